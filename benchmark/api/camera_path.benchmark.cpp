@@ -0,0 +1,169 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/gfx/headless_frontend.hpp>
+#include <mbgl/gfx/memory_usage.hpp>
+#include <mbgl/map/map.hpp>
+#include <mbgl/map/map_observer.hpp>
+#include <mbgl/map/map_options.hpp>
+#include <mbgl/renderer/renderer.hpp>
+#include <mbgl/storage/network_status.hpp>
+#include <mbgl/storage/resource_options.hpp>
+#include <mbgl/style/image.hpp>
+#include <mbgl/style/style.hpp>
+#include <mbgl/util/constants.hpp>
+#include <mbgl/util/image.hpp>
+#include <mbgl/util/io.hpp>
+#include <mbgl/util/monotonic_timer.hpp>
+#include <mbgl/util/run_loop.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+using namespace mbgl;
+
+namespace {
+
+static std::string cachePath { "benchmark/fixtures/api/cache.db" };
+constexpr double pixelRatio { 1.0 };
+constexpr Size size { 1000, 1000 };
+constexpr unsigned pathFrames { 120 };
+const LatLng manhattan { 40.726989, -73.992857 };
+
+// Moves the camera for one frame of a path.
+using CameraPath = void (*)(Map&, unsigned frame);
+
+void pan(Map& map, unsigned) {
+    map.moveBy({ -8.0, 3.0 });
+}
+
+// A pan that slows down after the finger is lifted.
+void fling(Map& map, unsigned frame) {
+    const double speed = 60.0 * std::pow(0.96, frame);
+    map.moveBy({ speed, -speed / 2.0 });
+}
+
+// Zooms out towards the middle of the path and back in while moving to the destination.
+void flyTo(Map& map, unsigned frame) {
+    const double t = double(frame) / (pathFrames - 1);
+    map.jumpTo(CameraOptions()
+                   .withCenter(LatLng { manhattan.latitude() + 0.04 * t, manhattan.longitude() + 0.05 * t })
+                   .withZoom(15.0 - 2.0 * std::sin(M_PI * t)));
+}
+
+void pitch(Map& map, unsigned frame) {
+    const double t = double(frame) / (pathFrames - 1);
+    map.jumpTo(CameraOptions().withPitch(util::PITCH_MAX * util::RAD2DEG * t).withBearing(90.0 * t));
+}
+
+class PathObserver : public MapObserver {
+public:
+    void onDidFinishRenderingFrame(RenderFrameStatus) override {
+        frames++;
+    }
+
+    void onDidBecomeIdle() override {
+        idle = true;
+    }
+
+    unsigned frames = 0;
+    bool idle = false;
+};
+
+class PathBenchmark {
+public:
+    PathBenchmark(const std::string& style)
+        : map(frontend, observer,
+              MapOptions().withMapMode(MapMode::Continuous).withSize(size).withPixelRatio(pixelRatio),
+              ResourceOptions().withCachePath(cachePath).withAccessToken("foobar")) {
+        map.getStyle().loadJSON(util::read_file(style));
+        map.jumpTo(CameraOptions().withCenter(manhattan).withZoom(15.0));
+
+        auto image = decodeImage(util::read_file("benchmark/fixtures/api/default_marker.png"));
+        map.getStyle().addImage(std::make_unique<style::Image>("test-icon", std::move(image), 1.0));
+
+        waitUntilIdle();
+    }
+
+    // Returns the time spent rendering the frame, in milliseconds.
+    double renderFrame(CameraPath path, unsigned frame) {
+        observer.idle = false;
+        path(map, frame);
+        const unsigned rendered = observer.frames;
+        while (observer.frames == rendered) {
+            util::RunLoop::Get()->runOnce();
+        }
+        return frontend.getFrameTime() * 1000.0;
+    }
+
+    void waitUntilIdle() {
+        while (!observer.idle) {
+            util::RunLoop::Get()->runOnce();
+        }
+    }
+
+    std::size_t gpuMemory() {
+        return frontend.getRenderer()->getGPUMemoryUsage().total.total();
+    }
+
+private:
+    PathObserver observer;
+    HeadlessFrontend frontend { size, pixelRatio };
+    Map map;
+};
+
+double percentile(std::vector<double>& values, double p) {
+    if (values.empty()) return 0.0;
+    const auto n = std::min(values.size() - 1, std::size_t(std::ceil(p * values.size())) - 1);
+    std::nth_element(values.begin(), values.begin() + n, values.end());
+    return values[n];
+}
+
+} // end namespace
+
+// Replays a camera path against a map that has finished loading, then waits for the tiles of
+// the final viewport. Frame times are the CPU time spent in Renderer::render, and "settle"
+// is the time from the last frame of the path until the map is idle again.
+static void API_renderCameraPath(::benchmark::State& state, const char* style, CameraPath path) {
+    NetworkStatus::Set(NetworkStatus::Status::Offline);
+    util::RunLoop loop;
+
+    std::vector<double> frameTimes;
+    double settleTime = 0;
+    std::size_t gpuMemory = 0;
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto bench = std::make_unique<PathBenchmark>(style);
+        state.ResumeTiming();
+
+        for (unsigned frame = 0; frame < pathFrames; ++frame) {
+            frameTimes.push_back(bench->renderFrame(path, frame));
+        }
+
+        const auto settleStart = util::MonotonicTimer::now();
+        bench->waitUntilIdle();
+        settleTime += std::chrono::duration<double, std::milli>(util::MonotonicTimer::now() - settleStart).count();
+
+        state.PauseTiming();
+        gpuMemory = std::max(gpuMemory, bench->gpuMemory());
+        bench.reset();
+        state.ResumeTiming();
+    }
+
+    state.counters["frame_p50_ms"] = percentile(frameTimes, 0.50);
+    state.counters["frame_p95_ms"] = percentile(frameTimes, 0.95);
+    state.counters["frame_p99_ms"] = percentile(frameTimes, 0.99);
+    state.counters["settle_ms"] = settleTime / state.iterations();
+    state.counters["gpu_bytes"] = gpuMemory;
+}
+
+#define CAMERA_PATHS(name, style) \
+    BENCHMARK_CAPTURE(API_renderCameraPath, name##_pan, style, pan)->Unit(benchmark::kMillisecond)->Iterations(5); \
+    BENCHMARK_CAPTURE(API_renderCameraPath, name##_fling, style, fling)->Unit(benchmark::kMillisecond)->Iterations(5); \
+    BENCHMARK_CAPTURE(API_renderCameraPath, name##_flyTo, style, flyTo)->Unit(benchmark::kMillisecond)->Iterations(5); \
+    BENCHMARK_CAPTURE(API_renderCameraPath, name##_pitch, style, pitch)->Unit(benchmark::kMillisecond)->Iterations(5);
+
+CAMERA_PATHS(streets, "benchmark/fixtures/api/style.json")
+CAMERA_PATHS(formatted_labels, "benchmark/fixtures/api/style_formatted_labels.json")
@@ -0,0 +1,109 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/gfx/headless_frontend.hpp>
+#include <mbgl/map/map.hpp>
+#include <mbgl/map/map_observer.hpp>
+#include <mbgl/map/map_options.hpp>
+#include <mbgl/storage/file_source_manager.hpp>
+#include <mbgl/storage/network_status.hpp>
+#include <mbgl/storage/resource_options.hpp>
+#include <mbgl/style/style.hpp>
+#include <mbgl/util/run_loop.hpp>
+
+#include <file_source.hpp>
+
+#include <array>
+#include <cassert>
+#include <chrono>
+#include <mutex>
+
+using namespace mbgl;
+
+namespace {
+
+// Holds the styles, tiles, glyphs and sprites of the real world render tests.
+static std::string cachePath { "metrics/cache-style.db" };
+constexpr double pixelRatio { 1.0 };
+constexpr Size size { 512, 512 };
+
+using Milestone = MapObserver::StartupMilestone;
+constexpr std::size_t milestoneCount = static_cast<std::size_t>(Milestone::ProgramsReady) + 1;
+
+class StartupObserver : public MapObserver {
+public:
+    void onDidReachStartupMilestone(Milestone milestone, Duration elapsed) override {
+        times[static_cast<std::size_t>(milestone)] = elapsed;
+    }
+
+    void onDidBecomeIdle() override {
+        idle = true;
+    }
+
+    std::array<Duration, milestoneCount> times {};
+    bool idle = false;
+};
+
+// Serves the local:// URLs of the render test styles from the cache, like the render test runner.
+void registerProxyFileSource() {
+    static std::once_flag registerProxyFlag;
+    std::call_once(registerProxyFlag, [] {
+        auto* fileSourceManager = FileSourceManager::get();
+
+        auto resourceLoaderFactory = fileSourceManager->unRegisterFileSourceFactory(FileSourceType::ResourceLoader);
+        auto factory = [defaultFactory = std::move(resourceLoaderFactory)](const ResourceOptions& options) {
+            assert(defaultFactory);
+            std::shared_ptr<FileSource> fileSource = defaultFactory(options);
+            return std::make_unique<ProxyFileSource>(std::move(fileSource), options);
+        };
+
+        fileSourceManager->registerFileSourceFactory(FileSourceType::ResourceLoader, std::move(factory));
+    });
+}
+
+} // end namespace
+
+// Measures the time from the construction of a map to its first complete frame, with every resource
+// in the cache. Each iteration creates a new frontend, so shader programs are compiled again.
+static void API_coldStart(::benchmark::State& state, const char* style, LatLng center, double zoom) {
+    registerProxyFileSource();
+    ProxyFileSource::setOffline(true);
+    NetworkStatus::Set(NetworkStatus::Status::Offline);
+    util::RunLoop loop;
+
+    std::array<double, milestoneCount> totals {};
+
+    for (auto _ : state) {
+        StartupObserver observer;
+        HeadlessFrontend frontend { size, pixelRatio };
+        Map map { frontend, observer,
+                  MapOptions().withMapMode(MapMode::Continuous).withSize(size).withPixelRatio(pixelRatio),
+                  ResourceOptions().withCachePath(cachePath).withAccessToken("foobar") };
+        map.jumpTo(CameraOptions().withCenter(center).withZoom(zoom));
+        map.getStyle().loadURL(style);
+
+        while (!observer.idle) {
+            loop.runOnce();
+        }
+
+        for (std::size_t i = 0; i < milestoneCount; ++i) {
+            totals[i] += std::chrono::duration<double, std::milli>(observer.times[i]).count();
+        }
+    }
+
+    const auto iterations = double(state.iterations());
+    state.counters["style_requested_ms"] = totals[static_cast<std::size_t>(Milestone::StyleRequested)] / iterations;
+    state.counters["style_parsed_ms"] = totals[static_cast<std::size_t>(Milestone::StyleParsed)] / iterations;
+    state.counters["first_frame_ms"] = totals[static_cast<std::size_t>(Milestone::FirstFrame)] / iterations;
+    state.counters["first_tile_ms"] = totals[static_cast<std::size_t>(Milestone::FirstTileRendered)] / iterations;
+    state.counters["programs_ready_ms"] = totals[static_cast<std::size_t>(Milestone::ProgramsReady)] / iterations;
+}
+
+BENCHMARK_CAPTURE(API_coldStart, chicago, "http://styles/chicago.json", LatLng { 41.853196, -87.736816 }, 13.0)
+    ->Unit(benchmark::kMillisecond)
+    ->Iterations(10);
+BENCHMARK_CAPTURE(API_coldStart, sanfrancisco, "http://styles/sanfrancisco.json", LatLng { 37.770715, -122.453613 }, 15.0)
+    ->Unit(benchmark::kMillisecond)
+    ->Iterations(10);
+BENCHMARK_CAPTURE(API_coldStart, bangkok, "http://styles/bangkok.json", LatLng { 13.752725, 100.546875 }, 12.0)
+    ->Unit(benchmark::kMillisecond)
+    ->Iterations(10);
@@ -0,0 +1,63 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/benchmark/stub_geometry_tile_feature.hpp>
+
+#include <mbgl/style/conversion/json.hpp>
+#include <mbgl/style/conversion/property_value.hpp>
+#include <mbgl/style/conversion_impl.hpp>
+#include <mbgl/util/color.hpp>
+#include <mbgl/util/interpolate.hpp>
+
+#include <string>
+#include <vector>
+
+using namespace mbgl;
+using namespace mbgl::style;
+using namespace std::string_literals;
+
+static const std::vector<std::string> colorStrings = {
+    "#f00"s, "#4264fb"s, "#fff"s, "#08306b"s, "red"s, "lightgray"s, "rgba(255, 0, 0, 0.5)"s, "hsl(120, 50%, 50%)"s,
+};
+
+static void Parse_Color(benchmark::State& state) {
+    std::size_t i = 0;
+    while (state.KeepRunning()) {
+        benchmark::DoNotOptimize(Color::parse(colorStrings[i++ % colorStrings.size()]));
+    }
+}
+
+static void Interpolate_Color(benchmark::State& state) {
+    const Color a(0.1f, 0.2f, 0.3f, 0.4f);
+    const Color b(0.9f, 0.7f, 0.5f, 1.0f);
+    double t = 0;
+    while (state.KeepRunning()) {
+        benchmark::DoNotOptimize(util::interpolate(a, b, t));
+        t = t < 1 ? t + 0.001 : 0;
+    }
+}
+
+// A data-driven color, which parses a property string for every feature.
+static void Evaluate_ToColor(benchmark::State& state) {
+    conversion::Error error;
+    optional<PropertyValue<Color>> function =
+        conversion::convertJSON<PropertyValue<Color>>(R"(["to-color", ["get", "color"]])", error, true, false);
+    if (!function) {
+        state.SkipWithError(error.message.c_str());
+        return;
+    }
+
+    std::vector<StubGeometryTileFeature> features;
+    for (const auto& color : colorStrings) {
+        features.emplace_back(PropertyMap{{"color", color}});
+    }
+
+    std::size_t i = 0;
+    while (state.KeepRunning()) {
+        benchmark::DoNotOptimize(
+            function->asExpression().evaluate(features[i++ % features.size()], Color::black()));
+    }
+}
+
+BENCHMARK(Parse_Color);
+BENCHMARK(Interpolate_Color);
+BENCHMARK(Evaluate_ToColor);
@@ -52,10 +52,91 @@ static void Evaluate_SourceFunction(benchmark::State& state) {
     state.SetLabel(std::to_string(stopCount).c_str());
 }
 
+static const char* choroplethExpressionJSON =
+    R"(["interpolate", ["linear"], ["/", ["get", "x"], 100],
+        0, "#f7fbff", 0.2, "#c6dbef", 0.4, "#6baed6", 0.6, "#2171b5", 0.8, "#08519c", 1, "#08306b"])";
+
+// Evaluates through PropertyExpression, which uses the compiled program.
+static void Evaluate_SourceExpression_Color(benchmark::State& state) {
+    conversion::Error error;
+    optional<PropertyValue<Color>> function =
+        conversion::convertJSON<PropertyValue<Color>>(choroplethExpressionJSON, error, true, false);
+    if (!function) {
+        state.SkipWithError(error.message.c_str());
+        return;
+    }
+
+    while (state.KeepRunning()) {
+        benchmark::DoNotOptimize(function->asExpression().evaluate(
+            StubGeometryTileFeature(PropertyMap{{"x", static_cast<int64_t>(rand() % 100)}}), Color::black()));
+    }
+}
+
+// Evaluates the same expression tree with the interpreter, for comparison.
+static void Evaluate_SourceExpression_Color_Interpreted(benchmark::State& state) {
+    conversion::Error error;
+    optional<PropertyValue<Color>> function =
+        conversion::convertJSON<PropertyValue<Color>>(choroplethExpressionJSON, error, true, false);
+    if (!function) {
+        state.SkipWithError(error.message.c_str());
+        return;
+    }
+
+    const expression::Expression& expression = function->asExpression().getExpression();
+    while (state.KeepRunning()) {
+        StubGeometryTileFeature feature(PropertyMap{{"x", static_cast<int64_t>(rand() % 100)}});
+        benchmark::DoNotOptimize(expression.evaluate(expression::EvaluationContext(&feature)));
+    }
+}
+
+static const char* compositeExpressionJSON =
+    R"(["interpolate", ["linear"], ["zoom"],
+        0, ["interpolate", ["linear"], ["get", "x"], 0, 1, 100, 5],
+        10, ["interpolate", ["linear"], ["get", "x"], 0, 2, 100, 10]])";
+
+// Evaluates a zoom-and-property expression for a whole layer's worth of features, either
+// one feature at a time (state.range(0) == 0) or as a batch.
+static void Evaluate_CompositeExpression(benchmark::State& state) {
+    conversion::Error error;
+    optional<PropertyValue<float>> function =
+        conversion::convertJSON<PropertyValue<float>>(compositeExpressionJSON, error, true, false);
+    if (!function) {
+        state.SkipWithError(error.message.c_str());
+        return;
+    }
+
+    std::vector<StubGeometryTileFeature> stubs;
+    for (int i = 0; i < 1000; ++i) {
+        stubs.emplace_back(PropertyMap{{"x", static_cast<int64_t>(rand() % 100)}});
+    }
+    std::vector<const GeometryTileFeature*> features;
+    for (const auto& stub : stubs) {
+        features.push_back(&stub);
+    }
+
+    const auto& expression = function->asExpression();
+    std::vector<float> results;
+    while (state.KeepRunning()) {
+        if (state.range(0)) {
+            expression.evaluate(expression::EvaluationContext(5.0f), features, results, 0.0f);
+        } else {
+            results.clear();
+            for (const GeometryTileFeature* feature : features) {
+                results.push_back(expression.evaluate(5.0f, *feature, 0.0f));
+            }
+        }
+        benchmark::DoNotOptimize(results.data());
+    }
+}
+
 BENCHMARK(Parse_SourceFunction)
     ->Arg(1)->Arg(2)->Arg(4)->Arg(6)->Arg(8)->Arg(10)->Arg(12);
 
 BENCHMARK(Evaluate_SourceFunction)
     ->Arg(1)->Arg(2)->Arg(4)->Arg(6)->Arg(8)->Arg(10)->Arg(12);
 
+BENCHMARK(Evaluate_SourceExpression_Color);
+BENCHMARK(Evaluate_SourceExpression_Color_Interpreted);
+BENCHMARK(Evaluate_CompositeExpression)->Arg(0)->Arg(1);
+
 
@@ -0,0 +1,59 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/gfx/backend_scope.hpp>
+#include <mbgl/gfx/command_encoder.hpp>
+#include <mbgl/gfx/upload_pass.hpp>
+#include <mbgl/gl/context.hpp>
+#include <mbgl/gl/headless_backend.hpp>
+#include <mbgl/programs/fill_program.hpp>
+
+using namespace mbgl;
+
+namespace {
+
+// The buffers of a fill draw, bound like FillProgram binds them, with a data-driven color.
+class VertexArrayBenchmark {
+public:
+    VertexArrayBenchmark() {
+        auto commandEncoder = context.createCommandEncoder();
+        auto uploadPass = commandEncoder->createUploadPass("upload");
+        gfx::IndexVector<gfx::Triangles> indices;
+        indices.emplace_back(0, 1, 2);
+        indexBuffer = uploadPass->createIndexBuffer(std::move(indices));
+        gfx::VertexVector<FillLayoutVertex> vertices;
+        vertices.emplace_back(FillProgram::layoutVertex({0, 0}));
+        vertices.emplace_back(FillProgram::layoutVertex({1, 0}));
+        vertices.emplace_back(FillProgram::layoutVertex({0, 1}));
+        vertexBuffer = uploadPass->createVertexBuffer(std::move(vertices));
+        bindings = {gfx::attributeBinding<0>(*vertexBuffer), nullopt, nullopt, nullopt};
+    }
+
+    gl::HeadlessBackend backend{{256, 256}};
+    gfx::BackendScope scope{backend};
+    gl::Context context{backend};
+    optional<gfx::IndexBuffer> indexBuffer;
+    optional<gfx::VertexBuffer<FillLayoutVertex>> vertexBuffer;
+    gl::AttributeBindingArray bindings;
+};
+
+} // namespace
+
+// Every draw builds the key of its bindings and looks it up among the vertex arrays of the context.
+static void GL_VertexArrayLookup(benchmark::State& state) {
+    VertexArrayBenchmark bench;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(bench.context.getVertexArray(*bench.indexBuffer, bench.bindings));
+    }
+}
+
+// Every draw compares its bindings with the key that its draw scope remembers, as program draws do.
+static void GL_VertexArrayDrawScope(benchmark::State& state) {
+    VertexArrayBenchmark bench;
+    auto drawScope = bench.context.createDrawScope();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(&bench.context.getVertexArray(drawScope, *bench.indexBuffer, bench.bindings));
+    }
+}
+
+BENCHMARK(GL_VertexArrayLookup);
+BENCHMARK(GL_VertexArrayDrawScope);
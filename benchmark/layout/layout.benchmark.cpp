@@ -0,0 +1,234 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/layermanager/layer_manager.hpp>
+#include <mbgl/layout/layout.hpp>
+#include <mbgl/renderer/bucket.hpp>
+#include <mbgl/renderer/bucket_parameters.hpp>
+#include <mbgl/renderer/group_by_layout.hpp>
+#include <mbgl/renderer/property_evaluation_parameters.hpp>
+#include <mbgl/renderer/render_layer.hpp>
+#include <mbgl/renderer/transition_parameters.hpp>
+#include <mbgl/style/expression/evaluation_context.hpp>
+#include <mbgl/style/filter.hpp>
+#include <mbgl/style/parser.hpp>
+#include <mbgl/text/dynamic_glyph_atlas.hpp>
+#include <mbgl/text/glyph_pbf.hpp>
+#include <mbgl/tile/vector_tile_data.hpp>
+#include <mbgl/util/arena.hpp>
+#include <mbgl/util/io.hpp>
+#include <mbgl/util/monotonic_timer.hpp>
+
+#include <allocation_index.hpp>
+
+#include <chrono>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace mbgl;
+
+namespace {
+
+// Production Mapbox Streets tiles.
+const std::vector<std::pair<OverscaledTileID, std::string>> corpus = {
+    { OverscaledTileID { 0, 0, 0 }, "test/fixtures/api/assets/streets/0-0-0.vector.pbf" },
+    { OverscaledTileID { 10, 163, 395 }, "test/fixtures/api/assets/streets/10-163-395.vector.pbf" },
+};
+
+// The benchmark style has no circle or fill-extrusion layers.
+const char* extraLayers = R"JSON({
+  "version": 8,
+  "sources": { "composite": { "type": "vector", "tiles": [] } },
+  "layers": [{
+    "id": "poi-circle",
+    "type": "circle",
+    "source": "composite",
+    "source-layer": "poi_label",
+    "paint": {
+      "circle-radius": ["interpolate", ["linear"], ["zoom"], 10, 2, 16, 6],
+      "circle-color": ["match", ["get", "maki"], "park", "#4a4", "#a44"]
+    }
+  }, {
+    "id": "building-extrusion",
+    "type": "fill-extrusion",
+    "source": "composite",
+    "source-layer": "building",
+    "paint": {
+      "fill-extrusion-color": "#aaa",
+      "fill-extrusion-height": ["get", "height"],
+      "fill-extrusion-base": ["get", "min_height"]
+    }
+  }]
+})JSON";
+
+class LayoutBenchmark {
+public:
+    struct Tile {
+        OverscaledTileID id;
+        std::unique_ptr<VectorTileData> data;
+        // The evaluated layers of the tile zoom, grouped by layout.
+        std::vector<std::vector<Immutable<style::LayerProperties>>> groups;
+    };
+
+    explicit LayoutBenchmark(const char* layerType) {
+        addLayers(util::read_file("benchmark/fixtures/api/style.json"), layerType);
+        addLayers(extraLayers, layerType);
+
+        for (const auto& entry : corpus) {
+            Tile tile { entry.first,
+                        std::make_unique<VectorTileData>(std::make_shared<std::string>(util::read_file(entry.second))),
+                        {} };
+            const float zoom = tile.id.overscaledZ;
+            std::map<std::string, std::vector<Immutable<style::LayerProperties>>> groupMap;
+            for (const auto& layer : renderLayers) {
+                if (layer->baseImpl->visibility == style::VisibilityType::None || !layer->supportsZoom(zoom)) {
+                    continue;
+                }
+                layer->evaluate(PropertyEvaluationParameters(zoom));
+                groupMap[layoutKey(*layer->baseImpl)].push_back(layer->evaluatedProperties);
+            }
+            for (auto& group : groupMap) {
+                tile.groups.push_back(std::move(group.second));
+            }
+            tiles.push_back(std::move(tile));
+        }
+
+        // Finds out which glyphs the symbols need, the way the worker requests them.
+        for (const auto& tile : tiles) {
+            layout(tile);
+        }
+        loadGlyphs();
+    }
+
+    // Lays out the tile like GeometryTileWorker::parse() and finalizeLayout(), and returns the
+    // number of features in the source layers of the laid out groups.
+    std::size_t layout(const Tile& tile) {
+        std::size_t features = 0;
+        std::unordered_map<StringIdentity, LayerRenderData> renderData;
+        arena.reset();
+
+        for (const auto& group : tile.groups) {
+            const style::Layer::Impl& leaderImpl = *group.at(0)->baseImpl;
+            BucketParameters parameters { tile.id, MapMode::Continuous, 1.0f, leaderImpl.getTypeInfo() };
+
+            auto geometryLayer = tile.data->getLayer(leaderImpl.sourceLayer);
+            if (!geometryLayer) {
+                continue;
+            }
+            features += geometryLayer->featureCount();
+
+            if (leaderImpl.getTypeInfo()->layout == style::LayerTypeInfo::Layout::Required) {
+                std::unique_ptr<Layout> layout = LayerManager::get()->createLayout(
+                    { parameters, glyphDependencies, imageDependencies, availableImages, &arena },
+                    std::move(geometryLayer),
+                    group);
+                layout->prepareSymbols(glyphMap, glyphPositions, {}, {});
+                if (layout->hasSymbolInstances()) {
+                    layout->createBucket({}, nullptr, renderData, true, false, tile.id.canonical);
+                }
+                continue;
+            }
+
+            std::shared_ptr<Bucket> bucket = LayerManager::get()->createBucket(parameters, group);
+            const OverscaledTileID& id = tile.id;
+            geometryLayer->forEachFeature([&](std::size_t i, const GeometryTileFeature& view) {
+                if (!leaderImpl.filter(style::expression::EvaluationContext(static_cast<float>(id.overscaledZ), &view)
+                                           .withCanonicalTileID(&id.canonical))) {
+                    return;
+                }
+                std::unique_ptr<GeometryTileFeature> feature = geometryLayer->getFeature(i);
+                bucket->addFeature(*feature, feature->getGeometries(), {}, PatternLayerMap(), i, id.canonical);
+            });
+            for (const auto& layer : group) {
+                renderData.emplace(layer->baseImpl->id, LayerRenderData { bucket, layer });
+            }
+        }
+
+        return features;
+    }
+
+    std::vector<Tile> tiles;
+
+private:
+    void addLayers(const std::string& json, const char* layerType) {
+        style::Parser parser;
+        parser.parse(json);
+        for (const auto& layer : parser.layers) {
+            if (std::strcmp(layer->getTypeInfo()->type, layerType) != 0) {
+                continue;
+            }
+            auto renderLayer = LayerManager::get()->createRenderLayer(layer->baseImpl);
+            renderLayer->transition(TransitionParameters { Clock::now(), {} });
+            renderLayers.push_back(std::move(renderLayer));
+        }
+    }
+
+    // The fixture only has one range of one font, which stands in for all the fonts of the style.
+    void loadGlyphs() {
+        Glyphs glyphs;
+        for (auto& glyph : parseGlyphPBF(GlyphRange { 0, 255 }, util::read_file("test/fixtures/resources/glyphs.pbf"))) {
+            const GlyphID id = glyph.id;
+            glyphs.emplace(id, Immutable<Glyph>(makeMutable<Glyph>(std::move(glyph))));
+        }
+        for (const auto& dependency : glyphDependencies) {
+            glyphMap.emplace(FontStackHasher()(dependency.first), glyphs);
+        }
+        glyphReservation = glyphAtlas->addGlyphs(glyphMap, glyphPositions);
+    }
+
+    std::vector<std::unique_ptr<RenderLayer>> renderLayers;
+    util::Arena arena;
+
+    GlyphDependencies glyphDependencies;
+    ImageDependencies imageDependencies;
+    std::set<std::string> availableImages;
+
+    GlyphMap glyphMap;
+    GlyphPositions glyphPositions;
+    std::shared_ptr<DynamicGlyphAtlas> glyphAtlas = DynamicGlyphAtlas::create();
+    std::shared_ptr<const DynamicGlyphAtlas::Reservation> glyphReservation;
+};
+
+} // namespace
+
+// Lays out the corpus for the layers of one type. Source features that the layer filters
+// drop count as well, so the per feature numbers include filtering.
+static void Layout_Bucket(benchmark::State& state, const char* layerType) {
+    LayoutBenchmark bench(layerType);
+
+    std::size_t features = 0;
+    AllocationIndex::reset();
+    AllocationIndex::setActive(true);
+    for (const auto& tile : bench.tiles) {
+        features += bench.layout(tile);
+    }
+    AllocationIndex::setActive(false);
+    if (features == 0) {
+        state.SkipWithError("No features to lay out");
+        return;
+    }
+    state.counters["bytes_per_feature"] = double(AllocationIndex::getAllocatedSizeTotal()) / features;
+    state.counters["allocations_per_feature"] = double(AllocationIndex::getAllocationsCount()) / features;
+    AllocationIndex::reset();
+
+    features = 0;
+    std::chrono::duration<double> elapsed { 0 };
+    for (auto _ : state) {
+        const auto start = util::MonotonicTimer::now();
+        for (const auto& tile : bench.tiles) {
+            features += bench.layout(tile);
+        }
+        elapsed += util::MonotonicTimer::now() - start;
+    }
+    state.counters["ns_per_feature"] = elapsed.count() * 1e9 / features;
+}
+
+BENCHMARK_CAPTURE(Layout_Bucket, FillBucket, "fill")->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(Layout_Bucket, LineBucket, "line")->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(Layout_Bucket, CircleBucket, "circle")->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(Layout_Bucket, SymbolLayout, "symbol")->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(Layout_Bucket, FillExtrusionBucket, "fill-extrusion")->Unit(benchmark::kMillisecond);
@@ -0,0 +1,50 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/algorithm/update_renderables.hpp>
+
+#include <unordered_map>
+
+using namespace mbgl;
+
+class FakeTile {
+public:
+    FakeTile(bool loaded_) : loaded(loaded_) {}
+
+    bool isReadyToRender() const { return loaded; }
+    bool isLoaded() const { return loaded; }
+    bool hasTriedCache() const { return true; }
+
+    const bool loaded;
+};
+
+// A camera that zoomed in from z13 to z14: the z14 cover is still loading, and the z13 tiles
+// around it are rendered in its place.
+static void UpdateRenderables(benchmark::State& state) {
+    std::unordered_map<OverscaledTileID, FakeTile> tiles;
+    std::vector<OverscaledTileID> idealTiles;
+    for (uint32_t x = 0; x < 8; ++x) {
+        for (uint32_t y = 0; y < 6; ++y) {
+            const OverscaledTileID idealTileID{ 14, 8224 + x, 5824 + y };
+            idealTiles.push_back(idealTileID);
+            tiles.emplace(idealTileID, FakeTile{ false });
+            tiles.emplace(idealTileID.scaledTo(13), FakeTile{ true });
+        }
+    }
+
+    while (state.KeepRunning()) {
+        std::size_t rendered = 0;
+        algorithm::updateRenderables(
+            [&](const OverscaledTileID& tileID) -> FakeTile* {
+                auto it = tiles.find(tileID);
+                return it == tiles.end() ? nullptr : &it->second;
+            },
+            [](const OverscaledTileID&) -> FakeTile* { return nullptr; },
+            [](FakeTile&, TileNecessity) {},
+            [&](const UnwrappedTileID&, FakeTile&) { ++rendered; },
+            idealTiles,
+            { 0, 22 });
+        benchmark::DoNotOptimize(rendered);
+    }
+}
+
+BENCHMARK(UpdateRenderables);
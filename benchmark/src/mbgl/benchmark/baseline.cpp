@@ -0,0 +1,173 @@
+#include <mbgl/benchmark/baseline.hpp>
+#include <mbgl/util/io.hpp>
+#include <mbgl/util/rapidjson.hpp>
+
+#include <rapidjson/prettywriter.h>
+#include <rapidjson/stringbuffer.h>
+
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+namespace mbgl {
+
+namespace {
+
+JSDocument parse(const std::string& json, const std::string& what) {
+    JSDocument document;
+    document.Parse<0>(json.c_str());
+    if (document.HasParseError()) {
+        throw std::runtime_error("Invalid " + what + ": " + formatJSONParseError(document));
+    }
+    if (!document.IsObject()) {
+        throw std::runtime_error("Invalid " + what + ": not an object");
+    }
+    return document;
+}
+
+double toNanoseconds(double time, const char* unit) {
+    if (std::strcmp(unit, "us") == 0) return time * 1e3;
+    if (std::strcmp(unit, "ms") == 0) return time * 1e6;
+    if (std::strcmp(unit, "s") == 0) return time * 1e9;
+    return time;
+}
+
+// The CPU time of every benchmark in Google Benchmark JSON results, in ns. Where the benchmarks
+// were repeated, the mean of the repetitions.
+std::map<std::string, double> parseResults(const std::string& resultsJSON) {
+    const JSDocument document = parse(resultsJSON, "benchmark results");
+    std::map<std::string, double> results;
+    if (!document.HasMember("benchmarks") || !document["benchmarks"].IsArray()) {
+        return results;
+    }
+
+    for (const auto& run : document["benchmarks"].GetArray()) {
+        if (!run.IsObject() || !run.HasMember("name") || !run.HasMember("cpu_time") ||
+            (run.HasMember("error_occurred") && run["error_occurred"].GetBool())) {
+            continue;
+        }
+        const bool aggregate = run.HasMember("run_type") && std::strcmp(run["run_type"].GetString(), "aggregate") == 0;
+        if (aggregate &&
+            (!run.HasMember("aggregate_name") || std::strcmp(run["aggregate_name"].GetString(), "mean") != 0)) {
+            continue;
+        }
+        const std::string name = run.HasMember("run_name") ? run["run_name"].GetString() : run["name"].GetString();
+        const double time = toNanoseconds(run["cpu_time"].GetDouble(),
+                                          run.HasMember("time_unit") ? run["time_unit"].GetString() : "ns");
+        if (aggregate) {
+            results[name] = time;
+        } else {
+            // Keeps the first repetition until the mean comes along.
+            results.emplace(name, time);
+        }
+    }
+    return results;
+}
+
+} // namespace
+
+BenchmarkBaseline BenchmarkBaseline::load(const std::string& path) {
+    const JSDocument document = parse(util::read_file(path), path);
+
+    BenchmarkBaseline baseline;
+    if (document.HasMember("filter") && document["filter"].IsString()) {
+        baseline.filter = document["filter"].GetString();
+    }
+    if (document.HasMember("tolerance") && document["tolerance"].IsNumber()) {
+        baseline.tolerance = document["tolerance"].GetDouble();
+    }
+    if (document.HasMember("benchmarks") && document["benchmarks"].IsObject()) {
+        for (const auto& benchmark : document["benchmarks"].GetObject()) {
+            if (!benchmark.value.IsObject()) continue;
+            Entry entry;
+            if (benchmark.value.HasMember("cpu_time_ns") && benchmark.value["cpu_time_ns"].IsNumber()) {
+                entry.cpuTime = benchmark.value["cpu_time_ns"].GetDouble();
+            }
+            if (benchmark.value.HasMember("tolerance") && benchmark.value["tolerance"].IsNumber()) {
+                entry.tolerance = benchmark.value["tolerance"].GetDouble();
+            }
+            baseline.benchmarks.emplace(benchmark.name.GetString(), entry);
+        }
+    }
+    return baseline;
+}
+
+double BenchmarkBaseline::toleranceFor(const Entry& entry) const {
+    return entry.tolerance ? *entry.tolerance : tolerance;
+}
+
+std::size_t BenchmarkBaseline::compare(const std::string& resultsJSON) const {
+    const auto results = parseResults(resultsJSON);
+    std::size_t regressions = 0;
+
+    for (const auto& result : results) {
+        auto it = benchmarks.find(result.first);
+        if (it == benchmarks.end() || it->second.cpuTime <= 0) {
+            std::printf("NEW       %s: %.0f ns\n", result.first.c_str(), result.second);
+            continue;
+        }
+        const double base = it->second.cpuTime;
+        const double change = result.second / base - 1.0;
+        const double allowed = toleranceFor(it->second);
+        if (change > allowed) {
+            std::printf("REGRESSED %s: %.0f ns, baseline %.0f ns (%+.1f%%, tolerance %.0f%%)\n",
+                        result.first.c_str(), result.second, base, change * 100, allowed * 100);
+            ++regressions;
+        } else if (change < -allowed) {
+            std::printf("IMPROVED  %s: %.0f ns, baseline %.0f ns (%+.1f%%)\n",
+                        result.first.c_str(), result.second, base, change * 100);
+        }
+    }
+    for (const auto& benchmark : benchmarks) {
+        if (results.find(benchmark.first) == results.end()) {
+            std::printf("MISSING   %s\n", benchmark.first.c_str());
+        }
+    }
+
+    std::printf("%zu of %zu benchmarks regressed\n", regressions, results.size());
+    return regressions;
+}
+
+void BenchmarkBaseline::update(const std::string& resultsJSON) {
+    std::map<std::string, Entry> updated;
+    for (const auto& result : parseResults(resultsJSON)) {
+        Entry& entry = updated[result.first];
+        entry.cpuTime = result.second;
+        auto it = benchmarks.find(result.first);
+        if (it != benchmarks.end()) {
+            entry.tolerance = it->second.tolerance;
+        }
+    }
+    benchmarks = std::move(updated);
+}
+
+std::string BenchmarkBaseline::toJSON() const {
+    rapidjson::StringBuffer buffer;
+    rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(buffer);
+    writer.SetIndent(' ', 2);
+
+    writer.StartObject();
+    writer.Key("filter");
+    writer.String(filter);
+    writer.Key("tolerance");
+    writer.Double(tolerance);
+    writer.Key("benchmarks");
+    writer.StartObject();
+    for (const auto& benchmark : benchmarks) {
+        writer.Key(benchmark.first.c_str());
+        writer.StartObject();
+        writer.Key("cpu_time_ns");
+        writer.Double(benchmark.second.cpuTime);
+        if (benchmark.second.tolerance) {
+            writer.Key("tolerance");
+            writer.Double(*benchmark.second.tolerance);
+        }
+        writer.EndObject();
+    }
+    writer.EndObject();
+    writer.EndObject();
+
+    return std::string(buffer.GetString(), buffer.GetSize()) + "\n";
+}
+
+} // namespace mbgl
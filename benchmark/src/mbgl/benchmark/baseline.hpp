@@ -0,0 +1,52 @@
+#pragma once
+
+#include <mbgl/util/optional.hpp>
+
+#include <map>
+#include <string>
+
+namespace mbgl {
+
+// CPU times of a set of benchmarks on one build target, checked in as metrics/<target>/benchmark/baseline.json:
+//
+//   {
+//     "filter": "<--benchmark_filter regex selecting the benchmarks>",
+//     "tolerance": 0.1,
+//     "benchmarks": {
+//       "TileCoverBounds": { "cpu_time_ns": 1234.5 },
+//       "OfflineDatabase/GetTile": { "cpu_time_ns": 5678.9, "tolerance": 0.25 }
+//     }
+//   }
+//
+// A benchmark regresses if it takes longer than its baseline time by more than its tolerance, a fraction
+// that defaults to the top level one.
+class BenchmarkBaseline {
+public:
+    struct Entry {
+        double cpuTime = 0; // ns
+        optional<double> tolerance;
+    };
+
+    // Throws if the file can't be read or parsed.
+    static BenchmarkBaseline load(const std::string& path);
+
+    const std::string& getFilter() const { return filter; }
+
+    // Compares the results written by Google Benchmark with --benchmark_out in JSON, and prints a line
+    // for every benchmark that regressed, improved, is new or is missing. Returns the number of regressions.
+    std::size_t compare(const std::string& resultsJSON) const;
+
+    // Replaces the baseline times with the results, keeping the tolerances.
+    void update(const std::string& resultsJSON);
+
+    std::string toJSON() const;
+
+private:
+    double toleranceFor(const Entry&) const;
+
+    std::string filter;
+    double tolerance = 0.1;
+    std::map<std::string, Entry> benchmarks;
+};
+
+} // namespace mbgl
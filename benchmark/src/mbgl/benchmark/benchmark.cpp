@@ -1,12 +1,118 @@
 #include <mbgl/benchmark.hpp>
+#include <mbgl/benchmark/baseline.hpp>
+#include <mbgl/util/io.hpp>
+#include <mbgl/util/optional.hpp>
+
+#include <allocation_index.hpp>
 
 #include <benchmark/benchmark.h>
 
+#include <cstring>
+#include <new>
+#include <string>
+#include <vector>
+
+#if !defined(SANITIZE)
+void* operator new(std::size_t sz) {
+    void* ptr = AllocationIndex::allocate(sz);
+    if (!ptr) throw std::bad_alloc{};
+
+    return ptr;
+}
+
+void operator delete(void* ptr) noexcept {
+    AllocationIndex::deallocate(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+    AllocationIndex::deallocate(ptr);
+}
+#endif
+
 namespace mbgl {
 
+namespace {
+
+// Removes the first argument starting with `flag` from the arguments, and returns the rest of it.
+optional<std::string> takeFlag(int& argc, char* argv[], const char* flag) {
+    optional<std::string> value;
+    int kept = 0;
+    for (int i = 0; i < argc; ++i) {
+        if (i > 0 && !value && std::strncmp(argv[i], flag, std::strlen(flag)) == 0) {
+            value = std::string(argv[i] + std::strlen(flag));
+        } else {
+            argv[kept++] = argv[i];
+        }
+    }
+    argc = kept;
+    return value;
+}
+
+bool hasFlag(int argc, char* argv[], const char* flag) {
+    for (int i = 1; i < argc; ++i) {
+        if (std::strncmp(argv[i], flag, std::strlen(flag)) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+// With --baseline=<path>, the benchmarks selected by the baseline are run unless given a
+// --benchmark_filter, and their results are written in JSON next to the baseline unless given a
+// --benchmark_out. Fails if any of them regressed. --rebaseline writes the results to the baseline.
 int runBenchmark(int argc, char* argv[]) {
-    ::benchmark::Initialize(&argc, argv);
+    const optional<std::string> allocationProfile = takeFlag(argc, argv, "--allocation-profile=");
+    const optional<std::string> baselinePath = takeFlag(argc, argv, "--baseline=");
+    const bool rebaseline = bool(takeFlag(argc, argv, "--rebaseline"));
+
+    optional<BenchmarkBaseline> baseline;
+    std::string resultsPath;
+    std::vector<std::string> baselineArguments;
+    if (baselinePath) {
+        baseline = BenchmarkBaseline::load(*baselinePath);
+        if (!hasFlag(argc, argv, "--benchmark_filter=") && !baseline->getFilter().empty()) {
+            baselineArguments.push_back("--benchmark_filter=" + baseline->getFilter());
+        }
+        if (optional<std::string> out = takeFlag(argc, argv, "--benchmark_out=")) {
+            resultsPath = *out;
+        } else {
+            const auto slash = baselinePath->find_last_of('/');
+            resultsPath = (slash == std::string::npos ? "" : baselinePath->substr(0, slash + 1)) + "results.json";
+        }
+        baselineArguments.push_back("--benchmark_out=" + resultsPath);
+        baselineArguments.push_back("--benchmark_out_format=json");
+    }
+
+    std::vector<char*> arguments(argv, argv + argc);
+    for (auto& argument : baselineArguments) {
+        arguments.push_back(&argument[0]);
+    }
+    int argumentCount = static_cast<int>(arguments.size());
+    arguments.push_back(nullptr);
+
+    if (allocationProfile) {
+        AllocationIndex::setProfiling(100);
+    }
+
+    ::benchmark::Initialize(&argumentCount, arguments.data());
     ::benchmark::RunSpecifiedBenchmarks();
+
+    if (allocationProfile) {
+        AllocationIndex::setProfiling(0);
+        util::write_file(*allocationProfile, AllocationIndex::exportFlameGraph());
+    }
+
+    if (baseline) {
+        const std::string results = util::read_file(resultsPath);
+        const std::size_t regressions = baseline->compare(results);
+        if (rebaseline) {
+            baseline->update(results);
+            util::write_file(*baselinePath, baseline->toJSON());
+        }
+        return regressions == 0 ? 0 : 1;
+    }
     return 0;
 }
 
@@ -0,0 +1,124 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/geometry/anchor.hpp>
+#include <mbgl/map/transform.hpp>
+#include <mbgl/renderer/buckets/symbol_bucket.hpp>
+#include <mbgl/text/collision_feature.hpp>
+#include <mbgl/text/collision_index.hpp>
+#include <mbgl/tile/tile_id.hpp>
+#include <mbgl/util/constants.hpp>
+#include <mbgl/util/mat4.hpp>
+
+#include <random>
+
+using namespace mbgl;
+
+namespace {
+
+struct Label {
+    CollisionFeature feature;
+    PlacedSymbol symbol;
+    mat4 posMatrix;
+};
+
+const uint8_t zoom = 14;
+const float textPixelRatio = float(util::tileSize) / util::EXTENT;
+
+// Point labels of about 60x16 pixels, scattered over the four tiles covering the viewport.
+std::vector<Label> makeLabels(const TransformState& state, std::size_t labelsPerTile) {
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<int> coordinate(0, util::EXTENT - 1);
+    const float halfWidth = 30 / textPixelRatio;
+    const float halfHeight = 8 / textPixelRatio;
+
+    mat4 projMatrix;
+    state.getProjMatrix(projMatrix);
+
+    std::vector<Label> labels;
+    labels.reserve(4 * labelsPerTile);
+    const uint32_t center = 1u << (zoom - 1);
+    for (uint32_t x = center - 1; x <= center; ++x) {
+        for (uint32_t y = center - 1; y <= center; ++y) {
+            mat4 posMatrix;
+            state.matrixFor(posMatrix, UnwrappedTileID(zoom, x, y));
+            matrix::multiply(posMatrix, projMatrix, posMatrix);
+
+            for (std::size_t i = 0; i < labelsPerTile; ++i) {
+                const GeometryCoordinate point(coordinate(generator), coordinate(generator));
+                const Anchor anchor(point.x, point.y, 0.0f);
+                labels.push_back({CollisionFeature({point},
+                                                   anchor,
+                                                   -halfHeight,
+                                                   halfHeight,
+                                                   -halfWidth,
+                                                   halfWidth,
+                                                   nullopt,
+                                                   1.0f,
+                                                   0.0f,
+                                                   style::SymbolPlacementType::Point,
+                                                   IndexedSubfeature(i, "labels", "labels", i),
+                                                   1.0f,
+                                                   0.0f),
+                                  PlacedSymbol({float(point.x), float(point.y)},
+                                               0,
+                                               16.0f,
+                                               16.0f,
+                                               {{0.0f, 0.0f}},
+                                               WritingModeType::Horizontal,
+                                               {point},
+                                               {}),
+                                  posMatrix});
+            }
+        }
+    }
+    return labels;
+}
+
+void placeLabels(benchmark::State& state, const CameraOptions& camera) {
+    Transform transform;
+    transform.resize({1024, 768});
+    transform.jumpTo(camera);
+    const auto labels = makeLabels(transform.getState(), state.range(0));
+
+    std::vector<ProjectedCollisionBox> projectedBoxes;
+    std::size_t placed = 0;
+    while (state.KeepRunning()) {
+        CollisionIndex collisionIndex(transform.getState(), MapMode::Continuous);
+        for (const auto& label : labels) {
+            projectedBoxes.clear();
+            const auto result = collisionIndex.placeFeature(label.feature,
+                                                            {},
+                                                            label.posMatrix,
+                                                            label.posMatrix,
+                                                            textPixelRatio,
+                                                            label.symbol,
+                                                            1.0f,
+                                                            16.0f,
+                                                            false,
+                                                            false,
+                                                            false,
+                                                            nullopt,
+                                                            nullopt,
+                                                            projectedBoxes);
+            if (result.first) {
+                collisionIndex.insertFeature(label.feature, projectedBoxes, false, 0, 0);
+                ++placed;
+            }
+        }
+    }
+    benchmark::DoNotOptimize(placed);
+}
+
+} // namespace
+
+static void CollisionIndex_placeFeature(benchmark::State& state) {
+    placeLabels(state, CameraOptions().withCenter(LatLng{0, 0}).withZoom(double(zoom)));
+}
+
+static void CollisionIndex_placeFeaturePitched(benchmark::State& state) {
+    placeLabels(state, CameraOptions().withCenter(LatLng{0, 0}).withZoom(double(zoom)).withPitch(60.0));
+}
+
+// From a sparse rural area up to a dense city center, per tile.
+BENCHMARK(CollisionIndex_placeFeature)->Arg(100)->Arg(500)->Arg(2000);
+BENCHMARK(CollisionIndex_placeFeaturePitched)->Arg(100)->Arg(500)->Arg(2000);
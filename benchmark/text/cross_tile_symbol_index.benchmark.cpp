@@ -0,0 +1,128 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/geometry/anchor.hpp>
+#include <mbgl/layout/symbol_instance.hpp>
+#include <mbgl/renderer/buckets/symbol_bucket.hpp>
+#include <mbgl/text/cross_tile_symbol_index.hpp>
+#include <mbgl/tile/tile_id.hpp>
+#include <mbgl/util/constants.hpp>
+#include <mbgl/util/mat4.hpp>
+#include <mbgl/util/utf.hpp>
+
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+
+using namespace mbgl;
+
+namespace {
+
+SymbolInstance makeSymbolInstance(float x, float y, std::u16string key) {
+    GeometryCoordinates line;
+    ImageMap imageMap;
+    const ShapedTextOrientations shaping{};
+    style::SymbolLayoutProperties::Evaluated layout;
+    IndexedSubfeature subfeature(0, "", "", 0);
+    Anchor anchor(x, y, 0, 0);
+    std::array<float, 2> textOffset{{0.0f, 0.0f}};
+    std::array<float, 2> iconOffset{{0.0f, 0.0f}};
+    std::array<float, 2> variableTextOffset{{0.0f, 0.0f}};
+    style::SymbolPlacementType placementType = style::SymbolPlacementType::Point;
+
+    auto sharedData = std::make_shared<SymbolInstanceSharedData>(std::move(line),
+                                                                 shaping,
+                                                                 nullopt,
+                                                                 nullopt,
+                                                                 layout,
+                                                                 placementType,
+                                                                 textOffset,
+                                                                 imageMap,
+                                                                 0,
+                                                                 SymbolContent::IconSDF,
+                                                                 false,
+                                                                 false);
+    return SymbolInstance(anchor, std::move(sharedData), shaping, nullopt, nullopt, 0, 0, placementType, textOffset, 0, 0, iconOffset, subfeature, 0, 0, std::move(key), 0.0f, 0.0f, 0.0f, variableTextOffset, false);
+}
+
+// Labels of a tile, with keys taken from a pool of names so that, like road names, most of them
+// occur several times. Child tiles repeat the labels of the parent tile in their quadrant, plus
+// some of their own.
+std::unique_ptr<SymbolBucket> makeBucket(const OverscaledTileID& tileID,
+                                         const OverscaledTileID& parentID,
+                                         std::size_t labelCount,
+                                         uint32_t bucketInstanceId) {
+    std::mt19937 parentGenerator(42);
+    std::mt19937 generator(tileID.canonical.x * 31 + tileID.canonical.y);
+    std::uniform_int_distribution<int> coordinate(0, util::EXTENT - 1);
+    std::uniform_int_distribution<int> name(0, int(labelCount / 4));
+
+    const uint32_t scale = 1u << (tileID.canonical.z - parentID.canonical.z);
+    const int offsetX = (tileID.canonical.x - parentID.canonical.x * scale) * util::EXTENT;
+    const int offsetY = (tileID.canonical.y - parentID.canonical.y * scale) * util::EXTENT;
+
+    std::vector<SymbolInstance> symbolInstances;
+    symbolInstances.reserve(labelCount);
+    while (symbolInstances.size() < labelCount / 2) {
+        // Positions in the parent tile, scaled to this one.
+        const int x = coordinate(parentGenerator) * int(scale) - offsetX;
+        const int y = coordinate(parentGenerator) * int(scale) - offsetY;
+        const auto key = util::convertUTF8ToUTF16("Street " + std::to_string(name(parentGenerator)));
+        if (tileID == parentID || (x >= 0 && y >= 0 && x < util::EXTENT && y < util::EXTENT)) {
+            symbolInstances.push_back(makeSymbolInstance(x, y, key));
+        }
+    }
+    while (symbolInstances.size() < labelCount) {
+        const int x = coordinate(generator);
+        const int y = coordinate(generator);
+        symbolInstances.push_back(
+            makeSymbolInstance(x, y, util::convertUTF8ToUTF16("Street " + std::to_string(name(generator)))));
+    }
+
+    auto bucket = std::make_unique<SymbolBucket>(makeMutable<style::SymbolLayoutProperties::PossiblyEvaluated>(),
+                                                 std::map<std::string, Immutable<style::LayerProperties>>(),
+                                                 16.0f,
+                                                 1.0f,
+                                                 0,
+                                                 false,
+                                                 false,
+                                                 "labels",
+                                                 std::move(symbolInstances),
+                                                 std::vector<SortKeyRange>(),
+                                                 1.0f,
+                                                 false,
+                                                 std::vector<style::TextWritingModeType>(),
+                                                 false);
+    bucket->bucketInstanceId = bucketInstanceId;
+    return bucket;
+}
+
+} // namespace
+
+// Adds a z13 tile and the four z14 tiles covering it, as happens when zooming in.
+static void CrossTileSymbolIndex_addBucket(benchmark::State& state) {
+    const std::size_t labelCount = state.range(0);
+    const OverscaledTileID parentID(13, 0, 13, 4096, 4096);
+
+    std::vector<std::pair<OverscaledTileID, std::unique_ptr<SymbolBucket>>> tiles;
+    tiles.emplace_back(parentID, makeBucket(parentID, parentID, labelCount, 1));
+    uint32_t bucketInstanceId = 1;
+    for (uint32_t x = 8192; x <= 8193; ++x) {
+        for (uint32_t y = 8192; y <= 8193; ++y) {
+            const OverscaledTileID childID(14, 0, 14, x, y);
+            tiles.emplace_back(childID, makeBucket(childID, parentID, labelCount, ++bucketInstanceId));
+        }
+    }
+
+    uint32_t maxCrossTileID = 0;
+    while (state.KeepRunning()) {
+        CrossTileSymbolLayerIndex index(maxCrossTileID);
+        for (auto& tile : tiles) {
+            index.addBucket(tile.first, mat4{}, *tile.second);
+        }
+    }
+    benchmark::DoNotOptimize(maxCrossTileID);
+}
+
+// From a sparse rural area up to a dense city center, per tile.
+BENCHMARK(CrossTileSymbolIndex_addBucket)->Arg(100)->Arg(500)->Arg(2000);
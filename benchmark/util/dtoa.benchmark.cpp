@@ -59,7 +59,19 @@ static void Util_standardDtoaLimits(::benchmark::State& state) {
     }
 }
 
+// Numeric label properties, such as elevations and house numbers, are mostly integers.
+static void Util_dtoaIntegers(::benchmark::State& state) {
+    while (state.KeepRunning()) {
+        util::dtoa(1.);
+        util::dtoa(42.);
+        util::dtoa(-418.);
+        util::dtoa(8848.);
+        util::dtoa(12345678.);
+    }
+}
+
 BENCHMARK(Util_dtoa);
+BENCHMARK(Util_dtoaIntegers);
 BENCHMARK(Util_standardDtoa);
 
 BENCHMARK(Util_dtoaLimits);
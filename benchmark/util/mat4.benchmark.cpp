@@ -0,0 +1,63 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/map/transform.hpp>
+#include <mbgl/util/mat4.hpp>
+
+using namespace mbgl;
+
+namespace {
+
+// The projection matrix of a pitched and rotated map.
+mat4 makeProjMatrix() {
+    Transform transform;
+    transform.resize({ 1024, 768 });
+    transform.jumpTo(CameraOptions().withCenter(LatLng { 37.77, -122.42 }).withZoom(14.5).withBearing(20.0).withPitch(45.0));
+    mat4 projMatrix;
+    transform.getState().getProjMatrix(projMatrix);
+    return projMatrix;
+}
+
+} // namespace
+
+// What RenderTile does for every tile of every layer.
+static void Mat4_MultiplyTileMatrix(benchmark::State& state) {
+    const mat4 projMatrix = makeProjMatrix();
+    mat4 tileMatrix;
+    matrix::identity(tileMatrix);
+    matrix::translate(tileMatrix, tileMatrix, 2620.0 * 512, 6333.0 * 512, 0);
+    matrix::scale(tileMatrix, tileMatrix, 512.0 / 8192, 512.0 / 8192, 1);
+
+    mat4 result;
+    while (state.KeepRunning()) {
+        matrix::multiply(result, projMatrix, tileMatrix);
+        benchmark::DoNotOptimize(result);
+    }
+}
+
+// What symbol projection does for every anchor.
+static void Mat4_TransformPoints(benchmark::State& state) {
+    const mat4 projMatrix = makeProjMatrix();
+
+    vec4 result;
+    while (state.KeepRunning()) {
+        for (int i = 0; i < 1000; i++) {
+            const vec4 point = {{ double(i * 8), double(8192 - i * 8), 0, 1 }};
+            matrix::transformMat4(result, point, projMatrix);
+            benchmark::DoNotOptimize(result);
+        }
+    }
+}
+
+static void Mat4_Invert(benchmark::State& state) {
+    const mat4 projMatrix = makeProjMatrix();
+
+    mat4 result;
+    while (state.KeepRunning()) {
+        matrix::invert(result, projMatrix);
+        benchmark::DoNotOptimize(result);
+    }
+}
+
+BENCHMARK(Mat4_MultiplyTileMatrix);
+BENCHMARK(Mat4_TransformPoints);
+BENCHMARK(Mat4_Invert);
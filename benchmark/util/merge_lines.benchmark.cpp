@@ -0,0 +1,76 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/layout/merge_lines.hpp>
+#include <mbgl/layout/symbol_feature.hpp>
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <string>
+
+using namespace mbgl;
+
+namespace {
+
+class LineFeature : public GeometryTileFeature {
+public:
+    explicit LineFeature(GeometryCollection geometry_) : geometry(std::move(geometry_)) {}
+
+    FeatureType getType() const override { return FeatureType::LineString; }
+    optional<Value> getValue(const std::string&) const override { return {}; }
+    const GeometryCollection& getGeometries() const override { return geometry; }
+
+private:
+    GeometryCollection geometry;
+};
+
+struct Segment {
+    GeometryCollection geometry;
+    std::u16string name;
+};
+
+// The roads of a dense tile: 500 roads sharing 50 names, each split into 40 segments of 8 points,
+// in random order.
+std::vector<Segment> makeRoadSegments() {
+    std::vector<Segment> segments;
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<int16_t> coordinate(0, 8191);
+
+    for (int road = 0; road < 500; ++road) {
+        const std::u16string name = u"Road " + std::u16string(1, char16_t(u'A' + road % 50));
+        GeometryCoordinate point{coordinate(generator), coordinate(generator)};
+        for (int segment = 0; segment < 40; ++segment) {
+            LineString<int16_t> line{point};
+            for (int i = 1; i < 8; ++i) {
+                point = {coordinate(generator), coordinate(generator)};
+                line.push_back(point);
+            }
+            segments.push_back({{line}, name});
+        }
+    }
+
+    std::shuffle(segments.begin(), segments.end(), generator);
+    return segments;
+}
+
+} // namespace
+
+static void MergeLines_Roads(benchmark::State& state) {
+    const std::vector<Segment> segments = makeRoadSegments();
+
+    while (state.KeepRunning()) {
+        state.PauseTiming();
+        SymbolFeatures features;
+        features.reserve(segments.size());
+        for (const auto& segment : segments) {
+            features.emplace_back(std::make_unique<LineFeature>(segment.geometry));
+            features.back().formattedText = TaggedString(segment.name, SectionOptions(1.0, {}));
+        }
+        state.ResumeTiming();
+
+        util::mergeLines(features);
+        benchmark::DoNotOptimize(features.data());
+    }
+}
+
+BENCHMARK(MergeLines_Roads);
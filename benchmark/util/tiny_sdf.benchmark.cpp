@@ -0,0 +1,41 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/util/tiny_sdf.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace mbgl;
+
+namespace {
+
+// A 30x30 raster of the size LocalGlyphRasterizer produces, with a few antialiased strokes
+// roughly like those of a CJK glyph.
+AlphaImage makeGlyphRaster() {
+    const uint32_t size = 30;
+    AlphaImage raster({size, size});
+    raster.fill(0);
+    for (uint32_t y = 0; y < size; y++) {
+        for (uint32_t x = 0; x < size; x++) {
+            const float stroke = std::min({std::abs(float(x) - 15.0f),
+                                           std::abs(float(y) - 8.0f),
+                                           std::abs(float(y) - 20.0f),
+                                           std::abs(float(x) - 6.0f) + (y < 8 || y > 20 ? 30.0f : 0.0f)});
+            const float alpha = std::max(0.0f, std::min(1.0f, 2.0f - stroke));
+            raster.data[y * size + x] = uint8_t(alpha * 255);
+        }
+    }
+    return raster;
+}
+
+} // namespace
+
+static void Util_transformRasterToSDF(::benchmark::State& state) {
+    const AlphaImage raster = makeGlyphRaster();
+    while (state.KeepRunning()) {
+        auto sdf = util::transformRasterToSDF(raster, 8, .25);
+        ::benchmark::DoNotOptimize(sdf.data);
+    }
+}
+
+BENCHMARK(Util_transformRasterToSDF);
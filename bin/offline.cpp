@@ -104,6 +104,9 @@ int main(int argc, char *argv[]) {
     args::ValueFlag<double> maxZoomValue(argumentParser, "number", "Max zoom level", {"maxZoom"});
     args::ValueFlag<double> pixelRatioValue(argumentParser, "number", "Pixel ratio", {"pixelRatio"});
     args::ValueFlag<bool> includeIdeographsValue(argumentParser, "boolean", "Include CJK glyphs", {"includeIdeographs"});
+    args::ValueFlag<uint32_t> maxConcurrentRequestsValue(
+        argumentParser, "number", "Maximum number of concurrent network requests", {"maxConcurrentRequests"});
+    args::Flag packFlag(argumentParser, "pack", "Compact the database file once the download is complete", {"pack"});
 
     try {
         argumentParser.ParseCLI(argc, argv);
@@ -132,6 +135,7 @@ int main(int argc, char *argv[]) {
     const double pixelRatio = pixelRatioValue ? args::get(pixelRatioValue) : 1.0;
     const bool includeIdeographs = includeIdeographsValue ? args::get(includeIdeographsValue) : false;
     const std::string output = outputValue ? args::get(outputValue) : "offline.db";
+    const bool pack = packFlag;
     
     using namespace mbgl;
     
@@ -163,10 +167,23 @@ int main(int argc, char *argv[]) {
 
 
     util::RunLoop loop;
+    const ResourceOptions resourceOptions =
+        ResourceOptions().withAccessToken(token).withBaseURL(apiBaseURL).withCachePath(output);
     std::shared_ptr<DatabaseFileSource> fileSource = std::static_pointer_cast<DatabaseFileSource>(
-        std::shared_ptr<FileSource>(FileSourceManager::get()->getFileSource(
-            FileSourceType::Database,
-            ResourceOptions().withAccessToken(token).withBaseURL(apiBaseURL).withCachePath(output))));
+        std::shared_ptr<FileSource>(FileSourceManager::get()->getFileSource(FileSourceType::Database, resourceOptions)));
+
+    if (maxConcurrentRequestsValue) {
+        // The network file source that the database file source downloads with. Servers that
+        // build packs can usually take far more requests at a time than the default for devices.
+        std::shared_ptr<FileSource> onlineSource(
+            FileSourceManager::get()->getFileSource(FileSourceType::Network, resourceOptions));
+        onlineSource->setProperty(MAX_CONCURRENT_REQUESTS_KEY, uint64_t(args::get(maxConcurrentRequestsValue)));
+    }
+
+    // Packing once at the end is enough, rather than after every change of the regions.
+    if (pack) {
+        fileSource->runPackDatabaseAutomatically(false);
+    }
 
     std::unique_ptr<OfflineRegion> region;
 
@@ -197,11 +214,13 @@ int main(int argc, char *argv[]) {
         Observer(OfflineRegion& region_,
                  std::shared_ptr<DatabaseFileSource> fileSource_,
                  util::RunLoop& loop_,
-                 mbgl::optional<std::string> mergePath_)
+                 mbgl::optional<std::string> mergePath_,
+                 bool pack_)
             : region(region_),
               fileSource(std::move(fileSource_)),
               loop(loop_),
               mergePath(std::move(mergePath_)),
+              pack(pack_),
               start(util::now()) {}
 
         void statusChanged(OfflineRegionStatus status) override {
@@ -226,7 +245,19 @@ int main(int argc, char *argv[]) {
 
             if (status.complete()) {
                 std::cout << "Finished Download" << std::endl;
-                loop.stop();
+                if (!pack) {
+                    loop.stop();
+                    return;
+                }
+                std::cout << "Start Pack" << std::endl;
+                fileSource->packDatabase([this](std::exception_ptr error) {
+                    if (error) {
+                        std::cerr << "Error packing database: " << util::toString(error) << std::endl;
+                    } else {
+                        std::cout << "Finished Pack" << std::endl;
+                    }
+                    loop.stop();
+                });
             }
         }
 
@@ -242,6 +273,7 @@ int main(int argc, char *argv[]) {
         std::shared_ptr<DatabaseFileSource> fileSource;
         util::RunLoop& loop;
         mbgl::optional<std::string> mergePath;
+        const bool pack;
         Timestamp start;
     };
 
@@ -264,7 +296,7 @@ int main(int argc, char *argv[]) {
                 assert(region_);
                 region = std::make_unique<OfflineRegion>(std::move(*region_));
                 fileSource->setOfflineRegionObserver(*region,
-                                                     std::make_unique<Observer>(*region, fileSource, loop, mergePath));
+                                                     std::make_unique<Observer>(*region, fileSource, loop, mergePath, pack));
                 fileSource->setOfflineRegionDownloadState(*region, OfflineRegionDownloadState::Active);
             }
         });
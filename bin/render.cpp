@@ -37,6 +37,14 @@ int main(int argc, char *argv[]) {
     args::ValueFlag<double> pitchValue(argumentParser, "degrees", "Pitch", {'p', "pitch"});
     args::ValueFlag<uint32_t> widthValue(argumentParser, "pixels", "Image width", {'w', "width"});
     args::ValueFlag<uint32_t> heightValue(argumentParser, "pixels", "Image height", {'h', "height"});
+    args::ValueFlag<uint32_t> deviceValue(
+        argumentParser, "index", "GPU to render on, with the EGL headless backend", {"device"});
+
+    args::ValueFlag<int> pngLevelValue(argumentParser, "number", "PNG compression level, 0 to 9", {"png-level"});
+    args::ValueFlag<std::string> pngFilterValue(
+        argumentParser, "filter", "PNG filter: none, sub, up, paeth or adaptive", {"png-filter"});
+    args::ValueFlag<uint32_t> pngThreadsValue(
+        argumentParser, "number", "Threads compressing the PNG", {"png-threads"});
 
     try {
         argumentParser.ParseCLI(argc, argv);
@@ -73,11 +81,40 @@ int main(int argc, char *argv[]) {
 
     const bool debug = debugFlag ? args::get(debugFlag) : false;
 
+    mbgl::PNGEncodeOptions pngOptions;
+    if (pngLevelValue) pngOptions.compressionLevel = args::get(pngLevelValue);
+    if (pngThreadsValue) pngOptions.threads = args::get(pngThreadsValue);
+    if (pngFilterValue) {
+        const std::string filter = args::get(pngFilterValue);
+        if (filter == "none") {
+            pngOptions.filter = mbgl::PNGEncodeOptions::Filter::None;
+        } else if (filter == "sub") {
+            pngOptions.filter = mbgl::PNGEncodeOptions::Filter::Sub;
+        } else if (filter == "up") {
+            pngOptions.filter = mbgl::PNGEncodeOptions::Filter::Up;
+        } else if (filter == "paeth") {
+            pngOptions.filter = mbgl::PNGEncodeOptions::Filter::Paeth;
+        } else if (filter == "adaptive") {
+            pngOptions.filter = mbgl::PNGEncodeOptions::Filter::Adaptive;
+        } else {
+            std::cerr << "Unknown PNG filter: " << filter << std::endl;
+            exit(2);
+        }
+    }
+
     using namespace mbgl;
 
     util::RunLoop loop;
 
-    HeadlessFrontend frontend({ width, height }, pixelRatio);
+    optional<uint32_t> device;
+    if (deviceValue) device = args::get(deviceValue);
+
+    HeadlessFrontend frontend({ width, height },
+                              pixelRatio,
+                              gfx::HeadlessBackend::SwapBehaviour::NoFlush,
+                              gfx::ContextMode::Unique,
+                              nullopt,
+                              device);
     Map map(frontend, MapObserver::nullObserver(),
             MapOptions().withMapMode(MapMode::Static).withSize(frontend.getSize()).withPixelRatio(pixelRatio),
             ResourceOptions().withCachePath(cache_file).withAssetPath(asset_root).withAccessToken(std::string(token)));
@@ -99,7 +136,7 @@ int main(int argc, char *argv[]) {
 
     try {
         std::ofstream out(output, std::ios::binary);
-        out << encodePNG(frontend.render(map).image);
+        out << encodePNG(frontend.render(map).image, pngOptions);
         out.close();
     } catch(std::exception& e) {
         std::cout << "Error: " << e.what() << std::endl;
@@ -65,6 +65,12 @@ public:
         return parent.self();
     }
 
+    // Sets the priority the actor's messages are scheduled with, see `Mailbox::setPriority()`.
+    void setPriority(TaskPriority priority) { parent.mailbox->setPriority(priority); }
+
+    // Sets the tag the actor's messages are scheduled with, see `Mailbox::setTag()`.
+    void setTag(TaskTag tag) { parent.mailbox->setTag(tag); }
+
 private:
     std::shared_ptr<Scheduler> retainer;
     AspiringActor<Object> parent;
@@ -2,10 +2,11 @@
 
 #include <mbgl/util/optional.hpp>
 
+#include <atomic>
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <mutex>
-#include <queue>
 
 #include <mapbox/std/weak.hpp>
 
@@ -13,6 +14,8 @@ namespace mbgl {
 
 class Scheduler;
 class Message;
+enum class TaskPriority : uint8_t;
+enum class TaskTag : uint8_t;
 
 class Mailbox : public std::enable_shared_from_this<Mailbox> {
 public:
@@ -25,6 +28,8 @@ public:
     
     Mailbox(Scheduler&);
 
+    ~Mailbox();
+
     // Attach the given scheduler to this mailbox and begin processing messages
     // sent to it. The mailbox must be a "holding" mailbox, as created by the
     // default constructor Mailbox().
@@ -33,6 +38,12 @@ public:
 
     bool isOpen() const;
 
+    // Sets the priority this mailbox uses for scheduling itself. Applies from the
+    // next time the mailbox is put into the scheduler's task queue.
+    void setPriority(TaskPriority);
+    // Sets the tag the mailbox schedules itself with, see `Scheduler::scheduleTagged()`.
+    void setTag(TaskTag);
+
     void push(std::unique_ptr<Message>);
     void receive();
 
@@ -40,15 +51,34 @@ public:
     static std::function<void()> makeClosure(std::weak_ptr<Mailbox>);
 
 private:
+    // Blocks new push() calls and waits until the ones in progress are finished.
+    void blockPushing();
+    void unblockPushing();
+
+    void enqueue(Message*);
+    Message* dequeue();
+
     mapbox::base::WeakPtr<Scheduler> weakScheduler;
 
+    // receive() and close() are serialized with a mutex, so that closing blocks until the
+    // message being processed is done. The mutex is recursive to allow a mailbox (and thus
+    // the actor) to close itself. Pushing is lock-free: push() only announces itself in
+    // `pushers`, while open() and close() wait for the announced pushes to finish.
     std::recursive_mutex receivingMutex;
-    std::mutex pushingMutex;
+    std::atomic<std::size_t> pushers;
+    std::atomic<bool> pushingBlocked;
 
-    bool closed { false };
+    std::atomic<bool> closed;
+    std::atomic<TaskPriority> priority;
+    std::atomic<TaskTag> tag;
 
-    std::mutex queueMutex;
-    std::queue<std::unique_ptr<Message>> queue;
+    // Intrusive multi-producer/single-consumer queue of messages: producers only swap
+    // `queueHead`, the consumer owns `queueTail`. `queueStub` keeps the queue non-empty
+    // while all the messages are consumed.
+    std::unique_ptr<Message> queueStub;
+    std::atomic<Message*> queueHead;
+    Message* queueTail;
+    std::atomic<std::size_t> queueSize;
 };
 
 } // namespace mbgl
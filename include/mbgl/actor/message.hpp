@@ -2,18 +2,33 @@
 
 #include <mbgl/util/optional.hpp>
 
+#include <atomic>
+#include <cstddef>
 #include <future>
 #include <utility>
 
 namespace mbgl {
 
+class Mailbox;
+
 // A movable type-erasing function wrapper. This allows to store arbitrary invokable
 // things (like std::function<>, or the result of a movable-only std::bind()) in the queue.
 // Source: http://stackoverflow.com/a/29642072/331379
+//
+// A message doubles as the node of its mailbox's queue, so the single allocation made by
+// `actor::makeMessage()` holds both the bound arguments and the queue link. The storage of small
+// messages is recycled through a free list per thread instead of going back to the heap.
 class Message {
 public:
     virtual ~Message() = default;
     virtual void operator()() = 0;
+
+    static void* operator new(std::size_t);
+    static void operator delete(void*, std::size_t) noexcept;
+
+private:
+    friend class Mailbox;
+    std::atomic<Message*> next{nullptr};
 };
 
 template <class Object, class MemberFn, class ArgsTuple>
@@ -1,16 +1,63 @@
 #pragma once
 
+#include <mbgl/util/chrono.hpp>
+#include <mbgl/util/optional.hpp>
 #include <mbgl/util/pass_types.hpp>
 
 #include <mapbox/std/weak.hpp>
 
+#include <cstdint>
 #include <functional>
 #include <memory>
+#include <vector>
 
 namespace mbgl {
 
 class Mailbox;
 
+// Relative priority of a scheduled task. Schedulers supporting prioritization run
+// the pending tasks with a higher priority first, the others treat all tasks alike.
+enum class TaskPriority : uint8_t {
+    High,    // Work the current frame is waiting for, e.g. tiles in the viewport.
+    Default,
+    Low,     // Speculative work, e.g. prefetched or cached tiles.
+};
+
+// What a scheduled task works on, so that schedulers keeping statistics can tell where the time
+// of their threads goes.
+enum class TaskTag : uint8_t {
+    Untagged,
+    Tile,      // Parsing, layout and decoding of tiles.
+    GeoJSON,   // Parsing and tiling of GeoJSON data.
+    Style,     // Parsing of the style and decoding of its images.
+    Sprite,    // Parsing of sprite sheets.
+    Glyph,     // Parsing and local rasterization of glyphs.
+    Placement, // Symbol placement.
+    Query,     // Rendered feature queries.
+    Database,  // Decompression of offline database and ambient cache responses.
+};
+
+constexpr std::size_t TaskTagCount = static_cast<std::size_t>(TaskTag::Database) + 1u;
+
+// The totals for the tasks with one tag that a scheduler ran so far.
+struct TaskStatistics {
+    std::uint64_t count = 0u;
+    // From scheduling a task until it started running.
+    Duration waitTime = Duration::zero();
+    Duration runTime = Duration::zero();
+};
+
+// The threads of a pool made by `Scheduler::MakeThreadPool()`. Unset options are taken from the
+// platform settings used for the shared background pool.
+struct ThreadPoolOptions {
+    // EXPERIMENTAL_WORKER_THREAD_COUNT or the hardware concurrency by default.
+    optional<std::size_t> threadCount;
+    // EXPERIMENTAL_THREAD_PRIORITY_WORKER by default, see `platform::setCurrentThreadPriority()`.
+    optional<double> priority;
+    // The CPUs the threads are restricted to, EXPERIMENTAL_WORKER_THREAD_AFFINITY by default.
+    optional<std::vector<std::size_t>> cpus;
+};
+
 /*
     A `Scheduler` is responsible for coordinating the processing of messages by
     one or more actors via their mailboxes. It's an abstract interface. Currently,
@@ -39,6 +86,20 @@ public:
 
     // Enqueues a function for execution.
     virtual void schedule(std::function<void()>) = 0;
+    // Enqueues a function for execution with the given priority. Schedulers that
+    // do not support prioritization enqueue it as a regular task.
+    virtual void scheduleWithPriority(TaskPriority, std::function<void()> fn) { schedule(std::move(fn)); }
+    // Enqueues a function for execution with the given priority, and accounts for it under the
+    // given tag. Schedulers that do not keep statistics ignore the tag.
+    virtual void scheduleTagged(TaskTag, TaskPriority priority, std::function<void()> fn) {
+        scheduleWithPriority(priority, std::move(fn));
+    }
+    // Returns the statistics of the tasks with the given tag that finished running. Schedulers
+    // that do not keep statistics return zeros; `GetBackground()` and `GetSequenced()` keep them.
+    virtual TaskStatistics getTaskStatistics(TaskTag) const { return {}; }
+    // Returns the number of threads running the scheduled tasks, i.e. how many of them may run at
+    // the same time. Schedulers running all tasks on one thread return 1.
+    virtual std::size_t threadCount() const { return 1u; }
     // Makes a weak pointer to this Scheduler.
     virtual mapbox::base::WeakPtr<Scheduler> makeWeakPtr() = 0;
 
@@ -60,8 +121,13 @@ public:
     // Note: the task result is copied and passed by value.
     template <typename TaskFn, typename ReplyFn>
     void scheduleAndReplyValue(const TaskFn& task, const ReplyFn& reply) {
+        scheduleAndReplyValue(TaskTag::Untagged, task, reply);
+    }
+
+    template <typename TaskFn, typename ReplyFn>
+    void scheduleAndReplyValue(TaskTag tag, const TaskFn& task, const ReplyFn& reply) {
         assert(GetCurrent());
-        scheduleAndReplyValue(task, reply, GetCurrent()->makeWeakPtr());
+        scheduleAndReplyValue(tag, task, reply, GetCurrent()->makeWeakPtr());
     }
 
     // Set/Get the current Scheduler for this thread
@@ -72,10 +138,27 @@ public:
     // will lazily initialize a shared worker pool when ran
     // from the first time.
     // The scheduled tasks might run in parallel on different
-    // threads.
+    // threads. The number of threads in the pool is taken from the
+    // `EXPERIMENTAL_WORKER_THREAD_COUNT` platform setting at the time the
+    // pool is created and defaults to the hardware concurrency.
     // TODO : Rename to GetPool()
     static PassRefPtr<Scheduler> GetBackground();
 
+    // Makes `GetBackground()` return the given scheduler on the current thread instead of the
+    // shared pool, so that the maps living on this thread run their background work on it. The
+    // caller keeps the scheduler alive; `GetBackground()` falls back to the shared pool once it
+    // is gone, or after passing null. Pools made by `MakeThreadPool()` do this on their threads.
+    static void SetBackground(std::weak_ptr<Scheduler>);
+
+    // Makes a pool of worker threads, e.g. one per socket of a server for the maps of the threads
+    // running on that socket, see `SetBackground()`.
+    static std::shared_ptr<Scheduler> MakeThreadPool(const ThreadPoolOptions&);
+
+    // Returns the priority of the task running on the current thread, so that work split off from
+    // it can be scheduled with the same priority. `TaskPriority::Default` outside of the tasks of
+    // the schedulers created by `GetBackground()`, `GetSequenced()` and `MakeThreadPool()`.
+    static TaskPriority GetCurrentPriority();
+
     // Get the *sequenced* scheduler for asynchronous tasks.
     // Unlike the method above, the returned scheduler
     // (once stored) represents a single thread, thus each
@@ -87,8 +170,12 @@ public:
     static PassRefPtr<Scheduler> GetSequenced();
 
 protected:
+    // Sets the priority returned by `GetCurrentPriority()` while a task runs on this thread.
+    static void SetCurrentPriority(TaskPriority);
+
     template <typename TaskFn, typename ReplyFn>
-    void scheduleAndReplyValue(const TaskFn& task,
+    void scheduleAndReplyValue(TaskTag tag,
+                               const TaskFn& task,
                                const ReplyFn& reply,
                                mapbox::base::WeakPtr<Scheduler> replyScheduler) {
         auto scheduled = [replyScheduler = std::move(replyScheduler), task, reply] {
@@ -98,7 +185,7 @@ protected:
             replyScheduler->schedule(std::move(scheduledReply));
         };
 
-        schedule(std::move(scheduled));
+        scheduleTagged(tag, TaskPriority::Default, std::move(scheduled));
     }
 };
 
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <mbgl/tile/tile_id.hpp>
+
+#include <cstddef>
+#include <map>
+#include <string>
+
+namespace mbgl {
+namespace gfx {
+
+// The GPU memory held by the resources of the renderer, attributed to what they were created for.
+struct MemoryUsage {
+    struct Bytes {
+        std::size_t textures = 0;
+        std::size_t vertexBuffers = 0;
+        std::size_t indexBuffers = 0;
+
+        std::size_t total() const {
+            return textures + vertexBuffers + indexBuffers;
+        }
+
+        Bytes& operator+=(const Bytes& r) {
+            textures += r.textures;
+            vertexBuffers += r.vertexBuffers;
+            indexBuffers += r.indexBuffers;
+            return *this;
+        }
+    };
+
+    // All resources, including the ones below.
+    Bytes total;
+
+    // By source ID, including the resources of the source's tiles.
+    std::map<std::string, Bytes> sources;
+    // By source ID and tile. Buckets shared by several layers count towards the first layer
+    // that uploaded them.
+    std::map<std::string, std::map<OverscaledTileID, Bytes>> tiles;
+    // By layer ID, including the buckets of the layer in all tiles.
+    std::map<std::string, Bytes> layers;
+    // Resources shared by the whole map, like "glyph atlas", "image atlas", "line atlas",
+    // "pattern atlas", "static data", and the "texture pool" kept for reuse.
+    std::map<std::string, Bytes> shared;
+    // Resources created for none of the above, like offscreen render targets.
+    Bytes other;
+};
+
+} // namespace gfx
+} // namespace mbgl
@@ -8,10 +8,13 @@ struct RenderingStats {
     bool isZero() const;
 
     int numDrawCalls;
+    // Draws left out because their program wasn't ready yet. Never reset.
+    int numSkippedDrawCalls;
     int numActiveTextures;
     int numCreatedTextures;
     int numBuffers;
     int numFrameBuffers;
+    int numVertexArrays;
 
     int memTextures;
     int memIndexBuffers;
@@ -22,10 +25,12 @@ struct RenderingStats {
 
 inline RenderingStats& RenderingStats::operator+=(const RenderingStats& r) {
     numDrawCalls += r.numDrawCalls;
+    numSkippedDrawCalls += r.numSkippedDrawCalls;
     numActiveTextures += r.numActiveTextures;
     numCreatedTextures += r.numCreatedTextures;
     numBuffers += r.numBuffers;
     numFrameBuffers += r.numFrameBuffers;
+    numVertexArrays += r.numVertexArrays;
 
     memTextures += r.memTextures;
     memIndexBuffers += r.memIndexBuffers;
@@ -43,6 +43,12 @@ public:
     void renderStill(StillImageCallback);
     void renderStill(const CameraOptions&, MapDebugOptions, StillImageCallback);
 
+    // Register a callback that will get called (on the render thread) the next time the map
+    // becomes idle in continuous mode: all resources have been loaded, a complete render occurred
+    // and there are no ongoing transitions.
+    using IdleCallback = std::function<void (std::exception_ptr)>;
+    void whenIdle(IdleCallback);
+
     // Triggers a repaint.
     void triggerRepaint();
 
@@ -119,6 +125,11 @@ public:
     void updateAnnotation(AnnotationID, const Annotation&);
     void removeAnnotation(AnnotationID);
 
+    // Adds or removes many annotations at once, with a single update of the annotation tiles.
+    // The IDs are returned in the order of the annotations.
+    AnnotationIDs addAnnotations(const std::vector<Annotation>&);
+    void removeAnnotations(const AnnotationIDs&);
+
     // Tile prefetching
     //
     // When loading a map, if `PrefetchZoomDelta` is set to any number greater than 0, the map will
@@ -128,6 +139,17 @@ public:
     void setPrefetchZoomDelta(uint8_t delta);
     uint8_t getPrefetchZoomDelta() const;
 
+    // When enabled, the tiles at the destination of animated camera transitions are requested
+    // at low priority while the camera is still on its way, so that they are there on arrival.
+    // Disabled by default.
+    void setPrefetchTransitionTarget(bool);
+    bool getPrefetchTransitionTarget() const;
+
+    // In static mode, the tiles for this camera are requested at low priority along with the
+    // next still images, without waiting for them, so that they are there when the map is moved
+    // to it. Use this to render a series of still images back to back.
+    void setPrefetchCamera(const optional<CameraOptions>&);
+
     // Debug
     void setDebug(MapDebugOptions);
     MapDebugOptions getDebug() const;
@@ -1,7 +1,9 @@
 #pragma once
 
+#include <mbgl/renderer/load_progress.hpp>
 #include <mbgl/style/source.hpp>
 #include <mbgl/style/image.hpp>
+#include <mbgl/util/chrono.hpp>
 
 #include <cstdint>
 #include <string>
@@ -34,6 +36,15 @@ public:
         Full
     };
 
+    // Steps from the construction of the map to its first complete frame.
+    enum class StartupMilestone : uint32_t {
+        StyleRequested,    // Style::loadURL() or Style::loadJSON() was called.
+        StyleParsed,       // The style was parsed and its sources and layers were added.
+        FirstFrame,        // The renderer finished its first frame.
+        FirstTileRendered, // A frame rendered tiles for the first time.
+        ProgramsReady      // A frame rendered tiles without waiting for shader programs to link.
+    };
+
     struct RenderFrameStatus {
         RenderMode mode;
         bool needsRepaint; // In continous mode, shows that there are ongoig transitions.
@@ -53,6 +64,10 @@ public:
     virtual void onDidFinishLoadingStyle() {}
     virtual void onSourceChanged(style::Source&) {}
     virtual void onDidBecomeIdle() {}
+    // Reported whenever what the map still waits for changes, until LoadProgress::isComplete().
+    virtual void onDidUpdateLoadProgress(const LoadProgress&) {}
+    // Reported once per milestone, with the time elapsed since the map was constructed.
+    virtual void onDidReachStartupMilestone(StartupMilestone, Duration) {}
     virtual void onStyleImageMissing(const std::string&) {}
     // This method should return true if unused image can be removed,
     // false otherwise. By default, unused image will be removed.
@@ -15,6 +15,55 @@ DECLARE_MAPBOX_SETTING(EXPERIMENTAL_THREAD_PRIORITY_FILE, thread_priority_file);
 DECLARE_MAPBOX_SETTING(EXPERIMENTAL_THREAD_PRIORITY_NETWORK, thread_priority_network);
 DECLARE_MAPBOX_SETTING(EXPERIMENTAL_THREAD_PRIORITY_DATABASE, thread_priority_database);
 
+// The value for EXPERIMENTAL_WORKER_THREAD_COUNT key, must be an unsigned integer.
+// Read when the shared background pool is (re)created; defaults to the hardware concurrency.
+DECLARE_MAPBOX_SETTING(EXPERIMENTAL_WORKER_THREAD_COUNT, worker_thread_count);
+
+// The value for EXPERIMENTAL_WORKER_THREAD_AFFINITY key, must be an array of unsigned integers. The
+// CPUs the threads of the shared background pool and of the sequenced schedulers are restricted to,
+// e.g. the cores of one socket. Read when a scheduler is created; its threads may run on any CPU by
+// default.
+DECLARE_MAPBOX_SETTING(EXPERIMENTAL_WORKER_THREAD_AFFINITY, worker_thread_affinity);
+
+// The value for EXPERIMENTAL_COMPRESSED_RASTER_TILES key, must be a bool. When true, opaque raster
+// tiles are compressed to ETC1 on the worker threads, which takes an eighth of the texture memory
+// at some loss of quality. GPUs without ETC1 support get the tiles decompressed at upload.
+DECLARE_MAPBOX_SETTING(EXPERIMENTAL_COMPRESSED_RASTER_TILES, compressed_raster_tiles);
+
+// The value for EXPERIMENTAL_PROGRAM_CACHE_DIRECTORY key, must be a string. When set, linked shader
+// programs are cached in that directory where the driver supports program binaries, so that later
+// renderers load them instead of compiling them. Read when a renderer is created.
+DECLARE_MAPBOX_SETTING(EXPERIMENTAL_PROGRAM_CACHE_DIRECTORY, program_cache_directory);
+
+// The value for EXPERIMENTAL_SKIP_UNCHANGED_FRAMES key, must be a bool. When true, continuous maps don't
+// render frames that would look the same as the last complete frame, so that an idle map leaves the GPU
+// idle. Only for renderer frontends that show the last presented frame until the next one, i.e. that
+// don't swap buffers when the renderer didn't present. Read when a renderer is created.
+DECLARE_MAPBOX_SETTING(EXPERIMENTAL_SKIP_UNCHANGED_FRAMES, skip_unchanged_frames);
+
+// The values for EXPERIMENTAL_CACHED_LAYER_RANGE_* keys, must be layer IDs. When both are set, continuous maps render
+// the layers from the first to the last one into a texture, and composite that texture in frames in which neither the
+// camera nor these layers changed. For stacks of static layers below overlays that change often. Read when a renderer
+// is created.
+DECLARE_MAPBOX_SETTING(EXPERIMENTAL_CACHED_LAYER_RANGE_FIRST, cached_layer_range_first);
+DECLARE_MAPBOX_SETTING(EXPERIMENTAL_CACHED_LAYER_RANGE_LAST, cached_layer_range_last);
+
+// The value for EXPERIMENTAL_UPLOAD_BUDGET key, must be an unsigned integer. The initial value of
+// Renderer::setUploadBudget() in bytes, so that tiles arriving together after a zoom jump are uploaded
+// over several frames and their parents or children shown meanwhile. Read when a renderer is created.
+DECLARE_MAPBOX_SETTING(EXPERIMENTAL_UPLOAD_BUDGET, upload_budget);
+
+// The value for EXPERIMENTAL_HEATMAP_DOWNSAMPLING key, must be a positive integer. Heatmap layers draw
+// their density into a texture this many times smaller than the viewport in each dimension, 4 by
+// default. Larger values draw dense heatmaps faster at the cost of a blurrier result. Read when a
+// heatmap layer is added to a renderer.
+DECLARE_MAPBOX_SETTING(EXPERIMENTAL_HEATMAP_DOWNSAMPLING, heatmap_downsampling);
+
+// The value for EXPERIMENTAL_CONCURRENT_PLACEMENT key, must be a bool. When true, maps without cross-source
+// collisions place the symbols of each source on a thread of the background scheduler. The result is the same as
+// placing them one source after the other. Read when a renderer is created.
+DECLARE_MAPBOX_SETTING(EXPERIMENTAL_CONCURRENT_PLACEMENT, concurrent_placement);
+
 // Settings class provides non-persistent, in-process key-value storage.
 class Settings final {
 public:
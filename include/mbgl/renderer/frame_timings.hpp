@@ -0,0 +1,41 @@
+#pragma once
+
+#include <mbgl/util/chrono.hpp>
+#include <mbgl/util/optional.hpp>
+
+#include <string>
+#include <vector>
+
+namespace mbgl {
+
+// Where the time of a frame went, as reported by RendererObserver::onDidMeasureFrame(). CPU times
+// are measured on the thread that renders.
+struct FrameTimings {
+    // Turning the latest map state into a render tree, including the evaluation of layers, the
+    // update of sources and symbol placement below.
+    Duration createRenderTree = Duration::zero();
+    Duration evaluateLayers = Duration::zero();
+    Duration updateSources = Duration::zero();
+    Duration placement = Duration::zero();
+
+    // Updating symbol opacities and vertices for the placement.
+    Duration prepare = Duration::zero();
+
+    // Uploading buffers and textures, and encoding the render passes.
+    Duration upload = Duration::zero();
+    Duration render = Duration::zero();
+
+    struct Layer {
+        std::string id;
+        Duration render = Duration::zero();
+    };
+    // The time spent encoding each rendered layer in all render passes, bottom to top.
+    std::vector<Layer> layers;
+
+    // The GPU time of a recent frame, measured with timer queries. GPU measurements complete a few
+    // frames late, and are missing where the driver doesn't support EXT_disjoint_timer_query or
+    // ARB_timer_query, or when a measurement was invalidated.
+    optional<Duration> gpu;
+};
+
+} // namespace mbgl
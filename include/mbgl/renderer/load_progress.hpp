@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace mbgl {
+
+// What the renderer still waits for before the map is fully loaded, as reported by
+// RendererObserver::onDidUpdateLoadProgress() whenever it changes.
+struct LoadProgress {
+    struct Source {
+        std::string id;
+        // Tiles that are still loading, parsing or waiting for their upload. Sources that aren't
+        // tiled count as a single tile.
+        std::size_t pendingTiles = 0;
+
+        friend bool operator==(const Source& lhs, const Source& rhs) {
+            return lhs.id == rhs.id && lhs.pendingTiles == rhs.pendingTiles;
+        }
+    };
+    // The enabled sources, in style order.
+    std::vector<Source> sources;
+    // Glyph ranges that are being requested or rasterized.
+    std::size_t pendingGlyphRanges = 0;
+    // Tiles waiting for the sprite or for missing images.
+    std::size_t pendingImageRequests = 0;
+    // In continuous mode, a symbol placement spread over frames hasn't been committed yet, or
+    // symbols are still fading.
+    bool placementPending = false;
+
+    bool isComplete() const {
+        for (const auto& source : sources) {
+            if (source.pendingTiles) return false;
+        }
+        return !pendingGlyphRanges && !pendingImageRequests && !placementPending;
+    }
+
+    friend bool operator==(const LoadProgress& lhs, const LoadProgress& rhs) {
+        return lhs.sources == rhs.sources && lhs.pendingGlyphRanges == rhs.pendingGlyphRanges &&
+               lhs.pendingImageRequests == rhs.pendingImageRequests && lhs.placementPending == rhs.placementPending;
+    }
+
+    friend bool operator!=(const LoadProgress& lhs, const LoadProgress& rhs) { return !(lhs == rhs); }
+};
+
+} // namespace mbgl
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <mbgl/util/chrono.hpp>
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace mbgl {
+
+// What a symbol placement did, as reported by RendererObserver::onDidPlaceSymbols() once the
+// placement is committed.
+struct PlacementStatistics {
+    struct Layer {
+        std::string id;
+        // Symbols that went through collision detection, and those whose result was carried over
+        // from the previous placement without collision detection.
+        std::size_t symbols = 0;
+        std::size_t carriedOver = 0;
+        std::size_t placed = 0;
+        // Symbols that weren't placed because they collided with symbols placed before them, and
+        // because they were outside of the viewport and its padding, or crossed the tile edges they
+        // have to avoid. Line labels that don't fit along their lines are neither.
+        std::size_t collisions = 0;
+        std::size_t offscreen = 0;
+        // The cells of the collision grid looked into by the collision tests of the layer.
+        std::size_t gridCells = 0;
+        // The CPU time spent placing the layer, which is spread across frames where placement has
+        // a time budget.
+        Duration time = Duration::zero();
+    };
+    // The layers with symbols, in the order they were placed: top to bottom, and grouped by
+    // source where the sources were placed concurrently.
+    std::vector<Layer> layers;
+};
+
+} // namespace mbgl
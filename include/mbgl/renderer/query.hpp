@@ -1,5 +1,6 @@
 #pragma once
 
+#include <mbgl/util/geo.hpp>
 #include <mbgl/util/optional.hpp>
 #include <mbgl/style/filter.hpp>
 
@@ -22,6 +23,15 @@ public:
     optional<std::vector<std::string>> layerIDs;
 
     optional<style::Filter> filter;
+
+    /** The maximum number of features to return, the first ones in the result order */
+    optional<std::size_t> limit;
+
+    /** The properties to include in the resulting features, or none to only get their ids */
+    optional<std::vector<std::string>> properties;
+
+    /** Whether to include the geometries of the resulting features */
+    bool geometry = true;
 };
 
 /**
@@ -38,6 +48,12 @@ public:
     optional<std::vector<std::string>> sourceLayers;
 
     optional<style::Filter> filter;
+
+    // Only features intersecting these bounds, tiles outside of them aren't read at all
+    optional<LatLngBounds> bounds;
+
+    // Returns features with the same id, e.g. the parts of a feature split across tiles, once
+    bool deduplicate = false;
 };
 
 } // namespace mbgl
@@ -2,6 +2,8 @@
 
 #include <mbgl/renderer/query.hpp>
 #include <mbgl/annotation/annotation.hpp>
+#include <mbgl/gfx/memory_usage.hpp>
+#include <mbgl/util/chrono.hpp>
 #include <mbgl/util/geo.hpp>
 #include <mbgl/util/geojson.hpp>
 
@@ -40,6 +42,14 @@ struct PlacedSymbolData {
     std::string layer;
 };
 
+// How urgently the system asks to free memory.
+enum class MemoryPressure : uint8_t {
+    // Frees what is cheap to get back, and keeps enough cached to move around the map.
+    Moderate,
+    // Frees everything that the current frame doesn't need.
+    Critical,
+};
+
 class Renderer {
 public:
     Renderer(gfx::RendererBackend&, float pixelRatio_, const optional<std::string>& localFontFamily = {});
@@ -51,6 +61,19 @@ public:
 
     void render(const std::shared_ptr<UpdateParameters>&);
 
+    /**
+     * @brief Renders a frame in two steps, `render()` being both in a row.
+     *
+     * `prepare()` updates the sources and layers, places the symbols and builds the render tree
+     * of the frame, and returns whether there is a frame to draw. `draw()` uploads and draws the
+     * prepared frame, and does nothing if there is none. Both run on the render thread with the
+     * backend active, as custom layers set up their GL resources while the frame is prepared.
+     * Memory reductions, `clearData()` and a lost context discard a prepared frame that wasn't
+     * drawn.
+     */
+    bool prepare(const std::shared_ptr<UpdateParameters>&);
+    void draw();
+
     // Feature queries
     std::vector<Feature> queryRenderedFeatures(const ScreenLineString&, const RenderedQueryOptions& options = {}) const;
     std::vector<Feature> queryRenderedFeatures(const ScreenCoordinate& point, const RenderedQueryOptions& options = {}) const;
@@ -70,6 +93,10 @@ public:
     void setFeatureState(const std::string& sourceID, const optional<std::string>& sourceLayerID,
                          const std::string& featureID, const FeatureState& state);
 
+    // Applies the state changes of many features of a source at once. Updates of the same
+    // source layer should be adjacent in the list.
+    void setFeatureStates(const std::string& sourceID, const std::vector<FeatureStateUpdate>& updates);
+
     void getFeatureState(FeatureState& state,
                          const std::string& sourceID,
                          const optional<std::string>& sourceLayerID,
@@ -80,6 +107,33 @@ public:
                             const optional<std::string>& featureID,
                             const optional<std::string>& stateKey);
 
+    /**
+     * @brief In Continuous map mode, limits the time spent on symbol placement per frame.
+     *
+     * If placing all symbol layers takes longer, placement continues in the following frames
+     * and its results are shown once all layers are placed. Placement isn't limited by default.
+     */
+    void setPlacementTimeBudget(optional<Duration>);
+
+    /**
+     * @brief In Continuous map mode, limits the bytes of the tiles rendered for the first time per frame.
+     *
+     * Tiles are parsed and their vertex data is built on the worker threads, so that their upload to
+     * the GPU is what remains for the render thread. When many tiles arrive at once, those whose data
+     * would exceed the budget wait for the following frames, and their parents or children are rendered
+     * in their place. The tile closest to the center of the viewport is always rendered. Uploads aren't
+     * limited by default, unless the platform::EXPERIMENTAL_UPLOAD_BUDGET setting is set.
+     */
+    void setUploadBudget(optional<std::size_t> bytes);
+
+    /**
+     * @brief Sets the bytes that the images provided for missing images may take while no tile uses them.
+     *
+     * Past it, the renderer asks to remove the least recently used of them once the map has loaded,
+     * see MapObserver::onCanRemoveUnusedStyleImage(). Defaults to util::DEFAULT_ON_DEMAND_IMAGES_CACHE_SIZE.
+     */
+    void setOnDemandImagesCacheSize(std::size_t bytes);
+
     // Debug
     void dumpDebugLogs();
 
@@ -105,6 +159,20 @@ public:
     void reduceMemoryUse();
     void clearData();
 
+    /**
+     * @brief Frees memory in response to a pressure signal of the system.
+     *
+     * Memory is freed in the order of what it costs to get it back: GL objects waiting for
+     * deletion, then the tiles kept for reuse, and under critical pressure the dash and pattern
+     * atlases, the loaded glyph ranges and the unused style images. The tile caches of all sources
+     * are trimmed to hold `targetBytes` together, least recently used tiles first. Without a target,
+     * moderate pressure halves them and critical pressure empties them.
+     */
+    void reduceMemoryUse(MemoryPressure, optional<std::size_t> targetBytes = nullopt);
+
+    // The GPU memory held by the renderer, by source, tile, layer and resource type.
+    gfx::MemoryUsage getGPUMemoryUsage() const;
+
 private:
     class Impl;
     std::unique_ptr<Impl> impl;
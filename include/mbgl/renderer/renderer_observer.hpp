@@ -5,6 +5,10 @@
 
 namespace mbgl {
 
+struct FrameTimings;
+struct LoadProgress;
+struct PlacementStatistics;
+
 class RendererObserver {
 public:
     virtual ~RendererObserver() = default;
@@ -14,6 +18,12 @@ public:
         Full
     };
 
+    enum class StartupMilestone : uint32_t {
+        FirstFrame,
+        FirstTileRendered,
+        ProgramsReady
+    };
+
     // Signals that a repaint is required
     virtual void onInvalidate() {}
 
@@ -29,9 +39,21 @@ public:
     // End of frame, booleans flags that a repaint is required and that placement changed.
     virtual void onDidFinishRenderingFrame(RenderMode, bool /*repaint*/, bool /*placementChanged*/) {}
 
+    // Timings of the frame that just finished, only reported in builds with MBGL_WITH_FRAME_TIMINGS
+    virtual void onDidMeasureFrame(const FrameTimings&) {}
+
+    // Symbol placement that was committed in the frame that just finished
+    virtual void onDidPlaceSymbols(const PlacementStatistics&) {}
+
+    // What the renderer still waits for, reported whenever it changes while the frames are prepared
+    virtual void onDidUpdateLoadProgress(const LoadProgress&) {}
+
     // Final frame
     virtual void onDidFinishRenderingMap() {}
 
+    // Startup step of the renderer, each reported once at the end of the frame that reached it
+    virtual void onDidReachStartupMilestone(StartupMilestone) {}
+
     // Style is missing an image
     using StyleImageMissingCallback = std::function<void()>;
     virtual void onStyleImageMissing(const std::string&, const StyleImageMissingCallback& done) { done(); }
@@ -20,6 +20,7 @@ public:
     void forward(const Resource&, const Response&, std::function<void()> callback) override;
     bool canRequest(const Resource&) const override;
     void setProperty(const std::string&, const mapbox::base::Value&) override;
+    mapbox::base::Value getProperty(const std::string&) const override;
     void pause() override;
     void resume() override;
 
@@ -194,9 +195,15 @@ public:
      *
      * Merged regions may not be in a completed status if the secondary database
      * does not contain all the tiles or resources required by the region definition.
+     *
+     * Tiles and resources are copied in chunks, and the database thread answers the
+     * requests queued in the meantime between chunks. After each chunk, `progress` is
+     * executed on the database thread with the number of region tiles and resources
+     * copied so far and in total. A merge that fails keeps the chunks it copied.
      */
     virtual void mergeOfflineRegions(const std::string& sideDatabasePath,
-                                     std::function<void(expected<OfflineRegions, std::exception_ptr>)>);
+                                     std::function<void(expected<OfflineRegions, std::exception_ptr>)>,
+                                     std::function<void(uint64_t completed, uint64_t total)> progress = {});
 
     /*
      * Remove an offline region from the database and perform any resources evictions
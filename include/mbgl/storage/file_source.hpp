@@ -25,7 +25,9 @@ enum FileSourceType : uint8_t {
     // Resource loader acts as a proxy and has logic
     // for request delegation to Asset, Cache, and other
     // file sources.
-    ResourceLoader
+    ResourceLoader,
+    // Single-file tile archives, like PMTiles.
+    TileArchive
 };
 
 // TODO: Rename to ResourceProvider to avoid confusion with
@@ -104,10 +106,62 @@ constexpr const char* API_BASE_URL_KEY = "api-base-url";
 // type: unsigned
 constexpr const char* MAX_CONCURRENT_REQUESTS_KEY = "max-concurrent-requests";
 
+// Property name to set / get maximum number of concurrent requests to the same host, within the
+// overall maximum. 0, the default, doesn't limit them.
+// type: unsigned
+constexpr const char* MAX_CONCURRENT_REQUESTS_PER_HOST_KEY = "max-concurrent-requests-per-host";
+
+// Properties that may be supported by resource loaders:
+
+// Property name to set / get the size in bytes of the in-memory cache of recently loaded resources,
+// which is consulted before the database. 0 disables the cache.
+// type: unsigned
+constexpr const char* MEMORY_CACHE_SIZE_KEY = "memory-cache-size";
+
+// Property name to get the statistics of the in-memory cache.
+// type: object of {"hits": unsigned, "misses": unsigned, "size": unsigned, "count": unsigned}, read-only
+constexpr const char* MEMORY_CACHE_STATS_KEY = "memory-cache-stats";
+
+// Property name to get histograms of the response timing phases ("queued", "database", "dns",
+// "connect", "tls", "first-byte", "network"), since the loader was created. Each bucket counts
+// the durations up to its "max-ms" and above the previous one; the last bucket has no limit.
+// type: object of {"requests": unsigned, "mean-ms": double, "max-ms": double,
+//                  "buckets": array of {"max-ms": unsigned, "count": unsigned}}, read-only
+constexpr const char* REQUEST_TIMING_KEY = "request-timing";
+
 // Properties that may be supported by database file sources:
 
 // Property to set database mode. When set, database opens in read-only mode; database opens in read-write-create mode
 // otherwise. type: bool
 constexpr const char* READ_ONLY_MODE_KEY = "read-only-mode";
 
+// Property to set the number of ambient cache writes committed together. Buffered writes are
+// committed at least once a second. 0 commits every write on its own, which is the default.
+// type: unsigned
+constexpr const char* WRITE_BATCH_SIZE_KEY = "write-batch-size";
+
+// Property to set the resolution in seconds of the access times that the ambient cache evicts the
+// least recently used entries by. When set, the access times of cache hits are buffered, and
+// written along with batched writes at least once a second and only where they changed. 0 writes
+// them with every cache hit, which is the default.
+// type: unsigned
+constexpr const char* ACCESS_TIME_RESOLUTION_KEY = "access-time-resolution";
+
+// Property to use the WAL journal with NORMAL synchronization. This saves most fsyncs, but the
+// latest writes may be lost on power failure, so it is meant for ambient-cache-only databases.
+// type: bool
+constexpr const char* WRITE_AHEAD_LOG_KEY = "write-ahead-log";
+
+// Property to set / get the number of read-only connections that serve cache reads on threads of
+// their own, in parallel with the writes and region downloads on the database thread. Enables the
+// write-ahead log. Reads don't see writes that are still batched. 0, the default, serves reads on
+// the database thread.
+// type: unsigned
+constexpr const char* READER_POOL_SIZE_KEY = "reader-pool-size";
+
+// Property to get the time between requesting resources and answering the requests, by database
+// queue ("database", "reader-0", ...), since the file source was created.
+// type: object of {"requests": unsigned, "mean-ms": double, "max-ms": double}, read-only
+constexpr const char* QUEUE_LATENCY_KEY = "queue-latency";
+
 } // namespace mbgl
@@ -6,6 +6,8 @@
 #include <mbgl/util/font_stack.hpp>
 #include <mbgl/util/tileset.hpp>
 
+#include <atomic>
+#include <memory>
 #include <string>
 
 namespace mbgl {
@@ -95,6 +97,11 @@ public:
     optional<Timestamp> priorExpires = {};
     optional<std::string> priorEtag = {};
     std::shared_ptr<const std::string> priorData;
+
+    // Orders the queued network requests of the same priority, lower values first. It is shared
+    // with the copies of the resource, so the requester can update it while a request waits,
+    // e.g. tiles by their distance from the center of the viewport. Requests without it go first.
+    std::shared_ptr<std::atomic<uint32_t>> queueOrder;
 };
 
 inline bool Resource::hasLoadingMethod(Resource::LoadingMethod method) const {
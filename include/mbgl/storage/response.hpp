@@ -37,6 +37,11 @@ public:
     optional<Timestamp> expires;
     optional<std::string> etag;
 
+    class Timing;
+    // Where the time to answer the request went, as far as the file source that answered it
+    // measured it.
+    std::unique_ptr<const Timing> timing;
+
     bool isFresh() const {
         return expires ? *expires > util::now() : !error;
     }
@@ -69,4 +74,22 @@ public:
     Error(Reason, std::string = "", optional<Timestamp> = {});
 };
 
+class Response::Timing {
+public:
+    // Waiting for a free network request slot.
+    optional<Duration> queued;
+    // Looking the resource up in the offline database.
+    optional<Duration> database;
+
+    // The phases of the network request, which follow each other.
+    optional<Duration> dns;
+    optional<Duration> connect;
+    // Absent for plain HTTP requests.
+    optional<Duration> tls;
+    // From sending the request until the first byte of the response arrived.
+    optional<Duration> firstByte;
+    // The whole network request, including the phases above and the transfer.
+    optional<Duration> network;
+};
+
 } // namespace mbgl
@@ -39,7 +39,10 @@ public:
     }
 
     bool isDataDriven() const { return false; }
+    // Ramps are evaluated over their own parameter, not the zoom level.
+    bool isZoomConstant() const { return true; }
     bool hasDataDrivenPropertyDifference(const ColorRampPropertyValue&) const { return false; }
+    bool hasDataDrivenKindDifference(const ColorRampPropertyValue&) const { return false; }
 
     const expression::Expression& getExpression() const { return *value; }
 };
@@ -11,7 +11,8 @@ namespace conversion {
 template <>
 struct Converter<Filter> {
 public:
-    optional<Filter> operator()(const Convertible& value, Error& error) const;
+    // With `deferParsing`, only the JSON of the filter is kept, see Filter::deferred().
+    optional<Filter> operator()(const Convertible& value, Error& error, bool deferParsing = false) const;
 };
 
 } // namespace conversion
@@ -13,7 +13,8 @@ namespace conversion {
 template <>
 struct Converter<std::unique_ptr<Layer>> {
 public:
-    optional<std::unique_ptr<Layer>> operator()(const Convertible& value, Error& error) const;
+    // With `deferFilter`, the filter of the layer is only parsed once it is first used, see Filter::deferred().
+    optional<std::unique_ptr<Layer>> operator()(const Convertible& value, Error& error, bool deferFilter = false) const;
 };
 
 optional<Error> setPaintProperties(Layer& layer, const Convertible& value);
@@ -34,6 +34,9 @@ public:
     
     mbgl::Value serialize() const override;
     std::string getOperator() const override { return "match"; }
+
+    const Branches& getBranches() const { return branches; }
+
 private:
     std::unique_ptr<Expression> input;
     Branches branches;
@@ -42,6 +45,9 @@ private:
 
 ParseResult parseMatch(const mbgl::style::conversion::Convertible& value, ParsingContext& ctx);
 
+// Returns the expression as a match on string labels, or nullptr if it is not one.
+const Match<std::string>* asStringMatch(const Expression&);
+
 } // namespace expression
 } // namespace style
 } // namespace mbgl
@@ -1,10 +1,15 @@
 #pragma once
 
 #include <mbgl/style/expression/expression.hpp>
+#include <mbgl/tile/tile_id.hpp>
 #include <mbgl/util/geojson.hpp>
 #include <mbgl/util/geometry_within.hpp>
 #include <mbgl/util/optional.hpp>
 
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
 namespace mbgl {
 namespace style {
 namespace expression {
@@ -29,8 +34,16 @@ public:
     std::string getOperator() const override;
 
 private:
+    // The polygons in the coordinates of the tile, with their grid. Built on the first evaluation
+    // for a tile instead of for every feature.
+    std::shared_ptr<const PolygonIndex> getIndex(const CanonicalTileID&) const;
+
     GeoJSON geoJSONSource;
     Feature::geometry_type geometries;
+
+    // Evaluated from the worker threads of several tiles at once.
+    mutable std::mutex mutex;
+    mutable std::unordered_map<CanonicalTileID, std::shared_ptr<const PolygonIndex>> indexes;
 };
 
 } // namespace expression
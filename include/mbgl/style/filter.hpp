@@ -12,26 +12,37 @@
 namespace mbgl {
 namespace style {
 
+class CompiledFilter;
+
 class Filter {
 public:
     optional<std::shared_ptr<const expression::Expression>> expression;
 private:
     optional<mbgl::Value> legacyFilter;
+    // Fast path for the expression, see CompiledFilter. Not set if nothing could be compiled.
+    std::shared_ptr<const CompiledFilter> compiled;
+    // Only set for filters created with Filter::deferred(). Shared by copies, so that each filter is parsed once.
+    class Deferred;
+    std::shared_ptr<Deferred> deferred_;
 public:
     Filter() = default;
 
-    Filter(expression::ParseResult _expression, optional<mbgl::Value> _filter = {})
-    : expression(std::move(*_expression)),
-     legacyFilter(std::move(_filter)){
-        assert(!expression || *expression != nullptr);
-    }
-    
+    Filter(expression::ParseResult _expression, optional<mbgl::Value> _filter = {});
+
+    // A filter that is only parsed from its JSON when it is first evaluated. Parse errors are logged
+    // then, and the filter doesn't match any feature.
+    static Filter deferred(mbgl::Value json);
+
     bool operator()(const expression::EvaluationContext& context) const;
 
-    operator bool() const { return expression || legacyFilter; }
+    operator bool() const { return expression || legacyFilter || deferred_; }
+
+    bool isDeferred() const { return bool(deferred_); }
 
     friend bool operator==(const Filter& lhs, const Filter& rhs) {
-        if (!lhs.expression || !rhs.expression) {
+        if (lhs.deferred_ || rhs.deferred_) {
+            return lhs.deferred_ == rhs.deferred_ || lhs.serialize() == rhs.serialize();
+        } else if (!lhs.expression || !rhs.expression) {
             return lhs.expression == rhs.expression;
         } else {
             return *(lhs.expression) == *(rhs.expression);
@@ -42,15 +53,7 @@ public:
         return !(lhs == rhs);
     }
     
-    mbgl::Value serialize() const {
-        if (legacyFilter) {
-            return *legacyFilter;
-        }
-        else if (expression) {
-            return (**expression).serialize();
-        }
-        return NullValue();
-    }
+    mbgl::Value serialize() const;
 };
 
 } // namespace style
@@ -5,11 +5,20 @@
 #include <mbgl/style/expression/interpolate.hpp>
 #include <mbgl/style/expression/step.hpp>
 #include <mbgl/style/expression/find_zoom_curve.hpp>
+#include <mbgl/util/color.hpp>
+#include <mbgl/util/interpolate.hpp>
 #include <mbgl/util/range.hpp>
 
+#include <type_traits>
+#include <vector>
+
 namespace mbgl {
 namespace style {
 
+namespace expression {
+class CompiledExpression;
+} // namespace expression
+
 class PropertyExpressionBase {
 public:
     explicit PropertyExpressionBase(std::unique_ptr<expression::Expression>);
@@ -29,7 +38,50 @@ public:
     bool useIntegerZoom = false;
 
 protected:
+    // Compiles the expression for the given result type, see expression::CompiledExpression.
+    void compileNumber();
+    void compileColor();
+    optional<float> evaluateCompiled(const expression::EvaluationContext&, float*) const;
+    optional<Color> evaluateCompiled(const expression::EvaluationContext&, Color*) const;
+    template <class T>
+    optional<T> evaluateCompiled(const expression::EvaluationContext&, T*) const {
+        assert(false);
+        return nullopt;
+    }
+    void evaluateCompiled(const expression::EvaluationContext&,
+                          const std::vector<const GeometryTileFeature*>&,
+                          std::vector<float>& results,
+                          float fallback) const;
+    void evaluateCompiled(const expression::EvaluationContext&,
+                          const std::vector<const GeometryTileFeature*>&,
+                          std::vector<Color>& results,
+                          Color fallback) const;
+    template <class T>
+    void evaluateCompiled(const expression::EvaluationContext&,
+                          const std::vector<const GeometryTileFeature*>&,
+                          std::vector<T>&,
+                          T) const {
+        assert(false);
+    }
+
+    // Camera functions are mostly a curve over the zoom level with literal outputs. Those are
+    // evaluated from the pre-converted outputs instead of walking the expression, see
+    // PropertyExpression::evaluate(float).
+    class LiteralZoomCurve;
+    struct ZoomCurvePosition {
+        std::size_t lower;
+        std::size_t upper;
+        // The interpolation factor between the lower and upper output. Always 0 for steps.
+        float t;
+    };
+    bool isLiteralZoomInterpolation() const noexcept;
+    // Empty if the expression isn't a literal zoom curve.
+    const std::vector<expression::Value>& literalZoomCurveOutputs() const;
+    optional<ZoomCurvePosition> literalZoomCurvePosition(float zoom) const noexcept;
+
     std::shared_ptr<const expression::Expression> expression;
+    std::shared_ptr<const expression::CompiledExpression> compiled;
+    std::shared_ptr<const LiteralZoomCurve> literalZoomCurve;
     variant<std::nullptr_t, const expression::Interpolate*, const expression::Step*> zoomCurve;
     bool isZoomConstant_;
     bool isFeatureConstant_;
@@ -43,9 +95,19 @@ public:
     PropertyExpression(std::unique_ptr<expression::Expression> expression_, optional<T> defaultValue_ = nullopt)
         : PropertyExpressionBase(std::move(expression_)),
           defaultValue(std::move(defaultValue_)) {
+        if (!isFeatureConstant()) {
+            compile(static_cast<T*>(nullptr));
+        }
+        if (literalZoomCurve) {
+            convertZoomCurveOutputs();
+        }
     }
 
     T evaluate(const expression::EvaluationContext& context, T finalDefaultValue = T()) const {
+        if (compiled) {
+            const optional<T> typed = evaluateCompiled(context, static_cast<T*>(nullptr));
+            return typed ? *typed : defaultValue ? *defaultValue : finalDefaultValue;
+        }
         const expression::EvaluationResult result = expression->evaluate(context);
         if (result) {
             const optional<T> typed = expression::fromExpressionValue<T>(*result);
@@ -57,6 +119,14 @@ public:
     T evaluate(float zoom) const {
         assert(!isZoomConstant());
         assert(isFeatureConstant());
+        if (zoomCurveOutputs) {
+            if (optional<ZoomCurvePosition> position = literalZoomCurvePosition(zoom)) {
+                const auto& outputs = *zoomCurveOutputs;
+                if (position->t == 0.0f) return T(outputs[position->lower]);
+                if (position->t == 1.0f) return T(outputs[position->upper]);
+                return interpolateZoomCurve(outputs[position->lower], outputs[position->upper], position->t);
+            }
+        }
         return evaluate(expression::EvaluationContext(zoom));
     }
 
@@ -123,6 +193,26 @@ public:
         return evaluate(expression::EvaluationContext(zoom, &feature, &state), finalDefaultValue);
     }
 
+    // Evaluates the expression for each of the features, with `context` providing everything
+    // but the feature, and stores one value per feature in `results`. Compiled expressions
+    // compute the parts that are the same for all features only once per batch.
+    void evaluate(const expression::EvaluationContext& context,
+                  const std::vector<const GeometryTileFeature*>& features,
+                  std::vector<T>& results,
+                  T finalDefaultValue = T()) const {
+        if (compiled) {
+            evaluateCompiled(context, features, results, defaultValue ? *defaultValue : finalDefaultValue);
+            return;
+        }
+        results.clear();
+        results.reserve(features.size());
+        expression::EvaluationContext featureContext(context);
+        for (const GeometryTileFeature* feature : features) {
+            featureContext.feature = feature;
+            results.push_back(evaluate(featureContext, finalDefaultValue));
+        }
+    }
+
     std::vector<optional<T>> possibleOutputs() const {
         return expression::fromExpressionValues<T>(expression->possibleOutputs());
     }
@@ -133,7 +223,41 @@ public:
     }
 
 private:
+    template <class U>
+    void compile(U*) {}
+    void compile(float*) { compileNumber(); }
+    void compile(Color*) { compileColor(); }
+
+    // Numbers are interpolated as doubles by the expressions, and only then converted.
+    using ZoomCurveOutput = std::conditional_t<std::is_same<T, float>::value, double, T>;
+
+    void convertZoomCurveOutputs() {
+        if (isLiteralZoomInterpolation() && !std::is_same<T, float>::value && !std::is_same<T, Color>::value) {
+            return;
+        }
+        auto outputs = std::make_shared<std::vector<ZoomCurveOutput>>();
+        for (const expression::Value& value : literalZoomCurveOutputs()) {
+            optional<ZoomCurveOutput> output = expression::fromExpressionValue<ZoomCurveOutput>(value);
+            if (!output) return;
+            outputs->push_back(std::move(*output));
+        }
+        zoomCurveOutputs = std::move(outputs);
+    }
+
+    template <class U>
+    static T interpolateZoomCurve(const U& lower, const U&, float) {
+        assert(false);
+        return T(lower);
+    }
+    static T interpolateZoomCurve(const double& lower, const double& upper, float t) {
+        return static_cast<T>(util::interpolate(lower, upper, t));
+    }
+    static T interpolateZoomCurve(const Color& lower, const Color& upper, float t) {
+        return util::interpolate(lower, upper, t);
+    }
+
     optional<T> defaultValue;
+    std::shared_ptr<const std::vector<ZoomCurveOutput>> zoomCurveOutputs;
 };
 
 } // namespace style
@@ -85,6 +85,12 @@ public:
     bool hasDataDrivenPropertyDifference(const PropertyValue<T>& other) const {
         return *this != other && (isDataDriven() || other.isDataDriven());
     }
+
+    // Whether one of the values is data-driven and the other one isn't, which changes the kind of
+    // the paint property binder.
+    bool hasDataDrivenKindDifference(const PropertyValue<T>& other) const {
+        return isDataDriven() != other.isDataDriven();
+    }
 };
 
 } // namespace style
@@ -89,6 +89,12 @@ public:
     // parent tile may be used.
     void setMaxOverscaleFactorForParentTiles(optional<uint8_t> overscaleFactor) noexcept;
     optional<uint8_t> getMaxOverscaleFactorForParentTiles() const noexcept;
+
+    // Sets a limit, in bytes, for the memory used by tiles that are kept in this
+    // source's cache after they are no longer visible. The least recently used
+    // tiles are evicted first. By default, only the tile count is limited.
+    void setMaxTileCacheBytes(optional<uint64_t> maxBytes) noexcept;
+    optional<uint64_t> getMaxTileCacheBytes() const noexcept;
     void dumpDebugLogs() const;
 
     virtual bool supportsLayerType(const mbgl::style::LayerTypeInfo*) const = 0;
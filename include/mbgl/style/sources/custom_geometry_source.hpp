@@ -17,6 +17,7 @@ class ThreadPool;
 namespace style {
 
 using TileFunction = std::function<void(const CanonicalTileID&)>;
+using TileDataFunction = std::function<GeoJSON(const CanonicalTileID&)>;
 
 class CustomTileLoader;
 
@@ -33,6 +34,13 @@ public:
     struct Options {
         TileFunction fetchTileFunction;
         TileFunction cancelTileFunction;
+        // Returns the data of a tile on a background thread, instead of fetchTileFunction calling
+        // setTileData(), e.g. for data read from a local file such as a FlatGeobufReader.
+        TileDataFunction loadTileFunction;
+        // The number of tiles loadTileFunction may load at once, which must then be thread-safe.
+        // Further tiles wait, closest to the viewport center first, until they are loaded or no
+        // longer needed.
+        uint8_t maxConcurrentLoads = 1;
         Range<uint8_t> zoomRange = { 0, 18};
         TileOptions tileOptions;
     };
@@ -4,12 +4,17 @@
 #include <mbgl/style/source.hpp>
 #include <mbgl/tile/tile_id.hpp>
 #include <mbgl/util/constants.hpp>
+#include <mbgl/util/feature.hpp>
+#include <mbgl/util/geo.hpp>
 #include <mbgl/util/geojson.hpp>
 #include <mbgl/util/optional.hpp>
 
+#include <atomic>
+#include <functional>
 #include <map>
 #include <memory>
 #include <utility>
+#include <vector>
 
 namespace mbgl {
 
@@ -41,9 +46,12 @@ class GeoJSONData {
 public:
     using TileFeatures = mapbox::feature::feature_collection<int16_t>;
     using Features = mapbox::feature::feature_collection<double>;
+    // Large feature collections are indexed in chunks on the background thread pool. `onProgress`
+    // gets the indexed fraction of the data, possibly on background threads.
     static std::shared_ptr<GeoJSONData> create(const GeoJSON&,
                                                const Immutable<GeoJSONOptions>& = GeoJSONOptions::defaultOptions(),
-                                               std::shared_ptr<Scheduler> scheduler = nullptr);
+                                               std::shared_ptr<Scheduler> scheduler = nullptr,
+                                               const std::function<void(float)>& onProgress = {});
 
     virtual ~GeoJSONData() = default;
     virtual void getTile(const CanonicalTileID&, const std::function<void(TileFeatures)>&) = 0;
@@ -54,6 +62,24 @@ public:
     virtual std::uint8_t getClusterExpansionZoom(std::uint32_t) = 0;
 
     virtual std::shared_ptr<Scheduler> getScheduler() { return nullptr; }
+
+    // Returns new data with the features added or replaced by id, and the features with the removed
+    // ids left out, re-indexing only the affected part of this data. Returns nullptr if the data
+    // doesn't support updates, e.g. with clustering.
+    virtual std::shared_ptr<GeoJSONData> updateFeatures(const Features&, const std::vector<FeatureIdentifier>&) {
+        return nullptr;
+    }
+
+    // For data created by updateFeatures(), the data it was updated from and the bounds of the
+    // features that changed, so that only the tiles covering them need to be reloaded.
+    struct FeatureUpdate {
+        const GeoJSONData* base;
+        std::vector<LatLngBounds> changedBounds;
+    };
+    const optional<FeatureUpdate>& getFeatureUpdate() const { return featureUpdate; }
+
+protected:
+    optional<FeatureUpdate> featureUpdate;
 };
 
 class GeoJSONSource final : public Source {
@@ -64,10 +90,17 @@ public:
     void setURL(const std::string& url);
     void setGeoJSON(const GeoJSON&);
     void setGeoJSONData(std::shared_ptr<GeoJSONData>);
+    // Adds or replaces the features by id and removes the features with the given ids, without
+    // re-indexing all of the data.
+    void updateFeatures(const GeoJSONData::Features&, const std::vector<FeatureIdentifier>& removed = {});
 
     optional<std::string> getURL() const;
     const GeoJSONOptions& getOptions() const;
 
+    // The fraction of the data at the URL that is indexed, for showing progress while a large
+    // source loads. 1 once the source is loaded.
+    float getLoadProgress() const;
+
     class Impl;
     const Impl& impl() const;
 
@@ -86,6 +119,7 @@ private:
     optional<std::string> url;
     std::unique_ptr<AsyncRequest> req;
     std::shared_ptr<Scheduler> threadPool;
+    std::shared_ptr<std::atomic<float>> loadProgress = std::make_shared<std::atomic<float>>(0.0f);
     mapbox::base::WeakPtrFactory<Source> weakFactory {this};
 };
 
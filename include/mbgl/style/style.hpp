@@ -28,6 +28,15 @@ public:
     void loadJSON(const std::string&);
     void loadURL(const std::string&);
 
+    // Replaces the style with the given one like loadJSON(), but keeps the sources and layers that
+    // didn't change, so that only the ones that did get reloaded and re-evaluated.
+    void applyPatch(const std::string&);
+
+    // Only parse the filters of the layers of styles loaded afterwards once a tile of the layer is
+    // laid out, which shortens the loading of large styles. Invalid filters are then logged at that
+    // point instead of invalidating their layer. Disabled by default.
+    void setDeferFilterParsing(bool);
+
     std::string getJSON() const;
     std::string getURL() const;
 
@@ -48,6 +57,16 @@ public:
     // Images
     optional<Image> getImage(const std::string&) const;
     void addImage(std::unique_ptr<Image>);
+    // Adds an image from its encoded data, in any format that decodeImage() supports. The image
+    // is decoded on a background thread and added once decoded, unless an image with the same
+    // ID is added or removed in the meantime. Suits images that are provided in response to
+    // MapObserver::onStyleImageMissing(), which the map would otherwise decode on its thread.
+    // Loading a new style drops the images that are still being decoded. Throws
+    // util::StyleImageException if `data` is null or `pixelRatio` isn't positive.
+    void addEncodedImage(const std::string& id,
+                         std::shared_ptr<const std::string> data,
+                         float pixelRatio = 1.0f,
+                         bool sdf = false);
     void removeImage(const std::string&);
 
     // Sources
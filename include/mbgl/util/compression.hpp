@@ -1,6 +1,8 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
+#include <vector>
 
 namespace mbgl {
 namespace util {
@@ -8,5 +10,23 @@ namespace util {
 std::string compress(const std::string& raw);
 std::string decompress(const std::string& raw);
 
+// Compresses against a preset dictionary. The output refers to the dictionary by its
+// Adler-32 checksum, see dictionaryID().
+std::string compress(const std::string& raw, const std::string& dictionary);
+std::string decompress(const std::string& raw, const std::string& dictionary);
+
+// The Adler-32 checksum that data compressed against `dictionary` refers to it by.
+uint32_t dictionaryID(const std::string& dictionary);
+
+// The dictionary that `compressed` was compressed against; throws if it doesn't need one.
+uint32_t compressedDictionaryID(const std::string& compressed);
+
+// The CRC-32 checksum of `data`.
+uint32_t checksum(const std::string& data);
+
+// Builds a preset dictionary of at most `maxSize` bytes from the segments that recur across
+// the samples. Returns an empty string if the samples have nothing in common.
+std::string trainDictionary(const std::vector<std::string>& samples, std::size_t maxSize = 32768);
+
 } // namespace util
 } // namespace mbgl
@@ -16,6 +16,13 @@ using FeatureState = mapbox::base::ValueObject;
 using FeatureStates = std::unordered_map<std::string, FeatureState>;       // <featureID, FeatureState>
 using LayerFeatureStates = std::unordered_map<std::string, FeatureStates>; // <sourceLayer, FeatureStates>
 
+// A single entry of a batched feature state update, see Renderer::setFeatureStates().
+struct FeatureStateUpdate {
+    optional<std::string> sourceLayerID;
+    std::string featureID;
+    FeatureState state;
+};
+
 class Feature : public GeoJSONFeature {
 public:
     std::string source;
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <mbgl/util/constants.hpp>
+#include <mbgl/util/geo.hpp>
+#include <mbgl/util/geojson.hpp>
+#include <mbgl/util/noncopyable.hpp>
+#include <mbgl/util/optional.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace mbgl {
+
+class CanonicalTileID;
+
+// Reads the features of a FlatGeobuf file (https://flatgeobuf.org) by bounding box. Queries only read
+// the nodes of the file's packed R-tree that intersect them, and the matching features. Files without
+// an index are scanned. Coordinates are expected to be longitudes and latitudes. Thread-safe.
+//
+// To show the file on the map, return getTile() from CustomGeometrySource::Options::loadTileFunction.
+class FlatGeobufReader : private util::noncopyable {
+public:
+    // Throws std::runtime_error if the file can't be read or isn't a FlatGeobuf file.
+    explicit FlatGeobufReader(const std::string& path);
+    ~FlatGeobufReader();
+
+    // The number of features, or 0 if the file doesn't say.
+    uint64_t getFeatureCount() const;
+    optional<LatLngBounds> getBounds() const;
+
+    // The features intersecting the bounds, with their index in the file as id.
+    FeatureCollection query(const LatLngBounds&) const;
+
+    // The features of a tile, including the ones in its buffer of `buffer` out of `tileSize` pixels.
+    FeatureCollection getTile(const CanonicalTileID&, uint16_t buffer = 128, uint16_t tileSize = util::tileSize) const;
+
+private:
+    class Impl;
+    const std::unique_ptr<Impl> impl;
+};
+
+} // namespace mbgl
@@ -163,4 +163,20 @@ using AlphaImage = Image<ImageAlphaMode::Exclusive>;
 PremultipliedImage decodeImage(const std::string&);
 std::string encodePNG(const PremultipliedImage&);
 
+struct PNGEncodeOptions {
+    // The filter applied to each scanline before compression. Adaptive picks the filter that
+    // gives the smallest sum of absolute values for each line, like libpng does.
+    enum class Filter : uint8_t { None, Sub, Up, Paeth, Adaptive };
+
+    // The zlib compression level, from 0 (stored) over 1 (fastest) to 9 (smallest), or -1 for
+    // zlib's default of 6.
+    int compressionLevel = -1;
+    Filter filter = Filter::None;
+    // Large images are split into strips of rows that are compressed on separate threads,
+    // at the cost of a slightly larger output; 1 compresses on the calling thread.
+    uint32_t threads = 1;
+};
+
+std::string encodePNG(const PremultipliedImage&, const PNGEncodeOptions&);
+
 } // namespace mbgl
@@ -93,13 +93,16 @@ public:
 template <>
 struct Interpolator<Color> {
 public:
+    // Interpolates the channels in a single loop, which compilers vectorize, with the same
+    // arithmetic as interpolating each of them on its own.
     Color operator()(const Color& a, const Color& b, const double t) {
-        return {
-            interpolate(a.r, b.r, t),
-            interpolate(a.g, b.g, t),
-            interpolate(a.b, b.b, t),
-            interpolate(a.a, b.a, t)
-        };
+        const float from[4] = { a.r, a.g, a.b, a.a };
+        const float to[4] = { b.r, b.g, b.b, b.a };
+        float result[4];
+        for (std::size_t i = 0; i < 4; ++i) {
+            result[i] = static_cast<float>(from[i] * (1.0 - t) + to[i] * t);
+        }
+        return { result[0], result[1], result[2], result[3] };
     }
 };
 
@@ -2,11 +2,17 @@
 
 #include <mbgl/util/image.hpp>
 
+#include <cstddef>
+#include <cstdint>
+
 namespace mbgl {
 namespace util {
 
 PremultipliedImage premultiply(UnassociatedImage&&);
 UnassociatedImage unpremultiply(PremultipliedImage&&);
 
+// Premultiplies `count` RGBA pixels in place, e.g. rows of an image while it is being decoded.
+void premultiplyPixels(uint8_t* data, std::size_t count);
+
 } // namespace util
 } // namespace mbgl
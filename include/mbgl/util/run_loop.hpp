@@ -81,6 +81,9 @@ public:
     }
 
     void schedule(std::function<void()> fn) override { invoke(std::move(fn)); }
+    void scheduleWithPriority(TaskPriority priority, std::function<void()> fn) override {
+        invoke(priority == TaskPriority::High ? Priority::High : Priority::Default, std::move(fn));
+    }
     ::mapbox::base::WeakPtr<Scheduler> makeWeakPtr() override { return weakFactory.makeWeakPtr(); }
 
     class Impl;
@@ -93,15 +96,19 @@ private:
     // Wakes up the RunLoop so that it starts processing items in the queue.
     void wake();
 
-    // Adds a WorkTask to the queue, and wakes it up.
+    // Adds a WorkTask to the queue, and wakes it up. Queued tasks were woken up for already, and
+    // process() runs until both queues are empty, so only a task added to empty queues wakes it.
     void push(Priority priority, std::shared_ptr<WorkTask> task) {
         std::lock_guard<std::mutex> lock(mutex);
+        const bool wasEmpty = highPriorityQueue.empty() && defaultQueue.empty();
         if (priority == Priority::High) {
             highPriorityQueue.emplace(std::move(task));
         } else {
             defaultQueue.emplace(std::move(task));
         }
-        wake();
+        if (wasEmpty) {
+            wake();
+        }
 
         if (platformCallback) {
             platformCallback();
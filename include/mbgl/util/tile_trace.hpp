@@ -0,0 +1,50 @@
+#pragma once
+
+#include <mbgl/tile/tile_id.hpp>
+#include <mbgl/util/noncopyable.hpp>
+
+#include <atomic>
+#include <string>
+
+namespace mbgl {
+namespace util {
+
+// Records when tile loads pass through each step from the request to the first upload, to find out
+// where slow tiles spend their time. Recording is off by default, and each step then only costs an
+// atomic load. Thread-safe.
+class TileTrace {
+public:
+    static void setEnabled(bool);
+    static bool isEnabled() {
+        return enabled.load(std::memory_order_relaxed);
+    }
+
+    // Returns the recorded events in the Chrome trace event format, for chrome://tracing or Perfetto,
+    // and discards them. Every tile gets a track of its own.
+    static std::string exportChromeTrace();
+
+    // Steps may begin and end on different threads. Names must be string literals.
+    static void begin(const OverscaledTileID&, const char* step);
+    static void end(const OverscaledTileID&, const char* step);
+
+    // Records a step for the rest of the enclosing scope.
+    class Scope : private util::noncopyable {
+    public:
+        Scope(const OverscaledTileID& id_, const char* step_) : id(id_), step(step_) {
+            TileTrace::begin(id, step);
+        }
+        ~Scope() {
+            TileTrace::end(id, step);
+        }
+
+    private:
+        const OverscaledTileID& id;
+        const char* const step;
+    };
+
+private:
+    static std::atomic<bool> enabled;
+};
+
+} // namespace util
+} // namespace mbgl
@@ -3,6 +3,8 @@
 #include <android/bitmap.h>
 #include <mbgl/util/logging.hpp>
 
+#include <cstring>
+
 namespace mbgl {
 namespace android {
 
@@ -76,13 +78,16 @@ PremultipliedImage Bitmap::GetImage(jni::JNIEnv& env, const jni::Object<Bitmap>&
 
     PixelGuard guard(env, bitmap);
 
-    // Copy the Android Bitmap into the PremultipliedImage.
-    auto pixels =
-        std::make_unique<uint8_t[]>(info.width * info.height * PremultipliedImage::channels);
-    for (uint32_t y = 0; y < info.height; y++) {
-        auto begin = guard.get() + y * info.stride;
-        std::copy(begin, begin + info.width * PremultipliedImage::channels,
-            pixels.get() + y * info.width * PremultipliedImage::channels);
+    // Copy the Android Bitmap into the PremultipliedImage, in one go unless its rows are padded.
+    const std::size_t rowBytes = info.width * PremultipliedImage::channels;
+    auto pixels = std::make_unique<uint8_t[]>(rowBytes * info.height);
+    if (info.stride == rowBytes) {
+        std::memcpy(pixels.get(), guard.get(), rowBytes * info.height);
+    } else {
+        for (uint32_t y = 0; y < info.height; y++) {
+            auto begin = guard.get() + y * info.stride;
+            std::copy(begin, begin + rowBytes, pixels.get() + y * rowBytes);
+        }
     }
 
     return { Size{ info.width, info.height }, std::move(pixels) };
@@ -105,9 +110,13 @@ jni::Local<jni::Object<Bitmap>> Bitmap::CreateBitmap(jni::JNIEnv& env, const Pre
     PixelGuard guard(env, bitmap);
 
     // Copy the PremultipliedImage into the Android Bitmap
-    for (uint32_t y = 0; y < image.size.height; y++) {
-        auto begin = image.data.get() + y * image.stride();
-        std::copy(begin, begin + image.stride(), guard.get() + y * info.stride);
+    if (info.stride == image.stride()) {
+        std::memcpy(guard.get(), image.data.get(), image.bytes());
+    } else {
+        for (uint32_t y = 0; y < image.size.height; y++) {
+            auto begin = image.data.get() + y * image.stride();
+            std::copy(begin, begin + image.stride(), guard.get() + y * info.stride);
+        }
     }
 
     return bitmap;
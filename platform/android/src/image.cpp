@@ -1,4 +1,5 @@
 #include <mbgl/util/image.hpp>
+#include <mbgl/util/image_buffer_pool.hpp>
 #include <mbgl/util/string.hpp>
 
 #include <string>
@@ -18,4 +19,9 @@ PremultipliedImage decodeImage(const std::string& string) {
     return android::Bitmap::GetImage(*env, android::BitmapFactory::DecodeByteArray(*env, array, 0, string.size()));
 }
 
+// The image is copied out of the Java bitmap, which allocates its own pixels.
+PremultipliedImage decodeImage(const std::string& string, util::ImageBufferPool&) {
+    return decodeImage(string);
+}
+
 } // namespace mbgl
@@ -2,6 +2,7 @@
 #include <mbgl/util/platform.hpp>
 #include <mbgl/platform/thread.hpp>
 
+#include <sched.h>
 #include <sys/prctl.h>
 #include <sys/resource.h>
 
@@ -48,6 +49,18 @@ void setCurrentThreadPriority(double priority) {
     setpriority(PRIO_PROCESS, 0, int(priority));
 }
 
+void setCurrentThreadAffinity(const std::vector<std::size_t>& cpus) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (const std::size_t cpu : cpus) {
+        if (cpu < CPU_SETSIZE) CPU_SET(cpu, &set);
+    }
+
+    if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+        Log::Warning(Event::General, "Couldn't set thread affinity");
+    }
+}
+
 void attachThread() {
     using namespace android;
     assert(env == nullptr);
@@ -1,6 +1,9 @@
 #include <mbgl/i18n/collator.hpp>
 
+#include <map>
+#include <mutex>
 #include <sstream>
+#include <tuple>
 
 #import <Foundation/Foundation.h>
 
@@ -48,11 +51,30 @@ private:
 };
 
 Collator::Collator(bool caseSensitive, bool diacriticSensitive, const optional<std::string>& locale_)
-    : impl(std::make_shared<Impl>(caseSensitive, diacriticSensitive, locale_))
+    : impl([&] {
+          // Collator expressions create a collator every time they are evaluated, and creating an
+          // NSLocale for every feature is expensive. Collators of the current locale aren't kept,
+          // as it may change.
+          if (!locale_) {
+              return std::make_shared<Impl>(caseSensitive, diacriticSensitive, locale_);
+          }
+
+          static std::mutex mutex;
+          static std::map<std::tuple<bool, bool, std::string>, std::shared_ptr<Impl>> impls;
+          std::lock_guard<std::mutex> lock(mutex);
+          if (impls.size() >= 64) {
+              impls.clear();
+          }
+          auto& cached = impls[std::make_tuple(caseSensitive, diacriticSensitive, *locale_)];
+          if (!cached) {
+              cached = std::make_shared<Impl>(caseSensitive, diacriticSensitive, locale_);
+          }
+          return cached;
+      }())
 {}
 
 bool Collator::operator==(const Collator& other) const {
-    return *impl == *(other.impl);
+    return impl == other.impl || *impl == *(other.impl);
 }
 
 int Collator::compare(const std::string& lhs, const std::string& rhs) const {
@@ -44,6 +44,9 @@ private:
 
 void HeadlessBackend::createImpl() {
     assert(!impl);
+    if (device) {
+        throw std::runtime_error("Choosing the GPU device requires the EGL headless backend");
+    }
     impl = std::make_unique<EAGLBackendImpl>();
 }
 
@@ -1,4 +1,5 @@
 #include <mbgl/util/image+MGLAdditions.hpp>
+#include <mbgl/util/image_buffer_pool.hpp>
 
 #import <ImageIO/ImageIO.h>
 
@@ -92,4 +93,9 @@ PremultipliedImage decodeImage(const std::string& source) {
     return MGLPremultipliedImageFromCGImage(*image);
 }
 
+// Core Graphics draws into an image of its own size.
+PremultipliedImage decodeImage(const std::string& source, util::ImageBufferPool&) {
+    return decodeImage(source);
+}
+
 } // namespace mbgl
@@ -34,6 +34,10 @@ void setCurrentThreadPriority(double priority) {
     [[NSThread currentThread] setThreadPriority:priority];
 }
 
+// Darwin has no API to bind threads to CPUs.
+void setCurrentThreadAffinity(const std::vector<std::size_t>&) {
+}
+
 void attachThread() {
 }
 
@@ -4,7 +4,9 @@
 #include <mbgl/gfx/backend.hpp>
 #include <mbgl/gfx/renderer_backend.hpp>
 #include <mbgl/util/image.hpp>
+#include <mbgl/util/optional.hpp>
 
+#include <deque>
 #include <memory>
 
 namespace mbgl {
@@ -17,19 +19,29 @@ class HeadlessBackend : public gfx::Renderable {
 public:
     enum class SwapBehaviour { NoFlush, Flush };
 
-    // Factory.
+    // Factory. The device is the index of the GPU to render on, where there are several and the
+    // backend can choose one; otherwise creating the context throws.
     static std::unique_ptr<HeadlessBackend> Create(const Size size = {256, 256},
                                                    SwapBehaviour swapBehavior = SwapBehaviour::NoFlush,
-                                                   const gfx::ContextMode contextMode = gfx::ContextMode::Unique) {
-        return Backend::Create<HeadlessBackend, Size, SwapBehaviour, gfx::ContextMode>(size, swapBehavior, contextMode);
+                                                   const gfx::ContextMode contextMode = gfx::ContextMode::Unique,
+                                                   const optional<uint32_t> device = nullopt) {
+        return Backend::Create<HeadlessBackend, Size, SwapBehaviour, gfx::ContextMode, optional<uint32_t>>(
+            size, swapBehavior, contextMode, device);
     }
 
     virtual PremultipliedImage readStillImage() = 0;
+    // Queues the current image for readback. Backends that support it copy the image out
+    // asynchronously, while the next one renders; takeStillImage() waits for the oldest one.
+    virtual void queueStillImage();
+    virtual PremultipliedImage takeStillImage();
     virtual RendererBackend* getRendererBackend() = 0;
     void setSize(Size);
 
 protected:
     HeadlessBackend(Size);
+
+private:
+    std::deque<PremultipliedImage> stillImages;
 };
 
 } // namespace gfx
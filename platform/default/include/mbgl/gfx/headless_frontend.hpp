@@ -9,9 +9,11 @@
 
 #include <atomic>
 #include <memory>
+#include <vector>
 
 namespace mbgl {
 
+class CanonicalTileID;
 class Renderer;
 class Map;
 class TransformState;
@@ -23,14 +25,23 @@ public:
         gfx::RenderingStats stats;
     };
 
+    // The device is the GPU to render on, see gfx::HeadlessBackend::Create().
     HeadlessFrontend(float pixelRatio_,
                      gfx::HeadlessBackend::SwapBehaviour swapBehavior = gfx::HeadlessBackend::SwapBehaviour::NoFlush,
                      gfx::ContextMode mode = gfx::ContextMode::Unique,
-                     const optional<std::string>& localFontFamily = {});
+                     const optional<std::string>& localFontFamily = {},
+                     optional<uint32_t> device = {});
     HeadlessFrontend(Size,
                      float pixelRatio_,
                      gfx::HeadlessBackend::SwapBehaviour swapBehavior = gfx::HeadlessBackend::SwapBehaviour::NoFlush,
                      gfx::ContextMode mode = gfx::ContextMode::Unique,
+                     const optional<std::string>& localFontFamily = {},
+                     optional<uint32_t> device = {});
+    // Renders through the given backend. Frontends on the same thread can share a backend to
+    // render many maps with one GL context; each one resizes it to its own size as it renders.
+    HeadlessFrontend(std::shared_ptr<gfx::HeadlessBackend>,
+                     Size,
+                     float pixelRatio_,
                      const optional<std::string>& localFontFamily = {});
     ~HeadlessFrontend() override;
 
@@ -55,16 +66,28 @@ public:
 
     PremultipliedImage readStillImage();
     RenderResult render(Map&);
+
+    // Like render(), but only queues the image for readback, so that it is copied out while the
+    // next one renders. takeQueuedImage() returns the queued images in order.
+    void renderQueued(Map&);
+    PremultipliedImage takeQueuedImage();
+
+    // In tile mode, renders the count×count block of tiles whose top left tile is `tileID` in one
+    // pass, so that the tiles share their parsing and symbol placement. Returns the tiles in row
+    // major order. Resizes the frontend and the map to the size of the block.
+    std::vector<PremultipliedImage> renderMetatile(Map&, const CanonicalTileID&, uint32_t count, uint16_t tileSize);
     void renderOnce(Map&);
 
     optional<TransformState> getTransformState() const;
 
 private:
+    Size getBackendSize() const;
+
     Size size;
     float pixelRatio;
 
     std::atomic<double> frameTime;
-    std::unique_ptr<gfx::HeadlessBackend> backend;
+    std::shared_ptr<gfx::HeadlessBackend> backend;
     util::AsyncTask asyncInvalidate;
 
     std::unique_ptr<Renderer> renderer;
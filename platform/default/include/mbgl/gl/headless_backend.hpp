@@ -12,11 +12,14 @@ class HeadlessBackend final : public gl::RendererBackend, public gfx::HeadlessBa
 public:
     HeadlessBackend(Size = {256, 256},
                     SwapBehaviour = SwapBehaviour::NoFlush,
-                    gfx::ContextMode = gfx::ContextMode::Unique);
+                    gfx::ContextMode = gfx::ContextMode::Unique,
+                    optional<uint32_t> device = nullopt);
     ~HeadlessBackend() override;
     void updateAssumedState() override;
     gfx::Renderable& getDefaultRenderable() override;
     PremultipliedImage readStillImage() override;
+    void queueStillImage() override;
+    PremultipliedImage takeStillImage() override;
     RendererBackend* getRendererBackend() override;
 
     void swap();
@@ -40,6 +43,8 @@ private:
 
 private:
     std::unique_ptr<Impl> impl;
+    // The GPU to create the context on. Only the EGL backend can choose one.
+    const optional<uint32_t> device;
     bool active = false;
     SwapBehaviour swapBehaviour = SwapBehaviour::NoFlush;
 };
@@ -4,6 +4,7 @@
 #include <mbgl/util/optional.hpp>
 #include <mbgl/util/geo.hpp>
 
+#include <cstddef>
 #include <exception>
 #include <memory>
 #include <string>
@@ -31,11 +32,13 @@ public:
 
 class MapSnapshotter {
 public:
+    // The device is the GPU to render on, see gfx::HeadlessBackend::Create().
     MapSnapshotter(Size size,
                    float pixelRatio,
                    const ResourceOptions&,
                    MapSnapshotterObserver&,
-                   optional<std::string> localFontFamily = nullopt);
+                   optional<std::string> localFontFamily = nullopt,
+                   optional<uint32_t> device = nullopt);
 
     MapSnapshotter(Size size, float pixelRatio, const ResourceOptions&);
 
@@ -64,6 +67,13 @@ public:
     using Attributions = std::vector<std::string>;
     using Callback = std::function<void (std::exception_ptr, PremultipliedImage, Attributions, PointForFn, LatLngForFn)>;
     void snapshot(Callback);
+
+    // Renders one image for each camera in turn, with the same loaded style, glyphs and tiles.
+    // The tiles for the next camera are requested while the current one renders. The callback
+    // gets the index of the camera as soon as its image is done.
+    using BatchCallback = std::function<void (std::size_t, std::exception_ptr, PremultipliedImage, Attributions, PointForFn, LatLngForFn)>;
+    void snapshotBatch(std::vector<CameraOptions>, BatchCallback);
+
     void cancel();
 
 private:
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <mbgl/storage/resource.hpp>
+#include <mbgl/storage/response.hpp>
 #include <mbgl/storage/offline.hpp>
 #include <mbgl/util/exception.hpp>
 #include <mbgl/util/optional.hpp>
@@ -11,7 +12,10 @@
 #include <list>
 #include <map>
 #include <memory>
+#include <set>
 #include <string>
+#include <tuple>
+#include <vector>
 
 namespace mapbox {
 namespace sqlite {
@@ -19,12 +23,12 @@ class Database;
 class Statement;
 class Query;
 class Exception;
+class Transaction;
 } // namespace sqlite
 } // namespace mapbox
 
 namespace mbgl {
 
-class Response;
 class TileID;
 
 namespace util {
@@ -35,15 +39,44 @@ struct MapboxTileLimitExceededException :  util::Exception {
     MapboxTileLimitExceededException() : util::Exception("Mapbox tile limit exceeded") {}
 };
 
+// A response whose data is still compressed the way the database stores it. Inflating it
+// doesn't need the database, so it can happen on any thread.
+struct CompressedResponse {
+    Response response;
+    bool compressed = false;
+    // The preset dictionary the data was compressed against, if any.
+    std::shared_ptr<const std::string> dictionary;
+
+    // Inflates the response data in place.
+    void decompress();
+};
+
+// How far the download of a tileset into a region got when it was interrupted. The tiles
+// are requested in tile cover order, and the first `tiles` of them are stored or were skipped.
+struct OfflineRegionCheckpoint {
+    std::string urlTemplate;
+    // The number of tiles of the tileset in the region, to tell whether it still applies.
+    uint64_t tileCount = 0;
+    uint64_t tiles = 0;
+    uint64_t completedTiles = 0;
+    uint64_t completedSize = 0;
+};
+
 class OfflineDatabase {
 public:
-    OfflineDatabase(std::string path);
+    // A read-only database never modifies the file, which another connection may be writing.
+    OfflineDatabase(std::string path, bool readOnly = false);
     ~OfflineDatabase();
 
     void changePath(const std::string&);
     std::exception_ptr resetDatabase();
 
     optional<Response> get(const Resource&);
+    // Like get(), but leaves inflating the data to the caller.
+    optional<CompressedResponse> getCompressed(const Resource&);
+
+    // Updates the timestamp used for LRU eviction, for reads served by a read-only connection.
+    void markAccessed(const Resource&);
 
     // Return value is (inserted, stored size)
     std::pair<bool, uint64_t> put(const Resource&, const Response&);
@@ -68,6 +101,18 @@ public:
     expected<OfflineRegions, std::exception_ptr>
     mergeDatabase(const std::string& sideDatabasePath);
 
+    // Runs mergeDatabase() in steps, so that other queries can run in between: beginMerge()
+    // attaches the side database and adds its regions, mergeNextChunk() copies the next few
+    // hundred region tiles or resources in a transaction of its own and returns whether any
+    // are left, and finishMerge() detaches the side database and returns the merged regions.
+    // Stored data isn't copied again when a newer version of it has the same bytes. A failing
+    // step, or changing the database, ends the merge and keeps the chunks copied so far.
+    std::exception_ptr beginMerge(const std::string& sideDatabasePath);
+    expected<bool, std::exception_ptr> mergeNextChunk();
+    expected<OfflineRegions, std::exception_ptr> finishMerge();
+    // The region tiles and resources of the merge in progress that were copied, and in total.
+    std::pair<uint64_t, uint64_t> getMergeProgress() const;
+
     expected<OfflineRegionMetadata, std::exception_ptr> updateMetadata(int64_t regionID, const OfflineRegionMetadata&);
 
     std::exception_ptr deleteRegion(OfflineRegion&&);
@@ -82,6 +127,10 @@ public:
     expected<OfflineRegionDefinition, std::exception_ptr> getRegionDefinition(int64_t regionID);
     expected<OfflineRegionStatus, std::exception_ptr> getRegionCompletedStatus(int64_t regionID);
 
+    optional<OfflineRegionCheckpoint> getRegionCheckpoint(int64_t regionID, const std::string& urlTemplate);
+    void putRegionCheckpoint(int64_t regionID, const OfflineRegionCheckpoint&);
+    void deleteRegionCheckpoints(int64_t regionID);
+
     std::exception_ptr setMaximumAmbientCacheSize(uint64_t);
     void setOfflineMapboxTileCountLimit(uint64_t);
     uint64_t getOfflineMapboxTileCountLimit();
@@ -94,9 +143,37 @@ public:
 
     void reopenDatabaseReadOnly(bool readOnly);
 
+    // Buffers ambient cache writes in one transaction, which is committed once it holds
+    // `maxBatchSize` writes or when flushPendingWrites() is called, instead of committing
+    // every put() on its own. Reads see the buffered writes, and all other modifications
+    // commit them first. A failing put() rolls back the whole batch. 0 disables batching.
+    void setWriteBatchSize(uint64_t maxBatchSize);
+    bool hasPendingWrites() const {
+        return pendingTransaction || !pendingTileAccesses.empty() || !pendingResourceAccesses.empty();
+    }
+    std::exception_ptr flushPendingWrites();
+
+    // Rounds the access times used for LRU eviction down to `resolution`, and buffers their
+    // updates until the next commit of batched writes, see flushPendingWrites(). Only access
+    // times that changed get written. 0 writes them with every read, which is the default.
+    void setAccessTimeResolution(Seconds resolution);
+
+    // Uses the WAL journal with NORMAL synchronization, which saves most fsyncs. The latest
+    // commits may be lost on power failure, so this is meant for databases that only hold
+    // the ambient cache.
+    void setWriteAheadLogging(bool);
+
 private:
     class DatabaseSizeChangeStats;
 
+    // Values of the `compressed` column.
+    enum class Compression : uint8_t {
+        None = 0,
+        Deflate = 1,
+        // Deflated against the preset dictionary of the tileset; the zlib header has its id.
+        DeflateWithDictionary = 2,
+    };
+
     void initialize();
     void handleError(const mapbox::sqlite::Exception&, const char* action);
     void handleError(const util::IOException&, const char* action);
@@ -109,29 +186,48 @@ private:
     void migrateToVersion5();
     void migrateToVersion3();
     void migrateToVersion6();
+    void migrateToVersion7();
+    void migrateToVersion8();
+    void migrateToVersion9();
+    void migrateToVersion10();
     void cleanup();
     bool disabled();
     void vacuum();
     void checkFlags();
+    void commitPendingWrites();
+    void applyJournalMode();
+    void detachMerge();
 
     mapbox::sqlite::Statement& getStatement(const char *);
 
-    optional<std::pair<Response, uint64_t>> getTile(const Resource::TileData&);
+    optional<std::pair<CompressedResponse, uint64_t>> getTile(const Resource::TileData&);
     optional<int64_t> hasTile(const Resource::TileData&);
     bool putTile(const Resource::TileData&, const Response&,
-                 const std::string&, bool compressed);
+                 const std::string&, Compression);
+    // Returns the id of the tile_data row with these bytes, adding one if there is none.
+    int64_t putTileData(const std::string&);
 
-    optional<std::pair<Response, uint64_t>> getResource(const Resource&);
+    optional<std::pair<CompressedResponse, uint64_t>> getResource(const Resource&);
     optional<int64_t> hasResource(const Resource&);
     bool putResource(const Resource&, const Response&,
-                     const std::string&, bool compressed);
+                     const std::string&, Compression);
 
     uint64_t putRegionResourceInternal(int64_t regionID, const Resource&, const Response&);
 
     optional<std::pair<Response, uint64_t>> getInternal(const Resource&);
+    optional<std::pair<CompressedResponse, uint64_t>> getCompressedInternal(const Resource&);
+    void updateAccessed(const Resource&);
+    void writeTileAccessed(const Resource::TileData&, Timestamp);
+    void writeResourceAccessed(const std::string& url, Timestamp);
+    void writePendingAccesses();
     optional<int64_t> hasInternal(const Resource&);
     std::pair<bool, uint64_t> putInternal(const Resource&, const Response&, bool evict);
 
+    // Returns the dictionary to compress tiles of the tileset against, if it has one. Tilesets
+    // without one collect their first tiles as samples to train a dictionary from.
+    const std::string* getCompressionDictionary(const std::string& urlTemplate, const std::string& data);
+    std::shared_ptr<const std::string> getDictionary(uint32_t id);
+
     // Return value is true iff the resource was previously unused by any other regions.
     bool markUsed(int64_t regionID, const Resource&);
 
@@ -150,7 +246,18 @@ private:
 
     optional<uint64_t> offlineMapboxTileCount;
 
-    bool evict(uint64_t neededFreeSize, DatabaseSizeChangeStats& stats);
+    struct DictionarySamples {
+        std::vector<std::string> tiles;
+        std::size_t size = 0;
+    };
+    std::map<std::string, DictionarySamples> dictionarySamples;
+    // Tilesets whose samples had too little in common for a dictionary.
+    std::set<std::string> untrainedTilesets;
+    // Dictionaries are immutable and addressed by their checksum, so they can be cached by id.
+    std::map<uint32_t, std::shared_ptr<const std::string>> dictionaries;
+
+    // An incremental eviction stops after a few milliseconds, leaving the rest to the next one.
+    bool evict(uint64_t neededFreeSize, DatabaseSizeChangeStats& stats, bool incremental = false);
 
     class DatabaseSizeChangeStats {
     public:
@@ -180,9 +287,35 @@ private:
     std::exception_ptr initAmbientCacheSize();
     optional<uint64_t> currentAmbientCacheSize;
     void updateAmbientCacheSize(DatabaseSizeChangeStats&);
+    // The size is stored in the database within the transaction that changes it, so that it
+    // only has to be summed up after it was reset.
+    void storeAmbientCacheSize();
+    // No ambient entry was accessed before this time, so eviction skips the region entries
+    // before it.
+    Timestamp evictionCursor;
 
     bool autopack = true;
     bool readOnly = false;
+    bool writeAheadLogging = false;
+
+    uint64_t writeBatchSize = 0;
+    uint64_t pendingWrites = 0;
+    std::unique_ptr<mapbox::sqlite::Transaction> pendingTransaction;
+
+    Seconds accessTimeResolution{0};
+    using TileKey = std::tuple<std::string, uint8_t, int32_t, int32_t, int8_t>;
+    std::map<TileKey, Timestamp> pendingTileAccesses;
+    std::map<std::string, Timestamp> pendingResourceAccesses;
+
+    struct MergeState {
+        // The last side tile and resource ids copied; tiles go first.
+        int64_t lastTileID = 0;
+        int64_t lastResourceID = 0;
+        bool tilesMerged = false;
+        uint64_t completed = 0;
+        uint64_t total = 0;
+    };
+    optional<MergeState> merge;
 };
 
 } // namespace mbgl
@@ -37,6 +37,15 @@ public:
     OfflineRegionStatus getStatus() const;
 
 private:
+    // The tiles of a tileset, which are generated as the download goes instead of all at once.
+    struct TileQueue;
+    struct QueuedResource {
+        Resource resource;
+        // The tileset and the position in it, for tiles.
+        TileQueue* tiles;
+        uint64_t ordinal;
+    };
+
     void activateDownload();
     void continueDownload();
     void deactivateDownload();
@@ -47,7 +56,7 @@ private:
      * While the request is in progress, it is recorded in `requests`. If the download
      * is deactivated, all in progress requests are cancelled.
      */
-    void ensureResource(Resource&&, std::function<void (Response)> = {});
+    void ensureResource(Resource&&, std::function<void (Response)> = {}, TileQueue* = nullptr, uint64_t ordinal = 0);
 
     void onMapboxTileCountLimitExceeded();
 
@@ -60,12 +69,20 @@ private:
 
     std::list<std::unique_ptr<AsyncRequest>> requests;
     std::set<std::string> requiredSourceURLs;
-    std::deque<Resource> resourcesRemaining;
+    std::list<std::unique_ptr<TileQueue>> tileQueues;
+    std::deque<QueuedResource> resourcesRemaining;
     std::list<Resource> resourcesToBeMarkedAsUsed;
+    // The tiles among them, with their stored size.
+    std::list<std::tuple<TileQueue*, uint64_t, uint64_t>> tilesToBeMarkedAsUsed;
     std::list<std::tuple<Resource, Response>> buffer;
+    // The tileset and the position in it of every buffered resource.
+    std::list<std::pair<TileQueue*, uint64_t>> bufferedTiles;
 
     void queueResource(Resource&&);
     void queueTiles(style::SourceType, uint16_t tileSize, const Tileset&);
+    void generateTiles();
+    bool hasRemainingResources();
+    void saveCheckpoints();
     void markPendingUsedResources();
 };
 
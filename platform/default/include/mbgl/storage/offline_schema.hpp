@@ -33,8 +33,43 @@ static constexpr const char* offlineDatabaseSchema =
 "  compressed INTEGER NOT NULL DEFAULT 0,\n"
 "  accessed INTEGER NOT NULL,\n"
 "  must_revalidate INTEGER NOT NULL DEFAULT 0,\n"
+"  data_id INTEGER,\n"
 "  UNIQUE (url_template, pixel_ratio, z, x, y)\n"
 ");\n"
+"CREATE TABLE tile_data (\n"
+"  id INTEGER NOT NULL PRIMARY KEY,\n"
+"  checksum INTEGER NOT NULL,\n"
+"  data BLOB NOT NULL,\n"
+"  refs INTEGER NOT NULL\n"
+");\n"
+"CREATE TRIGGER tiles_data_insert AFTER INSERT ON tiles\n"
+"WHEN new.data_id IS NOT NULL\n"
+"BEGIN\n"
+"  UPDATE tile_data SET refs = refs + 1 WHERE id = new.data_id;\n"
+"END;\n"
+"CREATE TRIGGER tiles_data_update AFTER UPDATE OF data_id ON tiles\n"
+"WHEN new.data_id IS NOT old.data_id\n"
+"BEGIN\n"
+"  UPDATE tile_data SET refs = refs + 1 WHERE id = new.data_id;\n"
+"  UPDATE tile_data SET refs = refs - 1 WHERE id = old.data_id;\n"
+"  DELETE FROM tile_data WHERE id = old.data_id AND refs = 0;\n"
+"END;\n"
+"CREATE TRIGGER tiles_data_delete AFTER DELETE ON tiles\n"
+"WHEN old.data_id IS NOT NULL\n"
+"BEGIN\n"
+"  UPDATE tile_data SET refs = refs - 1 WHERE id = old.data_id;\n"
+"  DELETE FROM tile_data WHERE id = old.data_id AND refs = 0;\n"
+"END;\n"
+"CREATE TABLE dictionaries (\n"
+"  id INTEGER NOT NULL PRIMARY KEY,\n"
+"  url_template TEXT NOT NULL,\n"
+"  data BLOB NOT NULL\n"
+");\n"
+"CREATE TABLE ambient_cache (\n"
+"  id INTEGER NOT NULL PRIMARY KEY CHECK (id = 1),\n"
+"  size INTEGER NOT NULL,\n"
+"  eviction_cursor INTEGER NOT NULL DEFAULT 0\n"
+");\n"
 "CREATE TABLE regions (\n"
 "  id INTEGER NOT NULL PRIMARY KEY AUTOINCREMENT,\n"
 "  definition TEXT NOT NULL,\n"
@@ -50,6 +85,15 @@ static constexpr const char* offlineDatabaseSchema =
 "  tile_id INTEGER NOT NULL REFERENCES tiles(id),\n"
 "  UNIQUE (region_id, tile_id)\n"
 ");\n"
+"CREATE TABLE region_checkpoints (\n"
+"  region_id INTEGER NOT NULL REFERENCES regions(id) ON DELETE CASCADE,\n"
+"  url_template TEXT NOT NULL,\n"
+"  tile_count INTEGER NOT NULL,\n"
+"  tiles INTEGER NOT NULL,\n"
+"  completed_tiles INTEGER NOT NULL,\n"
+"  completed_size INTEGER NOT NULL,\n"
+"  UNIQUE (region_id, url_template)\n"
+");\n"
 "CREATE INDEX resources_accessed\n"
 "ON resources (accessed);\n"
 "CREATE INDEX tiles_accessed\n"
@@ -58,6 +102,10 @@ static constexpr const char* offlineDatabaseSchema =
 "ON region_resources (resource_id);\n"
 "CREATE INDEX region_tiles_tile_id\n"
 "ON region_tiles (tile_id);\n"
+"CREATE INDEX dictionaries_url_template\n"
+"ON dictionaries (url_template);\n"
+"CREATE INDEX tile_data_checksum\n"
+"ON tile_data (checksum);\n"
 ;
 
 } // namespace mbgl
@@ -75,21 +75,91 @@ CREATE TABLE tiles (
                                                    -- get re-downloaded. See:
                                                    -- https://developer.mozilla.org/en-US/docs/Web/HTTP/Headers/ETag
 
-  data BLOB,                                       -- Contents of the tile.
+  data BLOB,                                       -- Contents of the tile, unless it refers to shared data.
 
   compressed INTEGER NOT NULL DEFAULT 0,           -- If the tile is compressed with Deflate or not. Compression is
                                                    -- optional and should be used when the compression ratio is
                                                    -- significant. Using compression will make decoding time slower
                                                    -- because it will add an extra decompression step.
+                                                   -- uncompressed                 = 0
+                                                   -- Deflate                      = 1
+                                                   -- Deflate with a dictionary    = 2
 
   accessed INTEGER NOT NULL,                       -- Last time the tile was used by GL Native. Useful for when
                                                    -- evicting the least used tiles from the cache.
 
   must_revalidate INTEGER NOT NULL DEFAULT 0,      -- When set to true, the tile will not be used unless it gets
                                                    -- first revalidated by the server.
+
+  data_id INTEGER,                                 -- The contents of the tile in tile_data, if it isn't in the data
+                                                   -- column. Tiles stored before schema version 10 keep theirs there.
   UNIQUE (url_template, pixel_ratio, z, x, y)
 );
 
+--
+-- Table containing the contents of tiles, stored once for all the tiles with the
+-- same bytes, such as the ocean and land tiles that tilesets have many of.
+--
+CREATE TABLE tile_data (
+  id INTEGER NOT NULL PRIMARY KEY,                 -- Primary key.
+
+  checksum INTEGER NOT NULL,                       -- CRC-32 checksum of the data, to look it up by.
+
+  data BLOB NOT NULL,                              -- Contents of the tiles, compressed as tiles.compressed says.
+
+  refs INTEGER NOT NULL                            -- Number of tiles referring to the data. Maintained by the
+                                                   -- triggers below, which remove the data with its last tile.
+);
+
+CREATE TRIGGER tiles_data_insert AFTER INSERT ON tiles
+WHEN new.data_id IS NOT NULL
+BEGIN
+  UPDATE tile_data SET refs = refs + 1 WHERE id = new.data_id;
+END;
+
+CREATE TRIGGER tiles_data_update AFTER UPDATE OF data_id ON tiles
+WHEN new.data_id IS NOT old.data_id
+BEGIN
+  UPDATE tile_data SET refs = refs + 1 WHERE id = new.data_id;
+  UPDATE tile_data SET refs = refs - 1 WHERE id = old.data_id;
+  DELETE FROM tile_data WHERE id = old.data_id AND refs = 0;
+END;
+
+CREATE TRIGGER tiles_data_delete AFTER DELETE ON tiles
+WHEN old.data_id IS NOT NULL
+BEGIN
+  UPDATE tile_data SET refs = refs - 1 WHERE id = old.data_id;
+  DELETE FROM tile_data WHERE id = old.data_id AND refs = 0;
+END;
+
+--
+-- Table containing the preset Deflate dictionaries that tiles are compressed
+-- against. Dictionaries are trained from the first tiles of a tileset and never
+-- change afterwards, since the tiles compressed against them refer to them.
+--
+CREATE TABLE dictionaries (
+  id INTEGER NOT NULL PRIMARY KEY,                 -- Adler-32 checksum of the dictionary, which the zlib header of
+                                                   -- the tiles compressed against it refers to it by.
+
+  url_template TEXT NOT NULL,                      -- The tileset the dictionary was trained for, see tiles.url_template.
+
+  data BLOB NOT NULL                               -- Contents of the dictionary, at most 32 KiB.
+);
+
+--
+-- Single row table keeping track of the ambient cache, which consists of the
+-- resources and tiles that are not part of any region. It is updated together
+-- with the entries, so that the size doesn't have to be summed up on startup.
+--
+CREATE TABLE ambient_cache (
+  id INTEGER NOT NULL PRIMARY KEY CHECK (id = 1),  -- Primary key, there is only one row.
+
+  size INTEGER NOT NULL,                           -- Approximate size of the ambient cache in bytes.
+
+  eviction_cursor INTEGER NOT NULL DEFAULT 0       -- No ambient entry was accessed before this time, so eviction
+                                                   -- can skip the older region entries of the accessed indexes.
+);
+
 --
 -- Regions define the offline regions, which could be a GeoJSON geometry,
 -- or a bounding box like this example:
@@ -151,6 +221,27 @@ CREATE TABLE region_tiles (
   UNIQUE (region_id, tile_id)
 );
 
+--
+-- Progress of the tile downloads of regions, so that an interrupted download
+-- can skip the tiles it already walked through instead of looking up each of
+-- them again. Removed once the region download completes.
+--
+CREATE TABLE region_checkpoints (
+  region_id INTEGER NOT NULL REFERENCES regions(id) ON DELETE CASCADE,
+
+  url_template TEXT NOT NULL,                      -- The tileset, see tiles.url_template.
+
+  tile_count INTEGER NOT NULL,                     -- Number of tiles of the tileset in the region.
+
+  tiles INTEGER NOT NULL,                          -- The first tiles in tile cover order that are stored or skipped.
+
+  completed_tiles INTEGER NOT NULL,                -- How many of these are stored,
+
+  completed_size INTEGER NOT NULL,                 -- and their size in bytes.
+
+  UNIQUE (region_id, url_template)
+);
+
 --
 -- Indexes for efficient eviction queries.
 --
@@ -166,3 +257,9 @@ ON region_resources (resource_id);
 
 CREATE INDEX region_tiles_tile_id
 ON region_tiles (tile_id);
+
+CREATE INDEX dictionaries_url_template
+ON dictionaries (url_template);
+
+CREATE INDEX tile_data_checksum
+ON tile_data (checksum);
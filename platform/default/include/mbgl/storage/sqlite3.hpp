@@ -131,6 +131,9 @@ public:
     template <typename T>
     void bind(int offset, T value);
 
+    // Without `retain`, text and blobs aren't copied, and have to stay alive until the query is
+    // destroyed, which clears its bindings.
+
     // Text
     void bind(int offset, const char*, std::size_t length, bool retain = true);
     void bind(int offset, const std::string&, bool retain = true);
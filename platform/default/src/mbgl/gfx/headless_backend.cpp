@@ -1,5 +1,7 @@
 #include <mbgl/gfx/headless_backend.hpp>
 
+#include <cassert>
+
 namespace mbgl {
 namespace gfx {
 
@@ -12,5 +14,16 @@ void HeadlessBackend::setSize(Size size_) {
     resource.reset();
 }
 
+void HeadlessBackend::queueStillImage() {
+    stillImages.push_back(readStillImage());
+}
+
+PremultipliedImage HeadlessBackend::takeStillImage() {
+    assert(!stillImages.empty());
+    PremultipliedImage image = std::move(stillImages.front());
+    stillImages.pop_front();
+    return image;
+}
+
 } // namespace gfx
 } // namespace mbgl
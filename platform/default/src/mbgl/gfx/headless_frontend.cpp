@@ -2,38 +2,62 @@
 #include <mbgl/gfx/context.hpp>
 #include <mbgl/gfx/headless_frontend.hpp>
 #include <mbgl/map/map.hpp>
+#include <mbgl/map/map_options.hpp>
 #include <mbgl/map/transform_state.hpp>
 #include <mbgl/renderer/renderer.hpp>
 #include <mbgl/renderer/renderer_state.hpp>
 #include <mbgl/renderer/update_parameters.hpp>
+#include <mbgl/tile/tile_id.hpp>
+#include <mbgl/util/constants.hpp>
 #include <mbgl/util/monotonic_timer.hpp>
+#include <mbgl/util/projection.hpp>
 #include <mbgl/util/run_loop.hpp>
 
+#include <cmath>
+
 namespace mbgl {
 
 HeadlessFrontend::HeadlessFrontend(float pixelRatio_,
                                    gfx::HeadlessBackend::SwapBehaviour swapBehavior,
                                    const gfx::ContextMode contextMode,
-                                   const optional<std::string>& localFontFamily)
-    : HeadlessFrontend({256, 256}, pixelRatio_, swapBehavior, contextMode, localFontFamily) {}
+                                   const optional<std::string>& localFontFamily,
+                                   const optional<uint32_t> device)
+    : HeadlessFrontend({256, 256}, pixelRatio_, swapBehavior, contextMode, localFontFamily, device) {}
 
 HeadlessFrontend::HeadlessFrontend(Size size_,
                                    float pixelRatio_,
                                    gfx::HeadlessBackend::SwapBehaviour swapBehavior,
                                    const gfx::ContextMode contextMode,
+                                   const optional<std::string>& localFontFamily,
+                                   const optional<uint32_t> device)
+    : HeadlessFrontend(gfx::HeadlessBackend::Create(
+                           {static_cast<uint32_t>(size_.width * pixelRatio_),
+                            static_cast<uint32_t>(size_.height * pixelRatio_)},
+                           swapBehavior,
+                           contextMode,
+                           device),
+                       size_,
+                       pixelRatio_,
+                       localFontFamily) {}
+
+HeadlessFrontend::HeadlessFrontend(std::shared_ptr<gfx::HeadlessBackend> backend_,
+                                   Size size_,
+                                   float pixelRatio_,
                                    const optional<std::string>& localFontFamily)
     : size(size_),
       pixelRatio(pixelRatio_),
       frameTime(0),
-      backend(gfx::HeadlessBackend::Create(
-          {static_cast<uint32_t>(size.width * pixelRatio), static_cast<uint32_t>(size.height * pixelRatio)},
-          swapBehavior,
-          contextMode)),
+      backend(std::move(backend_)),
       asyncInvalidate([this] {
           if (renderer && updateParameters) {
               auto startTime = mbgl::util::MonotonicTimer::now();
               gfx::BackendScope guard{*getBackend()};
 
+              // Another frontend may have resized a shared backend.
+              if (backend->getSize() != getBackendSize()) {
+                  backend->setSize(getBackendSize());
+              }
+
               // onStyleImageMissing might be called during a render. The user implemented method
               // could trigger a call to MGLRenderFrontend#update which overwrites `updateParameters`.
               // Copy the shared pointer here so that the parameters aren't destroyed while `render(...)` is
@@ -128,11 +152,14 @@ LatLng HeadlessFrontend::latLngForPixel(const ScreenCoordinate& point) {
     return LatLng {};
 }
 
+Size HeadlessFrontend::getBackendSize() const {
+    return {static_cast<uint32_t>(size.width * pixelRatio), static_cast<uint32_t>(size.height * pixelRatio)};
+}
+
 void HeadlessFrontend::setSize(Size size_) {
     if (size != size_) {
         size = size_;
-        backend->setSize({ static_cast<uint32_t>(size_.width * pixelRatio),
-                           static_cast<uint32_t>(size_.height * pixelRatio) });
+        backend->setSize(getBackendSize());
     }
 }
 
@@ -164,6 +191,67 @@ HeadlessFrontend::RenderResult HeadlessFrontend::render(Map& map) {
     return result;
 }
 
+void HeadlessFrontend::renderQueued(Map& map) {
+    bool done = false;
+    std::exception_ptr error;
+
+    map.renderStill([&](const std::exception_ptr& e) {
+        if (e) {
+            error = e;
+        } else {
+            backend->queueStillImage();
+        }
+        done = true;
+    });
+
+    while (!done) {
+        util::RunLoop::Get()->runOnce();
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+PremultipliedImage HeadlessFrontend::takeQueuedImage() {
+    gfx::BackendScope guard{*getBackend()};
+    return backend->takeStillImage();
+}
+
+std::vector<PremultipliedImage> HeadlessFrontend::renderMetatile(Map& map,
+                                                                 const CanonicalTileID& tileID,
+                                                                 uint32_t count,
+                                                                 uint16_t tileSize) {
+    assert(map.getMapOptions().mapMode() == MapMode::Tile);
+    assert(count > 0);
+
+    const Size blockSize{count * tileSize, count * tileSize};
+    setSize(blockSize);
+    map.setSize(blockSize);
+
+    const double scale = std::pow(2.0, tileID.z);
+    const Point<double> center{(tileID.x + count / 2.0) * util::tileSize, (tileID.y + count / 2.0) * util::tileSize};
+    map.jumpTo(CameraOptions()
+                   .withCenter(Projection::unproject(center, scale))
+                   .withZoom(tileID.z + std::log2(tileSize / util::tileSize))
+                   .withBearing(0.0)
+                   .withPitch(0.0));
+
+    const PremultipliedImage block = render(map).image;
+
+    const uint32_t tilePixels = tileSize * pixelRatio;
+    std::vector<PremultipliedImage> tiles;
+    tiles.reserve(count * count);
+    for (uint32_t y = 0; y < count; ++y) {
+        for (uint32_t x = 0; x < count; ++x) {
+            PremultipliedImage tile({tilePixels, tilePixels});
+            PremultipliedImage::copy(block, tile, {x * tilePixels, y * tilePixels}, {0, 0}, tile.size);
+            tiles.push_back(std::move(tile));
+        }
+    }
+    return tiles;
+}
+
 void HeadlessFrontend::renderOnce(Map&) {
     util::RunLoop::Get()->runOnce();
 }
@@ -36,10 +36,19 @@ public:
 
 HeadlessBackend::HeadlessBackend(const Size size_,
                                  gfx::HeadlessBackend::SwapBehaviour swapBehaviour_,
-                                 const gfx::ContextMode contextMode_)
-    : mbgl::gl::RendererBackend(contextMode_), mbgl::gfx::HeadlessBackend(size_), swapBehaviour(swapBehaviour_) {}
+                                 const gfx::ContextMode contextMode_,
+                                 const optional<uint32_t> device_)
+    : mbgl::gl::RendererBackend(contextMode_),
+      mbgl::gfx::HeadlessBackend(size_),
+      device(device_),
+      swapBehaviour(swapBehaviour_) {}
 
 HeadlessBackend::~HeadlessBackend() {
+    // Without an impl, creating the context failed and there is nothing to clean up.
+    if (!impl) {
+        return;
+    }
+
     gfx::BackendScope guard{*this};
     resource.reset();
     // Explicitly reset the context so that it is destructed and cleaned up before we destruct
@@ -53,14 +62,13 @@ gl::ProcAddress HeadlessBackend::getExtensionFunctionPointer(const char* name) {
 }
 
 void HeadlessBackend::activate() {
-    active = true;
-
     if (!impl) {
         createImpl();
     }
 
     assert(impl);
     impl->activateContext();
+    active = true;
 }
 
 void HeadlessBackend::deactivate() {
@@ -88,6 +96,24 @@ PremultipliedImage HeadlessBackend::readStillImage() {
     return static_cast<gl::Context&>(getContext()).readFramebuffer<PremultipliedImage>(size);
 }
 
+void HeadlessBackend::queueStillImage() {
+    auto& glContext = static_cast<gl::Context&>(getContext());
+    if (glContext.supportsPixelBufferObjects()) {
+        glContext.startFramebufferRead(size);
+    } else {
+        gfx::HeadlessBackend::queueStillImage();
+    }
+}
+
+PremultipliedImage HeadlessBackend::takeStillImage() {
+    auto& glContext = static_cast<gl::Context&>(getContext());
+    if (glContext.hasFramebufferReads()) {
+        return glContext.takeFramebufferRead();
+    } else {
+        return gfx::HeadlessBackend::takeStillImage();
+    }
+}
+
 RendererBackend* HeadlessBackend::getRendererBackend() {
     return this;
 }
@@ -98,8 +124,11 @@ namespace gfx {
 
 template <>
 std::unique_ptr<gfx::HeadlessBackend> Backend::Create<gfx::Backend::Type::OpenGL>(
-    const Size size, gfx::HeadlessBackend::SwapBehaviour swapBehavior, const gfx::ContextMode contextMode) {
-    return std::make_unique<gl::HeadlessBackend>(size, swapBehavior, contextMode);
+    const Size size,
+    gfx::HeadlessBackend::SwapBehaviour swapBehavior,
+    const gfx::ContextMode contextMode,
+    const optional<uint32_t> device) {
+    return std::make_unique<gl::HeadlessBackend>(size, swapBehavior, contextMode, device);
 }
 
 } // namespace gfx
@@ -2,8 +2,9 @@
 #include <libnu/unaccent.h>
 #include <mbgl/i18n/collator.hpp>
 
+#include <algorithm>
 #include <cstring>
-#include <sstream>
+#include <string>
 
 /*
     The default implementation of Collator ignores locale.
@@ -20,7 +21,8 @@
 
 namespace {
 std::string unaccent(const std::string& str) {
-    std::stringstream output;
+    std::string output;
+    output.reserve(str.length());
     char const* itr = str.c_str();
     char const* nitr;
     char const* end = itr + str.length();
@@ -35,14 +37,24 @@ std::string unaccent(const std::string& str) {
             do {
                 buf = NU_CASEMAP_DECODING_FUNCTION(buf, &code_point);
                 if (code_point == 0) break;
-                output.write(lo, nu_utf8_write(code_point, lo) - lo);
+                output.append(lo, nu_utf8_write(code_point, lo) - lo);
             } while (code_point != 0);
         } else {
-            output.write(itr, nitr - itr);
+            output.append(itr, nitr - itr);
         }
     }
 
-    return output.str();
+    return output;
+}
+
+// Returns the string without diacritics, using `storage` only if there are any to remove. ASCII
+// strings, which most labels compared in styles are, don't have any.
+const char* unaccent(const std::string& str, std::string& storage) {
+    if (std::all_of(str.begin(), str.end(), [](char c) { return static_cast<unsigned char>(c) < 0x80; })) {
+        return str.c_str();
+    }
+    storage = unaccent(str);
+    return storage.c_str();
 }
 } // namespace
 
@@ -65,10 +77,16 @@ public:
         } else if (!caseSensitive && diacriticSensitive) {
             return nu_strcasecoll(lhs.c_str(), rhs.c_str(),
                                   nu_utf8_read, nu_utf8_read);
-        } else if (caseSensitive && !diacriticSensitive) {
-            return nu_strcoll(unaccent(lhs).c_str(), unaccent(rhs).c_str(), nu_utf8_read, nu_utf8_read);
+        }
+
+        std::string lhsStorage;
+        std::string rhsStorage;
+        const char* lhsUnaccented = unaccent(lhs, lhsStorage);
+        const char* rhsUnaccented = unaccent(rhs, rhsStorage);
+        if (caseSensitive) {
+            return nu_strcoll(lhsUnaccented, rhsUnaccented, nu_utf8_read, nu_utf8_read);
         } else {
-            return nu_strcasecoll(unaccent(lhs).c_str(), unaccent(rhs).c_str(), nu_utf8_read, nu_utf8_read);
+            return nu_strcasecoll(lhsUnaccented, rhsUnaccented, nu_utf8_read, nu_utf8_read);
         }
     }
 
@@ -86,7 +104,7 @@ int Collator::compare(const std::string& lhs, const std::string& rhs) const {
 }
 
 bool Collator::operator==(const Collator& other) const {
-    return *impl == *(other.impl);
+    return impl == other.impl || *impl == *(other.impl);
 }
 
 std::string Collator::resolvedLocale() const {
@@ -94,7 +112,17 @@ std::string Collator::resolvedLocale() const {
 }
 
 Collator::Collator(bool caseSensitive, bool diacriticSensitive, const optional<std::string>& locale)
-    : impl(std::make_shared<Impl>(caseSensitive, diacriticSensitive, locale)) {}
+    : impl([&] {
+          // Collator expressions create a collator every time they are evaluated. As the locale is
+          // ignored, the four combinations of options cover all of them.
+          static const std::shared_ptr<Impl> impls[] = {
+              std::make_shared<Impl>(false, false, locale),
+              std::make_shared<Impl>(false, true, locale),
+              std::make_shared<Impl>(true, false, locale),
+              std::make_shared<Impl>(true, true, locale),
+          };
+          return impls[(caseSensitive ? 2 : 0) + (diacriticSensitive ? 1 : 0)];
+      }()) {}
 
 } // namespace platform
 } // namespace mbgl
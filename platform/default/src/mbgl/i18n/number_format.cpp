@@ -6,36 +6,75 @@
 #endif
 
 #include <string>
+#include <unordered_map>
 
 namespace mbgl {
 namespace platform {
 
 #if !defined(MBGL_USE_BUILTIN_ICU)
-std::string formatNumber(double number,
-                         const std::string& localeId,
-                         const std::string& currency,
-                         uint8_t minFractionDigits,
-                         uint8_t maxFractionDigits) {
-    UErrorCode status = U_ZERO_ERROR;
-    icu::UnicodeString ustr;
-    std::string formatted;
+namespace {
 
+// Creating a formatter resolves the locale and its number symbols, which costs far more than
+// formatting a number with it. Labels of numeric properties format a number per feature, with
+// the same few options.
+const icu::number::LocalizedNumberFormatter* getFormatter(const std::string& localeId,
+                                                          const std::string& currency,
+                                                          uint8_t minFractionDigits,
+                                                          uint8_t maxFractionDigits) {
+    static constexpr std::size_t maxFormatters = 32;
+    static thread_local std::unordered_map<std::string, icu::number::LocalizedNumberFormatter> formatters;
+
+    std::string key = localeId;
+    key += '\0';
+    key += currency;
+    key += '\0';
+    key += static_cast<char>(minFractionDigits);
+    key += static_cast<char>(maxFractionDigits);
+
+    auto it = formatters.find(key);
+    if (it != formatters.end()) {
+        return &it->second;
+    }
+
+    UErrorCode status = U_ZERO_ERROR;
+    icu::number::LocalizedNumberFormatter formatter;
     icu::Locale locale = icu::Locale(localeId.c_str());
     // Print the value as currency
     if (!currency.empty()) {
         icu::UnicodeString ucurrency = icu::UnicodeString::fromUTF8(currency);
-        ustr = icu::number::NumberFormatter::with()
-                   .unit(icu::CurrencyUnit(ucurrency.getBuffer(), status))
-                   .locale(locale)
-                   .formatDouble(number, status)
-                   .toString(status);
+        formatter = icu::number::NumberFormatter::with()
+                        .unit(icu::CurrencyUnit(ucurrency.getBuffer(), status))
+                        .locale(locale);
     } else {
-        ustr = icu::number::NumberFormatter::with()
-                   .precision(icu::number::Precision::minMaxFraction(minFractionDigits, maxFractionDigits))
-                   .locale(locale)
-                   .formatDouble(number, status)
-                   .toString(status);
+        formatter = icu::number::NumberFormatter::with()
+                        .precision(icu::number::Precision::minMaxFraction(minFractionDigits, maxFractionDigits))
+                        .locale(locale);
+    }
+    if (U_FAILURE(status)) {
+        return nullptr;
     }
+
+    if (formatters.size() >= maxFormatters) {
+        formatters.clear();
+    }
+    return &formatters.emplace(std::move(key), std::move(formatter)).first->second;
+}
+
+} // namespace
+
+std::string formatNumber(double number,
+                         const std::string& localeId,
+                         const std::string& currency,
+                         uint8_t minFractionDigits,
+                         uint8_t maxFractionDigits) {
+    std::string formatted;
+    const auto* formatter = getFormatter(localeId, currency, minFractionDigits, maxFractionDigits);
+    if (!formatter) {
+        return formatted;
+    }
+
+    UErrorCode status = U_ZERO_ERROR;
+    icu::UnicodeString ustr = formatter->formatDouble(number, status).toString(status);
     return ustr.toUTF8String(formatted);
 }
 #else
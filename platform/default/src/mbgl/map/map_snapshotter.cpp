@@ -2,10 +2,12 @@
 
 #include <mbgl/actor/actor_ref.hpp>
 #include <mbgl/gfx/headless_frontend.hpp>
+#include <mbgl/map/camera.hpp>
 #include <mbgl/map/map.hpp>
 #include <mbgl/map/map_options.hpp>
 #include <mbgl/map/transform.hpp>
 #include <mbgl/map/transform_state.hpp>
+#include <mbgl/renderer/load_progress.hpp>
 #include <mbgl/renderer/renderer_observer.hpp>
 #include <mbgl/renderer/update_parameters.hpp>
 #include <mbgl/storage/resource_options.hpp>
@@ -43,6 +45,10 @@ public:
         delegate.invoke(&RendererObserver::onStyleImageMissing, image, cb);
     }
 
+    void onDidUpdateLoadProgress(const LoadProgress& progress) override {
+        delegate.invoke(&RendererObserver::onDidUpdateLoadProgress, progress);
+    }
+
 private:
     std::shared_ptr<Mailbox> mailbox;
     ActorRef<RendererObserver> delegate;
@@ -50,12 +56,16 @@ private:
 
 class SnapshotterRenderer final : public RendererObserver {
 public:
-    SnapshotterRenderer(Size size, float pixelRatio, const optional<std::string>& localFontFamily)
+    SnapshotterRenderer(Size size,
+                        float pixelRatio,
+                        const optional<std::string>& localFontFamily,
+                        optional<uint32_t> device)
         : frontend(size,
                    pixelRatio,
                    gfx::HeadlessBackend::SwapBehaviour::NoFlush,
                    gfx::ContextMode::Unique,
-                   localFontFamily) {}
+                   localFontFamily,
+                   device) {}
 
     void reset() {
         hasPendingStillImageRequest = false;
@@ -80,6 +90,10 @@ public:
         rendererObserver->onStyleImageMissing(id, done);
     }
 
+    void onDidUpdateLoadProgress(const LoadProgress& progress) override {
+        rendererObserver->onDidUpdateLoadProgress(progress);
+    }
+
     void setObserver(std::shared_ptr<RendererObserver> observer) {
         assert(observer);
         rendererObserver = std::move(observer);
@@ -108,9 +122,12 @@ private:
 
 class SnapshotterRendererFrontend final : public RendererFrontend {
 public:
-    SnapshotterRendererFrontend(Size size, float pixelRatio, optional<std::string> localFontFamily)
+    SnapshotterRendererFrontend(Size size,
+                                float pixelRatio,
+                                optional<std::string> localFontFamily,
+                                optional<uint32_t> device)
         : renderer(std::make_unique<util::Thread<SnapshotterRenderer>>(
-              "Snapshotter", size, pixelRatio, std::move(localFontFamily))) {}
+              "Snapshotter", size, pixelRatio, std::move(localFontFamily), device)) {}
 
     ~SnapshotterRendererFrontend() override = default;
 
@@ -148,9 +165,10 @@ public:
          float pixelRatio,
          const ResourceOptions& resourceOptions,
          MapSnapshotterObserver& observer_,
-         optional<std::string> localFontFamily)
+         optional<std::string> localFontFamily,
+         optional<uint32_t> device)
         : observer(observer_),
-          frontend(size, pixelRatio, std::move(localFontFamily)),
+          frontend(size, pixelRatio, std::move(localFontFamily), device),
           map(frontend,
               *this,
               MapOptions().withMapMode(MapMode::Static).withSize(size).withPixelRatio(pixelRatio),
@@ -168,14 +186,88 @@ public:
             return;
         }
 
-        if (renderStillCallback) {
+        if (renderStillCallback || batch) {
             callback(std::make_exception_ptr(util::MisuseException("MapSnapshotter is currently rendering an image")),
                      PremultipliedImage(),
                      {},
                      {},
                      {});
+            return;
+        }
+
+        renderStill(std::move(callback));
+    }
+
+    void snapshotBatch(std::vector<CameraOptions> cameras, MapSnapshotter::BatchCallback callback) {
+        if (!callback) {
+            Log::Error(Event::General, "MapSnapshotter::BatchCallback is not set");
+            return;
+        }
+
+        if (renderStillCallback || batch) {
+            callback(0,
+                     std::make_exception_ptr(util::MisuseException("MapSnapshotter is currently rendering an image")),
+                     PremultipliedImage(),
+                     {},
+                     {},
+                     {});
+            return;
+        }
+
+        batch = std::make_unique<Batch>(Batch{std::move(cameras), std::move(callback), 0});
+        snapshotNextCamera();
+    }
+
+    // MapObserver overrides
+    void onDidFailLoadingMap(MapLoadError, const std::string& error) override { observer.onDidFailLoadingStyle(error); }
+    void onDidFinishLoadingStyle() override { observer.onDidFinishLoadingStyle(); }
+    void onStyleImageMissing(const std::string& image) override { observer.onStyleImageMissing(image); }
+
+    Map& getMap() { return map; }
+    const Map& getMap() const { return map; }
+    SnapshotterRendererFrontend& getRenderer() { return frontend; }
+
+    void cancel() {
+        renderStillCallback.reset();
+        if (batch) {
+            batch.reset();
+            map.setPrefetchCamera(nullopt);
         }
+    }
+
+private:
+    struct Batch {
+        std::vector<CameraOptions> cameras;
+        MapSnapshotter::BatchCallback callback;
+        std::size_t next;
+    };
+
+    void snapshotNextCamera() {
+        if (batch->next == batch->cameras.size()) {
+            cancel();
+            return;
+        }
+
+        // The map only renders one still image at a time, but the tiles for the camera after
+        // this one load along with it.
+        const std::size_t index = batch->next++;
+        map.setPrefetchCamera(batch->next < batch->cameras.size() ? batch->cameras[batch->next]
+                                                                  : optional<CameraOptions>());
+        map.jumpTo(batch->cameras[index]);
+
+        renderStill([this, index](std::exception_ptr ptr,
+                                  PremultipliedImage image,
+                                  Attributions attributions,
+                                  PointForFn pfn,
+                                  LatLngForFn latLonFn) {
+            // The callback may cancel the batch.
+            auto callback = batch->callback;
+            callback(
+                index, std::move(ptr), std::move(image), std::move(attributions), std::move(pfn), std::move(latLonFn));
+        });
+    }
 
+    void renderStill(MapSnapshotter::Callback callback) {
         renderStillCallback = std::make_unique<Actor<MapSnapshotter::Callback>>(
             *Scheduler::GetCurrent(),
             [this, cb = std::move(callback)](std::exception_ptr ptr,
@@ -183,8 +275,13 @@ public:
                                              Attributions attributions,
                                              PointForFn pfn,
                                              LatLngForFn latLonFn) {
+                Impl* impl = this;
                 cb(std::move(ptr), std::move(image), std::move(attributions), std::move(pfn), std::move(latLonFn));
-                renderStillCallback.reset();
+                // Destroys this lambda, so only locals are used from here on.
+                impl->renderStillCallback.reset();
+                if (impl->batch) {
+                    impl->snapshotNextCamera();
+                }
             });
 
         map.renderStill([this, actorRef = renderStillCallback->self()](const std::exception_ptr& error) {
@@ -228,18 +325,8 @@ public:
         });
     }
 
-    // MapObserver overrides
-    void onDidFailLoadingMap(MapLoadError, const std::string& error) override { observer.onDidFailLoadingStyle(error); }
-    void onDidFinishLoadingStyle() override { observer.onDidFinishLoadingStyle(); }
-    void onStyleImageMissing(const std::string& image) override { observer.onStyleImageMissing(image); }
-
-    Map& getMap() { return map; }
-    const Map& getMap() const { return map; }
-    SnapshotterRendererFrontend& getRenderer() { return frontend; }
-    void cancel() { renderStillCallback.reset(); }
-
-private:
     std::unique_ptr<Actor<MapSnapshotter::Callback>> renderStillCallback;
+    std::unique_ptr<Batch> batch;
     MapSnapshotterObserver& observer;
     SnapshotterRendererFrontend frontend;
     Map map;
@@ -249,9 +336,10 @@ MapSnapshotter::MapSnapshotter(Size size,
                                float pixelRatio,
                                const ResourceOptions& resourceOptions,
                                MapSnapshotterObserver& observer,
-                               optional<std::string> localFontFamily)
+                               optional<std::string> localFontFamily,
+                               optional<uint32_t> device)
     : impl(std::make_unique<MapSnapshotter::Impl>(
-          size, pixelRatio, resourceOptions, observer, std::move(localFontFamily))) {}
+          size, pixelRatio, resourceOptions, observer, std::move(localFontFamily), device)) {}
 
 MapSnapshotter::MapSnapshotter(Size size, float pixelRatio, const ResourceOptions& resourceOptions)
     : MapSnapshotter(size, pixelRatio, resourceOptions, MapSnapshotterObserver::nullObserver()) {}
@@ -312,6 +400,10 @@ void MapSnapshotter::snapshot(MapSnapshotter::Callback callback) {
     impl->snapshot(std::move(callback));
 }
 
+void MapSnapshotter::snapshotBatch(std::vector<CameraOptions> cameras, MapSnapshotter::BatchCallback callback) {
+    impl->snapshotBatch(std::move(cameras), std::move(callback));
+}
+
 void MapSnapshotter::cancel() {
     impl->cancel();
 }
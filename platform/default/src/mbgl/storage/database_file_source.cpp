@@ -1,3 +1,4 @@
+#include <mbgl/actor/scheduler.hpp>
 #include <mbgl/platform/settings.hpp>
 #include <mbgl/storage/database_file_source.hpp>
 #include <mbgl/storage/file_source_manager.hpp>
@@ -9,52 +10,177 @@
 #include <mbgl/util/constants.hpp>
 #include <mbgl/util/logging.hpp>
 #include <mbgl/util/platform.hpp>
+#include <mbgl/util/string.hpp>
 #include <mbgl/util/thread.hpp>
+#include <mbgl/util/timer.hpp>
 
+#include <atomic>
 #include <map>
+#include <mutex>
 #include <utility>
+#include <vector>
 
 namespace mbgl {
+
+namespace {
+
+// How long batched ambient cache writes may stay uncommitted.
+constexpr const Duration writeBatchInterval = Seconds(1);
+
+// The time between requesting resources and answering the requests, for one database queue.
+// Recorded on the database threads, read on any thread.
+class QueueLatency {
+public:
+    void record(Duration latency) {
+        const uint64_t us = std::chrono::duration_cast<std::chrono::microseconds>(latency).count();
+        requests++;
+        total += us;
+        uint64_t previous = maximum;
+        while (us > previous && !maximum.compare_exchange_weak(previous, us)) {
+        }
+    }
+
+    mapbox::base::Value toValue() const {
+        const uint64_t count = requests;
+        return mapbox::base::ValueObject{
+            {"requests", count},
+            {"mean-ms", count ? total / 1000.0 / count : 0.0},
+            {"max-ms", maximum / 1000.0},
+        };
+    }
+
+private:
+    std::atomic<uint64_t> requests{0};
+    // In microseconds.
+    std::atomic<uint64_t> total{0};
+    std::atomic<uint64_t> maximum{0};
+};
+
+Response notFound() {
+    Response response;
+    response.noContent = true;
+    response.error =
+        std::make_unique<Response::Error>(Response::Error::Reason::NotFound, "Not found in offline database");
+    return response;
+}
+
+// Answers the request from the database. Returns whether the resource was found. Compressed
+// data is inflated on the thread pool, so that the database thread can go on with the next
+// query meanwhile.
+bool respond(OfflineDatabase& db,
+             Scheduler& threadPool,
+             const Resource& resource,
+             const ActorRef<FileSourceRequest>& req,
+             TimePoint requested,
+             const std::shared_ptr<QueueLatency>& latency) {
+    const TimePoint lookup = Clock::now();
+    auto offlineResponse = db.getCompressed(resource);
+    const Duration lookupTime = Clock::now() - lookup;
+    const bool found = bool(offlineResponse);
+    if (!offlineResponse) {
+        offlineResponse.emplace();
+        offlineResponse->response = notFound();
+    } else if (!offlineResponse->response.isUsable()) {
+        offlineResponse->response.error =
+            std::make_unique<Response::Error>(Response::Error::Reason::NotFound, "Cached resource is unusable");
+    }
+    auto timing = std::make_unique<Response::Timing>();
+    timing->database = lookupTime;
+    offlineResponse->response.timing = std::move(timing);
+
+    if (!offlineResponse->compressed) {
+        latency->record(Clock::now() - requested);
+        req.invoke(&FileSourceRequest::setResponse, offlineResponse->response);
+        return found;
+    }
+
+    auto decompress = [compressed = std::move(*offlineResponse), req, requested, latency]() mutable {
+        try {
+            compressed.decompress();
+        } catch (const std::exception& ex) {
+            Log::Error(Event::Database, "Can't decompress resource: %s", ex.what());
+            compressed.response = notFound();
+        }
+        latency->record(Clock::now() - requested);
+        req.invoke(&FileSourceRequest::setResponse, compressed.response);
+    };
+    threadPool.scheduleTagged(TaskTag::Database, TaskPriority::Default, std::move(decompress));
+    return found;
+}
+
+} // namespace
+
+class DatabaseFileSourceReader;
+
 class DatabaseFileSourceThread {
 public:
-    DatabaseFileSourceThread(std::shared_ptr<FileSource> onlineFileSource_, const std::string& cachePath)
-        : db(std::make_unique<OfflineDatabase>(cachePath)), onlineFileSource(std::move(onlineFileSource_)) {}
+    DatabaseFileSourceThread(ActorRef<DatabaseFileSourceThread> self_,
+                             std::shared_ptr<FileSource> onlineFileSource_,
+                             const std::string& cachePath,
+                             std::shared_ptr<QueueLatency> latency_)
+        : self(std::move(self_)),
+          db(std::make_unique<OfflineDatabase>(cachePath)),
+          path(cachePath),
+          onlineFileSource(std::move(onlineFileSource_)),
+          latency(std::move(latency_)),
+          threadPool(Scheduler::GetBackground()) {}
+
+    void request(const Resource& resource, const ActorRef<FileSourceRequest>& req, TimePoint requested) {
+        respond(*db, *threadPool, resource, req, requested, latency);
+        scheduleFlush();
+    }
 
-    void request(const Resource& resource, const ActorRef<FileSourceRequest>& req) {
-        auto offlineResponse = db->get(resource);
-        if (!offlineResponse) {
-            offlineResponse.emplace();
-            offlineResponse->noContent = true;
-            offlineResponse->error =
-                std::make_unique<Response::Error>(Response::Error::Reason::NotFound, "Not found in offline database");
-        } else if (!offlineResponse->isUsable()) {
-            offlineResponse->error =
-                std::make_unique<Response::Error>(Response::Error::Reason::NotFound, "Cached resource is unusable");
+    // Records a cache hit served by a reader.
+    void markAccessed(const Resource& resource) {
+        db->markAccessed(resource);
+        scheduleFlush();
+    }
+
+    void setReaders(std::vector<ActorRef<DatabaseFileSourceReader>> readers_) {
+        readers = std::move(readers_);
+        if (!readers.empty()) {
+            // Otherwise readers and the writer wait for each other's locks.
+            db->setWriteAheadLogging(true);
         }
-        req.invoke(&FileSourceRequest::setResponse, *offlineResponse);
+        openReaders();
     }
 
-    void setDatabasePath(const std::string& path, const std::function<void()>& callback) {
-        db->changePath(path);
+    void setDatabasePath(const std::string& path_, const std::function<void()>& callback) {
+        db->changePath(path_);
+        path = path_;
+        openReaders();
         if (callback) {
             callback();
         }
     }
 
     void forward(const Resource& resource, const Response& response, const std::function<void()>& callback) {
-        db->put(resource, response);
+        put(resource, response);
         if (callback) {
             callback();
         }
     }
 
-    void resetDatabase(const std::function<void(std::exception_ptr)>& callback) { callback(db->resetDatabase()); }
+    void resetDatabase(const std::function<void(std::exception_ptr)>& callback) {
+        auto result = db->resetDatabase();
+        openReaders();
+        callback(result);
+    }
 
     void packDatabase(const std::function<void(std::exception_ptr)>& callback) { callback(db->pack()); }
 
     void runPackDatabaseAutomatically(bool autopack) { db->runPackDatabaseAutomatically(autopack); }
 
-    void put(const Resource& resource, const Response& response) { db->put(resource, response); }
+    void put(const Resource& resource, const Response& response) {
+        db->put(resource, response);
+        scheduleFlush();
+    }
+
+    void setWriteBatchSize(uint64_t size) { db->setWriteBatchSize(size); }
+
+    void setAccessTimeResolution(uint64_t seconds) { db->setAccessTimeResolution(Seconds(seconds)); }
+
+    void setWriteAheadLogging(bool enabled) { db->setWriteAheadLogging(enabled); }
 
     void invalidateAmbientCache(const std::function<void(std::exception_ptr)>& callback) {
         callback(db->invalidateAmbientCache());
@@ -79,8 +205,32 @@ public:
     }
 
     void mergeOfflineRegions(const std::string& sideDatabasePath,
-                             const std::function<void(expected<OfflineRegions, std::exception_ptr>)>& callback) {
-        callback(db->mergeDatabase(sideDatabasePath));
+                             const std::function<void(expected<OfflineRegions, std::exception_ptr>)>& callback,
+                             const std::function<void(uint64_t, uint64_t)>& progress) {
+        if (std::exception_ptr error = db->beginMerge(sideDatabasePath)) {
+            callback(unexpected<std::exception_ptr>(error));
+            return;
+        }
+        mergeNextChunk(callback, progress);
+    }
+
+    // Each chunk goes to the back of the queue, behind the requests that came in meanwhile.
+    void mergeNextChunk(const std::function<void(expected<OfflineRegions, std::exception_ptr>)>& callback,
+                        const std::function<void(uint64_t, uint64_t)>& progress) {
+        auto more = db->mergeNextChunk();
+        if (!more) {
+            callback(unexpected<std::exception_ptr>(more.error()));
+            return;
+        }
+        if (progress) {
+            const auto merged = db->getMergeProgress();
+            progress(merged.first, merged.second);
+        }
+        if (*more) {
+            self.invoke(&DatabaseFileSourceThread::mergeNextChunk, callback, progress);
+            return;
+        }
+        callback(db->finishMerge());
     }
 
     void updateMetadata(const int64_t regionID,
@@ -124,6 +274,19 @@ public:
     void reopenDatabaseReadOnly(bool readOnly) { db->reopenDatabaseReadOnly(readOnly); }
 
 private:
+    // Readers are only opened once the writer has created the database.
+    void openReaders();
+
+    void scheduleFlush() {
+        if (db->hasPendingWrites() && !flushScheduled) {
+            flushScheduled = true;
+            flushTimer.start(writeBatchInterval, Duration::zero(), [this] {
+                flushScheduled = false;
+                db->flushPendingWrites();
+            });
+        }
+    }
+
     expected<OfflineDownload*, std::exception_ptr> getDownload(int64_t regionID) {
         if (!onlineFileSource) {
             return unexpected<std::exception_ptr>(
@@ -143,27 +306,145 @@ private:
         return downloads.emplace(regionID, std::move(download)).first->second.get();
     }
 
+    ActorRef<DatabaseFileSourceThread> self;
     std::unique_ptr<OfflineDatabase> db;
+    std::string path;
     std::map<int64_t, std::unique_ptr<OfflineDownload>> downloads;
     std::shared_ptr<FileSource> onlineFileSource;
+    util::Timer flushTimer;
+    bool flushScheduled = false;
+    std::vector<ActorRef<DatabaseFileSourceReader>> readers;
+    const std::shared_ptr<QueueLatency> latency;
+    const std::shared_ptr<Scheduler> threadPool;
+};
+
+// Serves cache reads from a read-only connection of its own, so that they don't wait for the
+// writes and region downloads queued on the database thread. Reads don't see ambient cache
+// writes that are still batched.
+class DatabaseFileSourceReader {
+public:
+    DatabaseFileSourceReader(ActorRef<DatabaseFileSourceThread> writer_, std::shared_ptr<QueueLatency> latency_)
+        : writer(std::move(writer_)), latency(std::move(latency_)), threadPool(Scheduler::GetBackground()) {}
+
+    void open(const std::string& path) {
+        db.reset();
+        // In-memory databases are private to their connection, so their reads go to the writer.
+        if (path != ":memory:") {
+            db = std::make_unique<OfflineDatabase>(path, true /*readOnly*/);
+        }
+    }
+
+    void request(const Resource& resource, const ActorRef<FileSourceRequest>& req, TimePoint requested) {
+        if (!db) {
+            writer.invoke(&DatabaseFileSourceThread::request, resource, req, requested);
+            return;
+        }
+        if (respond(*db, *threadPool, resource, req, requested, latency)) {
+            writer.invoke(&DatabaseFileSourceThread::markAccessed, resource);
+        }
+    }
+
+private:
+    std::unique_ptr<OfflineDatabase> db;
+    ActorRef<DatabaseFileSourceThread> writer;
+    const std::shared_ptr<QueueLatency> latency;
+    const std::shared_ptr<Scheduler> threadPool;
 };
 
+void DatabaseFileSourceThread::openReaders() {
+    for (auto& reader : readers) {
+        reader.invoke(&DatabaseFileSourceReader::open, path);
+    }
+}
+
 class DatabaseFileSource::Impl {
 public:
     Impl(std::shared_ptr<FileSource> onlineFileSource, const std::string& cachePath)
-        : thread(std::make_unique<util::Thread<DatabaseFileSourceThread>>(
+        : latency(std::make_shared<QueueLatency>()),
+          thread(std::make_unique<util::Thread<DatabaseFileSourceThread>>(
               util::makeThreadPrioritySetter(platform::EXPERIMENTAL_THREAD_PRIORITY_DATABASE),
               "DatabaseFileSource",
               std::move(onlineFileSource),
-              cachePath)) {}
+              cachePath,
+              latency)) {}
 
     ActorRef<DatabaseFileSourceThread> actor() const { return thread->actor(); }
 
-    void pause() { thread->pause(); }
-    void resume() { thread->resume(); }
+    void request(const Resource& resource, const ActorRef<FileSourceRequest>& req) {
+        std::lock_guard<std::mutex> lock(readersMutex);
+        if (readers.empty()) {
+            actor().invoke(&DatabaseFileSourceThread::request, resource, req, Clock::now());
+            return;
+        }
+        auto& reader = readers[nextReader++ % readers.size()];
+        reader.thread->actor().invoke(&DatabaseFileSourceReader::request, resource, req, Clock::now());
+    }
+
+    void setReaderPoolSize(std::size_t size) {
+        std::vector<Reader> created;
+        std::vector<ActorRef<DatabaseFileSourceReader>> refs;
+        for (std::size_t i = 0; i < size; ++i) {
+            auto readerLatency = std::make_shared<QueueLatency>();
+            created.push_back({std::make_unique<util::Thread<DatabaseFileSourceReader>>(
+                                   util::makeThreadPrioritySetter(platform::EXPERIMENTAL_THREAD_PRIORITY_DATABASE),
+                                   "DatabaseFileSourceReader",
+                                   actor(),
+                                   readerLatency),
+                               readerLatency});
+            refs.push_back(created.back().thread->actor());
+        }
+        {
+            std::lock_guard<std::mutex> lock(readersMutex);
+            std::swap(readers, created);
+            nextReader = 0;
+            actor().invoke(&DatabaseFileSourceThread::setReaders, std::move(refs));
+        }
+        // The previous readers are joined here, without holding up the requests.
+    }
+
+    std::size_t getReaderPoolSize() const {
+        std::lock_guard<std::mutex> lock(readersMutex);
+        return readers.size();
+    }
+
+    mapbox::base::Value getQueueLatency() const {
+        mapbox::base::ValueObject result{{"database", latency->toValue()}};
+        std::lock_guard<std::mutex> lock(readersMutex);
+        for (std::size_t i = 0; i < readers.size(); ++i) {
+            result.emplace("reader-" + util::toString(i), readers[i].latency->toValue());
+        }
+        return result;
+    }
+
+    void pause() {
+        thread->pause();
+        std::lock_guard<std::mutex> lock(readersMutex);
+        for (auto& reader : readers) {
+            reader.thread->pause();
+        }
+    }
+
+    void resume() {
+        thread->resume();
+        std::lock_guard<std::mutex> lock(readersMutex);
+        for (auto& reader : readers) {
+            reader.thread->resume();
+        }
+    }
 
 private:
+    struct Reader {
+        std::unique_ptr<util::Thread<DatabaseFileSourceReader>> thread;
+        std::shared_ptr<QueueLatency> latency;
+    };
+
+    const std::shared_ptr<QueueLatency> latency;
     const std::unique_ptr<util::Thread<DatabaseFileSourceThread>> thread;
+    // The pool size is set from the client thread, while requests come from the thread of the
+    // resource loader.
+    mutable std::mutex readersMutex;
+    std::vector<Reader> readers;
+    std::size_t nextReader = 0;
 };
 
 DatabaseFileSource::DatabaseFileSource(const ResourceOptions& options)
@@ -174,7 +455,7 @@ DatabaseFileSource::~DatabaseFileSource() = default;
 
 std::unique_ptr<AsyncRequest> DatabaseFileSource::request(const Resource& resource, Callback callback) {
     auto req = std::make_unique<FileSourceRequest>(std::move(callback));
-    impl->actor().invoke(&DatabaseFileSourceThread::request, resource, req->actor());
+    impl->request(resource, req->actor());
     return std::move(req);
 }
 
@@ -189,7 +470,8 @@ void DatabaseFileSource::forward(const Resource& res, const Response& response,
 bool DatabaseFileSource::canRequest(const Resource& resource) const {
     return resource.hasLoadingMethod(Resource::LoadingMethod::Cache) &&
            resource.url.rfind(mbgl::util::ASSET_PROTOCOL, 0) == std::string::npos &&
-           resource.url.rfind(mbgl::util::FILE_PROTOCOL, 0) == std::string::npos;
+           resource.url.rfind(mbgl::util::FILE_PROTOCOL, 0) == std::string::npos &&
+           resource.url.rfind(mbgl::util::PMTILES_PROTOCOL, 0) == std::string::npos;
 }
 
 void DatabaseFileSource::setDatabasePath(const std::string& path, std::function<void()> callback) {
@@ -237,8 +519,11 @@ void DatabaseFileSource::createOfflineRegion(
 }
 
 void DatabaseFileSource::mergeOfflineRegions(
-    const std::string& sideDatabasePath, std::function<void(expected<OfflineRegions, std::exception_ptr>)> callback) {
-    impl->actor().invoke(&DatabaseFileSourceThread::mergeOfflineRegions, sideDatabasePath, std::move(callback));
+    const std::string& sideDatabasePath,
+    std::function<void(expected<OfflineRegions, std::exception_ptr>)> callback,
+    std::function<void(uint64_t, uint64_t)> progress) {
+    impl->actor().invoke(
+        &DatabaseFileSourceThread::mergeOfflineRegions, sideDatabasePath, std::move(callback), std::move(progress));
 }
 
 void DatabaseFileSource::updateOfflineMetadata(
@@ -280,12 +565,31 @@ void DatabaseFileSource::setOfflineMapboxTileCountLimit(uint64_t limit) const {
 void DatabaseFileSource::setProperty(const std::string& key, const mapbox::base::Value& value) {
     if (key == READ_ONLY_MODE_KEY && value.getBool()) {
         impl->actor().invoke(&DatabaseFileSourceThread::reopenDatabaseReadOnly, *value.getBool());
+    } else if (key == WRITE_BATCH_SIZE_KEY && value.getUint()) {
+        impl->actor().invoke(&DatabaseFileSourceThread::setWriteBatchSize, *value.getUint());
+    } else if (key == ACCESS_TIME_RESOLUTION_KEY && value.getUint()) {
+        impl->actor().invoke(&DatabaseFileSourceThread::setAccessTimeResolution, *value.getUint());
+    } else if (key == WRITE_AHEAD_LOG_KEY && value.getBool()) {
+        impl->actor().invoke(&DatabaseFileSourceThread::setWriteAheadLogging, *value.getBool());
+    } else if (key == READER_POOL_SIZE_KEY && value.getUint()) {
+        impl->setReaderPoolSize(*value.getUint());
     } else {
         std::string message = "Resource provider does not support property " + key;
         Log::Error(Event::General, message.c_str());
     }
 }
 
+mapbox::base::Value DatabaseFileSource::getProperty(const std::string& key) const {
+    if (key == READER_POOL_SIZE_KEY) {
+        return uint64_t(impl->getReaderPoolSize());
+    } else if (key == QUEUE_LATENCY_KEY) {
+        return impl->getQueueLatency();
+    }
+    std::string message = "Resource provider does not support property " + key;
+    Log::Error(Event::General, message.c_str());
+    return {};
+}
+
 void DatabaseFileSource::pause() {
     impl->pause();
 }
@@ -5,6 +5,7 @@
 #include <mbgl/storage/main_resource_loader.hpp>
 #include <mbgl/storage/online_file_source.hpp>
 #include <mbgl/storage/resource_options.hpp>
+#include <mbgl/storage/tile_archive_file_source.hpp>
 
 namespace mbgl {
 
@@ -32,6 +33,9 @@ public:
             networkSource->setProperty(API_BASE_URL_KEY, options.baseURL());
             return networkSource;
         });
+
+        registerFileSourceFactory(FileSourceType::TileArchive,
+                                  [](const ResourceOptions&) { return std::make_unique<TileArchiveFileSource>(); });
     }
 };
 
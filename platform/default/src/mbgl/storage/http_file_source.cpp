@@ -14,6 +14,8 @@
 #include <curl/curl.h>
 
 #include <dlfcn.h>
+#include <algorithm>
+#include <cstdlib>
 #include <queue>
 #include <map>
 #include <cassert>
@@ -32,6 +34,12 @@ static void handleError(CURLcode code) {
     }
 }
 
+static void handleError(CURLSHcode code) {
+    if (code != CURLSHE_OK) {
+        throw std::runtime_error(std::string("CURL share error: ") + curl_share_strerror(code));
+    }
+}
+
 namespace mbgl {
 
 class HTTPFileSource::Impl {
@@ -73,6 +81,7 @@ public:
 private:
     static size_t headerCallback(char *buffer, size_t size, size_t nmemb, void *userp);
     static size_t writeCallback(void *contents, size_t size, size_t nmemb, void *userp);
+    std::unique_ptr<const Response::Timing> getTiming() const;
 
     HTTPFileSource::Impl* context = nullptr;
     Resource resource;
@@ -84,6 +93,8 @@ private:
 
     optional<std::string> retryAfter;
     optional<std::string> xRateLimitReset;
+    // Length of the body as sent, which is its compressed length when it is encoded.
+    optional<size_t> contentLength;
 
     CURL *handle = nullptr;
     curl_slist *headers = nullptr;
@@ -96,13 +107,21 @@ HTTPFileSource::Impl::Impl() {
         throw std::runtime_error("Could not init cURL");
     }
 
+    // New connections reuse the DNS lookups and TLS sessions of earlier ones. Requests only
+    // run on this thread, so the share handle needs no locking.
     share = curl_share_init();
+    handleError(curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS));
+    handleError(curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION));
 
     multi = curl_multi_init();
     handleError(curl_multi_setopt(multi, CURLMOPT_SOCKETFUNCTION, handleSocket));
     handleError(curl_multi_setopt(multi, CURLMOPT_SOCKETDATA, this));
     handleError(curl_multi_setopt(multi, CURLMOPT_TIMERFUNCTION, startTimeout));
     handleError(curl_multi_setopt(multi, CURLMOPT_TIMERDATA, this));
+#if LIBCURL_VERSION_NUM >= ((7) << 16 | (43) << 8 | 0) // Added in 7.43.0
+    // Requests to the same HTTP/2 host share one connection.
+    handleError(curl_multi_setopt(multi, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX));
+#endif
 }
 
 HTTPFileSource::Impl::~Impl() {
@@ -260,6 +279,12 @@ HTTPRequest::HTTPRequest(HTTPFileSource::Impl* context_, Resource resource_, Fil
 #endif
     handleError(curl_easy_setopt(handle, CURLOPT_USERAGENT, "MapboxGL/1.0"));
     handleError(curl_easy_setopt(handle, CURLOPT_SHARE, context->share));
+#if LIBCURL_VERSION_NUM >= ((7) << 16 | (47) << 8 | 0) // Added in 7.47.0
+    // Negotiates HTTP/2 over TLS where libcurl supports it, which fails otherwise and keeps HTTP/1.1.
+    curl_easy_setopt(handle, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS);
+    // Waits for a connection that can be multiplexed rather than opening another one.
+    handleError(curl_easy_setopt(handle, CURLOPT_PIPEWAIT, 1L));
+#endif
 
     // Start requesting the information.
     handleError(curl_multi_add_handle(context->multi, handle));
@@ -287,6 +312,11 @@ size_t HTTPRequest::writeCallback(void *const contents, const size_t size, const
 
     if (!impl->data) {
         impl->data = std::make_shared<std::string>();
+        // Saves reallocating the body as it arrives. Bounded so that a bogus header can't make us
+        // allocate more than a tile or GeoJSON source plausibly needs.
+        if (impl->contentLength) {
+            impl->data->reserve(std::min<size_t>(*impl->contentLength, 64 * 1024 * 1024));
+        }
     }
 
     impl->data->append(static_cast<char *>(contents), size * nmemb);
@@ -338,11 +368,49 @@ size_t HTTPRequest::headerCallback(char *const buffer, const size_t size, const
         baton->retryAfter = std::string(buffer + begin, length - begin - 2); // remove \r\n
     } else if ((begin = headerMatches("x-rate-limit-reset: ", buffer, length)) != std::string::npos) {
         baton->xRateLimitReset = std::string(buffer + begin, length - begin - 2); // remove \r\n
+    } else if ((begin = headerMatches("content-length: ", buffer, length)) != std::string::npos) {
+        const std::string value{buffer + begin, length - begin - 2}; // remove \r\n
+        char* end = nullptr;
+        const unsigned long long contentLength = std::strtoull(value.c_str(), &end, 10);
+        if (end != value.c_str()) {
+            baton->contentLength = static_cast<size_t>(contentLength);
+        }
     }
 
     return length;
 }
 
+std::unique_ptr<const Response::Timing> HTTPRequest::getTiming() const {
+    // curl reports the times since the start of the request at which each phase was done.
+    double dns = 0, connect = 0, tls = 0, firstByte = 0, total = 0;
+    if (curl_easy_getinfo(handle, CURLINFO_NAMELOOKUP_TIME, &dns) != CURLE_OK ||
+        curl_easy_getinfo(handle, CURLINFO_CONNECT_TIME, &connect) != CURLE_OK ||
+        curl_easy_getinfo(handle, CURLINFO_APPCONNECT_TIME, &tls) != CURLE_OK ||
+        curl_easy_getinfo(handle, CURLINFO_STARTTRANSFER_TIME, &firstByte) != CURLE_OK ||
+        curl_easy_getinfo(handle, CURLINFO_TOTAL_TIME, &total) != CURLE_OK) {
+        return nullptr;
+    }
+
+    auto duration = [](double seconds) {
+        return std::chrono::duration_cast<Duration>(std::chrono::duration<double>(std::max(seconds, 0.0)));
+    };
+
+    auto timing = std::make_unique<Response::Timing>();
+    timing->dns = duration(dns);
+    // Reused connections take no time to connect; failed requests report 0 for the phases they didn't reach.
+    timing->connect = duration(connect - dns);
+    double sent = std::max(connect, dns);
+    if (tls > 0) {
+        timing->tls = duration(tls - sent);
+        sent = tls;
+    }
+    if (firstByte > 0) {
+        timing->firstByte = duration(firstByte - sent);
+    }
+    timing->network = duration(total);
+    return std::move(timing);
+}
+
 void HTTPRequest::handleResult(CURLcode code) {
     // Make sure a response object exists in case we haven't got any headers or content.
     if (!response) {
@@ -400,6 +468,8 @@ void HTTPRequest::handleResult(CURLcode code) {
         }
     }
 
+    response->timing = getTiming();
+
     // Calling `callback` may result in deleting `this`. Copy data to temporaries first.
     auto callback_ = callback;
     auto response_ = *response;
@@ -6,27 +6,207 @@
 #include <mbgl/storage/main_resource_loader.hpp>
 #include <mbgl/storage/resource.hpp>
 #include <mbgl/storage/resource_options.hpp>
+#include <mbgl/storage/response.hpp>
+#include <mbgl/util/logging.hpp>
 #include <mbgl/util/stopwatch.hpp>
 #include <mbgl/util/thread.hpp>
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <cassert>
+#include <iterator>
+#include <list>
 #include <map>
+#include <unordered_map>
 
 namespace mbgl {
 
+namespace {
+constexpr uint64_t defaultMemoryCacheSize = 8 * 1024 * 1024;
+} // namespace
+
+// A byte-bounded LRU of recently loaded responses, which share their data with the requesters.
+// Modified on the loader thread only; the statistics may be read on any thread.
+class MemoryResponseCache {
+public:
+    // Responses that may no longer be used are dropped, so that the database handles their revalidation.
+    optional<Response> get(const std::string& url) {
+        auto it = index.find(url);
+        if (it != index.end() && !it->second->second.isUsable()) {
+            erase(url);
+            it = index.end();
+        }
+        if (it == index.end()) {
+            misses++;
+            return nullopt;
+        }
+        entries.splice(entries.begin(), entries, it->second);
+        hits++;
+        return it->second->second;
+    }
+
+    void put(const std::string& url, const Response& response) {
+        assert(response.data);
+        erase(url);
+        const uint64_t bytes = url.size() + response.data->size();
+        if (bytes > maximumSize) {
+            return;
+        }
+        entries.emplace_front(url, response);
+        // Memory hits take no time of the file sources.
+        entries.front().second.timing.reset();
+        index.emplace(url, entries.begin());
+        size += bytes;
+        evict();
+    }
+
+    void erase(const std::string& url) {
+        auto it = index.find(url);
+        if (it != index.end()) {
+            size -= entrySize(*it->second);
+            entries.erase(it->second);
+            index.erase(it);
+            count = entries.size();
+        }
+    }
+
+    void setMaximumSize(uint64_t maximumSize_) {
+        maximumSize = maximumSize_;
+        evict();
+    }
+
+    mapbox::base::Value getStats() const {
+        return mapbox::base::ValueObject{{"hits", uint64_t(hits)},
+                                         {"misses", uint64_t(misses)},
+                                         {"size", uint64_t(size)},
+                                         {"count", uint64_t(count)}};
+    }
+
+private:
+    using Entry = std::pair<std::string, Response>;
+
+    static uint64_t entrySize(const Entry& entry) { return entry.first.size() + entry.second.data->size(); }
+
+    void evict() {
+        while (size > maximumSize) {
+            size -= entrySize(entries.back());
+            index.erase(entries.back().first);
+            entries.pop_back();
+        }
+        count = entries.size();
+    }
+
+    std::list<Entry> entries;
+    std::unordered_map<std::string, std::list<Entry>::iterator> index;
+    uint64_t maximumSize = defaultMemoryCacheSize;
+
+    std::atomic<uint64_t> hits{0};
+    std::atomic<uint64_t> misses{0};
+    std::atomic<uint64_t> size{0};
+    std::atomic<uint64_t> count{0};
+};
+
+// Histograms of the phases of the responses' timing, scraped through REQUEST_TIMING_KEY.
+// Recorded on the loader thread, read on any thread.
+class RequestTimingHistogram {
+public:
+    void record(const Response::Timing& timing) {
+        record(Phase::Queued, timing.queued);
+        record(Phase::Database, timing.database);
+        record(Phase::DNS, timing.dns);
+        record(Phase::Connect, timing.connect);
+        record(Phase::TLS, timing.tls);
+        record(Phase::FirstByte, timing.firstByte);
+        record(Phase::Network, timing.network);
+    }
+
+    mapbox::base::Value toValue() const {
+        static const char* names[] = {"queued", "database", "dns", "connect", "tls", "first-byte", "network"};
+        mapbox::base::ValueObject result;
+        for (std::size_t phase = 0; phase < phaseCount; ++phase) {
+            const Histogram& histogram = histograms[phase];
+            mapbox::base::ValueArray buckets;
+            for (std::size_t i = 0; i < bucketCount; ++i) {
+                mapbox::base::ValueObject bucket{{"count", uint64_t(histogram.buckets[i])}};
+                if (i < bucketCount - 1) {
+                    bucket.emplace("max-ms", bucketLimits[i]);
+                }
+                buckets.emplace_back(std::move(bucket));
+            }
+            const uint64_t count = histogram.requests;
+            result.emplace(names[phase],
+                           mapbox::base::ValueObject{{"requests", count},
+                                                     {"mean-ms", count ? histogram.total / 1000.0 / count : 0.0},
+                                                     {"max-ms", histogram.maximum / 1000.0},
+                                                     {"buckets", std::move(buckets)}});
+        }
+        return result;
+    }
+
+private:
+    enum Phase { Queued, Database, DNS, Connect, TLS, FirstByte, Network, phaseCount };
+
+    // The upper limits in milliseconds of the buckets; the last bucket takes the rest.
+    static constexpr std::size_t bucketCount = 13;
+    static constexpr uint64_t bucketLimits[bucketCount - 1] = {1, 2, 5, 10, 20, 50, 100, 200, 500, 1000, 2000, 5000};
+
+    struct Histogram {
+        std::atomic<uint64_t> requests{0};
+        // In microseconds.
+        std::atomic<uint64_t> total{0};
+        std::atomic<uint64_t> maximum{0};
+        std::array<std::atomic<uint64_t>, bucketCount> buckets{};
+    };
+
+    void record(Phase phase, const optional<Duration>& duration) {
+        if (!duration) {
+            return;
+        }
+        const uint64_t us = std::chrono::duration_cast<std::chrono::microseconds>(*duration).count();
+        Histogram& histogram = histograms[phase];
+        histogram.requests++;
+        histogram.total += us;
+        if (us > histogram.maximum) {
+            histogram.maximum = us;
+        }
+        const auto limit = std::lower_bound(std::begin(bucketLimits), std::end(bucketLimits), (us + 999) / 1000);
+        histogram.buckets[limit - std::begin(bucketLimits)]++;
+    }
+
+    std::array<Histogram, phaseCount> histograms;
+};
+
+constexpr uint64_t RequestTimingHistogram::bucketLimits[];
+
 class MainResourceLoaderThread {
 public:
     MainResourceLoaderThread(std::shared_ptr<FileSource> assetFileSource_,
                              std::shared_ptr<FileSource> databaseFileSource_,
                              std::shared_ptr<FileSource> localFileSource_,
-                             std::shared_ptr<FileSource> onlineFileSource_)
+                             std::shared_ptr<FileSource> onlineFileSource_,
+                             std::shared_ptr<FileSource> tileArchiveFileSource_,
+                             std::shared_ptr<MemoryResponseCache> memoryCache_,
+                             std::shared_ptr<RequestTimingHistogram> timing_)
         : assetFileSource(std::move(assetFileSource_)),
           databaseFileSource(std::move(databaseFileSource_)),
           localFileSource(std::move(localFileSource_)),
-          onlineFileSource(std::move(onlineFileSource_)) {}
+          onlineFileSource(std::move(onlineFileSource_)),
+          tileArchiveFileSource(std::move(tileArchiveFileSource_)),
+          memoryCache(std::move(memoryCache_)),
+          timing(std::move(timing_)) {}
 
     void request(AsyncRequest* req, const Resource& resource, const ActorRef<FileSourceRequest>& ref) {
         auto callback = [ref](const Response& res) { ref.invoke(&FileSourceRequest::setResponse, res); };
+        // Records the responses of the database and the network, whether or not they are passed on.
+        auto observe = [this](const Resource& res, const Response& response) {
+            if (response.timing) {
+                timing->record(*response.timing);
+                if (timingObserver) {
+                    timingObserver(res, *response.timing);
+                }
+            }
+        };
 
         auto requestFromNetwork = [=](const Resource& res,
                                       std::unique_ptr<AsyncRequest> parent) -> std::unique_ptr<AsyncRequest> {
@@ -39,9 +219,16 @@ public:
 
             MBGL_TIMING_START(watch);
             return onlineFileSource->request(res, [=, ptr = parentKeepAlive](const Response& response) {
+                observe(res, response);
                 if (databaseFileSource) {
                     databaseFileSource->forward(res, response, nullptr);
                 }
+                if (response.notModified) {
+                    // The database holds the updated expiration.
+                    memoryCache->erase(res.url);
+                } else if (!response.error && response.data) {
+                    memoryCache->put(res.url, response);
+                }
                 if (res.kind == Resource::Kind::Tile) {
                     // onlineResponse.data will be null if data not modified
                     MBGL_TIMING_FINISH(watch,
@@ -66,35 +253,60 @@ public:
         } else if (localFileSource && localFileSource->canRequest(resource)) {
             // Local file request
             tasks[req] = localFileSource->request(resource, callback);
+        } else if (tileArchiveFileSource && tileArchiveFileSource->canRequest(resource)) {
+            // Tile archive request
+            tasks[req] = tileArchiveFileSource->request(resource, callback);
         } else if (databaseFileSource && databaseFileSource->canRequest(resource)) {
-            // Try cache only request if needed.
-            if (resource.loadingMethod == Resource::LoadingMethod::CacheOnly) {
-                tasks[req] = databaseFileSource->request(resource, callback);
+            auto onCachedResponse = [=](const Response& response) {
+                Resource res = resource;
+
+                // Resource is in the cache
+                if (!response.noContent) {
+                    if (response.isUsable()) {
+                        callback(response);
+                        // Set the priority of existing resource to low if it's expired but usable.
+                        res.setPriority(Resource::Priority::Low);
+                    } else {
+                        // Set prior data only if it was not returned to the requester.
+                        // Once we get 304 response from the network, we will forward response
+                        // to the requester.
+                        res.priorData = response.data;
+                    }
+
+                    // Copy response fields for cache control request
+                    res.priorModified = response.modified;
+                    res.priorExpires = response.expires;
+                    res.priorEtag = response.etag;
+                }
+
+                tasks[req] = requestFromNetwork(res, std::move(tasks[req]));
+            };
+            auto remember = [=](const Response& response) {
+                if (!response.error && response.data) {
+                    memoryCache->put(resource.url, response);
+                }
+            };
+
+            if (auto cached = memoryCache->get(resource.url)) {
+                // Recently loaded responses are handled like database hits, without a database request.
+                if (resource.loadingMethod == Resource::LoadingMethod::CacheOnly) {
+                    callback(*cached);
+                    return;
+                }
+                onCachedResponse(*cached);
+            } else if (resource.loadingMethod == Resource::LoadingMethod::CacheOnly) {
+                // Try cache only request if needed.
+                tasks[req] = databaseFileSource->request(resource, [=](const Response& response) {
+                    observe(resource, response);
+                    remember(response);
+                    callback(response);
+                });
             } else {
                 // Cache request with fallback to network with cache control
                 tasks[req] = databaseFileSource->request(resource, [=](const Response& response) {
-                    Resource res = resource;
-
-                    // Resource is in the cache
-                    if (!response.noContent) {
-                        if (response.isUsable()) {
-                            callback(response);
-                            // Set the priority of existing resource to low if it's expired but usable.
-                            res.setPriority(Resource::Priority::Low);
-                        } else {
-                            // Set prior data only if it was not returned to the requester.
-                            // Once we get 304 response from the network, we will forward response
-                            // to the requester.
-                            res.priorData = response.data;
-                        }
-
-                        // Copy response fields for cache control request
-                        res.priorModified = response.modified;
-                        res.priorExpires = response.expires;
-                        res.priorEtag = response.etag;
-                    }
-
-                    tasks[req] = requestFromNetwork(res, std::move(tasks[req]));
+                    observe(resource, response);
+                    remember(response);
+                    onCachedResponse(response);
                 });
             }
         } else if (auto networkReq = requestFromNetwork(resource, nullptr)) {
@@ -117,11 +329,19 @@ public:
         tasks.erase(req);
     }
 
+    void setMemoryCacheSize(uint64_t size) { memoryCache->setMaximumSize(size); }
+
+    void setTimingObserver(MainResourceLoader::TimingObserver observer) { timingObserver = std::move(observer); }
+
 private:
     const std::shared_ptr<FileSource> assetFileSource;
     const std::shared_ptr<FileSource> databaseFileSource;
     const std::shared_ptr<FileSource> localFileSource;
     const std::shared_ptr<FileSource> onlineFileSource;
+    const std::shared_ptr<FileSource> tileArchiveFileSource;
+    const std::shared_ptr<MemoryResponseCache> memoryCache;
+    const std::shared_ptr<RequestTimingHistogram> timing;
+    MainResourceLoader::TimingObserver timingObserver;
     std::map<AsyncRequest*, std::unique_ptr<AsyncRequest>> tasks;
 };
 
@@ -130,19 +350,26 @@ public:
     Impl(std::shared_ptr<FileSource> assetFileSource_,
          std::shared_ptr<FileSource> databaseFileSource_,
          std::shared_ptr<FileSource> localFileSource_,
-         std::shared_ptr<FileSource> onlineFileSource_)
+         std::shared_ptr<FileSource> onlineFileSource_,
+         std::shared_ptr<FileSource> tileArchiveFileSource_)
         : assetFileSource(std::move(assetFileSource_)),
           databaseFileSource(std::move(databaseFileSource_)),
           localFileSource(std::move(localFileSource_)),
           onlineFileSource(std::move(onlineFileSource_)),
+          tileArchiveFileSource(std::move(tileArchiveFileSource_)),
           supportsCacheOnlyRequests_(bool(databaseFileSource)),
+          memoryCache(std::make_shared<MemoryResponseCache>()),
+          timing(std::make_shared<RequestTimingHistogram>()),
           thread(std::make_unique<util::Thread<MainResourceLoaderThread>>(
               util::makeThreadPrioritySetter(platform::EXPERIMENTAL_THREAD_PRIORITY_WORKER),
               "ResourceLoaderThread",
               assetFileSource,
               databaseFileSource,
               localFileSource,
-              onlineFileSource)) {}
+              onlineFileSource,
+              tileArchiveFileSource,
+              memoryCache,
+              timing)) {}
 
     std::unique_ptr<AsyncRequest> request(const Resource& resource, Callback callback) {
         auto req = std::make_unique<FileSourceRequest>(std::move(callback));
@@ -157,12 +384,28 @@ public:
     bool canRequest(const Resource& resource) const {
         return (assetFileSource && assetFileSource->canRequest(resource)) ||
                (localFileSource && localFileSource->canRequest(resource)) ||
+               (tileArchiveFileSource && tileArchiveFileSource->canRequest(resource)) ||
                (databaseFileSource && databaseFileSource->canRequest(resource)) ||
                (onlineFileSource && onlineFileSource->canRequest(resource));
     }
 
     bool supportsCacheOnlyRequests() const { return supportsCacheOnlyRequests_; }
 
+    void setMemoryCacheSize(uint64_t size) {
+        memoryCacheSize = size;
+        thread->actor().invoke(&MainResourceLoaderThread::setMemoryCacheSize, size);
+    }
+
+    uint64_t getMemoryCacheSize() const { return memoryCacheSize; }
+
+    mapbox::base::Value getMemoryCacheStats() const { return memoryCache->getStats(); }
+
+    mapbox::base::Value getRequestTiming() const { return timing->toValue(); }
+
+    void setTimingObserver(TimingObserver observer) {
+        thread->actor().invoke(&MainResourceLoaderThread::setTimingObserver, std::move(observer));
+    }
+
     void pause() { thread->pause(); }
 
     void resume() { thread->resume(); }
@@ -172,7 +415,11 @@ private:
     const std::shared_ptr<FileSource> databaseFileSource;
     const std::shared_ptr<FileSource> localFileSource;
     const std::shared_ptr<FileSource> onlineFileSource;
+    const std::shared_ptr<FileSource> tileArchiveFileSource;
     const bool supportsCacheOnlyRequests_;
+    const std::shared_ptr<MemoryResponseCache> memoryCache;
+    const std::shared_ptr<RequestTimingHistogram> timing;
+    uint64_t memoryCacheSize = defaultMemoryCacheSize;
     const std::unique_ptr<util::Thread<MainResourceLoaderThread>> thread;
 };
 
@@ -180,7 +427,8 @@ MainResourceLoader::MainResourceLoader(const ResourceOptions& options)
     : impl(std::make_unique<Impl>(FileSourceManager::get()->getFileSource(FileSourceType::Asset, options),
                                   FileSourceManager::get()->getFileSource(FileSourceType::Database, options),
                                   FileSourceManager::get()->getFileSource(FileSourceType::FileSystem, options),
-                                  FileSourceManager::get()->getFileSource(FileSourceType::Network, options))) {}
+                                  FileSourceManager::get()->getFileSource(FileSourceType::Network, options),
+                                  FileSourceManager::get()->getFileSource(FileSourceType::TileArchive, options))) {}
 
 MainResourceLoader::~MainResourceLoader() = default;
 
@@ -196,6 +444,32 @@ bool MainResourceLoader::canRequest(const Resource& resource) const {
     return impl->canRequest(resource);
 }
 
+void MainResourceLoader::setProperty(const std::string& key, const mapbox::base::Value& value) {
+    if (key == MEMORY_CACHE_SIZE_KEY && value.getUint()) {
+        impl->setMemoryCacheSize(*value.getUint());
+    } else {
+        std::string message = "Resource provider does not support property " + key;
+        Log::Error(Event::General, message.c_str());
+    }
+}
+
+mapbox::base::Value MainResourceLoader::getProperty(const std::string& key) const {
+    if (key == MEMORY_CACHE_SIZE_KEY) {
+        return impl->getMemoryCacheSize();
+    } else if (key == MEMORY_CACHE_STATS_KEY) {
+        return impl->getMemoryCacheStats();
+    } else if (key == REQUEST_TIMING_KEY) {
+        return impl->getRequestTiming();
+    }
+    std::string message = "Resource provider does not support property " + key;
+    Log::Error(Event::General, message.c_str());
+    return {};
+}
+
+void MainResourceLoader::setTimingObserver(TimingObserver observer) {
+    impl->setTimingObserver(std::move(observer));
+}
+
 void MainResourceLoader::pause() {
     impl->pause();
 }
@@ -8,12 +8,45 @@
 #include <mbgl/util/logging.hpp>
 
 #include <mbgl/storage/offline_schema.hpp>
-#include <mbgl/storage/merge_sideloaded.hpp>
+
+#include <algorithm>
+#include <array>
 
 namespace mbgl {
 
-OfflineDatabase::OfflineDatabase(std::string path_)
-    : path(std::move(path_)) {
+namespace {
+
+// Tiles sampled per tileset before training its compression dictionary.
+constexpr std::size_t dictionarySampleCount = 32;
+constexpr std::size_t dictionarySampleSize = 1024 * 1024;
+// Bounds the memory held by samples of tilesets that see few tiles.
+constexpr std::size_t dictionarySampledTilesets = 8;
+
+// Entries evicted together, and how long an incremental eviction may hold the database.
+constexpr int64_t evictionBatchSize = 50;
+constexpr Duration evictionTimeBudget = Milliseconds(4);
+
+// Buffered access times written together at the latest.
+constexpr std::size_t maxPendingAccesses = 1024;
+
+// Side tiles or resources copied per transaction of a merge.
+constexpr int64_t mergeChunkSize = 256;
+
+} // namespace
+
+void CompressedResponse::decompress() {
+    if (!compressed) {
+        return;
+    }
+    assert(response.data);
+    response.data = std::make_shared<std::string>(dictionary ? util::decompress(*response.data, *dictionary)
+                                                             : util::decompress(*response.data));
+    compressed = false;
+    dictionary.reset();
+}
+
+OfflineDatabase::OfflineDatabase(std::string path_, bool readOnly_)
+    : path(std::move(path_)), readOnly(readOnly_) {
     try {
         initialize();
     } catch (...) {
@@ -43,6 +76,8 @@ void OfflineDatabase::initialize() {
         mapbox::sqlite::Database::open(path, mapbox::sqlite::ReadWriteCreate));
     db->setBusyTimeout(Milliseconds::max());
     db->exec("PRAGMA foreign_keys = ON");
+    // Otherwise the tiles that REPLACE removes don't release their shared data.
+    db->exec("PRAGMA recursive_triggers = ON");
 
     const auto userVersion = getPragma<int64_t>("PRAGMA user_version");
     switch (userVersion) {
@@ -51,7 +86,7 @@ void OfflineDatabase::initialize() {
         // Newly created database, or old cache-only database; remove old table if it exists.
         removeOldCacheTable();
         createSchema();
-        return;
+        break;
     case 2:
         migrateToVersion3();
         // fall through
@@ -65,12 +100,29 @@ void OfflineDatabase::initialize() {
         migrateToVersion6();
         // fall through
     case 6:
+        migrateToVersion7();
+        // fall through
+    case 7:
+        migrateToVersion8();
+        // fall through
+    case 8:
+        migrateToVersion9();
+        // fall through
+    case 9:
+        migrateToVersion10();
+        // fall through
+    case 10:
         // Happy path; we're done
-        return;
+        break;
     default:
         // Downgrade: delete the database and try to reinitialize.
         removeExisting();
         initialize();
+        return;
+    }
+
+    if (writeAheadLogging) {
+        applyJournalMode();
     }
 }
 
@@ -84,8 +136,18 @@ void OfflineDatabase::changePath(const std::string& path_) {
 void OfflineDatabase::cleanup() {
     // Deleting these SQLite objects may result in exceptions
     try {
+        commitPendingWrites();
+    } catch (...) {
+        handleError("write resources");
+    }
+    try {
+        pendingTransaction.reset();
         statements.clear();
         db.reset();
+        dictionaries.clear();
+        currentAmbientCacheSize = nullopt;
+        // The side database of a merge is attached to this connection only.
+        merge = nullopt;
     } catch (...) {
         handleError("close database");
     }
@@ -149,10 +211,24 @@ void OfflineDatabase::handleError(const char* action) {
 void OfflineDatabase::removeExisting() {
     Log::Warning(Event::Database, "Removing existing incompatible offline database");
 
+    pendingTransaction.reset();
+    pendingWrites = 0;
     statements.clear();
     db.reset();
+    dictionaries.clear();
+    currentAmbientCacheSize = nullopt;
+    merge = nullopt;
+    pendingTileAccesses.clear();
+    pendingResourceAccesses.clear();
 
+    // A read-only connection can't recreate the database, so it leaves the file to the writer.
+    if (readOnly) {
+        return;
+    }
     util::deleteFile(path);
+    // A stale journal would be applied to the new database.
+    util::deleteFile(path + "-wal");
+    util::deleteFile(path + "-shm");
 }
 
 void OfflineDatabase::removeOldCacheTable() {
@@ -172,7 +248,82 @@ void OfflineDatabase::createSchema() {
     db->exec("PRAGMA synchronous = FULL");
     mapbox::sqlite::Transaction transaction(*db);
     db->exec(offlineDatabaseSchema);
-    db->exec("PRAGMA user_version = 6");
+    db->exec("PRAGMA user_version = 10");
+    transaction.commit();
+}
+
+void OfflineDatabase::migrateToVersion8() {
+    assert(db);
+    checkFlags();
+
+    // The size is summed up once more and stored from then on.
+    mapbox::sqlite::Transaction transaction(*db);
+    db->exec(
+        "CREATE TABLE ambient_cache ("
+        "  id INTEGER NOT NULL PRIMARY KEY CHECK (id = 1),"
+        "  size INTEGER NOT NULL,"
+        "  eviction_cursor INTEGER NOT NULL DEFAULT 0"
+        ")");
+    db->exec("PRAGMA user_version = 8");
+    transaction.commit();
+}
+
+void OfflineDatabase::migrateToVersion9() {
+    assert(db);
+    checkFlags();
+
+    mapbox::sqlite::Transaction transaction(*db);
+    db->exec(
+        "CREATE TABLE region_checkpoints ("
+        "  region_id INTEGER NOT NULL REFERENCES regions(id) ON DELETE CASCADE,"
+        "  url_template TEXT NOT NULL,"
+        "  tile_count INTEGER NOT NULL,"
+        "  tiles INTEGER NOT NULL,"
+        "  completed_tiles INTEGER NOT NULL,"
+        "  completed_size INTEGER NOT NULL,"
+        "  UNIQUE (region_id, url_template)"
+        ")");
+    db->exec("PRAGMA user_version = 9");
+    transaction.commit();
+}
+
+void OfflineDatabase::migrateToVersion10() {
+    assert(db);
+    checkFlags();
+
+    // Existing tiles keep their data; only new tiles share theirs.
+    mapbox::sqlite::Transaction transaction(*db);
+    db->exec("ALTER TABLE tiles ADD COLUMN data_id INTEGER");
+    db->exec(
+        "CREATE TABLE tile_data ("
+        "  id INTEGER NOT NULL PRIMARY KEY,"
+        "  checksum INTEGER NOT NULL,"
+        "  data BLOB NOT NULL,"
+        "  refs INTEGER NOT NULL"
+        ")");
+    db->exec("CREATE INDEX tile_data_checksum ON tile_data (checksum)");
+    db->exec(
+        "CREATE TRIGGER tiles_data_insert AFTER INSERT ON tiles "
+        "WHEN new.data_id IS NOT NULL "
+        "BEGIN "
+        "  UPDATE tile_data SET refs = refs + 1 WHERE id = new.data_id; "
+        "END");
+    db->exec(
+        "CREATE TRIGGER tiles_data_update AFTER UPDATE OF data_id ON tiles "
+        "WHEN new.data_id IS NOT old.data_id "
+        "BEGIN "
+        "  UPDATE tile_data SET refs = refs + 1 WHERE id = new.data_id; "
+        "  UPDATE tile_data SET refs = refs - 1 WHERE id = old.data_id; "
+        "  DELETE FROM tile_data WHERE id = old.data_id AND refs = 0; "
+        "END");
+    db->exec(
+        "CREATE TRIGGER tiles_data_delete AFTER DELETE ON tiles "
+        "WHEN old.data_id IS NOT NULL "
+        "BEGIN "
+        "  UPDATE tile_data SET refs = refs - 1 WHERE id = old.data_id; "
+        "  DELETE FROM tile_data WHERE id = old.data_id AND refs = 0; "
+        "END");
+    db->exec("PRAGMA user_version = 10");
     transaction.commit();
 }
 
@@ -210,6 +361,23 @@ void OfflineDatabase::migrateToVersion6() {
     transaction.commit();
 }
 
+void OfflineDatabase::migrateToVersion7() {
+    assert(db);
+    checkFlags();
+
+    // Existing tiles stay as they are; only new tiles get compressed against dictionaries.
+    mapbox::sqlite::Transaction transaction(*db);
+    db->exec(
+        "CREATE TABLE dictionaries ("
+        "  id INTEGER NOT NULL PRIMARY KEY,"
+        "  url_template TEXT NOT NULL,"
+        "  data BLOB NOT NULL"
+        ")");
+    db->exec("CREATE INDEX dictionaries_url_template ON dictionaries (url_template)");
+    db->exec("PRAGMA user_version = 7");
+    transaction.commit();
+}
+
 void OfflineDatabase::vacuum() {
     assert(db);
     checkFlags();
@@ -228,6 +396,76 @@ void OfflineDatabase::checkFlags() {
     }
 }
 
+void OfflineDatabase::commitPendingWrites() {
+    if (!pendingTileAccesses.empty() || !pendingResourceAccesses.empty()) {
+        if (!db) {
+            pendingTileAccesses.clear();
+            pendingResourceAccesses.clear();
+        } else {
+            if (!pendingTransaction) {
+                pendingTransaction =
+                    std::make_unique<mapbox::sqlite::Transaction>(*db, mapbox::sqlite::Transaction::Immediate);
+            }
+            writePendingAccesses();
+        }
+    }
+    if (!pendingTransaction) {
+        return;
+    }
+    auto transaction = std::move(pendingTransaction);
+    pendingWrites = 0;
+    transaction->commit();
+}
+
+std::exception_ptr OfflineDatabase::flushPendingWrites() try {
+    commitPendingWrites();
+    return nullptr;
+} catch (...) {
+    // The writes were rolled back, so the cached size is stale.
+    currentAmbientCacheSize = nullopt;
+    handleError("write resources");
+    return std::current_exception();
+}
+
+void OfflineDatabase::setWriteBatchSize(uint64_t maxBatchSize) {
+    writeBatchSize = maxBatchSize;
+    if (pendingWrites >= writeBatchSize) {
+        flushPendingWrites();
+    }
+}
+
+void OfflineDatabase::setAccessTimeResolution(Seconds resolution) {
+    accessTimeResolution = resolution;
+    if (accessTimeResolution == Seconds::zero()) {
+        flushPendingWrites();
+    }
+}
+
+void OfflineDatabase::setWriteAheadLogging(bool enabled) try {
+    if (writeAheadLogging == enabled) return;
+    writeAheadLogging = enabled;
+    if (db && !readOnly) {
+        commitPendingWrites();
+        applyJournalMode();
+    }
+} catch (...) {
+    handleError("change journal mode");
+}
+
+void OfflineDatabase::applyJournalMode() {
+    assert(db);
+    checkFlags();
+
+    // The journal mode is stored in the database file, the synchronization mode is not.
+    if (writeAheadLogging) {
+        db->exec("PRAGMA journal_mode = WAL");
+        db->exec("PRAGMA synchronous = NORMAL");
+    } else {
+        db->exec("PRAGMA journal_mode = DELETE");
+        db->exec("PRAGMA synchronous = FULL");
+    }
+}
+
 mapbox::sqlite::Statement& OfflineDatabase::getStatement(const char* sql) {
     if (!db) {
         initialize();
@@ -251,7 +489,32 @@ optional<Response> OfflineDatabase::get(const Resource& resource) try {
     return nullopt;
 }
 
+optional<CompressedResponse> OfflineDatabase::getCompressed(const Resource& resource) try {
+    if (disabled()) {
+        return nullopt;
+    }
+
+    auto result = getCompressedInternal(resource);
+    return result ? optional<CompressedResponse>{ std::move(result->first) } : nullopt;
+} catch (...) {
+    handleError("read resource");
+    return nullopt;
+}
+
 optional<std::pair<Response, uint64_t>> OfflineDatabase::getInternal(const Resource& resource) {
+    auto result = getCompressedInternal(resource);
+    if (!result) {
+        return nullopt;
+    }
+    result->first.decompress();
+    return std::make_pair(std::move(result->first.response), result->second);
+}
+
+optional<std::pair<CompressedResponse, uint64_t>> OfflineDatabase::getCompressedInternal(const Resource& resource) {
+    if (!readOnly) {
+        updateAccessed(resource);
+    }
+
     if (resource.kind == Resource::Kind::Tile) {
         assert(resource.tileData);
         return getTile(*resource.tileData);
@@ -260,6 +523,96 @@ optional<std::pair<Response, uint64_t>> OfflineDatabase::getInternal(const Resou
     }
 }
 
+void OfflineDatabase::markAccessed(const Resource& resource) try {
+    if (!readOnly) {
+        updateAccessed(resource);
+    }
+} catch (...) {
+    handleError("update timestamp");
+}
+
+void OfflineDatabase::updateAccessed(const Resource& resource) {
+    if (accessTimeResolution > Seconds::zero()) {
+        const auto sinceEpoch = util::now().time_since_epoch();
+        const Timestamp accessed(sinceEpoch - sinceEpoch % accessTimeResolution);
+        if (resource.kind == Resource::Kind::Tile) {
+            assert(resource.tileData);
+            const Resource::TileData& tile = *resource.tileData;
+            pendingTileAccesses[TileKey(tile.urlTemplate, tile.pixelRatio, tile.x, tile.y, tile.z)] = accessed;
+        } else {
+            pendingResourceAccesses[resource.url] = accessed;
+        }
+        if (pendingTileAccesses.size() + pendingResourceAccesses.size() >= maxPendingAccesses) {
+            commitPendingWrites();
+        }
+        return;
+    }
+
+    // Update accessed timestamp used for LRU eviction.
+    try {
+        if (resource.kind == Resource::Kind::Tile) {
+            assert(resource.tileData);
+            writeTileAccessed(*resource.tileData, util::now());
+        } else {
+            writeResourceAccessed(resource.url, util::now());
+        }
+    } catch (const mapbox::sqlite::Exception& ex) {
+        if (ex.code == mapbox::sqlite::ResultCode::NotADB || ex.code == mapbox::sqlite::ResultCode::Corrupt) {
+            throw;
+        }
+
+        // If we don't have any indication that the database is corrupt, continue as usual.
+        Log::Warning(Event::Database, static_cast<int>(ex.code), "Can't update timestamp: %s", ex.what());
+    }
+}
+
+void OfflineDatabase::writeTileAccessed(const Resource::TileData& tile, Timestamp accessed) {
+    // Rows that are up to date aren't written again.
+    // clang-format off
+    mapbox::sqlite::Query accessedQuery{ getStatement(
+        "UPDATE tiles "
+        "SET accessed       = ?1 "
+        "WHERE url_template = ?2 "
+        "  AND pixel_ratio  = ?3 "
+        "  AND x            = ?4 "
+        "  AND y            = ?5 "
+        "  AND z            = ?6 "
+        "  AND accessed     < ?1 ") };
+    // clang-format on
+
+    accessedQuery.bind(1, accessed);
+    accessedQuery.bind(2, tile.urlTemplate, false);
+    accessedQuery.bind(3, tile.pixelRatio);
+    accessedQuery.bind(4, tile.x);
+    accessedQuery.bind(5, tile.y);
+    accessedQuery.bind(6, tile.z);
+    accessedQuery.run();
+}
+
+void OfflineDatabase::writeResourceAccessed(const std::string& url, Timestamp accessed) {
+    mapbox::sqlite::Query accessedQuery{
+        getStatement("UPDATE resources SET accessed = ?1 WHERE url = ?2 AND accessed < ?1")};
+    accessedQuery.bind(1, accessed);
+    accessedQuery.bind(2, url, false);
+    accessedQuery.run();
+}
+
+void OfflineDatabase::writePendingAccesses() {
+    auto tiles = std::move(pendingTileAccesses);
+    auto resources = std::move(pendingResourceAccesses);
+    pendingTileAccesses.clear();
+    pendingResourceAccesses.clear();
+    for (const auto& access : tiles) {
+        const TileKey& key = access.first;
+        writeTileAccessed(
+            {std::get<0>(key), std::get<1>(key), std::get<2>(key), std::get<3>(key), std::get<4>(key)},
+            access.second);
+    }
+    for (const auto& access : resources) {
+        writeResourceAccessed(access.first, access.second);
+    }
+}
+
 optional<int64_t> OfflineDatabase::hasInternal(const Resource& resource) {
     if (resource.kind == Resource::Kind::Tile) {
         assert(resource.tileData);
@@ -280,11 +633,29 @@ std::pair<bool, uint64_t> OfflineDatabase::put(const Resource& resource, const R
         return { false, 0 };
     }
 
-    mapbox::sqlite::Transaction transaction(*db, mapbox::sqlite::Transaction::Immediate);
+    if (writeBatchSize == 0) {
+        mapbox::sqlite::Transaction transaction(*db, mapbox::sqlite::Transaction::Immediate);
+        auto result = putInternal(resource, response, true);
+        transaction.commit();
+        return result;
+    }
+
+    if (!pendingTransaction) {
+        pendingTransaction =
+            std::make_unique<mapbox::sqlite::Transaction>(*db, mapbox::sqlite::Transaction::Immediate);
+    }
     auto result = putInternal(resource, response, true);
-    transaction.commit();
+    if (++pendingWrites >= writeBatchSize) {
+        commitPendingWrites();
+    }
     return result;
 } catch (...) {
+    if (pendingTransaction || pendingWrites) {
+        // The batch is rolled back as a whole, so the cached size is stale.
+        pendingTransaction.reset();
+        pendingWrites = 0;
+        currentAmbientCacheSize = nullopt;
+    }
     handleError("write resource");
     return {false, 0};
 }
@@ -297,19 +668,26 @@ std::pair<bool, uint64_t> OfflineDatabase::putInternal(const Resource& resource,
     }
 
     std::string compressedData;
-    bool compressed = false;
+    Compression compression = Compression::None;
     uint64_t size = 0;
 
     if (response.data) {
-        compressedData = util::compress(*response.data);
-        compressed = compressedData.size() < response.data->size();
-        size = compressed ? compressedData.size() : response.data->size();
+        const std::string* dictionary = nullptr;
+        if (resource.kind == Resource::Kind::Tile) {
+            assert(resource.tileData);
+            dictionary = getCompressionDictionary(resource.tileData->urlTemplate, *response.data);
+        }
+        compressedData = dictionary ? util::compress(*response.data, *dictionary) : util::compress(*response.data);
+        if (compressedData.size() < response.data->size()) {
+            compression = dictionary ? Compression::DeflateWithDictionary : Compression::Deflate;
+        }
+        size = compression != Compression::None ? compressedData.size() : response.data->size();
     }
 
     optional<DatabaseSizeChangeStats> stats;
     if (evict_) {
         stats = DatabaseSizeChangeStats(this);
-        if (!evict(size, *stats)) {
+        if (!evict(size, *stats, true /* incremental */)) {
             Log::Info(Event::Database, "Unable to make space for entry");
             return {false, 0};
         }
@@ -320,12 +698,12 @@ std::pair<bool, uint64_t> OfflineDatabase::putInternal(const Resource& resource,
     if (resource.kind == Resource::Kind::Tile) {
         assert(resource.tileData);
         inserted = putTile(*resource.tileData, response,
-                compressed ? compressedData : response.data ? *response.data : "",
-                compressed);
+                compression != Compression::None ? compressedData : response.data ? *response.data : "",
+                compression);
     } else {
         inserted = putResource(resource, response,
-                compressed ? compressedData : response.data ? *response.data : "",
-                compressed);
+                compression != Compression::None ? compressedData : response.data ? *response.data : "",
+                compression);
     }
 
     if (stats) {
@@ -335,24 +713,80 @@ std::pair<bool, uint64_t> OfflineDatabase::putInternal(const Resource& resource,
     return { inserted, size };
 }
 
-optional<std::pair<Response, uint64_t>> OfflineDatabase::getResource(const Resource& resource) {
-    // Update accessed timestamp used for LRU eviction.
-    if (!readOnly) {
-        try {
-            mapbox::sqlite::Query accessedQuery{getStatement("UPDATE resources SET accessed = ?1 WHERE url = ?2")};
-            accessedQuery.bind(1, util::now());
-            accessedQuery.bind(2, resource.url);
-            accessedQuery.run();
-        } catch (const mapbox::sqlite::Exception& ex) {
-            if (ex.code == mapbox::sqlite::ResultCode::NotADB || ex.code == mapbox::sqlite::ResultCode::Corrupt) {
-                throw;
-            }
+const std::string* OfflineDatabase::getCompressionDictionary(const std::string& urlTemplate,
+                                                               const std::string& data) {
+    // The tileset's dictionary is looked up every time rather than cached, since the
+    // transaction that stored it may still be rolled back.
+    // clang-format off
+    mapbox::sqlite::Query query{ getStatement(
+        "SELECT id FROM dictionaries "
+        "WHERE url_template = ?1 "
+        "LIMIT 1") };
+    // clang-format on
 
-            // If we don't have any indication that the database is corrupt, continue as usual.
-            Log::Warning(Event::Database, static_cast<int>(ex.code), "Can't update timestamp: %s", ex.what());
-        }
+    query.bind(1, urlTemplate);
+    if (query.run()) {
+        return getDictionary(uint32_t(query.get<int64_t>(0))).get();
     }
+    if (untrainedTilesets.count(urlTemplate)) {
+        return nullptr;
+    }
+
+    if (!dictionarySamples.count(urlTemplate) && dictionarySamples.size() >= dictionarySampledTilesets) {
+        return nullptr;
+    }
+
+    auto& samples = dictionarySamples[urlTemplate];
+    samples.tiles.push_back(data);
+    samples.size += data.size();
+    if (samples.tiles.size() < dictionarySampleCount && samples.size < dictionarySampleSize) {
+        return nullptr;
+    }
+
+    std::string dictionary = util::trainDictionary(samples.tiles);
+    dictionarySamples.erase(urlTemplate);
+    if (dictionary.empty()) {
+        untrainedTilesets.insert(urlTemplate);
+        return nullptr;
+    }
+
+    const uint32_t id = util::dictionaryID(dictionary);
+    // clang-format off
+    mapbox::sqlite::Query insertQuery{ getStatement(
+        "INSERT OR IGNORE INTO dictionaries (id, url_template, data) "
+        "VALUES                             (?1, ?2,           ?3)") };
+    // clang-format on
+
+    insertQuery.bind(1, int64_t(id));
+    insertQuery.bind(2, urlTemplate);
+    insertQuery.bindBlob(3, dictionary.data(), dictionary.size(), false);
+    insertQuery.run();
+    if (insertQuery.changes() == 0) {
+        // Another dictionary has the same checksum; tiles can't tell them apart.
+        untrainedTilesets.insert(urlTemplate);
+        return nullptr;
+    }
+
+    auto& stored = dictionaries[id];
+    stored = std::make_shared<const std::string>(std::move(dictionary));
+    return stored.get();
+}
+
+std::shared_ptr<const std::string> OfflineDatabase::getDictionary(uint32_t id) {
+    auto it = dictionaries.find(id);
+    if (it != dictionaries.end()) {
+        return it->second;
+    }
+
+    mapbox::sqlite::Query query{ getStatement("SELECT data FROM dictionaries WHERE id = ?1") };
+    query.bind(1, int64_t(id));
+    if (!query.run()) {
+        throw std::runtime_error("missing compression dictionary");
+    }
+    return dictionaries.emplace(id, std::make_shared<const std::string>(query.get<std::string>(0))).first->second;
+}
 
+optional<std::pair<CompressedResponse, uint64_t>> OfflineDatabase::getResource(const Resource& resource) {
     // clang-format off
     mapbox::sqlite::Query query{ getStatement(
         //        0      1            2            3       4      5
@@ -361,13 +795,14 @@ optional<std::pair<Response, uint64_t>> OfflineDatabase::getResource(const Resou
         "WHERE url = ?") };
     // clang-format on
 
-    query.bind(1, resource.url);
+    query.bind(1, resource.url, false);
 
     if (!query.run()) {
         return nullopt;
     }
 
-    Response response;
+    CompressedResponse result;
+    Response& response = result.response;
     uint64_t size = 0;
 
     response.etag           = query.get<optional<std::string>>(0);
@@ -378,20 +813,18 @@ optional<std::pair<Response, uint64_t>> OfflineDatabase::getResource(const Resou
     auto data = query.get<optional<std::string>>(4);
     if (!data) {
         response.noContent = true;
-    } else if (query.get<bool>(5)) {
-        response.data = std::make_shared<std::string>(util::decompress(*data));
-        size = data->length();
     } else {
-        response.data = std::make_shared<std::string>(*data);
+        result.compressed = query.get<bool>(5);
         size = data->length();
+        response.data = std::make_shared<std::string>(std::move(*data));
     }
 
-    return std::make_pair(response, size);
+    return std::make_pair(std::move(result), size);
 }
 
 optional<int64_t> OfflineDatabase::hasResource(const Resource& resource) {
     mapbox::sqlite::Query query{ getStatement("SELECT length(data) FROM resources WHERE url = ?") };
-    query.bind(1, resource.url);
+    query.bind(1, resource.url, false);
     if (!query.run()) {
         return nullopt;
     }
@@ -402,7 +835,7 @@ optional<int64_t> OfflineDatabase::hasResource(const Resource& resource) {
 bool OfflineDatabase::putResource(const Resource& resource,
                                   const Response& response,
                                   const std::string& data,
-                                  bool compressed) {
+                                  Compression compression) {
     checkFlags();
 
     if (response.notModified) {
@@ -418,7 +851,7 @@ bool OfflineDatabase::putResource(const Resource& resource,
         notModifiedQuery.bind(1, util::now());
         notModifiedQuery.bind(2, response.expires);
         notModifiedQuery.bind(3, response.mustRevalidate);
-        notModifiedQuery.bind(4, resource.url);
+        notModifiedQuery.bind(4, resource.url, false);
         notModifiedQuery.run();
         return false;
     }
@@ -444,14 +877,14 @@ bool OfflineDatabase::putResource(const Resource& resource,
     updateQuery.bind(4, response.mustRevalidate);
     updateQuery.bind(5, response.modified);
     updateQuery.bind(6, util::now());
-    updateQuery.bind(9, resource.url);
+    updateQuery.bind(9, resource.url, false);
 
     if (response.noContent) {
         updateQuery.bind(7, nullptr);
         updateQuery.bind(8, false);
     } else {
         updateQuery.bindBlob(7, data.data(), data.size(), false);
-        updateQuery.bind(8, compressed);
+        updateQuery.bind(8, uint8_t(compression));
     }
 
     updateQuery.run();
@@ -465,7 +898,7 @@ bool OfflineDatabase::putResource(const Resource& resource,
         "VALUES                (?1,  ?2,   ?3,   ?4,      ?5,              ?6,       ?7,       ?8,   ?9) ") };
     // clang-format on
 
-    insertQuery.bind(1, resource.url);
+    insertQuery.bind(1, resource.url, false);
     insertQuery.bind(2, int(resource.kind));
     insertQuery.bind(3, response.etag);
     insertQuery.bind(4, response.expires);
@@ -478,7 +911,7 @@ bool OfflineDatabase::putResource(const Resource& resource,
         insertQuery.bind(9, false);
     } else {
         insertQuery.bindBlob(8, data.data(), data.size(), false);
-        insertQuery.bind(9, compressed);
+        insertQuery.bind(9, uint8_t(compression));
     }
 
     insertQuery.run();
@@ -486,51 +919,21 @@ bool OfflineDatabase::putResource(const Resource& resource,
     return true;
 }
 
-optional<std::pair<Response, uint64_t>> OfflineDatabase::getTile(const Resource::TileData& tile) {
-    // Update accessed timestamp used for LRU eviction.
-    if (!readOnly) {
-        try {
-            // clang-format off
-            mapbox::sqlite::Query accessedQuery{ getStatement(
-                "UPDATE tiles "
-                "SET accessed       = ?1 "
-                "WHERE url_template = ?2 "
-                "  AND pixel_ratio  = ?3 "
-                "  AND x            = ?4 "
-                "  AND y            = ?5 "
-                "  AND z            = ?6 ") };
-            // clang-format on
-
-            accessedQuery.bind(1, util::now());
-            accessedQuery.bind(2, tile.urlTemplate);
-            accessedQuery.bind(3, tile.pixelRatio);
-            accessedQuery.bind(4, tile.x);
-            accessedQuery.bind(5, tile.y);
-            accessedQuery.bind(6, tile.z);
-            accessedQuery.run();
-        } catch (const mapbox::sqlite::Exception& ex) {
-            if (ex.code == mapbox::sqlite::ResultCode::NotADB || ex.code == mapbox::sqlite::ResultCode::Corrupt) {
-                throw;
-            }
-
-            // If we don't have any indication that the database is corrupt, continue as usual.
-            Log::Warning(Event::Database, static_cast<int>(ex.code), "Can't update timestamp: %s", ex.what());
-        }
-    }
-
+optional<std::pair<CompressedResponse, uint64_t>> OfflineDatabase::getTile(const Resource::TileData& tile) {
     // clang-format off
     mapbox::sqlite::Query query{ getStatement(
-        //        0      1           2,            3,      4,      5
-        "SELECT etag, expires, must_revalidate, modified, data, compressed "
-        "FROM tiles "
-        "WHERE url_template = ?1 "
-        "  AND pixel_ratio  = ?2 "
-        "  AND x            = ?3 "
-        "  AND y            = ?4 "
-        "  AND z            = ?5 ") };
+        //          0          1             2,              3,                  4,                5
+        "SELECT t.etag, t.expires, t.must_revalidate, t.modified, IFNULL(t.data, d.data), t.compressed "
+        "FROM tiles t "
+        "LEFT JOIN tile_data d ON d.id = t.data_id "
+        "WHERE t.url_template = ?1 "
+        "  AND t.pixel_ratio  = ?2 "
+        "  AND t.x            = ?3 "
+        "  AND t.y            = ?4 "
+        "  AND t.z            = ?5 ") };
     // clang-format on
 
-    query.bind(1, tile.urlTemplate);
+    query.bind(1, tile.urlTemplate, false);
     query.bind(2, tile.pixelRatio);
     query.bind(3, tile.x);
     query.bind(4, tile.y);
@@ -540,7 +943,8 @@ optional<std::pair<Response, uint64_t>> OfflineDatabase::getTile(const Resource:
         return nullopt;
     }
 
-    Response response;
+    CompressedResponse result;
+    Response& response = result.response;
     uint64_t size = 0;
 
     response.etag            = query.get<optional<std::string>>(0);
@@ -551,30 +955,33 @@ optional<std::pair<Response, uint64_t>> OfflineDatabase::getTile(const Resource:
     optional<std::string> data = query.get<optional<std::string>>(4);
     if (!data) {
         response.noContent = true;
-    } else if (query.get<bool>(5)) {
-        response.data = std::make_shared<std::string>(util::decompress(*data));
-        size = data->length();
     } else {
-        response.data = std::make_shared<std::string>(*data);
+        const auto compression = Compression(query.get<int>(5));
+        result.compressed = compression != Compression::None;
+        if (compression == Compression::DeflateWithDictionary) {
+            result.dictionary = getDictionary(util::compressedDictionaryID(*data));
+        }
         size = data->length();
+        response.data = std::make_shared<std::string>(std::move(*data));
     }
 
-    return std::make_pair(response, size);
+    return std::make_pair(std::move(result), size);
 }
 
 optional<int64_t> OfflineDatabase::hasTile(const Resource::TileData& tile) {
     // clang-format off
     mapbox::sqlite::Query size{ getStatement(
-        "SELECT length(data) "
-        "FROM tiles "
-        "WHERE url_template = ?1 "
-        "  AND pixel_ratio  = ?2 "
-        "  AND x            = ?3 "
-        "  AND y            = ?4 "
-        "  AND z            = ?5 ") };
+        "SELECT IFNULL(length(t.data), length(d.data)) "
+        "FROM tiles t "
+        "LEFT JOIN tile_data d ON d.id = t.data_id "
+        "WHERE t.url_template = ?1 "
+        "  AND t.pixel_ratio  = ?2 "
+        "  AND t.x            = ?3 "
+        "  AND t.y            = ?4 "
+        "  AND t.z            = ?5 ") };
     // clang-format on
 
-    size.bind(1, tile.urlTemplate);
+    size.bind(1, tile.urlTemplate, false);
     size.bind(2, tile.pixelRatio);
     size.bind(3, tile.x);
     size.bind(4, tile.y);
@@ -590,7 +997,7 @@ optional<int64_t> OfflineDatabase::hasTile(const Resource::TileData& tile) {
 bool OfflineDatabase::putTile(const Resource::TileData& tile,
                               const Response& response,
                               const std::string& data,
-                              bool compressed) {
+                              Compression compression) {
     checkFlags();
 
     if (response.notModified) {
@@ -610,7 +1017,7 @@ bool OfflineDatabase::putTile(const Resource::TileData& tile,
         notModifiedQuery.bind(1, util::now());
         notModifiedQuery.bind(2, response.expires);
         notModifiedQuery.bind(3, response.mustRevalidate);
-        notModifiedQuery.bind(4, tile.urlTemplate);
+        notModifiedQuery.bind(4, tile.urlTemplate, false);
         notModifiedQuery.bind(5, tile.pixelRatio);
         notModifiedQuery.bind(6, tile.x);
         notModifiedQuery.bind(7, tile.y);
@@ -619,6 +1026,9 @@ bool OfflineDatabase::putTile(const Resource::TileData& tile,
         return false;
     }
 
+    // Tiles with the same bytes share them.
+    const int64_t dataID = response.noContent ? 0 : putTileData(data);
+
     // We can't use REPLACE because it would change the id value.
 
     // clang-format off
@@ -629,7 +1039,8 @@ bool OfflineDatabase::putTile(const Resource::TileData& tile,
         "    expires         = ?3, "
         "    must_revalidate = ?4, "
         "    accessed        = ?5, "
-        "    data            = ?6, "
+        "    data            = NULL, "
+        "    data_id         = ?6, "
         "    compressed      = ?7 "
         "WHERE url_template  = ?8 "
         "  AND pixel_ratio   = ?9 "
@@ -643,7 +1054,7 @@ bool OfflineDatabase::putTile(const Resource::TileData& tile,
     updateQuery.bind(3, response.expires);
     updateQuery.bind(4, response.mustRevalidate);
     updateQuery.bind(5, util::now());
-    updateQuery.bind(8, tile.urlTemplate);
+    updateQuery.bind(8, tile.urlTemplate, false);
     updateQuery.bind(9, tile.pixelRatio);
     updateQuery.bind(10, tile.x);
     updateQuery.bind(11, tile.y);
@@ -653,8 +1064,8 @@ bool OfflineDatabase::putTile(const Resource::TileData& tile,
         updateQuery.bind(6, nullptr);
         updateQuery.bind(7, false);
     } else {
-        updateQuery.bindBlob(6, data.data(), data.size(), false);
-        updateQuery.bind(7, compressed);
+        updateQuery.bind(6, dataID);
+        updateQuery.bind(7, uint8_t(compression));
     }
 
     updateQuery.run();
@@ -664,11 +1075,11 @@ bool OfflineDatabase::putTile(const Resource::TileData& tile,
 
     // clang-format off
     mapbox::sqlite::Query insertQuery{ getStatement(
-        "INSERT INTO tiles (url_template, pixel_ratio, x,  y,  z,  modified, must_revalidate, etag, expires, accessed,  data, compressed) "
-        "VALUES            (?1,           ?2,          ?3, ?4, ?5, ?6,       ?7,              ?8,   ?9,      ?10,       ?11,  ?12)") };
+        "INSERT INTO tiles (url_template, pixel_ratio, x,  y,  z,  modified, must_revalidate, etag, expires, accessed,  data_id, compressed) "
+        "VALUES            (?1,           ?2,          ?3, ?4, ?5, ?6,       ?7,              ?8,   ?9,      ?10,       ?11,     ?12)") };
     // clang-format on
 
-    insertQuery.bind(1, tile.urlTemplate);
+    insertQuery.bind(1, tile.urlTemplate, false);
     insertQuery.bind(2, tile.pixelRatio);
     insertQuery.bind(3, tile.x);
     insertQuery.bind(4, tile.y);
@@ -683,8 +1094,8 @@ bool OfflineDatabase::putTile(const Resource::TileData& tile,
         insertQuery.bind(11, nullptr);
         insertQuery.bind(12, false);
     } else {
-        insertQuery.bindBlob(11, data.data(), data.size(), false);
-        insertQuery.bind(12, compressed);
+        insertQuery.bind(11, dataID);
+        insertQuery.bind(12, uint8_t(compression));
     }
 
     insertQuery.run();
@@ -692,8 +1103,35 @@ bool OfflineDatabase::putTile(const Resource::TileData& tile,
     return true;
 }
 
+int64_t OfflineDatabase::putTileData(const std::string& data) {
+    const uint32_t checksum = util::checksum(data);
+
+    // clang-format off
+    mapbox::sqlite::Query selectQuery{ getStatement(
+        "SELECT id FROM tile_data WHERE checksum = ?1 AND data = ?2") };
+    // clang-format on
+
+    selectQuery.bind(1, checksum);
+    selectQuery.bindBlob(2, data.data(), data.size(), false);
+    if (selectQuery.run()) {
+        return selectQuery.get<int64_t>(0);
+    }
+
+    // The tile that refers to the data counts the reference, see the tiles_data_* triggers.
+    // clang-format off
+    mapbox::sqlite::Query insertQuery{ getStatement(
+        "INSERT INTO tile_data (checksum, data, refs) VALUES (?1, ?2, 0)") };
+    // clang-format on
+
+    insertQuery.bind(1, checksum);
+    insertQuery.bindBlob(2, data.data(), data.size(), false);
+    insertQuery.run();
+    return insertQuery.lastInsertRowId();
+}
+
 std::exception_ptr OfflineDatabase::invalidateAmbientCache() try {
     checkFlags();
+    commitPendingWrites();
 
     // clang-format off
     mapbox::sqlite::Query tileQuery{ getStatement(
@@ -727,6 +1165,7 @@ std::exception_ptr OfflineDatabase::invalidateAmbientCache() try {
 
 std::exception_ptr OfflineDatabase::clearAmbientCache() try {
     checkFlags();
+    commitPendingWrites();
 
     // clang-format off
     mapbox::sqlite::Query tileQuery{ getStatement(
@@ -750,6 +1189,10 @@ std::exception_ptr OfflineDatabase::clearAmbientCache() try {
 
     resourceQuery.run();
 
+    currentAmbientCacheSize = 0;
+    evictionCursor = {};
+    storeAmbientCacheSize();
+
     if (autopack) vacuum();
 
     return nullptr;
@@ -760,6 +1203,7 @@ std::exception_ptr OfflineDatabase::clearAmbientCache() try {
 
 std::exception_ptr OfflineDatabase::invalidateRegion(int64_t regionID) try {
     checkFlags();
+    commitPendingWrites();
 
     {
         // clang-format off
@@ -824,6 +1268,7 @@ expected<OfflineRegion, std::exception_ptr>
 OfflineDatabase::createRegion(const OfflineRegionDefinition& definition,
                               const OfflineRegionMetadata& metadata) try {
     checkFlags();
+    commitPendingWrites();
 
     // clang-format off
     mapbox::sqlite::Query query{ getStatement(
@@ -842,9 +1287,32 @@ OfflineDatabase::createRegion(const OfflineRegionDefinition& definition,
 
 expected<OfflineRegions, std::exception_ptr>
 OfflineDatabase::mergeDatabase(const std::string& sideDatabasePath) {
+    if (std::exception_ptr error = beginMerge(sideDatabasePath)) {
+        return unexpected<std::exception_ptr>(error);
+    }
+
+    expected<bool, std::exception_ptr> more;
+    do {
+        more = mergeNextChunk();
+        if (!more) {
+            return unexpected<std::exception_ptr>(more.error());
+        }
+    } while (*more);
+
+    return finishMerge();
+}
+
+std::exception_ptr OfflineDatabase::beginMerge(const std::string& sideDatabasePath) {
     checkFlags();
 
+    if (merge) {
+        Log::Error(Event::Database, "Can't merge database (%s): another merge is in progress", sideDatabasePath.c_str());
+        return std::make_exception_ptr(std::runtime_error("Another merge is in progress"));
+    }
+
     try {
+        commitPendingWrites();
+
         // clang-format off
         mapbox::sqlite::Query query{ getStatement("ATTACH DATABASE ?1 AS side") };
         // clang-format on
@@ -853,18 +1321,37 @@ OfflineDatabase::mergeDatabase(const std::string& sideDatabasePath) {
         query.run();
     } catch (const mapbox::sqlite::Exception& ex) {
         Log::Error(Event::Database, static_cast<int>(ex.code), "Can't attach database (%s) for merge: %s", sideDatabasePath.c_str(), ex.what());
-        return unexpected<std::exception_ptr>(std::current_exception());
+        return std::current_exception();
     }
     try {
-        // Support sideloaded databases at user_version = 6. Future schema version
-        // changes will need to implement migration paths for sideloaded databases at
-        // version 6.
+        // Support sideloaded databases at user_version = 6 to 10. Version 7 only added
+        // compression dictionaries, which tiles refer to by checksum, so its tiles can be
+        // copied as they are along with the dictionaries. Version 8 only added ambient
+        // cache bookkeeping and version 9 download checkpoints, which aren't merged. Version
+        // 10 shares tile data, which the side_tiles view below looks up. Future schema version changes will need
+        // to implement migration paths for sideloaded databases at version 6.
         auto sideUserVersion = static_cast<int>(getPragma<int64_t>("PRAGMA side.user_version"));
         const auto mainUserVersion = getPragma<int64_t>("PRAGMA user_version");
-        if (sideUserVersion < 6 || sideUserVersion != mainUserVersion) {
+        if (sideUserVersion < 6 || sideUserVersion > mainUserVersion) {
             throw std::runtime_error("Merge database has incorrect user_version");
         }
 
+        if (sideUserVersion >= 7) {
+            // clang-format off
+            mapbox::sqlite::Query queryDictionaries{ getStatement(
+                "SELECT COUNT(*) "
+                "FROM side.dictionaries sd "
+                "JOIN dictionaries d ON sd.id = d.id "
+                "WHERE sd.data <> d.data") };
+            // clang-format on
+            queryDictionaries.run();
+            const auto conflicts = queryDictionaries.get<int64_t>(0);
+            queryDictionaries.reset();
+            if (conflicts > 0) {
+                throw std::runtime_error("Merge database has conflicting compression dictionaries");
+            }
+        }
+
         auto currentTileCount = getOfflineMapboxTileCount();
         // clang-format off
          mapbox::sqlite::Query queryTiles{ getStatement(
@@ -888,9 +1375,198 @@ OfflineDatabase::mergeDatabase(const std::string& sideDatabasePath) {
         queryTiles.reset();
 
         mapbox::sqlite::Transaction transaction(*db);
-        db->exec(mergeSideloadedDatabaseSQL);
+        if (sideUserVersion >= 7) {
+            db->exec(
+                "INSERT OR IGNORE INTO dictionaries (id, url_template, data) "
+                "SELECT id, url_template, data FROM side.dictionaries");
+        }
+        // clang-format off
+        db->exec(
+            "INSERT INTO regions "
+            "SELECT DISTINCT NULL, sr.definition, sr.description "
+            "FROM side.regions sr "
+            "LEFT JOIN regions r ON sr.definition = r.definition AND sr.description IS r.description "
+            "WHERE r.definition IS NULL;"
+            "CREATE TEMPORARY TABLE region_mapping AS "
+            "SELECT sr.id AS side_region_id, r.id AS main_region_id "
+            "FROM side.regions sr "
+            "JOIN regions r ON sr.definition = r.definition AND sr.description IS r.description");
+        // The tiles of both databases with their data, whether it is shared or not.
+        db->exec(sideUserVersion >= 10
+            ? "CREATE TEMPORARY VIEW side_tiles AS "
+              "SELECT st.id, st.url_template, st.pixel_ratio, st.z, st.x, st.y, "
+                  "st.expires, st.modified, st.etag, IFNULL(st.data, sd.data) AS data, "
+                  "st.compressed, st.accessed, st.must_revalidate "
+              "FROM side.tiles st "
+              "LEFT JOIN side.tile_data sd ON sd.id = st.data_id"
+            : "CREATE TEMPORARY VIEW side_tiles AS "
+              "SELECT * FROM side.tiles");
+        db->exec(
+            "CREATE TEMPORARY VIEW main_tiles AS "
+            "SELECT t.id, t.url_template, t.pixel_ratio, t.z, t.x, t.y, "
+                "t.modified, IFNULL(t.data, d.data) AS data, t.compressed "
+            "FROM main.tiles t "
+            "LEFT JOIN main.tile_data d ON d.id = t.data_id");
+        // clang-format on
         transaction.commit();
 
+        // clang-format off
+        mapbox::sqlite::Query queryTotal{ getStatement(
+            "SELECT (SELECT COUNT(DISTINCT tile_id) FROM side.region_tiles), "
+                "(SELECT COUNT(DISTINCT resource_id) FROM side.region_resources)") };
+        // clang-format on
+        queryTotal.run();
+        merge.emplace();
+        merge->total = queryTotal.get<int64_t>(0) + queryTotal.get<int64_t>(1);
+        return nullptr;
+    } catch (const std::runtime_error& ex) {
+        detachMerge();
+        Log::Error(Event::Database, "%s", ex.what());
+
+        return std::current_exception();
+    }
+}
+
+expected<bool, std::exception_ptr> OfflineDatabase::mergeNextChunk() {
+    if (!merge) {
+        Log::Error(Event::Database, "Can't merge database: the merge was interrupted");
+        return unexpected<std::exception_ptr>(std::make_exception_ptr(std::runtime_error("No merge in progress")));
+    }
+
+    try {
+        commitPendingWrites();
+
+        const bool tiles = !merge->tilesMerged;
+        int64_t& lastID = tiles ? merge->lastTileID : merge->lastResourceID;
+
+        // Chunks go by the ids of the side tiles or resources that belong to a region.
+        // clang-format off
+        mapbox::sqlite::Query queryChunk{ getStatement(tiles
+            ? "SELECT COUNT(*), MAX(tile_id) "
+              "FROM (SELECT DISTINCT tile_id FROM side.region_tiles "
+                    "WHERE tile_id > ?1 ORDER BY tile_id LIMIT ?2)"
+            : "SELECT COUNT(*), MAX(resource_id) "
+              "FROM (SELECT DISTINCT resource_id FROM side.region_resources "
+                    "WHERE resource_id > ?1 ORDER BY resource_id LIMIT ?2)") };
+        // clang-format on
+        queryChunk.bind(1, lastID);
+        queryChunk.bind(2, mergeChunkSize);
+        queryChunk.run();
+        const auto count = queryChunk.get<int64_t>(0);
+        const auto chunkLastID = count ? queryChunk.get<int64_t>(1) : lastID;
+        queryChunk.reset();
+
+        if (count) {
+            mapbox::sqlite::Transaction transaction(*db);
+            // The tiles and resources with the same data only get newer metadata, instead of
+            // having their data rewritten. The rest is copied only if it is missing or newer.
+            // clang-format off
+            const std::array<const char*, 3> chunkStatements = tiles ? std::array<const char*, 3>{{
+                "UPDATE tiles "
+                "SET (expires, modified, etag, accessed, must_revalidate) = ("
+                    "SELECT st.expires, st.modified, st.etag, st.accessed, st.must_revalidate "
+                    "FROM side.tiles st "
+                    "WHERE st.url_template = tiles.url_template AND st.pixel_ratio = tiles.pixel_ratio AND "
+                        "st.z = tiles.z AND st.x = tiles.x AND st.y = tiles.y) "
+                "WHERE id IN ("
+                    "SELECT t.id "
+                    "FROM side_tiles st "
+                    "JOIN main_tiles t ON st.url_template = t.url_template AND st.pixel_ratio = t.pixel_ratio AND "
+                        "st.z = t.z AND st.x = t.x AND st.y = t.y "
+                    "WHERE st.id > ?1 AND st.id <= ?2 "
+                    "AND st.id IN (SELECT tile_id FROM side.region_tiles) "
+                    "AND st.modified > t.modified "
+                    "AND st.compressed IS t.compressed "
+                    "AND length(st.data) = length(t.data) AND st.data = t.data)",
+                "REPLACE INTO tiles (id, url_template, pixel_ratio, z, x, y, "
+                    "expires, modified, etag, data, compressed, accessed, must_revalidate) "
+                "SELECT t.id, "
+                    "st.url_template, st.pixel_ratio, st.z, st.x, st.y, "
+                    "st.expires, st.modified, st.etag, st.data, st.compressed, st.accessed, st.must_revalidate "
+                "FROM side_tiles st "
+                "LEFT JOIN tiles t ON st.url_template = t.url_template AND st.pixel_ratio = t.pixel_ratio AND "
+                    "st.z = t.z AND st.x = t.x AND st.y = t.y "
+                "WHERE st.id > ?1 AND st.id <= ?2 "
+                "AND st.id IN (SELECT tile_id FROM side.region_tiles) "
+                "AND (t.id IS NULL OR st.modified > t.modified)",
+                "INSERT OR IGNORE INTO region_tiles "
+                "SELECT rm.main_region_id, t.id "
+                "FROM side.region_tiles srt "
+                "JOIN region_mapping rm ON srt.region_id = rm.side_region_id "
+                "JOIN side.tiles st ON srt.tile_id = st.id "
+                "JOIN tiles t ON st.url_template = t.url_template AND st.pixel_ratio = t.pixel_ratio AND "
+                    "st.z = t.z AND st.x = t.x AND st.y = t.y "
+                "WHERE srt.tile_id > ?1 AND srt.tile_id <= ?2"
+            }} : std::array<const char*, 3>{{
+                "UPDATE resources "
+                "SET (kind, expires, modified, etag, accessed, must_revalidate) = ("
+                    "SELECT sr.kind, sr.expires, sr.modified, sr.etag, sr.accessed, sr.must_revalidate "
+                    "FROM side.resources sr "
+                    "WHERE sr.url = resources.url) "
+                "WHERE id IN ("
+                    "SELECT r.id "
+                    "FROM side.resources sr "
+                    "JOIN resources r ON sr.url = r.url "
+                    "WHERE sr.id > ?1 AND sr.id <= ?2 "
+                    "AND sr.id IN (SELECT resource_id FROM side.region_resources) "
+                    "AND sr.modified > r.modified "
+                    "AND sr.compressed IS r.compressed "
+                    "AND length(sr.data) = length(r.data) AND sr.data = r.data)",
+                "REPLACE INTO resources "
+                "SELECT r.id, "
+                    "sr.url, sr.kind, sr.expires, sr.modified, sr.etag, "
+                    "sr.data, sr.compressed, sr.accessed, sr.must_revalidate "
+                "FROM side.resources sr "
+                "LEFT JOIN resources r ON sr.url = r.url "
+                "WHERE sr.id > ?1 AND sr.id <= ?2 "
+                "AND sr.id IN (SELECT resource_id FROM side.region_resources) "
+                "AND (r.id IS NULL OR sr.modified > r.modified)",
+                "INSERT OR IGNORE INTO region_resources "
+                "SELECT rm.main_region_id, r.id "
+                "FROM side.region_resources srr "
+                "JOIN region_mapping rm ON srr.region_id = rm.side_region_id "
+                "JOIN side.resources sr ON srr.resource_id = sr.id "
+                "JOIN resources r ON sr.url = r.url "
+                "WHERE srr.resource_id > ?1 AND srr.resource_id <= ?2"
+            }};
+            // clang-format on
+            for (const char* sql : chunkStatements) {
+                mapbox::sqlite::Query query{ getStatement(sql) };
+                query.bind(1, lastID);
+                query.bind(2, chunkLastID);
+                query.run();
+            }
+            transaction.commit();
+
+            if (tiles) {
+                offlineMapboxTileCount = nullopt;
+            }
+            lastID = chunkLastID;
+            merge->completed += count;
+        }
+
+        if (count < mergeChunkSize) {
+            if (!tiles) {
+                return false;
+            }
+            merge->tilesMerged = true;
+        }
+        return true;
+    } catch (const std::runtime_error& ex) {
+        detachMerge();
+        Log::Error(Event::Database, "%s", ex.what());
+
+        return unexpected<std::exception_ptr>(std::current_exception());
+    }
+}
+
+expected<OfflineRegions, std::exception_ptr> OfflineDatabase::finishMerge() {
+    if (!merge) {
+        Log::Error(Event::Database, "Can't merge database: the merge was interrupted");
+        return unexpected<std::exception_ptr>(std::make_exception_ptr(std::runtime_error("No merge in progress")));
+    }
+
+    try {
         // clang-format off
         mapbox::sqlite::Query queryRegions{ getStatement(
             "SELECT DISTINCT r.id, r.definition, r.description "
@@ -906,21 +1582,34 @@ OfflineDatabase::mergeDatabase(const std::string& sideDatabasePath) {
                 queryRegions.get<std::vector<uint8_t>>(2));
             result.emplace_back(std::move(region));
         }
-        db->exec("DETACH DATABASE side");
+        queryRegions.reset();
+        detachMerge();
         // Explicit move to avoid triggering the copy constructor.
         return { std::move(result) };
     } catch (const std::runtime_error& ex) {
-        db->exec("DETACH DATABASE side");
+        detachMerge();
         Log::Error(Event::Database, "%s", ex.what());
 
         return unexpected<std::exception_ptr>(std::current_exception());
     }
-    return {};
+}
+
+std::pair<uint64_t, uint64_t> OfflineDatabase::getMergeProgress() const {
+    return merge ? std::make_pair(merge->completed, merge->total) : std::make_pair(uint64_t(0), uint64_t(0));
+}
+
+void OfflineDatabase::detachMerge() {
+    merge = nullopt;
+    db->exec("DROP TABLE IF EXISTS temp.region_mapping");
+    db->exec("DROP VIEW IF EXISTS temp.side_tiles");
+    db->exec("DROP VIEW IF EXISTS temp.main_tiles");
+    db->exec("DETACH DATABASE side");
 }
 
 expected<OfflineRegionMetadata, std::exception_ptr>
 OfflineDatabase::updateMetadata(const int64_t regionID, const OfflineRegionMetadata& metadata) try {
     checkFlags();
+    commitPendingWrites();
 
     // clang-format off
     mapbox::sqlite::Query query{ getStatement(
@@ -939,6 +1628,7 @@ OfflineDatabase::updateMetadata(const int64_t regionID, const OfflineRegionMetad
 
 std::exception_ptr OfflineDatabase::deleteRegion(OfflineRegion&& region) try {
     checkFlags();
+    commitPendingWrites();
 
     {
         mapbox::sqlite::Query query{ getStatement("DELETE FROM regions WHERE id = ?") };
@@ -946,6 +1636,9 @@ std::exception_ptr OfflineDatabase::deleteRegion(OfflineRegion&& region) try {
         query.run();
     }
 
+    // The entries of the region are ambient now, and may be older than the cursor.
+    initAmbientCacheSize();
+    evictionCursor = {};
     DatabaseSizeChangeStats stats(this);
     evict(0, stats);
     assert(db);
@@ -982,6 +1675,7 @@ uint64_t OfflineDatabase::putRegionResource(int64_t regionID,
     if (!db) {
         initialize();
     }
+    commitPendingWrites();
     mapbox::sqlite::Transaction transaction(*db);
     auto size = putRegionResourceInternal(regionID, resource, response);
     transaction.commit();
@@ -999,6 +1693,7 @@ void OfflineDatabase::putRegionResources(int64_t regionID,
     if (!db) {
         initialize();
     }
+    commitPendingWrites();
     mapbox::sqlite::Transaction transaction(*db);
 
     // Accumulate all statistics locally first before adding them to the OfflineRegionStatus object
@@ -1169,6 +1864,73 @@ expected<OfflineRegionStatus, std::exception_ptr> OfflineDatabase::getRegionComp
     return unexpected<std::exception_ptr>(std::current_exception());
 }
 
+optional<OfflineRegionCheckpoint> OfflineDatabase::getRegionCheckpoint(int64_t regionID,
+                                                                       const std::string& urlTemplate) try {
+    if (!db) {
+        initialize();
+    }
+    // clang-format off
+    mapbox::sqlite::Query query{ getStatement(
+        "SELECT tile_count, tiles, completed_tiles, completed_size "
+        "FROM region_checkpoints "
+        "WHERE region_id = ?1 "
+        "AND url_template = ?2") };
+    // clang-format on
+    query.bind(1, regionID);
+    query.bind(2, urlTemplate);
+    if (!query.run()) {
+        return nullopt;
+    }
+
+    OfflineRegionCheckpoint checkpoint;
+    checkpoint.urlTemplate = urlTemplate;
+    checkpoint.tileCount = query.get<int64_t>(0);
+    checkpoint.tiles = query.get<int64_t>(1);
+    checkpoint.completedTiles = query.get<int64_t>(2);
+    checkpoint.completedSize = query.get<int64_t>(3);
+    return checkpoint;
+} catch (...) {
+    handleError("read region checkpoint");
+    return nullopt;
+}
+
+void OfflineDatabase::putRegionCheckpoint(int64_t regionID, const OfflineRegionCheckpoint& checkpoint) try {
+    checkFlags();
+
+    if (!db) {
+        initialize();
+    }
+    commitPendingWrites();
+    // clang-format off
+    mapbox::sqlite::Query query{ getStatement(
+        "REPLACE INTO region_checkpoints (region_id, url_template, tile_count, tiles, completed_tiles, completed_size) "
+        "VALUES (?1, ?2, ?3, ?4, ?5, ?6)") };
+    // clang-format on
+    query.bind(1, regionID);
+    query.bind(2, checkpoint.urlTemplate);
+    query.bind(3, static_cast<int64_t>(checkpoint.tileCount));
+    query.bind(4, static_cast<int64_t>(checkpoint.tiles));
+    query.bind(5, static_cast<int64_t>(checkpoint.completedTiles));
+    query.bind(6, static_cast<int64_t>(checkpoint.completedSize));
+    query.run();
+} catch (...) {
+    handleError("write region checkpoint");
+}
+
+void OfflineDatabase::deleteRegionCheckpoints(int64_t regionID) try {
+    checkFlags();
+
+    if (!db) {
+        initialize();
+    }
+    commitPendingWrites();
+    mapbox::sqlite::Query query{getStatement("DELETE FROM region_checkpoints WHERE region_id = ?1")};
+    query.bind(1, regionID);
+    query.run();
+} catch (...) {
+    handleError("delete region checkpoints");
+}
+
 std::pair<int64_t, int64_t> OfflineDatabase::getCompletedResourceCountAndSize(int64_t regionID) {
     // clang-format off
     mapbox::sqlite::Query query{ getStatement(
@@ -1185,10 +1947,11 @@ std::pair<int64_t, int64_t> OfflineDatabase::getCompletedResourceCountAndSize(in
 std::pair<int64_t, int64_t> OfflineDatabase::getCompletedTileCountAndSize(int64_t regionID) {
     // clang-format off
     mapbox::sqlite::Query query{ getStatement(
-        "SELECT COUNT(*), SUM(LENGTH(data)) "
-        "FROM region_tiles, tiles "
-        "WHERE region_id = ?1 "
-        "AND tile_id = tiles.id ") };
+        "SELECT COUNT(*), SUM(IFNULL(LENGTH(tiles.data), LENGTH(tile_data.data))) "
+        "FROM region_tiles "
+        "JOIN tiles ON tile_id = tiles.id "
+        "LEFT JOIN tile_data ON tile_data.id = tiles.data_id "
+        "WHERE region_id = ?1 ") };
     // clang-format on
     query.bind(1, regionID);
     query.run();
@@ -1212,37 +1975,59 @@ T OfflineDatabase::getPragma(const char* sql) {
 // and as it approaches to the hard limit (i.e. the actual file size) we
 // delete an arbitrary number of old cache entries. The free pages approach saves
 // us from calling VACUUM or keeping a running total, which can be costly.
-bool OfflineDatabase::evict(uint64_t neededFreeSize, DatabaseSizeChangeStats& stats) {
+bool OfflineDatabase::evict(uint64_t neededFreeSize, DatabaseSizeChangeStats& stats, bool incremental) {
     checkFlags();
     uint64_t ambientCacheSize =
         (initAmbientCacheSize() == nullptr) ? *currentAmbientCacheSize : maximumAmbientCacheSize;
     uint64_t newAmbientCacheSize = ambientCacheSize + neededFreeSize + stats.pageSize();
+    const auto started = Clock::now();
+    // Entries read recently must not look older than they are.
+    writePendingAccesses();
 
     while (newAmbientCacheSize > maximumAmbientCacheSize) {
+        if (incremental && Clock::now() - started > evictionTimeBudget) {
+            // The cache stays over its limit a little longer; the next writes evict the rest.
+            return true;
+        }
+
+        // Both tables are walked along their accessed index, starting at the cursor rather
+        // than at the region entries that are older than any ambient one.
         // clang-format off
-        mapbox::sqlite::Query accessedQuery{ getStatement(
-            "SELECT max(accessed) "
-            "FROM ( "
-            "    SELECT accessed "
-            "    FROM resources "
-            "    LEFT JOIN region_resources "
-            "    ON resource_id = resources.id "
-            "    WHERE resource_id IS NULL "
-            "  UNION ALL "
-            "    SELECT accessed "
-            "    FROM tiles "
-            "    LEFT JOIN region_tiles "
-            "    ON tile_id = tiles.id "
-            "    WHERE tile_id IS NULL "
-            "  ORDER BY accessed ASC LIMIT ?1 "
-            ") "
-        ) };
-        accessedQuery.bind(1, 50);
+        mapbox::sqlite::Query tileAccessedQuery{ getStatement(
+            "SELECT accessed "
+            "FROM tiles "
+            "LEFT JOIN region_tiles "
+            "ON tile_id = tiles.id "
+            "WHERE tile_id IS NULL "
+            "  AND accessed >= ?1 "
+            "ORDER BY accessed ASC LIMIT ?2") };
+        mapbox::sqlite::Query resourceAccessedQuery{ getStatement(
+            "SELECT accessed "
+            "FROM resources "
+            "LEFT JOIN region_resources "
+            "ON resource_id = resources.id "
+            "WHERE resource_id IS NULL "
+            "  AND accessed >= ?1 "
+            "ORDER BY accessed ASC LIMIT ?2") };
         // clang-format on
-        if (!accessedQuery.run()) {
-            return false;
+        std::vector<Timestamp> oldest;
+        for (auto* query : {&tileAccessedQuery, &resourceAccessedQuery}) {
+            query->bind(1, evictionCursor);
+            query->bind(2, evictionBatchSize);
+            while (query->run()) {
+                oldest.push_back(query->get<Timestamp>(0));
+            }
         }
-        Timestamp accessed = accessedQuery.get<Timestamp>(0);
+        if (oldest.empty()) {
+            if (evictionCursor == Timestamp{}) {
+                return false;
+            }
+            // Entries may have become ambient since, or the clock went back.
+            evictionCursor = {};
+            continue;
+        }
+        std::sort(oldest.begin(), oldest.end());
+        Timestamp accessed = oldest[std::min<std::size_t>(oldest.size(), evictionBatchSize) - 1];
 
         // clang-format off
         mapbox::sqlite::Query resourceQuery{ getStatement(
@@ -1274,6 +2059,9 @@ bool OfflineDatabase::evict(uint64_t neededFreeSize, DatabaseSizeChangeStats& st
         tileQuery.run();
         const uint64_t tileChanges = tileQuery.changes();
 
+        // No ambient entry older than the evicted ones is left.
+        evictionCursor = accessed;
+
         // Update current ambient cache size, based on how many bytes were released.
         newAmbientCacheSize = std::max<int64_t>(
             static_cast<int64_t>(newAmbientCacheSize) - static_cast<int64_t>(stats.bytesReleased()), 0u);
@@ -1291,12 +2079,20 @@ bool OfflineDatabase::evict(uint64_t neededFreeSize, DatabaseSizeChangeStats& st
 std::exception_ptr OfflineDatabase::initAmbientCacheSize() {
     if (!currentAmbientCacheSize) {
         try {
+            mapbox::sqlite::Query storedQuery{ getStatement("SELECT size, eviction_cursor FROM ambient_cache") };
+            if (storedQuery.run()) {
+                currentAmbientCacheSize = storedQuery.get<int64_t>(0);
+                evictionCursor = storedQuery.get<Timestamp>(1);
+                return nullptr;
+            }
+
             // clang-format off
             mapbox::sqlite::Query query{ getStatement(
             "SELECT SUM(data) "
             "FROM ( "
-            "    SELECT SUM(IFNULL(LENGTH(data), 0) "
-            "               + IFNULL(LENGTH(id), 0) "
+            "    SELECT SUM(IFNULL(LENGTH(tiles.data), 0) "
+            "               + IFNULL(LENGTH(tile_data.data), 0) "
+            "               + IFNULL(LENGTH(tiles.id), 0) "
             "               + IFNULL(LENGTH(url_template), 0) "
             "               + IFNULL(LENGTH(pixel_ratio), 0) "
             "               + IFNULL(LENGTH(x), 0) "
@@ -1310,6 +2106,8 @@ std::exception_ptr OfflineDatabase::initAmbientCacheSize() {
             "               + IFNULL(LENGTH(must_revalidate), 0) "
             "               ) as data "
             "    FROM tiles "
+            "    LEFT JOIN tile_data "
+            "    ON tile_data.id = tiles.data_id "
             "    LEFT JOIN region_tiles "
             "    ON tile_id = tiles.id "
             "    WHERE tile_id IS NULL "
@@ -1333,6 +2131,8 @@ std::exception_ptr OfflineDatabase::initAmbientCacheSize() {
             // clang-format on
             query.run();
             currentAmbientCacheSize = query.get<int64_t>(0);
+            evictionCursor = {};
+            storeAmbientCacheSize();
         } catch (const mapbox::sqlite::Exception& ex) {
             handleError(ex, "cannot get current ambient cache size");
             return std::current_exception();
@@ -1350,6 +2150,7 @@ std::exception_ptr OfflineDatabase::setMaximumAmbientCacheSize(uint64_t size) {
     }
 
     try {
+        commitPendingWrites();
         maximumAmbientCacheSize = size;
 
         if (*currentAmbientCacheSize > maximumAmbientCacheSize) {
@@ -1416,6 +2217,7 @@ void OfflineDatabase::markUsedResources(int64_t regionID, const std::list<Resour
     if (!db) {
         initialize();
     }
+    commitPendingWrites();
     mapbox::sqlite::Transaction transaction(*db);
     for (const auto& resource : resources) {
         markUsed(regionID, resource);
@@ -1427,6 +2229,7 @@ void OfflineDatabase::markUsedResources(int64_t regionID, const std::list<Resour
 
 std::exception_ptr OfflineDatabase::pack() try {
     if (!db) initialize();
+    commitPendingWrites();
     vacuum();
     return nullptr;
 } catch (...) {
@@ -1480,7 +2283,22 @@ void OfflineDatabase::updateAmbientCacheSize(DatabaseSizeChangeStats& stats) {
     assert(currentAmbientCacheSize);
     if (currentAmbientCacheSize) {
         *currentAmbientCacheSize = std::max<int64_t>(static_cast<int64_t>(*currentAmbientCacheSize) + stats.diff(), 0u);
+        storeAmbientCacheSize();
+    }
+}
+
+void OfflineDatabase::storeAmbientCacheSize() {
+    if (readOnly || !currentAmbientCacheSize) {
+        return;
     }
+    // clang-format off
+    mapbox::sqlite::Query query{ getStatement(
+        "REPLACE INTO ambient_cache (id, size, eviction_cursor) "
+        "VALUES                     (1,  ?1,   ?2)") };
+    // clang-format on
+    query.bind(1, int64_t(*currentAmbientCacheSize));
+    query.bind(2, evictionCursor);
+    query.run();
 }
 
 } // namespace mbgl
@@ -18,12 +18,15 @@
 #include <mbgl/util/tile_cover.hpp>
 #include <mbgl/util/tileset.hpp>
 
+#include <map>
 #include <set>
 
 namespace {
 
 const size_t kResourcesBatchSize = 64;
 const size_t kMarkBatchSize = 200;
+// Tiles are generated ahead of the requests up to this many queued resources.
+const size_t kTileQueueSize = 256;
 
 } // namespace
 
@@ -46,29 +49,6 @@ Range<uint8_t> coveringZoomRange(const RegionDefinition& definition,
     return { static_cast<uint8_t>(minZ), static_cast<uint8_t>(maxZ) };
 }
 
-template <class Geometry, class Fn>
-void tileCover(const Geometry& geometry, uint8_t z, Fn&& fn) {
-    util::TileCover cover(geometry, z);
-    while (cover.hasNext()) {
-        fn(cover.next()->canonical);
-    }
-}
-
-
-template <class Fn>
-void tileCover(const OfflineRegionDefinition& definition, style::SourceType type,
-               uint16_t tileSize, const Range<uint8_t>& zoomRange, Fn&& fn) {
-    const Range<uint8_t> clampedZoomRange =
-            definition.match([&](auto& reg) { return coveringZoomRange(reg, type, tileSize, zoomRange); });
-
-    for (uint8_t z = clampedZoomRange.min; z <= clampedZoomRange.max; z++) {
-        definition.match(
-                [&](const OfflineTilePyramidRegionDefinition& reg){ tileCover(reg.bounds, z, fn); },
-                [&](const OfflineGeometryRegionDefinition& reg){ tileCover(reg.geometry, z, fn); }
-        );
-    }
-}
-
 uint64_t tileCount(const OfflineRegionDefinition& definition, style::SourceType type,
                    uint16_t tileSize, const Range<uint8_t>& zoomRange) {
 
@@ -88,6 +68,67 @@ uint64_t tileCount(const OfflineRegionDefinition& definition, style::SourceType
 
 // OfflineDownload
 
+struct OfflineDownload::TileQueue {
+    std::string urlTemplate;
+    Tileset::Scheme scheme = Tileset::Scheme::XYZ;
+    Range<uint8_t> zoomRange{0, 0};
+    uint64_t tileCount = 0;
+
+    // The cover of zoom level `z`, which the next tile comes from. Bounds are walked in Z-order,
+    // which keeps the tiles that are downloaded together close to each other.
+    uint32_t z = 0;
+    std::unique_ptr<util::ZOrderTileCover> boundsCover;
+    std::unique_ptr<util::TileCover> geometryCover;
+    uint64_t generated = 0;
+
+    // The first `done` tiles are stored or skipped, `completedTiles` of them with `completedSize` bytes.
+    uint64_t done = 0;
+    uint64_t completedTiles = 0;
+    uint64_t completedSize = 0;
+    // Tiles past `done` that are finished, with their stored size or none when skipped.
+    std::map<uint64_t, optional<uint64_t>> finished;
+    bool changed = false;
+
+    optional<CanonicalTileID> next(const OfflineRegionDefinition& definition) {
+        while (z <= zoomRange.max) {
+            optional<UnwrappedTileID> tile = definition.match(
+                [&](const OfflineTilePyramidRegionDefinition& reg) {
+                    if (!boundsCover) {
+                        boundsCover = std::make_unique<util::ZOrderTileCover>(reg.bounds, static_cast<uint8_t>(z));
+                    }
+                    return boundsCover->next();
+                },
+                [&](const OfflineGeometryRegionDefinition& reg) -> optional<UnwrappedTileID> {
+                    if (!geometryCover) {
+                        geometryCover = std::make_unique<util::TileCover>(reg.geometry, static_cast<uint8_t>(z));
+                    }
+                    return geometryCover->hasNext() ? geometryCover->next() : nullopt;
+                });
+            if (tile) {
+                generated++;
+                return tile->canonical;
+            }
+            boundsCover.reset();
+            geometryCover.reset();
+            z++;
+        }
+        return nullopt;
+    }
+
+    void finish(uint64_t ordinal, optional<uint64_t> size) {
+        finished.emplace(ordinal, size);
+        while (!finished.empty() && finished.begin()->first == done) {
+            if (finished.begin()->second) {
+                completedTiles++;
+                completedSize += *finished.begin()->second;
+            }
+            finished.erase(finished.begin());
+            done++;
+            changed = true;
+        }
+    }
+};
+
 OfflineDownload::OfflineDownload(int64_t id_,
                                  OfflineRegionDefinition definition_,
                                  OfflineDatabase& offlineDatabase_,
@@ -360,11 +401,12 @@ void OfflineDownload::activateDownload() {
    the first few errors is fruitless anyway.
 */
 void OfflineDownload::continueDownload() {
-    if (resourcesRemaining.empty()) {
+    if (!hasRemainingResources()) {
         // Flush pending buffers.
         if (!flushResourcesBuffer()) return;
         if (status.complete()) {
             markPendingUsedResources();
+            offlineDatabase.deleteRegionCheckpoints(id);
             setState(OfflineRegionDownloadState::Inactive);
             return;
         }
@@ -378,9 +420,10 @@ void OfflineDownload::continueDownload() {
         maxConcurrentRequests = static_cast<uint32_t>(*maxRequests);
     }
 
-    while (!resourcesRemaining.empty() && requests.size() < maxConcurrentRequests) {
-        ensureResource(std::move(resourcesRemaining.front()));
+    while (hasRemainingResources() && requests.size() < maxConcurrentRequests) {
+        QueuedResource next = std::move(resourcesRemaining.front());
         resourcesRemaining.pop_front();
+        ensureResource(std::move(next.resource), {}, next.tiles, next.ordinal);
     }
 }
 
@@ -389,13 +432,30 @@ void OfflineDownload::deactivateDownload() {
     resourcesRemaining.clear();
     requests.clear();
     buffer.clear();
+    bufferedTiles.clear();
+    // Keeps the progress of the tiles found in the database for the next activation.
+    if (!tilesToBeMarkedAsUsed.empty()) {
+        markPendingUsedResources();
+    }
+    tileQueues.clear();
 }
 
 bool OfflineDownload::flushResourcesBuffer() {
     if (buffer.empty()) return true;
     try {
         offlineDatabase.putRegionResources(id, buffer, status);
+        auto tile = bufferedTiles.begin();
+        for (auto elem = buffer.begin(); elem != buffer.end(); ++elem, ++tile) {
+            if (!tile->first) continue;
+            // Tiles that failed to be stored don't advance the checkpoint past them.
+            optional<int64_t> size = offlineDatabase.hasRegionResource(std::get<0>(*elem));
+            if (size || std::get<1>(*elem).noContent) {
+                tile->first->finish(tile->second, static_cast<uint64_t>(size.value_or(0)));
+            }
+        }
         buffer.clear();
+        bufferedTiles.clear();
+        saveCheckpoints();
         observer->statusChanged(status);
         return true;
     } catch (const MapboxTileLimitExceededException&) {
@@ -411,32 +471,98 @@ void OfflineDownload::queueResource(Resource&& resource) {
     if (resource.kind == mbgl::Resource::Kind::Tile) {
         status.requiredTileCount++;
     }
-    resourcesRemaining.push_front(std::move(resource));
+    resourcesRemaining.push_front({std::move(resource), nullptr, 0});
 }
 
 void OfflineDownload::queueTiles(SourceType type, uint16_t tileSize, const Tileset& tileset) {
-    tileCover(definition, type, tileSize, tileset.zoomRange, [&](const auto& tile) {
-        status.requiredResourceCount++;
-        status.requiredTileCount++;
+    auto tiles = std::make_unique<TileQueue>();
+    tiles->urlTemplate = tileset.tiles[0];
+    tiles->scheme = tileset.scheme;
+    tiles->zoomRange =
+        definition.match([&](auto& reg) { return coveringZoomRange(reg, type, tileSize, tileset.zoomRange); });
+    tiles->z = tiles->zoomRange.min;
+    tiles->tileCount = tileCount(definition, type, tileSize, tileset.zoomRange);
+
+    status.requiredResourceCount += tiles->tileCount;
+    status.requiredTileCount += tiles->tileCount;
+
+    // Resumes an interrupted download after the tiles it already walked through.
+    optional<OfflineRegionCheckpoint> checkpoint = offlineDatabase.getRegionCheckpoint(id, tiles->urlTemplate);
+    if (checkpoint && checkpoint->tileCount == tiles->tileCount && checkpoint->tiles <= tiles->tileCount &&
+        checkpoint->completedTiles <= checkpoint->tiles) {
+        while (tiles->generated < checkpoint->tiles && tiles->next(definition)) {
+        }
+        tiles->done = checkpoint->tiles;
+        tiles->completedTiles = checkpoint->completedTiles;
+        tiles->completedSize = checkpoint->completedSize;
+
+        // The remaining ones were skipped.
+        status.requiredResourceCount -= checkpoint->tiles - checkpoint->completedTiles;
+        status.completedResourceCount += checkpoint->completedTiles;
+        status.completedResourceSize += checkpoint->completedSize;
+        status.completedTileCount += checkpoint->completedTiles;
+        status.completedTileSize += checkpoint->completedSize;
+    }
 
-        auto tileResource = Resource::tile(
-                tileset.tiles[0], definition.match([](auto& def) { return def.pixelRatio; }),
-                tile.x, tile.y, tile.z, tileset.scheme);
+    tileQueues.push_back(std::move(tiles));
+}
 
-        tileResource.setPriority(Resource::Priority::Low);
-        tileResource.setUsage(Resource::Usage::Offline);
+void OfflineDownload::generateTiles() {
+    const float pixelRatio = definition.match([](auto& def) { return def.pixelRatio; });
+    for (auto& tiles : tileQueues) {
+        while (resourcesRemaining.size() < kTileQueueSize) {
+            const uint64_t ordinal = tiles->generated;
+            optional<CanonicalTileID> tile = tiles->next(definition);
+            if (!tile) {
+                break;
+            }
 
-        resourcesRemaining.push_back(std::move(tileResource));
-    });
+            auto tileResource =
+                Resource::tile(tiles->urlTemplate, pixelRatio, tile->x, tile->y, tile->z, tiles->scheme);
+            tileResource.setPriority(Resource::Priority::Low);
+            tileResource.setUsage(Resource::Usage::Offline);
+
+            resourcesRemaining.push_back({std::move(tileResource), tiles.get(), ordinal});
+        }
+    }
+}
+
+bool OfflineDownload::hasRemainingResources() {
+    if (resourcesRemaining.empty()) {
+        generateTiles();
+    }
+    return !resourcesRemaining.empty();
+}
+
+void OfflineDownload::saveCheckpoints() {
+    for (auto& tiles : tileQueues) {
+        if (!tiles->changed) continue;
+        tiles->changed = false;
+
+        OfflineRegionCheckpoint checkpoint;
+        checkpoint.urlTemplate = tiles->urlTemplate;
+        checkpoint.tileCount = tiles->tileCount;
+        checkpoint.tiles = tiles->done;
+        checkpoint.completedTiles = tiles->completedTiles;
+        checkpoint.completedSize = tiles->completedSize;
+        offlineDatabase.putRegionCheckpoint(id, checkpoint);
+    }
 }
 
 void OfflineDownload::markPendingUsedResources() {
     offlineDatabase.markUsedResources(id, resourcesToBeMarkedAsUsed);
     resourcesToBeMarkedAsUsed.clear();
+    for (const auto& tile : tilesToBeMarkedAsUsed) {
+        std::get<0>(tile)->finish(std::get<1>(tile), std::get<2>(tile));
+    }
+    tilesToBeMarkedAsUsed.clear();
+    saveCheckpoints();
 }
 
 void OfflineDownload::ensureResource(Resource&& resource,
-                                     std::function<void(Response)> callback) {
+                                     std::function<void(Response)> callback,
+                                     TileQueue* tiles,
+                                     uint64_t ordinal) {
     assert(resource.priority == Resource::Priority::Low);
     assert(resource.usage == Resource::Usage::Offline);
 
@@ -456,7 +582,10 @@ void OfflineDownload::ensureResource(Resource&& resource,
                 }
             }
 
-            if (result) resourcesToBeMarkedAsUsed.emplace_back(resource);
+            if (result) {
+                resourcesToBeMarkedAsUsed.emplace_back(resource);
+                if (tiles) tilesToBeMarkedAsUsed.emplace_back(tiles, ordinal, *result);
+            }
             return result;
         };
 
@@ -489,6 +618,7 @@ void OfflineDownload::ensureResource(Resource&& resource,
                     requests.erase(fileRequestsIt);
                     assert(status.requiredResourceCount > 0);
                     status.requiredResourceCount--;
+                    if (tiles) tiles->finish(ordinal, nullopt);
                     continueDownload();
                 }
                 return;
@@ -502,11 +632,12 @@ void OfflineDownload::ensureResource(Resource&& resource,
 
             // Queue up for batched insertion
             buffer.emplace_back(resource, onlineResponse);
+            bufferedTiles.emplace_back(tiles, ordinal);
 
             // Flush buffer periodically.
-            // Have to keep `resourcesRemaining.empty()` as the following condition would fail otherwise.
+            // Have to keep `hasRemainingResources()` as the following condition would fail otherwise.
             // TODO: Simplify the tile count limit check code path!
-            if ((buffer.size() == kResourcesBatchSize || resourcesRemaining.empty()) && !flushResourcesBuffer()) return;
+            if ((buffer.size() == kResourcesBatchSize || !hasRemainingResources()) && !flushResourcesBuffer()) return;
 
             if (offlineDatabase.exceedsOfflineMapboxTileCountLimit(resource)) {
                 onMapboxTileCountLimitExceeded();
@@ -19,12 +19,14 @@
 #include <mbgl/util/run_loop.hpp>
 #include <mbgl/util/thread.hpp>
 #include <mbgl/util/timer.hpp>
+#include <mbgl/util/url.hpp>
 
 #include <algorithm>
 #include <cassert>
 #include <list>
 #include <map>
 #include <utility>
+#include <vector>
 
 namespace mbgl {
 
@@ -57,6 +59,21 @@ struct OnlineFileRequest {
     std::function<void()> cancelCallback = nullptr;
     std::shared_ptr<Mailbox> mailbox;
 
+    // The host that the network request of this request counts against while it is active.
+    std::string host;
+
+    // Whether the active network request only checks whether data the requestor already has is
+    // still current.
+    bool revalidating = false;
+
+    // The active request whose network request this one shares, and the ones sharing this one's.
+    OnlineFileRequest* leader = nullptr;
+    std::vector<OnlineFileRequest*> followers;
+
+    // When the request was due, and how long it then waited for a network request slot.
+    TimePoint due;
+    Duration queueWait = Duration::zero();
+
     // Counts the number of times a response was already expired when received. We're using
     // this to add a delay when making a new request so we don't keep retrying immediately
     // in case of a server serving expired tiles.
@@ -106,8 +123,23 @@ public:
 
     void remove(OnlineFileRequest* req) {
         allRequests.erase(req);
-        if (activeRequests.erase(req)) {
-            activatePendingRequest();
+        if (req->leader) {
+            auto& followers = req->leader->followers;
+            followers.erase(std::remove(followers.begin(), followers.end(), req), followers.end());
+            req->leader = nullptr;
+        } else if (deactivateRequest(req)) {
+            // The network request goes away with this one, so the ones sharing it start another.
+            auto followers = std::move(req->followers);
+            req->followers.clear();
+            for (auto* follower : followers) {
+                follower->leader = nullptr;
+            }
+            if (followers.empty()) {
+                activatePendingRequest();
+            }
+            for (auto* follower : followers) {
+                activateOrQueueRequest(follower);
+            }
         } else {
             pendingRequests.remove(req);
         }
@@ -118,7 +150,13 @@ public:
         assert(activeRequests.find(req) == activeRequests.end());
         assert(!req->request);
 
-        if (activeRequests.size() >= getMaximumConcurrentRequests()) {
+        req->due = Clock::now();
+        if (coalesceRequest(req)) {
+            return;
+        }
+
+        if (activeRequests.size() >= getMaximumConcurrentRequests() || !hostHasRoom(req) ||
+            !revalidationsHaveRoom(req)) {
             queueRequest(req);
         } else {
             activateRequest(req);
@@ -127,15 +165,56 @@ public:
 
     void queueRequest(OnlineFileRequest* req) { pendingRequests.insert(req); }
 
+    // Attaches the request to an active one that sends the same network request, if any, so
+    // that both get its response without taking up another slot.
+    bool coalesceRequest(OnlineFileRequest* req) {
+        if (OnlineFileRequest* active = findActiveRequest(req)) {
+            req->queueWait = Clock::now() - req->due;
+            req->leader = active;
+            active->followers.push_back(req);
+            return true;
+        }
+        return false;
+    }
+
+    OnlineFileRequest* findActiveRequest(const OnlineFileRequest* req) const {
+        for (auto* active : activeRequests) {
+            if (active->request && active->resource.url == req->resource.url &&
+                active->resource.kind == req->resource.kind && active->resource.priorEtag == req->resource.priorEtag &&
+                active->resource.priorModified == req->resource.priorModified) {
+                return active;
+            }
+        }
+        return nullptr;
+    }
+
     void activateRequest(OnlineFileRequest* req) {
         auto callback = [=](const Response& response) {
-            activeRequests.erase(req);
+            deactivateRequest(req);
             req->request.reset();
+            auto followers = std::move(req->followers);
+            req->followers.clear();
+            for (auto* follower : followers) {
+                follower->leader = nullptr;
+            }
             req->completed(response);
+            for (auto* follower : followers) {
+                // Completing a request may cancel others.
+                if (allRequests.find(follower) != allRequests.end()) {
+                    follower->completed(response);
+                }
+            }
             activatePendingRequest();
         };
 
+        req->queueWait = Clock::now() - req->due;
         activeRequests.insert(req);
+        req->host = hostOf(req);
+        activeRequestsPerHost[req->host]++;
+        req->revalidating = isRevalidation(req);
+        if (req->revalidating) {
+            activeRevalidations++;
+        }
 
         if (online) {
             req->request = httpFileSource.request(req->resource, callback);
@@ -147,17 +226,65 @@ public:
         }
     }
 
-    void activatePendingRequest() {
-        auto req = pendingRequests.pop();
+    bool deactivateRequest(OnlineFileRequest* req) {
+        if (!activeRequests.erase(req)) {
+            return false;
+        }
+        if (req->revalidating) {
+            activeRevalidations--;
+            req->revalidating = false;
+        }
+        auto it = activeRequestsPerHost.find(req->host);
+        if (it != activeRequestsPerHost.end() && --it->second == 0) {
+            activeRequestsPerHost.erase(it);
+        }
+        return true;
+    }
+
+    static std::string hostOf(const OnlineFileRequest* req) {
+        const util::URL url(req->resource.url);
+        return req->resource.url.substr(url.domain.first, url.domain.second);
+    }
 
-        if (req) {
-            activateRequest(*req);
+    bool hostHasRoom(const OnlineFileRequest* req) const {
+        if (maximumConcurrentRequestsPerHost == 0) {
+            return true;
+        }
+        auto it = activeRequestsPerHost.find(hostOf(req));
+        return it == activeRequestsPerHost.end() || it->second < maximumConcurrentRequestsPerHost;
+    }
+
+    // Low priority requests for data that the requestor got from the cache already, e.g. the
+    // expired tiles of an app coming back from the background, only check whether it changed.
+    static bool isRevalidation(const OnlineFileRequest* req) {
+        const Resource& resource = req->resource;
+        return resource.priority == Resource::Priority::Low && (resource.priorEtag || resource.priorModified) &&
+               !resource.priorData;
+    }
+
+    // Revalidations take up to half of the network request slots, so that the requests for the
+    // data that isn't there yet don't wait for all of them.
+    bool revalidationsHaveRoom(const OnlineFileRequest* req) const {
+        return !isRevalidation(req) || activeRevalidations < std::max(1u, getMaximumConcurrentRequests() / 2);
+    }
+
+    void activatePendingRequest() {
+        while (auto req = pendingRequests.pop([this](const OnlineFileRequest* pending) {
+            // Requests that can share an active network request don't count against the host.
+            return (hostHasRoom(pending) && revalidationsHaveRoom(pending)) || findActiveRequest(pending);
+        })) {
+            if (!coalesceRequest(*req)) {
+                activateRequest(*req);
+                return;
+            }
         }
     }
 
     bool isPending(OnlineFileRequest* req) { return pendingRequests.contains(req); }
 
-    bool isActive(OnlineFileRequest* req) { return activeRequests.find(req) != activeRequests.end(); }
+    bool isActive(OnlineFileRequest* req) {
+        return req->leader || activeRequests.find(req) != activeRequests.end();
+    }
 
     void setResourceTransform(ResourceTransform transform) { resourceTransform = std::move(transform); }
 
@@ -176,6 +303,10 @@ public:
         maximumConcurrentRequests = maximumConcurrentRequests_;
     }
 
+    void setMaximumConcurrentRequestsPerHost(uint32_t maximumConcurrentRequestsPerHost_) {
+        maximumConcurrentRequestsPerHost = maximumConcurrentRequestsPerHost_;
+    }
+
     void setAPIBaseURL(const std::string& t) { apiBaseURL = t; }
     std::string getAPIBaseURL() const { return apiBaseURL; }
 
@@ -204,7 +335,8 @@ private:
     // Using Pending Requests as an priority queue which processes
     // file requests in a FIFO manner but prefers regular requests
     // over offline requests with a low priority such that low priority
-    // requests do not throttle regular requests.
+    // requests do not throttle regular requests. Among requests of the
+    // same priority, those with a lower Resource::queueOrder go first.
     //
     // The order of a queue is therefore:
     //
@@ -243,18 +375,58 @@ private:
             }
         }
 
-        optional<OnlineFileRequest*> pop() {
-            if (queue.empty()) {
-                return {};
+        // Skips the requests that can't be activated yet, e.g. because their host is at its limit.
+        template <typename Fn>
+        optional<OnlineFileRequest*> pop(Fn&& canActivate) {
+            auto next = find(queue.begin(), firstLowPriorityRequest, canActivate);
+            if (next == firstLowPriorityRequest) {
+                next = find(firstLowPriorityRequest, queue.end(), canActivate);
+                if (next == queue.end()) {
+                    return {};
+                }
             }
 
-            if (queue.begin() == firstLowPriorityRequest) {
+            if (next == firstLowPriorityRequest) {
                 firstLowPriorityRequest++;
             }
 
-            OnlineFileRequest* next = queue.front();
-            queue.pop_front();
-            return {next};
+            OnlineFileRequest* request = *next;
+            queue.erase(next);
+            return {request};
+        }
+
+        // Popping a long queue would otherwise compare all of its requests every time. Tiles are
+        // queued about in the order of their cover anyway, so the best of the first few is close.
+        static constexpr std::size_t maxOrderedCandidates = 32;
+
+        // The order can change while requests wait, so it is only looked at here.
+        template <typename Fn>
+        static std::list<OnlineFileRequest*>::iterator find(std::list<OnlineFileRequest*>::iterator begin,
+                                                            std::list<OnlineFileRequest*>::iterator end,
+                                                            Fn& canActivate) {
+            auto next = end;
+            uint32_t nextOrder = 0;
+            std::size_t candidates = 0;
+            for (auto it = begin; it != end && candidates < maxOrderedCandidates; ++it) {
+                if (!canActivate(*it)) {
+                    continue;
+                }
+                ++candidates;
+                const uint32_t itOrder = order(*it);
+                if (next == end || itOrder < nextOrder) {
+                    next = it;
+                    nextOrder = itOrder;
+                    if (nextOrder == 0) {
+                        break;
+                    }
+                }
+            }
+            return next;
+        }
+
+        static uint32_t order(const OnlineFileRequest* request) {
+            const auto& queueOrder = request->resource.queueOrder;
+            return queueOrder ? queueOrder->load(std::memory_order_relaxed) : 0;
         }
 
         bool contains(OnlineFileRequest* request) const {
@@ -274,7 +446,8 @@ private:
      * 4. Back to #1
      *
      * Requests in any state are in `allRequests`. Requests in the pending state are in
-     * `pendingRequests`. Requests in the active state are in `activeRequests`.
+     * `pendingRequests`. Requests in the active state are in `activeRequests`, unless they
+     * share the network request of an identical one in there.
      */
     std::set<OnlineFileRequest*> allRequests;
 
@@ -282,8 +455,14 @@ private:
 
     std::set<OnlineFileRequest*> activeRequests;
 
+    // Active requests by the host of their network request.
+    std::map<std::string, uint32_t> activeRequestsPerHost;
+
+    uint32_t activeRevalidations = 0;
+
     bool online = true;
     uint32_t maximumConcurrentRequests;
+    uint32_t maximumConcurrentRequestsPerHost = 0;
     HTTPFileSource httpFileSource;
     util::AsyncTask reachability{std::bind(&OnlineFileSourceThread::networkIsReachableAgain, this)};
     std::string accessToken;
@@ -351,6 +530,25 @@ public:
         return cachedMaximumConcurrentRequests;
     }
 
+    void setMaximumConcurrentRequestsPerHost(const mapbox::base::Value& value) {
+        if (auto* maximumConcurrentRequestsPerHost = value.getUint()) {
+            assert(*maximumConcurrentRequestsPerHost < std::numeric_limits<uint32_t>::max());
+            const auto maxRequestsPerHost = static_cast<uint32_t>(*maximumConcurrentRequestsPerHost);
+            thread->actor().invoke(&OnlineFileSourceThread::setMaximumConcurrentRequestsPerHost, maxRequestsPerHost);
+            {
+                std::lock_guard<std::mutex> lock(maximumConcurrentRequestsMutex);
+                cachedMaximumConcurrentRequestsPerHost = maxRequestsPerHost;
+            }
+        } else {
+            Log::Error(Event::General, "Invalid max-concurrent-requests-per-host property value type.");
+        }
+    }
+
+    uint32_t getMaximumConcurrentRequestsPerHost() const {
+        std::lock_guard<std::mutex> lock(maximumConcurrentRequestsMutex);
+        return cachedMaximumConcurrentRequestsPerHost;
+    }
+
     void setAccessToken(const mapbox::base::Value& value) {
         if (auto* accessToken = value.getString()) {
             thread->actor().invoke(&OnlineFileSourceThread::setAccessToken, *accessToken);
@@ -375,6 +573,7 @@ private:
     std::string cachedBaseURL = util::API_BASE_URL;
     mutable std::mutex maximumConcurrentRequestsMutex;
     uint32_t cachedMaximumConcurrentRequests = util::DEFAULT_MAXIMUM_CONCURRENT_REQUESTS;
+    uint32_t cachedMaximumConcurrentRequestsPerHost = 0;
     const std::unique_ptr<util::Thread<OnlineFileSourceThread>> thread;
 };
 
@@ -519,6 +718,10 @@ void OnlineFileRequest::completed(Response response) {
         failedRequestReason = Response::Error::Reason::Success;
     }
 
+    auto timing = std::make_unique<Response::Timing>(response.timing ? *response.timing : Response::Timing());
+    timing->queued = queueWait;
+    response.timing = std::move(timing);
+
     schedule(response.expires);
 
     // Calling the callback may result in `this` being deleted. It needs to be done last,
@@ -614,6 +817,8 @@ void OnlineFileSource::setProperty(const std::string& key, const mapbox::base::V
         impl->setAPIBaseURL(value);
     } else if (key == MAX_CONCURRENT_REQUESTS_KEY) {
         impl->setMaximumConcurrentRequests(value);
+    } else if (key == MAX_CONCURRENT_REQUESTS_PER_HOST_KEY) {
+        impl->setMaximumConcurrentRequestsPerHost(value);
     } else if (key == ONLINE_STATUS_KEY) {
         // For testing only
         if (auto* boolValue = value.getBool()) {
@@ -632,6 +837,8 @@ mapbox::base::Value OnlineFileSource::getProperty(const std::string& key) const
         return impl->getAPIBaseURL();
     } else if (key == MAX_CONCURRENT_REQUESTS_KEY) {
         return impl->getMaximumConcurrentRequests();
+    } else if (key == MAX_CONCURRENT_REQUESTS_PER_HOST_KEY) {
+        return impl->getMaximumConcurrentRequestsPerHost();
     }
     std::string message = "Resource provider does not support property " + key;
     Log::Error(Event::General, message.c_str());
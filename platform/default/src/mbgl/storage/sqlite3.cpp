@@ -71,7 +71,12 @@ class StatementImpl {
 public:
     StatementImpl(sqlite3* db, const char* sql)
     {
+#if SQLITE_VERSION_NUMBER >= 3020000
+        // Statements are prepared once and run many times.
+        const int error = sqlite3_prepare_v3(db, sql, -1, SQLITE_PREPARE_PERSISTENT, &stmt, nullptr);
+#else
         const int error = sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr);
+#endif
         if (error != SQLITE_OK) {
             stmt = nullptr;
             throw Exception { error, sqlite3_errmsg(db) };
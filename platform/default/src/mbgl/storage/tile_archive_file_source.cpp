@@ -0,0 +1,465 @@
+#include <mbgl/platform/settings.hpp>
+#include <mbgl/storage/file_source_request.hpp>
+#include <mbgl/storage/resource.hpp>
+#include <mbgl/storage/response.hpp>
+#include <mbgl/storage/tile_archive_file_source.hpp>
+#include <mbgl/util/compression.hpp>
+#include <mbgl/util/constants.hpp>
+#include <mbgl/util/io.hpp>
+#include <mbgl/util/noncopyable.hpp>
+#include <mbgl/util/optional.hpp>
+#include <mbgl/util/rapidjson.hpp>
+#include <mbgl/util/thread.hpp>
+#include <mbgl/util/url.hpp>
+
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace mbgl {
+
+namespace {
+
+bool acceptsURL(const std::string& url) {
+    return 0 == url.rfind(util::PMTILES_PROTOCOL, 0);
+}
+
+// A read-only view of a whole file. Where the platform supports it, the file is memory-mapped,
+// so that only the pages holding the directories and the requested tiles are read.
+class MappedFile : private util::noncopyable {
+public:
+    explicit MappedFile(const std::string& path) {
+#ifndef _WIN32
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd == -1) {
+            throw util::IOException(errno, "Cannot open file " + path);
+        }
+        struct stat buf;
+        if (::fstat(fd, &buf) == -1) {
+            const int error = errno;
+            ::close(fd);
+            throw util::IOException(error, "Cannot read file " + path);
+        }
+        size = static_cast<std::size_t>(buf.st_size);
+        if (size > 0) {
+            void* mapped = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapped == MAP_FAILED) {
+                const int error = errno;
+                ::close(fd);
+                throw util::IOException(error, "Cannot map file " + path);
+            }
+            data = static_cast<const char*>(mapped);
+        }
+        // The mapping stays valid after closing the descriptor.
+        ::close(fd);
+#else
+        auto contents = util::readFile(path);
+        if (!contents) {
+            throw util::IOException(ENOENT, "Cannot read file " + path);
+        }
+        fallback = std::move(*contents);
+        data = fallback.data();
+        size = fallback.size();
+#endif
+    }
+
+    ~MappedFile() {
+#ifndef _WIN32
+        if (data) {
+            ::munmap(const_cast<char*>(data), size);
+        }
+#endif
+    }
+
+    // Returns the `length` bytes at `offset`, which must lie within the file.
+    const char* at(uint64_t offset, uint64_t length) const {
+        if (offset > size || length > size - offset) {
+            throw std::runtime_error("PMTiles archive is truncated");
+        }
+        return data + offset;
+    }
+
+private:
+    const char* data = nullptr;
+    std::size_t size = 0;
+#ifdef _WIN32
+    std::string fallback;
+#endif
+};
+
+template <typename T>
+T readLittleEndian(const char* bytes) {
+    T value = 0;
+    for (std::size_t i = 0; i < sizeof(T); ++i) {
+        value |= T(uint8_t(bytes[i])) << (8 * i);
+    }
+    return value;
+}
+
+// Returns the position of the tile on the Hilbert curve that orders the tiles of all zoom levels.
+uint64_t tileIDFromZXY(uint8_t z, uint32_t x, uint32_t y) {
+    uint64_t id = ((uint64_t(1) << (2 * z)) - 1) / 3;
+    for (uint32_t s = (uint32_t(1) << z) >> 1; s > 0; s >>= 1) {
+        const uint32_t rx = (x & s) ? 1 : 0;
+        const uint32_t ry = (y & s) ? 1 : 0;
+        id += uint64_t(s) * s * ((3 * rx) ^ ry);
+        if (ry == 0) {
+            if (rx == 1) {
+                x = s - 1 - x;
+                y = s - 1 - y;
+            }
+            std::swap(x, y);
+        }
+    }
+    return id;
+}
+
+// Reads archives in the PMTiles version 3 format: https://github.com/protomaps/PMTiles
+class PMTilesArchive : private util::noncopyable {
+public:
+    explicit PMTilesArchive(const std::string& path) : file(path) {
+        const char* header = file.at(0, headerLength);
+        if (std::memcmp(header, "PMTiles", 7) != 0 || uint8_t(header[7]) != 3) {
+            throw std::runtime_error("Not a PMTiles version 3 archive");
+        }
+        rootDirectoryOffset = readLittleEndian<uint64_t>(header + 8);
+        rootDirectoryLength = readLittleEndian<uint64_t>(header + 16);
+        metadataOffset = readLittleEndian<uint64_t>(header + 24);
+        metadataLength = readLittleEndian<uint64_t>(header + 32);
+        leafDirectoriesOffset = readLittleEndian<uint64_t>(header + 40);
+        tileDataOffset = readLittleEndian<uint64_t>(header + 56);
+        internalCompression = Compression(header[97]);
+        tileCompression = Compression(header[98]);
+        minZoom = uint8_t(header[100]);
+        maxZoom = uint8_t(header[101]);
+        for (std::size_t i = 0; i < 4; ++i) {
+            bounds[i] = readLittleEndian<uint32_t>(header + 102 + 4 * i);
+        }
+        centerZoom = uint8_t(header[118]);
+        center[0] = readLittleEndian<uint32_t>(header + 119);
+        center[1] = readLittleEndian<uint32_t>(header + 123);
+
+        rootDirectory = readDirectory(rootDirectoryOffset, rootDirectoryLength);
+    }
+
+    // Returns the tile data, or nullopt if the archive doesn't contain the tile.
+    optional<std::string> getTile(uint8_t z, uint32_t x, uint32_t y) {
+        const uint64_t tileID = tileIDFromZXY(z, x, y);
+        const std::vector<Entry>* directory = &rootDirectory;
+        // The specification allows for three levels of leaf directories.
+        for (uint32_t depth = 0; depth < 4; ++depth) {
+            const Entry* entry = findEntry(*directory, tileID);
+            if (!entry) {
+                return nullopt;
+            }
+            if (entry->runLength > 0) {
+                return decompress(file.at(tileDataOffset + entry->offset, entry->length), entry->length,
+                                  tileCompression);
+            }
+            directory = &getLeafDirectory(leafDirectoriesOffset + entry->offset, entry->length);
+        }
+        throw std::runtime_error("PMTiles leaf directories are nested too deeply");
+    }
+
+    // Describes the archive as TileJSON, whose tiles are fetched from `url`.
+    std::string getTileJSON(const std::string& url) const {
+        rapidjson::StringBuffer buffer;
+        rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+        writer.StartObject();
+        writer.Key("tilejson");
+        writer.String("2.2.0");
+        writer.Key("tiles");
+        writer.StartArray();
+        const std::string tiles = url + "/{z}/{x}/{y}";
+        writer.String(tiles.c_str(), rapidjson::SizeType(tiles.size()));
+        writer.EndArray();
+        writer.Key("minzoom");
+        writer.Uint(minZoom);
+        writer.Key("maxzoom");
+        writer.Uint(maxZoom);
+        writer.Key("bounds");
+        writer.StartArray();
+        for (const uint32_t bound : bounds) {
+            writer.Double(int32_t(bound) / 1e7);
+        }
+        writer.EndArray();
+        writer.Key("center");
+        writer.StartArray();
+        writer.Double(int32_t(center[0]) / 1e7);
+        writer.Double(int32_t(center[1]) / 1e7);
+        writer.Uint(centerZoom);
+        writer.EndArray();
+
+        // Pass on the metadata, like the attribution and vector layers.
+        if (metadataLength > 0) {
+            JSDocument metadata;
+            const std::string json = decompress(file.at(metadataOffset, metadataLength), metadataLength,
+                                                internalCompression);
+            metadata.Parse<0>(json.c_str());
+            if (!metadata.HasParseError() && metadata.IsObject()) {
+                for (auto it = metadata.MemberBegin(); it != metadata.MemberEnd(); ++it) {
+                    const std::string key(it->name.GetString(), it->name.GetStringLength());
+                    if (key != "tilejson" && key != "tiles" && key != "minzoom" && key != "maxzoom" &&
+                        key != "bounds" && key != "center") {
+                        writer.Key(key.c_str(), rapidjson::SizeType(key.size()));
+                        it->value.Accept(writer);
+                    }
+                }
+            }
+        }
+
+        writer.EndObject();
+        return {buffer.GetString(), buffer.GetSize()};
+    }
+
+private:
+    static constexpr std::size_t headerLength = 127;
+    // Leaf directories decoded at most, for archives with many of them.
+    static constexpr std::size_t maxCachedLeafDirectories = 64;
+
+    enum class Compression : uint8_t { Unknown = 0, None = 1, Gzip = 2, Brotli = 3, Zstd = 4 };
+
+    struct Entry {
+        uint64_t tileID;
+        uint64_t offset;
+        uint32_t length;
+        // The number of consecutive tiles sharing the data; 0 for leaf directories.
+        uint32_t runLength;
+    };
+
+    static std::string decompress(const char* bytes, uint64_t length, Compression compression) {
+        switch (compression) {
+            case Compression::Unknown:
+            case Compression::None:
+                return {bytes, std::size_t(length)};
+            case Compression::Gzip:
+                return util::decompress({bytes, std::size_t(length)});
+            case Compression::Brotli:
+            case Compression::Zstd:
+                break;
+        }
+        throw std::runtime_error("Unsupported PMTiles compression");
+    }
+
+    std::vector<Entry> readDirectory(uint64_t offset, uint64_t length) const {
+        const std::string data = decompress(file.at(offset, length), length, internalCompression);
+        const char* it = data.data();
+        const char* end = data.data() + data.size();
+        auto readVarint = [&] {
+            uint64_t value = 0;
+            for (uint32_t shift = 0; shift < 64; shift += 7) {
+                if (it == end) {
+                    break;
+                }
+                const uint8_t byte = uint8_t(*it++);
+                value |= uint64_t(byte & 0x7F) << shift;
+                if (!(byte & 0x80)) {
+                    return value;
+                }
+            }
+            throw std::runtime_error("Malformed PMTiles directory");
+        };
+
+        const uint64_t count = readVarint();
+        // Every entry takes up at least four bytes, so this guards the allocation against corrupt counts.
+        if (count > data.size()) {
+            throw std::runtime_error("Malformed PMTiles directory");
+        }
+        std::vector<Entry> entries(count);
+        uint64_t tileID = 0;
+        for (auto& entry : entries) {
+            tileID += readVarint();
+            entry.tileID = tileID;
+        }
+        for (auto& entry : entries) {
+            entry.runLength = uint32_t(readVarint());
+        }
+        for (auto& entry : entries) {
+            entry.length = uint32_t(readVarint());
+        }
+        for (std::size_t i = 0; i < entries.size(); ++i) {
+            const uint64_t value = readVarint();
+            // 0 marks data that directly follows the data of the previous entry.
+            if (value == 0 && i > 0) {
+                entries[i].offset = entries[i - 1].offset + entries[i - 1].length;
+            } else {
+                entries[i].offset = value - 1;
+            }
+        }
+        return entries;
+    }
+
+    const std::vector<Entry>& getLeafDirectory(uint64_t offset, uint64_t length) {
+        auto it = leafDirectories.find(offset);
+        if (it == leafDirectories.end()) {
+            if (leafDirectories.size() >= maxCachedLeafDirectories) {
+                leafDirectories.clear();
+            }
+            it = leafDirectories.emplace(offset, readDirectory(offset, length)).first;
+        }
+        return it->second;
+    }
+
+    // Returns the tile entry covering the tile, or the leaf directory that may hold it.
+    static const Entry* findEntry(const std::vector<Entry>& entries, uint64_t tileID) {
+        auto it = std::upper_bound(entries.begin(), entries.end(), tileID, [](uint64_t id, const Entry& entry) {
+            return id < entry.tileID;
+        });
+        if (it == entries.begin()) {
+            return nullptr;
+        }
+        const Entry& entry = *(it - 1);
+        if (entry.runLength == 0 || tileID - entry.tileID < entry.runLength) {
+            return &entry;
+        }
+        return nullptr;
+    }
+
+    MappedFile file;
+    uint64_t rootDirectoryOffset;
+    uint64_t rootDirectoryLength;
+    uint64_t metadataOffset;
+    uint64_t metadataLength;
+    uint64_t leafDirectoriesOffset;
+    uint64_t tileDataOffset;
+    Compression internalCompression;
+    Compression tileCompression;
+    uint8_t minZoom;
+    uint8_t maxZoom;
+    // Longitudes and latitudes in units of 1e-7 degrees.
+    uint32_t bounds[4];
+    uint32_t center[2];
+    uint8_t centerZoom;
+
+    std::vector<Entry> rootDirectory;
+    std::map<uint64_t, std::vector<Entry>> leafDirectories;
+};
+
+// Splits "/path/to/archive.pmtiles/z/x/y" into the path and the tile coordinates.
+bool parseTilePath(const std::string& path, std::string& archive, uint8_t& z, uint32_t& x, uint32_t& y) {
+    uint32_t coordinates[3];
+    std::size_t end = path.size();
+    for (int i = 2; i >= 0; --i) {
+        const std::size_t slash = path.rfind('/', end - 1);
+        if (slash == std::string::npos || slash + 1 == end || end - slash > 11) {
+            return false;
+        }
+        uint64_t value = 0;
+        for (std::size_t c = slash + 1; c < end; ++c) {
+            if (path[c] < '0' || path[c] > '9') {
+                return false;
+            }
+            value = value * 10 + uint64_t(path[c] - '0');
+        }
+        if (value > std::numeric_limits<uint32_t>::max() || slash == 0) {
+            return false;
+        }
+        coordinates[i] = uint32_t(value);
+        end = slash;
+    }
+    if (coordinates[0] > 31 || coordinates[1] >> coordinates[0] || coordinates[2] >> coordinates[0]) {
+        return false;
+    }
+    archive = path.substr(0, end);
+    z = uint8_t(coordinates[0]);
+    x = coordinates[1];
+    y = coordinates[2];
+    return true;
+}
+
+} // namespace
+
+class TileArchiveFileSource::Impl {
+public:
+    explicit Impl(const ActorRef<Impl>&) {}
+
+    void request(const Resource& resource, const ActorRef<FileSourceRequest>& req) {
+        Response response;
+        if (!acceptsURL(resource.url)) {
+            response.error = std::make_unique<Response::Error>(Response::Error::Reason::Other, "Invalid PMTiles URL");
+            req.invoke(&FileSourceRequest::setResponse, response);
+            return;
+        }
+
+        // Cut off the protocol.
+        const auto path =
+            util::percentDecode(resource.url.substr(std::char_traits<char>::length(util::PMTILES_PROTOCOL)));
+        try {
+            if (resource.kind == Resource::Kind::Tile) {
+                std::string archive;
+                uint8_t z;
+                uint32_t x;
+                uint32_t y;
+                if (!parseTilePath(path, archive, z, x, y)) {
+                    response.error =
+                        std::make_unique<Response::Error>(Response::Error::Reason::Other, "Invalid PMTiles tile URL");
+                } else if (auto tile = getArchive(archive).getTile(z, x, y)) {
+                    response.data = std::make_shared<std::string>(std::move(*tile));
+                } else {
+                    response.noContent = true;
+                }
+            } else {
+                response.data = std::make_shared<std::string>(getArchive(path).getTileJSON(resource.url));
+            }
+        } catch (const util::IOException& ex) {
+            response.error = std::make_unique<Response::Error>(
+                ex.code == ENOENT ? Response::Error::Reason::NotFound : Response::Error::Reason::Other, ex.what());
+        } catch (const std::exception& ex) {
+            response.error = std::make_unique<Response::Error>(Response::Error::Reason::Other, ex.what());
+        }
+
+        req.invoke(&FileSourceRequest::setResponse, response);
+    }
+
+private:
+    PMTilesArchive& getArchive(const std::string& path) {
+        auto it = archives.find(path);
+        if (it == archives.end()) {
+            it = archives.emplace(path, std::make_unique<PMTilesArchive>(path)).first;
+        }
+        return *it->second;
+    }
+
+    std::map<std::string, std::unique_ptr<PMTilesArchive>> archives;
+};
+
+TileArchiveFileSource::TileArchiveFileSource()
+    : impl(std::make_unique<util::Thread<Impl>>(
+          util::makeThreadPrioritySetter(platform::EXPERIMENTAL_THREAD_PRIORITY_FILE), "TileArchiveFileSource")) {}
+
+TileArchiveFileSource::~TileArchiveFileSource() = default;
+
+std::unique_ptr<AsyncRequest> TileArchiveFileSource::request(const Resource& resource, Callback callback) {
+    auto req = std::make_unique<FileSourceRequest>(std::move(callback));
+
+    impl->actor().invoke(&Impl::request, resource, req->actor());
+
+    return std::move(req);
+}
+
+bool TileArchiveFileSource::canRequest(const Resource& resource) const {
+    return acceptsURL(resource.url);
+}
+
+void TileArchiveFileSource::pause() {
+    impl->pause();
+}
+
+void TileArchiveFileSource::resume() {
+    impl->resume();
+}
+
+} // namespace mbgl
@@ -1,28 +1,97 @@
 #include <mbgl/text/bidi.hpp>
+#include <mbgl/util/hash.hpp>
 #include <mbgl/util/traits.hpp>
 
 #include <unicode/ubidi.h>
 #include <unicode/ushape.h>
 
-#include <memory>
+#include <list>
+#include <stdexcept>
+#include <unordered_map>
 #include <utility>
 
 namespace mbgl {
 
-class BiDiImpl {
+namespace {
+
+// The ICU objects and the results of a thread, shared by all the BiDi instances running on it.
+// BiDi instances of a tile worker may run on any thread of the pool, so they fetch this for every
+// call instead of holding onto it.
+class ThreadBiDi {
 public:
-    BiDiImpl() : bidiText(ubidi_open()), bidiLine(ubidi_open()) {
+    // Labels such as road names repeat across the tiles and zoom levels a worker lays out. The
+    // least recently used results are evicted once this many are cached.
+    static constexpr std::size_t maxCachedResults = 256;
+
+    struct Key {
+        // The style indices are empty for processText().
+        StyledText text;
+        std::set<std::size_t> lineBreakPoints;
+
+        bool operator==(const Key& rhs) const {
+            return text == rhs.text && lineBreakPoints == rhs.lineBreakPoints;
+        }
+    };
+
+    static ThreadBiDi& get() {
+        thread_local ThreadBiDi threadBiDi;
+        return threadBiDi;
     }
-    ~BiDiImpl() {
+
+    ThreadBiDi() : bidiText(ubidi_open()), bidiLine(ubidi_open()) {}
+    ~ThreadBiDi() {
         ubidi_close(bidiText);
         ubidi_close(bidiLine);
     }
 
+    const std::vector<StyledText>* find(const Key& key) {
+        auto it = results.find(key);
+        if (it == results.end()) {
+            return nullptr;
+        }
+        orderedKeys.splice(orderedKeys.end(), orderedKeys, it->second.position);
+        return &it->second.lines;
+    }
+
+    void add(Key key, std::vector<StyledText> lines) {
+        if (results.size() >= maxCachedResults) {
+            results.erase(*orderedKeys.front());
+            orderedKeys.pop_front();
+        }
+        auto it = results.emplace(std::move(key), Result{std::move(lines), orderedKeys.end()}).first;
+        it->second.position = orderedKeys.insert(orderedKeys.end(), &it->first);
+    }
+
     UBiDi* bidiText = nullptr;
     UBiDi* bidiLine = nullptr;
+
+private:
+    struct KeyHasher {
+        std::size_t operator()(const Key& key) const {
+            std::size_t seed = std::hash<std::u16string>()(key.text.first);
+            for (const uint8_t index : key.text.second) {
+                util::hash_combine(seed, index);
+            }
+            for (const std::size_t lineBreakPoint : key.lineBreakPoints) {
+                util::hash_combine(seed, lineBreakPoint);
+            }
+            return seed;
+        }
+    };
+
+    struct Result {
+        std::vector<StyledText> lines;
+        std::list<const Key*>::iterator position;
+    };
+
+    std::unordered_map<Key, Result, KeyHasher> results;
+    // Least recently used first. Points to the keys of `results`, which stay in place on rehashing.
+    std::list<const Key*> orderedKeys;
 };
 
-BiDi::BiDi() : impl(std::make_unique<BiDiImpl>()) {}
+} // namespace
+
+BiDi::BiDi() = default;
 BiDi::~BiDi() = default;
 
 // Takes UTF16 input in logical order and applies Arabic shaping to the input while maintaining
@@ -54,11 +123,12 @@ std::u16string applyArabicShaping(const std::u16string& input) {
 }
 
 void BiDi::mergeParagraphLineBreaks(std::set<size_t>& lineBreakPoints) {
-    int32_t paragraphCount = ubidi_countParagraphs(impl->bidiText);
+    ThreadBiDi& threadBiDi = ThreadBiDi::get();
+    int32_t paragraphCount = ubidi_countParagraphs(threadBiDi.bidiText);
     for (int32_t i = 0; i < paragraphCount; i++) {
         UErrorCode errorCode = U_ZERO_ERROR;
         int32_t paragraphEndIndex;
-        ubidi_getParagraphByIndex(impl->bidiText, i, nullptr, &paragraphEndIndex, nullptr, &errorCode);
+        ubidi_getParagraphByIndex(threadBiDi.bidiText, i, nullptr, &paragraphEndIndex, nullptr, &errorCode);
 
         if (U_FAILURE(errorCode)) {
             throw std::runtime_error(std::string("ProcessedBiDiText::mergeParagraphLineBreaks: ") +
@@ -90,26 +160,52 @@ std::vector<std::u16string> BiDi::applyLineBreaking(std::set<std::size_t> lineBr
 
 std::vector<std::u16string> BiDi::processText(const std::u16string& input,
                                               std::set<std::size_t> lineBreakPoints) {
+    ThreadBiDi& threadBiDi = ThreadBiDi::get();
+    ThreadBiDi::Key key{{input, {}}, lineBreakPoints};
+    if (const auto* cached = threadBiDi.find(key)) {
+        std::vector<std::u16string> lines;
+        lines.reserve(cached->size());
+        for (const auto& line : *cached) {
+            lines.push_back(line.first);
+        }
+        return lines;
+    }
+
     UErrorCode errorCode = U_ZERO_ERROR;
 
-    ubidi_setPara(impl->bidiText, mbgl::utf16char_cast<const UChar*>(input.c_str()), static_cast<int32_t>(input.size()),
+    ubidi_setPara(threadBiDi.bidiText, mbgl::utf16char_cast<const UChar*>(input.c_str()), static_cast<int32_t>(input.size()),
                   UBIDI_DEFAULT_LTR, nullptr, &errorCode);
 
     if (U_FAILURE(errorCode)) {
         throw std::runtime_error(std::string("BiDi::processText: ") + u_errorName(errorCode));
     }
 
-    return applyLineBreaking(std::move(lineBreakPoints));
+    auto lines = applyLineBreaking(std::move(lineBreakPoints));
+
+    std::vector<StyledText> cachedLines;
+    cachedLines.reserve(lines.size());
+    for (const auto& line : lines) {
+        cachedLines.emplace_back(line, std::vector<uint8_t>());
+    }
+    threadBiDi.add(std::move(key), std::move(cachedLines));
+
+    return lines;
 }
     
 std::vector<StyledText> BiDi::processStyledText(const StyledText& input, std::set<std::size_t> lineBreakPoints) {
+    ThreadBiDi& threadBiDi = ThreadBiDi::get();
+    ThreadBiDi::Key key{input, lineBreakPoints};
+    if (const auto* cached = threadBiDi.find(key)) {
+        return *cached;
+    }
+
     std::vector<StyledText> lines;
     const auto& inputText = input.first;
     const auto& styleIndices = input.second;
     
     UErrorCode errorCode = U_ZERO_ERROR;
     
-    ubidi_setPara(impl->bidiText, mbgl::utf16char_cast<const UChar*>(inputText.c_str()), static_cast<int32_t>(inputText.size()),
+    ubidi_setPara(threadBiDi.bidiText, mbgl::utf16char_cast<const UChar*>(inputText.c_str()), static_cast<int32_t>(inputText.size()),
                   UBIDI_DEFAULT_LTR, nullptr, &errorCode);
     
     if (U_FAILURE(errorCode)) {
@@ -125,13 +221,13 @@ std::vector<StyledText> BiDi::processStyledText(const StyledText& input, std::se
         line.second.reserve(lineBreakPoint - lineStartIndex);
 
         errorCode = U_ZERO_ERROR;
-        ubidi_setLine(impl->bidiText, static_cast<int32_t>(lineStartIndex), static_cast<int32_t>(lineBreakPoint), impl->bidiLine, &errorCode);
+        ubidi_setLine(threadBiDi.bidiText, static_cast<int32_t>(lineStartIndex), static_cast<int32_t>(lineBreakPoint), threadBiDi.bidiLine, &errorCode);
         if (U_FAILURE(errorCode)) {
             throw std::runtime_error(std::string("BiDi::processStyledText (setLine): ") + u_errorName(errorCode));
         }
         
         errorCode = U_ZERO_ERROR;
-        uint32_t runCount = ubidi_countRuns(impl->bidiLine, &errorCode);
+        uint32_t runCount = ubidi_countRuns(threadBiDi.bidiLine, &errorCode);
         if (U_FAILURE(errorCode)) {
             throw std::runtime_error(std::string("BiDi::processStyledText (countRuns): ") + u_errorName(errorCode));
         }
@@ -139,7 +235,7 @@ std::vector<StyledText> BiDi::processStyledText(const StyledText& input, std::se
         for (uint32_t runIndex = 0; runIndex < runCount; runIndex++) {
             int32_t runLogicalStart;
             int32_t runLength;
-            UBiDiDirection direction = ubidi_getVisualRun(impl->bidiLine, runIndex, &runLogicalStart, &runLength);
+            UBiDiDirection direction = ubidi_getVisualRun(threadBiDi.bidiLine, runIndex, &runLogicalStart, &runLength);
             const bool isReversed = direction == UBIDI_RTL;
             
             std::size_t logicalStart = lineStartIndex + runLogicalStart;
@@ -176,6 +272,8 @@ std::vector<StyledText> BiDi::processStyledText(const StyledText& input, std::se
         lineStartIndex = lineBreakPoint;
     }
 
+    threadBiDi.add(std::move(key), lines);
+
     return lines;
 }
     
@@ -205,8 +303,9 @@ std::u16string BiDi::writeReverse(const std::u16string& input, std::size_t logic
 }
 
 std::u16string BiDi::getLine(std::size_t start, std::size_t end) {
+    ThreadBiDi& threadBiDi = ThreadBiDi::get();
     UErrorCode errorCode = U_ZERO_ERROR;
-    ubidi_setLine(impl->bidiText, static_cast<int32_t>(start), static_cast<int32_t>(end), impl->bidiLine, &errorCode);
+    ubidi_setLine(threadBiDi.bidiText, static_cast<int32_t>(start), static_cast<int32_t>(end), threadBiDi.bidiLine, &errorCode);
 
     if (U_FAILURE(errorCode)) {
         throw std::runtime_error(std::string("BiDi::getLine (setLine): ") + u_errorName(errorCode));
@@ -215,13 +314,13 @@ std::u16string BiDi::getLine(std::size_t start, std::size_t end) {
     // Because we set UBIDI_REMOVE_BIDI_CONTROLS, the output may be smaller than what we reserve
     //  Setting UBIDI_INSERT_LRM_FOR_NUMERIC would require
     //  ubidi_getLength(pBiDi)+2*ubidi_countRuns(pBiDi)
-    const int32_t outputLength = ubidi_getProcessedLength(impl->bidiLine);
+    const int32_t outputLength = ubidi_getProcessedLength(threadBiDi.bidiLine);
     std::u16string outputText(outputLength, 0);
 
     // UBIDI_DO_MIRRORING: Apply unicode mirroring of characters like parentheses
     // UBIDI_REMOVE_BIDI_CONTROLS: Now that all the lines are set, remove control characters so that
     // they don't show up on screen (some fonts have glyphs representing them)
-    int32_t finalLength = ubidi_writeReordered(impl->bidiLine,
+    int32_t finalLength = ubidi_writeReordered(threadBiDi.bidiLine,
                                                mbgl::utf16char_cast<UChar*>(&outputText[0]),
                                                outputLength,
                                                UBIDI_DO_MIRRORING | UBIDI_REMOVE_BIDI_CONTROLS,
@@ -6,9 +6,13 @@
 #include <zlib.h>
 #endif
 
+#include <algorithm>
 #include <cstdio>
 #include <cstring>
+#include <queue>
 #include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
 
 // Check zlib library version.
 const static bool zlibVersionCheck __attribute__((unused)) = []() {
@@ -31,7 +35,9 @@ namespace util {
 // cause a link error.
 #undef compress
 
-std::string compress(const std::string &raw) {
+namespace {
+
+std::string compressWith(const std::string &raw, const std::string *dictionary) {
     z_stream deflate_stream;
     memset(&deflate_stream, 0, sizeof(deflate_stream));
 
@@ -40,6 +46,14 @@ std::string compress(const std::string &raw) {
         throw std::runtime_error("failed to initialize deflate");
     }
 
+    if (dictionary &&
+        deflateSetDictionary(&deflate_stream,
+                             reinterpret_cast<const Bytef *>(dictionary->data()),
+                             uInt(dictionary->size())) != Z_OK) {
+        deflateEnd(&deflate_stream);
+        throw std::runtime_error("failed to set deflate dictionary");
+    }
+
     deflate_stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(raw.data()));
     deflate_stream.avail_in = uInt(raw.size());
 
@@ -66,12 +80,13 @@ std::string compress(const std::string &raw) {
     return result;
 }
 
-std::string decompress(const std::string &raw) {
+std::string decompressWith(const std::string &raw, const std::string *dictionary) {
     z_stream inflate_stream;
     memset(&inflate_stream, 0, sizeof(inflate_stream));
 
     // TODO: reuse z_streams
-    if (inflateInit(&inflate_stream) != Z_OK) {
+    // Accepts both zlib and gzip headers.
+    if (inflateInit2(&inflate_stream, MAX_WBITS + 32) != Z_OK) {
         throw std::runtime_error("failed to initialize inflate");
     }
 
@@ -86,6 +101,16 @@ std::string decompress(const std::string &raw) {
         inflate_stream.next_out = reinterpret_cast<Bytef *>(out);
         inflate_stream.avail_out = sizeof(out);
         code = inflate(&inflate_stream, 0);
+        if (code == Z_NEED_DICT && dictionary) {
+            // Fails with Z_DATA_ERROR if the data refers to a different dictionary.
+            code = inflateSetDictionary(&inflate_stream,
+                                        reinterpret_cast<const Bytef *>(dictionary->data()),
+                                        uInt(dictionary->size()));
+            dictionary = nullptr;
+            if (code == Z_OK) {
+                continue;
+            }
+        }
         // result.append(out, sizeof(out) - inflate_stream.avail_out);
         if (result.size() < inflate_stream.total_out) {
             result.append(out, inflate_stream.total_out - result.size());
@@ -100,5 +125,139 @@ std::string decompress(const std::string &raw) {
 
     return result;
 }
+
+// Segments are scored by the 8-byte sequences they contain, which fit a single integer.
+using Sequence = uint64_t;
+constexpr std::size_t sequenceLength = sizeof(Sequence);
+constexpr std::size_t segmentLength = 64;
+constexpr std::size_t segmentStep = 16;
+
+Sequence sequenceAt(const std::string &sample, std::size_t offset) {
+    Sequence sequence;
+    memcpy(&sequence, sample.data() + offset, sequenceLength);
+    return sequence;
+}
+
+struct Segment {
+    std::size_t sample;
+    std::size_t offset;
+    uint64_t score;
+
+    bool operator<(const Segment &other) const {
+        return score < other.score;
+    }
+};
+
+} // namespace
+
+std::string compress(const std::string &raw) {
+    return compressWith(raw, nullptr);
+}
+
+std::string decompress(const std::string &raw) {
+    return decompressWith(raw, nullptr);
+}
+
+std::string compress(const std::string &raw, const std::string &dictionary) {
+    return compressWith(raw, &dictionary);
+}
+
+std::string decompress(const std::string &raw, const std::string &dictionary) {
+    return decompressWith(raw, &dictionary);
+}
+
+uint32_t dictionaryID(const std::string &dictionary) {
+    const uLong initial = adler32(0L, Z_NULL, 0);
+    return uint32_t(adler32(initial, reinterpret_cast<const Bytef *>(dictionary.data()), uInt(dictionary.size())));
+}
+
+uint32_t compressedDictionaryID(const std::string &compressed) {
+    // The zlib header sets FDICT and follows with the big-endian DICTID, see RFC 1950.
+    if (compressed.size() < 6 || (uint8_t(compressed[1]) & 0x20) == 0) {
+        throw std::runtime_error("data wasn't compressed against a dictionary");
+    }
+    return uint32_t(uint8_t(compressed[2])) << 24 | uint32_t(uint8_t(compressed[3])) << 16 |
+           uint32_t(uint8_t(compressed[4])) << 8 | uint32_t(uint8_t(compressed[5]));
+}
+
+uint32_t checksum(const std::string &data) {
+    const uLong initial = crc32(0L, Z_NULL, 0);
+    return uint32_t(crc32(initial, reinterpret_cast<const Bytef *>(data.data()), uInt(data.size())));
+}
+
+std::string trainDictionary(const std::vector<std::string> &samples, std::size_t maxSize) {
+    // Counts the samples each sequence occurs in. Sequences found in a single sample don't
+    // help compressing the others.
+    std::unordered_map<Sequence, uint32_t> frequencies;
+    std::unordered_set<Sequence> seen;
+    for (const auto &sample : samples) {
+        seen.clear();
+        for (std::size_t i = 0; i + sequenceLength <= sample.size(); ++i) {
+            if (seen.insert(sequenceAt(sample, i)).second) {
+                ++frequencies[sequenceAt(sample, i)];
+            }
+        }
+    }
+
+    // Greedily picks the segments that cover the most frequent sequences not covered yet.
+    std::unordered_set<Sequence> covered;
+    std::vector<Sequence> sequences;
+    auto score = [&](const Segment &segment) {
+        sequences.clear();
+        for (std::size_t i = 0; i + sequenceLength <= segmentLength; ++i) {
+            sequences.push_back(sequenceAt(samples[segment.sample], segment.offset + i));
+        }
+        std::sort(sequences.begin(), sequences.end());
+        sequences.erase(std::unique(sequences.begin(), sequences.end()), sequences.end());
+        uint64_t result = 0;
+        for (const auto sequence : sequences) {
+            const uint32_t frequency = frequencies[sequence];
+            if (frequency > 1 && covered.find(sequence) == covered.end()) {
+                result += frequency;
+            }
+        }
+        return result;
+    };
+
+    std::priority_queue<Segment> candidates;
+    for (std::size_t i = 0; i < samples.size(); ++i) {
+        for (std::size_t offset = 0; offset + segmentLength <= samples[i].size(); offset += segmentStep) {
+            Segment segment{i, offset, 0};
+            segment.score = score(segment);
+            if (segment.score > 0) {
+                candidates.push(segment);
+            }
+        }
+    }
+
+    std::vector<Segment> chosen;
+    while (!candidates.empty() && (chosen.size() + 1) * segmentLength <= maxSize) {
+        Segment segment = candidates.top();
+        candidates.pop();
+        // Scores only decrease as segments get picked, so a rescored segment that still
+        // beats the next candidate is the best one.
+        segment.score = score(segment);
+        if (segment.score == 0) {
+            continue;
+        }
+        if (!candidates.empty() && segment.score < candidates.top().score) {
+            candidates.push(segment);
+            continue;
+        }
+        chosen.push_back(segment);
+        for (std::size_t i = 0; i + sequenceLength <= segmentLength; ++i) {
+            covered.insert(sequenceAt(samples[segment.sample], segment.offset + i));
+        }
+    }
+
+    // The end of the dictionary is the cheapest to refer to, so the best segments go last.
+    std::string dictionary;
+    dictionary.reserve(chosen.size() * segmentLength);
+    for (auto it = chosen.rbegin(); it != chosen.rend(); ++it) {
+        dictionary.append(samples[it->sample], it->offset, segmentLength);
+    }
+    return dictionary;
+}
+
 } // namespace util
 } // namespace mbgl
@@ -1,13 +1,16 @@
 #include <mbgl/util/image.hpp>
+#include <mbgl/util/image_buffer_pool.hpp>
 #include <mbgl/util/string.hpp>
 #include <mbgl/util/premultiply.hpp>
 
 namespace mbgl {
 
-PremultipliedImage decodePNG(const uint8_t*, size_t);
-PremultipliedImage decodeJPEG(const uint8_t*, size_t);
+PremultipliedImage decodePNG(const uint8_t*, size_t, util::ImageBufferPool*);
+PremultipliedImage decodeJPEG(const uint8_t*, size_t, util::ImageBufferPool*);
 
-PremultipliedImage decodeImage(const std::string& string) {
+namespace {
+
+PremultipliedImage decode(const std::string& string, util::ImageBufferPool* pool) {
     const auto* data = reinterpret_cast<const uint8_t*>(string.data());
     const size_t size = string.size();
 
@@ -15,18 +18,28 @@ PremultipliedImage decodeImage(const std::string& string) {
         uint32_t magic = (static_cast<uint32_t>(data[0]) << 24) | (static_cast<uint32_t>(data[1]) << 16) |
                          (static_cast<uint32_t>(data[2]) << 8) | static_cast<uint32_t>(data[3]);
         if (magic == 0x89504E47U) {
-            return decodePNG(data, size);
+            return decodePNG(data, size, pool);
         }
     }
 
     if (size >= 2) {
         uint16_t magic = ((data[0] << 8) | data[1]) & 0xffff;
         if (magic == 0xFFD8) {
-            return decodeJPEG(data, size);
+            return decodeJPEG(data, size, pool);
         }
     }
 
     throw std::runtime_error("unsupported image type");
 }
 
+} // namespace
+
+PremultipliedImage decodeImage(const std::string& string) {
+    return decode(string, nullptr);
+}
+
+PremultipliedImage decodeImage(const std::string& string, util::ImageBufferPool& pool) {
+    return decode(string, &pool);
+}
+
 } // namespace mbgl
@@ -1,5 +1,6 @@
 #include <mbgl/util/image.hpp>
 #include <mbgl/util/char_array_buffer.hpp>
+#include <mbgl/util/image_buffer_pool.hpp>
 
 #include <istream>
 #include <sstream>
@@ -88,7 +89,7 @@ struct jpeg_info_guard {
     jpeg_decompress_struct* i_;
 };
 
-PremultipliedImage decodeJPEG(const uint8_t* data, size_t size) {
+PremultipliedImage decodeJPEG(const uint8_t* data, size_t size, util::ImageBufferPool* pool) {
     util::CharArrayBuffer dataBuffer { reinterpret_cast<const char*>(data), size };
     std::istream stream(&dataBuffer);
 
@@ -118,7 +119,8 @@ PremultipliedImage decodeJPEG(const uint8_t* data, size_t size) {
     size_t components = cinfo.output_components;
     size_t rowStride = components * width;
 
-    PremultipliedImage image({ static_cast<uint32_t>(width), static_cast<uint32_t>(height) });
+    const Size imageSize{ static_cast<uint32_t>(width), static_cast<uint32_t>(height) };
+    PremultipliedImage image = pool ? pool->acquire(imageSize) : PremultipliedImage(imageSize);
     uint8_t* dst = image.data.get();
 
     JSAMPARRAY buffer = (*cinfo.mem->alloc_sarray)(reinterpret_cast<j_common_ptr>(&cinfo), JPOOL_IMAGE, rowStride, 1);
@@ -1,6 +1,7 @@
 #include <mbgl/util/image.hpp>
 #include <mbgl/util/premultiply.hpp>
 #include <mbgl/util/char_array_buffer.hpp>
+#include <mbgl/util/image_buffer_pool.hpp>
 #include <mbgl/util/logging.hpp>
 
 #include <istream>
@@ -62,7 +63,7 @@ struct png_struct_guard {
     png_infopp i_;
 };
 
-PremultipliedImage decodePNG(const uint8_t* data, size_t size) {
+PremultipliedImage decodePNG(const uint8_t* data, size_t size, util::ImageBufferPool* pool) {
     util::CharArrayBuffer dataBuffer { reinterpret_cast<const char*>(data), size };
     std::istream stream(&dataBuffer);
 
@@ -98,7 +99,10 @@ PremultipliedImage decodePNG(const uint8_t* data, size_t size) {
     int color_type = 0;
     png_get_IHDR(png_ptr, info_ptr, &width, &height, &bit_depth, &color_type, nullptr, nullptr, nullptr);
 
-    UnassociatedImage image({ static_cast<uint32_t>(width), static_cast<uint32_t>(height) });
+    // Pixels are premultiplied as they are decoded, images without transparency need no pass.
+    const Size imageSize{ static_cast<uint32_t>(width), static_cast<uint32_t>(height) };
+    PremultipliedImage image = pool ? pool->acquire(imageSize) : PremultipliedImage(imageSize);
+    const bool hasAlpha = (color_type & PNG_COLOR_MASK_ALPHA) || png_get_valid(png_ptr, info_ptr, PNG_INFO_tRNS);
 
     if (color_type == PNG_COLOR_TYPE_PALETTE)
         png_set_expand(png_ptr);
@@ -118,7 +122,8 @@ PremultipliedImage decodePNG(const uint8_t* data, size_t size) {
 
     png_set_add_alpha(png_ptr, 0xff, PNG_FILLER_AFTER);
 
-    if (png_get_interlace_type(png_ptr,info_ptr) == PNG_INTERLACE_ADAM7) {
+    const bool interlaced = png_get_interlace_type(png_ptr, info_ptr) == PNG_INTERLACE_ADAM7;
+    if (interlaced) {
         png_set_interlace_handling(png_ptr); // FIXME: libpng bug?
         // according to docs png_read_image
         // "..automatically handles interlacing,
@@ -127,16 +132,30 @@ PremultipliedImage decodePNG(const uint8_t* data, size_t size) {
 
     png_read_update_info(png_ptr, info_ptr);
 
-    // we can read whole image at once
-    // alloc row pointers
-    const std::unique_ptr<png_bytep[]> rows(new png_bytep[height]);
-    for (unsigned row = 0; row < height; ++row)
-        rows[row] = image.data.get() + row * width * 4;
-    png_read_image(png_ptr, rows.get());
+    if (interlaced) {
+        // we can read whole image at once
+        // alloc row pointers
+        const std::unique_ptr<png_bytep[]> rows(new png_bytep[height]);
+        for (unsigned row = 0; row < height; ++row)
+            rows[row] = image.data.get() + row * width * 4;
+        png_read_image(png_ptr, rows.get());
+        if (hasAlpha) {
+            util::premultiplyPixels(image.data.get(), image.size.area());
+        }
+    } else {
+        // Premultiplies each row while it is still in the cache.
+        for (unsigned row = 0; row < height; ++row) {
+            png_bytep pixels = image.data.get() + row * width * 4;
+            png_read_row(png_ptr, pixels, nullptr);
+            if (hasAlpha) {
+                util::premultiplyPixels(pixels, width);
+            }
+        }
+    }
 
     png_read_end(png_ptr, nullptr);
 
-    return util::premultiply(std::move(image));
+    return image;
 }
 
 } // namespace mbgl
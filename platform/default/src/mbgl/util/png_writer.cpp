@@ -1,16 +1,29 @@
-#include <mbgl/util/compression.hpp>
 #include <mbgl/util/image.hpp>
 #include <mbgl/util/premultiply.hpp>
 
 #include <boost/crc.hpp>
 
+#if defined(__QT__) && defined(_WIN32) && !defined(__GNUC__)
+#include <QtZlib/zlib.h>
+#else
+#include <zlib.h>
+#endif
+
+#include <algorithm>
 #include <cassert>
+#include <cstdlib>
 #include <cstring>
+#include <exception>
+#include <stdexcept>
+#include <thread>
+#include <vector>
 
 #define NETWORK_BYTE_UINT32(value) char((value) >> 24), char((value) >> 16), char((value) >> 8), char((value) >> 0)
 
 namespace {
 
+using Filter = mbgl::PNGEncodeOptions::Filter;
+
 void addChunk(std::string& png, const char* type, const char* data = "", const uint32_t size = 0) {
     assert(strlen(type) == 4);
 
@@ -29,12 +42,189 @@ void addChunk(std::string& png, const char* type, const char* data = "", const u
     png.append(crc, 4);
 }
 
+uint8_t paeth(uint8_t a, uint8_t b, uint8_t c) {
+    const int p = int(a) + int(b) - int(c);
+    const int pa = std::abs(p - int(a));
+    const int pb = std::abs(p - int(b));
+    const int pc = std::abs(p - int(c));
+    return (pa <= pb && pa <= pc) ? a : (pb <= pc ? b : c);
+}
+
+// Writes the filtered scanline `line`, with the filter type byte in front, to `out`. `previous`
+// is the scanline above, or null for the first one.
+void filterLine(Filter filter, const uint8_t* line, const uint8_t* previous, std::size_t stride, uint8_t* out) {
+    const std::size_t bpp = 4;
+    uint8_t* filtered = out + 1;
+    switch (filter) {
+    case Filter::None:
+    case Filter::Adaptive:
+        out[0] = 0;
+        std::memcpy(filtered, line, stride);
+        break;
+    case Filter::Sub:
+        out[0] = 1;
+        for (std::size_t i = 0; i < stride; ++i) {
+            filtered[i] = uint8_t(line[i] - (i >= bpp ? line[i - bpp] : 0));
+        }
+        break;
+    case Filter::Up:
+        out[0] = 2;
+        for (std::size_t i = 0; i < stride; ++i) {
+            filtered[i] = uint8_t(line[i] - (previous ? previous[i] : 0));
+        }
+        break;
+    case Filter::Paeth:
+        out[0] = 4;
+        for (std::size_t i = 0; i < stride; ++i) {
+            const uint8_t a = i >= bpp ? line[i - bpp] : 0;
+            const uint8_t b = previous ? previous[i] : 0;
+            const uint8_t c = previous && i >= bpp ? previous[i - bpp] : 0;
+            filtered[i] = uint8_t(line[i] - paeth(a, b, c));
+        }
+        break;
+    }
+}
+
+uint64_t filterCost(const uint8_t* filtered, std::size_t stride) {
+    uint64_t cost = 0;
+    for (std::size_t i = 0; i < stride; ++i) {
+        // Bytes are taken as signed, so that small negative differences are cheap too.
+        cost += uint64_t(std::abs(int(int8_t(filtered[i]))));
+    }
+    return cost;
+}
+
+// Returns the image data as it goes into the IDAT chunk before compression.
+std::string filterImage(const mbgl::UnassociatedImage& src, Filter filter) {
+    const std::size_t stride = src.stride();
+    std::string data((stride + 1) * src.size.height, '\0');
+    std::vector<uint8_t> candidate(filter == Filter::Adaptive ? stride + 1 : 0);
+    for (uint32_t y = 0; y < src.size.height; y++) {
+        const uint8_t* line = src.data.get() + y * stride;
+        const uint8_t* previous = y > 0 ? line - stride : nullptr;
+        auto* out = reinterpret_cast<uint8_t*>(&data[y * (stride + 1)]);
+        if (filter != Filter::Adaptive) {
+            filterLine(filter, line, previous, stride, out);
+            continue;
+        }
+        filterLine(Filter::None, line, previous, stride, out);
+        uint64_t bestCost = filterCost(out + 1, stride);
+        for (const Filter option : {Filter::Sub, Filter::Up, Filter::Paeth}) {
+            filterLine(option, line, previous, stride, candidate.data());
+            const uint64_t cost = filterCost(candidate.data() + 1, stride);
+            if (cost < bestCost) {
+                bestCost = cost;
+                std::memcpy(out, candidate.data(), stride + 1);
+            }
+        }
+    }
+    return data;
+}
+
+// Compresses data[begin, end) into a raw deflate stream that continues the previous strip,
+// whose last 32 KB serve as the dictionary. Strips other than the last end on a byte boundary
+// with a sync flush, so that the streams of consecutive strips can be concatenated.
+std::string deflateStrip(const std::string& data, std::size_t begin, std::size_t end, int level) {
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    if (deflateInit2(&stream, level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        throw std::runtime_error("failed to initialize deflate");
+    }
+
+    const std::size_t window = std::min<std::size_t>(begin, 1u << MAX_WBITS);
+    if (window > 0 &&
+        deflateSetDictionary(&stream, reinterpret_cast<const Bytef*>(data.data() + begin - window), uInt(window)) !=
+            Z_OK) {
+        deflateEnd(&stream);
+        throw std::runtime_error("failed to set deflate dictionary");
+    }
+
+    std::string result(deflateBound(&stream, uLong(end - begin)) + 16, '\0');
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data() + begin));
+    stream.avail_in = uInt(end - begin);
+    stream.next_out = reinterpret_cast<Bytef*>(&result[0]);
+    stream.avail_out = uInt(result.size());
+    const bool last = end == data.size();
+    const int code = deflate(&stream, last ? Z_FINISH : Z_SYNC_FLUSH);
+    result.resize(stream.total_out);
+    deflateEnd(&stream);
+
+    if (code != (last ? Z_STREAM_END : Z_OK) || stream.avail_in != 0) {
+        throw std::runtime_error("failed to deflate image data");
+    }
+    return result;
+}
+
+// Wraps the data into a zlib stream, see RFC 1950.
+std::string compressImage(const std::string& data, std::size_t stride, uint32_t height, int level, uint32_t threads) {
+    // Strips of fewer rows don't make up for the thread and the restarted compression.
+    const uint32_t minimumStripRows = 64;
+    const uint32_t strips = std::max(1u, std::min(threads, height / minimumStripRows));
+    const uint32_t stripRows = (height + strips - 1) / strips;
+
+    std::vector<std::string> compressed(strips);
+    auto compressStrip = [&](uint32_t strip) {
+        const std::size_t begin = std::size_t(strip) * stripRows * (stride + 1);
+        const std::size_t end = std::min<std::size_t>(begin + std::size_t(stripRows) * (stride + 1), data.size());
+        compressed[strip] = deflateStrip(data, begin, end, level);
+    };
+
+    std::vector<std::exception_ptr> errors(strips);
+    auto run = [&](uint32_t strip) {
+        try {
+            compressStrip(strip);
+        } catch (...) {
+            errors[strip] = std::current_exception();
+        }
+    };
+    std::vector<std::thread> workers;
+    for (uint32_t strip = 1; strip < strips; ++strip) {
+        workers.emplace_back(run, strip);
+    }
+    run(0);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    for (const auto& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    // The header records the level in FLEVEL, FCHECK makes it a multiple of 31.
+    const int flevel = level < 0 ? 2 : level < 2 ? 0 : level < 6 ? 1 : level == 6 ? 2 : 3;
+    const uint8_t cmf = 0x78;
+    uint8_t flg = uint8_t(flevel << 6);
+    flg = uint8_t(flg + (31 - (cmf * 256 + flg) % 31) % 31);
+
+    const uLong adler = adler32(adler32(0L, Z_NULL, 0), reinterpret_cast<const Bytef*>(data.data()), uInt(data.size()));
+
+    std::string result;
+    std::size_t size = 2 + 4;
+    for (const auto& strip : compressed) {
+        size += strip.size();
+    }
+    result.reserve(size);
+    result.push_back(char(cmf));
+    result.push_back(char(flg));
+    for (const auto& strip : compressed) {
+        result.append(strip);
+    }
+    const char checksum[4] = { NETWORK_BYTE_UINT32(uint32_t(adler)) };
+    result.append(checksum, 4);
+    return result;
+}
+
 } // namespace
 
 namespace mbgl {
 
 // Encode PNGs without libpng.
 std::string encodePNG(const PremultipliedImage& pre) {
+    return encodePNG(pre, {});
+}
+
+std::string encodePNG(const PremultipliedImage& pre, const PNGEncodeOptions& options) {
     // Make copy of the image so that we can unpremultiply it.
     const auto src = util::unpremultiply(pre.clone());
 
@@ -52,15 +242,13 @@ std::string encodePNG(const PremultipliedImage& pre) {
         0,                                    // interlace method == none
     };
 
-    // Prepare the (compressed) data chunk.
-    const auto stride = src.stride();
-    std::string idat;
-    for (uint32_t y = 0; y < src.size.height; y++) {
-        // Every scanline needs to be prefixed with one byte that indicates the filter type.
-        idat.append(1, 0); // filter type 0
-        idat.append(reinterpret_cast<const char*>(src.data.get() + y * stride), stride);
-    }
-    idat = util::compress(idat);
+    // Prepare the (compressed) data chunk. Every scanline is prefixed with one byte that
+    // indicates the filter type.
+    const std::string idat = compressImage(filterImage(src, options.filter),
+                                           src.stride(),
+                                           src.size.height,
+                                           std::max(-1, std::min(9, options.compressionLevel)),
+                                           std::max(1u, options.threads));
 
     // Assemble the PNG.
     std::string png;
@@ -55,6 +55,22 @@ void setCurrentThreadPriority(double priority) {
 #endif
 }
 
+void setCurrentThreadAffinity(const std::vector<std::size_t>& cpus) {
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (const std::size_t cpu : cpus) {
+        if (cpu < CPU_SETSIZE) CPU_SET(cpu, &set);
+    }
+
+    if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0) {
+        Log::Warning(Event::General, "Couldn't set thread affinity");
+    }
+#else
+    (void)cpus;
+#endif
+}
+
 void attachThread() {}
 
 void detachThread() {}
@@ -9,23 +9,20 @@ namespace util {
 
 class Timer::Impl {
 public:
-    Impl() : timer(new uv_timer_t) {
-        auto* loop = reinterpret_cast<uv_loop_t*>(RunLoop::getLoopHandle());
-        if (uv_timer_init(loop, timer) != 0) {
-            throw std::runtime_error("Failed to initialize timer.");
-        }
-
-        handle()->data = this;
-        uv_unref(handle());
-    }
-
     ~Impl() {
+        if (!timer) {
+            return;
+        }
         uv_close(handle(), [](uv_handle_t* h) {
             delete reinterpret_cast<uv_timer_t*>(h);
         });
     }
 
     void start(uint64_t timeout, uint64_t repeat, std::function<void ()>&& cb_) {
+        // Most timers of file requests are never started, so the handle is only created here.
+        if (!timer) {
+            init();
+        }
         cb = std::move(cb_);
         if (uv_timer_start(timer, timerCallback, timeout, repeat) != 0) {
             throw std::runtime_error("Failed to start timer.");
@@ -34,12 +31,28 @@ public:
 
     void stop() {
         cb = nullptr;
+        if (!timer) {
+            return;
+        }
         if (uv_timer_stop(timer) != 0) {
             throw std::runtime_error("Failed to stop timer.");
         }
     }
 
 private:
+    void init() {
+        timer = new uv_timer_t;
+        auto* loop = reinterpret_cast<uv_loop_t*>(RunLoop::getLoopHandle());
+        if (uv_timer_init(loop, timer) != 0) {
+            delete timer;
+            timer = nullptr;
+            throw std::runtime_error("Failed to initialize timer.");
+        }
+
+        handle()->data = this;
+        uv_unref(handle());
+    }
+
     static void timerCallback(uv_timer_t* handle) {
         reinterpret_cast<Impl*>(handle->data)->cb();
     }
@@ -48,7 +61,7 @@ private:
         return reinterpret_cast<uv_handle_t*>(timer);
     }
 
-    uv_timer_t* timer;
+    uv_timer_t* timer = nullptr;
 
     std::function<void()> cb;
 };
@@ -2,7 +2,11 @@ find_package(CURL REQUIRED)
 find_package(ICU OPTIONAL_COMPONENTS i18n)
 find_package(ICU OPTIONAL_COMPONENTS uc)
 find_package(JPEG REQUIRED)
-find_package(OpenGL REQUIRED GLX)
+if(MBGL_WITH_EGL)
+    find_package(OpenGL REQUIRED EGL OpenGL)
+else()
+    find_package(OpenGL REQUIRED GLX)
+endif()
 find_package(PNG REQUIRED)
 find_package(PkgConfig REQUIRED)
 find_package(X11 REQUIRED)
@@ -31,6 +35,7 @@ target_sources(
         ${PROJECT_SOURCE_DIR}/platform/default/src/mbgl/storage/offline_download.cpp
         ${PROJECT_SOURCE_DIR}/platform/default/src/mbgl/storage/online_file_source.cpp
         ${PROJECT_SOURCE_DIR}/platform/default/src/mbgl/storage/sqlite3.cpp
+        ${PROJECT_SOURCE_DIR}/platform/default/src/mbgl/storage/tile_archive_file_source.cpp
         ${PROJECT_SOURCE_DIR}/platform/default/src/mbgl/text/bidi.cpp
         ${PROJECT_SOURCE_DIR}/platform/default/src/mbgl/text/local_glyph_rasterizer.cpp
         ${PROJECT_SOURCE_DIR}/platform/default/src/mbgl/util/async_task.cpp
@@ -48,7 +53,8 @@ target_sources(
         ${PROJECT_SOURCE_DIR}/platform/default/src/mbgl/util/timer.cpp
         ${PROJECT_SOURCE_DIR}/platform/default/src/mbgl/util/utf.cpp
         ${PROJECT_SOURCE_DIR}/platform/linux/src/gl_functions.cpp
-        ${PROJECT_SOURCE_DIR}/platform/linux/src/headless_backend_glx.cpp
+        $<$<BOOL:${MBGL_WITH_EGL}>:${PROJECT_SOURCE_DIR}/platform/linux/src/headless_backend_egl.cpp>
+        $<$<NOT:$<BOOL:${MBGL_WITH_EGL}>>:${PROJECT_SOURCE_DIR}/platform/linux/src/headless_backend_glx.cpp>
 )
 
 # FIXME: Should not be needed, but now needed by node because of the headless frontend.
@@ -89,7 +95,9 @@ target_link_libraries(
         $<$<NOT:$<BOOL:${MBGL_USE_BUILTIN_ICU}>>:ICU::i18n>
         $<$<NOT:$<BOOL:${MBGL_USE_BUILTIN_ICU}>>:ICU::uc>
         $<$<BOOL:${MBGL_USE_BUILTIN_ICU}>:mbgl-vendor-icu>
-        OpenGL::GLX
+        $<$<BOOL:${MBGL_WITH_EGL}>:OpenGL::EGL>
+        $<$<BOOL:${MBGL_WITH_EGL}>:OpenGL::OpenGL>
+        $<$<NOT:$<BOOL:${MBGL_WITH_EGL}>>:OpenGL::GLX>
         PNG::PNG
         mbgl-vendor-nunicode
         mbgl-vendor-sqlite
@@ -4,22 +4,81 @@
 #include <mbgl/util/logging.hpp>
 
 #include <EGL/egl.h>
+#include <EGL/eglext.h>
 
 #include <cassert>
+#include <cstring>
+#include <map>
+#include <vector>
 
 namespace mbgl {
 namespace gl {
 
-// This class provides a singleton that contains information about the configuration used for
-// instantiating new headless rendering contexts.
+namespace {
+
+bool hasExtension(const char* extensions, const char* name) {
+    if (!extensions) {
+        return false;
+    }
+    const std::size_t length = std::strlen(name);
+    for (const char* match = std::strstr(extensions, name); match; match = std::strstr(match + length, name)) {
+        if ((match == extensions || match[-1] == ' ') && (match[length] == ' ' || match[length] == '\0')) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// The display of one of the GPUs that EGL_EXT_device_enumeration lists, on the device platform
+// of EGL_EXT_platform_device, which needs neither a window system nor a display server.
+EGLDisplay getDeviceDisplay(uint32_t device) {
+#if defined(EGL_EXT_device_enumeration) && defined(EGL_EXT_platform_device)
+    const char* clientExtensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+    if (!hasExtension(clientExtensions, "EGL_EXT_device_enumeration") ||
+        !hasExtension(clientExtensions, "EGL_EXT_platform_device")) {
+        throw std::runtime_error("Choosing the GPU device requires EGL_EXT_device_enumeration and EGL_EXT_platform_device.\n");
+    }
+
+    auto queryDevices = reinterpret_cast<PFNEGLQUERYDEVICESEXTPROC>(eglGetProcAddress("eglQueryDevicesEXT"));
+    auto getPlatformDisplay =
+        reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+    if (!queryDevices || !getPlatformDisplay) {
+        throw std::runtime_error("Cannot find eglQueryDevicesEXT or eglGetPlatformDisplayEXT.\n");
+    }
+
+    EGLint count = 0;
+    if (!queryDevices(0, nullptr, &count)) {
+        throw std::runtime_error("eglQueryDevicesEXT() failed.\n");
+    }
+    std::vector<EGLDeviceEXT> devices(count);
+    if (count > 0 && !queryDevices(count, devices.data(), &count)) {
+        throw std::runtime_error("eglQueryDevicesEXT() failed.\n");
+    }
+    if (device >= static_cast<uint32_t>(count)) {
+        throw std::runtime_error("There is no GPU device " + util::toString(device) + ", only " +
+                                 util::toString(count) + ".\n");
+    }
+
+    return getPlatformDisplay(EGL_PLATFORM_DEVICE_EXT, devices[device], nullptr);
+#else
+    (void)device;
+    (void)hasExtension;
+    throw std::runtime_error("Choosing the GPU device requires EGL_EXT_device_enumeration and EGL_EXT_platform_device.\n");
+#endif
+}
+
+} // namespace
+
+// This class provides a singleton per device that contains information about the configuration
+// used for instantiating new headless rendering contexts.
 class EGLDisplayConfig {
 private:
     // Key for singleton construction.
     struct Key { explicit Key() = default; };
 
 public:
-    EGLDisplayConfig(Key) {
-        display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    EGLDisplayConfig(Key, optional<uint32_t> device) {
+        display = device ? getDeviceDisplay(*device) : eglGetDisplay(EGL_DEFAULT_DISPLAY);
         if (display == EGL_NO_DISPLAY) {
             throw std::runtime_error("Failed to obtain a valid EGL display.\n");
         }
@@ -29,15 +88,25 @@ public:
             throw std::runtime_error("eglInitialize() failed.\n");
         }
 
+#if MBGL_USE_GLES2
         if (!eglBindAPI(EGL_OPENGL_ES_API)) {
             mbgl::Log::Error(mbgl::Event::OpenGL, "eglBindAPI(EGL_OPENGL_ES_API) returned error %d",
                              eglGetError());
             throw std::runtime_error("eglBindAPI() failed");
         }
+#else
+        if (!eglBindAPI(EGL_OPENGL_API)) {
+            mbgl::Log::Error(mbgl::Event::OpenGL, "eglBindAPI(EGL_OPENGL_API) returned error %d",
+                             eglGetError());
+            throw std::runtime_error("eglBindAPI() failed");
+        }
+#endif
 
         const EGLint attribs[] = {
 #if MBGL_USE_GLES2
             EGL_RENDERABLE_TYPE, EGL_OPENGL_ES2_BIT,
+#else
+            EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
 #endif
             EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
             EGL_NONE
@@ -54,11 +123,12 @@ public:
         eglTerminate(display);
     }
 
-    static std::shared_ptr<const EGLDisplayConfig> create() {
-        static std::weak_ptr<const EGLDisplayConfig> instance;
+    static std::shared_ptr<const EGLDisplayConfig> create(optional<uint32_t> device) {
+        static std::map<optional<uint32_t>, std::weak_ptr<const EGLDisplayConfig>> instances;
+        auto& instance = instances[device];
         auto shared = instance.lock();
         if (!shared) {
-            instance = shared = std::make_shared<EGLDisplayConfig>(Key{});
+            instance = shared = std::make_shared<EGLDisplayConfig>(Key{}, device);
         }
         return shared;
     }
@@ -70,13 +140,15 @@ public:
 
 class EGLBackendImpl : public HeadlessBackend::Impl {
 public:
-    EGLBackendImpl() {
+    explicit EGLBackendImpl(optional<uint32_t> device) : eglDisplay(EGLDisplayConfig::create(device)) {
         // EGL initializes the context client version to 1 by default. We want to
         // use OpenGL ES 2.0 which has the ability to create shader and program
         // objects and also to write vertex and fragment shaders in the OpenGL ES
         // Shading Language.
         const EGLint attribs[] = {
+#if MBGL_USE_GLES2
             EGL_CONTEXT_CLIENT_VERSION, 2,
+#endif
             EGL_NONE
         };
 
@@ -133,14 +205,14 @@ public:
     }
 
 private:
-    const std::shared_ptr<const EGLDisplayConfig> eglDisplay = EGLDisplayConfig::create();
+    const std::shared_ptr<const EGLDisplayConfig> eglDisplay;
     EGLContext eglContext = EGL_NO_CONTEXT;
     EGLSurface eglSurface = EGL_NO_SURFACE;
 };
 
 void HeadlessBackend::createImpl() {
     assert(!impl);
-    impl = std::make_unique<EGLBackendImpl>();
+    impl = std::make_unique<EGLBackendImpl>(device);
 }
 
 } // namespace gl
@@ -4,19 +4,63 @@
 
 var mbgl = require('../../lib/node-v' + process.versions.modules + '/mbgl');
 var constructor = mbgl.Map.prototype.constructor;
+var poolConstructor = mbgl.MapPool.prototype.constructor;
 
-var Map = function(options) {
+function wrapBatchRequest(options) {
+    var batchRequest = options.batchRequest;
+
+    return Object.assign(options, {
+        batchRequest: function(reqs) {
+            // The same protection as for `request` below, for the whole batch.
+            var responded = false;
+            var callback = function(err, responses) {
+                if (responded) {
+                    console.warn('batchRequest function responded multiple times; it should call the callback only once');
+                    return;
+                }
+                responded = true;
+                process.nextTick(function() {
+                    reqs.forEach(function(req, i) {
+                        var res = responses && responses[i];
+                        if (err) {
+                            req.respond(err);
+                        } else if (res === undefined || res === null) {
+                            req.respond();
+                        } else if (res instanceof Error) {
+                            req.respond(res);
+                        } else {
+                            req.respond(null, res);
+                        }
+                    });
+                });
+            };
+
+            try {
+                batchRequest(reqs, callback);
+            } catch (e) {
+                console.warn('batchRequest function threw an exception; it should call the callback with an error instead');
+                callback(e);
+            }
+        }
+    });
+}
+
+function wrapRequest(options) {
     if (!(options instanceof Object)) {
         throw TypeError("Requires an options object as first argument");
     }
 
+    if (options.batchRequest instanceof Function) {
+        return wrapBatchRequest(options);
+    }
+
     if (!options.hasOwnProperty('request') || !(options.request instanceof Function)) {
         throw TypeError("Options object must have a 'request' method");
     }
 
     var request = options.request;
 
-    return new constructor(Object.assign(options, {
+    return Object.assign(options, {
         request: function(req) {
             // Protect against `request` implementations that call the callback synchronously,
             // call it multiple times, or throw exceptions.
@@ -42,10 +86,21 @@ var Map = function(options) {
                 callback(e);
             }
         }
-    }));
+    });
+}
+
+var Map = function(options) {
+    return new constructor(wrapRequest(options));
 };
 
 Map.prototype = mbgl.Map.prototype;
 Map.prototype.constructor = Map;
 
-module.exports = Object.assign(mbgl, { Map: Map });
+var MapPool = function(options) {
+    return new poolConstructor(wrapRequest(options));
+};
+
+MapPool.prototype = mbgl.MapPool.prototype;
+MapPool.prototype.constructor = MapPool;
+
+module.exports = Object.assign(mbgl, { Map: Map, MapPool: MapPool });
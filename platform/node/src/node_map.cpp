@@ -1,5 +1,7 @@
 #include "node_map.hpp"
+#include "node_map_pool.hpp"
 #include "node_request.hpp"
+#include "node_response_cache.hpp"
 #include "node_feature.hpp"
 #include "node_conversion.hpp"
 
@@ -31,26 +33,12 @@
 #include <mbgl/util/exception.hpp>
 #include <mbgl/util/logging.hpp>
 #include <mbgl/util/premultiply.hpp>
+#include <mbgl/util/run_loop.hpp>
 
 #include <unistd.h>
 
 namespace node_mbgl {
 
-struct NodeMap::RenderOptions {
-    double zoom = 0;
-    double bearing = 0;
-    mbgl::style::Light light;
-    double pitch = 0;
-    double latitude = 0;
-    double longitude = 0;
-    mbgl::Size size = { 512, 512 };
-    bool axonometric = false;
-    double xSkew = 0;
-    double ySkew = 1;
-    std::vector<std::string> classes;
-    mbgl::MapDebugOptions debugOptions = mbgl::MapDebugOptions::NoDebug;
-};
-
 Nan::Persistent<v8::Function> NodeMap::constructor;
 Nan::Persistent<v8::Object> NodeMap::parseError;
 
@@ -58,6 +46,18 @@ static const char* releasedMessage() {
     return "Map resources have already been released";
 }
 
+// All maps render on the loop thread and read their still image back right away, so they can
+// share one GL context. It goes away with the last map.
+static std::shared_ptr<mbgl::gfx::HeadlessBackend> sharedBackend() {
+    static std::weak_ptr<mbgl::gfx::HeadlessBackend> weakBackend;
+    std::shared_ptr<mbgl::gfx::HeadlessBackend> backend = weakBackend.lock();
+    if (!backend) {
+        backend = mbgl::gfx::HeadlessBackend::Create();
+        weakBackend = backend;
+    }
+    return backend;
+}
+
 void NodeMapObserver::onDidFailLoadingMap(mbgl::MapLoadError error, const std::string& description) {
     switch (error) {
         case mbgl::MapLoadError::StyleParseError:
@@ -152,8 +152,15 @@ ParseError)JS").ToLocalChecked()).ToLocalChecked();
  * @param {Object} options
  * @param {Function} options.request a method used to request resources
  * over the internet
+ * @param {Function} [options.batchRequest] instead of `request`, a method
+ * that gets the requests made in one turn of the event loop at once, as an
+ * array, and a callback taking an error for all of them or an array of
+ * responses. An entry of the array is an Error, a response object, or
+ * undefined for no content.
  * @param {Function} [options.cancel]
  * @param {number} options.ratio pixel ratio
+ * @param {number} [options.cache] the bytes of responses to keep in memory,
+ * so that requests for them don't reach `request` again
  * @example
  * var map = new mbgl.Map({ request: function() {} });
  * map.load(require('./test/fixtures/style.json'));
@@ -173,10 +180,12 @@ void NodeMap::New(const Nan::FunctionCallbackInfo<v8::Value>& info) {
 
     auto options = Nan::To<v8::Object>(info[0]).ToLocalChecked();
 
-    // Check that 'request' is set. If 'cancel' is set it must be a
-    // function and if 'ratio' is set it must be a number.
-    if (!Nan::Has(options, Nan::New("request").ToLocalChecked()).FromJust()
-     || !Nan::Get(options, Nan::New("request").ToLocalChecked()).ToLocalChecked()->IsFunction()) {
+    // Check that 'request' or 'batchRequest' is set. If 'cancel' is set it
+    // must be a function and if 'ratio' or 'cache' is set it must be a number.
+    if ((!Nan::Has(options, Nan::New("request").ToLocalChecked()).FromJust()
+      || !Nan::Get(options, Nan::New("request").ToLocalChecked()).ToLocalChecked()->IsFunction())
+     && (!Nan::Has(options, Nan::New("batchRequest").ToLocalChecked()).FromJust()
+      || !Nan::Get(options, Nan::New("batchRequest").ToLocalChecked()).ToLocalChecked()->IsFunction())) {
         return Nan::ThrowError("Options object must have a 'request' method");
     }
 
@@ -190,6 +199,11 @@ void NodeMap::New(const Nan::FunctionCallbackInfo<v8::Value>& info) {
         return Nan::ThrowError("Options object 'ratio' property must be a number");
     }
 
+    if (Nan::Has(options, Nan::New("cache").ToLocalChecked()).FromJust()
+     && !Nan::Get(options, Nan::New("cache").ToLocalChecked()).ToLocalChecked()->IsNumber()) {
+        return Nan::ThrowError("Options object 'cache' property must be a number");
+    }
+
     info.This()->SetInternalField(1, options);
 
     mbgl::FileSourceManager::get()->registerFileSourceFactory(
@@ -390,18 +404,6 @@ NodeMap::RenderOptions NodeMap::ParseOptions(v8::Local<v8::Object> obj) {
     return options;
 }
 
-class RenderRequest : public Nan::AsyncResource {
-public:
-    explicit RenderRequest(v8::Local<v8::Function> callback_) : AsyncResource("mbgl:RenderRequest") {
-        callback.Reset(callback_);
-    }
-    ~RenderRequest() {
-        callback.Reset();
-    }
-
-    Nan::Persistent<v8::Function> callback;
-};
-
 /**
  * Render an image from the currently-loaded style
  *
@@ -506,40 +508,46 @@ void NodeMap::renderFinished() {
     // We're done with this render call, so we're unrefing so that the loop could close.
     uv_unref(reinterpret_cast<uv_handle_t *>(async));
 
-    // Move the callback and image out of the way so that the callback can start a new render call.
+    // Move the callback, image and error out of the way so that the callback can start a new
+    // render call, whose own error may be set as soon as it starts.
     auto request = std::move(req);
     auto img = std::move(image);
+    std::exception_ptr err = error;
+    error = nullptr;
     assert(request);
 
     // These have to be empty to be prepared for the next render call.
     assert(!req);
     assert(!image.data);
+    assert(!error);
+
+    // A pool can start its next render on this map already.
+    if (pool) {
+        pool->renderFinished(*this);
+    }
 
     v8::Local<v8::Function> callback = Nan::New(request->callback);
     v8::Local<v8::Object> target = Nan::New<v8::Object>();
 
-    if (error) {
-        v8::Local<v8::Value> err;
+    if (err) {
+        v8::Local<v8::Value> jsError;
 
         try {
-            std::rethrow_exception(error);
+            std::rethrow_exception(err);
             assert(false);
         } catch (const mbgl::util::StyleParseException& ex) {
-            err = ParseError(ex.what());
+            jsError = ParseError(ex.what());
         } catch (const std::exception& ex) {
-            err = Nan::Error(ex.what());
+            jsError = Nan::Error(ex.what());
         }
 
         v8::Local<v8::Value> argv[] = {
-            err
+            jsError
         };
 
-        // This must be empty to be prepared for the next render call.
-        error = nullptr;
-        assert(!error);
-
         request->runInAsyncScope(target, callback, 1, argv);
     } else if (img.data) {
+        // The buffer takes over the pixels without copying them.
         v8::Local<v8::Object> pixels = Nan::NewBuffer(
             reinterpret_cast<char *>(img.data.get()), img.bytes(),
             // Retain the data until the buffer is deleted.
@@ -596,6 +604,13 @@ void NodeMap::release() {
     
     map.reset();
     frontend.reset();
+
+    // The requests are canceled along with the map, and JS won't see them anymore.
+    flushTask.reset();
+    for (NodeRequest* request : pendingRequests) {
+        request->unrefRequest();
+    }
+    pendingRequests.clear();
 }
 
 /**
@@ -636,7 +651,7 @@ void NodeMap::cancel() {
         reinterpret_cast<NodeMap *>(h->data)->renderFinished();
     });
 
-    frontend = std::make_unique<mbgl::HeadlessFrontend>(mbgl::Size{ 256, 256 }, pixelRatio);
+    frontend = std::make_unique<mbgl::HeadlessFrontend>(sharedBackend(), mbgl::Size{ 256, 256 }, pixelRatio);
     map = std::make_unique<mbgl::Map>(*frontend, mapObserver,
                                       mbgl::MapOptions().withSize(frontend->getSize())
                                       .withPixelRatio(pixelRatio)
@@ -653,6 +668,39 @@ void NodeMap::cancel() {
     renderFinished();
 }
 
+void NodeMap::queueRequest(NodeRequest& request) {
+    pendingRequests.push_back(&request);
+    if (!flushTask) {
+        flushTask = mbgl::util::RunLoop::Get()->invokeCancellable([this] { flushRequests(); });
+    }
+}
+
+void NodeMap::flushRequests() {
+    auto task = std::move(flushTask);
+    auto requests = std::move(pendingRequests);
+    pendingRequests.clear();
+
+    Nan::HandleScope scope;
+
+    v8::Local<v8::Array> batch = Nan::New<v8::Array>();
+    uint32_t length = 0;
+    for (NodeRequest* request : requests) {
+        if (request->callback) {
+            Nan::Set(batch, length++, request->handle());
+        } else {
+            // Canceled before JS got to see it.
+            request->unrefRequest();
+        }
+    }
+    if (length == 0) {
+        return;
+    }
+
+    Nan::AsyncResource asyncResource("mbgl:execute");
+    v8::Local<v8::Value> argv[] = { batch };
+    asyncResource.runInAsyncScope(Nan::To<v8::Object>(handle()->GetInternalField(1)).ToLocalChecked(), "batchRequest", 1, argv);
+}
+
 void NodeMap::AddSource(const Nan::FunctionCallbackInfo<v8::Value>& info) {
     using namespace mbgl::style;
     using namespace mbgl::style::conversion;
@@ -1414,8 +1462,21 @@ NodeMap::NodeMap(v8::Local<v8::Object> options)
                 ->BooleanValue()
             : true;
     }())
+    , batchRequests([&] {
+        Nan::HandleScope scope;
+        return Nan::Has(options, Nan::New("batchRequest").ToLocalChecked()).FromJust() &&
+               Nan::Get(options, Nan::New("batchRequest").ToLocalChecked()).ToLocalChecked()->IsFunction();
+    }())
+    , cache([&]() -> std::shared_ptr<NodeResponseCache> {
+        Nan::HandleScope scope;
+        if (!Nan::Has(options, Nan::New("cache").ToLocalChecked()).FromJust()) {
+            return {};
+        }
+        const double size = Nan::Get(options, Nan::New("cache").ToLocalChecked()).ToLocalChecked()->NumberValue();
+        return size > 0 ? std::make_shared<NodeResponseCache>(static_cast<std::size_t>(size)) : nullptr;
+    }())
     , mapObserver(NodeMapObserver())
-    , frontend(std::make_unique<mbgl::HeadlessFrontend>(mbgl::Size { 256, 256 }, pixelRatio))
+    , frontend(std::make_unique<mbgl::HeadlessFrontend>(sharedBackend(), mbgl::Size { 256, 256 }, pixelRatio))
     , map(std::make_unique<mbgl::Map>(*frontend, mapObserver,
                                       mbgl::MapOptions().withSize(frontend->getSize())
                                       .withPixelRatio(pixelRatio)
@@ -1449,6 +1510,16 @@ std::unique_ptr<mbgl::AsyncRequest> NodeFileSource::request(const mbgl::Resource
     // *this while we're still executing code.
     nodeMap->handle();
 
+    if (nodeMap->pool) {
+        if (auto cached = nodeMap->pool->requestCached(resource, callback_)) {
+            return cached;
+        }
+    } else if (nodeMap->cache) {
+        if (auto cached = nodeMap->cache->request(resource, callback_)) {
+            return cached;
+        }
+    }
+
     auto asyncRequest = std::make_unique<node_mbgl::NodeAsyncRequest>();
 
     v8::Local<v8::Value> argv[] = {
@@ -2,10 +2,13 @@
 
 #include <mbgl/map/map.hpp>
 #include <mbgl/storage/file_source.hpp>
+#include <mbgl/style/light.hpp>
 #include <mbgl/util/async_request.hpp>
 #include <mbgl/util/image.hpp>
 
 #include <exception>
+#include <string>
+#include <vector>
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wunused-parameter"
@@ -23,11 +26,38 @@ struct NodeMapObserver : public mbgl::MapObserver {
     void onDidFailLoadingMap(mbgl::MapLoadError, const std::string&) final;
 };
 
-class RenderRequest;
+class NodeMapPool;
+class NodeRequest;
+class NodeResponseCache;
+
+class RenderRequest : public Nan::AsyncResource {
+public:
+    explicit RenderRequest(v8::Local<v8::Function> callback_) : AsyncResource("mbgl:RenderRequest") {
+        callback.Reset(callback_);
+    }
+    ~RenderRequest() {
+        callback.Reset();
+    }
+
+    Nan::Persistent<v8::Function> callback;
+};
 
 class NodeMap : public Nan::ObjectWrap {
 public:
-    struct RenderOptions;
+    struct RenderOptions {
+        double zoom = 0;
+        double bearing = 0;
+        mbgl::style::Light light;
+        double pitch = 0;
+        double latitude = 0;
+        double longitude = 0;
+        mbgl::Size size = { 512, 512 };
+        bool axonometric = false;
+        double xSkew = 0;
+        double ySkew = 1;
+        std::vector<std::string> classes;
+        mbgl::MapDebugOptions debugOptions = mbgl::MapDebugOptions::NoDebug;
+    };
     class RenderWorker;
 
     NodeMap(v8::Local<v8::Object>);
@@ -76,11 +106,18 @@ public:
     void release();
     void cancel();
 
+    // Hands the request to the JS batchRequest function together with the others made before the
+    // run loop gets to the next task.
+    void queueRequest(NodeRequest&);
+    void flushRequests();
+
     static RenderOptions ParseOptions(v8::Local<v8::Object>);
 
     const float pixelRatio;
     mbgl::MapMode mode;
     bool crossSourceCollisions;
+    const bool batchRequests;
+    std::shared_ptr<NodeResponseCache> cache;
     NodeMapObserver mapObserver;
     std::unique_ptr<mbgl::HeadlessFrontend> frontend;
     std::unique_ptr<mbgl::Map> map;
@@ -93,6 +130,13 @@ public:
     uv_async_t *async;
 
     bool loaded = false;
+
+    std::vector<NodeRequest*> pendingRequests;
+    std::unique_ptr<mbgl::AsyncRequest> flushTask;
+
+    // The pool this map renders for, if any. It is told when a render finishes, and shares the
+    // responses of the map's requests with the other maps of the pool.
+    NodeMapPool* pool = nullptr;
 };
 
 struct NodeFileSource : public mbgl::FileSource {
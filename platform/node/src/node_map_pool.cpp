@@ -0,0 +1,298 @@
+#include "node_map_pool.hpp"
+
+#include <mbgl/style/conversion.hpp>
+#include <mbgl/style/style.hpp>
+#include <mbgl/util/exception.hpp>
+#include <mbgl/util/logging.hpp>
+#include <mbgl/util/run_loop.hpp>
+
+#include <cassert>
+#include <limits>
+
+namespace node_mbgl {
+
+Nan::Persistent<v8::Function> NodeMapPool::constructor;
+
+static const char* releasedMessage() {
+    return "MapPool resources have already been released";
+}
+
+void NodeMapPool::Init(v8::Local<v8::Object> target) {
+    v8::Local<v8::FunctionTemplate> tpl = Nan::New<v8::FunctionTemplate>(New);
+
+    tpl->SetClassName(Nan::New("MapPool").ToLocalChecked());
+    tpl->InstanceTemplate()->SetInternalFieldCount(1);
+
+    Nan::SetPrototypeMethod(tpl, "load", Load);
+    Nan::SetPrototypeMethod(tpl, "render", Render);
+    Nan::SetPrototypeMethod(tpl, "release", Release);
+
+    constructor.Reset(tpl->GetFunction());
+    Nan::Set(target, Nan::New("MapPool").ToLocalChecked(), tpl->GetFunction());
+}
+
+/**
+ * A pool of maps with the same style, which renders several requests at a
+ * time. The maps render on the main thread one after the other, but their
+ * resource requests and the parsing and layout of their tiles overlap.
+ *
+ * @class
+ * @name MapPool
+ * @param {Object} options the options of a {@link Map}, which all the maps of
+ * the pool share
+ * @param {number} [options.size=4] the number of maps in the pool
+ * @param {number} [options.cache] the bytes of responses the maps share,
+ * tiles included. Without it, the maps share their styles, sources, glyphs
+ * and sprites only.
+ * @example
+ * var pool = new mbgl.MapPool({ request: function() {}, size: 4 });
+ * pool.load(require('./test/fixtures/style.json'));
+ * pool.render({ zoom: 1 }, function(err, image) {});
+ * pool.render({ zoom: 2 }, function(err, image) {});
+ */
+void NodeMapPool::New(const Nan::FunctionCallbackInfo<v8::Value>& info) {
+    if (!info.IsConstructCall()) {
+        return Nan::ThrowTypeError("Use the new operator to create new MapPool objects");
+    }
+
+    if (info.Length() < 1 || !info[0]->IsObject()) {
+        return Nan::ThrowTypeError("Requires an options object as first argument");
+    }
+
+    auto options = Nan::To<v8::Object>(info[0]).ToLocalChecked();
+
+    uint32_t size = 4;
+    if (Nan::Has(options, Nan::New("size").ToLocalChecked()).FromJust()) {
+        auto value = Nan::Get(options, Nan::New("size").ToLocalChecked()).ToLocalChecked();
+        if (!value->IsUint32() || Nan::To<uint32_t>(value).FromJust() == 0) {
+            return Nan::ThrowError("Options object 'size' property must be a positive integer");
+        }
+        size = Nan::To<uint32_t>(value).FromJust();
+    }
+
+    // The maps share the cache of the pool instead of having their own.
+    std::size_t cacheSize = std::numeric_limits<std::size_t>::max();
+    bool cacheAll = false;
+    if (Nan::Has(options, Nan::New("cache").ToLocalChecked()).FromJust()) {
+        auto value = Nan::Get(options, Nan::New("cache").ToLocalChecked()).ToLocalChecked();
+        if (!value->IsNumber() || Nan::To<double>(value).FromJust() < 0) {
+            return Nan::ThrowError("Options object 'cache' property must be a non-negative number");
+        }
+        cacheSize = static_cast<std::size_t>(Nan::To<double>(value).FromJust());
+        cacheAll = true;
+    }
+
+    auto pool = new NodeMapPool();
+    pool->cache = std::make_shared<NodeResponseCache>(cacheSize);
+    pool->cacheAll = cacheAll;
+    pool->Wrap(info.This());
+
+    for (uint32_t i = 0; i < size; ++i) {
+        v8::Local<v8::Value> argv[] = { options };
+        v8::Local<v8::Object> handle;
+        // The Map constructor validates the options and throws on its own.
+        if (!Nan::NewInstance(Nan::New(NodeMap::constructor), 1, argv).ToLocal(&handle)) {
+            return;
+        }
+
+        auto map = Nan::ObjectWrap::Unwrap<NodeMap>(handle);
+        map->pool = pool;
+        map->cache.reset();
+        pool->handles.push_back(std::make_unique<Nan::Persistent<v8::Object>>(handle));
+        pool->maps.push_back(map);
+        pool->idle.push_back(map);
+    }
+
+    info.GetReturnValue().Set(info.This());
+}
+
+NodeMapPool::~NodeMapPool() {
+    try {
+        release();
+    } catch (...) {
+        mbgl::Log::Error(mbgl::Event::General, "Error releasing the maps when destroying NodeMapPool");
+    }
+}
+
+/**
+ * Load a stylesheet into every map of the pool. There must be no render in
+ * progress.
+ *
+ * @function
+ * @name load
+ * @param {string|Object} stylesheet either an object or a JSON representation
+ * @returns {undefined} loads stylesheet into the maps
+ * @throws {Error} if stylesheet is missing or invalid
+ */
+void NodeMapPool::Load(const Nan::FunctionCallbackInfo<v8::Value>& info) {
+    auto pool = Nan::ObjectWrap::Unwrap<NodeMapPool>(info.Holder());
+    if (pool->maps.empty()) return Nan::ThrowError(releasedMessage());
+
+    if (pool->busy()) {
+        return Nan::ThrowError("MapPool is currently processing RenderRequests");
+    }
+
+    pool->loaded = false;
+
+    if (info.Length() < 1) {
+        return Nan::ThrowError("Requires a map style as first argument");
+    }
+
+    std::string style;
+
+    if (info[0]->IsObject()) {
+        Nan::JSON JSON;
+        style = *Nan::Utf8String(JSON.Stringify(info[0]->ToObject()).ToLocalChecked());
+    } else if (info[0]->IsString()) {
+        style = *Nan::Utf8String(info[0]);
+    } else {
+        return Nan::ThrowTypeError("First argument must be a string or object");
+    }
+
+    // The new style may refer to resources that have changed since they were requested.
+    pool->cache->clear();
+
+    for (NodeMap* map : pool->maps) {
+        map->loaded = false;
+        try {
+            map->map->getStyle().loadJSON(style);
+        } catch (const mbgl::util::StyleParseException& ex) {
+            return Nan::ThrowError(NodeMap::ParseError(ex.what()));
+        } catch (const std::exception& ex) {
+            return Nan::ThrowError(ex.what());
+        }
+        map->loaded = true;
+    }
+
+    pool->loaded = true;
+
+    info.GetReturnValue().SetUndefined();
+}
+
+/**
+ * Render an image from the loaded style on the next map of the pool that is
+ * free, with the options of {@link Map#render}. Any number of renders can be
+ * in progress at a time.
+ *
+ * @name render
+ * @param {Object} options
+ * @param {Function} callback
+ * @returns {undefined} calls callback
+ * @throws {Error} if stylesheet is not loaded
+ */
+void NodeMapPool::Render(const Nan::FunctionCallbackInfo<v8::Value>& info) {
+    auto pool = Nan::ObjectWrap::Unwrap<NodeMapPool>(info.Holder());
+    if (pool->maps.empty()) return Nan::ThrowError(releasedMessage());
+
+    if (info.Length() <= 0 || !info[0]->IsObject()) {
+        return Nan::ThrowTypeError("First argument must be an options object");
+    }
+
+    if (info.Length() <= 1 || !info[1]->IsFunction()) {
+        return Nan::ThrowTypeError("Second argument must be a callback function");
+    }
+
+    if (!pool->loaded) {
+        return Nan::ThrowTypeError("Style is not loaded");
+    }
+
+    try {
+        auto options = NodeMap::ParseOptions(Nan::To<v8::Object>(info[0]).ToLocalChecked());
+        pool->queue.push_back({ std::move(options),
+                                std::make_unique<RenderRequest>(Nan::To<v8::Function>(info[1]).ToLocalChecked()) });
+
+        // Retain the pool until the request is complete, so that the maps it is waiting for stay
+        // around as well.
+        pool->Ref();
+
+        pool->dispatch();
+    } catch (const mbgl::style::conversion::Error& err) {
+        return Nan::ThrowTypeError(err.message.c_str());
+    } catch (const mbgl::util::StyleParseException& ex) {
+        return Nan::ThrowError(NodeMap::ParseError(ex.what()));
+    } catch (const mbgl::util::Exception &ex) {
+        return Nan::ThrowError(ex.what());
+    }
+
+    info.GetReturnValue().SetUndefined();
+}
+
+void NodeMapPool::dispatch() {
+    while (!queue.empty() && !idle.empty()) {
+        NodeMap* map = idle.back();
+        idle.pop_back();
+
+        PendingRender pending = std::move(queue.front());
+        queue.pop_front();
+
+        assert(!map->req);
+        map->req = std::move(pending.req);
+        map->startRender(pending.options);
+    }
+}
+
+void NodeMapPool::renderFinished(NodeMap& map) {
+    idle.push_back(&map);
+    dispatch();
+    Unref();
+}
+
+std::unique_ptr<mbgl::AsyncRequest> NodeMapPool::requestCached(const mbgl::Resource& resource,
+                                                               mbgl::FileSource::Callback& callback_) {
+    // Tiles differ from render to render, and are only cached with the cache option.
+    switch (resource.kind) {
+    case mbgl::Resource::Style:
+    case mbgl::Resource::Source:
+    case mbgl::Resource::Glyphs:
+    case mbgl::Resource::SpriteImage:
+    case mbgl::Resource::SpriteJSON:
+        break;
+    default:
+        if (!cacheAll) return {};
+    }
+
+    return cache->request(resource, callback_);
+}
+
+/**
+ * Clean up the maps of the pool. There must be no render in progress.
+ * @name release
+ * @returns {undefined}
+ */
+void NodeMapPool::Release(const Nan::FunctionCallbackInfo<v8::Value>& info) {
+    auto pool = Nan::ObjectWrap::Unwrap<NodeMapPool>(info.Holder());
+    if (pool->maps.empty()) return Nan::ThrowError(releasedMessage());
+
+    if (pool->busy()) {
+        return Nan::ThrowError("MapPool is currently processing RenderRequests");
+    }
+
+    try {
+        pool->release();
+    } catch (const std::exception &ex) {
+        return Nan::ThrowError(ex.what());
+    }
+
+    info.GetReturnValue().SetUndefined();
+}
+
+bool NodeMapPool::busy() const {
+    return !queue.empty() || idle.size() != maps.size();
+}
+
+void NodeMapPool::release() {
+    for (NodeMap* map : maps) {
+        map->pool = nullptr;
+        if (map->map) map->release();
+    }
+    for (auto& handle : handles) {
+        handle->Reset();
+    }
+
+    handles.clear();
+    maps.clear();
+    idle.clear();
+    cache->clear();
+}
+
+} // namespace node_mbgl
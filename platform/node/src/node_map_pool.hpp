@@ -0,0 +1,68 @@
+#pragma once
+
+#include "node_map.hpp"
+#include "node_response_cache.hpp"
+
+#include <mbgl/storage/file_source.hpp>
+#include <mbgl/storage/resource.hpp>
+#include <mbgl/util/async_request.hpp>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#pragma GCC diagnostic ignored "-Wshadow"
+#include <nan.h>
+#pragma GCC diagnostic pop
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+namespace node_mbgl {
+
+// A fixed number of maps with the same style, which take turns rendering the requests given to
+// the pool. Requests that find every map busy wait in a queue. The maps share the responses to
+// the requests for their style, sources, glyphs and sprites, and for their tiles as well with the
+// cache option, so that these are only requested once through the JS request function.
+class NodeMapPool : public Nan::ObjectWrap {
+public:
+    ~NodeMapPool() override;
+
+    static Nan::Persistent<v8::Function> constructor;
+
+    static void Init(v8::Local<v8::Object>);
+
+    static void New(const Nan::FunctionCallbackInfo<v8::Value>&);
+    static void Load(const Nan::FunctionCallbackInfo<v8::Value>&);
+    static void Render(const Nan::FunctionCallbackInfo<v8::Value>&);
+    static void Release(const Nan::FunctionCallbackInfo<v8::Value>&);
+
+    // Called by a map of the pool once its render request is complete, and before the callback
+    // of the request runs. The map can take the next request of the queue right away.
+    void renderFinished(NodeMap&);
+
+    // Answers the request of a map of the pool from the responses the maps received so far.
+    // Returns null if the response isn't known yet, and makes the callback remember it.
+    std::unique_ptr<mbgl::AsyncRequest> requestCached(const mbgl::Resource&, mbgl::FileSource::Callback&);
+
+private:
+    struct PendingRender {
+        NodeMap::RenderOptions options;
+        std::unique_ptr<RenderRequest> req;
+    };
+
+    bool busy() const;
+    void dispatch();
+    void release();
+
+    std::vector<std::unique_ptr<Nan::Persistent<v8::Object>>> handles;
+    std::vector<NodeMap*> maps;
+    std::vector<NodeMap*> idle;
+    std::deque<PendingRender> queue;
+
+    std::shared_ptr<NodeResponseCache> cache;
+    bool cacheAll = false;
+
+    bool loaded = false;
+};
+
+} // namespace node_mbgl
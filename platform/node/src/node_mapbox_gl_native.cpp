@@ -9,6 +9,7 @@
 #include <mbgl/gfx/backend.hpp>
 
 #include "node_map.hpp"
+#include "node_map_pool.hpp"
 #include "node_logging.hpp"
 #include "node_request.hpp"
 #include "node_expression.hpp"
@@ -33,6 +34,7 @@ void RegisterModule(v8::Local<v8::Object> target, v8::Local<v8::Object> module)
     Nan::SetMethod(target, "setBackendType", SetBackendType);
 
     node_mbgl::NodeMap::Init(target);
+    node_mbgl::NodeMapPool::Init(target);
     node_mbgl::NodeRequest::Init();
     node_mbgl::NodeExpression::Init(target);
 
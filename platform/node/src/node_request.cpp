@@ -48,8 +48,12 @@ void NodeRequest::New(const Nan::FunctionCallbackInfo<v8::Value>& info) {
     request->Ref();
     Nan::Set(info.This(), Nan::New("url").ToLocalChecked(), info[3]);
     Nan::Set(info.This(), Nan::New("kind").ToLocalChecked(), info[4]);
-    v8::Local<v8::Value> argv[] = { info.This() };
-    request->asyncResource->runInAsyncScope(Nan::To<v8::Object>(target->handle()->GetInternalField(1)).ToLocalChecked(), "request", 1, argv);
+    if (target->batchRequests) {
+        target->queueRequest(*request);
+    } else {
+        v8::Local<v8::Value> argv[] = { info.This() };
+        request->asyncResource->runInAsyncScope(Nan::To<v8::Object>(target->handle()->GetInternalField(1)).ToLocalChecked(), "request", 1, argv);
+    }
     info.GetReturnValue().Set(info.This());
 }
 
@@ -113,6 +117,9 @@ void NodeRequest::HandleCallback(const Nan::FunctionCallbackInfo<v8::Value>& inf
         if (Nan::Has(res, Nan::New("data").ToLocalChecked()).FromJust()) {
             auto data = Nan::Get(res, Nan::New("data").ToLocalChecked()).ToLocalChecked();
             if (node::Buffer::HasInstance(data)) {
+                // Response data is a std::string, which can't take over the memory of the Buffer, so
+                // this is the one copy of the data on its way to the parsers. The JS side may also
+                // reuse or modify the Buffer once respond() returns.
                 response.data = std::make_shared<std::string>(
                     node::Buffer::Data(data),
                     node::Buffer::Length(data)
@@ -0,0 +1,68 @@
+#include "node_response_cache.hpp"
+
+#include <mbgl/util/run_loop.hpp>
+
+namespace node_mbgl {
+
+namespace {
+
+std::size_t dataSize(const mbgl::Response& response) {
+    return response.data ? response.data->size() : 0;
+}
+
+} // namespace
+
+NodeResponseCache::NodeResponseCache(std::size_t maxSize_) : maxSize(maxSize_) {}
+
+std::unique_ptr<mbgl::AsyncRequest> NodeResponseCache::request(const mbgl::Resource& resource,
+                                                               mbgl::FileSource::Callback& callback_) {
+    auto it = index.find(resource.url);
+    if (it != index.end()) {
+        entries.splice(entries.begin(), entries, it->second);
+        // File sources respond asynchronously.
+        return mbgl::util::RunLoop::Get()->invokeCancellable(
+            [callback = std::move(callback_), response = it->second->second] { callback(response); });
+    }
+
+    callback_ = [weak = std::weak_ptr<NodeResponseCache>(shared_from_this()), url = resource.url,
+                 callback = std::move(callback_)](mbgl::Response response) {
+        auto self = weak.lock();
+        if (self && !response.error) {
+            self->add(url, response);
+        }
+        callback(response);
+    };
+    return {};
+}
+
+void NodeResponseCache::add(const std::string& url, const mbgl::Response& response) {
+    if (dataSize(response) > maxSize) {
+        return;
+    }
+
+    // Another request for the same resource may have been answered in the meantime.
+    auto it = index.find(url);
+    if (it != index.end()) {
+        size -= dataSize(it->second->second);
+        entries.erase(it->second);
+        index.erase(it);
+    }
+
+    entries.emplace_front(url, response);
+    index.emplace(url, entries.begin());
+    size += dataSize(response);
+
+    while (size > maxSize) {
+        size -= dataSize(entries.back().second);
+        index.erase(entries.back().first);
+        entries.pop_back();
+    }
+}
+
+void NodeResponseCache::clear() {
+    entries.clear();
+    index.clear();
+    size = 0;
+}
+
+} // namespace node_mbgl
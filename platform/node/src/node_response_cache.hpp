@@ -0,0 +1,40 @@
+#pragma once
+
+#include <mbgl/storage/file_source.hpp>
+#include <mbgl/storage/resource.hpp>
+#include <mbgl/storage/response.hpp>
+#include <mbgl/util/async_request.hpp>
+
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace node_mbgl {
+
+// Keeps the successful responses of the JS request function in memory by URL, so that requests
+// for the same resource don't reach JS again. The least recently used responses go first once
+// their data exceeds the maximum size.
+class NodeResponseCache : public std::enable_shared_from_this<NodeResponseCache> {
+public:
+    explicit NodeResponseCache(std::size_t maxSize);
+
+    // Answers the request asynchronously if the response is cached. Otherwise returns null, and
+    // makes the callback add the response to the cache when it comes in.
+    std::unique_ptr<mbgl::AsyncRequest> request(const mbgl::Resource&, mbgl::FileSource::Callback&);
+
+    void clear();
+
+private:
+    void add(const std::string& url, const mbgl::Response&);
+
+    using Entry = std::pair<std::string, mbgl::Response>;
+
+    const std::size_t maxSize;
+    std::size_t size = 0;
+    // Most recently used first.
+    std::list<Entry> entries;
+    std::unordered_map<std::string, std::list<Entry>::iterator> index;
+};
+
+} // namespace node_mbgl
@@ -0,0 +1,74 @@
+'use strict';
+
+var test = require('tape');
+var mbgl = require('../../index');
+var fs = require('fs');
+var path = require('path');
+var style = require('../fixtures/style.json');
+
+test('MapPool', function(t) {
+    var options = {
+        request: function(req, callback) {
+            fs.readFile(path.join(__dirname, '..', req.url), function(err, data) {
+                callback(err, { data: data });
+            });
+        },
+        ratio: 1,
+        size: 3
+    };
+
+    t.test('requires request property', function(t) {
+        t.throws(function() {
+            new mbgl.MapPool({});
+        }, /Options object must have a 'request' method/);
+
+        t.end();
+    });
+
+    t.test('size must be a positive integer', function(t) {
+        t.throws(function() {
+            new mbgl.MapPool({ request: function() {}, size: 0 });
+        }, /Options object 'size' property must be a positive integer/);
+
+        t.throws(function() {
+            new mbgl.MapPool({ request: function() {}, size: 'test' });
+        }, /Options object 'size' property must be a positive integer/);
+
+        t.end();
+    });
+
+    t.test('requires a loaded style to render', function(t) {
+        var pool = new mbgl.MapPool(options);
+
+        t.throws(function() {
+            pool.render({}, function() {});
+        }, /Style is not loaded/);
+
+        pool.release();
+        t.end();
+    });
+
+    t.test('renders more requests than maps concurrently', function(t) {
+        var pool = new mbgl.MapPool(options);
+        pool.load(style);
+
+        var remaining = 10;
+        for (var i = 0; i < 10; i++) {
+            pool.render({ bearing: i * 10 }, function(err, pixels) {
+                t.error(err);
+                t.equal(pixels.length, 512 * 512 * 4);
+
+                if (--remaining === 0) {
+                    pool.release();
+                    t.end();
+                }
+            });
+        }
+
+        t.throws(function() {
+            pool.release();
+        }, /MapPool is currently processing RenderRequests/);
+    });
+
+    t.end();
+});
@@ -165,3 +165,67 @@ test(`render does not report an error from rendering a previous style`, function
         });
     });
 });
+
+test(`render with a batchRequest function gets the requests of a tick at once`, function(t) {
+    var batches = [];
+    var map = new mbgl.Map({
+        batchRequest: function(reqs, callback) {
+            batches.push(reqs.length);
+            callback(null, reqs.map(function(req) {
+                return { data: mockfs.dataForRequest(req) };
+            }));
+        }
+    });
+    map.load(mockfs.style_vector);
+    map.render({ zoom: 16 }, function(err, pixels) {
+        t.error(err);
+        t.assert(pixels);
+        t.assert(batches.some(function(length) { return length > 1; }), 'requests were batched');
+        map.release();
+        t.end();
+    });
+});
+
+test(`render reports an error when the batchRequest function responds with an error`, function(t) {
+    var map = new mbgl.Map({
+        batchRequest: function(reqs, callback) {
+            callback(null, reqs.map(function(req) {
+                var data = mockfs.dataForRequest(req);
+                return mockfs.source_vector === data ? new Error('message') : { data: data };
+            }));
+        }
+    });
+    map.load(mockfs.style_vector);
+    map.render({ zoom: 16 }, function(err, pixels) {
+        t.assert(err);
+        t.assert(/message/.test(err.message));
+        t.assert(!pixels);
+        map.release();
+        t.end();
+    });
+});
+
+test(`render with a cache doesn't request a resource twice`, function(t) {
+    var requests = {};
+    var map = new mbgl.Map({
+        request: function(req, callback) {
+            requests[req.url] = (requests[req.url] || 0) + 1;
+            callback(null, { data: mockfs.dataForRequest(req) });
+        },
+        cache: 1024 * 1024
+    });
+    map.load(mockfs.style_vector);
+    map.render({ zoom: 16 }, function(err) {
+        t.error(err);
+        map.load(mockfs.style_vector);
+        map.render({ zoom: 16 }, function(err, pixels) {
+            t.error(err);
+            t.assert(pixels);
+            Object.keys(requests).forEach(function(url) {
+                t.equal(requests[url], 1, url);
+            });
+            map.release();
+            t.end();
+        });
+    });
+});
@@ -1,22 +1,14 @@
-#include <memory>
-
 #include <mbgl/text/bidi.hpp>
 
 namespace mbgl {
 
-// This stub implementation is stateless and doesn't implement the private
-// methods used by the ICU BiDi
-class BiDiImpl {
-    // Used by the ICU implementation to hold onto internal BiDi state
-};
+// This stub implementation doesn't implement the private methods used by the ICU BiDi
 
 std::u16string applyArabicShaping(const std::u16string& input) {
     return input;
 }
 
-BiDi::BiDi() : impl(std::make_unique<BiDiImpl>())
-{
-}
+BiDi::BiDi() = default;
 
 BiDi::~BiDi() = default;
 
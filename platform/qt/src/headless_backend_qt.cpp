@@ -4,6 +4,7 @@
 #include <QOpenGLContext>
 
 #include <cassert>
+#include <stdexcept>
 
 namespace mbgl {
 namespace gl {
@@ -31,6 +32,9 @@ private:
 
 void HeadlessBackend::createImpl() {
     assert(!impl);
+    if (device) {
+        throw std::runtime_error("Choosing the GPU device requires the EGL headless backend");
+    }
     impl = std::make_unique<QtBackendImpl>();
 }
 
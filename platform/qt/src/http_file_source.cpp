@@ -9,6 +9,9 @@
 #include <QNetworkReply>
 #include <QSslConfiguration>
 
+#include <memory>
+#include <string>
+
 namespace mbgl {
 
 HTTPFileSource::Impl::Impl() : m_manager(new QNetworkAccessManager(this))
@@ -30,6 +33,13 @@ void HTTPFileSource::Impl::request(HTTPRequest* req)
 
     QNetworkRequest networkRequest = req->networkRequest();
     networkRequest.setAttribute(QNetworkRequest::FollowRedirectsAttribute, true);
+    // Lets the requests to a host share one connection where the server supports it, instead of
+    // opening one per request up to the limit of the manager.
+#if QT_VERSION >= QT_VERSION_CHECK(5, 15, 0)
+    networkRequest.setAttribute(QNetworkRequest::Http2AllowedAttribute, true);
+#elif QT_VERSION >= QT_VERSION_CHECK(5, 8, 0)
+    networkRequest.setAttribute(QNetworkRequest::HTTP2AllowedAttribute, true);
+#endif
 
     data.first = m_manager->get(networkRequest);
     connect(data.first, SIGNAL(finished()), this, SLOT(onReplyFinished()));
@@ -73,7 +83,9 @@ void HTTPFileSource::Impl::onReplyFinished()
         return;
     }
 
-    QByteArray data = reply->readAll();
+    // The requests that share the reply share the data as well.
+    const QByteArray bytes = reply->readAll();
+    const auto data = std::make_shared<const std::string>(bytes.constData(), bytes.size());
     QVector<HTTPRequest*>& requestsVector = it.value().second;
 
     // Cannot use the iterator to walk the requestsVector
@@ -52,7 +52,7 @@ QNetworkRequest HTTPRequest::networkRequest() const
     return req;
 }
 
-void HTTPRequest::handleNetworkReply(QNetworkReply *reply, const QByteArray& data)
+void HTTPRequest::handleNetworkReply(QNetworkReply *reply, const std::shared_ptr<const std::string>& data)
 {
     m_handled = true;
 
@@ -97,14 +97,9 @@ void HTTPRequest::handleNetworkReply(QNetworkReply *reply, const QByteArray& dat
     int responseCode = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
 
     switch(responseCode) {
-    case 200: {
-        if (data.isEmpty()) {
-            response.data = std::make_shared<std::string>();
-        } else {
-            response.data = std::make_shared<std::string>(data.constData(), data.size());
-        }
+    case 200:
+        response.data = data;
         break;
-    }
     case 204:
         response.noContent = true;
         break;
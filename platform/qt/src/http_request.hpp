@@ -8,6 +8,9 @@
 #include <QNetworkRequest>
 #include <QUrl>
 
+#include <memory>
+#include <string>
+
 namespace mbgl {
 
 class Response;
@@ -21,7 +24,7 @@ public:
     QUrl requestUrl() const;
     QNetworkRequest networkRequest() const;
 
-    void handleNetworkReply(QNetworkReply *, const QByteArray& data);
+    void handleNetworkReply(QNetworkReply *, const std::shared_ptr<const std::string>& data);
 
 private:
     HTTPFileSource::Impl* m_context;
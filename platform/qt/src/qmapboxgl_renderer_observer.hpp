@@ -45,6 +45,10 @@ public:
         delegate.invoke(&mbgl::RendererObserver::onDidFinishRenderingMap);
     }
 
+    void onDidReachStartupMilestone(StartupMilestone milestone) final {
+        delegate.invoke(&mbgl::RendererObserver::onDidReachStartupMilestone, milestone);
+    }
+
 private:
     std::shared_ptr<mbgl::Mailbox> mailbox;
     mbgl::ActorRef<mbgl::RendererObserver> delegate;
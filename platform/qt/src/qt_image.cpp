@@ -1,12 +1,20 @@
 #include <mbgl/util/image.hpp>
+#include <mbgl/util/image_buffer_pool.hpp>
 
 #include <QBuffer>
 #include <QByteArray>
 #include <QImage>
 
+#include <algorithm>
+
 namespace mbgl {
 
 std::string encodePNG(const PremultipliedImage& pre) {
+    return encodePNG(pre, {});
+}
+
+// Qt picks the filters and compresses on the calling thread, only the level is honored.
+std::string encodePNG(const PremultipliedImage& pre, const PNGEncodeOptions& options) {
     QImage image(pre.data.get(), pre.size.width, pre.size.height,
         QImage::Format_ARGB32_Premultiplied);
 
@@ -14,16 +22,20 @@ std::string encodePNG(const PremultipliedImage& pre) {
     QBuffer buffer(&array);
 
     buffer.open(QIODevice::WriteOnly);
-    image.rgbSwapped().save(&buffer, "PNG");
+    // Qt maps the quality 0 to 100 onto the compression levels 9 to 0.
+    const int quality = options.compressionLevel < 0 ? -1 : (9 - std::min(9, options.compressionLevel)) * 100 / 9;
+    image.rgbSwapped().save(&buffer, "PNG", quality);
 
     return std::string(array.constData(), array.size());
 }
 
 #if !defined(QT_IMAGE_DECODERS)
-PremultipliedImage decodeJPEG(const uint8_t*, size_t);
+PremultipliedImage decodeJPEG(const uint8_t*, size_t, util::ImageBufferPool*);
 #endif
 
-PremultipliedImage decodeImage(const std::string& string) {
+namespace {
+
+PremultipliedImage decode(const std::string& string, util::ImageBufferPool* pool) {
     const uint8_t* data = reinterpret_cast<const uint8_t*>(string.data());
     const size_t size = string.size();
 
@@ -31,7 +43,7 @@ PremultipliedImage decodeImage(const std::string& string) {
     if (size >= 2) {
         uint16_t magic = ((data[0] << 8) | data[1]) & 0xffff;
         if (magic == 0xFFD8) {
-            return decodeJPEG(data, size);
+            return decodeJPEG(data, size, pool);
         }
     }
 #endif
@@ -45,10 +57,20 @@ PremultipliedImage decodeImage(const std::string& string) {
         throw std::runtime_error("Unsupported image type");
     }
 
-    auto img = std::make_unique<uint8_t[]>(image.byteCount());
-    memcpy(img.get(), image.constBits(), image.byteCount());
+    const Size imageSize{ static_cast<uint32_t>(image.width()), static_cast<uint32_t>(image.height()) };
+    PremultipliedImage result = pool ? pool->acquire(imageSize) : PremultipliedImage(imageSize);
+    memcpy(result.data.get(), image.constBits(), result.bytes());
+
+    return result;
+}
+
+} // namespace
+
+PremultipliedImage decodeImage(const std::string& string) {
+    return decode(string, nullptr);
+}
 
-    return { { static_cast<uint32_t>(image.width()), static_cast<uint32_t>(image.height()) },
-             std::move(img) };
+PremultipliedImage decodeImage(const std::string& string, util::ImageBufferPool& pool) {
+    return decode(string, &pool);
 }
 }
@@ -18,6 +18,8 @@ void makeThreadLowPriority() {
 
 void setCurrentThreadPriority(double) {}
 
+void setCurrentThreadAffinity(const std::vector<std::size_t>&) {}
+
 void attachThread() {
 }
 
@@ -1,21 +1,41 @@
 #include "allocation_index.hpp"
 
+#include <mbgl/util/phase.hpp>
+
 #include <atomic>
 #include <cassert>
 #include <cstdlib>
 #include <mutex>
+#include <sstream>
 #include <unordered_map>
+#include <utility>
+#include <vector>
+
+#if defined(__GLIBC__) || defined(__APPLE__)
+#define MBGL_ALLOCATION_STACKS
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+#endif
 
 namespace {
 
 std::atomic_size_t indexedMemorySize{0};
 std::atomic_size_t indexedMemoryPeak{0};
 std::atomic_size_t allocationsCount{0};
+std::atomic_size_t allocatedMemoryTotal{0};
 std::unordered_map<void*, size_t> memoryIndex;
 std::atomic_bool suppresIndexing{false};
 std::atomic_bool active{false};
 std::mutex indexMutex;
 
+constexpr int maxStackDepth = 32;
+using Stack = std::vector<void*>;
+std::atomic_size_t sampleInterval{0};
+std::atomic_size_t sampleCounter{0};
+std::map<std::string, AllocationIndex::PhaseStatistics, std::less<>> phaseStatistics;
+std::map<std::pair<std::string, Stack>, AllocationIndex::PhaseStatistics> samples;
+
 class FlagGuard {
 public:
     explicit FlagGuard(std::atomic_bool& flag_)
@@ -30,6 +50,7 @@ void addToIndex(std::size_t sz, void* ptr) {
     std::lock_guard<std::mutex> mlk(indexMutex);
     FlagGuard flk(suppresIndexing);
     allocationsCount++;
+    allocatedMemoryTotal += sz;
     indexedMemorySize += sz;
     if (indexedMemoryPeak < indexedMemorySize) indexedMemoryPeak = size_t(indexedMemorySize);
     memoryIndex[ptr] = sz;
@@ -50,6 +71,60 @@ inline bool canModifyIndex() {
     return active && !suppresIndexing;
 }
 
+void addToProfile(std::size_t sz) {
+    const std::size_t interval = sampleInterval;
+    if (!interval) return;
+    const bool sampled = sampleCounter++ % interval == 0;
+
+    void* frames[maxStackDepth];
+    int depth = 0;
+#ifdef MBGL_ALLOCATION_STACKS
+    if (sampled) depth = backtrace(frames, maxStackDepth);
+#endif
+    const char* phase = mbgl::util::Phase::current();
+    if (!phase) phase = "other";
+
+    std::lock_guard<std::mutex> mlk(indexMutex);
+    FlagGuard flk(suppresIndexing);
+    auto it = phaseStatistics.find(phase);
+    if (it == phaseStatistics.end()) it = phaseStatistics.emplace(phase, AllocationIndex::PhaseStatistics()).first;
+    it->second.allocations++;
+    it->second.bytes += sz;
+
+    if (sampled) {
+        auto& sample = samples[std::make_pair(std::string(phase), Stack(frames, frames + depth))];
+        sample.allocations += interval;
+        sample.bytes += sz * interval;
+    }
+}
+
+inline bool canProfile() {
+    return sampleInterval && !suppresIndexing;
+}
+
+std::string symbolName(void* address) {
+    std::string name;
+#ifdef MBGL_ALLOCATION_STACKS
+    Dl_info info;
+    if (dladdr(address, &info) && info.dli_sname) {
+        int status = 0;
+        char* demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+        name = status == 0 && demangled ? demangled : info.dli_sname;
+        std::free(demangled);
+    }
+#endif
+    if (name.empty()) {
+        std::ostringstream stream;
+        stream << address;
+        name = stream.str();
+    }
+    // Semicolons separate the frames of the folded format.
+    for (char& c : name) {
+        if (c == ';') c = ':';
+    }
+    return name;
+}
+
 } // namespace
 
 // static
@@ -69,6 +144,7 @@ void AllocationIndex::reset() {
     memoryIndex.clear();
     indexedMemorySize = 0;
     allocationsCount = 0;
+    allocatedMemoryTotal = 0;
     indexedMemoryPeak = 0;
 }
 
@@ -76,6 +152,7 @@ void AllocationIndex::reset() {
 void* AllocationIndex::allocate(size_t size) {
     void *ptr = std::malloc(size);
     if (ptr && canModifyIndex()) addToIndex(size, ptr);
+    if (ptr && canProfile()) addToProfile(size);
     return ptr;
 }
 
@@ -95,7 +172,72 @@ size_t AllocationIndex::getAllocationsCount() {
     return allocationsCount;
 }
 
+// static
+size_t AllocationIndex::getAllocatedSizeTotal() {
+    return allocatedMemoryTotal;
+}
+
 // static
 size_t AllocationIndex::getAllocatedSizePeak() {
     return indexedMemoryPeak;
 }
+
+// static
+void AllocationIndex::setProfiling(size_t sampleInterval_) {
+    sampleInterval = sampleInterval_;
+}
+
+// static
+void AllocationIndex::resetProfile() {
+    std::lock_guard<std::mutex> mlk(indexMutex);
+    FlagGuard flk(suppresIndexing);
+    phaseStatistics.clear();
+    samples.clear();
+    sampleCounter = 0;
+}
+
+// static
+std::map<std::string, AllocationIndex::PhaseStatistics> AllocationIndex::getPhaseStatistics() {
+    std::lock_guard<std::mutex> mlk(indexMutex);
+    FlagGuard flk(suppresIndexing);
+    return {phaseStatistics.begin(), phaseStatistics.end()};
+}
+
+// static
+std::string AllocationIndex::exportFlameGraph() {
+    std::lock_guard<std::mutex> mlk(indexMutex);
+    FlagGuard flk(suppresIndexing);
+
+    std::unordered_map<void*, std::string> names;
+    auto nameOf = [&](void* address) -> const std::string& {
+        auto it = names.find(address);
+        if (it == names.end()) it = names.emplace(address, symbolName(address)).first;
+        return it->second;
+    };
+
+    std::map<std::string, size_t> folded;
+    for (const auto& sample : samples) {
+        const Stack& stack = sample.first.second;
+        // Drops the frames of the profiler itself, up to and including operator new.
+        std::size_t first = 0;
+        for (std::size_t i = 0; i < stack.size(); ++i) {
+            if (nameOf(stack[i]).compare(0, 12, "operator new") == 0) {
+                first = i + 1;
+                break;
+            }
+        }
+
+        std::string line = sample.first.first;
+        for (std::size_t i = stack.size(); i > first; --i) {
+            line += ';';
+            line += nameOf(stack[i - 1]);
+        }
+        folded[line] += sample.second.bytes;
+    }
+
+    std::ostringstream stream;
+    for (const auto& entry : folded) {
+        stream << entry.first << ' ' << entry.second << '\n';
+    }
+    return stream.str();
+}
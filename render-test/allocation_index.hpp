@@ -1,6 +1,8 @@
 #pragma once
 
 #include <cstddef>
+#include <map>
+#include <string>
 
 class AllocationIndex {
 public:
@@ -44,10 +46,51 @@ public:
      */
     static size_t getAllocationsCount();
 
+    /**
+     * @brief Returns the total size (in bytes) of all allocations since indexing start,
+     * including the ones that were freed since.
+     *
+     * @return size_t
+     */
+    static size_t getAllocatedSizeTotal();
+
     /**
      * @brief Returns the maximum size (in bytes) of the allocated data in the index, since last `reset()` call.
      * 
      * @return size_t 
      */
     static size_t getAllocatedSizePeak();
+
+    struct PhaseStatistics {
+        size_t allocations = 0;
+        size_t bytes = 0;
+    };
+
+    /**
+     * @brief Starts/stops allocation profiling. While profiling, every allocation is
+     * attributed to the current `mbgl::util::Phase`, and the call stack of every
+     * `sampleInterval`-th allocation is recorded. Profiling is independent of indexing,
+     * and a zero interval stops it.
+     */
+    static void setProfiling(size_t sampleInterval);
+    /**
+     * @brief Discards the profile.
+     */
+    static void resetProfile();
+    /**
+     * @brief Returns the allocations of each phase since profiling start. Allocations
+     * outside of any phase are listed as "other".
+     *
+     * @return std::map<std::string, PhaseStatistics>
+     */
+    static std::map<std::string, PhaseStatistics> getPhaseStatistics();
+    /**
+     * @brief Returns the sampled call stacks in the folded format of flame graph tools
+     * (`phase;outermost;...;innermost bytes` lines), with the bytes scaled by the sample
+     * interval. Symbols are only resolved for exported functions, so executables should
+     * be linked with `-rdynamic`.
+     *
+     * @return std::string
+     */
+    static std::string exportFlameGraph();
 };
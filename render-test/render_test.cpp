@@ -43,7 +43,8 @@ void operator delete(void* ptr, size_t) noexcept {
 
 namespace {
 
-using ArgumentsTuple = std::tuple<bool, bool, bool, uint32_t, std::string, TestRunner::UpdateResults, std::string>;
+using ArgumentsTuple =
+    std::tuple<bool, bool, bool, uint32_t, std::string, TestRunner::UpdateResults, std::string, std::string, uint32_t>;
 ArgumentsTuple parseArguments(int argc, char** argv) {
     const static std::unordered_map<std::string, TestRunner::UpdateResults> updateResultsFlags = {
         {"default", TestRunner::UpdateResults::DEFAULT},
@@ -63,6 +64,16 @@ ArgumentsTuple parseArguments(int argc, char** argv) {
     args::ValueFlag<std::string> testPathValue(
         argumentParser, "manifestPath", "Test manifest file path", {'p', "manifestPath"}, args::Options::Required);
     args::ValueFlag<std::string> testFilterValue(argumentParser, "filter", "Test filter regex", {'f', "filter"});
+    args::ValueFlag<std::string> allocationProfileValue(
+        argumentParser,
+        "allocationProfile",
+        "Profiles the allocations of all tests and writes a flame graph of them to the given path",
+        {"allocation-profile"});
+    args::ValueFlag<uint32_t> allocationSampleIntervalValue(
+        argumentParser,
+        "interval",
+        "Records the call stack of every n-th allocation while profiling (default: 100)",
+        {"allocation-sample-interval"});
     args::MapFlag<std::string, TestRunner::UpdateResults> testUpdateResultsValue(
         argumentParser,
         "update",
@@ -108,13 +119,18 @@ ArgumentsTuple parseArguments(int argc, char** argv) {
     const auto seed = seedValue ? args::get(seedValue) : 1u;
     TestRunner::UpdateResults updateResults =
         testUpdateResultsValue ? args::get(testUpdateResultsValue) : TestRunner::UpdateResults::NO;
+    auto allocationProfile = allocationProfileValue ? args::get(allocationProfileValue) : std::string{};
+    const auto allocationSampleInterval =
+        allocationSampleIntervalValue ? std::max(args::get(allocationSampleIntervalValue), 1u) : 100u;
     return ArgumentsTuple{recycleMapFlag ? args::get(recycleMapFlag) : false,
                           shuffle,
                           online,
                           seed,
                           manifestPath.string(),
                           updateResults,
-                          std::move(testFilter)};
+                          std::move(testFilter),
+                          std::move(allocationProfile),
+                          allocationSampleInterval};
 }
 } // namespace
 namespace mbgl {
@@ -127,11 +143,21 @@ int runRenderTests(int argc, char** argv, std::function<void()> testStatus) {
     uint32_t seed;
     std::string manifestPath;
     std::string testFilter;
+    std::string allocationProfile;
+    uint32_t allocationSampleInterval;
 
     Log::useLogThread(false);
     TestRunner::UpdateResults updateResults;
 
-    std::tie(recycleMap, shuffle, online, seed, manifestPath, updateResults, testFilter) = parseArguments(argc, argv);
+    std::tie(recycleMap,
+             shuffle,
+             online,
+             seed,
+             manifestPath,
+             updateResults,
+             testFilter,
+             allocationProfile,
+             allocationSampleInterval) = parseArguments(argc, argv);
 
     ProxyFileSource::setOffline(!online);
 
@@ -156,6 +182,10 @@ int runRenderTests(int argc, char** argv, std::function<void()> testStatus) {
 
     TestStatistics stats;
 
+    if (!allocationProfile.empty()) {
+        AllocationIndex::setProfiling(allocationSampleInterval);
+    }
+
     for (auto& testPath : testPaths) {
         TestMetadata metadata = parseTestMetadata(testPath);
 
@@ -241,6 +271,18 @@ int runRenderTests(int argc, char** argv, std::function<void()> testStatus) {
         }
     }
 
+    if (!allocationProfile.empty()) {
+        AllocationIndex::setProfiling(0);
+        for (const auto& phase : AllocationIndex::getPhaseStatistics()) {
+            printf("Allocations in %s: %zu (%zu bytes)\n",
+                   phase.first.c_str(),
+                   phase.second.allocations,
+                   phase.second.bytes);
+        }
+        mbgl::util::write_file(allocationProfile, AllocationIndex::exportFlameGraph());
+        printf("Allocation flame graph at: %s\n", allocationProfile.c_str());
+    }
+
     const std::string manifestName = mbgl::filesystem::path(manifestPath).stem();
     const std::string resultPath = manifest.getResultPath() + "/" + manifestName + ".html";
     std::string resultsHTML = createResultPage(stats, metadatas, shuffle, seed);
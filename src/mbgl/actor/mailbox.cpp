@@ -3,63 +3,117 @@
 #include <mbgl/actor/scheduler.hpp>
 
 #include <cassert>
+#include <thread>
 
 namespace mbgl {
 
-Mailbox::Mailbox() = default;
+namespace {
 
-Mailbox::Mailbox(Scheduler& scheduler_) : weakScheduler(scheduler_.makeWeakPtr()) {}
+class StubMessage final : public Message {
+public:
+    void operator()() override { assert(false); }
+};
+
+} // namespace
+
+Mailbox::Mailbox()
+    : pushers(0u),
+      pushingBlocked(false),
+      closed(false),
+      priority(TaskPriority::Default),
+      tag(TaskTag::Untagged),
+      queueStub(std::make_unique<StubMessage>()),
+      queueHead(queueStub.get()),
+      queueTail(queueStub.get()),
+      queueSize(0u) {}
+
+Mailbox::Mailbox(Scheduler& scheduler_) : Mailbox() {
+    weakScheduler = scheduler_.makeWeakPtr();
+}
+
+Mailbox::~Mailbox() {
+    for (; queueSize > 0u; --queueSize) {
+        delete dequeue();
+    }
+}
 
 void Mailbox::open(Scheduler& scheduler_) {
     assert(!weakScheduler);
 
-    // As with close(), block until neither receive() nor push() are in progress, and acquire the two
-    // mutexes in the same order.
+    // As with close(), block until neither receive() nor push() are in progress.
     std::lock_guard<std::recursive_mutex> receivingLock(receivingMutex);
-    std::lock_guard<std::mutex> pushingLock(pushingMutex);
+    blockPushing();
 
     weakScheduler = scheduler_.makeWeakPtr();
 
-    if (closed) {
-        return;
-    }
-    
-    if (!queue.empty()) {
+    if (!closed && queueSize > 0u) {
         auto guard = weakScheduler.lock();
-        if (weakScheduler) weakScheduler->schedule(makeClosure(shared_from_this()));
+        if (weakScheduler) weakScheduler->scheduleTagged(tag, priority, makeClosure(shared_from_this()));
     }
+
+    unblockPushing();
 }
 
 void Mailbox::close() {
-    // Block until neither receive() nor push() are in progress. Two mutexes are used because receive()
-    // must not block send(). Of the two, the receiving mutex must be acquired first, because that is
-    // the order that an actor will obtain them when it self-sends a message, and consistent lock
-    // acquisition order prevents deadlocks.
-    // The receiving mutex is recursive to allow a mailbox (and thus the actor) to close itself.
+    // Block until neither receive() nor push() are in progress. The receiving mutex must
+    // be acquired first to keep the lock acquisition order of an actor self-sending a message.
     std::lock_guard<std::recursive_mutex> receivingLock(receivingMutex);
-    std::lock_guard<std::mutex> pushingLock(pushingMutex);
+    blockPushing();
 
     closed = true;
+
+    unblockPushing();
 }
 
 bool Mailbox::isOpen() const {
     return bool(weakScheduler);
 }
 
-void Mailbox::push(std::unique_ptr<Message> message) {
-    std::lock_guard<std::mutex> pushingLock(pushingMutex);
+void Mailbox::setPriority(TaskPriority priority_) {
+    priority = priority_;
+}
 
-    if (closed) {
-        return;
+void Mailbox::setTag(TaskTag tag_) {
+    tag = tag_;
+}
+
+void Mailbox::blockPushing() {
+    bool expected = false;
+    while (!pushingBlocked.compare_exchange_weak(expected, true)) {
+        expected = false;
+        std::this_thread::yield();
+    }
+    while (pushers > 0u) {
+        std::this_thread::yield();
     }
+}
 
-    std::lock_guard<std::mutex> queueLock(queueMutex);
-    bool wasEmpty = queue.empty();
-    queue.push(std::move(message));
-    auto guard = weakScheduler.lock();
-    if (wasEmpty && weakScheduler) {
-        weakScheduler->schedule(makeClosure(shared_from_this()));
+void Mailbox::unblockPushing() {
+    pushingBlocked = false;
+}
+
+void Mailbox::push(std::unique_ptr<Message> message) {
+    // Announce the push first and only then check whether pushing is blocked; blockPushing()
+    // does the same in the reverse order, so one of the two always sees the other.
+    ++pushers;
+    while (pushingBlocked) {
+        --pushers;
+        while (pushingBlocked) {
+            std::this_thread::yield();
+        }
+        ++pushers;
+    }
+
+    if (!closed) {
+        enqueue(message.release());
+        bool wasEmpty = queueSize++ == 0u;
+        auto guard = weakScheduler.lock();
+        if (wasEmpty && weakScheduler) {
+            weakScheduler->scheduleTagged(tag, priority, makeClosure(shared_from_this()));
+        }
     }
+
+    --pushers;
 }
 
 void Mailbox::receive() {
@@ -72,21 +126,59 @@ void Mailbox::receive() {
         return;
     }
 
-    std::unique_ptr<Message> message;
-    bool wasEmpty;
-
-    {
-        std::lock_guard<std::mutex> queueLock(queueMutex);
-        assert(!queue.empty());
-        message = std::move(queue.front());
-        queue.pop();
-        wasEmpty = queue.empty();
-    }
+    std::unique_ptr<Message> message(dequeue());
 
     (*message)();
 
+    bool wasEmpty = --queueSize == 0u;
     if (!wasEmpty) {
-        weakScheduler->schedule(makeClosure(shared_from_this()));
+        weakScheduler->scheduleTagged(tag, priority, makeClosure(shared_from_this()));
+    }
+}
+
+void Mailbox::enqueue(Message* message) {
+    message->next.store(nullptr, std::memory_order_relaxed);
+    Message* prev = queueHead.exchange(message, std::memory_order_acq_rel);
+    prev->next.store(message, std::memory_order_release);
+}
+
+Message* Mailbox::dequeue() {
+    assert(queueSize > 0u);
+    // A counted message has always been swapped into `queueHead`, but a concurrent pusher
+    // that got ahead of it may not have linked its predecessor yet, so retry until it did.
+    while (true) {
+        Message* tail = queueTail;
+        Message* next = tail->next.load(std::memory_order_acquire);
+
+        if (tail == queueStub.get()) {
+            if (!next) {
+                std::this_thread::yield();
+                continue;
+            }
+            queueTail = next;
+            tail = next;
+            next = next->next.load(std::memory_order_acquire);
+        }
+
+        if (next) {
+            queueTail = next;
+            return tail;
+        }
+
+        if (tail != queueHead.load(std::memory_order_acquire)) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        // `tail` is the last message; put the stub behind it so that it can be detached.
+        enqueue(queueStub.get());
+
+        next = tail->next.load(std::memory_order_acquire);
+        if (next) {
+            queueTail = next;
+            return tail;
+        }
+        std::this_thread::yield();
     }
 }
 
@@ -0,0 +1,90 @@
+#include <mbgl/actor/message.hpp>
+
+#include <new>
+
+namespace mbgl {
+
+namespace {
+
+// Most messages bind a few pointers or shared pointers, which fit into blocks of this size.
+constexpr std::size_t pooledMessageSize = 128;
+// Caps the memory each thread keeps for reuse.
+constexpr std::size_t maxPooledMessages = 256;
+
+// The blocks of destroyed messages, kept by the thread that destroyed them. Mailboxes are usually
+// drained by one thread, and the replies to their messages flow back the other way, so the blocks
+// a thread frees are the ones it allocates next.
+class MessagePool {
+public:
+    ~MessagePool() {
+        destroyed = true;
+        while (head) {
+            Block* block = head;
+            head = head->next;
+            ::operator delete(block);
+        }
+    }
+
+    void* take() {
+        if (!head) {
+            return nullptr;
+        }
+        Block* block = head;
+        head = head->next;
+        --size;
+        return block;
+    }
+
+    bool put(void* pointer) {
+        if (size == maxPooledMessages) {
+            return false;
+        }
+        head = new (pointer) Block{head};
+        ++size;
+        return true;
+    }
+
+    // Messages can still be destroyed while the thread exits, after its pool is gone.
+    static thread_local bool destroyed;
+
+private:
+    struct Block {
+        Block* next;
+    };
+
+    Block* head = nullptr;
+    std::size_t size = 0;
+};
+
+thread_local bool MessagePool::destroyed = false;
+
+MessagePool& pool() {
+    static thread_local MessagePool messagePool;
+    return messagePool;
+}
+
+} // namespace
+
+void* Message::operator new(std::size_t size) {
+    if (size <= pooledMessageSize) {
+        if (!MessagePool::destroyed) {
+            if (void* pointer = pool().take()) {
+                return pointer;
+            }
+        }
+        return ::operator new(pooledMessageSize);
+    }
+    return ::operator new(size);
+}
+
+void Message::operator delete(void* pointer, std::size_t size) noexcept {
+    if (!pointer) {
+        return;
+    }
+    if (size <= pooledMessageSize && !MessagePool::destroyed && pool().put(pointer)) {
+        return;
+    }
+    ::operator delete(pointer);
+}
+
+} // namespace mbgl
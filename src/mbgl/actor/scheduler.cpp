@@ -26,8 +26,46 @@ Scheduler* Scheduler::GetCurrent() {
     return current().get();
 }
 
+// The scheduler GetBackground() returns on this thread instead of the shared pool.
+static auto& background() {
+    static thread_local std::weak_ptr<Scheduler> scheduler;
+    return scheduler;
+}
+
+// static
+void Scheduler::SetBackground(std::weak_ptr<Scheduler> scheduler) {
+    background() = std::move(scheduler);
+}
+
+// The priority of the task running on this thread.
+static auto& currentPriority() {
+    static thread_local TaskPriority priority = TaskPriority::Default;
+    return priority;
+}
+
+// static
+TaskPriority Scheduler::GetCurrentPriority() {
+    return currentPriority();
+}
+
+// static
+void Scheduler::SetCurrentPriority(TaskPriority priority) {
+    currentPriority() = priority;
+}
+
+// static
+std::shared_ptr<Scheduler> Scheduler::MakeThreadPool(const ThreadPoolOptions& options) {
+    auto pool = std::make_shared<ThreadPool>(options);
+    pool->setWorkerBackground(pool);
+    return pool;
+}
+
 // static
 PassRefPtr<Scheduler> Scheduler::GetBackground() {
+    if (std::shared_ptr<Scheduler> assigned = background().lock()) {
+        return PassRefPtr<Scheduler>(std::move(assigned));
+    }
+
     static std::weak_ptr<Scheduler> weak;
     static std::mutex mtx;
 
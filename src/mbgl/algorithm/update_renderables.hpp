@@ -23,6 +23,7 @@ void updateRenderables(GetTileFn getTile,
                        const Range<uint8_t>& zoomRange,
                        const optional<uint8_t>& maxParentOverscaleFactor = nullopt) {
     std::unordered_set<OverscaledTileID> checked;
+    std::unordered_set<OverscaledTileID> labelParents;
     bool covered;
     int32_t overscaledZ;
 
@@ -44,9 +45,34 @@ void updateRenderables(GetTileFn getTile,
         }
 
         // if (source has the tile and bucket is loaded) {
-        if (tile->isRenderable()) {
+        if (tile->isReadyToRender()) {
             retainTile(*tile, TileNecessity::Required);
             renderTile(idealRenderTileID, *tile);
+
+            if (tile->isPartial()) {
+                // The tile doesn't have its symbols yet. Render the closest parent tile that is
+                // ready as well, which keeps its labels until the symbols of the tile are laid
+                // out, while its other layers are clipped to the area that the tile doesn't cover.
+                for (overscaledZ = idealDataTileID.overscaledZ - 1; overscaledZ >= zoomRange.min; --overscaledZ) {
+                    if (maxParentOverscaleFactor &&
+                        (idealDataTileID.overscaledZ - overscaledZ) > *maxParentOverscaleFactor) {
+                        break;
+                    }
+
+                    const auto parentDataTileID = idealDataTileID.scaledTo(overscaledZ);
+                    if (!labelParents.emplace(parentDataTileID).second) {
+                        // Another partial tile rendered this parent, or found none ready above it.
+                        break;
+                    }
+
+                    auto parent = getTile(parentDataTileID);
+                    if (parent && parent->isReadyToRender()) {
+                        retainTile(*parent, TileNecessity::Optional);
+                        renderTile(parentDataTileID.toUnwrapped(), *parent);
+                        break;
+                    }
+                }
+            }
         } else {
             // We are now attempting to load child and parent tiles.
             bool parentHasTriedOptional = tile->hasTriedCache();
@@ -60,7 +86,7 @@ void updateRenderables(GetTileFn getTile,
                 // We're looking for an overzoomed child tile.
                 const auto childDataTileID = idealDataTileID.scaledTo(overscaledZ);
                 tile = getTile(childDataTileID);
-                if (tile && tile->isRenderable()) {
+                if (tile && tile->isReadyToRender()) {
                     retainTile(*tile, TileNecessity::Optional);
                     renderTile(idealRenderTileID, *tile);
                 } else {
@@ -71,7 +97,7 @@ void updateRenderables(GetTileFn getTile,
                 for (const auto& childTileID : idealDataTileID.canonical.children()) {
                     const OverscaledTileID childDataTileID(overscaledZ, idealRenderTileID.wrap, childTileID);
                     tile = getTile(childDataTileID);
-                    if (tile && tile->isRenderable()) {
+                    if (tile && tile->isReadyToRender()) {
                         retainTile(*tile, TileNecessity::Optional);
                         renderTile(childDataTileID.toUnwrapped(), *tile);
                     } else {
@@ -122,7 +148,7 @@ void updateRenderables(GetTileFn getTile,
                         parentHasTriedOptional = tile->hasTriedCache();
                         parentIsLoaded = tile->isLoaded();
 
-                        if (tile->isRenderable()) {
+                        if (tile->isReadyToRender()) {
                             renderTile(parentDataTileID.toUnwrapped(), *tile);
                             // Break parent tile ascent, since we found one.
                             break;
@@ -11,6 +11,9 @@
 #include <mbgl/style/layers/symbol_layer_impl.hpp>
 #include <mbgl/style/style.hpp>
 #include <mbgl/style/style_impl.hpp>
+#include <mbgl/math/clamp.hpp>
+
+#include <mapbox/geometry/envelope.hpp>
 
 #include <boost/function_output_iterator.hpp>
 
@@ -27,6 +30,50 @@ namespace mbgl {
 
 using namespace style;
 
+namespace {
+
+LatLngBounds symbolTileBounds(const CanonicalTileID& tileID) {
+    LatLngBounds tileBounds(tileID);
+    // Hack for https://github.com/mapbox/mapbox-gl-native/issues/12472
+    // To handle precision issues, query a slightly larger area than the tile bounds
+    // Symbols at a border can be included in vector data for both tiles
+    // The rendering/querying logic will make sure the symbols show up in only one of the tiles
+    tileBounds.extend(LatLng(tileBounds.south() - 0.000000001, tileBounds.west() - 0.000000001));
+    tileBounds.extend(LatLng(tileBounds.north() + 0.000000001, tileBounds.east() + 0.000000001));
+    return tileBounds;
+}
+
+// The buffer of shape tiles is less than a tile, so the bounds of the neighbouring tiles cover it.
+LatLngBounds shapeTileBounds(const CanonicalTileID& tileID) {
+    LatLngBounds tileBounds(tileID);
+    const double width = tileBounds.east() - tileBounds.west();
+    const uint32_t maxY = (1u << tileID.z) - 1;
+    const double north = tileID.y > 0 ? LatLngBounds(CanonicalTileID(tileID.z, tileID.x, tileID.y - 1)).north()
+                                      : tileBounds.north();
+    const double south = tileID.y < maxY ? LatLngBounds(CanonicalTileID(tileID.z, tileID.x, tileID.y + 1)).south()
+                                         : tileBounds.south();
+    return LatLngBounds::hull(LatLng(south, tileBounds.west() - width), LatLng(north, tileBounds.east() + width));
+}
+
+// Shapes are wrapped around the antimeridian when they are tiled, so copies one world away count too.
+bool overlapsShape(const LatLngBounds& tileBounds, const LatLngBounds& shapeBounds) {
+    if (shapeBounds.north() < tileBounds.south() || shapeBounds.south() > tileBounds.north()) {
+        return false;
+    }
+    for (const double offset : {0.0, -util::DEGREES_MAX, util::DEGREES_MAX}) {
+        if (shapeBounds.east() + offset >= tileBounds.west() && shapeBounds.west() + offset <= tileBounds.east()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+LatLng toLatLng(const Point<double>& point) {
+    return LatLng(util::clamp(point.y, -util::LATITUDE_MAX, util::LATITUDE_MAX), point.x);
+}
+
+} // namespace
+
 const std::string AnnotationManager::SourceID = "com.mapbox.annotations";
 const std::string AnnotationManager::PointLayerID = "com.mapbox.annotations.points";
 const std::string AnnotationManager::ShapeLayerID = "com.mapbox.annotations.shape.";
@@ -74,22 +121,50 @@ void AnnotationManager::removeAnnotation(const AnnotationID& id) {
     dirty = true;
 }
 
+AnnotationIDs AnnotationManager::addAnnotations(const std::vector<Annotation>& annotations) {
+    CHECK_ANNOTATIONS_ENABLED_AND_RETURN(AnnotationIDs());
+    std::lock_guard<std::mutex> lock(mutex);
+    AnnotationIDs ids;
+    ids.reserve(annotations.size());
+    for (const auto& annotation : annotations) {
+        AnnotationID id = nextID++;
+        Annotation::visit(annotation, [&] (const auto& annotation_) {
+            this->add(id, annotation_);
+        });
+        ids.push_back(id);
+    }
+    dirty = true;
+    return ids;
+}
+
+void AnnotationManager::removeAnnotations(const AnnotationIDs& ids) {
+    CHECK_ANNOTATIONS_ENABLED_AND_RETURN();
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto& id : ids) {
+        remove(id);
+    }
+    dirty = true;
+}
+
 void AnnotationManager::add(const AnnotationID& id, const SymbolAnnotation& annotation) {
     auto impl = std::make_shared<SymbolAnnotationImpl>(id, annotation);
     symbolTree.insert(impl);
     symbolAnnotations.emplace(id, impl);
+    invalidateTiles(annotation.geometry);
 }
 
 void AnnotationManager::add(const AnnotationID& id, const LineAnnotation& annotation) {
     ShapeAnnotationImpl& impl = *shapeAnnotations.emplace(id,
         std::make_unique<LineAnnotationImpl>(id, annotation)).first->second;
     impl.updateStyle(*style.get().impl);
+    invalidateTiles(impl);
 }
 
 void AnnotationManager::add(const AnnotationID& id, const FillAnnotation& annotation) {
     ShapeAnnotationImpl& impl = *shapeAnnotations.emplace(id,
         std::make_unique<FillAnnotationImpl>(id, annotation)).first->second;
     impl.updateStyle(*style.get().impl);
+    invalidateTiles(impl);
 }
 
 void AnnotationManager::update(const AnnotationID& id, const SymbolAnnotation& annotation) {
@@ -116,6 +191,7 @@ void AnnotationManager::update(const AnnotationID& id, const LineAnnotation& ann
         return;
     }
 
+    invalidateTiles(*it->second);
     shapeAnnotations.erase(it);
     add(id, annotation);
     dirty = true;
@@ -128,6 +204,7 @@ void AnnotationManager::update(const AnnotationID& id, const FillAnnotation& ann
         return;
     }
 
+    invalidateTiles(*it->second);
     shapeAnnotations.erase(it);
     add(id, annotation);
     dirty = true;
@@ -136,10 +213,12 @@ void AnnotationManager::update(const AnnotationID& id, const FillAnnotation& ann
 void AnnotationManager::remove(const AnnotationID& id) {
     CHECK_ANNOTATIONS_ENABLED_AND_RETURN();
     if (symbolAnnotations.find(id) != symbolAnnotations.end()) {
+        invalidateTiles(symbolAnnotations.at(id)->annotation.geometry);
         symbolTree.remove(symbolAnnotations.at(id));
         symbolAnnotations.erase(id);
     } else if (shapeAnnotations.find(id) != shapeAnnotations.end()) {
         auto it = shapeAnnotations.find(id);
+        invalidateTiles(*it->second);
         *style.get().impl->removeLayer(it->second->layerID);
         shapeAnnotations.erase(it);
     } else {
@@ -155,14 +234,7 @@ std::unique_ptr<AnnotationTileData> AnnotationManager::getTileData(const Canonic
 
     auto pointLayer = tileData->addLayer(PointLayerID);
 
-    LatLngBounds tileBounds(tileID);
-    // Hack for https://github.com/mapbox/mapbox-gl-native/issues/12472
-    // To handle precision issues, query a slightly larger area than the tile bounds
-    // Symbols at a border can be included in vector data for both tiles
-    // The rendering/querying logic will make sure the symbols show up in only one of the tiles
-    tileBounds.extend(LatLng(tileBounds.south() - 0.000000001, tileBounds.west() - 0.000000001));
-    tileBounds.extend(LatLng(tileBounds.north() + 0.000000001, tileBounds.east() + 0.000000001));
-    
+    const LatLngBounds tileBounds = symbolTileBounds(tileID);
     symbolTree.query(boost::geometry::index::intersects(tileBounds),
         boost::make_function_output_iterator([&](const auto& val){
             val->updateLayer(tileID, *pointLayer);
@@ -214,24 +286,48 @@ void AnnotationManager::updateData() {
     CHECK_ANNOTATIONS_ENABLED_AND_RETURN();
     std::lock_guard<std::mutex> lock(mutex);
     if (dirty) {
-        for (auto& tile : tiles) {
+        // Only the tiles that include a changed annotation are laid out again.
+        for (auto& tile : dirtyTiles) {
             tile->setData(getTileData(tile->id.canonical));
         }
+        dirtyTiles.clear();
         dirty = false;
     }
 }
 
+void AnnotationManager::invalidateTiles(const Point<double>& symbol) {
+    const LatLng position = toLatLng(symbol);
+    for (const auto& tile : tiles) {
+        if (tile.second.symbols.contains(position)) {
+            dirtyTiles.insert(tile.first);
+        }
+    }
+}
+
+void AnnotationManager::invalidateTiles(const ShapeAnnotationImpl& shape) {
+    const auto envelope = ShapeAnnotationGeometry::visit(
+        shape.geometry(), [](const auto& geometry) { return mapbox::geometry::envelope(geometry); });
+    const auto bounds = LatLngBounds::hull(toLatLng(envelope.min), toLatLng(envelope.max));
+    for (const auto& tile : tiles) {
+        if (overlapsShape(tile.second.shapes, bounds)) {
+            dirtyTiles.insert(tile.first);
+        }
+    }
+}
+
 void AnnotationManager::addTile(AnnotationTile& tile) {
     CHECK_ANNOTATIONS_ENABLED_AND_RETURN();
     std::lock_guard<std::mutex> lock(mutex);
-    tiles.insert(&tile);
-    tile.setData(getTileData(tile.id.canonical));
+    const CanonicalTileID& tileID = tile.id.canonical;
+    tiles.emplace(&tile, TileBounds{symbolTileBounds(tileID), shapeTileBounds(tileID)});
+    tile.setData(getTileData(tileID));
 }
 
 void AnnotationManager::removeTile(AnnotationTile& tile) {
     CHECK_ANNOTATIONS_ENABLED_AND_RETURN();
     std::lock_guard<std::mutex> lock(mutex);
     tiles.erase(&tile);
+    dirtyTiles.erase(&tile);
 }
 
 // To ensure that annotation images do not collide with images from the style,
@@ -3,6 +3,7 @@
 #include <mbgl/annotation/annotation.hpp>
 #include <mbgl/annotation/symbol_annotation_impl.hpp>
 #include <mbgl/style/image.hpp>
+#include <mbgl/util/geo.hpp>
 #include <mbgl/util/noncopyable.hpp>
 
 #include <mutex>
@@ -15,7 +16,6 @@
 
 namespace mbgl {
 
-class LatLngBounds;
 class AnnotationTile;
 class AnnotationTileData;
 class SymbolAnnotationImpl;
@@ -34,6 +34,10 @@ public:
     bool updateAnnotation(const AnnotationID&, const Annotation&);
     void removeAnnotation(const AnnotationID&);
 
+    // Adds or removes all the annotations under a single lock and a single update.
+    AnnotationIDs addAnnotations(const std::vector<Annotation>&);
+    void removeAnnotations(const AnnotationIDs&);
+
     void addImage(std::unique_ptr<style::Image>);
     void removeImage(const std::string&);
     double getTopOffsetPixelsForImage(const std::string&);
@@ -63,6 +67,10 @@ private:
 
     void remove(const AnnotationID&);
 
+    // Marks the tiles whose data includes the area for reloading by updateData().
+    void invalidateTiles(const Point<double>& symbol);
+    void invalidateTiles(const ShapeAnnotationImpl&);
+
     void updateStyle();
 
     std::unique_ptr<AnnotationTileData> getTileData(const CanonicalTileID&);
@@ -87,7 +95,14 @@ private:
     ShapeAnnotationMap shapeAnnotations;
     ImageMap images;
 
-    std::unordered_set<AnnotationTile*> tiles;
+    // The areas whose annotations are included in the data of each tile. Shapes are also included
+    // in the buffer of the neighbouring tiles.
+    struct TileBounds {
+        LatLngBounds symbols;
+        LatLngBounds shapes;
+    };
+    std::unordered_map<AnnotationTile*, TileBounds> tiles;
+    std::unordered_set<AnnotationTile*> dirtyTiles;
     mapbox::base::WeakPtrFactory<AnnotationManager> weakFactory{this};
 };
 
@@ -41,7 +41,8 @@ void RenderAnnotationSource::update(Immutable<style::Source::Impl> baseImpl_,
         optional<LatLngBounds>{},
         [&](const OverscaledTileID& tileID) { return std::make_unique<AnnotationTile>(tileID, parameters); },
         baseImpl->getPrefetchZoomDelta(),
-        baseImpl->getMaxOverscaleFactorForParentTiles());
+        baseImpl->getMaxOverscaleFactorForParentTiles(),
+        baseImpl->getMaxTileCacheBytes());
 }
 
 std::unordered_map<std::string, std::vector<Feature>>
@@ -1,33 +1,81 @@
 #include <mbgl/geometry/dem_data.hpp>
 #include <mbgl/math/clamp.hpp>
 
+#include <algorithm>
+#include <limits>
+
 namespace mbgl {
 
+namespace {
+
+// Heights are encoded as 24-bit values of `scale` meters above `-offset` meters.
+// https://www.mapbox.com/help/access-elevation-data/#mapbox-terrain-rgb
+// https://aws.amazon.com/public-datasets/terrain/
+double encodingScale(Tileset::DEMEncoding encoding) {
+    return encoding == Tileset::DEMEncoding::Terrarium ? 1.0 / 256.0 : 0.1;
+}
+
+double encodingOffset(Tileset::DEMEncoding encoding) {
+    return encoding == Tileset::DEMEncoding::Terrarium ? 32768.0 : 10000.0;
+}
+
+constexpr int64_t maxCode = std::numeric_limits<uint16_t>::max();
+
+// Neighboring tiles are backfilled with heights close to the ones at the edges of this tile,
+// but they can exceed its range. Codes cover at least this much above and below.
+constexpr double minBorderMargin = 1000.0;
+
+} // namespace
+
 DEMData::DEMData(const PremultipliedImage& _image, Tileset::DEMEncoding _encoding):
     dim(_image.size.height),
     // extra two pixels per row for border backfilling on either edge
     stride(dim + 2),
     encoding(_encoding),
-    image({ static_cast<uint32_t>(stride), static_cast<uint32_t>(stride) }) {
+    heights(static_cast<size_t>(stride) * stride) {
 
     if (_image.size.height != _image.size.width){
         throw std::runtime_error("raster-dem tiles must be square.");
     }
 
-    auto* dest = reinterpret_cast<uint32_t*>(image.data.get()) + stride + 1;
-    auto* source = reinterpret_cast<uint32_t*>(_image.data.get());
+    const uint8_t* source = _image.data.get();
+    const size_t pixels = static_cast<size_t>(dim) * dim;
+    auto value = [&](size_t i) -> int64_t {
+        return (source[i * 4] << 16) | (source[i * 4 + 1] << 8) | source[i * 4 + 2];
+    };
+
+    int64_t min = pixels ? value(0) : 0;
+    int64_t max = min;
+    for (size_t i = 1; i < pixels; i++) {
+        min = std::min(min, value(i));
+        max = std::max(max, value(i));
+    }
+
+    // The grid of codes is centered on the heights of the tile and leaves room for the borders
+    // of its neighbors. Steps are powers of two aligned to multiples of themselves, so that
+    // codes copied from a neighbor with the same or a coarser step are exact.
+    const double scale = encodingScale(encoding);
+    const int64_t margin = std::max(max - min, static_cast<int64_t>(minBorderMargin / scale));
+    const int64_t range = max - min + 2 * margin;
+    while (step * maxCode < range) {
+        step *= 2;
+    }
+    base = ((min + max) / 2 / step - maxCode / 2) * step;
+    unpack = {{ static_cast<float>(scale * step * 256), static_cast<float>(scale * step), 0.0f,
+                static_cast<float>(encodingOffset(encoding) - base * scale) }};
+
     for (int32_t y = 0; y < dim; y++) {
-        memcpy(dest, source, dim * 4);
-        dest += stride;
-        source += dim;
+        for (int32_t x = 0; x < dim; x++) {
+            heights[idx(x, y)] = encode(value(static_cast<size_t>(y) * dim + x));
+        }
     }
-    
+
     // in order to avoid flashing seams between tiles, here we are initially populating a 1px border of
     // pixels around the image with the data of the nearest pixel from the image. this data is eventually
     // replaced when the tile's neighboring tiles are loaded and the accurate data can be backfilled using
     // DEMData#backfillBorder
 
-    auto* data = reinterpret_cast<uint32_t*>(image.data.get());
+    auto* data = heights.data();
     for (int32_t x = 0; x < dim; x++) {
         auto rowOffset = stride * (x + 1);
         // left vertical border
@@ -38,9 +86,20 @@ DEMData::DEMData(const PremultipliedImage& _image, Tileset::DEMEncoding _encodin
     }
     
     // top horizontal border with corners
-    memcpy(data, data + stride, stride * 4);
+    std::copy(data + stride, data + 2 * stride, data);
     // bottom horizontal border with corners
-    memcpy(data + (dim + 1) * stride, data + dim * stride, stride * 4);
+    std::copy(data + dim * stride, data + (dim + 1) * stride, data + (dim + 1) * stride);
+}
+
+uint16_t DEMData::encode(const int64_t value) const {
+    if (value <= base) {
+        return 0;
+    }
+    return static_cast<uint16_t>(std::min((value - base + step / 2) / step, maxCode));
+}
+
+int64_t DEMData::decode(const uint16_t code) const {
+    return base + code * step;
 }
 
 // This function takes the DEMData from a neighboring tile and backfills the edge/corner
@@ -72,29 +131,43 @@ void DEMData::backfillBorder(const DEMData& borderTileData, int8_t dx, int8_t dy
     int32_t ox = -dx * dim;
     int32_t oy = -dy * dim;
     
-    auto* dest = reinterpret_cast<uint32_t*>(image.data.get());
-    auto* source = reinterpret_cast<uint32_t*>(o.image.data.get());
-
+    // The neighbor's codes are relative to its own grid.
     for (int32_t y = yMin; y < yMax; y++) {
         for (int32_t x = xMin; x < xMax; x++) {
-            dest[idx(x, y)] = source[idx(x + ox, y + oy)];
+            heights[idx(x, y)] = encode(o.decode(o.heights[idx(x + ox, y + oy)]));
         }
     }
 }
 
 int32_t DEMData::get(const int32_t x, const int32_t y) const {
-    const auto& unpack = getUnpackVector();
-    const uint8_t* value = image.data.get() + idx(x, y) * 4;
-    return value[0] * unpack[0] + value[1] * unpack[1] + value[2] * unpack[2] - unpack[3];
+    return static_cast<int32_t>(decode(heights[idx(x, y)]) * encodingScale(encoding) - encodingOffset(encoding));
 }
 
 const std::array<float, 4>& DEMData::getUnpackVector() const {
-    // https://www.mapbox.com/help/access-elevation-data/#mapbox-terrain-rgb
-    static const std::array<float, 4> unpackMapbox = {{ 6553.6, 25.6, 0.1, 10000.0 }};
-    // https://aws.amazon.com/public-datasets/terrain/
-    static const std::array<float, 4> unpackTerrarium = {{ 256.0, 1.0, 1.0 / 256.0, 32768.0 }};
+    return unpack;
+}
+
+PremultipliedImage DEMData::getImage() const {
+    return getImage({ 0, 0, static_cast<uint16_t>(stride), static_cast<uint16_t>(stride) });
+}
 
-    return encoding == Tileset::DEMEncoding::Terrarium ? unpackTerrarium : unpackMapbox;
+PremultipliedImage DEMData::getImage(const Rect<uint16_t>& rect) const {
+    assert(rect.x + rect.w <= stride);
+    assert(rect.y + rect.h <= stride);
+
+    PremultipliedImage image({ rect.w, rect.h });
+    uint8_t* dest = image.data.get();
+    for (int32_t y = rect.y; y < rect.y + rect.h; y++) {
+        for (int32_t x = rect.x; x < rect.x + rect.w; x++) {
+            const uint16_t code = heights[static_cast<size_t>(y) * stride + x];
+            dest[0] = code >> 8;
+            dest[1] = code & 0xFF;
+            dest[2] = 0;
+            dest[3] = 0xFF;
+            dest += 4;
+        }
+    }
+    return image;
 }
 
 } // namespace mbgl
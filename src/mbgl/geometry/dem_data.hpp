@@ -2,6 +2,7 @@
 
 #include <mbgl/math/clamp.hpp>
 #include <mbgl/util/image.hpp>
+#include <mbgl/util/rect.hpp>
 #include <mbgl/util/tileset.hpp>
 
 #include <memory>
@@ -11,16 +12,29 @@
 
 namespace mbgl {
 
+// The heights of a raster-dem tile and of a one pixel border around it, stored as 16-bit codes on a
+// grid of `step` encoded units starting at `base`. The grid is chosen per tile to cover its heights
+// with room for the borders of its neighbors, so codes are lossless for most Mapbox tiles.
 class DEMData {
 public:
     DEMData(const PremultipliedImage& image, Tileset::DEMEncoding encoding);
     void backfillBorder(const DEMData& borderTileData, int8_t dx, int8_t dy);
 
     int32_t get(int32_t x, int32_t y) const;
+    // Decodes the pixels of getImage() into heights: r * [0] + g * [1] + b * [2] - [3].
     const std::array<float, 4>& getUnpackVector() const;
 
-    const PremultipliedImage* getImage() const {
-        return &image;
+    // The codes as RGBA pixels for the DEM texture, including the border.
+    PremultipliedImage getImage() const;
+    // A part of the DEM texture, in pixels from the top left corner of the border.
+    PremultipliedImage getImage(const Rect<uint16_t>&) const;
+
+    bool valid() const {
+        return !heights.empty();
+    }
+
+    std::size_t bytes() const {
+        return heights.size() * sizeof(uint16_t);
     }
 
     const int32_t dim;
@@ -28,8 +42,14 @@ public:
 
 
 private:
+    uint16_t encode(int64_t value) const;
+    int64_t decode(uint16_t code) const;
+
     Tileset::DEMEncoding encoding;
-    PremultipliedImage image;
+    int64_t base = 0;
+    int64_t step = 1;
+    std::array<float, 4> unpack;
+    std::vector<uint16_t> heights;
 
     size_t idx(const int32_t x, const int32_t y) const {
         assert(x >= -1);
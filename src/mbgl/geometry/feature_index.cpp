@@ -9,6 +9,7 @@
 #include <mbgl/tile/tile_id.hpp>
 #include <mbgl/util/constants.hpp>
 #include <mbgl/util/geometry_within.hpp>
+#include <mbgl/util/hash.hpp>
 #include <mbgl/util/math.hpp>
 #include <mbgl/util/projection.hpp>
 
@@ -78,6 +79,7 @@ void FeatureIndex::query(std::unordered_map<std::string, std::vector<Feature>>&
     std::sort(features.begin(), features.end(), [](const IndexedSubfeature& a, const IndexedSubfeature& b) {
         return a.sortIndex > b.sortIndex;
     });
+    std::lock_guard<std::mutex> lock(decodedMutex);
     size_t previousSortIndex = std::numeric_limits<size_t>::max();
     for (const auto& indexedFeature : features) {
 
@@ -123,6 +125,7 @@ std::unordered_map<std::string, std::vector<Feature>> FeatureIndex::lookupSymbol
         }
     });
 
+    std::lock_guard<std::mutex> lock(decodedMutex);
     for (const auto& symbolFeature : sortedFeatures) {
         mat4 unusedMatrix;
         addFeature(result, symbolFeature, queryOptions, tileID.canonical, layers, GeometryCoordinates(), {}, 0,
@@ -139,8 +142,7 @@ void FeatureIndex::addFeature(std::unordered_map<std::string, std::vector<Featur
                               const float pixelsToTileUnits, const mat4& posMatrix,
                               const SourceFeatureState* sourceFeatureState) const {
     // Lazily calculated.
-    std::unique_ptr<GeometryTileLayer> sourceLayer;
-    std::unique_ptr<GeometryTileFeature> geometryTileFeature;
+    DecodedFeature* decoded = nullptr;
 
     for (const std::string& layerID : bucketLayerIDs.at(indexedFeature.bucketLeaderID)) {
         const auto it = layers.find(layerID);
@@ -150,38 +152,94 @@ void FeatureIndex::addFeature(std::unordered_map<std::string, std::vector<Featur
 
         const RenderLayer* renderLayer = it->second;
 
-        if (!geometryTileFeature) {
-            sourceLayer = tileData->getLayer(indexedFeature.sourceLayerName);
-            assert(sourceLayer);
+        if (options.limit) {
+            const auto layerResult = result.find(layerID);
+            if (layerResult != result.end() && layerResult->second.size() >= *options.limit) {
+                continue;
+            }
+        }
 
-            geometryTileFeature = sourceLayer->getFeature(indexedFeature.index);
-            assert(geometryTileFeature);
+        if (!decoded) {
+            decoded = &getDecodedFeature(indexedFeature);
         }
+        const GeometryTileLayer& sourceLayer = decoded->sourceLayer;
+        const GeometryTileFeature& geometryTileFeature = *decoded->feature;
         FeatureState state;
         if (sourceFeatureState != nullptr) {
-            optional<std::string> idStr = featureIDtoString(geometryTileFeature->getID());
+            optional<std::string> idStr = featureIDtoString(geometryTileFeature.getID());
             if (idStr) {
-                sourceFeatureState->getState(state, sourceLayer->getName(), *idStr);
+                sourceFeatureState->getState(state, sourceLayer.getName(), *idStr);
             }
         }
 
         bool needsCrossTileIndex = renderLayer->baseImpl->getTypeInfo()->crossTileIndex == style::LayerTypeInfo::CrossTileIndex::Required;
         if (!needsCrossTileIndex &&
-            !renderLayer->queryIntersectsFeature(queryGeometry, *geometryTileFeature, tileID.z, transformState,
+            !renderLayer->queryIntersectsFeature(queryGeometry, geometryTileFeature, tileID.z, transformState,
                                                  pixelsToTileUnits, posMatrix, state)) {
             continue;
         }
 
-        if (options.filter && !(*options.filter)(style::expression::EvaluationContext { static_cast<float>(tileID.z), geometryTileFeature.get() })) {
+        if (options.filter && !(*options.filter)(style::expression::EvaluationContext { static_cast<float>(tileID.z), &geometryTileFeature })) {
             continue;
         }
 
-        Feature feature = convertFeature(*geometryTileFeature, tileID);
+        Feature feature;
+        if (options.properties || !options.geometry) {
+            // Only the requested parts of the feature are converted.
+            if (options.geometry) {
+                feature.geometry = decoded->converted ? decoded->converted->geometry
+                                                      : convertGeometry(geometryTileFeature, tileID);
+            }
+            if (options.properties) {
+                for (const auto& key : *options.properties) {
+                    if (optional<Value> value = geometryTileFeature.getValue(key)) {
+                        feature.properties.emplace(key, std::move(*value));
+                    }
+                }
+            } else {
+                feature.properties = geometryTileFeature.getProperties();
+            }
+            feature.id = geometryTileFeature.getID();
+        } else {
+            if (!decoded->converted) {
+                decoded->converted = convertFeature(geometryTileFeature, tileID);
+            }
+            feature = *decoded->converted;
+        }
         feature.source = renderLayer->baseImpl->source;
-        feature.sourceLayer = sourceLayer->getName();
+        feature.sourceLayer = sourceLayer.getName();
         feature.state = state;
-        result[layerID].emplace_back(feature);
+        result[layerID].emplace_back(std::move(feature));
+    }
+}
+
+std::size_t FeatureIndex::DecodedFeatureKeyHasher::operator()(const DecodedFeatureKey& key) const {
+    return util::hash(key.first, key.second);
+}
+
+FeatureIndex::DecodedFeature& FeatureIndex::getDecodedFeature(const IndexedSubfeature& indexedFeature) const {
+    auto& sourceLayer = decodedLayers[indexedFeature.sourceLayerName];
+    if (!sourceLayer) {
+        sourceLayer = tileData->getLayer(indexedFeature.sourceLayerName);
+        assert(sourceLayer);
+    }
+
+    const DecodedFeatureKey key{sourceLayer.get(), indexedFeature.index};
+    auto it = decodedFeatures.find(key);
+    if (it != decodedFeatures.end()) {
+        decodedFeatureOrder.splice(decodedFeatureOrder.end(), decodedFeatureOrder, it->second.position);
+        return it->second;
+    }
+
+    if (decodedFeatures.size() >= maxDecodedFeatures) {
+        decodedFeatures.erase(decodedFeatureOrder.front());
+        decodedFeatureOrder.pop_front();
     }
+    auto feature = sourceLayer->getFeature(indexedFeature.index);
+    assert(feature);
+    const auto position = decodedFeatureOrder.insert(decodedFeatureOrder.end(), key);
+    return decodedFeatures.emplace(key, DecodedFeature{*sourceLayer, std::move(feature), nullopt, position})
+        .first->second;
 }
 
 optional<GeometryCoordinates> FeatureIndex::translateQueryGeometry(
@@ -8,6 +8,8 @@
 #include <mbgl/util/grid_index.hpp>
 #include <mbgl/util/mat4.hpp>
 
+#include <list>
+#include <mutex>
 #include <vector>
 #include <string>
 #include <unordered_map>
@@ -108,6 +110,19 @@ public:
         const FeatureSortOrder& featureSortOrder) const;
 
 private:
+    using DecodedFeatureKey = std::pair<const GeometryTileLayer*, std::size_t>;
+
+    // A feature decoded for a query, converted once it matched a query.
+    struct DecodedFeature {
+        const GeometryTileLayer& sourceLayer;
+        std::unique_ptr<const GeometryTileFeature> feature;
+        optional<Feature> converted;
+        std::list<DecodedFeatureKey>::iterator position;
+    };
+
+    // Must be called with decodedMutex held.
+    DecodedFeature& getDecodedFeature(const IndexedSubfeature&) const;
+
     void addFeature(std::unordered_map<std::string, std::vector<Feature>>& result,
                     const IndexedSubfeature&,
                     const RenderedQueryOptions& options,
@@ -124,5 +139,17 @@ private:
 
     std::unordered_map<std::string, std::vector<std::string>> bucketLayerIDs;
     std::unique_ptr<const GeometryTileData> tileData;
+
+    // Repeated queries, e.g. while hovering, mostly hit the same features, so the most recently
+    // queried ones are kept decoded, along with the source layers they come from.
+    struct DecodedFeatureKeyHasher {
+        std::size_t operator()(const DecodedFeatureKey&) const;
+    };
+    static constexpr std::size_t maxDecodedFeatures = 256;
+    mutable std::mutex decodedMutex;
+    mutable std::unordered_map<std::string, std::unique_ptr<const GeometryTileLayer>> decodedLayers;
+    mutable std::unordered_map<DecodedFeatureKey, DecodedFeature, DecodedFeatureKeyHasher> decodedFeatures;
+    // Least recently used first.
+    mutable std::list<DecodedFeatureKey> decodedFeatureOrder;
 };
 } // namespace mbgl
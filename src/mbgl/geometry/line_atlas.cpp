@@ -1,4 +1,3 @@
-#include <cmath>
 #include <mbgl/geometry/line_atlas.hpp>
 #include <mbgl/gfx/upload_pass.hpp>
 #include <mbgl/math/log2.hpp>
@@ -7,6 +6,9 @@
 #include <mbgl/util/logging.hpp>
 #include <mbgl/util/platform.hpp>
 
+#include <algorithm>
+#include <cmath>
+
 namespace mbgl {
 namespace {
 
@@ -171,87 +173,139 @@ LinePatternPos addDashPattern(AlphaImage& image,
 
 } // namespace
 
-DashPatternTexture::DashPatternTexture(const std::vector<float>& from_,
-                                       const std::vector<float>& to_,
-                                       const LinePatternCap cap) {
-    const bool patternsIdentical = from_ == to_;
-    const uint32_t patternHeight = cap == LinePatternCap::Round ? 15 : 1;
-    const uint32_t height = (patternsIdentical ? 1 : 2) * patternHeight;
-
-    // The OpenGL ES 2.0 spec, section 3.8.2 states:
-    //
-    //     Calling a sampler from a fragment shader will return (R,G,B,A) = (0,0,0,1) if any of the
-    //     following conditions are true:
-    //     […]
-    //     - A two-dimensional sampler is called, the corresponding texture image is a
-    //       non-power-of-two image […], and either the texture wrap mode is not CLAMP_TO_EDGE, or
-    //       the minification filter is neither NEAREST nor LINEAR.
-    //     […]
-    //
-    // This means that texture lookups won't work for NPOT textures unless they use GL_CLAMP_TO_EDGE.
-    // We're using GL_CLAMP_TO_EDGE for the vertical direction, but GL_REPEAT for the horizontal
-    // direction, which means that we need a power-of-two texture for our line dash patterns to work
-    // on OpenGL ES 2.0 conforming implementations. Fortunately, this just means changing the height
-    // from 15 to 16, and from 30 to 32, so we don't waste many pixels.
-    const uint32_t textureHeight = 1 << util::ceil_log2(height);
-    AlphaImage image({256, textureHeight});
-
-    from = addDashPattern(image, 0, from_, cap);
-    to = patternsIdentical ? from : addDashPattern(image, patternHeight, to_, cap);
-
-    texture = std::move(image);
+// The OpenGL ES 2.0 spec, section 3.8.2 states:
+//
+//     Calling a sampler from a fragment shader will return (R,G,B,A) = (0,0,0,1) if any of the
+//     following conditions are true:
+//     […]
+//     - A two-dimensional sampler is called, the corresponding texture image is a
+//       non-power-of-two image […], and either the texture wrap mode is not CLAMP_TO_EDGE, or
+//       the minification filter is neither NEAREST nor LINEAR.
+//     […]
+//
+// This means that texture lookups won't work for NPOT textures unless they use GL_CLAMP_TO_EDGE.
+// We're using GL_CLAMP_TO_EDGE for the vertical direction, but GL_REPEAT for the horizontal
+// direction, which means that the atlas needs to be a power-of-two texture for our line dash
+// patterns to work on OpenGL ES 2.0 conforming implementations. It grows by doubling its height.
+constexpr uint32_t atlasWidth = 256;
+constexpr uint32_t initialHeight = 16;
+constexpr uint32_t maxHeight = 2048;
+
+LineAtlas::LineAtlas() : image({atlasWidth, initialHeight}) {
+    image.fill(0);
 }
 
-void DashPatternTexture::upload(gfx::UploadPass& uploadPass) {
-    if (texture.is<AlphaImage>()) {
-        texture = uploadPass.createTexture(texture.get<AlphaImage>());
+LineAtlas::~LineAtlas() = default;
+
+LinePatternPos LineAtlas::getDashPosition(const std::vector<float>& dasharray, const LinePatternCap cap) {
+    const size_t hash = getDashPatternHash(dasharray, cap);
+
+    auto it = patterns.find(hash);
+    if (it != patterns.end()) {
+        it->second.lastUsed = frame;
+        return getPosition(it->second);
     }
-}
 
-gfx::TextureBinding DashPatternTexture::textureBinding() const {
-    // The texture needs to have been uploaded already.
-    assert(texture.is<gfx::Texture>());
-    return {texture.get<gfx::Texture>().getResource(),
-            gfx::TextureFilterType::Linear,
-            gfx::TextureMipMapType::No,
-            gfx::TextureWrapType::Repeat,
-            gfx::TextureWrapType::Clamp};
+    const uint32_t rows = cap == LinePatternCap::Round ? 15 : 1;
+    const optional<uint32_t> y = allocate(rows);
+    if (!y) {
+        Log::Warning(Event::OpenGL, "line atlas bitmap overflow");
+        return {};
+    }
+
+    const LinePatternPos position = addDashPattern(image, *y, dasharray, cap);
+    it = patterns.emplace(hash, Pattern{*y, rows, position.width, frame}).first;
+    if (!fullUpload) {
+        dirtyBegin = dirtyBegin == dirtyEnd ? *y : std::min(dirtyBegin, *y);
+        dirtyEnd = std::max(dirtyEnd, *y + rows);
+    }
+    return getPosition(it->second);
 }
 
-Size DashPatternTexture::getSize() const {
-    return texture.match([](const auto& obj) { return obj.size; });
+LinePatternPos LineAtlas::getPosition(const Pattern& pattern) const {
+    const uint32_t n = (pattern.rows - 1) / 2;
+    LinePatternPos position;
+    position.y = (0.5f + pattern.y + n) / image.size.height;
+    position.height = (2.0f * n + 1) / image.size.height;
+    position.width = pattern.width;
+    return position;
 }
 
-LineAtlas::LineAtlas() = default;
+optional<uint32_t> LineAtlas::allocate(const uint32_t rows) {
+    if (nextRow + rows > image.size.height) {
+        evict();
+    }
+    if (nextRow + rows > image.size.height) {
+        uint32_t height = image.size.height;
+        while (nextRow + rows > height && height < maxHeight) {
+            height *= 2;
+        }
+        if (nextRow + rows > height) {
+            return nullopt;
+        }
+        image.resize({atlasWidth, height});
+        fullUpload = true;
+    }
+
+    const uint32_t y = nextRow;
+    nextRow += rows;
+    return y;
+}
 
-LineAtlas::~LineAtlas() = default;
+void LineAtlas::evict() {
+    const bool unused = std::any_of(
+        patterns.begin(), patterns.end(), [&](const auto& entry) { return entry.second.lastUsed < frame; });
+    if (!unused) {
+        return;
+    }
 
-DashPatternTexture& LineAtlas::getDashPatternTexture(const std::vector<float>& from,
-                                                     const std::vector<float>& to,
-                                                     const LinePatternCap cap) {
-    const size_t hash = util::hash(getDashPatternHash(from, cap), getDashPatternHash(to, cap));
-
-    // Note: We're not handling hash collisions here.
-    const auto it = textures.find(hash);
-    if (it == textures.end()) {
-        auto inserted = textures.emplace(
-            std::piecewise_construct, std::forward_as_tuple(hash), std::forward_as_tuple(from, to, cap));
-        assert(inserted.second);
-        needsUpload.emplace_back(hash);
-        return inserted.first->second;
-    } else {
-        return it->second;
+    // The patterns used in this frame are packed again from the top, the others go.
+    AlphaImage packed(image.size);
+    packed.fill(0);
+    nextRow = 0;
+    for (auto it = patterns.begin(); it != patterns.end();) {
+        Pattern& pattern = it->second;
+        if (pattern.lastUsed < frame) {
+            it = patterns.erase(it);
+            continue;
+        }
+        AlphaImage::copy(image, packed, {0, pattern.y}, {0, nextRow}, {atlasWidth, pattern.rows});
+        pattern.y = nextRow;
+        nextRow += pattern.rows;
+        ++it;
     }
+    image = std::move(packed);
+    fullUpload = true;
 }
 
 void LineAtlas::upload(gfx::UploadPass& uploadPass) {
-    for (const size_t hash : needsUpload) {
-        const auto it = textures.find(hash);
-        if (it != textures.end()) {
-            it->second.upload(uploadPass);
-        }
+    if (patterns.empty() && !texture) {
+        return;
     }
-    needsUpload.clear();
+
+    if (!texture) {
+        texture = uploadPass.createTexture(image);
+    } else if (fullUpload) {
+        uploadPass.updateTexture(*texture, image);
+    } else if (dirtyBegin < dirtyEnd) {
+        AlphaImage rows({atlasWidth, dirtyEnd - dirtyBegin});
+        AlphaImage::copy(image, rows, {0, dirtyBegin}, {0, 0}, rows.size);
+        uploadPass.updateTextureSub(*texture, rows, 0, static_cast<uint16_t>(dirtyBegin));
+    }
+
+    fullUpload = false;
+    dirtyBegin = dirtyEnd = 0;
+    ++frame;
+}
+
+gfx::TextureBinding LineAtlas::textureBinding() const {
+    // The texture needs to have been uploaded already.
+    assert(texture);
+    return {texture->getResource(),
+            gfx::TextureFilterType::Linear,
+            gfx::TextureMipMapType::No,
+            gfx::TextureWrapType::Repeat,
+            gfx::TextureWrapType::Clamp};
 }
 
 } // namespace mbgl
@@ -3,10 +3,9 @@
 #include <mbgl/gfx/texture.hpp>
 #include <mbgl/util/image.hpp>
 #include <mbgl/util/optional.hpp>
-#include <mbgl/util/variant.hpp>
 
-#include <map>
 #include <memory>
+#include <unordered_map>
 #include <vector>
 
 namespace mbgl {
@@ -34,48 +33,54 @@ struct DashRange {
     bool isZeroLength;
 };
 
-class DashPatternTexture {
-public:
-    DashPatternTexture(const std::vector<float>& from, const std::vector<float>& to, LinePatternCap);
-
-    // Uploads the texture to the GPU to be available when we need it. This is a lazy operation;
-    // the texture is only bound when the data is uploaded for the first time.
-    void upload(gfx::UploadPass&);
-
-    // Binds the atlas texture to the GPU, and uploads data if it is out of date.
-    gfx::TextureBinding textureBinding() const;
-
-    // Returns the size of the texture image.
-    Size getSize() const;
-
-    const LinePatternPos& getFrom() const { return from; }
-    const LinePatternPos& getTo() const { return to; }
-
-private:
-    LinePatternPos from, to;
-    variant<AlphaImage, gfx::Texture> texture;
-};
-
+// Packs the dash patterns of line layers into the rows of a single texture, which grows as patterns
+// are added and is uploaded incrementally. When the texture is full, the patterns that weren't used
+// in the current frame are evicted to make room.
 class LineAtlas {
 public:
     LineAtlas();
     ~LineAtlas();
 
-    // Obtains or creates a texture that has both line patterns in it
-    DashPatternTexture& getDashPatternTexture(const std::vector<float>& from,
-                                              const std::vector<float>& to,
-                                              LinePatternCap);
+    // Obtains the position of the dash pattern in the atlas, adding the pattern if it isn't in the
+    // atlas yet. Positions may change when patterns are added, so they are obtained again for
+    // rendering, after all the patterns of the frame have been added.
+    LinePatternPos getDashPosition(const std::vector<float>& dasharray, LinePatternCap);
 
-    // Uploads the textures to the GPU to be available when we need it.
+    // Uploads the rows that changed since the last upload, and starts the next frame.
     void upload(gfx::UploadPass&);
 
-    bool isEmpty() const { return textures.empty(); }
+    // Binds the atlas texture, which needs to have been uploaded already.
+    gfx::TextureBinding textureBinding() const;
 
-private:
-    std::map<size_t, DashPatternTexture> textures;
+    Size getSize() const { return image.size; }
+
+    bool isEmpty() const { return patterns.empty(); }
 
-    // Stores a list of hashes of texture objcts that need uploading.
-    std::vector<size_t> needsUpload;
+private:
+    struct Pattern {
+        uint32_t y;
+        uint32_t rows;
+        float width;
+        uint64_t lastUsed;
+    };
+
+    LinePatternPos getPosition(const Pattern&) const;
+    // Returns the first row of a free range of the given number of rows, making room if needed.
+    optional<uint32_t> allocate(uint32_t rows);
+    // Removes the patterns that weren't used in the current frame and packs the others again.
+    void evict();
+
+    AlphaImage image;
+    optional<gfx::Texture> texture;
+    // Note: hash collisions of dash patterns aren't handled.
+    std::unordered_map<size_t, Pattern> patterns;
+    uint32_t nextRow = 0;
+    uint64_t frame = 0;
+
+    // The rows that need uploading, if the texture doesn't need uploading as a whole.
+    uint32_t dirtyBegin = 0;
+    uint32_t dirtyEnd = 0;
+    bool fullUpload = true;
 };
 
 } // namespace mbgl
@@ -17,5 +17,15 @@ optional<AttributeBinding> offsetAttributeBinding(const optional<AttributeBindin
     }
 }
 
+optional<AttributeBinding> instancedAttributeBinding(const optional<AttributeBinding>& binding, uint32_t instanceDivisor) {
+    if (binding) {
+        AttributeBinding result = *binding;
+        result.instanceDivisor = instanceDivisor;
+        return result;
+    } else {
+        return binding;
+    }
+}
+
 } // namespace gfx
 } // namespace mbgl
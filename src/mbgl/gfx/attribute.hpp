@@ -84,12 +84,16 @@ public:
     uint8_t vertexStride;
     const VertexBufferResource* vertexBufferResource;
     uint32_t vertexOffset;
+    // With instanced drawing, the attribute advances once per that many instances; 0 advances
+    // it with every vertex.
+    uint32_t instanceDivisor;
 
     friend bool operator==(const AttributeBinding& lhs, const AttributeBinding& rhs) {
         return lhs.attribute == rhs.attribute &&
                lhs.vertexStride == rhs.vertexStride &&
                lhs.vertexBufferResource == rhs.vertexBufferResource &&
-               lhs.vertexOffset == rhs.vertexOffset;
+               lhs.vertexOffset == rhs.vertexOffset &&
+               lhs.instanceDivisor == rhs.instanceDivisor;
     }
 };
 
@@ -248,10 +252,12 @@ AttributeBinding attributeBinding(const VertexBuffer<detail::VertexType<As...>>&
         Descriptor::data.stride,
         &buffer.getResource(),
         0,
+        0,
     };
 }
 
 optional<gfx::AttributeBinding> offsetAttributeBinding(const optional<gfx::AttributeBinding>& binding, std::size_t vertexOffset);
+optional<gfx::AttributeBinding> instancedAttributeBinding(const optional<gfx::AttributeBinding>& binding, uint32_t instanceDivisor = 1);
 
 template <class>
 class AttributeBindings;
@@ -3,11 +3,14 @@
 #include <mbgl/gfx/backend.hpp>
 #include <mbgl/gfx/command_encoder.hpp>
 #include <mbgl/gfx/draw_scope.hpp>
+#include <mbgl/gfx/memory_tracker.hpp>
 #include <mbgl/gfx/program.hpp>
 #include <mbgl/gfx/renderbuffer.hpp>
 #include <mbgl/gfx/rendering_stats.hpp>
 #include <mbgl/gfx/texture.hpp>
 #include <mbgl/gfx/types.hpp>
+#include <mbgl/util/chrono.hpp>
+#include <mbgl/util/optional.hpp>
 
 namespace mbgl {
 
@@ -27,6 +30,7 @@ public:
     static constexpr const uint32_t minimumRequiredVertexBindingCount = 8;
     const uint32_t maximumVertexBindingCount;
     bool supportsHalfFloatTextures = false;
+    bool supportsETC1Textures = false;
 
 public:
     Context(Context&&) = delete;
@@ -44,6 +48,9 @@ public:
 
 public:
     virtual std::unique_ptr<OffscreenTexture> createOffscreenTexture(Size, TextureChannelDataType) = 0;
+    // Creates an offscreen texture with a depth/stencil buffer, for rendering layers that clip to
+    // tiles or use the depth buffer.
+    virtual std::unique_ptr<OffscreenTexture> createOffscreenTextureWithDepthStencil(Size) = 0;
 
 public:
     // Creates an empty texture with the specified dimensions.
@@ -87,6 +94,21 @@ public:
 
     virtual const RenderingStats& renderingStats() const = 0;
 
+    // Backends add their textures and buffers, see MemoryTracker.
+    MemoryTracker& memoryTracker() {
+        return memory;
+    }
+    const MemoryTracker& memoryTracker() const {
+        return memory;
+    }
+
+    // Measures the GPU time of the commands issued between the two calls, where the backend can.
+    // Measurements complete asynchronously, endGPUTimer() returns the latest one that completed.
+    virtual void beginGPUTimer() {}
+    virtual optional<Duration> endGPUTimer() {
+        return nullopt;
+    }
+
 #if not defined(NDEBUG)
 public:
     virtual void visualizeStencilBuffer() = 0;
@@ -94,6 +116,9 @@ public:
 #endif
 
     virtual void clearStencilBuffer(int32_t) = 0;
+
+private:
+    MemoryTracker memory;
 };
 
 } // namespace gfx
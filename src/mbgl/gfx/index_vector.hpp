@@ -3,6 +3,9 @@
 #include <mbgl/gfx/draw_mode.hpp>
 #include <mbgl/util/ignore.hpp>
 
+#include <algorithm>
+#include <cassert>
+#include <iterator>
 #include <vector>
 
 namespace mbgl {
@@ -19,6 +22,34 @@ public:
         util::ignore({ (v.emplace_back(std::forward<Args>(args)), 0)... });
     }
 
+    // Appends the indices in [first, last), each one shifted by offset. The number of indices
+    // must be a multiple of groupSize.
+    template <class ForwardIt>
+    void append(ForwardIt first, ForwardIt last, uint16_t offset = 0) {
+        const auto n = static_cast<std::size_t>(std::distance(first, last));
+        assert(n % groupSize == 0);
+        grow(n);
+        for (; first != last; ++first) {
+            v.push_back(static_cast<uint16_t>(offset + *first));
+        }
+    }
+
+    // Makes sure that n more indices can be added without reallocating. Unlike reserve(),
+    // this keeps the capacity growing geometrically, so it can be called for every feature.
+    void grow(std::size_t n) {
+        if (v.size() + n > v.capacity()) {
+            v.reserve(std::max(v.size() + n, v.capacity() * 2));
+        }
+    }
+
+    void reserve(std::size_t n) {
+        v.reserve(n);
+    }
+
+    std::size_t capacity() const {
+        return v.capacity();
+    }
+
     std::size_t elements() const {
         return v.size();
     }
@@ -0,0 +1,69 @@
+#include <mbgl/gfx/memory_tracker.hpp>
+
+#include <cassert>
+
+namespace mbgl {
+namespace gfx {
+
+namespace {
+
+std::size_t& bytesOf(MemoryUsage::Bytes& bytes, MemoryType type) {
+    switch (type) {
+        case MemoryType::Texture:
+            return bytes.textures;
+        case MemoryType::VertexBuffer:
+            return bytes.vertexBuffers;
+        case MemoryType::IndexBuffer:
+        default:
+            return bytes.indexBuffers;
+    }
+}
+
+} // namespace
+
+MemoryTracker::Handle MemoryTracker::add(MemoryType type, std::size_t bytes) {
+    auto handle = entries.emplace(current, Entry()).first;
+    bytesOf(handle->second.bytes, type) += bytes;
+    handle->second.resources++;
+    return handle;
+}
+
+void MemoryTracker::remove(Handle handle, MemoryType type, std::size_t bytes) {
+    std::size_t& counter = bytesOf(handle->second.bytes, type);
+    assert(counter >= bytes);
+    counter -= bytes;
+    assert(handle->second.resources > 0);
+    if (--handle->second.resources == 0) {
+        entries.erase(handle);
+    }
+}
+
+MemoryUsage MemoryTracker::getUsage() const {
+    MemoryUsage usage;
+    for (const auto& entry : entries) {
+        const MemoryOwner& owner = entry.first;
+        const MemoryUsage::Bytes& bytes = entry.second.bytes;
+        usage.total += bytes;
+        if (!owner.shared.empty()) {
+            usage.shared[owner.shared] += bytes;
+            continue;
+        }
+        if (owner.source.empty() && owner.layer.empty()) {
+            usage.other += bytes;
+            continue;
+        }
+        if (!owner.source.empty()) {
+            usage.sources[owner.source] += bytes;
+            if (owner.tile) {
+                usage.tiles[owner.source][*owner.tile] += bytes;
+            }
+        }
+        if (!owner.layer.empty()) {
+            usage.layers[owner.layer] += bytes;
+        }
+    }
+    return usage;
+}
+
+} // namespace gfx
+} // namespace mbgl
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <mbgl/gfx/memory_usage.hpp>
+#include <mbgl/tile/tile_id.hpp>
+#include <mbgl/util/noncopyable.hpp>
+#include <mbgl/util/optional.hpp>
+
+#include <map>
+#include <string>
+#include <tuple>
+
+namespace mbgl {
+namespace gfx {
+
+enum class MemoryType : uint8_t {
+    Texture,
+    VertexBuffer,
+    IndexBuffer,
+};
+
+// What GPU resources are created for. Empty fields don't apply.
+struct MemoryOwner {
+    std::string source;
+    std::string layer;
+    optional<OverscaledTileID> tile;
+    // The name of a resource shared by the whole map, like "glyph atlas".
+    std::string shared;
+
+    static MemoryOwner forSource(std::string id) {
+        MemoryOwner owner;
+        owner.source = std::move(id);
+        return owner;
+    }
+    static MemoryOwner forLayer(std::string id) {
+        MemoryOwner owner;
+        owner.layer = std::move(id);
+        return owner;
+    }
+    static MemoryOwner forShared(std::string name) {
+        MemoryOwner owner;
+        owner.shared = std::move(name);
+        return owner;
+    }
+
+    bool operator<(const MemoryOwner& rhs) const {
+        return std::tie(source, layer, tile, shared) < std::tie(rhs.source, rhs.layer, rhs.tile, rhs.shared);
+    }
+};
+
+// Attributes the GPU memory of resources to the owner that was current when they were created.
+// Backends call add() when they create a resource and remove() with its handle when they delete it.
+class MemoryTracker : private util::noncopyable {
+private:
+    struct Entry {
+        MemoryUsage::Bytes bytes;
+        std::size_t resources = 0;
+    };
+    using Entries = std::map<MemoryOwner, Entry>;
+
+public:
+    // Identifies the owner of a resource for as long as the resource lives.
+    using Handle = Entries::iterator;
+
+    // Makes `owner` the current owner until the scope ends.
+    class Scope : private util::noncopyable {
+    public:
+        Scope(MemoryTracker& tracker_, MemoryOwner owner) : tracker(&tracker_), previous(std::move(tracker->current)) {
+            tracker->current = std::move(owner);
+        }
+        Scope(Scope&& rhs) noexcept : tracker(rhs.tracker), previous(std::move(rhs.previous)) {
+            rhs.tracker = nullptr;
+        }
+        ~Scope() {
+            if (tracker) {
+                tracker->current = std::move(previous);
+            }
+        }
+
+    private:
+        MemoryTracker* tracker;
+        MemoryOwner previous;
+    };
+
+    const MemoryOwner& getOwner() const {
+        return current;
+    }
+
+    Handle add(MemoryType, std::size_t bytes);
+    void remove(Handle, MemoryType, std::size_t bytes);
+
+    MemoryUsage getUsage() const;
+
+private:
+    MemoryOwner current;
+    Entries entries;
+};
+
+} // namespace gfx
+} // namespace mbgl
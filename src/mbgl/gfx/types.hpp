@@ -147,6 +147,10 @@ enum class TexturePixelType : uint8_t {
     Luminance,
 };
 
+enum class TextureCompressionType : uint8_t {
+    ETC1,
+};
+
 enum class TextureChannelDataType : uint8_t {
     UnsignedByte,
     HalfFloat,
@@ -5,6 +5,7 @@
 #include <mbgl/gfx/vertex_buffer.hpp>
 #include <mbgl/gfx/index_vector.hpp>
 #include <mbgl/gfx/index_buffer.hpp>
+#include <mbgl/gfx/memory_tracker.hpp>
 #include <mbgl/gfx/texture.hpp>
 #include <mbgl/util/size.hpp>
 
@@ -28,6 +29,18 @@ public:
         return { *this, name };
     }
 
+    // Attributes the GPU memory of the resources created while the scope lives to `owner`.
+    MemoryTracker::Scope createMemoryScope(MemoryOwner owner) {
+        return { getMemoryTracker(), std::move(owner) };
+    }
+
+    const MemoryOwner& getMemoryOwner() {
+        return getMemoryTracker().getOwner();
+    }
+
+protected:
+    virtual MemoryTracker& getMemoryTracker() = 0;
+
 public:
     template <class Vertex>
     VertexBuffer<Vertex>
@@ -39,7 +52,19 @@ public:
     template <class Vertex>
     void updateVertexBuffer(VertexBuffer<Vertex>& buffer, VertexVector<Vertex>&& v) {
         assert(v.elements() == buffer.elements);
-        updateVertexBufferResource(buffer.getResource(), v.data(), v.bytes());
+        updateVertexBufferResource(buffer.getResource(), v.data(), v.bytes(), 0);
+    }
+
+    // Uploads only the vertices [start, end) of a vector that the buffer was created from.
+    template <class Vertex>
+    void updateVertexBuffer(VertexBuffer<Vertex>& buffer,
+                            const VertexVector<Vertex>& v,
+                            std::size_t start,
+                            std::size_t end) {
+        assert(v.elements() == buffer.elements);
+        assert(start <= end && end <= v.elements());
+        updateVertexBufferResource(
+            buffer.getResource(), v.data() + start, (end - start) * sizeof(Vertex), start * sizeof(Vertex));
     }
 
     template <class DrawMode>
@@ -58,8 +83,9 @@ protected:
     virtual std::unique_ptr<VertexBufferResource> createVertexBufferResource(const void* data,
                                                                              std::size_t size,
                                                                              BufferUsageType) = 0;
+    // Writes `size` bytes starting at byte `offset` of the buffer.
     virtual void
-    updateVertexBufferResource(VertexBufferResource&, const void* data, std::size_t size) = 0;
+    updateVertexBufferResource(VertexBufferResource&, const void* data, std::size_t size, std::size_t offset) = 0;
 
     virtual std::unique_ptr<IndexBufferResource> createIndexBufferResource(const void* data,
                                                                            std::size_t size,
@@ -98,7 +124,19 @@ public:
         updateTextureResourceSub(texture.getResource(), offsetX, offsetY, image.size, image.data.get(), format, type);
     }
 
+    virtual bool supportsCompressedTextures(TextureCompressionType) const = 0;
+
+    // Create a texture from compressed data, which must be supported.
+    Texture createCompressedTexture(Size size, const std::vector<uint8_t>& data, TextureCompressionType type) {
+        assert(supportsCompressedTextures(type));
+        return {size, createCompressedTextureResource(size, data.data(), data.size(), type)};
+    }
+
 protected:
+    virtual std::unique_ptr<TextureResource> createCompressedTextureResource(Size,
+                                                                             const void* data,
+                                                                             std::size_t size,
+                                                                             TextureCompressionType) = 0;
     virtual std::unique_ptr<TextureResource> createTextureResource(
         Size, const void* data, TexturePixelType, TextureChannelDataType) = 0;
     virtual void updateTextureResource(TextureResource&, Size, const void* data,
@@ -2,6 +2,8 @@
 
 #include <mbgl/util/ignore.hpp>
 
+#include <algorithm>
+#include <cassert>
 #include <vector>
 
 namespace mbgl {
@@ -20,6 +22,28 @@ public:
         v.resize(v.size() + n, val);
     }
 
+    // Appends all vertices in [first, last) with at most one reallocation.
+    template <class InputIt>
+    void append(InputIt first, InputIt last) {
+        v.insert(v.end(), first, last);
+    }
+
+    // Makes sure that n more vertices can be added without reallocating. Unlike reserve(),
+    // this keeps the capacity growing geometrically, so it can be called for every feature.
+    void grow(std::size_t n) {
+        if (v.size() + n > v.capacity()) {
+            v.reserve(std::max(v.size() + n, v.capacity() * 2));
+        }
+    }
+
+    void reserve(std::size_t n) {
+        v.reserve(n);
+    }
+
+    std::size_t capacity() const {
+        return v.capacity();
+    }
+
     Vertex& at(std::size_t n) {
         assert(n < v.size());
         return v.at(n);
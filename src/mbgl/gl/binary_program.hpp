@@ -0,0 +1,38 @@
+#pragma once
+
+#include <mbgl/gl/types.hpp>
+
+#include <string>
+
+namespace mbgl {
+namespace gl {
+
+// A linked program as retrieved from the driver, along with the identifier of the sources and
+// driver it was linked with. Programs only load back into the same driver they came from.
+class BinaryProgram {
+public:
+    // Parses a serialized program, throws std::runtime_error if the data is malformed.
+    BinaryProgram(std::string&& data);
+
+    BinaryProgram(BinaryProgramFormat, std::string&& code, std::string identifier);
+
+    std::string serialize() const;
+
+    BinaryProgramFormat format() const {
+        return binaryFormat;
+    }
+    const std::string& code() const {
+        return binaryCode;
+    }
+    const std::string& identifier() const {
+        return binaryIdentifier;
+    }
+
+private:
+    BinaryProgramFormat binaryFormat = 0;
+    std::string binaryCode;
+    std::string binaryIdentifier;
+};
+
+} // namespace gl
+} // namespace mbgl
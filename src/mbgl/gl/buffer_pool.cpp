@@ -0,0 +1,101 @@
+#include <mbgl/gl/buffer_pool.hpp>
+
+#include <algorithm>
+#include <cassert>
+
+namespace mbgl {
+namespace gl {
+
+BufferPool::Allocation::Allocation(std::shared_ptr<Block> block_, std::size_t offset_, std::size_t size_)
+    : block(std::move(block_)), offset(offset_), size(size_) {}
+
+BufferPool::Allocation::Allocation(Allocation&& other) noexcept
+    : block(std::move(other.block)), offset(other.offset), size(other.size) {
+    other.block.reset();
+}
+
+BufferPool::Allocation& BufferPool::Allocation::operator=(Allocation&& other) noexcept {
+    if (this != &other) {
+        if (block) {
+            block->release(offset, size);
+        }
+        block = std::move(other.block);
+        other.block.reset();
+        offset = other.offset;
+        size = other.size;
+    }
+    return *this;
+}
+
+BufferPool::Allocation::~Allocation() {
+    if (block) {
+        block->release(offset, size);
+    }
+}
+
+BufferID BufferPool::Allocation::getBuffer() const {
+    assert(block);
+    return block->buffer.get();
+}
+
+BufferPool::Allocation BufferPool::allocate(std::size_t size, const std::function<UniqueBuffer()>& createBlock) {
+    assert(size > 0 && size <= maxAllocationSize);
+    size = (size + alignment - 1) / alignment * alignment;
+
+    blocks.erase(std::remove_if(blocks.begin(), blocks.end(), [](const auto& block) { return block.expired(); }),
+                 blocks.end());
+    for (const auto& weakBlock : blocks) {
+        auto block = weakBlock.lock();
+        if (auto offset = block->allocate(size)) {
+            return {std::move(block), *offset, size};
+        }
+    }
+
+    auto block = std::make_shared<Block>(createBlock(), blockSize);
+    blocks.push_back(block);
+    const auto offset = block->allocate(size);
+    assert(offset);
+    return {std::move(block), *offset, size};
+}
+
+std::size_t BufferPool::blockCount() const {
+    return std::count_if(blocks.begin(), blocks.end(), [](const auto& block) { return !block.expired(); });
+}
+
+BufferPool::Block::Block(UniqueBuffer&& buffer_, std::size_t size) : buffer(std::move(buffer_)) {
+    freeRanges.emplace(0, size);
+}
+
+optional<std::size_t> BufferPool::Block::allocate(std::size_t size) {
+    for (auto it = freeRanges.begin(); it != freeRanges.end(); ++it) {
+        if (it->second >= size) {
+            const std::size_t offset = it->first;
+            const std::size_t remaining = it->second - size;
+            freeRanges.erase(it);
+            if (remaining > 0) {
+                freeRanges.emplace(offset + size, remaining);
+            }
+            return offset;
+        }
+    }
+    return nullopt;
+}
+
+void BufferPool::Block::release(std::size_t offset, std::size_t size) {
+    auto next = freeRanges.lower_bound(offset);
+    if (next != freeRanges.end() && offset + size == next->first) {
+        size += next->second;
+        next = freeRanges.erase(next);
+    }
+    if (next != freeRanges.begin()) {
+        auto previous = std::prev(next);
+        if (previous->first + previous->second == offset) {
+            previous->second += size;
+            return;
+        }
+    }
+    freeRanges.emplace(offset, size);
+}
+
+} // namespace gl
+} // namespace mbgl
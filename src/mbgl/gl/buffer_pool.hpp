@@ -0,0 +1,74 @@
+#pragma once
+
+#include <mbgl/gl/object.hpp>
+#include <mbgl/util/optional.hpp>
+
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace mbgl {
+namespace gl {
+
+/*
+    Suballocates small static buffers from a few large buffer objects, so that the vertex or
+    index data of the buckets of many tiles shares buffers. That takes fewer buffer objects,
+    and consecutive draws of a layer across tiles mostly keep the buffers bound.
+*/
+class BufferPool {
+public:
+    class Block;
+
+    // A range of a block, which returns to the block when destroyed. A block lives as long as
+    // any of its ranges.
+    class Allocation {
+    public:
+        Allocation() = default;
+        Allocation(std::shared_ptr<Block>, std::size_t offset, std::size_t size);
+        Allocation(Allocation&&) noexcept;
+        Allocation& operator=(Allocation&&) noexcept;
+        ~Allocation();
+
+        BufferID getBuffer() const;
+        std::size_t getOffset() const { return offset; }
+
+    private:
+        std::shared_ptr<Block> block;
+        std::size_t offset = 0;
+        std::size_t size = 0;
+    };
+
+    // Larger buffers get buffer objects of their own.
+    static constexpr std::size_t maxAllocationSize = 256 * 1024;
+    static constexpr std::size_t blockSize = 1024 * 1024;
+    // Ranges start at multiples of this, which suits every attribute and index type.
+    static constexpr std::size_t alignment = 16;
+
+    // Returns a free range of `size` bytes, `createBlock` creates the buffer object of a new
+    // block of `blockSize` bytes if no block has room.
+    Allocation allocate(std::size_t size, const std::function<UniqueBuffer()>& createBlock);
+
+    std::size_t blockCount() const;
+
+private:
+    std::vector<std::weak_ptr<Block>> blocks;
+};
+
+class BufferPool::Block {
+public:
+    Block(UniqueBuffer&&, std::size_t size);
+
+    optional<std::size_t> allocate(std::size_t size);
+    void release(std::size_t offset, std::size_t size);
+
+    const UniqueBuffer buffer;
+
+private:
+    // Free ranges by offset, neighboring ranges are merged.
+    std::map<std::size_t, std::size_t> freeRanges;
+};
+
+} // namespace gl
+} // namespace mbgl
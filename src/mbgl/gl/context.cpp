@@ -9,6 +9,11 @@
 #include <mbgl/gl/command_encoder.hpp>
 #include <mbgl/gl/debugging_extension.hpp>
 #include <mbgl/gl/vertex_array_extension.hpp>
+#include <mbgl/gl/instanced_arrays_extension.hpp>
+#include <mbgl/gl/program_binary_extension.hpp>
+#include <mbgl/gl/parallel_shader_compile_extension.hpp>
+#include <mbgl/gl/pixel_buffer_object_extension.hpp>
+#include <mbgl/gl/timer_query_extension.hpp>
 #include <mbgl/util/traits.hpp>
 #include <mbgl/util/std.hpp>
 #include <mbgl/util/logging.hpp>
@@ -106,6 +111,56 @@ void Context::initializeExtensions(const std::function<gl::ProcAddress(const cha
             vertexArray = std::make_unique<extension::VertexArray>(fn);
         }
 
+        instancedArrays = std::make_unique<extension::InstancedArrays>(fn);
+
+        // Block Adreno 3xx, 4xx and 5xx as they crash or return corrupt binaries after driver updates
+        // Block ARM Mali-T880 as it returns invalid binaries for programs with many uniforms
+        if (renderer.find("Adreno (TM) 3") == std::string::npos &&
+            renderer.find("Adreno (TM) 4") == std::string::npos &&
+            renderer.find("Adreno (TM) 5") == std::string::npos &&
+            renderer.find("Mali-T880") == std::string::npos) {
+            programBinary = std::make_unique<extension::ProgramBinary>(fn);
+
+            // Drivers may expose the extension without offering a single binary format.
+            GLint numFormats = 0;
+            if (programBinary->programBinary) {
+                MBGL_CHECK_ERROR(glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &numFormats));
+            }
+            if (numFormats <= 0) {
+                programBinary.reset();
+            }
+        }
+
+        if (strstr(extensions, "GL_KHR_parallel_shader_compile") != nullptr ||
+            strstr(extensions, "GL_ARB_parallel_shader_compile") != nullptr) {
+            parallelShaderCompile = std::make_unique<extension::ParallelShaderCompile>(fn);
+            // Let the driver pick the number of threads, some default to compiling on the calling thread.
+            if (parallelShaderCompile->maxShaderCompilerThreads) {
+                MBGL_CHECK_ERROR(parallelShaderCompile->maxShaderCompilerThreads(0xFFFFFFFF));
+            }
+        }
+
+        if (strstr(extensions, "GL_ARB_pixel_buffer_object") != nullptr ||
+            strstr(extensions, "GL_EXT_pixel_buffer_object") != nullptr ||
+            strstr(extensions, "GL_NV_pixel_buffer_object") != nullptr) {
+            pixelBufferObject = std::make_unique<extension::PixelBufferObject>(fn);
+        }
+
+        if (strstr(extensions, "GL_EXT_disjoint_timer_query") != nullptr ||
+            strstr(extensions, "GL_ARB_timer_query") != nullptr) {
+            timerQuery = std::make_unique<extension::TimerQuery>(fn);
+            if (!*timerQuery) {
+                timerQuery.reset();
+            }
+            timerQueryCanBeDisjoint = strstr(extensions, "GL_EXT_disjoint_timer_query") != nullptr;
+        }
+
+        // Binaries are only valid for the driver that produced them, and driver updates keep the renderer
+        // string but change the version.
+        const auto* vendor = reinterpret_cast<const char*>(MBGL_CHECK_ERROR(glGetString(GL_VENDOR)));
+        const auto* version = reinterpret_cast<const char*>(MBGL_CHECK_ERROR(glGetString(GL_VERSION)));
+        driverIdentifier = std::string(vendor ? vendor : "") + ";" + renderer + ";" + (version ? version : "");
+
 #if MBGL_USE_GLES2
         constexpr const char* halfFloatExtensionName = "OES_texture_half_float";
         constexpr const char* halfFloatColorBufferExtensionName = "EXT_color_buffer_half_float";
@@ -119,6 +174,14 @@ void Context::initializeExtensions(const std::function<gl::ProcAddress(const cha
             supportsHalfFloatTextures = true;
         }
 
+#if MBGL_USE_GLES2
+        constexpr const char* etc1ExtensionName = "OES_compressed_ETC1_RGB8_texture";
+#else
+        // ETC2 decoders read ETC1 data as well.
+        constexpr const char* etc1ExtensionName = "ARB_ES3_compatibility";
+#endif
+        supportsETC1Textures = strstr(extensions, etc1ExtensionName) != nullptr;
+
         if (!supportsVertexArrays()) {
             Log::Warning(Event::OpenGL, "Not using Vertex Array Objects");
         }
@@ -147,6 +210,11 @@ UniqueShader Context::createShader(ShaderType type, const std::initializer_list<
     MBGL_CHECK_ERROR(glShaderSource(result, static_cast<GLsizei>(sources.size()), sources.begin(), nullptr));
     MBGL_CHECK_ERROR(glCompileShader(result));
 
+    if (supportsParallelShaderCompile()) {
+        // Compile errors fail the program linkage, querying the status now would wait for the driver.
+        return result;
+    }
+
     GLint status = 0;
     MBGL_CHECK_ERROR(glGetShaderiv(result, GL_COMPILE_STATUS, &status));
     if (status != 0) {
@@ -176,16 +244,61 @@ UniqueProgram Context::createProgram(ShaderID vertexShader, ShaderID fragmentSha
     // AttributeLocations::getFirstAttribName.
     MBGL_CHECK_ERROR(glBindAttribLocation(result, 0, location0AttribName));
 
-    linkProgram(result);
+    if (supportsParallelShaderCompile()) {
+        // Querying the status now would wait for the driver threads.
+        MBGL_CHECK_ERROR(glLinkProgram(result));
+    } else {
+        linkProgram(result);
+    }
 
     return result;
 }
 
+UniqueProgram Context::createProgram(const BinaryProgram& binaryProgram) {
+    assert(supportsProgramBinaries());
+    UniqueProgram result { MBGL_CHECK_ERROR(glCreateProgram()), { this } };
+    MBGL_CHECK_ERROR(programBinary->programBinary(result,
+                                                  static_cast<GLenum>(binaryProgram.format()),
+                                                  binaryProgram.code().data(),
+                                                  static_cast<GLint>(binaryProgram.code().size())));
+    verifyProgramLinkage(result);
+    return result;
+}
+
+optional<BinaryProgram> Context::getBinaryProgram(ProgramID program_, std::string identifier) const {
+    if (!supportsProgramBinaries()) {
+        return {};
+    }
+    GLint binaryLength = 0;
+    MBGL_CHECK_ERROR(glGetProgramiv(program_, GL_PROGRAM_BINARY_LENGTH, &binaryLength));
+    if (binaryLength <= 0) {
+        return {};
+    }
+    std::string binary;
+    binary.resize(binaryLength);
+    GLenum binaryFormat = 0;
+    MBGL_CHECK_ERROR(programBinary->getProgramBinary(
+        program_, binaryLength, &binaryLength, &binaryFormat, const_cast<char*>(binary.data())));
+    if (size_t(binaryLength) != binary.size()) {
+        return {};
+    }
+    return BinaryProgram{ binaryFormat, std::move(binary), std::move(identifier) };
+}
+
 void Context::linkProgram(ProgramID program_) {
     MBGL_CHECK_ERROR(glLinkProgram(program_));
     verifyProgramLinkage(program_);
 }
 
+bool Context::isProgramLinkComplete(ProgramID program_) const {
+    if (!supportsParallelShaderCompile()) {
+        return true;
+    }
+    GLint status = GL_FALSE;
+    MBGL_CHECK_ERROR(glGetProgramiv(program_, GL_COMPLETION_STATUS_KHR, &status));
+    return status == GL_TRUE;
+}
+
 void Context::verifyProgramLinkage(ProgramID program_) {
     GLint status;
     MBGL_CHECK_ERROR(glGetProgramiv(program_, GL_LINK_STATUS, &status));
@@ -218,6 +331,43 @@ UniqueTexture Context::createUniqueTexture() {
     return UniqueTexture{std::move(id), {this}};
 }
 
+optional<UniqueTexture> Context::takePooledTexture(const TextureStorage& storage) {
+    // The most recently pooled textures are the most likely to still be resident.
+    for (auto it = texturePool.rbegin(); it != texturePool.rend(); ++it) {
+        if (it->storage == storage) {
+            TextureID id = it->id;
+            unpoolTexture(*it);
+            texturePool.erase(std::next(it).base());
+            stats.numActiveTextures++;
+            // NOLINTNEXTLINE(performance-move-const-arg)
+            return UniqueTexture{std::move(id), {this}};
+        }
+    }
+    return nullopt;
+}
+
+void Context::poolTexture(TextureID id, const TextureStorage& storage, int byteSize) {
+    gfx::MemoryTracker::Scope scope(memoryTracker(), gfx::MemoryOwner::forShared("texture pool"));
+    texturePool.push_back({id, storage, byteSize, memoryTracker().add(gfx::MemoryType::Texture, byteSize)});
+    texturePoolBytes += byteSize;
+    stats.numActiveTextures--;
+    assert(stats.numActiveTextures >= 0);
+}
+
+void Context::unpoolTexture(const PooledTexture& pooled) {
+    memoryTracker().remove(pooled.memory, gfx::MemoryType::Texture, pooled.byteSize);
+    texturePoolBytes -= pooled.byteSize;
+    assert(texturePoolBytes >= 0);
+}
+
+void Context::abandonTexturePool() {
+    for (const auto& pooled : texturePool) {
+        unpoolTexture(pooled);
+        abandonedTextures.push_back(pooled.id);
+    }
+    texturePool.clear();
+}
+
 bool Context::supportsVertexArrays() const {
     return vertexArray &&
            vertexArray->genVertexArrays &&
@@ -225,12 +375,25 @@ bool Context::supportsVertexArrays() const {
            vertexArray->deleteVertexArrays;
 }
 
+bool Context::supportsInstancedArrays() const {
+    return instancedArrays && instancedArrays->vertexAttribDivisor && instancedArrays->drawElementsInstanced;
+}
+
+bool Context::supportsPixelBufferObjects() const {
+    return pixelBufferObject && pixelBufferObject->mapBufferRange && pixelBufferObject->unmapBuffer;
+}
+
+bool Context::supportsProgramBinaries() const {
+    return programBinary && programBinary->programBinary && programBinary->getProgramBinary;
+}
+
 VertexArray Context::createVertexArray() {
     if (supportsVertexArrays()) {
         VertexArrayID id = 0;
         MBGL_CHECK_ERROR(vertexArray->genVertexArrays(1, &id));
         // NOLINTNEXTLINE(performance-move-const-arg)
         UniqueVertexArray vao(std::move(id), { this });
+        stats.numVertexArrays++;
         return { UniqueVertexArrayState(new VertexArrayState(std::move(vao)), VertexArrayStateDeleter { true })};
     } else {
         // On GL implementations which do not support vertex arrays, attribute bindings are global state.
@@ -239,6 +402,39 @@ VertexArray Context::createVertexArray() {
     }
 }
 
+VertexArray* Context::getVertexArray(const gfx::IndexBuffer& indexBuffer, const AttributeBindingArray& bindings) {
+    if (!supportsVertexArrays()) {
+        return nullptr;
+    }
+    VertexArrayKey key(indexBuffer, bindings);
+    auto it = vertexArrays.find(key);
+    if (it == vertexArrays.end()) {
+        it = vertexArrays.emplace(std::move(key), createVertexArray()).first;
+    }
+    return &it->second;
+}
+
+VertexArray& Context::getVertexArray(gfx::DrawScope& drawScope,
+                                     const gfx::IndexBuffer& indexBuffer,
+                                     const AttributeBindingArray& bindings) {
+    auto& resource = drawScope.getResource<gl::DrawScopeResource>();
+    if (!supportsVertexArrays()) {
+        return resource.vertexArray;
+    }
+    if (resource.shared && resource.sharedGeneration == vertexArrayGeneration &&
+        resource.sharedKey->matches(indexBuffer, bindings)) {
+        return *resource.shared;
+    }
+    resource.sharedKey.emplace(indexBuffer, bindings);
+    auto it = vertexArrays.find(*resource.sharedKey);
+    if (it == vertexArrays.end()) {
+        it = vertexArrays.emplace(*resource.sharedKey, createVertexArray()).first;
+    }
+    resource.shared = &it->second;
+    resource.sharedGeneration = vertexArrayGeneration;
+    return it->second;
+}
+
 UniqueFramebuffer Context::createFramebuffer() {
     FramebufferID id = 0;
     MBGL_CHECK_ERROR(glGenFramebuffers(1, &id));
@@ -249,21 +445,26 @@ UniqueFramebuffer Context::createFramebuffer() {
 
 std::unique_ptr<gfx::TextureResource> Context::createTextureResource(
     const Size size, const gfx::TexturePixelType format, const gfx::TextureChannelDataType type) {
-    auto obj = createUniqueTexture();
+    const TextureStorage storage{size, format, type};
+    auto pooled = takePooledTexture(storage);
+    auto obj = pooled ? std::move(*pooled) : createUniqueTexture();
     int textureByteSize = gl::TextureResource::getStorageSize(size, format, type);
     stats.memTextures += textureByteSize;
-    std::unique_ptr<gfx::TextureResource> resource =
-        std::make_unique<gl::TextureResource>(std::move(obj), textureByteSize);
+    auto resource = std::make_unique<gl::TextureResource>(std::move(obj), textureByteSize);
+    resource->storage = storage;
 
     // Always use texture unit 0 for manipulating it.
     activeTextureUnit = 0;
-    texture[0] = static_cast<gl::TextureResource&>(*resource).texture;
-
-    // Creates an empty texture with the specified size and format.
-    MBGL_CHECK_ERROR(glTexImage2D(GL_TEXTURE_2D, 0, Enum<gfx::TexturePixelType>::to(format),
-                                  size.width, size.height, 0,
-                                  Enum<gfx::TexturePixelType>::to(format),
-                                  Enum<gfx::TextureChannelDataType>::to(type), nullptr));
+    texture[0] = resource->texture;
+
+    // Creates an empty texture with the specified size and format. The contents of a pooled
+    // texture are as undefined as those of new storage.
+    if (!pooled) {
+        MBGL_CHECK_ERROR(glTexImage2D(GL_TEXTURE_2D, 0, Enum<gfx::TexturePixelType>::to(format),
+                                      size.width, size.height, 0,
+                                      Enum<gfx::TexturePixelType>::to(format),
+                                      Enum<gfx::TextureChannelDataType>::to(type), nullptr));
+    }
 
     // We are using clamp to edge here since OpenGL ES doesn't allow GL_REPEAT on NPOT textures.
     // We use those when the pixelRatio isn't a power of two, e.g. on iPhone 6 Plus.
@@ -315,6 +516,54 @@ std::unique_ptr<uint8_t[]> Context::readFramebuffer(const Size size, const gfx::
     return data;
 }
 
+void Context::startFramebufferRead(const Size size) {
+    assert(supportsPixelBufferObjects());
+
+    BufferID id = 0;
+    if (idlePixelPackBuffers.empty()) {
+        MBGL_CHECK_ERROR(glGenBuffers(1, &id));
+        stats.numBuffers++;
+        // NOLINTNEXTLINE(performance-move-const-arg)
+        idlePixelPackBuffers.emplace_back(std::move(id), detail::BufferDeleter{ *this });
+    }
+    UniqueBuffer buffer = std::move(idlePixelPackBuffers.back());
+    idlePixelPackBuffers.pop_back();
+
+    pixelStorePack = { 1 };
+
+    MBGL_CHECK_ERROR(glBindBuffer(GL_PIXEL_PACK_BUFFER, buffer));
+    MBGL_CHECK_ERROR(glBufferData(GL_PIXEL_PACK_BUFFER, size.width * size.height * 4, nullptr, GL_STREAM_READ));
+    MBGL_CHECK_ERROR(glReadPixels(0, 0, size.width, size.height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr));
+    MBGL_CHECK_ERROR(glBindBuffer(GL_PIXEL_PACK_BUFFER, 0));
+
+    framebufferReads.push_back({ std::move(buffer), size });
+}
+
+PremultipliedImage Context::takeFramebufferRead() {
+    assert(!framebufferReads.empty());
+    FramebufferRead read = std::move(framebufferReads.front());
+    framebufferReads.pop_front();
+
+    PremultipliedImage image(read.size);
+    const std::size_t stride = image.stride();
+
+    MBGL_CHECK_ERROR(glBindBuffer(GL_PIXEL_PACK_BUFFER, read.buffer));
+    // Waits for the copy if the GPU hasn't got to it yet.
+    const auto* pixels = static_cast<const uint8_t*>(MBGL_CHECK_ERROR(
+        pixelBufferObject->mapBufferRange(GL_PIXEL_PACK_BUFFER, 0, image.bytes(), GL_MAP_READ_BIT)));
+    if (pixels) {
+        // Flip the rows on the way out of the buffer, the copy has to be made anyway.
+        for (std::size_t row = 0; row < read.size.height; ++row) {
+            std::memcpy(image.data.get() + row * stride, pixels + (read.size.height - 1 - row) * stride, stride);
+        }
+        MBGL_CHECK_ERROR(pixelBufferObject->unmapBuffer(GL_PIXEL_PACK_BUFFER));
+    }
+    MBGL_CHECK_ERROR(glBindBuffer(GL_PIXEL_PACK_BUFFER, 0));
+
+    idlePixelPackBuffers.push_back(std::move(read.buffer));
+    return image;
+}
+
 #if not MBGL_USE_GLES2
 void Context::drawPixels(const Size size, const void* data, gfx::TexturePixelType format) {
     pixelStoreUnpack = { 1 };
@@ -448,13 +697,39 @@ Context::createOffscreenTexture(const Size size, const gfx::TextureChannelDataTy
     return std::make_unique<gl::OffscreenTexture>(*this, size, type);
 }
 
+std::unique_ptr<gfx::OffscreenTexture>
+Context::createOffscreenTextureWithDepthStencil(const Size size) {
+    return std::make_unique<gl::OffscreenTexture>(*this, size, gfx::TextureChannelDataType::UnsignedByte, true);
+}
+
 std::unique_ptr<gfx::DrawScopeResource> Context::createDrawScopeResource() {
-    return std::make_unique<gl::DrawScopeResource>(createVertexArray());
+    // Draws share the vertex arrays of the context when they are supported. Otherwise the bindings
+    // are global state, which draw scopes track.
+    return std::make_unique<gl::DrawScopeResource>(
+        VertexArray(UniqueVertexArrayState(&globalVertexArrayState, VertexArrayStateDeleter{false})));
 }
 
 void Context::reset() {
+    framebufferReads.clear();
+    idlePixelPackBuffers.clear();
+    vertexArrays.clear();
+    vertexArrayGeneration++;
     std::copy(pooledTextures.begin(), pooledTextures.end(), std::back_inserter(abandonedTextures));
     pooledTextures.resize(0);
+    abandonTexturePool();
+    if (timerQuery) {
+        if (activeTimerQuery) {
+            MBGL_CHECK_ERROR(timerQuery->endQuery(GL_TIME_ELAPSED));
+            idleTimerQueries.push_back(*activeTimerQuery);
+            activeTimerQuery = nullopt;
+        }
+        idleTimerQueries.insert(idleTimerQueries.end(), pendingTimerQueries.begin(), pendingTimerQueries.end());
+        pendingTimerQueries.clear();
+        if (!idleTimerQueries.empty()) {
+            MBGL_CHECK_ERROR(timerQuery->deleteQueries(static_cast<GLsizei>(idleTimerQueries.size()), idleTimerQueries.data()));
+            idleTimerQueries.clear();
+        }
+    }
     performCleanup();
 }
 
@@ -600,13 +875,64 @@ const gfx::RenderingStats& Context::renderingStats() const {
     return stats;
 }
 
+void Context::beginGPUTimer() {
+    // Drivers may only answer queries a few frames late, skip frames while the results pile up.
+    constexpr std::size_t maxPendingTimerQueries = 4;
+    if (!timerQuery || activeTimerQuery || pendingTimerQueries.size() >= maxPendingTimerQueries) {
+        return;
+    }
+
+    if (idleTimerQueries.empty()) {
+        GLuint id = 0;
+        MBGL_CHECK_ERROR(timerQuery->genQueries(1, &id));
+        idleTimerQueries.push_back(id);
+    }
+    activeTimerQuery = idleTimerQueries.back();
+    idleTimerQueries.pop_back();
+    MBGL_CHECK_ERROR(timerQuery->beginQuery(GL_TIME_ELAPSED, *activeTimerQuery));
+}
+
+optional<Duration> Context::endGPUTimer() {
+    if (!timerQuery) {
+        return nullopt;
+    }
+
+    if (activeTimerQuery) {
+        MBGL_CHECK_ERROR(timerQuery->endQuery(GL_TIME_ELAPSED));
+        pendingTimerQueries.push_back(*activeTimerQuery);
+        activeTimerQuery = nullopt;
+    }
+
+    optional<Duration> result;
+    while (!pendingTimerQueries.empty()) {
+        const GLuint id = pendingTimerQueries.front();
+        GLuint available = GL_FALSE;
+        MBGL_CHECK_ERROR(timerQuery->getQueryObjectuiv(id, GL_QUERY_RESULT_AVAILABLE, &available));
+        if (!available) {
+            break;
+        }
+        uint64_t elapsed = 0;
+        MBGL_CHECK_ERROR(timerQuery->getQueryObjectui64v(id, GL_QUERY_RESULT, &elapsed));
+        result = std::chrono::duration_cast<Duration>(std::chrono::nanoseconds(elapsed));
+        pendingTimerQueries.pop_front();
+        idleTimerQueries.push_back(id);
+    }
+
+    if (result && timerQueryCanBeDisjoint) {
+        GLint disjoint = GL_FALSE;
+        MBGL_CHECK_ERROR(glGetIntegerv(GL_GPU_DISJOINT_EXT, &disjoint));
+        if (disjoint) {
+            result = nullopt;
+        }
+    }
+    return result;
+}
+
 void Context::finish() {
     MBGL_CHECK_ERROR(glFinish());
 }
 
-void Context::draw(const gfx::DrawMode& drawMode,
-                   std::size_t indexOffset,
-                   std::size_t indexLength) {
+void Context::setDrawMode(const gfx::DrawMode& drawMode) {
     switch (drawMode.type) {
     case gfx::DrawModeType::Points:
 #if not MBGL_USE_GLES2
@@ -622,6 +948,12 @@ void Context::draw(const gfx::DrawMode& drawMode,
     default:
         break;
     }
+}
+
+void Context::draw(const gfx::DrawMode& drawMode,
+                   std::size_t indexOffset,
+                   std::size_t indexLength) {
+    setDrawMode(drawMode);
 
     MBGL_CHECK_ERROR(glDrawElements(
         Enum<gfx::DrawModeType>::to(drawMode.type),
@@ -632,6 +964,23 @@ void Context::draw(const gfx::DrawMode& drawMode,
     stats.numDrawCalls++;
 }
 
+void Context::drawInstanced(const gfx::DrawMode& drawMode,
+                            std::size_t indexOffset,
+                            std::size_t indexLength,
+                            std::size_t instanceCount) {
+    assert(supportsInstancedArrays());
+    setDrawMode(drawMode);
+
+    MBGL_CHECK_ERROR(instancedArrays->drawElementsInstanced(
+        Enum<gfx::DrawModeType>::to(drawMode.type),
+        static_cast<GLsizei>(indexLength),
+        GL_UNSIGNED_SHORT,
+        reinterpret_cast<GLvoid*>(sizeof(uint16_t) * indexOffset),
+        static_cast<GLsizei>(instanceCount)));
+
+    stats.numDrawCalls++;
+}
+
 void Context::performCleanup() {
     // TODO: Find a better way to unbind VAOs after we're done with them without introducing
     // unnecessary bind(0)/bind(N) sequences.
@@ -658,6 +1007,18 @@ void Context::performCleanup() {
     abandonedShaders.clear();
 
     if (!abandonedBuffers.empty()) {
+        // The names of the buffers may be handed out again, which must not match the vertex arrays
+        // that still refer to the deleted buffers. Their vertex arrays are deleted further below.
+        if (!vertexArrays.empty()) {
+            const std::unordered_set<BufferID> deleted(abandonedBuffers.begin(), abandonedBuffers.end());
+            const std::size_t count = vertexArrays.size();
+            for (auto it = vertexArrays.begin(); it != vertexArrays.end();) {
+                it = it->first.uses(deleted) ? vertexArrays.erase(it) : std::next(it);
+            }
+            if (vertexArrays.size() != count) {
+                vertexArrayGeneration++;
+            }
+        }
         for (const auto id : abandonedBuffers) {
             if (vertexBuffer == id) {
                 vertexBuffer.setDirty();
@@ -670,6 +1031,13 @@ void Context::performCleanup() {
         abandonedBuffers.clear();
     }
 
+    // The storage of the least recently pooled textures goes first.
+    while (texturePoolBytes > TexturePoolMaxBytes) {
+        unpoolTexture(texturePool.front());
+        abandonedTextures.push_back(texturePool.front().id);
+        texturePool.pop_front();
+    }
+
     if (!abandonedTextures.empty()) {
         for (const auto id : abandonedTextures) {
             for (auto& binding : texture) {
@@ -693,6 +1061,8 @@ void Context::performCleanup() {
         }
         MBGL_CHECK_ERROR(vertexArray->deleteVertexArrays(int(abandonedVertexArrays.size()),
                                                          abandonedVertexArrays.data()));
+        stats.numVertexArrays -= int(abandonedVertexArrays.size());
+        assert(stats.numVertexArrays >= 0);
         abandonedVertexArrays.clear();
     }
 
@@ -717,6 +1087,8 @@ void Context::performCleanup() {
 }
 
 void Context::reduceMemoryUsage() {
+    // Pooled storage is only kept to speed up rendering, so it is the first to go.
+    abandonTexturePool();
     performCleanup();
 
     // Ensure that all pending actions are executed to ensure that they happen before the app goes
@@ -1,10 +1,13 @@
 #pragma once
 
 #include <mbgl/gfx/context.hpp>
+#include <mbgl/gl/binary_program.hpp>
+#include <mbgl/gl/buffer_pool.hpp>
 #include <mbgl/gl/object.hpp>
 #include <mbgl/gl/state.hpp>
 #include <mbgl/gl/value.hpp>
 #include <mbgl/gl/framebuffer.hpp>
+#include <mbgl/gl/texture_resource.hpp>
 #include <mbgl/gl/vertex_array.hpp>
 #include <mbgl/gl/types.hpp>
 #include <mbgl/gfx/texture.hpp>
@@ -13,10 +16,14 @@
 #include <mbgl/gfx/stencil_mode.hpp>
 #include <mbgl/gfx/color_mode.hpp>
 #include <mbgl/platform/gl_functions.hpp>
+#include <mbgl/util/image.hpp>
 #include <mbgl/util/noncopyable.hpp>
+#include <mbgl/util/optional.hpp>
 
 
+#include <deque>
 #include <functional>
+#include <map>
 #include <memory>
 #include <vector>
 #include <array>
@@ -26,12 +33,19 @@ namespace mbgl {
 namespace gl {
 
 constexpr size_t TextureMax = 64;
+// The bytes of texture storage that the texture pool keeps for reuse.
+constexpr int TexturePoolMaxBytes = 16 * 1024 * 1024;
 using ProcAddress = void (*)();
 class RendererBackend;
 
 namespace extension {
 class VertexArray;
 class Debugging;
+class InstancedArrays;
+class ProgramBinary;
+class ParallelShaderCompile;
+class PixelBufferObject;
+class TimerQuery;
 } // namespace extension
 
 class Context final : public gfx::Context {
@@ -46,15 +60,30 @@ public:
     gfx::RenderingStats& renderingStats();
     const gfx::RenderingStats& renderingStats() const override;
 
+    void beginGPUTimer() override;
+    optional<Duration> endGPUTimer() override;
+
     void initializeExtensions(const std::function<gl::ProcAddress(const char*)>&);
 
     void enableDebugging();
 
     UniqueShader createShader(ShaderType type, const std::initializer_list<const char*>& sources);
+    // Where supportsParallelShaderCompile(), the program may still be linking when this returns, and
+    // isProgramLinkComplete() tells when verifyProgramLinkage() won't wait for the driver.
     UniqueProgram createProgram(ShaderID vertexShader, ShaderID fragmentShader, const char* location0AttribName);
+    // Loads a program previously retrieved with getBinaryProgram(), requires supportsProgramBinaries().
+    // Throws when the driver rejects the binary.
+    UniqueProgram createProgram(const BinaryProgram&);
+    optional<BinaryProgram> getBinaryProgram(ProgramID, std::string identifier) const;
     void verifyProgramLinkage(ProgramID);
+    bool isProgramLinkComplete(ProgramID) const;
     void linkProgram(ProgramID);
     UniqueTexture createUniqueTexture();
+    // A texture that already has storage of this kind, from the texture pool.
+    optional<UniqueTexture> takePooledTexture(const TextureStorage&);
+    // Keeps a texture that is no longer used with its storage, until a texture of the same kind is
+    // needed or the pool exceeds TexturePoolMaxBytes.
+    void poolTexture(TextureID, const TextureStorage&, int byteSize);
 
     Framebuffer createFramebuffer(const gfx::Renderbuffer<gfx::RenderbufferPixelType::RGBA>&,
                                   const gfx::Renderbuffer<gfx::RenderbufferPixelType::DepthStencil>&);
@@ -74,6 +103,15 @@ public:
         return { size, readFramebuffer(size, format, flip) };
     }
 
+    // Starts copying the framebuffer into a pixel buffer object and returns without waiting for
+    // the GPU, requires supportsPixelBufferObjects(). takeFramebufferRead() returns the copies in
+    // the order they were started.
+    void startFramebufferRead(Size);
+    PremultipliedImage takeFramebufferRead();
+    bool hasFramebufferReads() const {
+        return !framebufferReads.empty();
+    }
+
 #if not MBGL_USE_GLES2
     template <typename Image>
     void drawPixels(const Image& image) {
@@ -94,6 +132,11 @@ public:
     void draw(const gfx::DrawMode&,
               std::size_t indexOffset,
               std::size_t indexLength);
+    // Draws the indices `instanceCount` times, requires supportsInstancedArrays().
+    void drawInstanced(const gfx::DrawMode&,
+                       std::size_t indexOffset,
+                       std::size_t indexLength,
+                       std::size_t instanceCount);
 
     void finish();
 
@@ -109,6 +152,7 @@ public:
 
     bool empty() const {
         return pooledTextures.empty()
+            && texturePool.empty()
             && abandonedPrograms.empty()
             && abandonedShaders.empty()
             && abandonedBuffers.empty()
@@ -119,6 +163,15 @@ public:
 
     void setDirtyState();
 
+    // The vertex array for these bindings, created on first use and shared by every draw that
+    // binds the same buffers the same way. Without vertex array support, the bindings are global
+    // state and the draw scope's vertex array is used instead.
+    VertexArray* getVertexArray(const gfx::IndexBuffer&, const AttributeBindingArray&);
+    // As above, but remembers the vertex array in the draw scope, whose draws usually bind the
+    // same buffers every frame: those only compare their bindings with the remembered key. Returns
+    // the draw scope's vertex array without vertex array support.
+    VertexArray& getVertexArray(gfx::DrawScope&, const gfx::IndexBuffer&, const AttributeBindingArray&);
+
     extension::Debugging* getDebuggingExtension() const {
         return debugging.get();
     }
@@ -127,6 +180,29 @@ public:
         return vertexArray.get();
     }
 
+    extension::InstancedArrays* getInstancedArraysExtension() const {
+        return instancedArrays.get();
+    }
+
+    // Whether drawInstanced() and attribute bindings with an instance divisor work.
+    bool supportsInstancedArrays() const;
+
+    // Whether linked programs can be retrieved and loaded back as binaries.
+    bool supportsProgramBinaries() const;
+
+    // Whether framebuffer reads can complete asynchronously, into pixel buffer objects.
+    bool supportsPixelBufferObjects() const;
+
+    // Whether shaders compile and programs link on driver threads, without blocking the calls.
+    bool supportsParallelShaderCompile() const {
+        return bool(parallelShaderCompile);
+    }
+
+    // Identifies the driver, program binaries of other drivers must not be loaded.
+    const std::string& getDriverIdentifier() const {
+        return driverIdentifier;
+    }
+
     void setCleanupOnDestruction(bool cleanup) {
         cleanupOnDestruction = cleanup;
     }
@@ -138,6 +214,17 @@ private:
     gfx::RenderingStats stats;
     std::unique_ptr<extension::Debugging> debugging;
     std::unique_ptr<extension::VertexArray> vertexArray;
+    std::unique_ptr<extension::InstancedArrays> instancedArrays;
+    std::unique_ptr<extension::ProgramBinary> programBinary;
+    std::unique_ptr<extension::ParallelShaderCompile> parallelShaderCompile;
+    std::unique_ptr<extension::PixelBufferObject> pixelBufferObject;
+    std::unique_ptr<extension::TimerQuery> timerQuery;
+    // Only EXT_disjoint_timer_query reports events, e.g. frequency changes, that invalidate measurements.
+    bool timerQueryCanBeDisjoint = false;
+    optional<platform::GLuint> activeTimerQuery;
+    std::deque<platform::GLuint> pendingTimerQueries;
+    std::vector<platform::GLuint> idleTimerQueries;
+    std::string driverIdentifier;
 
 public:
     State<value::ActiveTextureUnit> activeTextureUnit;
@@ -151,6 +238,10 @@ public:
     State<value::BindVertexArray, const Context&> bindVertexArray { *this };
     VertexArrayState globalVertexArrayState { UniqueVertexArray(0, { this }) };
 
+    // Static vertex and index buffers are suballocated from these.
+    BufferPool vertexBufferPool;
+    BufferPool indexBufferPool;
+
     State<value::PixelStorePack> pixelStorePack;
     State<value::PixelStoreUnpack> pixelStoreUnpack;
 
@@ -188,6 +279,7 @@ private:
 #endif // MBGL_USE_GLES2
 
     std::unique_ptr<gfx::OffscreenTexture> createOffscreenTexture(Size, gfx::TextureChannelDataType) override;
+    std::unique_ptr<gfx::OffscreenTexture> createOffscreenTextureWithDepthStencil(Size) override;
 
     std::unique_ptr<gfx::TextureResource>
         createTextureResource(Size, gfx::TexturePixelType, gfx::TextureChannelDataType) override;
@@ -204,6 +296,7 @@ private:
 
     VertexArray createVertexArray();
     bool supportsVertexArrays() const;
+    void setDrawMode(const gfx::DrawMode&);
 
     friend detail::ProgramDeleter;
     friend detail::ShaderDeleter;
@@ -215,6 +308,21 @@ private:
 
     std::vector<TextureID> pooledTextures;
 
+    struct PooledTexture {
+        TextureID id;
+        TextureStorage storage;
+        int byteSize;
+        // Pooled storage is reported as shared "texture pool" memory.
+        gfx::MemoryTracker::Handle memory;
+    };
+    // Least recently pooled first.
+    std::deque<PooledTexture> texturePool;
+    int texturePoolBytes = 0;
+
+    void unpoolTexture(const PooledTexture&);
+    // Moves all the pooled textures to the abandoned ones.
+    void abandonTexturePool();
+
     std::vector<ProgramID> abandonedPrograms;
     std::vector<ShaderID> abandonedShaders;
     std::vector<BufferID> abandonedBuffers;
@@ -223,6 +331,18 @@ private:
     std::vector<FramebufferID> abandonedFramebuffers;
     std::vector<RenderbufferID> abandonedRenderbuffers;
 
+    // Dropped along with the buffers they refer to, before the names of the buffers can be reused.
+    std::map<VertexArrayKey, VertexArray> vertexArrays;
+    // Incremented whenever vertex arrays are deleted, which invalidates the ones draw scopes remember.
+    uint64_t vertexArrayGeneration = 0;
+
+    struct FramebufferRead {
+        UniqueBuffer buffer;
+        Size size;
+    };
+    std::deque<FramebufferRead> framebufferReads;
+    std::vector<UniqueBuffer> idlePixelPackBuffers;
+
 public:
     // For testing
     bool disableVAOExtension = false;
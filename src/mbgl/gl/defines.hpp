@@ -161,12 +161,16 @@
 #define GL_UNSIGNED_BYTE 0x1401
 #define GL_UNSIGNED_INT 0x1405
 #define GL_UNSIGNED_SHORT 0x1403
+#define GL_VENDOR 0x1F00
+#define GL_VERSION 0x1F02
 #define GL_VERTEX_SHADER 0x8B31
 #define GL_VIEWPORT 0x0BA2
 #define GL_ZERO 0
 #ifdef MBGL_USE_GLES2
+#define GL_ETC1_RGB8_OES 0x8D64
 #define GL_HALF_FLOAT 0x8D61
 #else
+#define GL_COMPRESSED_RGB8_ETC2 0x9274
 #define GL_CURRENT_RASTER_POSITION 0x0B07
 #define GL_DEPTH24_STENCIL8 0x88F0
 #define GL_DEPTH_BIAS 0x0D1F
@@ -2,6 +2,9 @@
 
 #include <mbgl/gfx/draw_scope.hpp>
 #include <mbgl/gl/vertex_array.hpp>
+#include <mbgl/util/optional.hpp>
+
+#include <cstdint>
 
 namespace mbgl {
 namespace gl {
@@ -12,6 +15,12 @@ public:
     }
 
     VertexArray vertexArray;
+
+    // The shared vertex array of the last draw, see Context::getVertexArray(). Valid while the
+    // context hasn't deleted any vertex array since.
+    optional<VertexArrayKey> sharedKey;
+    VertexArray* shared = nullptr;
+    uint64_t sharedGeneration = 0;
 };
 
 } // namespace gl
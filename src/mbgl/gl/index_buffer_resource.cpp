@@ -4,11 +4,34 @@
 namespace mbgl {
 namespace gl {
 
+IndexBufferResource::IndexBufferResource(UniqueBuffer&& buffer_, int byteSize_, gfx::BufferUsageType usage_)
+    : buffer(buffer_.get()),
+      byteOffset(0),
+      byteSize(byteSize_),
+      usage(usage_),
+      context(buffer_.get_deleter().context),
+      ownBuffer(std::move(buffer_)),
+      memory(context.memoryTracker().add(gfx::MemoryType::IndexBuffer, byteSize)) {}
+
+IndexBufferResource::IndexBufferResource(Context& context_, BufferPool::Allocation&& allocation_, int byteSize_)
+    : buffer(allocation_.getBuffer()),
+      byteOffset(allocation_.getOffset()),
+      byteSize(byteSize_),
+      usage(gfx::BufferUsageType::StaticDraw),
+      context(context_),
+      allocation(std::move(allocation_)),
+      memory(context.memoryTracker().add(gfx::MemoryType::IndexBuffer, byteSize)) {}
+
+bool IndexBufferResource::orphansOnUpdate() const {
+    return ownBuffer && usage != gfx::BufferUsageType::StaticDraw;
+}
+
 IndexBufferResource::~IndexBufferResource() {
-    auto& stats = buffer.get_deleter().context.renderingStats();
+    auto& stats = context.renderingStats();
     stats.memIndexBuffers -= byteSize;
     assert(stats.memIndexBuffers >= 0);
+    context.memoryTracker().remove(memory, gfx::MemoryType::IndexBuffer, byteSize);
 }
 
 } // namespace gl
-} // namespace mbgl
\ No newline at end of file
+} // namespace mbgl
@@ -1,18 +1,37 @@
 #pragma once
 
+#include <mbgl/gfx/types.hpp>
 #include <mbgl/gfx/index_buffer.hpp>
+#include <mbgl/gfx/memory_tracker.hpp>
+#include <mbgl/gl/buffer_pool.hpp>
 #include <mbgl/gl/object.hpp>
 
 namespace mbgl {
 namespace gl {
 
+class Context;
+
 class IndexBufferResource : public gfx::IndexBufferResource {
 public:
-    IndexBufferResource(UniqueBuffer&& buffer_, int byteSize_) : buffer(std::move(buffer_)), byteSize(byteSize_) {}
+    IndexBufferResource(UniqueBuffer&& buffer_, int byteSize_, gfx::BufferUsageType usage_);
+    // The data starts at `byteOffset` of a buffer shared with other resources.
+    IndexBufferResource(Context&, BufferPool::Allocation&& allocation_, int byteSize_);
     ~IndexBufferResource() override;
 
-    UniqueBuffer buffer;
+    BufferID buffer;
+    std::size_t byteOffset;
     int byteSize;
+    gfx::BufferUsageType usage;
+
+    // Whether whole updates replace the storage instead of writing into storage that draws of
+    // previous frames may still read from.
+    bool orphansOnUpdate() const;
+
+private:
+    Context& context;
+    optional<UniqueBuffer> ownBuffer;
+    BufferPool::Allocation allocation;
+    gfx::MemoryTracker::Handle memory;
 };
 
 } // namespace gl
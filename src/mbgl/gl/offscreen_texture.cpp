@@ -10,8 +10,9 @@ class OffscreenTextureResource final : public gl::RenderableResource {
 public:
     OffscreenTextureResource(gl::Context& context_,
                              const Size size_,
-                             const gfx::TextureChannelDataType type_)
-        : context(context_), size(size_), type(type_) {
+                             const gfx::TextureChannelDataType type_,
+                             const bool depthStencil_)
+        : context(context_), size(size_), type(type_), depthStencil(depthStencil_) {
         assert(!size.isEmpty());
     }
 
@@ -19,7 +20,12 @@ public:
         if (!framebuffer) {
             assert(!texture);
             texture = context.createTexture(size, gfx::TexturePixelType::RGBA, type);
-            framebuffer = context.createFramebuffer(*texture);
+            if (depthStencil) {
+                depthStencilBuffer = context.createRenderbuffer<gfx::RenderbufferPixelType::DepthStencil>(size);
+                framebuffer = context.createFramebuffer(*texture, *depthStencilBuffer);
+            } else {
+                framebuffer = context.createFramebuffer(*texture);
+            }
         } else {
             context.bindFramebuffer = framebuffer->framebuffer;
         }
@@ -45,13 +51,16 @@ private:
     const Size size;
     optional<gfx::Texture> texture;
     const gfx::TextureChannelDataType type;
+    const bool depthStencil;
+    optional<gfx::Renderbuffer<gfx::RenderbufferPixelType::DepthStencil>> depthStencilBuffer;
     optional<gl::Framebuffer> framebuffer;
 };
 
 OffscreenTexture::OffscreenTexture(gl::Context& context,
                                    const Size size_,
-                                   const gfx::TextureChannelDataType type)
-    : gfx::OffscreenTexture(size, std::make_unique<OffscreenTextureResource>(context, size_, type)) {
+                                   const gfx::TextureChannelDataType type,
+                                   const bool depthStencil)
+    : gfx::OffscreenTexture(size_, std::make_unique<OffscreenTextureResource>(context, size_, type, depthStencil)) {
 }
 
 bool OffscreenTexture::isRenderable() {
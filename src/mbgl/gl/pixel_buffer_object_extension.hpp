@@ -0,0 +1,39 @@
+#pragma once
+
+#include <mbgl/gl/extension.hpp>
+#include <mbgl/gl/defines.hpp>
+#include <mbgl/platform/gl_functions.hpp>
+
+#define GL_PIXEL_PACK_BUFFER 0x88EB
+#define GL_STREAM_READ 0x88E1
+#define GL_MAP_READ_BIT 0x0001
+
+namespace mbgl {
+namespace gl {
+namespace extension {
+
+class PixelBufferObject {
+public:
+    template <typename Fn>
+    PixelBufferObject(const Fn& loadExtension)
+        : mapBufferRange(
+              loadExtension({ { "GL_ARB_map_buffer_range", "glMapBufferRange" },
+                              { "GL_EXT_map_buffer_range", "glMapBufferRangeEXT" } })),
+          unmapBuffer(
+              loadExtension({ { "GL_ARB_map_buffer_range", "glUnmapBuffer" },
+                              { "GL_EXT_map_buffer_range", "glUnmapBufferOES" },
+                              { "GL_OES_mapbuffer", "glUnmapBufferOES" } })) {
+    }
+
+    const ExtensionFunction<void*(platform::GLenum target,
+                                  platform::GLintptr offset,
+                                  platform::GLsizeiptr length,
+                                  platform::GLbitfield access)>
+        mapBufferRange;
+
+    const ExtensionFunction<platform::GLboolean(platform::GLenum target)> unmapBuffer;
+};
+
+} // namespace extension
+} // namespace gl
+} // namespace mbgl
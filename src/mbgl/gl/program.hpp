@@ -5,6 +5,7 @@
 #include <mbgl/gl/object.hpp>
 #include <mbgl/gl/context.hpp>
 #include <mbgl/gl/draw_scope_resource.hpp>
+#include <mbgl/gl/index_buffer_resource.hpp>
 #include <mbgl/gfx/vertex_buffer.hpp>
 #include <mbgl/gfx/index_buffer.hpp>
 #include <mbgl/gfx/uniform.hpp>
@@ -12,6 +13,7 @@
 #include <mbgl/gl/attribute.hpp>
 #include <mbgl/gl/uniform.hpp>
 #include <mbgl/gl/texture.hpp>
+#include <mbgl/gl/binary_program.hpp>
 #include <mbgl/util/io.hpp>
 
 #include <mbgl/util/logging.hpp>
@@ -44,21 +46,55 @@ public:
     public:
         Instance(Context& context,
                  const std::initializer_list<const char*>& vertexSource,
-                 const std::initializer_list<const char*>& fragmentSource)
+                 const std::initializer_list<const char*>& fragmentSource,
+                 optional<std::string> cachePath_,
+                 std::string identifier_)
             : program(context.createProgram(
                   context.createShader(ShaderType::Vertex, vertexSource),
                   context.createShader(ShaderType::Fragment, fragmentSource),
-                  attributeLocations.getFirstAttribName())) {
-            attributeLocations.queryLocations(program);
-            uniformStates.queryLocations(program);
-            // Texture units are specified via uniforms as well, so we need query their locations
-            textureStates.queryLocations(program);
+                  attributeLocations.getFirstAttribName())),
+              cachePath(std::move(cachePath_)),
+              identifier(std::move(identifier_)) {
+            // With parallel shader compilation, the driver may still be linking.
+            isLinked(context);
+        }
+
+        Instance(Context& context, const BinaryProgram& binaryProgram)
+            : program(context.createProgram(binaryProgram)) {
+            queryLocations();
+            linked = true;
         }
 
         static std::unique_ptr<Instance>
         createInstance(gl::Context& context,
                        const ProgramParameters& programParameters,
                        const std::string& additionalDefines) {
+            // Load the program linked by an earlier run, if the driver and sources are the same
+            optional<std::string> cachePath =
+                context.supportsProgramBinaries()
+                    ? programParameters.cachePath(programs::gl::ShaderSource<Name>::name, additionalDefines)
+                    : optional<std::string>{};
+            std::string identifier;
+            if (cachePath) {
+                identifier = programs::gl::programIdentifier(programParameters.getDefines(),
+                                                             additionalDefines,
+                                                             programs::gl::ShaderSource<Name>::hash) +
+                             context.getDriverIdentifier();
+                try {
+                    if (auto cachedBinaryProgram = util::readFile(*cachePath)) {
+                        const BinaryProgram binaryProgram(std::move(*cachedBinaryProgram));
+                        if (binaryProgram.identifier() == identifier) {
+                            return std::make_unique<Instance>(context, binaryProgram);
+                        } else {
+                            Log::Info(Event::Shader, "Cached program %s changed, recompiling",
+                                      programs::gl::ShaderSource<Name>::name);
+                        }
+                    }
+                } catch (const std::runtime_error& error) {
+                    Log::Warning(Event::Shader, "Could not load cached program: %s", error.what());
+                }
+            }
+
             // Compile the shader
             const std::initializer_list<const char*> vertexSource = {
                 programParameters.getDefines().c_str(),
@@ -72,15 +108,52 @@ public:
                 (programs::gl::shaderSource() + programs::gl::fragmentPreludeOffset),
                 (programs::gl::shaderSource() + fragmentOffset)
             };
-            auto result = std::make_unique<Instance>(context, vertexSource, fragmentSource);
+            return std::make_unique<Instance>(
+                context, vertexSource, fragmentSource, std::move(cachePath), std::move(identifier));
+        }
 
-            return std::move(result);
+        // Whether the program can be used. Doesn't wait for a link that is still in progress, but
+        // throws if the link failed.
+        bool isLinked(Context& context) {
+            if (linked) {
+                return true;
+            }
+            if (!context.isProgramLinkComplete(program)) {
+                return false;
+            }
+            context.verifyProgramLinkage(program);
+            queryLocations();
+            linked = true;
+
+            if (cachePath) {
+                try {
+                    if (const auto binaryProgram = context.getBinaryProgram(program, std::move(identifier))) {
+                        util::write_file(*cachePath, binaryProgram->serialize());
+                    }
+                } catch (const std::runtime_error& error) {
+                    Log::Warning(Event::Shader, "Could not cache program: %s", error.what());
+                }
+                cachePath = {};
+            }
+            return true;
         }
 
         UniqueProgram program;
         gl::AttributeLocations<AttributeList> attributeLocations;
         gl::UniformStates<UniformList> uniformStates;
         gl::TextureStates<TextureList> textureStates;
+
+    private:
+        void queryLocations() {
+            attributeLocations.queryLocations(program);
+            uniformStates.queryLocations(program);
+            // Texture units are specified via uniforms as well, so we need query their locations
+            textureStates.queryLocations(program);
+        }
+
+        bool linked = false;
+        optional<std::string> cachePath;
+        std::string identifier;
     };
 
     void draw(gfx::Context& genericContext,
@@ -117,19 +190,25 @@ public:
         }
 
         auto& instance = *it->second;
+        if (!instance.isLinked(context)) {
+            // Skip the draw for this frame rather than wait for the driver to finish linking.
+            context.renderingStats().numSkippedDrawCalls++;
+            return;
+        }
         context.program = instance.program;
 
         instance.uniformStates.bind(uniformValues);
 
         instance.textureStates.bind(context, textureBindings);
 
-        auto& vertexArray = drawScope.getResource<gl::DrawScopeResource>().vertexArray;
-        vertexArray.bind(context,
-                        indexBuffer,
-                        instance.attributeLocations.toBindingArray(attributeBindings));
+        const auto bindings = instance.attributeLocations.toBindingArray(attributeBindings);
+        context.getVertexArray(drawScope, indexBuffer, bindings).bind(context, indexBuffer, bindings);
 
+        // Pooled index buffers start at an offset into a shared buffer.
+        const std::size_t indexBufferOffset =
+            indexBuffer.getResource<gl::IndexBufferResource>().byteOffset / sizeof(uint16_t);
         context.draw(drawMode,
-                     indexOffset,
+                     indexBufferOffset + indexOffset,
                      indexLength);
     }
 
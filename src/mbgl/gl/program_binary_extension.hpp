@@ -0,0 +1,43 @@
+#pragma once
+
+#include <mbgl/gl/extension.hpp>
+#include <mbgl/gl/defines.hpp>
+#include <mbgl/platform/gl_functions.hpp>
+
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+#define GL_PROGRAM_BINARY_FORMATS 0x87FF
+
+namespace mbgl {
+namespace gl {
+namespace extension {
+
+class ProgramBinary {
+public:
+    template <typename Fn>
+    ProgramBinary(const Fn& loadExtension)
+        : getProgramBinary(
+              loadExtension({ { "GL_OES_get_program_binary", "glGetProgramBinaryOES" },
+                              { "GL_ARB_get_program_binary", "glGetProgramBinary" } })),
+          programBinary(
+              loadExtension({ { "GL_OES_get_program_binary", "glProgramBinaryOES" },
+                              { "GL_ARB_get_program_binary", "glProgramBinary" } })) {
+    }
+
+    const ExtensionFunction<void(platform::GLuint program,
+                                 platform::GLsizei bufSize,
+                                 platform::GLsizei* length,
+                                 platform::GLenum* binaryFormat,
+                                 void* binary)>
+        getProgramBinary;
+
+    const ExtensionFunction<void(platform::GLuint program,
+                                 platform::GLenum binaryFormat,
+                                 const void* binary,
+                                 platform::GLint length)>
+        programBinary;
+};
+
+} // namespace extension
+} // namespace gl
+} // namespace mbgl
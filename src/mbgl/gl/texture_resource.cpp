@@ -31,10 +31,21 @@ static int channelStorageSize(gfx::TextureChannelDataType type) {
     }
 }
 
+TextureResource::TextureResource(UniqueTexture&& texture_, int byteSize_)
+    : texture(std::move(texture_)),
+      byteSize(byteSize_),
+      memory(texture.get_deleter().context->memoryTracker().add(gfx::MemoryType::Texture, byteSize)) {}
+
 TextureResource::~TextureResource() {
-    auto& stats = texture.get_deleter().context->renderingStats();
+    auto& context = *texture.get_deleter().context;
+    auto& stats = context.renderingStats();
     stats.memTextures -= byteSize;
     assert(stats.memTextures >= 0);
+    context.memoryTracker().remove(memory, gfx::MemoryType::Texture, byteSize);
+    if (storage) {
+        // The storage may have been respecified since the resource was created.
+        context.poolTexture(texture.release(), *storage, getStorageSize(storage->size, storage->format, storage->type));
+    }
 }
 
 int TextureResource::getStorageSize(const Size& size, gfx::TexturePixelType format, gfx::TextureChannelDataType type) {
@@ -1,14 +1,30 @@
 #pragma once
 
+#include <mbgl/gfx/memory_tracker.hpp>
 #include <mbgl/gfx/texture.hpp>
 #include <mbgl/gl/object.hpp>
+#include <mbgl/util/optional.hpp>
+
+#include <tuple>
 
 namespace mbgl {
 namespace gl {
 
+// The uncompressed storage of a texture, which textures of the same size, format and channel type
+// can take over.
+struct TextureStorage {
+    Size size;
+    gfx::TexturePixelType format;
+    gfx::TextureChannelDataType type;
+
+    friend bool operator==(const TextureStorage& lhs, const TextureStorage& rhs) {
+        return std::tie(lhs.size, lhs.format, lhs.type) == std::tie(rhs.size, rhs.format, rhs.type);
+    }
+};
+
 class TextureResource : public gfx::TextureResource {
 public:
-    TextureResource(UniqueTexture&& texture_, int byteSize_) : texture(std::move(texture_)), byteSize(byteSize_) {}
+    TextureResource(UniqueTexture&& texture_, int byteSize_);
     ~TextureResource() override;
 
     static int getStorageSize(const Size& size, gfx::TexturePixelType format, gfx::TextureChannelDataType type);
@@ -19,6 +35,12 @@ public:
     gfx::TextureWrapType wrapX = gfx::TextureWrapType::Clamp;
     gfx::TextureWrapType wrapY = gfx::TextureWrapType::Clamp;
     int byteSize;
+    // Set when the storage can be reused, in which case the texture goes to the texture pool of
+    // the context along with its storage once the resource is destroyed.
+    optional<TextureStorage> storage;
+
+private:
+    gfx::MemoryTracker::Handle memory;
 };
 
 } // namespace gl
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <mbgl/gl/extension.hpp>
+#include <mbgl/gl/defines.hpp>
+#include <mbgl/platform/gl_functions.hpp>
+
+#include <cstdint>
+
+#define GL_TIME_ELAPSED 0x88BF
+#define GL_QUERY_RESULT 0x8866
+#define GL_QUERY_RESULT_AVAILABLE 0x8867
+#define GL_GPU_DISJOINT_EXT 0x8FBB
+
+namespace mbgl {
+namespace gl {
+namespace extension {
+
+class TimerQuery {
+public:
+    template <typename Fn>
+    TimerQuery(const Fn& loadExtension)
+        : genQueries(
+              loadExtension({ { "GL_EXT_disjoint_timer_query", "glGenQueriesEXT" },
+                              { "GL_ARB_timer_query", "glGenQueries" } })),
+          deleteQueries(
+              loadExtension({ { "GL_EXT_disjoint_timer_query", "glDeleteQueriesEXT" },
+                              { "GL_ARB_timer_query", "glDeleteQueries" } })),
+          beginQuery(
+              loadExtension({ { "GL_EXT_disjoint_timer_query", "glBeginQueryEXT" },
+                              { "GL_ARB_timer_query", "glBeginQuery" } })),
+          endQuery(
+              loadExtension({ { "GL_EXT_disjoint_timer_query", "glEndQueryEXT" },
+                              { "GL_ARB_timer_query", "glEndQuery" } })),
+          getQueryObjectuiv(
+              loadExtension({ { "GL_EXT_disjoint_timer_query", "glGetQueryObjectuivEXT" },
+                              { "GL_ARB_timer_query", "glGetQueryObjectuiv" } })),
+          getQueryObjectui64v(
+              loadExtension({ { "GL_EXT_disjoint_timer_query", "glGetQueryObjectui64vEXT" },
+                              { "GL_ARB_timer_query", "glGetQueryObjectui64v" } })) {
+    }
+
+    explicit operator bool() const {
+        return genQueries && deleteQueries && beginQuery && endQuery && getQueryObjectuiv && getQueryObjectui64v;
+    }
+
+    const ExtensionFunction<void(platform::GLsizei n, platform::GLuint* ids)> genQueries;
+
+    const ExtensionFunction<void(platform::GLsizei n, const platform::GLuint* ids)> deleteQueries;
+
+    const ExtensionFunction<void(platform::GLenum target, platform::GLuint id)> beginQuery;
+
+    const ExtensionFunction<void(platform::GLenum target)> endQuery;
+
+    const ExtensionFunction<void(platform::GLuint id, platform::GLenum pname, platform::GLuint* params)>
+        getQueryObjectuiv;
+
+    const ExtensionFunction<void(platform::GLuint id, platform::GLenum pname, uint64_t* params)>
+        getQueryObjectui64v;
+};
+
+} // namespace extension
+} // namespace gl
+} // namespace mbgl
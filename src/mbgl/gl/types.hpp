@@ -15,6 +15,9 @@ using VertexArrayID = uint32_t;
 using FramebufferID = uint32_t;
 using RenderbufferID = uint32_t;
 
+// The driver-specific format of a program binary, as reported by glGetProgramBinary.
+using BinaryProgramFormat = uint32_t;
+
 // OpenGL does not formally define a type for attribute locations, but most APIs use
 // GLuint. The exception is glGetAttribLocation, which returns GLint so that -1 can
 // be used as an error indicator.
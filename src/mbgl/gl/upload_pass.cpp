@@ -16,8 +16,34 @@ UploadPass::UploadPass(gl::CommandEncoder& commandEncoder_, const char* name)
     : commandEncoder(commandEncoder_), debugGroup(commandEncoder.createDebugGroup(name)) {
 }
 
+namespace {
+
+bool pooled(std::size_t size, const gfx::BufferUsageType usage) {
+    return usage == gfx::BufferUsageType::StaticDraw && size > 0 && size <= BufferPool::maxAllocationSize;
+}
+
+} // namespace
+
 std::unique_ptr<gfx::VertexBufferResource> UploadPass::createVertexBufferResource(
     const void* data, std::size_t size, const gfx::BufferUsageType usage) {
+    auto& context = commandEncoder.context;
+    if (pooled(size, usage)) {
+        auto allocation = context.vertexBufferPool.allocate(size, [&] {
+            BufferID id = 0;
+            MBGL_CHECK_ERROR(glGenBuffers(1, &id));
+            context.renderingStats().numBuffers++;
+            // NOLINTNEXTLINE(performance-move-const-arg)
+            UniqueBuffer block{ std::move(id), { context } };
+            context.vertexBuffer = block;
+            MBGL_CHECK_ERROR(glBufferData(GL_ARRAY_BUFFER, BufferPool::blockSize, nullptr, GL_STATIC_DRAW));
+            return block;
+        });
+        context.renderingStats().memVertexBuffers += size;
+        context.vertexBuffer = allocation.getBuffer();
+        MBGL_CHECK_ERROR(glBufferSubData(GL_ARRAY_BUFFER, allocation.getOffset(), size, data));
+        return std::make_unique<gl::VertexBufferResource>(context, std::move(allocation), size);
+    }
+
     BufferID id = 0;
     MBGL_CHECK_ERROR(glGenBuffers(1, &id));
     commandEncoder.context.renderingStats().numBuffers++;
@@ -27,18 +53,48 @@ std::unique_ptr<gfx::VertexBufferResource> UploadPass::createVertexBufferResourc
     commandEncoder.context.vertexBuffer = result;
     MBGL_CHECK_ERROR(
         glBufferData(GL_ARRAY_BUFFER, size, data, Enum<gfx::BufferUsageType>::to(usage)));
-    return std::make_unique<gl::VertexBufferResource>(std::move(result), size);
+    return std::make_unique<gl::VertexBufferResource>(std::move(result), size, usage);
 }
 
 void UploadPass::updateVertexBufferResource(gfx::VertexBufferResource& resource,
                                             const void* data,
-                                            std::size_t size) {
-    commandEncoder.context.vertexBuffer = static_cast<gl::VertexBufferResource&>(resource).buffer;
-    MBGL_CHECK_ERROR(glBufferSubData(GL_ARRAY_BUFFER, 0, size, data));
+                                            std::size_t size,
+                                            std::size_t offset) {
+    auto& glResource = static_cast<gl::VertexBufferResource&>(resource);
+    commandEncoder.context.vertexBuffer = glResource.buffer;
+    if (offset == 0 && int(size) == glResource.byteSize && glResource.orphansOnUpdate()) {
+        // Respecifying the whole buffer lets the driver hand out fresh storage while draws of
+        // the previous frame still read the old one, instead of waiting for them.
+        MBGL_CHECK_ERROR(glBufferData(GL_ARRAY_BUFFER, size, data, Enum<gfx::BufferUsageType>::to(glResource.usage)));
+        return;
+    }
+    MBGL_CHECK_ERROR(glBufferSubData(GL_ARRAY_BUFFER, glResource.byteOffset + offset, size, data));
 }
 
 std::unique_ptr<gfx::IndexBufferResource> UploadPass::createIndexBufferResource(
     const void* data, std::size_t size, const gfx::BufferUsageType usage) {
+    auto& context = commandEncoder.context;
+    if (pooled(size, usage)) {
+        // Be sure to unbind any existing vertex array object before binding the index buffer
+        // so that we don't mess up another VAO
+        context.bindVertexArray = 0;
+        auto allocation = context.indexBufferPool.allocate(size, [&] {
+            BufferID id = 0;
+            MBGL_CHECK_ERROR(glGenBuffers(1, &id));
+            context.renderingStats().numBuffers++;
+            // NOLINTNEXTLINE(performance-move-const-arg)
+            UniqueBuffer block{ std::move(id), { context } };
+            context.globalVertexArrayState.indexBuffer = block;
+            MBGL_CHECK_ERROR(
+                glBufferData(GL_ELEMENT_ARRAY_BUFFER, BufferPool::blockSize, nullptr, GL_STATIC_DRAW));
+            return block;
+        });
+        context.renderingStats().memIndexBuffers += size;
+        context.globalVertexArrayState.indexBuffer = allocation.getBuffer();
+        MBGL_CHECK_ERROR(glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, allocation.getOffset(), size, data));
+        return std::make_unique<gl::IndexBufferResource>(context, std::move(allocation), size);
+    }
+
     BufferID id = 0;
     MBGL_CHECK_ERROR(glGenBuffers(1, &id));
     commandEncoder.context.renderingStats().numBuffers++;
@@ -49,7 +105,7 @@ std::unique_ptr<gfx::IndexBufferResource> UploadPass::createIndexBufferResource(
     commandEncoder.context.globalVertexArrayState.indexBuffer = result;
     MBGL_CHECK_ERROR(
         glBufferData(GL_ELEMENT_ARRAY_BUFFER, size, data, Enum<gfx::BufferUsageType>::to(usage)));
-    return std::make_unique<gl::IndexBufferResource>(std::move(result), size);
+    return std::make_unique<gl::IndexBufferResource>(std::move(result), size, usage);
 }
 
 void UploadPass::updateIndexBufferResource(gfx::IndexBufferResource& resource,
@@ -58,9 +114,14 @@ void UploadPass::updateIndexBufferResource(gfx::IndexBufferResource& resource,
     // Be sure to unbind any existing vertex array object before binding the index buffer
     // so that we don't mess up another VAO
     commandEncoder.context.bindVertexArray = 0;
-    commandEncoder.context.globalVertexArrayState.indexBuffer =
-        static_cast<gl::IndexBufferResource&>(resource).buffer;
-    MBGL_CHECK_ERROR(glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, size, data));
+    auto& glResource = static_cast<gl::IndexBufferResource&>(resource);
+    commandEncoder.context.globalVertexArrayState.indexBuffer = glResource.buffer;
+    if (int(size) == glResource.byteSize && glResource.orphansOnUpdate()) {
+        MBGL_CHECK_ERROR(
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, size, data, Enum<gfx::BufferUsageType>::to(glResource.usage)));
+        return;
+    }
+    MBGL_CHECK_ERROR(glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, glResource.byteOffset, size, data));
 }
 
 std::unique_ptr<gfx::TextureResource>
@@ -68,13 +129,28 @@ UploadPass::createTextureResource(const Size size,
                                   const void* data,
                                   gfx::TexturePixelType format,
                                   gfx::TextureChannelDataType type) {
-    auto obj = commandEncoder.context.createUniqueTexture();
+    auto& context = commandEncoder.context;
+    auto pooled = context.takePooledTexture({size, format, type});
+    auto obj = pooled ? std::move(*pooled) : context.createUniqueTexture();
     int textureByteSize = gl::TextureResource::getStorageSize(size, format, type);
-    commandEncoder.context.renderingStats().memTextures += textureByteSize;
+    context.renderingStats().memTextures += textureByteSize;
     std::unique_ptr<gfx::TextureResource> resource =
         std::make_unique<gl::TextureResource>(std::move(obj), textureByteSize);
-    commandEncoder.context.pixelStoreUnpack = { 1 };
-    updateTextureResource(*resource, size, data, format, type);
+    context.pixelStoreUnpack = { 1 };
+    if (pooled) {
+        // Writes into the existing storage instead of allocating new storage.
+        auto& glResource = static_cast<gl::TextureResource&>(*resource);
+        glResource.storage = TextureStorage{size, format, type};
+        context.activeTextureUnit = 0;
+        context.texture[0] = glResource.texture;
+        if (data) {
+            MBGL_CHECK_ERROR(glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, size.width, size.height,
+                                             Enum<gfx::TexturePixelType>::to(format),
+                                             Enum<gfx::TextureChannelDataType>::to(type), data));
+        }
+    } else {
+        updateTextureResource(*resource, size, data, format, type);
+    }
     // We are using clamp to edge here since OpenGL ES doesn't allow GL_REPEAT on NPOT textures.
     // We use those when the pixelRatio isn't a power of two, e.g. on iPhone 6 Plus.
     MBGL_CHECK_ERROR(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
@@ -96,6 +172,43 @@ void UploadPass::updateTextureResource(gfx::TextureResource& resource,
                                   size.width, size.height, 0,
                                   Enum<gfx::TexturePixelType>::to(format),
                                   Enum<gfx::TextureChannelDataType>::to(type), data));
+    static_cast<gl::TextureResource&>(resource).storage = TextureStorage{size, format, type};
+}
+
+bool UploadPass::supportsCompressedTextures(gfx::TextureCompressionType type) const {
+    switch (type) {
+        case gfx::TextureCompressionType::ETC1:
+            return commandEncoder.context.supportsETC1Textures;
+    }
+    return false;
+}
+
+std::unique_ptr<gfx::TextureResource> UploadPass::createCompressedTextureResource(const Size size,
+                                                                                  const void* data,
+                                                                                  const std::size_t byteSize,
+                                                                                  gfx::TextureCompressionType type) {
+    assert(type == gfx::TextureCompressionType::ETC1);
+    (void)type;
+#if MBGL_USE_GLES2
+    constexpr platform::GLenum format = GL_ETC1_RGB8_OES;
+#else
+    constexpr platform::GLenum format = GL_COMPRESSED_RGB8_ETC2;
+#endif
+    auto obj = commandEncoder.context.createUniqueTexture();
+    const int textureByteSize = static_cast<int>(byteSize);
+    commandEncoder.context.renderingStats().memTextures += textureByteSize;
+    std::unique_ptr<gfx::TextureResource> resource =
+        std::make_unique<gl::TextureResource>(std::move(obj), textureByteSize);
+    // Always use texture unit 0 for manipulating it.
+    commandEncoder.context.activeTextureUnit = 0;
+    commandEncoder.context.texture[0] = static_cast<gl::TextureResource&>(*resource).texture;
+    MBGL_CHECK_ERROR(glCompressedTexImage2D(
+        GL_TEXTURE_2D, 0, format, size.width, size.height, 0, textureByteSize, data));
+    MBGL_CHECK_ERROR(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+    MBGL_CHECK_ERROR(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+    MBGL_CHECK_ERROR(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST));
+    MBGL_CHECK_ERROR(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
+    return resource;
 }
 
 void UploadPass::updateTextureResourceSub(gfx::TextureResource& resource,
@@ -121,5 +234,9 @@ void UploadPass::popDebugGroup() {
     commandEncoder.popDebugGroup();
 }
 
+gfx::MemoryTracker& UploadPass::getMemoryTracker() {
+    return commandEncoder.context.memoryTracker();
+}
+
 } // namespace gl
 } // namespace mbgl
@@ -21,12 +21,16 @@ public:
 private:
     void pushDebugGroup(const char* name) override;
     void popDebugGroup() override;
+    gfx::MemoryTracker& getMemoryTracker() override;
 
 public:
     std::unique_ptr<gfx::VertexBufferResource> createVertexBufferResource(const void* data,
                                                                           std::size_t size,
                                                                           gfx::BufferUsageType) override;
-    void updateVertexBufferResource(gfx::VertexBufferResource&, const void* data, std::size_t size) override;
+    void updateVertexBufferResource(gfx::VertexBufferResource&,
+                                    const void* data,
+                                    std::size_t size,
+                                    std::size_t offset) override;
     std::unique_ptr<gfx::IndexBufferResource> createIndexBufferResource(const void* data,
                                                                         std::size_t size,
                                                                         gfx::BufferUsageType) override;
@@ -43,6 +47,12 @@ public:
                                   gfx::TexturePixelType,
                                   gfx::TextureChannelDataType) override;
 
+    bool supportsCompressedTextures(gfx::TextureCompressionType) const override;
+    std::unique_ptr<gfx::TextureResource> createCompressedTextureResource(Size,
+                                                                          const void* data,
+                                                                          std::size_t size,
+                                                                          gfx::TextureCompressionType) override;
+
 private:
     gl::CommandEncoder& commandEncoder;
     const gfx::DebugGroup<gfx::CommandEncoder> debugGroup;
@@ -1,6 +1,7 @@
 #include <mbgl/gl/value.hpp>
 #include <mbgl/gl/context.hpp>
 #include <mbgl/gl/vertex_buffer_resource.hpp>
+#include <mbgl/gl/instanced_arrays_extension.hpp>
 #include <mbgl/gl/vertex_array_extension.hpp>
 #include <mbgl/gl/enum.hpp>
 
@@ -491,7 +492,8 @@ GLint components(const gfx::AttributeDataType type) {
 
 void VertexAttribute::Set(const Type& binding, Context& context, AttributeLocation location) {
     if (binding) {
-        context.vertexBuffer = reinterpret_cast<const gl::VertexBufferResource&>(*binding->vertexBufferResource).buffer;
+        const auto& resource = reinterpret_cast<const gl::VertexBufferResource&>(*binding->vertexBufferResource);
+        context.vertexBuffer = resource.buffer;
         MBGL_CHECK_ERROR(glEnableVertexAttribArray(location));
         MBGL_CHECK_ERROR(glVertexAttribPointer(
             location,
@@ -499,7 +501,14 @@ void VertexAttribute::Set(const Type& binding, Context& context, AttributeLocati
             vertexType(binding->attribute.dataType),
             static_cast<GLboolean>(false),
             static_cast<GLsizei>(binding->vertexStride),
-            reinterpret_cast<GLvoid*>(binding->attribute.offset + (binding->vertexStride * binding->vertexOffset))));
+            reinterpret_cast<GLvoid*>(resource.byteOffset + binding->attribute.offset +
+                                      (binding->vertexStride * binding->vertexOffset))));
+        // The divisor is part of the vertex array state, so it is reset along with the pointer.
+        if (auto* instancedArrays = context.getInstancedArraysExtension()) {
+            if (instancedArrays->vertexAttribDivisor) {
+                MBGL_CHECK_ERROR(instancedArrays->vertexAttribDivisor(location, binding->instanceDivisor));
+            }
+        }
     } else {
         MBGL_CHECK_ERROR(glDisableVertexAttribArray(location));
     }
@@ -1,5 +1,6 @@
 #include <mbgl/gl/vertex_array.hpp>
 #include <mbgl/gl/index_buffer_resource.hpp>
+#include <mbgl/gl/vertex_buffer_resource.hpp>
 #include <mbgl/gl/context.hpp>
 
 namespace mbgl {
@@ -22,5 +23,51 @@ void VertexArray::bind(Context& context,
     }
 }
 
+VertexArrayKey::VertexArrayKey(const gfx::IndexBuffer& indexBuffer_, const AttributeBindingArray& bindings)
+    : indexBuffer(indexBuffer_.getResource<gl::IndexBufferResource>().buffer) {
+    attributes.reserve(bindings.size());
+    for (const auto& binding : bindings) {
+        attributes.push_back(attributeOf(binding));
+    }
+}
+
+VertexArrayKey::Attribute VertexArrayKey::attributeOf(const optional<gfx::AttributeBinding>& binding) {
+    if (!binding) {
+        return Attribute(0, 0, 0, gfx::AttributeDataType{}, 0);
+    }
+    const auto& resource = reinterpret_cast<const gl::VertexBufferResource&>(*binding->vertexBufferResource);
+    return Attribute(resource.buffer,
+                     resource.byteOffset + binding->attribute.offset +
+                         std::size_t(binding->vertexStride) * binding->vertexOffset,
+                     binding->vertexStride,
+                     binding->attribute.dataType,
+                     binding->instanceDivisor);
+}
+
+bool VertexArrayKey::matches(const gfx::IndexBuffer& indexBuffer_, const AttributeBindingArray& bindings) const {
+    if (indexBuffer != indexBuffer_.getResource<gl::IndexBufferResource>().buffer ||
+        attributes.size() != bindings.size()) {
+        return false;
+    }
+    for (std::size_t i = 0; i < bindings.size(); ++i) {
+        if (attributes[i] != attributeOf(bindings[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool VertexArrayKey::uses(const std::unordered_set<BufferID>& buffers) const {
+    if (buffers.count(indexBuffer)) {
+        return true;
+    }
+    for (const auto& attribute : attributes) {
+        if (buffers.count(std::get<0>(attribute))) {
+            return true;
+        }
+    }
+    return false;
+}
+
 } // namespace gl
 } // namespace mbgl
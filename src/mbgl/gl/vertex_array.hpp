@@ -7,6 +7,9 @@
 
 #include <array>
 #include <memory>
+#include <tuple>
+#include <unordered_set>
+#include <vector>
 
 namespace mbgl {
 
@@ -67,5 +70,31 @@ private:
     UniqueVertexArrayState state;
 };
 
+// The GL state that a vertex array captures: the index buffer, and the buffer, offset and layout
+// bound to every attribute location. Draws with equal keys can share a vertex array, whatever
+// their program, segment or layer.
+class VertexArrayKey {
+public:
+    VertexArrayKey(const gfx::IndexBuffer&, const AttributeBindingArray&);
+
+    // Whether the key equals the one of these bindings, without building that key.
+    bool matches(const gfx::IndexBuffer&, const AttributeBindingArray&) const;
+
+    // Whether the vertex array refers to any of these buffers.
+    bool uses(const std::unordered_set<BufferID>&) const;
+
+    friend bool operator<(const VertexArrayKey& lhs, const VertexArrayKey& rhs) {
+        return std::tie(lhs.indexBuffer, lhs.attributes) < std::tie(rhs.indexBuffer, rhs.attributes);
+    }
+
+private:
+    // Buffer, byte offset, stride, data type and divisor of a location. Unbound locations use buffer 0.
+    using Attribute = std::tuple<BufferID, std::size_t, uint8_t, gfx::AttributeDataType, uint32_t>;
+    static Attribute attributeOf(const optional<gfx::AttributeBinding>&);
+
+    BufferID indexBuffer;
+    std::vector<Attribute> attributes;
+};
+
 } // namespace gl
 } // namespace mbgl
@@ -25,7 +25,7 @@ std::unique_ptr<Layout> CircleLayerFactory::createLayout(
     const LayoutParameters& parameters,
     std::unique_ptr<GeometryTileLayer> layer,
     const std::vector<Immutable<style::LayerProperties>>& group) noexcept {
-    return std::make_unique<CircleLayout>(parameters.bucketParameters, group, std::move(layer));
+    return std::make_unique<CircleLayout>(parameters.bucketParameters, group, std::move(layer), parameters.arena);
 }
 
 std::unique_ptr<RenderLayer> CircleLayerFactory::createRenderLayer(Immutable<style::Layer::Impl> impl) noexcept {
@@ -5,6 +5,9 @@
 #include <mbgl/renderer/buckets/circle_bucket.hpp>
 #include <mbgl/renderer/render_layer.hpp>
 #include <mbgl/style/layers/circle_layer_impl.hpp>
+#include <mbgl/util/arena.hpp>
+
+#include <list>
 
 namespace mbgl {
 
@@ -12,8 +15,12 @@ class CircleLayout final : public Layout {
 public:
     CircleLayout(const BucketParameters& parameters,
                  const std::vector<Immutable<style::LayerProperties>>& group,
-                 std::unique_ptr<GeometryTileLayer> sourceLayer_)
-        : sourceLayer(std::move(sourceLayer_)), zoom(parameters.tileID.overscaledZ), mode(parameters.mode) {
+                 std::unique_ptr<GeometryTileLayer> sourceLayer_,
+                 util::Arena* arena = nullptr)
+        : sourceLayer(std::move(sourceLayer_)),
+          features(util::ArenaAllocator<CircleFeature>(arena)),
+          zoom(parameters.tileID.overscaledZ),
+          mode(parameters.mode) {
         assert(!group.empty());
         auto leaderLayerProperties = staticImmutableCast<style::CircleLayerProperties>(group.front());
         const auto& unevaluatedLayout = leaderLayerProperties->layerImpl().layout;
@@ -27,13 +34,16 @@ public:
             layerPropertiesMap.emplace(layerId, layerProperties);
         }
 
-        const size_t featureCount = sourceLayer->featureCount();
-        for (size_t i = 0; i < featureCount; ++i) {
-            auto feature = sourceLayer->getFeature(i);
-            if (!leaderLayerProperties->layerImpl().filter(style::expression::EvaluationContext(zoom, feature.get())
-                                                               .withCanonicalTileID(&parameters.tileID.canonical))) {
-                continue;
+        util::ArenaVector<size_t> filteredFeatures{util::ArenaAllocator<size_t>(arena)};
+        sourceLayer->forEachFeature([&](size_t i, const GeometryTileFeature& feature) {
+            if (leaderLayerProperties->layerImpl().filter(style::expression::EvaluationContext(zoom, &feature)
+                                                              .withCanonicalTileID(&parameters.tileID.canonical))) {
+                filteredFeatures.push_back(i);
             }
+        });
+
+        for (size_t i : filteredFeatures) {
+            auto feature = sourceLayer->getFeature(i);
 
             if (!sortFeaturesByKey) {
                 features.push_back({i, std::move(feature), style::CircleSortKey::defaultValue()});
@@ -51,8 +61,8 @@ public:
     bool hasDependencies() const override { return false; }
 
     void createBucket(const ImagePositions&,
-                      std::unique_ptr<FeatureIndex>& featureIndex,
-                      std::unordered_map<std::string, LayerRenderData>& renderData,
+                      FeatureIndex* featureIndex,
+                      std::unordered_map<StringIdentity, LayerRenderData>& renderData,
                       const bool,
                       const bool,
                       const CanonicalTileID& canonical) override {
@@ -66,13 +76,13 @@ public:
             addCircle(*bucket, *feature, geometries, i, circleFeature.sortKey, canonical);
 
             bucket->addFeature(*feature, geometries, {}, PatternLayerMap(), i, canonical);
-            featureIndex->insert(geometries, i, sourceLayerID, bucketLeaderID);
+            if (featureIndex) featureIndex->insert(geometries, i, sourceLayerID, bucketLeaderID);
         }
 
         if (!bucket->hasData()) return;
 
         for (const auto& pair : layerPropertiesMap) {
-            renderData.emplace(pair.first, LayerRenderData{bucket, pair.second});
+            renderData.emplace(pair.second->baseImpl->internedID, LayerRenderData{bucket, pair.second});
         }
     }
 
@@ -151,7 +161,7 @@ private:
     std::string bucketLeaderID;
 
     const std::unique_ptr<GeometryTileLayer> sourceLayer;
-    std::list<CircleFeature> features;
+    std::list<CircleFeature, util::ArenaAllocator<CircleFeature>> features;
 
     const float zoom;
     const MapMode mode;
@@ -3,6 +3,7 @@
 #include <mbgl/renderer/image_atlas.hpp>
 #include <mbgl/text/glyph_atlas.hpp>
 #include <mbgl/tile/geometry_tile_data.hpp>
+#include <mbgl/util/string_indexer.hpp>
 #include <memory>
 
 namespace mbgl {
@@ -13,13 +14,19 @@ class RenderLayer;
 class FeatureIndex;
 class LayerRenderData;
 
+namespace util {
+class Arena;
+} // namespace util
+
 class Layout {
 public:
     virtual ~Layout() = default;
 
+    // Adds the features of the bucket to the feature index, unless it is null because the index
+    // already has them.
     virtual void createBucket(const ImagePositions&,
-                              std::unique_ptr<FeatureIndex>&,
-                              std::unordered_map<std::string, LayerRenderData>&,
+                              FeatureIndex*,
+                              std::unordered_map<StringIdentity, LayerRenderData>&,
                               bool,
                               bool,
                               const CanonicalTileID&) = 0;
@@ -39,6 +46,9 @@ public:
     GlyphDependencies& glyphDependencies;
     ImageDependencies& imageDependencies;
     std::set<std::string>& availableImages;
+    // Backs the layout's own containers. It is reset with the next parse of the tile, after
+    // all the layouts were destroyed, so none of it may end up in a bucket.
+    util::Arena* arena = nullptr;
 };
 
 } // namespace mbgl
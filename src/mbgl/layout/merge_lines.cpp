@@ -1,66 +1,71 @@
 #include <mbgl/layout/merge_lines.hpp>
 #include <mbgl/layout/symbol_feature.hpp>
-#include <mbgl/util/hash.hpp>
+
+#include <limits>
+#include <unordered_map>
 
 namespace mbgl {
 namespace util {
 
-// Map of key -> index into features
-using Index = std::unordered_map<size_t, size_t>;
-
-size_t mergeFromRight(std::vector<SymbolFeature>& features,
-                      Index& rightIndex,
-                      Index::iterator left,
-                      size_t rightKey,
-                      GeometryCollection& geom) {
-
-    const size_t index = left->second;
-    rightIndex.erase(left);
-    rightIndex[rightKey] = index;
-    features[index].geometry[0].pop_back();
-    features[index].geometry[0].insert(
-        features[index].geometry[0].end(), geom[0].begin(), geom[0].end());
-    geom[0].clear();
-    return index;
-}
+namespace {
 
-size_t mergeFromLeft(std::vector<SymbolFeature>& features,
-                     Index& leftIndex,
-                     Index::iterator right,
-                     size_t leftKey,
-                     GeometryCollection& geom) {
-
-    const size_t index = right->second;
-    leftIndex.erase(right);
-    leftIndex[leftKey] = index;
-    geom[0].pop_back();
-    geom[0].insert(
-        geom[0].end(), features[index].geometry[0].begin(), features[index].geometry[0].end());
-    features[index].geometry[0].clear();
-    std::swap(features[index].geometry[0], geom[0]);
-    return index;
-}
+constexpr std::size_t none = std::numeric_limits<std::size_t>::max();
+
+struct TextHash {
+    std::size_t operator()(const std::u16string* text) const {
+        return std::hash<std::u16string>()(*text);
+    }
+};
+
+struct TextEqual {
+    bool operator()(const std::u16string* lhs, const std::u16string* rhs) const {
+        return *lhs == *rhs;
+    }
+};
 
-size_t getKey(const std::u16string& text, const GeometryCoordinate& coord) {
-    return util::hash(text, coord.x, coord.y);
+// A line end is identified by the id of the line's text and the end's coordinates, which fit
+// together in a 64-bit key, so that lines are only merged at exactly matching ends.
+uint64_t getKey(uint32_t textID, const GeometryCoordinate& coord) {
+    return (uint64_t(textID) << 32) | (uint64_t(uint16_t(coord.x)) << 16) | uint16_t(coord.y);
 }
 
-void mergeLines(std::vector<SymbolFeature>& features) {
-    Index leftIndex;
-    Index rightIndex;
+// A run of features whose lines are joined end to start, linked through `next`. The merged line is
+// stored in the feature that started the run once all features have been visited.
+struct Run {
+    std::size_t first = none;
+    std::size_t last = none;
+};
+
+} // namespace
+
+void mergeLines(SymbolFeatures& features) {
+    // Map of key -> index of the run that starts or ends there.
+    std::unordered_map<uint64_t, std::size_t> leftIndex;
+    std::unordered_map<uint64_t, std::size_t> rightIndex;
+    leftIndex.reserve(features.size());
+    rightIndex.reserve(features.size());
 
-    for (size_t k = 0; k < features.size(); k++) {
+    // Texts are interned by reference; features keep their text while lines are merged.
+    std::unordered_map<const std::u16string*, uint32_t, TextHash, TextEqual> textIDs;
+
+    std::vector<Run> runs(features.size());
+    std::vector<std::size_t> next(features.size(), none);
+
+    for (std::size_t k = 0; k < features.size(); k++) {
         SymbolFeature& feature = features[k];
-        GeometryCollection& geometry = feature.geometry;
+        const GeometryCollection& geometry = feature.geometry;
 
         if (!feature.formattedText || geometry.empty() || geometry[0].empty()) {
             continue;
         }
-        
+
         // TODO: Key should include formatting options (see https://github.com/mapbox/mapbox-gl-js/issues/3645)
 
-        const size_t leftKey = getKey(feature.formattedText->rawText(), geometry[0].front());
-        const size_t rightKey = getKey(feature.formattedText->rawText(), geometry[0].back());
+        const uint32_t textID =
+            textIDs.emplace(&feature.formattedText->rawText(), static_cast<uint32_t>(textIDs.size())).first->second;
+
+        const uint64_t leftKey = getKey(textID, geometry[0].front());
+        const uint64_t rightKey = getKey(textID, geometry[0].back());
 
         const auto left = rightIndex.find(leftKey);
         const auto right = leftIndex.find(rightKey);
@@ -68,27 +73,66 @@ void mergeLines(std::vector<SymbolFeature>& features) {
         if (left != rightIndex.end() && right != leftIndex.end() && left->second != right->second) {
             // found lines with the same text adjacent to both ends of the current line, merge all
             // three
-            size_t j = mergeFromLeft(features, leftIndex, right, leftKey, geometry);
-            size_t i = mergeFromRight(features, rightIndex, left, rightKey, features[j].geometry);
-
+            const std::size_t i = left->second;
+            const std::size_t j = right->second;
+            next[runs[i].last] = k;
+            next[k] = runs[j].first;
+            runs[i].last = runs[j].last;
+            runs[j] = {};
+
+            rightIndex.erase(left);
+            leftIndex.erase(right);
             leftIndex.erase(leftKey);
             rightIndex.erase(rightKey);
-            rightIndex[getKey(feature.formattedText->rawText(), features[i].geometry[0].back())] = i;
+            rightIndex[getKey(textID, features[runs[i].last].geometry[0].back())] = i;
 
         } else if (left != rightIndex.end()) {
             // found mergeable line adjacent to the start of the current line, merge
-            mergeFromRight(features, rightIndex, left, rightKey, geometry);
+            const std::size_t i = left->second;
+            next[runs[i].last] = k;
+            runs[i].last = k;
+
+            rightIndex.erase(left);
+            rightIndex[rightKey] = i;
 
         } else if (right != leftIndex.end()) {
             // found mergeable line adjacent to the end of the current line, merge
-            mergeFromLeft(features, leftIndex, right, leftKey, geometry);
+            const std::size_t j = right->second;
+            next[k] = runs[j].first;
+            runs[j].first = k;
+
+            leftIndex.erase(right);
+            leftIndex[leftKey] = j;
 
         } else {
             // no adjacent lines, add as a new item
+            runs[k] = { k, k };
             leftIndex[leftKey] = k;
             rightIndex[rightKey] = k;
         }
     }
+
+    // Join the lines of each run once, leaving the lines of the other features in it empty.
+    for (std::size_t k = 0; k < features.size(); k++) {
+        const Run& run = runs[k];
+        if (run.first == none || run.first == run.last) {
+            continue;
+        }
+
+        std::size_t size = 1;
+        for (std::size_t i = run.first; i != none; i = next[i]) {
+            size += features[i].geometry[0].size() - 1;
+        }
+
+        LineString<int16_t> line;
+        line.reserve(size);
+        for (std::size_t i = run.first; i != none; i = next[i]) {
+            auto& part = features[i].geometry[0];
+            line.insert(line.end(), i == run.first ? part.begin() : part.begin() + 1, part.end());
+            part.clear();
+        }
+        features[k].geometry[0] = std::move(line);
+    }
 }
 
 } // end namespace util
@@ -1,10 +1,6 @@
 #pragma once
 
-#include <mbgl/tile/geometry_tile_data.hpp>
-
-#include <unordered_map>
-#include <string>
-#include <vector>
+#include <mbgl/util/arena.hpp>
 
 namespace mbgl {
 
@@ -12,19 +8,9 @@ class SymbolFeature;
 
 namespace util {
 
-unsigned int mergeFromRight(std::vector<SymbolFeature> &features,
-                            std::unordered_map<std::string, unsigned int> &rightIndex,
-                            std::unordered_map<std::string, unsigned int>::iterator left,
-                            std::string &rightKey,
-                            GeometryCollection &geom);
-
-unsigned int mergeFromLeft(std::vector<SymbolFeature> &features,
-                           std::unordered_map<std::string, unsigned int> &leftIndex,
-                           std::string &leftKey,
-                           std::unordered_map<std::string, unsigned int>::iterator right,
-                           GeometryCollection &geom);
-
-void mergeLines(std::vector<SymbolFeature> &features);
+// Joins the lines of features with the same text that end where another one starts. Each merged
+// line is stored in one of its features, and the lines of the others are left empty.
+void mergeLines(ArenaVector<SymbolFeature>& features);
 
 } // end namespace util
 } // end namespace mbgl
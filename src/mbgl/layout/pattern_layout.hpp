@@ -6,6 +6,7 @@
 #include <mbgl/renderer/render_layer.hpp>
 #include <mbgl/style/expression/image.hpp>
 #include <mbgl/style/layer_properties.hpp>
+#include <mbgl/util/arena.hpp>
 
 namespace mbgl {
 
@@ -16,7 +17,8 @@ public:
     std::string max;
 };
 
-using PatternLayerMap = std::map<std::string, PatternDependency>;
+// Keyed by the interned layer ID.
+using PatternLayerMap = std::map<StringIdentity, PatternDependency>;
 
 class PatternFeature  {
 public:
@@ -40,7 +42,7 @@ struct PatternFeatureInserter;
 template <>
 struct PatternFeatureInserter<void> {
     template <typename PropertiesType>
-    static void insert(std::vector<PatternFeature>& features,
+    static void insert(util::ArenaVector<PatternFeature>& features,
                        std::size_t index,
                        std::unique_ptr<GeometryTileFeature> feature,
                        PatternLayerMap patternDependencyMap,
@@ -54,7 +56,7 @@ struct PatternFeatureInserter<void> {
 template <class SortKeyPropertyType>
 struct PatternFeatureInserter {
     template <typename PropertiesType>
-    static void insert(std::vector<PatternFeature>& features,
+    static void insert(util::ArenaVector<PatternFeature>& features,
                        std::size_t index,
                        std::unique_ptr<GeometryTileFeature> feature,
                        PatternLayerMap patternDependencyMap,
@@ -81,6 +83,7 @@ public:
                   std::unique_ptr<GeometryTileLayer> sourceLayer_,
                   const LayoutParameters& layoutParameters)
         : sourceLayer(std::move(sourceLayer_)),
+          features(util::ArenaAllocator<PatternFeature>(layoutParameters.arena)),
           zoom(parameters.tileID.overscaledZ),
           overscaling(parameters.tileID.overscaleFactor()),
           hasPattern(false) {
@@ -107,13 +110,16 @@ public:
             layerPropertiesMap.emplace(layerId, layerProperties);
         }
 
-        const size_t featureCount = sourceLayer->featureCount();
-        for (size_t i = 0; i < featureCount; ++i) {
-            auto feature = sourceLayer->getFeature(i);
-            if (!leaderLayerProperties->layerImpl().filter(
-                    style::expression::EvaluationContext(this->zoom, feature.get())
+        util::ArenaVector<size_t> filteredFeatures{util::ArenaAllocator<size_t>(layoutParameters.arena)};
+        sourceLayer->forEachFeature([&](size_t i, const GeometryTileFeature& feature) {
+            if (leaderLayerProperties->layerImpl().filter(
+                    style::expression::EvaluationContext(this->zoom, &feature)
                         .withCanonicalTileID(&parameters.tileID.canonical)))
-                continue;
+                filteredFeatures.push_back(i);
+        });
+
+        for (size_t i : filteredFeatures) {
+            auto feature = sourceLayer->getFeature(i);
 
             PatternLayerMap patternDependencyMap;
             if (hasPattern) {
@@ -145,7 +151,7 @@ public:
                             layoutParameters.imageDependencies.emplace(min.to.id(), ImageType::Pattern);
                             layoutParameters.imageDependencies.emplace(mid.to.id(), ImageType::Pattern);
                             layoutParameters.imageDependencies.emplace(max.to.id(), ImageType::Pattern);
-                            patternDependencyMap.emplace(layerId,
+                            patternDependencyMap.emplace(layerProperties->baseImpl->internedID,
                                                          PatternDependency{min.to.id(), mid.to.id(), max.to.id()});
                         }
                     }
@@ -165,8 +171,8 @@ public:
     bool hasDependencies() const override { return hasPattern; }
 
     void createBucket(const ImagePositions& patternPositions,
-                      std::unique_ptr<FeatureIndex>& featureIndex,
-                      std::unordered_map<std::string, LayerRenderData>& renderData,
+                      FeatureIndex* featureIndex,
+                      std::unordered_map<StringIdentity, LayerRenderData>& renderData,
                       const bool /*firstLoad*/,
                       const bool /*showCollisionBoxes*/,
                       const CanonicalTileID& canonical) override {
@@ -178,11 +184,11 @@ public:
             const GeometryCollection& geometries = feature->getGeometries();
 
             bucket->addFeature(*feature, geometries, patternPositions, patterns, i, canonical);
-            featureIndex->insert(geometries, i, sourceLayerID, bucketLeaderID);
+            if (featureIndex) featureIndex->insert(geometries, i, sourceLayerID, bucketLeaderID);
         }
         if (bucket->hasData()) {
             for (const auto& pair : layerPropertiesMap) {
-                renderData.emplace(pair.first, LayerRenderData {bucket, pair.second});
+                renderData.emplace(pair.second->baseImpl->internedID, LayerRenderData {bucket, pair.second});
             }
         }
     };
@@ -192,7 +198,7 @@ protected:
     std::string bucketLeaderID;
 
     const std::unique_ptr<GeometryTileLayer> sourceLayer;
-    std::vector<PatternFeature> features;
+    util::ArenaVector<PatternFeature> features;
     typename LayoutPropertiesType::PossiblyEvaluated layout;
 
     const float zoom;
@@ -3,6 +3,7 @@
 #include <mbgl/style/expression/image.hpp>
 #include <mbgl/text/tagged_string.hpp>
 #include <mbgl/tile/geometry_tile_data.hpp>
+#include <mbgl/util/arena.hpp>
 #include <mbgl/util/optional.hpp>
 
 #include <array>
@@ -36,4 +37,6 @@ public:
     bool allowsVerticalWritingMode = false;
 };
 
+using SymbolFeatures = util::ArenaVector<SymbolFeature>;
+
 } // namespace mbgl
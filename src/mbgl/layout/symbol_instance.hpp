@@ -108,6 +108,8 @@ public:
     std::array<float, 2> textOffset;
     std::array<float, 2> iconOffset;
     std::u16string key;
+    // Hash of the key, used by the CrossTileSymbolIndex to find symbols with the same key.
+    std::size_t keyHash;
     bool isDuplicate;
     optional<size_t> placedRightTextIndex;
     optional<size_t> placedCenterTextIndex;
@@ -91,7 +91,8 @@ SymbolLayout::SymbolLayout(const BucketParameters& parameters,
       pixelRatio(parameters.pixelRatio),
       tileSize(util::tileSize * overscaling),
       tilePixelRatio(float(util::EXTENT) / tileSize),
-      layout(createLayout(toSymbolLayerProperties(layers.at(0)).layerImpl().layout, zoom)) {
+      layout(createLayout(toSymbolLayerProperties(layers.at(0)).layerImpl().layout, zoom)),
+      features(util::ArenaAllocator<SymbolFeature>(layoutParameters.arena)) {
     const SymbolLayer::Impl& leader = toSymbolLayerProperties(layers.at(0)).layerImpl();
 
     textSize = leader.layout.get<TextSize>();
@@ -130,14 +131,15 @@ SymbolLayout::SymbolLayout(const BucketParameters& parameters,
     }
 
     // Determine glyph dependencies
-    const size_t featureCount = sourceLayer->featureCount();
-    for (size_t i = 0; i < featureCount; ++i) {
-        auto feature = sourceLayer->getFeature(i);
-        if (!leader.filter(expression::EvaluationContext(this->zoom, feature.get())
-                               .withCanonicalTileID(&parameters.tileID.canonical)))
-            continue;
+    util::ArenaVector<size_t> filteredFeatures{util::ArenaAllocator<size_t>(layoutParameters.arena)};
+    sourceLayer->forEachFeature([&](size_t i, const GeometryTileFeature& feature) {
+        if (leader.filter(expression::EvaluationContext(this->zoom, &feature)
+                              .withCanonicalTileID(&parameters.tileID.canonical)))
+            filteredFeatures.push_back(i);
+    });
 
-        SymbolFeature ft(std::move(feature));
+    for (size_t i : filteredFeatures) {
+        SymbolFeature ft(sourceLayer->getFeature(i));
 
         ft.index = i;
 
@@ -754,8 +756,8 @@ std::vector<float> SymbolLayout::calculateTileDistances(const GeometryCoordinate
 }
 
 void SymbolLayout::createBucket(const ImagePositions&,
-                                std::unique_ptr<FeatureIndex>&,
-                                std::unordered_map<std::string, LayerRenderData>& renderData,
+                                FeatureIndex*,
+                                std::unordered_map<StringIdentity, LayerRenderData>& renderData,
                                 const bool firstLoad,
                                 const bool showCollisionBoxes,
                                 const CanonicalTileID& canonical) {
@@ -889,7 +891,7 @@ void SymbolLayout::createBucket(const ImagePositions&,
             if (!firstLoad) {
                 bucket->justReloaded = true;
             }
-            renderData.emplace(pair.first, LayerRenderData{bucket, pair.second});
+            renderData.emplace(pair.second->baseImpl->internedID, LayerRenderData{bucket, pair.second});
         }
     }
 }
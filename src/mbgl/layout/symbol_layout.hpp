@@ -37,8 +37,8 @@ public:
                         const ImagePositions&) override;
 
     void createBucket(const ImagePositions&,
-                      std::unique_ptr<FeatureIndex>&,
-                      std::unordered_map<std::string, LayerRenderData>&,
+                      FeatureIndex*,
+                      std::unordered_map<StringIdentity, LayerRenderData>&,
                       bool firstLoad,
                       bool showCollisionBoxes,
                       const CanonicalTileID& canonical) override;
@@ -133,9 +133,9 @@ private:
     style::IconSize::UnevaluatedType iconSize;
     style::TextRadialOffset::UnevaluatedType textRadialOffset;
     Immutable<style::SymbolLayoutProperties::PossiblyEvaluated> layout;
-    std::vector<SymbolFeature> features;
+    SymbolFeatures features;
 
-    BiDi bidi; // Consider moving this up to geometry tile worker to reduce reinstantiation costs; use of BiDi/ubiditransform object must be constrained to one thread
+    BiDi bidi;
 };
 
 } // namespace mbgl
@@ -75,6 +75,22 @@ void Map::renderStill(const CameraOptions& camera, MapDebugOptions debugOptions,
     renderStill(std::move(callback));
 }
 
+void Map::whenIdle(IdleCallback callback) {
+    if (!callback) {
+        Log::Error(Event::General, "IdleCallback not set");
+        return;
+    }
+
+    if (impl->mode != MapMode::Continuous) {
+        callback(std::make_exception_ptr(util::MisuseException("Map is not in continuous render mode")));
+        return;
+    }
+
+    impl->idleCallbacks.push_back(std::move(callback));
+    // Renders a frame even if nothing changed, so that an idle map reports it again.
+    impl->onUpdate();
+}
+
 void Map::triggerRepaint() {
     impl->onUpdate();
 }
@@ -409,12 +425,16 @@ LatLng Map::latLngForPixel(const ScreenCoordinate& pixel) const {
 }
 
 std::vector<ScreenCoordinate> Map::pixelsForLatLngs(const std::vector<LatLng>& latLngs) const {
-    std::vector<ScreenCoordinate> ret;
-    ret.reserve(latLngs.size());
+    // See pixelForLatLng(). The center and the projection matrix are looked up once for all points.
+    const LatLng center = impl->transform.getLatLng();
+    std::vector<LatLng> unwrappedLatLngs;
+    unwrappedLatLngs.reserve(latLngs.size());
     for (const auto& latLng : latLngs) {
-        ret.emplace_back(pixelForLatLng(latLng));
+        LatLng unwrappedLatLng = latLng.wrapped();
+        unwrappedLatLng.unwrapForShortestPath(center);
+        unwrappedLatLngs.push_back(unwrappedLatLng);
     }
-    return ret;
+    return impl->transform.latLngsToScreenCoordinates(unwrappedLatLngs);
 }
 
 std::vector<LatLng> Map::latLngsForPixels(const std::vector<ScreenCoordinate>& screenCoords) const {
@@ -471,6 +491,22 @@ void Map::removeAnnotation(AnnotationID annotation) {
     }
 }
 
+AnnotationIDs Map::addAnnotations(const std::vector<Annotation>& annotations) {
+    if (LayerManager::annotationsEnabled) {
+        auto result = impl->annotationManager.addAnnotations(annotations);
+        impl->onUpdate();
+        return result;
+    }
+    return AnnotationIDs(annotations.size(), 0);
+}
+
+void Map::removeAnnotations(const AnnotationIDs& annotations) {
+    if (LayerManager::annotationsEnabled) {
+        impl->annotationManager.removeAnnotations(annotations);
+        impl->onUpdate();
+    }
+}
+
 #pragma mark - Toggles
 
 void Map::setDebug(MapDebugOptions debugOptions) {
@@ -490,6 +526,18 @@ uint8_t Map::getPrefetchZoomDelta() const {
     return impl->prefetchZoomDelta;
 }
 
+void Map::setPrefetchTransitionTarget(bool enabled) {
+    impl->prefetchTransitionTarget = enabled;
+}
+
+bool Map::getPrefetchTransitionTarget() const {
+    return impl->prefetchTransitionTarget;
+}
+
+void Map::setPrefetchCamera(const optional<CameraOptions>& camera) {
+    impl->prefetchCamera = camera;
+}
+
 bool Map::isFullyLoaded() const {
     return impl->style->impl->isLoaded() && impl->rendererFullyLoaded;
 }
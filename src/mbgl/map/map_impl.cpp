@@ -48,6 +48,15 @@ void Map::Impl::onUpdate() {
 
     transform.updateTransitions(timePoint);
 
+    optional<TransformState> transitionTarget;
+    if (mode != MapMode::Continuous && prefetchCamera) {
+        Transform target(transform.getState());
+        target.jumpTo(*prefetchCamera);
+        transitionTarget = target.getState();
+    } else if (prefetchTransitionTarget) {
+        transitionTarget = transform.getTransitionTarget();
+    }
+
     UpdateParameters params = {style->impl->isLoaded(),
                                mode,
                                pixelRatio,
@@ -64,6 +73,7 @@ void Map::Impl::onUpdate() {
                                annotationManager.makeWeakPtr(),
                                fileSource,
                                prefetchZoomDelta,
+                               std::move(transitionTarget),
                                bool(stillImageRequest),
                                crossSourceCollisions};
 
@@ -73,6 +83,7 @@ void Map::Impl::onUpdate() {
 void Map::Impl::onStyleLoading() {
     loading = true;
     rendererFullyLoaded = false;
+    reachStartupMilestone(MapObserver::StartupMilestone::StyleRequested);
     observer.onWillStartLoadingMap();
 }
 
@@ -83,6 +94,7 @@ void Map::Impl::onStyleLoaded() {
     if (LayerManager::annotationsEnabled) {
         annotationManager.onStyleLoaded();
     }
+    reachStartupMilestone(MapObserver::StartupMilestone::StyleParsed);
     observer.onDidFinishLoadingStyle();
 }
 
@@ -138,6 +150,12 @@ void Map::Impl::onDidFinishRenderingFrame(RenderMode renderMode, bool needsRepai
             onUpdate();
         } else if (rendererFullyLoaded) {
             observer.onDidBecomeIdle();
+            // The callbacks may register new ones for the next time.
+            auto callbacks = std::move(idleCallbacks);
+            idleCallbacks.clear();
+            for (auto& callback : callbacks) {
+                callback(nullptr);
+            }
         }
     } else if (stillImageRequest && rendererFullyLoaded) {
         auto request = std::move(stillImageRequest);
@@ -161,6 +179,33 @@ void Map::Impl::onDidFinishRenderingMap() {
     }
 };
 
+void Map::Impl::onDidReachStartupMilestone(StartupMilestone milestone) {
+    switch (milestone) {
+        case StartupMilestone::FirstFrame:
+            reachStartupMilestone(MapObserver::StartupMilestone::FirstFrame);
+            break;
+        case StartupMilestone::FirstTileRendered:
+            reachStartupMilestone(MapObserver::StartupMilestone::FirstTileRendered);
+            break;
+        case StartupMilestone::ProgramsReady:
+            reachStartupMilestone(MapObserver::StartupMilestone::ProgramsReady);
+            break;
+    }
+}
+
+void Map::Impl::onDidUpdateLoadProgress(const LoadProgress& progress) {
+    observer.onDidUpdateLoadProgress(progress);
+}
+
+void Map::Impl::reachStartupMilestone(MapObserver::StartupMilestone milestone) {
+    const uint32_t bit = 1u << static_cast<uint32_t>(milestone);
+    if (startupMilestones & bit) {
+        return;
+    }
+    startupMilestones |= bit;
+    observer.onDidReachStartupMilestone(milestone, Clock::now() - creationTime);
+}
+
 void Map::Impl::jumpTo(const CameraOptions& camera) {
     cameraMutated = true;
     transform.jumpTo(camera);
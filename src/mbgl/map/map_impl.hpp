@@ -45,11 +45,14 @@ public:
     void onDidFinishRenderingFrame(RenderMode, bool, bool) final;
     void onWillStartRenderingMap() final;
     void onDidFinishRenderingMap() final;
+    void onDidReachStartupMilestone(StartupMilestone) final;
+    void onDidUpdateLoadProgress(const LoadProgress&) final;
     void onStyleImageMissing(const std::string&, const std::function<void()>&) final;
     void onRemoveUnusedStyleImages(const std::vector<std::string>&) final;
 
     // Map
     void jumpTo(const CameraOptions&);
+    void reachStartupMilestone(MapObserver::StartupMilestone);
 
     MapObserver& observer;
     RendererFrontend& rendererFrontend;
@@ -70,10 +73,17 @@ public:
     bool cameraMutated = false;
 
     uint8_t prefetchZoomDelta = util::DEFAULT_PREFETCH_ZOOM_DELTA;
+    bool prefetchTransitionTarget = false;
+    optional<CameraOptions> prefetchCamera;
 
     bool loading = false;
     bool rendererFullyLoaded;
+
+    const TimePoint creationTime = Clock::now();
+    // Bits of the startup milestones that were reported already.
+    uint32_t startupMilestones = 0;
     std::unique_ptr<StillImageRequest> stillImageRequest;
+    std::vector<Map::IdleCallback> idleCallbacks;
 };
 
 } // namespace mbgl
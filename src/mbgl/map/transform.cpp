@@ -515,6 +515,15 @@ void Transform::startTransition(const CameraOptions& camera,
     transitionStart = Clock::now();
     transitionDuration = duration;
 
+    if (isAnimated) {
+        // Play the last frame on the side, so that the destination is known ahead of arrival.
+        const TransformState current = state;
+        frame(1.0);
+        if (anchor) state.moveLatLng(anchorLatLng, *anchor);
+        transitionTarget = state;
+        state = current;
+    }
+
     transitionFrameFn = [isAnimated, animation, frame, anchor, anchorLatLng, this](const TimePoint now) {
         float t = isAnimated ? (std::chrono::duration<float>(now - transitionStart) / transitionDuration) : 1.0;
         if (t >= 1.0) {
@@ -540,6 +549,7 @@ void Transform::startTransition(const CameraOptions& camera,
     };
 
     transitionFinishFn = [isAnimated, animation, this] {
+        transitionTarget = nullopt;
         state.setProperties(
             TransformStateProperties().withPanningInProgress(false).withScalingInProgress(false).withRotatingInProgress(
                 false));
@@ -628,6 +638,14 @@ ScreenCoordinate Transform::latLngToScreenCoordinate(const LatLng& latLng) const
     return point;
 }
 
+std::vector<ScreenCoordinate> Transform::latLngsToScreenCoordinates(const std::vector<LatLng>& latLngs) const {
+    std::vector<ScreenCoordinate> points = state.latLngsToScreenCoordinates(latLngs);
+    for (auto& point : points) {
+        point.y = state.getSize().height - point.y;
+    }
+    return points;
+}
+
 LatLng Transform::screenCoordinateToLatLng(const ScreenCoordinate& point, LatLng::WrapMode wrapMode) const {
     ScreenCoordinate flippedPoint = point;
     flippedPoint.y = state.getSize().height - flippedPoint.y;
@@ -97,6 +97,8 @@ public:
     void updateTransitions(const TimePoint& now);
     TimePoint getTransitionStart() const { return transitionStart; }
     Duration getTransitionDuration() const { return transitionDuration; }
+    // The camera at the end of the running animated transition, if any.
+    const optional<TransformState>& getTransitionTarget() const { return transitionTarget; }
     void cancelTransitions();
 
     // Gesture
@@ -111,6 +113,7 @@ public:
 
     // Conversion and projection
     ScreenCoordinate latLngToScreenCoordinate(const LatLng&) const;
+    std::vector<ScreenCoordinate> latLngsToScreenCoordinates(const std::vector<LatLng>&) const;
     LatLng screenCoordinateToLatLng(const ScreenCoordinate&, LatLng::WrapMode = LatLng::Wrapped) const;
 
 private:
@@ -127,6 +130,7 @@ private:
 
     TimePoint transitionStart;
     Duration transitionDuration;
+    optional<TransformState> transitionTarget;
     std::function<bool(const TimePoint)> transitionFrameFn;
     std::function<void()> transitionFinishFn;
 };
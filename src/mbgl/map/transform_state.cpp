@@ -83,6 +83,12 @@ void TransformState::getProjMatrix(mat4& projMatrix, uint16_t nearZ, bool aligne
         return;
     }
 
+    // The default projection is cached until the state changes.
+    if (nearZ == 1 && !aligned && !needsMatricesUpdate()) {
+        projMatrix = projectionMatrix;
+        return;
+    }
+
     const double cameraToCenterDistance = getCameraToCenterDistance();
     const ScreenCoordinate offset = getCenterOffset();
 
@@ -527,6 +533,25 @@ ScreenCoordinate TransformState::latLngToScreenCoordinate(const LatLng& latLng,
     return {p[0] / p[3], size.height - p[1] / p[3]};
 }
 
+std::vector<ScreenCoordinate> TransformState::latLngsToScreenCoordinates(const std::vector<LatLng>& latLngs) const {
+    if (size.isEmpty()) {
+        return std::vector<ScreenCoordinate>(latLngs.size());
+    }
+
+    std::vector<ScreenCoordinate> result;
+    result.reserve(latLngs.size());
+    const mat4& m = getCoordMatrix();
+    for (const auto& latLng : latLngs) {
+        // Points are on the ground (z = 0, w = 1), so only those columns of the matrix apply.
+        const Point<double> pt = Projection::project(latLng, scale) / util::tileSize;
+        const double x = m[0] * pt.x + m[4] * pt.y + m[12];
+        const double y = m[1] * pt.x + m[5] * pt.y + m[13];
+        const double w = m[3] * pt.x + m[7] * pt.y + m[15];
+        result.emplace_back(x / w, size.height - y / w);
+    }
+    return result;
+}
+
 TileCoordinate TransformState::screenCoordinateToTileCoordinate(const ScreenCoordinate& point, uint8_t atZoom) const {
     if (size.isEmpty()) {
         return {{}, 0};
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 
 namespace mbgl {
@@ -9,10 +10,8 @@ class ProgramParameters;
 namespace programs {
 namespace gl {
 
-std::string programIdentifier(const std::string& defines1,
-                              const std::string& defines2,
-                              const uint8_t hash1[8],
-                              const uint8_t hash2[8]);
+// Identifies the source of a program variant, cached program binaries of other sources don't apply.
+std::string programIdentifier(const std::string& defines1, const std::string& defines2, const uint8_t hash[8]);
 
 } // namespace gl
 } // namespace programs
@@ -1,10 +1,13 @@
 #include <mbgl/programs/program_parameters.hpp>
 #include <mbgl/util/string.hpp>
 
+#include <functional>
+
 namespace mbgl {
 
 ProgramParameters::ProgramParameters(const float pixelRatio,
-                                     const bool overdraw)
+                                     const bool overdraw,
+                                     optional<std::string> cacheDir_)
     : defines([&] {
           std::string result;
           result.reserve(32);
@@ -15,11 +18,21 @@ ProgramParameters::ProgramParameters(const float pixelRatio,
               result += "#define OVERDRAW_INSPECTOR\n";
           }
           return result;
-      }()) {
+      }()),
+      cacheDir(std::move(cacheDir_)) {
 }
 
 const std::string& ProgramParameters::getDefines() const {
     return defines;
 }
 
+optional<std::string> ProgramParameters::cachePath(const char* name, const std::string& additionalDefines) const {
+    if (!cacheDir) {
+        return {};
+    }
+    // Variants of a program differ by their defines.
+    const auto variant = static_cast<uint64_t>(std::hash<std::string>()(defines + additionalDefines));
+    return *cacheDir + "/com.mapbox.gl.shader." + name + "." + util::toHex(variant) + ".bin";
+}
+
 } // namespace mbgl
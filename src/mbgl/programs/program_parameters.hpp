@@ -8,12 +8,17 @@ namespace mbgl {
 
 class ProgramParameters {
 public:
-    ProgramParameters(float pixelRatio, bool overdraw);
+    ProgramParameters(float pixelRatio, bool overdraw, optional<std::string> cacheDir = {});
 
     const std::string& getDefines() const;
 
+    // The file caching the binary of the program with that name and additional defines, if the
+    // programs are cached.
+    optional<std::string> cachePath(const char* name, const std::string& additionalDefines) const;
+
 private:
     std::string defines;
+    optional<std::string> cacheDir;
 };
 
 } // namespace mbgl
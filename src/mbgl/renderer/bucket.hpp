@@ -4,19 +4,27 @@
 #include <mbgl/style/image_impl.hpp>
 #include <mbgl/renderer/image_atlas.hpp>
 #include <mbgl/style/layer_impl.hpp>
+#include <mbgl/style/layer_properties.hpp>
 #include <atomic>
 
 namespace mbgl {
 
 namespace gfx {
 class UploadPass;
+class IndexBuffer;
+template <class>
+class IndexVector;
+template <class>
+class VertexBuffer;
+template <class>
+class VertexVector;
 } // namespace gfx
 
 class RenderLayer;
 class CrossTileSymbolLayerIndex;
 class OverscaledTileID;
 class PatternDependency;
-using PatternLayerMap = std::map<std::string, PatternDependency>;
+using PatternLayerMap = std::map<StringIdentity, PatternDependency>;
 class Placement;
 class TransformState;
 class BucketPlacementData;
@@ -41,8 +49,15 @@ public:
 
     virtual void update(const FeatureStates&, const GeometryTileLayer&, const std::string&, const ImagePositions&) {}
 
+    // Applies changed data-driven paint properties of one of the bucket's layers by evaluating them
+    // again for the features of the existing layout, which are read from the source layer.
+    virtual void updatePaintProperties(const Immutable<style::LayerProperties>&,
+                                       const GeometryTileLayer&,
+                                       const CanonicalTileID&) {}
+
     // As long as this bucket has a Prepare render pass, this function is getting called. Typically,
-    // this only happens once when the bucket is being rendered for the first time.
+    // this only happens once when the bucket is being rendered for the first time. Feature state
+    // and paint property updates call it again; buckets then only upload what has changed.
     virtual void upload(gfx::UploadPass&) = 0;
 
     virtual bool hasData() const = 0;
@@ -54,6 +69,10 @@ public:
     bool needsUpload() const {
         return hasData() && !uploaded;
     }
+
+    // Returns the approximate number of bytes held by the bucket's vertex, index and texture
+    // data, whether it is still in memory or already uploaded to the GPU.
+    virtual std::size_t getMemoryUsage() const { return 0u; }
    
     // The following methods are implemented by buckets that require cross-tile indexing and placement.
 
@@ -65,11 +84,27 @@ public:
     }
     // Places this bucket to the given placement.
     virtual void place(Placement&, const BucketPlacementData&, std::set<uint32_t>&) {}
-    virtual void updateVertices(
-        const Placement&, bool /*updateOpacities*/, const TransformState&, const RenderTile&, std::set<uint32_t>&) {}
+    // Updates the opacities of the symbols from the given placement.
+    virtual void updateOpacities(const Placement&, const TransformState&, std::set<uint32_t>&) {}
+    // Updates the vertices that follow the camera. Called concurrently for different buckets.
+    virtual void updateDynamicVertices(const Placement&, const TransformState&, const RenderTile&) {}
+    // The number of symbols whose vertices updateDynamicVertices() recomputes, 0 if it does nothing.
+    virtual std::size_t getDynamicSymbolCount() const { return 0u; }
 
 protected:
     Bucket() = default;
+
+    template <class Vertex>
+    static std::size_t memoryUsage(const gfx::VertexVector<Vertex>& vertices,
+                                   const optional<gfx::VertexBuffer<Vertex>>& buffer) {
+        return (buffer ? buffer->elements : vertices.elements()) * sizeof(Vertex);
+    }
+
+    template <class DrawMode>
+    static std::size_t memoryUsage(const gfx::IndexVector<DrawMode>& indices, const optional<gfx::IndexBuffer>& buffer) {
+        return (buffer ? buffer->elements : indices.elements()) * sizeof(uint16_t);
+    }
+
     std::atomic<bool> uploaded { false };
 };
 
@@ -5,6 +5,7 @@
 #include <mbgl/renderer/layers/render_circle_layer.hpp>
 #include <mbgl/util/constants.hpp>
 #include <mbgl/util/math.hpp>
+#include <mbgl/util/string_indexer.hpp>
 
 namespace mbgl {
 
@@ -16,7 +17,7 @@ CircleBucket::CircleBucket(const std::map<std::string, Immutable<LayerProperties
     : mode(mode_) {
     for (const auto& pair : layerPaintProperties) {
         paintPropertyBinders.emplace(std::piecewise_construct,
-                                     std::forward_as_tuple(pair.first),
+                                     std::forward_as_tuple(pair.second->baseImpl->internedID),
                                      std::forward_as_tuple(getEvaluated<CircleLayerProperties>(pair.second), zoom));
     }
 }
@@ -24,7 +25,7 @@ CircleBucket::CircleBucket(const std::map<std::string, Immutable<LayerProperties
 CircleBucket::~CircleBucket() = default;
 
 void CircleBucket::upload(gfx::UploadPass& uploadPass) {
-    if (!uploaded) {
+    if (!vertexBuffer) {
         vertexBuffer = uploadPass.createVertexBuffer(std::move(vertices));
         indexBuffer = uploadPass.createIndexBuffer(std::move(triangles));
     }
@@ -40,8 +41,12 @@ bool CircleBucket::hasData() const {
     return !segments.empty();
 }
 
+std::size_t CircleBucket::getMemoryUsage() const {
+    return memoryUsage(vertices, vertexBuffer) + memoryUsage(triangles, indexBuffer);
+}
+
 template <class Property>
-static float get(const CirclePaintProperties::PossiblyEvaluated& evaluated, const std::string& id, const std::map<std::string, CircleProgram::Binders>& paintPropertyBinders) {
+static float get(const CirclePaintProperties::PossiblyEvaluated& evaluated, StringIdentity id, const std::map<StringIdentity, CircleProgram::Binders>& paintPropertyBinders) {
     auto it = paintPropertyBinders.find(id);
     if (it == paintPropertyBinders.end() || !it->second.statistics<Property>().max()) {
         return evaluated.get<Property>().constantOr(Property::defaultValue());
@@ -52,19 +57,30 @@ static float get(const CirclePaintProperties::PossiblyEvaluated& evaluated, cons
 
 float CircleBucket::getQueryRadius(const RenderLayer& layer) const {
     const auto& evaluated = getEvaluated<CircleLayerProperties>(layer.evaluatedProperties);
-    float radius = get<CircleRadius>(evaluated, layer.getID(), paintPropertyBinders);
-    float stroke = get<CircleStrokeWidth>(evaluated, layer.getID(), paintPropertyBinders);
+    float radius = get<CircleRadius>(evaluated, layer.baseImpl->internedID, paintPropertyBinders);
+    float stroke = get<CircleStrokeWidth>(evaluated, layer.baseImpl->internedID, paintPropertyBinders);
     auto translate = evaluated.get<CircleTranslate>();
     return radius + stroke + util::length(translate[0], translate[1]);
 }
 
 void CircleBucket::update(const FeatureStates& states, const GeometryTileLayer& layer, const std::string& layerID,
                           const ImagePositions& imagePositions) {
-    auto it = paintPropertyBinders.find(layerID);
+    auto it = paintPropertyBinders.find(util::stringIndexer().get(layerID));
     if (it != paintPropertyBinders.end()) {
         it->second.updateVertexVectors(states, layer, imagePositions);
         uploaded = false;
     }
 }
 
+void CircleBucket::updatePaintProperties(const Immutable<style::LayerProperties>& layerProperties,
+                                         const GeometryTileLayer& layer,
+                                         const CanonicalTileID& canonical) {
+    auto it = paintPropertyBinders.find(layerProperties->baseImpl->internedID);
+    if (it != paintPropertyBinders.end()) {
+        it->second = CircleProgram::Binders(
+            getEvaluated<CircleLayerProperties>(layerProperties), it->second, layer, canonical);
+        uploaded = false;
+    }
+}
+
 } // namespace mbgl
@@ -23,12 +23,16 @@ public:
     ~CircleBucket() override;
 
     bool hasData() const override;
+    std::size_t getMemoryUsage() const override;
 
     void upload(gfx::UploadPass&) override;
 
     float getQueryRadius(const RenderLayer&) const override;
 
     void update(const FeatureStates&, const GeometryTileLayer&, const std::string&, const ImagePositions&) override;
+    void updatePaintProperties(const Immutable<style::LayerProperties>&,
+                               const GeometryTileLayer&,
+                               const CanonicalTileID&) override;
 
     gfx::VertexVector<CircleLayoutVertex> vertices;
     gfx::IndexVector<gfx::Triangles> triangles;
@@ -37,7 +41,7 @@ public:
     optional<gfx::VertexBuffer<CircleLayoutVertex>> vertexBuffer;
     optional<gfx::IndexBuffer> indexBuffer;
 
-    std::map<std::string, CircleProgram::Binders> paintPropertyBinders;
+    std::map<StringIdentity, CircleProgram::Binders> paintPropertyBinders;
 
     const MapMode mode;
 };
@@ -1,26 +1,15 @@
 #include <mbgl/renderer/buckets/fill_bucket.hpp>
+#include <mbgl/renderer/buckets/fill_tessellation.hpp>
 #include <mbgl/programs/fill_program.hpp>
 #include <mbgl/renderer/bucket_parameters.hpp>
 #include <mbgl/style/layers/fill_layer_impl.hpp>
 #include <mbgl/renderer/layers/render_fill_layer.hpp>
+#include <mbgl/util/constants.hpp>
 #include <mbgl/util/math.hpp>
-
-#include <mapbox/earcut.hpp>
+#include <mbgl/util/string_indexer.hpp>
 
 #include <cassert>
 
-namespace mapbox {
-namespace util {
-template <> struct nth<0, mbgl::GeometryCoordinate> {
-    static int64_t get(const mbgl::GeometryCoordinate& t) { return t.x; };
-};
-
-template <> struct nth<1, mbgl::GeometryCoordinate> {
-    static int64_t get(const mbgl::GeometryCoordinate& t) { return t.y; };
-};
-} // namespace util
-} // namespace mapbox
-
 namespace mbgl {
 
 using namespace style;
@@ -30,11 +19,12 @@ struct GeometryTooLongException : std::exception {};
 FillBucket::FillBucket(const FillBucket::PossiblyEvaluatedLayoutProperties&,
                        const std::map<std::string, Immutable<style::LayerProperties>>& layerPaintProperties,
                        const float zoom,
-                       const uint32_t) {
+                       const uint32_t overscaling)
+    : overscaled(overscaling > 1) {
     for (const auto& pair : layerPaintProperties) {
         paintPropertyBinders.emplace(
             std::piecewise_construct,
-            std::forward_as_tuple(pair.first),
+            std::forward_as_tuple(pair.second->baseImpl->internedID),
             std::forward_as_tuple(
                 getEvaluated<FillLayerProperties>(pair.second),
                 zoom));
@@ -62,6 +52,8 @@ void FillBucket::addFeature(const GeometryTileFeature& feature,
         }
 
         std::size_t startVertices = vertices.elements();
+        vertices.grow(totalVertices);
+        lines.grow(totalVertices * 2);
 
         for (const auto& ring : polygon) {
             std::size_t nVertices = ring.size();
@@ -77,6 +69,11 @@ void FillBucket::addFeature(const GeometryTileFeature& feature,
             assert(lineSegment.vertexLength <= std::numeric_limits<uint16_t>::max());
             uint16_t lineIndex = lineSegment.vertexLength;
 
+            for (const auto& point : ring) {
+                exceedsTile = exceedsTile || point.x <= 0 || point.x >= util::EXTENT || point.y <= 0 ||
+                              point.y >= util::EXTENT;
+            }
+
             vertices.emplace_back(FillProgram::layoutVertex(ring[0]));
             lines.emplace_back(lineIndex + nVertices - 1, lineIndex);
 
@@ -89,7 +86,7 @@ void FillBucket::addFeature(const GeometryTileFeature& feature,
             lineSegment.indexLength += nVertices * 2;
         }
 
-        std::vector<uint32_t> indices = mapbox::earcut(polygon);
+        std::vector<uint32_t> indices = tessellatePolygon(polygon, overscaled);
 
         std::size_t nIndicies = indices.size();
         assert(nIndicies % 3 == 0);
@@ -102,11 +99,7 @@ void FillBucket::addFeature(const GeometryTileFeature& feature,
         assert(triangleSegment.vertexLength <= std::numeric_limits<uint16_t>::max());
         uint16_t triangleIndex = triangleSegment.vertexLength;
 
-        for (std::size_t i = 0; i < nIndicies; i += 3) {
-            triangles.emplace_back(triangleIndex + indices[i],
-                                   triangleIndex + indices[i + 1],
-                                   triangleIndex + indices[i + 2]);
-        }
+        triangles.append(indices.begin(), indices.end(), triangleIndex);
 
         triangleSegment.vertexLength += totalVertices;
         triangleSegment.indexLength += nIndicies;
@@ -124,7 +117,7 @@ void FillBucket::addFeature(const GeometryTileFeature& feature,
 }
 
 void FillBucket::upload(gfx::UploadPass& uploadPass) {
-    if (!uploaded) {
+    if (!vertexBuffer) {
         vertexBuffer = uploadPass.createVertexBuffer(std::move(vertices));
         lineIndexBuffer = uploadPass.createIndexBuffer(std::move(lines));
         triangleIndexBuffer =
@@ -142,6 +135,11 @@ bool FillBucket::hasData() const {
     return !triangleSegments.empty() || !lineSegments.empty();
 }
 
+std::size_t FillBucket::getMemoryUsage() const {
+    return memoryUsage(vertices, vertexBuffer) + memoryUsage(lines, lineIndexBuffer) +
+           memoryUsage(triangles, triangleIndexBuffer);
+}
+
 float FillBucket::getQueryRadius(const RenderLayer& layer) const {
     const auto& evaluated = getEvaluated<FillLayerProperties>(layer.evaluatedProperties);
     const std::array<float, 2>& translate = evaluated.get<FillTranslate>();
@@ -150,11 +148,22 @@ float FillBucket::getQueryRadius(const RenderLayer& layer) const {
 
 void FillBucket::update(const FeatureStates& states, const GeometryTileLayer& layer, const std::string& layerID,
                         const ImagePositions& imagePositions) {
-    auto it = paintPropertyBinders.find(layerID);
+    auto it = paintPropertyBinders.find(util::stringIndexer().get(layerID));
     if (it != paintPropertyBinders.end()) {
         it->second.updateVertexVectors(states, layer, imagePositions);
         uploaded = false;
     }
 }
 
+void FillBucket::updatePaintProperties(const Immutable<style::LayerProperties>& layerProperties,
+                                       const GeometryTileLayer& layer,
+                                       const CanonicalTileID& canonical) {
+    auto it = paintPropertyBinders.find(layerProperties->baseImpl->internedID);
+    if (it != paintPropertyBinders.end()) {
+        it->second = FillProgram::Binders(
+            getEvaluated<FillLayerProperties>(layerProperties), it->second, layer, canonical);
+        uploaded = false;
+    }
+}
+
 } // namespace mbgl
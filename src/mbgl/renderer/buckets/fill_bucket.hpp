@@ -33,12 +33,16 @@ public:
                     const CanonicalTileID&) override;
 
     bool hasData() const override;
+    std::size_t getMemoryUsage() const override;
 
     void upload(gfx::UploadPass&) override;
 
     float getQueryRadius(const RenderLayer&) const override;
 
     void update(const FeatureStates&, const GeometryTileLayer&, const std::string&, const ImagePositions&) override;
+    void updatePaintProperties(const Immutable<style::LayerProperties>&,
+                               const GeometryTileLayer&,
+                               const CanonicalTileID&) override;
 
     gfx::VertexVector<FillLayoutVertex> vertices;
     gfx::IndexVector<gfx::Lines> lines;
@@ -50,7 +54,15 @@ public:
     optional<gfx::IndexBuffer> lineIndexBuffer;
     optional<gfx::IndexBuffer> triangleIndexBuffer;
 
-    std::map<std::string, FillProgram::Binders> paintPropertyBinders;
+    std::map<StringIdentity, FillProgram::Binders> paintPropertyBinders;
+
+    // Whether a polygon reaches the tile boundary or goes past it, and thus needs to be clipped
+    // to the tile.
+    bool exceedsTile = false;
+
+private:
+    // Tiles past the maximum zoom level of their source share the triangulations of their polygons.
+    const bool overscaled;
 };
 
 } // namespace mbgl
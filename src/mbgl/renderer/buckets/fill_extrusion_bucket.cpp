@@ -1,33 +1,15 @@
 #include <mbgl/renderer/buckets/fill_extrusion_bucket.hpp>
+#include <mbgl/renderer/buckets/fill_tessellation.hpp>
 #include <mbgl/programs/fill_extrusion_program.hpp>
 #include <mbgl/renderer/bucket_parameters.hpp>
 #include <mbgl/style/layers/fill_extrusion_layer_impl.hpp>
 #include <mbgl/renderer/layers/render_fill_extrusion_layer.hpp>
 #include <mbgl/util/math.hpp>
+#include <mbgl/util/string_indexer.hpp>
 #include <mbgl/util/constants.hpp>
 
-#include <mapbox/earcut.hpp>
-
 #include <cassert>
 
-namespace mapbox {
-namespace util {
-template <>
-struct nth<0, mbgl::GeometryCoordinate> {
-    static int64_t get(const mbgl::GeometryCoordinate& t) {
-        return t.x;
-    };
-};
-
-template <>
-struct nth<1, mbgl::GeometryCoordinate> {
-    static int64_t get(const mbgl::GeometryCoordinate& t) {
-        return t.y;
-    };
-};
-} // namespace util
-} // namespace mapbox
-
 namespace mbgl {
 
 using namespace style;
@@ -37,11 +19,12 @@ struct GeometryTooLongException : std::exception {};
 FillExtrusionBucket::FillExtrusionBucket(const FillExtrusionBucket::PossiblyEvaluatedLayoutProperties&,
                        const std::map<std::string, Immutable<style::LayerProperties>>& layerPaintProperties,
                        const float zoom,
-                       const uint32_t) {
+                       const uint32_t overscaling)
+    : overscaled(overscaling > 1) {
     for (const auto& pair : layerPaintProperties) {
         paintPropertyBinders.emplace(
             std::piecewise_construct,
-            std::forward_as_tuple(pair.first),
+            std::forward_as_tuple(pair.second->baseImpl->internedID),
             std::forward_as_tuple(
                 getEvaluated<FillExtrusionLayerProperties>(pair.second),
                 zoom));
@@ -74,6 +57,8 @@ void FillExtrusionBucket::addFeature(const GeometryTileFeature& feature,
         flatIndices.reserve(totalVertices);
 
         std::size_t startVertices = vertices.elements();
+        // One vertex for the roof and up to four for the wall of every edge.
+        vertices.grow(5 * totalVertices);
 
         if (triangleSegments.empty() ||
             triangleSegments.back().vertexLength + (5 * (totalVertices - 1) + 1) >
@@ -142,7 +127,7 @@ void FillExtrusionBucket::addFeature(const GeometryTileFeature& feature,
             }
         }
 
-        std::vector<uint32_t> indices = mapbox::earcut(polygon);
+        std::vector<uint32_t> indices = tessellatePolygon(polygon, overscaled);
 
         std::size_t nIndices = indices.size();
         assert(nIndices % 3 == 0);
@@ -169,7 +154,7 @@ void FillExtrusionBucket::addFeature(const GeometryTileFeature& feature,
 }
 
 void FillExtrusionBucket::upload(gfx::UploadPass& uploadPass) {
-    if (!uploaded) {
+    if (!vertexBuffer) {
         vertexBuffer = uploadPass.createVertexBuffer(std::move(vertices));
         indexBuffer = uploadPass.createIndexBuffer(std::move(triangles));
     }
@@ -185,6 +170,10 @@ bool FillExtrusionBucket::hasData() const {
     return !triangleSegments.empty();
 }
 
+std::size_t FillExtrusionBucket::getMemoryUsage() const {
+    return memoryUsage(vertices, vertexBuffer) + memoryUsage(triangles, indexBuffer);
+}
+
 float FillExtrusionBucket::getQueryRadius(const RenderLayer& layer) const {
     const auto& evaluated = getEvaluated<FillExtrusionLayerProperties>(layer.evaluatedProperties);
     const std::array<float, 2>& translate = evaluated.get<FillExtrusionTranslate>();
@@ -193,11 +182,22 @@ float FillExtrusionBucket::getQueryRadius(const RenderLayer& layer) const {
 
 void FillExtrusionBucket::update(const FeatureStates& states, const GeometryTileLayer& layer,
                                  const std::string& layerID, const ImagePositions& imagePositions) {
-    auto it = paintPropertyBinders.find(layerID);
+    auto it = paintPropertyBinders.find(util::stringIndexer().get(layerID));
     if (it != paintPropertyBinders.end()) {
         it->second.updateVertexVectors(states, layer, imagePositions);
         uploaded = false;
     }
 }
 
+void FillExtrusionBucket::updatePaintProperties(const Immutable<style::LayerProperties>& layerProperties,
+                                                const GeometryTileLayer& layer,
+                                                const CanonicalTileID& canonical) {
+    auto it = paintPropertyBinders.find(layerProperties->baseImpl->internedID);
+    if (it != paintPropertyBinders.end()) {
+        it->second = FillExtrusionProgram::Binders(
+            getEvaluated<FillExtrusionLayerProperties>(layerProperties), it->second, layer, canonical);
+        uploaded = false;
+    }
+}
+
 } // namespace mbgl
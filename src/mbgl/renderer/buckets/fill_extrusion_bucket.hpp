@@ -32,12 +32,16 @@ public:
                     const CanonicalTileID&) override;
 
     bool hasData() const override;
+    std::size_t getMemoryUsage() const override;
 
     void upload(gfx::UploadPass&) override;
 
     float getQueryRadius(const RenderLayer&) const override;
 
     void update(const FeatureStates&, const GeometryTileLayer&, const std::string&, const ImagePositions&) override;
+    void updatePaintProperties(const Immutable<style::LayerProperties>&,
+                               const GeometryTileLayer&,
+                               const CanonicalTileID&) override;
 
     gfx::VertexVector<FillExtrusionLayoutVertex> vertices;
     gfx::IndexVector<gfx::Triangles> triangles;
@@ -46,7 +50,11 @@ public:
     optional<gfx::VertexBuffer<FillExtrusionLayoutVertex>> vertexBuffer;
     optional<gfx::IndexBuffer> indexBuffer;
     
-    std::unordered_map<std::string, FillExtrusionProgram::Binders> paintPropertyBinders;
+    std::unordered_map<StringIdentity, FillExtrusionProgram::Binders> paintPropertyBinders;
+
+private:
+    // Tiles past the maximum zoom level of their source share the triangulations of their polygons.
+    const bool overscaled;
 };
 
 } // namespace mbgl
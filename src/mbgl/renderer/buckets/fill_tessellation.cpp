@@ -0,0 +1,156 @@
+#include <mbgl/renderer/buckets/fill_tessellation.hpp>
+#include <mbgl/util/hash.hpp>
+
+#include <mapbox/earcut.hpp>
+
+#include <iterator>
+#include <limits>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace mapbox {
+namespace util {
+template <> struct nth<0, mbgl::GeometryCoordinate> {
+    static int64_t get(const mbgl::GeometryCoordinate& t) { return t.x; };
+};
+
+template <> struct nth<1, mbgl::GeometryCoordinate> {
+    static int64_t get(const mbgl::GeometryCoordinate& t) { return t.y; };
+};
+} // namespace util
+} // namespace mapbox
+
+namespace mbgl {
+
+namespace {
+
+// Polygons are compared by their vertices with a marker between rings, so that the same vertices
+// split into different rings don't share a triangulation.
+using PolygonKey = std::vector<GeometryCoordinate>;
+
+PolygonKey polygonKey(const GeometryPolygon& polygon) {
+    std::size_t size = polygon.size();
+    for (const auto& ring : polygon) {
+        size += ring.size();
+    }
+
+    PolygonKey key;
+    key.reserve(size);
+    for (const auto& ring : polygon) {
+        key.insert(key.end(), ring.begin(), ring.end());
+        key.emplace_back(std::numeric_limits<int16_t>::min(), static_cast<int16_t>(ring.size()));
+    }
+    return key;
+}
+
+struct PolygonKeyHash {
+    std::size_t operator()(const PolygonKey& key) const {
+        std::size_t seed = key.size();
+        for (const auto& point : key) {
+            util::hash_combine(seed, (uint32_t(uint16_t(point.x)) << 16) | uint16_t(point.y));
+        }
+        return seed;
+    }
+};
+
+// A least recently used cache of triangulations, bounded by the bytes of its keys and indices.
+class TessellationCache {
+public:
+    using Indices = std::shared_ptr<const std::vector<uint32_t>>;
+
+    Indices get(const PolygonKey& key) {
+        const std::size_t hash = PolygonKeyHash()(key);
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = find(hash, key);
+        if (it == order.end()) {
+            return {};
+        }
+        order.splice(order.begin(), order, it);
+        return it->indices;
+    }
+
+    void put(PolygonKey key, Indices indices) {
+        const std::size_t hash = PolygonKeyHash()(key);
+        const std::size_t size = entrySize(key, *indices);
+        if (size > maxBytes) {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (find(hash, key) != order.end()) {
+            return;
+        }
+        order.push_front({ hash, std::move(key), std::move(indices) });
+        index.emplace(hash, order.begin());
+        bytes += size;
+
+        while (bytes > maxBytes) {
+            const auto last = std::prev(order.end());
+            const auto range = index.equal_range(last->hash);
+            for (auto it = range.first; it != range.second; ++it) {
+                if (it->second == last) {
+                    index.erase(it);
+                    break;
+                }
+            }
+            bytes -= entrySize(last->key, *last->indices);
+            order.erase(last);
+        }
+    }
+
+private:
+    struct Entry {
+        std::size_t hash;
+        PolygonKey key;
+        Indices indices;
+    };
+    using Entries = std::list<Entry>;
+
+    Entries::iterator find(std::size_t hash, const PolygonKey& key) {
+        const auto range = index.equal_range(hash);
+        for (auto it = range.first; it != range.second; ++it) {
+            if (it->second->key == key) {
+                return it->second;
+            }
+        }
+        return order.end();
+    }
+
+    static std::size_t entrySize(const PolygonKey& key, const std::vector<uint32_t>& indices) {
+        return key.size() * sizeof(GeometryCoordinate) + indices.size() * sizeof(uint32_t);
+    }
+
+    static constexpr std::size_t maxBytes = 8 * 1024 * 1024;
+
+    std::mutex mutex;
+    Entries order;
+    std::unordered_multimap<std::size_t, Entries::iterator> index;
+    std::size_t bytes = 0;
+};
+
+TessellationCache& tessellationCache() {
+    static TessellationCache cache;
+    return cache;
+}
+
+} // namespace
+
+std::vector<uint32_t> tessellatePolygon(const GeometryPolygon& polygon, bool cached) {
+    if (!cached) {
+        return mapbox::earcut(polygon);
+    }
+
+    PolygonKey key = polygonKey(polygon);
+    auto& cache = tessellationCache();
+    if (auto indices = cache.get(key)) {
+        return *indices;
+    }
+
+    auto indices = std::make_shared<const std::vector<uint32_t>>(mapbox::earcut(polygon));
+    cache.put(std::move(key), indices);
+    return *indices;
+}
+
+} // namespace mbgl
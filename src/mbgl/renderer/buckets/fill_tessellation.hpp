@@ -0,0 +1,17 @@
+#pragma once
+
+#include <mbgl/tile/geometry_tile_data.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace mbgl {
+
+// Triangulates a polygon with earcut, returning indices into its vertices in ring order.
+//
+// Tiles overscaled past the maximum zoom level of their source contain the same polygons as the tile
+// of that zoom level, in the same tile coordinates. With `cached`, triangulations are looked up by
+// content in a cache shared by all buckets, so each overscaled zoom level doesn't run earcut again.
+std::vector<uint32_t> tessellatePolygon(const GeometryPolygon& polygon, bool cached);
+
+} // namespace mbgl
@@ -15,7 +15,7 @@ HeatmapBucket::HeatmapBucket(const BucketParameters& parameters, const std::vect
     for (const auto& layer : layers) {
         paintPropertyBinders.emplace(
             std::piecewise_construct,
-            std::forward_as_tuple(layer->baseImpl->id),
+            std::forward_as_tuple(layer->baseImpl->internedID),
             std::forward_as_tuple(
                 getEvaluated<HeatmapLayerProperties>(layer),
                 parameters.tileID.overscaledZ));
@@ -25,8 +25,10 @@ HeatmapBucket::HeatmapBucket(const BucketParameters& parameters, const std::vect
 HeatmapBucket::~HeatmapBucket() = default;
 
 void HeatmapBucket::upload(gfx::UploadPass& uploadPass) {
-    vertexBuffer = uploadPass.createVertexBuffer(std::move(vertices));
-    indexBuffer = uploadPass.createIndexBuffer(std::move(triangles));
+    if (!vertexBuffer) {
+        vertexBuffer = uploadPass.createVertexBuffer(std::move(vertices));
+        indexBuffer = uploadPass.createIndexBuffer(std::move(triangles));
+    }
 
     for (auto& pair : paintPropertyBinders) {
         pair.second.upload(uploadPass);
@@ -39,6 +41,10 @@ bool HeatmapBucket::hasData() const {
     return !segments.empty();
 }
 
+std::size_t HeatmapBucket::getMemoryUsage() const {
+    return memoryUsage(vertices, vertexBuffer) + memoryUsage(triangles, indexBuffer);
+}
+
 void HeatmapBucket::addFeature(const GeometryTileFeature& feature,
                                const GeometryCollection& geometry,
                                const ImagePositions&,
@@ -100,4 +106,15 @@ float HeatmapBucket::getQueryRadius(const RenderLayer& layer) const {
     return 0;
 }
 
+void HeatmapBucket::updatePaintProperties(const Immutable<style::LayerProperties>& layerProperties,
+                                          const GeometryTileLayer& layer,
+                                          const CanonicalTileID& canonical) {
+    auto it = paintPropertyBinders.find(layerProperties->baseImpl->internedID);
+    if (it != paintPropertyBinders.end()) {
+        it->second = HeatmapProgram::Binders(
+            getEvaluated<HeatmapLayerProperties>(layerProperties), it->second, layer, canonical);
+        uploaded = false;
+    }
+}
+
 } // namespace mbgl
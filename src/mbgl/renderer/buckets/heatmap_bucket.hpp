@@ -25,9 +25,14 @@ public:
                     std::size_t,
                     const CanonicalTileID&) override;
     bool hasData() const override;
+    std::size_t getMemoryUsage() const override;
 
     void upload(gfx::UploadPass&) override;
 
+    void updatePaintProperties(const Immutable<style::LayerProperties>&,
+                               const GeometryTileLayer&,
+                               const CanonicalTileID&) override;
+
     float getQueryRadius(const RenderLayer&) const override;
 
     gfx::VertexVector<HeatmapLayoutVertex> vertices;
@@ -37,7 +42,7 @@ public:
     optional<gfx::VertexBuffer<HeatmapLayoutVertex>> vertexBuffer;
     optional<gfx::IndexBuffer> indexBuffer;
 
-    std::map<std::string, HeatmapProgram::Binders> paintPropertyBinders;
+    std::map<StringIdentity, HeatmapProgram::Binders> paintPropertyBinders;
 
     const MapMode mode;
 };
@@ -31,8 +31,18 @@ void HillshadeBucket::upload(gfx::UploadPass& uploadPass) {
         return;
     }
 
-    const PremultipliedImage* image = demdata.getImage();
-    dem = uploadPass.createTexture(*image);
+    // Only the tile mask changes the vertices, the DEM texture is uploaded again only with new DEM data.
+    if (!dem) {
+        dem = uploadPass.createTexture(demdata.getImage());
+    } else if (demChanged) {
+        uploadPass.updateTexture(*dem, demdata.getImage());
+    } else {
+        for (const auto& border : changedBorders) {
+            uploadPass.updateTextureSub(*dem, demdata.getImage(border), border.x, border.y);
+        }
+    }
+    demChanged = false;
+    changedBorders.clear();
 
     if (!vertices.empty()) {
         vertexBuffer = uploadPass.createVertexBuffer(std::move(vertices));
@@ -44,6 +54,21 @@ void HillshadeBucket::upload(gfx::UploadPass& uploadPass) {
     uploaded = true;
 }
 
+void HillshadeBucket::setDEMBorderChanged(const int8_t dx, const int8_t dy) {
+    const auto dim = static_cast<uint16_t>(demdata.dim);
+    auto range = [&](int8_t d) -> std::pair<uint16_t, uint16_t> {
+        // The offset and length of the border in the DEM texture.
+        if (d < 0) return { 0, 1 };
+        if (d > 0) return { static_cast<uint16_t>(dim + 1), 1 };
+        return { 1, dim };
+    };
+    const auto x = range(dx);
+    const auto y = range(dy);
+    changedBorders.emplace_back(x.first, y.first, x.second, y.second);
+    uploaded = false;
+    prepared = false;
+}
+
 void HillshadeBucket::clear() {
     vertexBuffer = {};
     indexBuffer = {};
@@ -113,7 +138,18 @@ void HillshadeBucket::setMask(TileMask&& mask_) {
 }
 
 bool HillshadeBucket::hasData() const {
-    return demdata.getImage()->valid();
+    return demdata.valid();
+}
+
+std::size_t HillshadeBucket::getMemoryUsage() const {
+    std::size_t bytes = demdata.bytes();
+    if (dem) {
+        bytes += dem->size.area() * 4u;
+    }
+    if (texture) {
+        bytes += texture->getSize().area() * 4u;
+    }
+    return bytes + memoryUsage(vertices, vertexBuffer) + memoryUsage(indices, indexBuffer);
 }
 
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <mbgl/gfx/index_buffer.hpp>
+#include <mbgl/gfx/offscreen_texture.hpp>
 #include <mbgl/gfx/texture.hpp>
 #include <mbgl/gfx/vertex_buffer.hpp>
 #include <mbgl/programs/hillshade_program.hpp>
@@ -12,6 +13,7 @@
 #include <mbgl/util/image.hpp>
 #include <mbgl/util/mat4.hpp>
 #include <mbgl/util/optional.hpp>
+#include <mbgl/util/rect.hpp>
 
 namespace mbgl {
 
@@ -24,12 +26,15 @@ public:
 
     void upload(gfx::UploadPass&) override;
     bool hasData() const override;
+    std::size_t getMemoryUsage() const override;
 
     void clear();
     void setMask(TileMask&&);
 
     optional<gfx::Texture> dem;
-    optional<gfx::Texture> texture;
+    // The slopes prepared from the DEM, shared by all hillshade layers of the source. Preparing the
+    // DEM again renders into the same texture.
+    std::unique_ptr<gfx::OffscreenTexture> texture;
 
     TileMask mask{ { 0, 0, 0 } };
 
@@ -44,6 +49,18 @@ public:
         prepared = preparedState;
     }
 
+    // The DEM data changed, e.g. when its border was backfilled from a neighboring tile. Uploads
+    // the DEM texture and prepares the slopes again.
+    void setDEMDataChanged() {
+        demChanged = true;
+        uploaded = false;
+        prepared = false;
+    }
+
+    // Only the border facing the neighboring tile at `dx`, `dy` changed. Uploads just that part of
+    // the DEM texture.
+    void setDEMBorderChanged(int8_t dx, int8_t dy);
+
     // Raster-DEM Tile Sources use the default buffers from Painter
     gfx::VertexVector<HillshadeLayoutVertex> vertices;
     gfx::IndexVector<gfx::Triangles> indices;
@@ -53,6 +70,8 @@ public:
     optional<gfx::IndexBuffer> indexBuffer;
 private: 
     DEMData demdata;
+    bool demChanged = true;
+    std::vector<Rect<uint16_t>> changedBorders;
     bool prepared = false;
 };
 
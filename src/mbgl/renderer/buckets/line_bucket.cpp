@@ -3,6 +3,7 @@
 #include <mbgl/style/layers/line_layer_impl.hpp>
 #include <mbgl/util/math.hpp>
 #include <mbgl/util/constants.hpp>
+#include <mbgl/util/string_indexer.hpp>
 
 #include <cassert>
 #include <utility>
@@ -19,7 +20,7 @@ LineBucket::LineBucket(LineBucket::PossiblyEvaluatedLayoutProperties layout_,
     for (const auto& pair : layerPaintProperties) {
         paintPropertyBinders.emplace(
             std::piecewise_construct,
-            std::forward_as_tuple(pair.first),
+            std::forward_as_tuple(pair.second->baseImpl->internedID),
             std::forward_as_tuple(
                 getEvaluated<LineLayerProperties>(pair.second),
                 zoom));
@@ -143,6 +144,7 @@ void LineBucket::addGeometry(const GeometryCoordinates& coordinates,
     const LineJoinType joinType = layout.evaluate<LineJoin>(zoom, feature, canonical);
 
     const float miterLimit = joinType == LineJoinType::Bevel ? 1.05f : float(layout.get<LineMiterLimit>());
+    const float roundLimit = layout.get<LineRoundLimit>();
 
     const double sharpCornerOffset =
         overscaling == 0
@@ -171,7 +173,10 @@ void LineBucket::addGeometry(const GeometryCoordinates& coordinates,
     }
 
     const std::size_t startVertex = vertices.elements();
-    std::vector<TriangleElement> triangleStore;
+    const Distances* distances = lineDistances ? &*lineDistances : nullptr;
+    triangleStore.clear();
+    // Every vertex of the line emits at least two vertices and two triangles.
+    vertices.grow((len - first) * 2);
 
     for (std::size_t i = first; i < len; ++i) {
         if (type == FeatureType::Polygon && i == len - 1) {
@@ -251,7 +256,7 @@ void LineBucket::addGeometry(const GeometryCoordinates& coordinates,
             if (prevSegmentLength > 2.0 * sharpCornerOffset) {
                 GeometryCoordinate newPrevVertex = *currentCoordinate - convertPoint<int16_t>(util::round(convertPoint<double>(*currentCoordinate - *prevCoordinate) * (sharpCornerOffset / prevSegmentLength)));
                 distance += util::dist<double>(newPrevVertex, *prevCoordinate);
-                addCurrentVertex(newPrevVertex, distance, *prevNormal, 0, 0, false, startVertex, triangleStore, lineDistances);
+                addCurrentVertex(newPrevVertex, distance, *prevNormal, 0, 0, false, startVertex, distances);
                 prevCoordinate = newPrevVertex;
             }
         }
@@ -263,7 +268,7 @@ void LineBucket::addGeometry(const GeometryCoordinates& coordinates,
 
         if (middleVertex) {
             if (currentJoin == LineJoinType::Round) {
-                if (miterLength < layout.get<LineRoundLimit>()) {
+                if (miterLength < roundLimit) {
                     currentJoin = LineJoinType::Miter;
                 } else if (miterLength <= 2) {
                     currentJoin = LineJoinType::FakeRound;
@@ -296,7 +301,7 @@ void LineBucket::addGeometry(const GeometryCoordinates& coordinates,
         if (middleVertex && currentJoin == LineJoinType::Miter) {
             joinNormal = joinNormal * miterLength;
             addCurrentVertex(*currentCoordinate, distance, joinNormal, 0, 0, false, startVertex,
-                             triangleStore, lineDistances);
+                             distances);
 
         } else if (middleVertex && currentJoin == LineJoinType::FlipBevel) {
             // miter is too big, flip the direction to make a beveled join
@@ -312,10 +317,10 @@ void LineBucket::addGeometry(const GeometryCoordinates& coordinates,
             }
 
             addCurrentVertex(*currentCoordinate, distance, joinNormal, 0, 0, false, startVertex,
-                             triangleStore, lineDistances);
+                             distances);
 
             addCurrentVertex(*currentCoordinate, distance, joinNormal * -1.0, 0, 0, false, startVertex,
-                             triangleStore, lineDistances);
+                             distances);
         } else if (middleVertex && (currentJoin == LineJoinType::Bevel || currentJoin == LineJoinType::FakeRound)) {
             const bool lineTurnsLeft = (prevNormal->x * nextNormal->y - prevNormal->y * nextNormal->x) > 0;
             const float offset = -std::sqrt(miterLength * miterLength - 1);
@@ -333,7 +338,7 @@ void LineBucket::addGeometry(const GeometryCoordinates& coordinates,
             // Close previous segement with bevel
             if (!startOfLine) {
                 addCurrentVertex(*currentCoordinate, distance, *prevNormal, offsetA, offsetB, false,
-                                 startVertex, triangleStore, lineDistances);
+                                 startVertex, distances);
             }
 
             if (currentJoin == LineJoinType::FakeRound) {
@@ -355,34 +360,34 @@ void LineBucket::addGeometry(const GeometryCoordinates& coordinates,
                         t = t + t * t2 * (t - 1) * (A * t2 * t2 + B);
                     }
                     auto approxFractionalNormal = util::unit(*prevNormal * (1.0 - t) + *nextNormal * t);
-                    addPieSliceVertex(*currentCoordinate, distance, approxFractionalNormal, lineTurnsLeft, startVertex, triangleStore, lineDistances);
+                    addPieSliceVertex(*currentCoordinate, distance, approxFractionalNormal, lineTurnsLeft, startVertex, distances);
                 }
             }
 
             // Start next segment
             if (nextCoordinate) {
                 addCurrentVertex(*currentCoordinate, distance, *nextNormal, -offsetA, -offsetB,
-                                 false, startVertex, triangleStore, lineDistances);
+                                 false, startVertex, distances);
             }
 
         } else if (!middleVertex && currentCap == LineCapType::Butt) {
             if (!startOfLine) {
                 // Close previous segment with a butt
                 addCurrentVertex(*currentCoordinate, distance, *prevNormal, 0, 0, false,
-                                 startVertex, triangleStore, lineDistances);
+                                 startVertex, distances);
             }
 
             // Start next segment with a butt
             if (nextCoordinate) {
                 addCurrentVertex(*currentCoordinate, distance, *nextNormal, 0, 0, false,
-                                 startVertex, triangleStore, lineDistances);
+                                 startVertex, distances);
             }
 
         } else if (!middleVertex && currentCap == LineCapType::Square) {
             if (!startOfLine) {
                 // Close previous segment with a square cap
                 addCurrentVertex(*currentCoordinate, distance, *prevNormal, 1, 1, false,
-                                 startVertex, triangleStore, lineDistances);
+                                 startVertex, distances);
 
                 // The segment is done. Unset vertices to disconnect segments.
                 e1 = e2 = -1;
@@ -391,18 +396,18 @@ void LineBucket::addGeometry(const GeometryCoordinates& coordinates,
             // Start next segment
             if (nextCoordinate) {
                 addCurrentVertex(*currentCoordinate, distance, *nextNormal, -1, -1, false,
-                                 startVertex, triangleStore, lineDistances);
+                                 startVertex, distances);
             }
 
         } else if (middleVertex ? currentJoin == LineJoinType::Round : currentCap == LineCapType::Round) {
             if (!startOfLine) {
                 // Close previous segment with a butt
                 addCurrentVertex(*currentCoordinate, distance, *prevNormal, 0, 0, false,
-                                 startVertex, triangleStore, lineDistances);
+                                 startVertex, distances);
 
                 // Add round cap or linejoin at end of segment
                 addCurrentVertex(*currentCoordinate, distance, *prevNormal, 1, 1, true, startVertex,
-                                 triangleStore, lineDistances);
+                                 distances);
 
                 // The segment is done. Unset vertices to disconnect segments.
                 e1 = e2 = -1;
@@ -412,10 +417,10 @@ void LineBucket::addGeometry(const GeometryCoordinates& coordinates,
             if (nextCoordinate) {
                 // Add round cap before first segment
                 addCurrentVertex(*currentCoordinate, distance, *nextNormal, -1, -1, true,
-                                 startVertex, triangleStore, lineDistances);
+                                 startVertex, distances);
 
                 addCurrentVertex(*currentCoordinate, distance, *nextNormal, 0, 0, false,
-                                 startVertex, triangleStore, lineDistances);
+                                 startVertex, distances);
             }
         }
 
@@ -424,7 +429,7 @@ void LineBucket::addGeometry(const GeometryCoordinates& coordinates,
             if (nextSegmentLength > 2 * sharpCornerOffset) {
                 GeometryCoordinate newCurrentVertex = *currentCoordinate + convertPoint<int16_t>(util::round(convertPoint<double>(*nextCoordinate - *currentCoordinate) * (sharpCornerOffset / nextSegmentLength)));
                 distance += util::dist<double>(newCurrentVertex, *currentCoordinate);
-                addCurrentVertex(newCurrentVertex, distance, *nextNormal, 0, 0, false, startVertex, triangleStore, lineDistances);
+                addCurrentVertex(newCurrentVertex, distance, *nextNormal, 0, 0, false, startVertex, distances);
                 currentCoordinate = newCurrentVertex;
             }
         }
@@ -443,6 +448,7 @@ void LineBucket::addGeometry(const GeometryCoordinates& coordinates,
     assert(segment.vertexLength <= std::numeric_limits<uint16_t>::max());
     uint16_t index = segment.vertexLength;
 
+    triangles.grow(triangleStore.size() * 3);
     for (const auto& triangle : triangleStore) {
         triangles.emplace_back(index + triangle.a, index + triangle.b, index + triangle.c);
     }
@@ -458,8 +464,7 @@ void LineBucket::addCurrentVertex(const GeometryCoordinate& currentCoordinate,
                                   double endRight,
                                   bool round,
                                   std::size_t startVertex,
-                                  std::vector<TriangleElement>& triangleStore,
-                                  optional<Distances> lineDistances) {
+                                  const Distances* lineDistances) {
     Point<double> extrude = normal;
     double scaledDistance = lineDistances ? lineDistances->scaleToMaxLineDistance(distance) : distance;
 
@@ -490,7 +495,7 @@ void LineBucket::addCurrentVertex(const GeometryCoordinate& currentCoordinate,
     // to `linesofar`.
     if (distance > MAX_LINE_DISTANCE / 2.0f && !lineDistances) {
         distance = 0.0;
-        addCurrentVertex(currentCoordinate, distance, normal, endLeft, endRight, round, startVertex, triangleStore, lineDistances);
+        addCurrentVertex(currentCoordinate, distance, normal, endLeft, endRight, round, startVertex, lineDistances);
     }
 }
 
@@ -499,8 +504,7 @@ void LineBucket::addPieSliceVertex(const GeometryCoordinate& currentVertex,
                                    const Point<double>& extrude,
                                    bool lineTurnsLeft,
                                    std::size_t startVertex,
-                                   std::vector<TriangleElement>& triangleStore,
-                                   optional<Distances> lineDistances) {
+                                   const Distances* lineDistances) {
     Point<double> flippedExtrude = extrude * (lineTurnsLeft ? -1.0 : 1.0);
     if (lineDistances) {
         distance = lineDistances->scaleToMaxLineDistance(distance);
@@ -520,9 +524,11 @@ void LineBucket::addPieSliceVertex(const GeometryCoordinate& currentVertex,
 }
 
 void LineBucket::upload(gfx::UploadPass& uploadPass) {
-    if (!uploaded) {
+    if (!vertexBuffer) {
         vertexBuffer = uploadPass.createVertexBuffer(std::move(vertices));
         indexBuffer = uploadPass.createIndexBuffer(std::move(triangles));
+        // No geometry is added once the bucket is uploaded, so the scratch space can go.
+        std::vector<TriangleElement>().swap(triangleStore);
     }
 
     for (auto& pair : paintPropertyBinders) {
@@ -536,8 +542,12 @@ bool LineBucket::hasData() const {
     return !segments.empty();
 }
 
+std::size_t LineBucket::getMemoryUsage() const {
+    return memoryUsage(vertices, vertexBuffer) + memoryUsage(triangles, indexBuffer);
+}
+
 template <class Property>
-static float get(const LinePaintProperties::PossiblyEvaluated& evaluated, const std::string& id, const std::map<std::string, LineProgram::Binders>& paintPropertyBinders) {
+static float get(const LinePaintProperties::PossiblyEvaluated& evaluated, StringIdentity id, const std::map<StringIdentity, LineProgram::Binders>& paintPropertyBinders) {
     auto it = paintPropertyBinders.find(id);
     if (it == paintPropertyBinders.end() || !it->second.statistics<Property>().max()) {
         return evaluated.get<Property>().constantOr(Property::defaultValue());
@@ -549,9 +559,9 @@ static float get(const LinePaintProperties::PossiblyEvaluated& evaluated, const
 float LineBucket::getQueryRadius(const RenderLayer& layer) const {
     const auto& evaluated = getEvaluated<LineLayerProperties>(layer.evaluatedProperties);
     const std::array<float, 2>& translate = evaluated.get<LineTranslate>();
-    float offset = get<LineOffset>(evaluated, layer.getID(), paintPropertyBinders);
-    float lineWidth = get<LineWidth>(evaluated, layer.getID(), paintPropertyBinders);
-    float gapWidth = get<LineGapWidth>(evaluated, layer.getID(), paintPropertyBinders);
+    float offset = get<LineOffset>(evaluated, layer.baseImpl->internedID, paintPropertyBinders);
+    float lineWidth = get<LineWidth>(evaluated, layer.baseImpl->internedID, paintPropertyBinders);
+    float gapWidth = get<LineGapWidth>(evaluated, layer.baseImpl->internedID, paintPropertyBinders);
     if (gapWidth) {
         lineWidth = gapWidth + 2 * lineWidth;
     }
@@ -561,11 +571,22 @@ float LineBucket::getQueryRadius(const RenderLayer& layer) const {
 
 void LineBucket::update(const FeatureStates& states, const GeometryTileLayer& layer, const std::string& layerID,
                         const ImagePositions& imagePositions) {
-    auto it = paintPropertyBinders.find(layerID);
+    auto it = paintPropertyBinders.find(util::stringIndexer().get(layerID));
     if (it != paintPropertyBinders.end()) {
         it->second.updateVertexVectors(states, layer, imagePositions);
         uploaded = false;
     }
 }
 
+void LineBucket::updatePaintProperties(const Immutable<style::LayerProperties>& layerProperties,
+                                       const GeometryTileLayer& layer,
+                                       const CanonicalTileID& canonical) {
+    auto it = paintPropertyBinders.find(layerProperties->baseImpl->internedID);
+    if (it != paintPropertyBinders.end()) {
+        it->second = LineProgram::Binders(
+            getEvaluated<LineLayerProperties>(layerProperties), it->second, layer, canonical);
+        uploaded = false;
+    }
+}
+
 } // namespace mbgl
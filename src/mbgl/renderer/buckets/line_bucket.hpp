@@ -33,12 +33,16 @@ public:
                     const CanonicalTileID&) override;
 
     bool hasData() const override;
+    std::size_t getMemoryUsage() const override;
 
     void upload(gfx::UploadPass&) override;
 
     float getQueryRadius(const RenderLayer&) const override;
 
     void update(const FeatureStates&, const GeometryTileLayer&, const std::string&, const ImagePositions&) override;
+    void updatePaintProperties(const Immutable<style::LayerProperties>&,
+                               const GeometryTileLayer&,
+                               const CanonicalTileID&) override;
 
     PossiblyEvaluatedLayoutProperties layout;
 
@@ -49,7 +53,7 @@ public:
     optional<gfx::VertexBuffer<LineLayoutVertex>> vertexBuffer;
     optional<gfx::IndexBuffer> indexBuffer;
 
-    std::map<std::string, LineProgram::Binders> paintPropertyBinders;
+    std::map<StringIdentity, LineProgram::Binders> paintPropertyBinders;
 
 private:
     void addGeometry(const GeometryCoordinates&, const GeometryTileFeature&, const CanonicalTileID&);
@@ -67,13 +71,15 @@ private:
                           double endRight,
                           bool round,
                           std::size_t startVertex,
-                          std::vector<LineBucket::TriangleElement>& triangleStore,
-                          optional<Distances> distances);
+                          const Distances* distances);
 
     void addPieSliceVertex(const GeometryCoordinate& currentVertex, double distance,
             const Point<double>& extrude, bool lineTurnsLeft, std::size_t startVertex,
-            std::vector<TriangleElement>& triangleStore,
-            optional<Distances> distances);
+            const Distances* distances);
+
+    // Scratch space for the triangles of the geometry being added, reused between geometries and
+    // released on upload.
+    std::vector<TriangleElement> triangleStore;
 
     std::ptrdiff_t e1;
     std::ptrdiff_t e2;
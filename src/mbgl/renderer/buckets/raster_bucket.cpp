@@ -2,6 +2,8 @@
 #include <mbgl/renderer/layers/render_raster_layer.hpp>
 #include <mbgl/programs/raster_program.hpp>
 #include <mbgl/gfx/upload_pass.hpp>
+#include <mbgl/util/etc1.hpp>
+#include <mbgl/util/image_buffer_pool.hpp>
 
 namespace mbgl {
 
@@ -12,6 +14,9 @@ RasterBucket::RasterBucket(PremultipliedImage&& image_)
 
 RasterBucket::RasterBucket(std::shared_ptr<PremultipliedImage> image_) : image(std::move(image_)) {}
 
+RasterBucket::RasterBucket(Size size, std::vector<uint8_t>&& etc1Image_)
+    : etc1Image(std::make_shared<const std::vector<uint8_t>>(std::move(etc1Image_))), etc1Size(size) {}
+
 RasterBucket::~RasterBucket() = default;
 
 void RasterBucket::upload(gfx::UploadPass& uploadPass) {
@@ -19,7 +24,21 @@ void RasterBucket::upload(gfx::UploadPass& uploadPass) {
         return;
     }
     if (!texture) {
-        texture = uploadPass.createTexture(*image);
+        if (!etc1Image) {
+            texture = uploadPass.createTexture(*image);
+            textureBytes = image->bytes();
+            if (imagePool && image.use_count() == 1) {
+                imagePool->release(std::move(*image));
+                image.reset();
+            }
+        } else if (uploadPass.supportsCompressedTextures(gfx::TextureCompressionType::ETC1)) {
+            texture = uploadPass.createCompressedTexture(etc1Size, *etc1Image, gfx::TextureCompressionType::ETC1);
+            textureBytes = etc1Image->size();
+        } else {
+            const PremultipliedImage decoded = util::decodeETC1(etc1Size, *etc1Image);
+            texture = uploadPass.createTexture(decoded);
+            textureBytes = decoded.bytes();
+        }
     }
     if (!vertices.empty()) {
         vertexBuffer = uploadPass.createVertexBuffer(std::move(vertices));
@@ -42,6 +61,8 @@ void RasterBucket::clear() {
 
 void RasterBucket::setImage(std::shared_ptr<PremultipliedImage> image_) {
     image = std::move(image_);
+    imagePool = nullptr;
+    etc1Image = nullptr;
     texture = {};
     uploaded = false;
 }
@@ -105,7 +126,16 @@ void RasterBucket::setMask(TileMask&& mask_) {
 }
 
 bool RasterBucket::hasData() const {
-    return !!image;
+    return image || etc1Image || texture;
+}
+
+std::size_t RasterBucket::getMemoryUsage() const {
+    // The image is kept in memory after the texture is created, unless it went back to its pool.
+    std::size_t bytes = image ? image->bytes() : etc1Image ? etc1Image->size() : 0u;
+    if (texture) {
+        bytes += textureBytes;
+    }
+    return bytes + memoryUsage(vertices, vertexBuffer) + memoryUsage(indices, indexBuffer);
 }
 
 
@@ -12,21 +12,35 @@
 
 namespace mbgl {
 
+namespace util {
+class ImageBufferPool;
+} // namespace util
+
 class RasterBucket final : public Bucket {
 public:
     RasterBucket(PremultipliedImage&&);
     RasterBucket(std::shared_ptr<PremultipliedImage>);
+    // Takes an image compressed with util::encodeETC1().
+    RasterBucket(Size, std::vector<uint8_t>&& etc1Image);
     ~RasterBucket() override;
 
     void upload(gfx::UploadPass&) override;
     bool hasData() const override;
+    std::size_t getMemoryUsage() const override;
 
     void clear();
     void setImage(std::shared_ptr<PremultipliedImage>);
     void setMask(TileMask&&);
 
     std::shared_ptr<PremultipliedImage> image;
+    // The pool the image was decoded into, which gets the image back once it is uploaded unless
+    // the image is shared.
+    util::ImageBufferPool* imagePool = nullptr;
+    // Instead of the image, when the raster tile worker compressed it.
+    std::shared_ptr<const std::vector<uint8_t>> etc1Image;
+    Size etc1Size;
     optional<gfx::Texture> texture;
+    std::size_t textureBytes = 0;
     TileMask mask{ { 0, 0, 0 } };
 
     // Bucket specific vertices are used for Image Sources only
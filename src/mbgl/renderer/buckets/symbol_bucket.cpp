@@ -7,6 +7,7 @@
 #include <mbgl/text/glyph_atlas.hpp>
 #include <mbgl/text/placement.hpp>
 
+#include <numeric>
 #include <utility>
 
 namespace mbgl {
@@ -14,6 +15,14 @@ namespace mbgl {
 using namespace style;
 namespace {
 std::atomic<uint32_t> maxBucketInstanceId;
+
+// The layout vertices are uploaded once and never read again on the CPU, unlike the dynamic and
+// opacity vertices that placement rewrites. They are most of the vertex data of a symbol bucket,
+// so their memory is given back as soon as the GPU has its copy.
+template <class Vertex>
+void releaseVertices(gfx::VertexVector<Vertex>& vertices) {
+    vertices = {};
+}
 } // namespace
 
 SymbolBucket::SymbolBucket(Immutable<style::SymbolLayoutProperties::PossiblyEvaluated> layout_,
@@ -69,6 +78,7 @@ void SymbolBucket::upload(gfx::UploadPass& uploadPass) {
         if (!staticUploaded) {
             text.indexBuffer = uploadPass.createIndexBuffer(std::move(text.triangles), sortFeaturesByY ? gfx::BufferUsageType::StreamDraw : gfx::BufferUsageType::StaticDraw);
             text.vertexBuffer = uploadPass.createVertexBuffer(std::move(text.vertices));
+            releaseVertices(text.vertices);
             for (auto& pair : paintProperties) {
                 pair.second.textBinders.upload(uploadPass);
             }
@@ -84,11 +94,7 @@ void SymbolBucket::upload(gfx::UploadPass& uploadPass) {
             }
         }
         if (!placementChangesUploaded) {
-            if (!text.opacityVertexBuffer) {
-                text.opacityVertexBuffer = uploadPass.createVertexBuffer(std::move(text.opacityVertices), gfx::BufferUsageType::StreamDraw);
-            } else {
-                uploadPass.updateVertexBuffer(*text.opacityVertexBuffer, std::move(text.opacityVertices));
-            }
+            uploadVertexVector(uploadPass, text.opacityVertices, text.opacityVertexBuffer, text.opacityDirtyRanges, gfx::BufferUsageType::DynamicDraw);
         }
     }
 
@@ -96,6 +102,7 @@ void SymbolBucket::upload(gfx::UploadPass& uploadPass) {
         if (!staticUploaded) {
             iconBuffer.indexBuffer = uploadPass.createIndexBuffer(std::move(iconBuffer.triangles), sortFeaturesByY ? gfx::BufferUsageType::StreamDraw : gfx::BufferUsageType::StaticDraw);
             iconBuffer.vertexBuffer = uploadPass.createVertexBuffer(std::move(iconBuffer.vertices));
+            releaseVertices(iconBuffer.vertices);
             for (auto& pair : paintProperties) {
                 pair.second.iconBinders.upload(uploadPass);
             }
@@ -110,11 +117,7 @@ void SymbolBucket::upload(gfx::UploadPass& uploadPass) {
             }
         }
         if (!placementChangesUploaded) {
-            if (!iconBuffer.opacityVertexBuffer) {
-                iconBuffer.opacityVertexBuffer = uploadPass.createVertexBuffer(std::move(iconBuffer.opacityVertices), gfx::BufferUsageType::StreamDraw);
-            } else {
-                uploadPass.updateVertexBuffer(*iconBuffer.opacityVertexBuffer, std::move(iconBuffer.opacityVertices));
-            }
+            uploadVertexVector(uploadPass, iconBuffer.opacityVertices, iconBuffer.opacityVertexBuffer, iconBuffer.opacityDirtyRanges, gfx::BufferUsageType::DynamicDraw);
         }
     };
     if (hasIconData()) {
@@ -128,6 +131,7 @@ void SymbolBucket::upload(gfx::UploadPass& uploadPass) {
         if (!staticUploaded) {
             collisionBox.indexBuffer = uploadPass.createIndexBuffer(std::move(collisionBox.lines));
             collisionBox.vertexBuffer = uploadPass.createVertexBuffer(std::move(collisionBox.vertices));
+            releaseVertices(collisionBox.vertices);
         }
         if (!placementChangesUploaded) {
             if (!collisionBox.dynamicVertexBuffer) {
@@ -149,6 +153,7 @@ void SymbolBucket::upload(gfx::UploadPass& uploadPass) {
         if (!staticUploaded) {
             collisionCircle.indexBuffer = uploadPass.createIndexBuffer(std::move(collisionCircle.triangles));
             collisionCircle.vertexBuffer = uploadPass.createVertexBuffer(std::move(collisionCircle.vertices));
+            releaseVertices(collisionCircle.vertices);
         }
         if (!placementChangesUploaded) {
             if (!collisionCircle.dynamicVertexBuffer) {
@@ -178,6 +183,16 @@ bool SymbolBucket::hasData() const {
            hasTextCollisionBoxData() || hasIconCollisionCircleData() || hasTextCollisionCircleData();
 }
 
+std::size_t SymbolBucket::getMemoryUsage() const {
+    auto bufferMemoryUsage = [](const Buffer& buffer) {
+        return memoryUsage(buffer.vertices, buffer.vertexBuffer) +
+               memoryUsage(buffer.dynamicVertices, buffer.dynamicVertexBuffer) +
+               memoryUsage(buffer.opacityVertices, buffer.opacityVertexBuffer) +
+               memoryUsage(buffer.triangles, buffer.indexBuffer);
+    };
+    return bufferMemoryUsage(text) + bufferMemoryUsage(icon) + bufferMemoryUsage(sdfIcon);
+}
+
 bool SymbolBucket::hasTextData() const {
     return !text.segments.empty();
 }
@@ -232,6 +247,13 @@ void SymbolBucket::sortFeatures(const float angle) {
         return;
     }
 
+    // Small rotations rarely change the order of the symbols, and the index buffers stay valid then.
+    const auto& sortedIndexes = getSortedSymbolIndexes(angle);
+    if (sortedIndexes == drawnSymbolIndexes) {
+        return;
+    }
+    drawnSymbolIndexes = sortedIndexes;
+
     sortUploaded = false;
     uploaded = false;
 
@@ -245,7 +267,8 @@ void SymbolBucket::sortFeatures(const float angle) {
     // If the symbols are allowed to overlap sort them by their vertical screen position.
     // The index array buffer is rewritten to reference the (unchanged) vertices in the
     // sorted order.
-    for (const SymbolInstance& symbolInstance : getSortedSymbols(angle)) {
+    for (std::size_t index : drawnSymbolIndexes) {
+        const SymbolInstance& symbolInstance = symbolInstances[index];
         symbolsSortOrder->push_back(symbolInstance.dataFeatureIndex);
 
         if (symbolInstance.placedRightTextIndex) {
@@ -278,20 +301,39 @@ void SymbolBucket::sortFeatures(const float angle) {
 }
 
 SymbolInstanceReferences SymbolBucket::getSortedSymbols(const float angle) const {
-    SymbolInstanceReferences result(symbolInstances.begin(), symbolInstances.end());
+    SymbolInstanceReferences result;
+    result.reserve(symbolInstances.size());
+    for (std::size_t index : getSortedSymbolIndexes(angle)) {
+        result.emplace_back(symbolInstances[index]);
+    }
+    return result;
+}
+
+const std::vector<std::size_t>& SymbolBucket::getSortedSymbolIndexes(const float angle) const {
+    if (sortedIndexesAngle == angle) {
+        return sortedSymbolIndexes;
+    }
+    sortedIndexesAngle = angle;
+
     const float sin = std::sin(angle);
     const float cos = std::cos(angle);
+    // Rotate every anchor once rather than twice per comparison.
+    std::vector<long> rotated;
+    rotated.reserve(symbolInstances.size());
+    for (const SymbolInstance& symbolInstance : symbolInstances) {
+        rotated.push_back(std::lround(sin * symbolInstance.anchor.point.x + cos * symbolInstance.anchor.point.y));
+    }
 
-    std::sort(result.begin(), result.end(), [sin, cos](const SymbolInstance& a, const SymbolInstance& b) {
-        const auto aRotated = std::lround(sin * a.anchor.point.x + cos * a.anchor.point.y);
-        const auto bRotated = std::lround(sin * b.anchor.point.x + cos * b.anchor.point.y);
-        if (aRotated != bRotated) {
-            return aRotated < bRotated;
+    sortedSymbolIndexes.resize(symbolInstances.size());
+    std::iota(sortedSymbolIndexes.begin(), sortedSymbolIndexes.end(), std::size_t(0));
+    std::sort(sortedSymbolIndexes.begin(), sortedSymbolIndexes.end(), [&](std::size_t a, std::size_t b) {
+        if (rotated[a] != rotated[b]) {
+            return rotated[a] < rotated[b];
         }
-        return a.dataFeatureIndex > b.dataFeatureIndex;  // aRotated == bRotated
+        return symbolInstances[a].dataFeatureIndex > symbolInstances[b].dataFeatureIndex; // rotated[a] == rotated[b]
     });
 
-    return result;
+    return sortedSymbolIndexes;
 }
 
 SymbolInstanceReferences SymbolBucket::getSymbols(const optional<SortKeyRange>& range) const {
@@ -320,21 +362,31 @@ void SymbolBucket::place(Placement& placement, const BucketPlacementData& data,
     placement.placeSymbolBucket(data, seenIds);
 }
 
-void SymbolBucket::updateVertices(const Placement& placement,
-                                  bool updateOpacities,
-                                  const TransformState& state,
-                                  const RenderTile& tile,
-                                  std::set<uint32_t>& seenIds) {
-    if (updateOpacities) {
-        placement.updateBucketOpacities(*this, state, seenIds);
-        placementChangesUploaded = false;
-        uploaded = false;
-    }
+void SymbolBucket::updateOpacities(const Placement& placement,
+                                   const TransformState& state,
+                                   std::set<uint32_t>& seenIds) {
+    placement.updateBucketOpacities(*this, state, seenIds);
+    placementChangesUploaded = false;
+    uploaded = false;
+}
 
+void SymbolBucket::updateDynamicVertices(const Placement& placement,
+                                         const TransformState& state,
+                                         const RenderTile& tile) {
     if (placement.updateBucketDynamicVertices(*this, state, tile)) {
         dynamicUploaded = false;
         uploaded = false;
     }
 }
 
+std::size_t SymbolBucket::getDynamicSymbolCount() const {
+    // Mirrors the cases handled by Placement::updateBucketDynamicVertices().
+    const bool alongLine = layout->get<style::SymbolPlacement>() != style::SymbolPlacementType::Point;
+    const bool hasVariableAnchors = !layout->get<style::TextVariableAnchor>().empty();
+    if (!alongLine && !((hasVariableAnchors || allowVerticalPlacement) && hasTextData())) {
+        return 0u;
+    }
+    return text.placedSymbols.size() + icon.placedSymbols.size() + sdfIcon.placedSymbols.size();
+}
+
 } // namespace mbgl
@@ -9,6 +9,7 @@
 #include <mbgl/programs/segment.hpp>
 #include <mbgl/programs/symbol_program.hpp>
 #include <mbgl/renderer/bucket.hpp>
+#include <mbgl/renderer/paint_property_binder.hpp>
 #include <mbgl/style/layers/symbol_layer_properties.hpp>
 #include <mbgl/text/glyph_range.hpp>
 #include <mbgl/text/placement.hpp>
@@ -83,10 +84,12 @@ public:
 
     void upload(gfx::UploadPass&) override;
     bool hasData() const override;
+    std::size_t getMemoryUsage() const override;
     std::pair<uint32_t, bool> registerAtCrossTileIndex(CrossTileSymbolLayerIndex&, const RenderTile&) override;
     void place(Placement&, const BucketPlacementData&, std::set<uint32_t>&) override;
-    void updateVertices(
-        const Placement&, bool updateOpacities, const TransformState&, const RenderTile&, std::set<uint32_t>&) override;
+    void updateOpacities(const Placement&, const TransformState&, std::set<uint32_t>&) override;
+    void updateDynamicVertices(const Placement&, const TransformState&, const RenderTile&) override;
+    std::size_t getDynamicSymbolCount() const override;
     bool hasTextData() const;
     bool hasIconData() const;
     bool hasSdfIconData() const;
@@ -135,6 +138,8 @@ public:
         gfx::VertexVector<SymbolLayoutVertex> vertices;
         gfx::VertexVector<gfx::Vertex<SymbolDynamicLayoutAttributes>> dynamicVertices;
         gfx::VertexVector<gfx::Vertex<SymbolOpacityAttributes>> opacityVertices;
+        // The opacity vertices that placement changed since the previous upload, by symbol instance.
+        std::vector<FeatureVertexRange> opacityDirtyRanges;
         gfx::IndexVector<gfx::Triangles> triangles;
         SegmentVector<SymbolTextAttributes> segments;
         std::vector<PlacedSymbol> placedSymbols;
@@ -200,6 +205,16 @@ public:
     mutable optional<bool> hasFormatSectionOverrides_;
 
     FeatureSortOrder featureSortOrder;
+
+private:
+    // Returns the indexes of the `symbolInstances` items, sorted by viewport Y. The order is kept
+    // for the last angle, which both placement and sortFeatures() ask for.
+    const std::vector<std::size_t>& getSortedSymbolIndexes(float angle) const;
+
+    mutable float sortedIndexesAngle = std::numeric_limits<float>::max();
+    mutable std::vector<std::size_t> sortedSymbolIndexes;
+    // The order of the symbols in the index buffers, once sorted.
+    std::vector<std::size_t> drawnSymbolIndexes;
 };
 
 } // namespace mbgl
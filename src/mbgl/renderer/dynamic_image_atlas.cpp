@@ -0,0 +1,201 @@
+#include <mbgl/renderer/dynamic_image_atlas.hpp>
+#include <mbgl/gfx/upload_pass.hpp>
+
+#include <cassert>
+
+namespace mbgl {
+
+namespace {
+
+constexpr uint32_t padding = ImagePosition::padding;
+constexpr int32_t initialSize = 128;
+
+mapbox::ShelfPack::ShelfPackOptions packOptions() {
+    mapbox::ShelfPack::ShelfPackOptions options;
+    options.autoResize = true;
+    return options;
+}
+
+} // namespace
+
+DynamicImageAtlas::Reservation::Reservation(std::weak_ptr<DynamicImageAtlas> atlas_, std::vector<uint64_t> entries_)
+    : atlas(std::move(atlas_)), entries(std::move(entries_)) {}
+
+DynamicImageAtlas::Reservation::~Reservation() {
+    if (auto shared = atlas.lock()) {
+        shared->release(entries);
+    }
+}
+
+std::shared_ptr<DynamicImageAtlas> DynamicImageAtlas::create() {
+    return std::shared_ptr<DynamicImageAtlas>(new DynamicImageAtlas());
+}
+
+DynamicImageAtlas::DynamicImageAtlas()
+    : pack(initialSize, initialSize, packOptions()), image({uint32_t(initialSize), uint32_t(initialSize)}) {
+    image.fill(0);
+}
+
+DynamicImageAtlas::~DynamicImageAtlas() = default;
+
+std::shared_ptr<const DynamicImageAtlas::Reservation> DynamicImageAtlas::addImages(const ImageMap& icons,
+                                                                                   const ImageMap& patterns,
+                                                                                   const ImageVersionMap& versionMap,
+                                                                                   ImageAtlas& result) {
+    std::vector<uint64_t> reserved;
+    auto versionOf = [&](const std::string& id) {
+        auto it = versionMap.find(id);
+        return it != versionMap.end() ? it->second : 0u;
+    };
+
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto& entry : icons) {
+        const style::Image::Impl& icon = *entry.second;
+        result.iconPositions.emplace(icon.id, add(icon, ImageType::Icon, versionOf(entry.first), reserved));
+    }
+    for (const auto& entry : patterns) {
+        const style::Image::Impl& pattern = *entry.second;
+        result.patternPositions.emplace(pattern.id,
+                                        add(pattern, ImageType::Pattern, versionOf(entry.first), reserved));
+    }
+
+    return std::shared_ptr<const Reservation>(new Reservation(shared_from_this(), std::move(reserved)));
+}
+
+const ImagePosition& DynamicImageAtlas::add(const style::Image::Impl& image_,
+                                            ImageType type,
+                                            uint32_t version,
+                                            std::vector<uint64_t>& reserved) {
+    auto attachedIt = attached.find({image_.id, type});
+    if (attachedIt != attached.end()) {
+        Entry& entry = entries.at(attachedIt->second);
+        // A stale layout may still carry the image at its former size; it gets an entry of its own.
+        if (entry.size == image_.size) {
+            if (version > entry.position.version) {
+                paint(image_, type, entry.position.paddedRect);
+                entry.position = ImagePosition(*pack.getBin(entry.binID), image_, version);
+            }
+            ++entry.references;
+            reserved.push_back(attachedIt->second);
+            return entry.position;
+        }
+    }
+
+    const mapbox::Bin* bin =
+        pack.packOne(-1, image_.size.width + 2 * padding, image_.size.height + 2 * padding);
+    assert(bin);
+
+    if (uint32_t(pack.width()) > image.size.width || uint32_t(pack.height()) > image.size.height) {
+        image.resize({uint32_t(pack.width()), uint32_t(pack.height())});
+    }
+
+    ImagePosition position(*bin, image_, version);
+    // The bin may hold the pixels of a released image.
+    PremultipliedImage::clear(image, {position.paddedRect.x, position.paddedRect.y},
+                              {position.paddedRect.w, position.paddedRect.h});
+    paint(image_, type, position.paddedRect);
+
+    const uint64_t entryID = nextEntryID++;
+    entries.emplace(entryID, Entry{image_.id, bin->id, position, type, image_.size, 1u});
+    if (attachedIt == attached.end()) {
+        attached.emplace(std::make_pair(image_.id, type), entryID);
+    }
+    reserved.push_back(entryID);
+    return entries.at(entryID).position;
+}
+
+void DynamicImageAtlas::paint(const style::Image::Impl& image_, ImageType type, const Rect<uint16_t>& paddedRect) {
+    const uint32_t x = paddedRect.x + padding;
+    const uint32_t y = paddedRect.y + padding;
+    const uint32_t w = image_.size.width;
+    const uint32_t h = image_.size.height;
+
+    const PremultipliedImage& src = image_.getImage();
+    PremultipliedImage::copy(src, image, {0, 0}, {x, y}, image_.size);
+    if (type == ImageType::Pattern) {
+        // Add 1 pixel wrapped padding on each side of the image.
+        PremultipliedImage::copy(src, image, { 0, h - 1 }, { x, y - 1 }, { w, 1 }); // T
+        PremultipliedImage::copy(src, image, { 0,     0 }, { x, y + h }, { w, 1 }); // B
+        PremultipliedImage::copy(src, image, { w - 1, 0 }, { x - 1, y }, { 1, h }); // L
+        PremultipliedImage::copy(src, image, { 0,     0 }, { x + w, y }, { 1, h }); // R
+    }
+
+    dirtyRects.push_back(paddedRect);
+    dirty = true;
+}
+
+void DynamicImageAtlas::updateImage(const style::Image::Impl& image_, uint32_t version) {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const ImageType type : {ImageType::Icon, ImageType::Pattern}) {
+        auto attachedIt = attached.find({image_.id, type});
+        if (attachedIt == attached.end()) {
+            continue;
+        }
+        Entry& entry = entries.at(attachedIt->second);
+        if (entry.size != image_.size) {
+            attached.erase(attachedIt);
+            continue;
+        }
+        paint(image_, type, entry.position.paddedRect);
+        entry.position = ImagePosition(*pack.getBin(entry.binID), image_, version);
+    }
+}
+
+void DynamicImageAtlas::detachImage(const std::string& id) {
+    std::lock_guard<std::mutex> lock(mutex);
+    attached.erase({id, ImageType::Icon});
+    attached.erase({id, ImageType::Pattern});
+}
+
+void DynamicImageAtlas::detachAll() {
+    std::lock_guard<std::mutex> lock(mutex);
+    attached.clear();
+}
+
+void DynamicImageAtlas::release(const std::vector<uint64_t>& released) {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const uint64_t entryID : released) {
+        auto it = entries.find(entryID);
+        assert(it != entries.end());
+        if (--it->second.references == 0) {
+            if (mapbox::Bin* bin = pack.getBin(it->second.binID)) {
+                pack.unref(*bin);
+            }
+            auto attachedIt = attached.find({it->second.id, it->second.type});
+            if (attachedIt != attached.end() && attachedIt->second == entryID) {
+                attached.erase(attachedIt);
+            }
+            entries.erase(it);
+        }
+    }
+}
+
+void DynamicImageAtlas::upload(gfx::UploadPass& uploadPass) {
+    if (!dirty.exchange(false) && texture) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!texture || texture->size != image.size) {
+        texture = uploadPass.createTexture(image);
+    } else {
+        for (const auto& rect : dirtyRects) {
+            PremultipliedImage patch({rect.w, rect.h});
+            PremultipliedImage::copy(image, patch, {rect.x, rect.y}, {0, 0}, patch.size);
+            uploadPass.updateTextureSub(*texture, patch, rect.x, rect.y);
+        }
+    }
+    dirtyRects.clear();
+}
+
+Size DynamicImageAtlas::getSize() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return image.size;
+}
+
+std::size_t DynamicImageAtlas::imageCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return entries.size();
+}
+
+} // namespace mbgl
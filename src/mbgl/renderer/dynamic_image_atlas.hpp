@@ -0,0 +1,113 @@
+#pragma once
+
+#include <mbgl/gfx/texture.hpp>
+#include <mbgl/renderer/image_atlas.hpp>
+#include <mbgl/style/image_impl.hpp>
+#include <mbgl/util/noncopyable.hpp>
+#include <mbgl/util/optional.hpp>
+
+#include <mapbox/shelf-pack.hpp>
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace mbgl {
+
+namespace gfx {
+class UploadPass;
+} // namespace gfx
+
+/**
+ * @brief An icon and pattern atlas owned by the ImageManager and shared by all tiles of a renderer.
+ *
+ * Tile workers add the images of their layout with addImages() and keep the returned
+ * reservation for as long as their buckets refer to the image positions. Images used by
+ * several tiles are stored once, and the space of images that are no longer reserved by any
+ * tile is reused. Images never move, so positions stay valid when the atlas grows.
+ *
+ * When an image is updated without changing its size, updateImage() repaints it in place, so
+ * tiles pick up the new pixels without a relayout. Images that are removed or change their
+ * size are detached: tiles that still use them keep their pixels, but later layouts add the
+ * new image instead.
+ *
+ * addImages() may be called from any thread; upload() and getTexture() are only used on the
+ * render thread. upload() only sends the images changed since the previous upload, unless the
+ * atlas has grown in between.
+ */
+class DynamicImageAtlas : public std::enable_shared_from_this<DynamicImageAtlas>, private util::noncopyable {
+public:
+    class Reservation : private util::noncopyable {
+    public:
+        ~Reservation();
+
+    private:
+        friend class DynamicImageAtlas;
+        Reservation(std::weak_ptr<DynamicImageAtlas>, std::vector<uint64_t>);
+
+        const std::weak_ptr<DynamicImageAtlas> atlas;
+        const std::vector<uint64_t> entries;
+    };
+
+    static std::shared_ptr<DynamicImageAtlas> create();
+    ~DynamicImageAtlas();
+
+    // Adds the icons and patterns that aren't in the atlas yet and writes the positions of all
+    // of them to `result`. The images stay in place until the reservation is released.
+    std::shared_ptr<const Reservation> addImages(const ImageMap& icons,
+                                                 const ImageMap& patterns,
+                                                 const ImageVersionMap& versionMap,
+                                                 ImageAtlas& result);
+
+    // Repaints the icon and pattern of the image, if the atlas holds them at the same size.
+    void updateImage(const style::Image::Impl&, uint32_t version);
+    // Makes later calls to addImages() add the image again instead of sharing the stored one.
+    void detachImage(const std::string& id);
+    void detachAll();
+
+    void upload(gfx::UploadPass&);
+
+    // Null before the first upload.
+    const gfx::Texture* getTexture() const { return texture ? &*texture : nullptr; }
+
+    // The size of the atlas image, which the texture catches up with on the next upload.
+    Size getSize() const;
+    // The number of icons and patterns currently in the atlas.
+    std::size_t imageCount() const;
+
+private:
+    DynamicImageAtlas();
+
+    struct Entry {
+        std::string id;
+        int32_t binID;
+        ImagePosition position;
+        ImageType type;
+        Size size;
+        uint32_t references;
+    };
+
+    const ImagePosition& add(const style::Image::Impl&, ImageType, uint32_t version, std::vector<uint64_t>& reserved);
+    void paint(const style::Image::Impl&, ImageType, const Rect<uint16_t>& paddedRect);
+    void release(const std::vector<uint64_t>&);
+
+    mutable std::mutex mutex;
+    mapbox::ShelfPack pack;
+    PremultipliedImage image;
+    std::map<uint64_t, Entry> entries;
+    // The entries that new layouts share, by image id and type.
+    std::map<std::pair<std::string, ImageType>, uint64_t> attached;
+    uint64_t nextEntryID = 0;
+    // Padded rectangles of the images painted since the last upload.
+    std::vector<Rect<uint16_t>> dirtyRects;
+    std::atomic<bool> dirty{false};
+
+    // Render thread only.
+    optional<gfx::Texture> texture;
+};
+
+} // namespace mbgl
@@ -14,8 +14,6 @@ class UploadPass;
 class Texture;
 } // namespace gfx
 
-class ImageManager;
-
 class ImagePosition {
 public:
     ImagePosition(const mapbox::Bin&, const style::Image::Impl&, uint32_t version = 0);
@@ -53,24 +51,11 @@ public:
 
 using ImagePositions = std::map<std::string, ImagePosition>;
 
-class ImagePatch {
-public:
-    ImagePatch(Immutable<style::Image::Impl> image_, const Rect<uint16_t>& paddedRect_)
-        : image(std::move(image_)), paddedRect(paddedRect_) {}
-
-    Immutable<style::Image::Impl> image;
-    Rect<uint16_t> paddedRect;
-};
-
+// The positions of the images of a tile in the shared DynamicImageAtlas.
 class ImageAtlas {
 public:
-    PremultipliedImage image;
     ImagePositions iconPositions;
     ImagePositions patternPositions;
-
-    std::vector<ImagePatch> getImagePatchesAndUpdateVersions(const ImageManager&);
 };
 
-ImageAtlas makeImageAtlas(const ImageMap&, const ImageMap&, const std::unordered_map<std::string, uint32_t>& versionMap);
-
 } // namespace mbgl
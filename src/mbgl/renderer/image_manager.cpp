@@ -2,15 +2,18 @@
 
 #include <mbgl/actor/actor.hpp>
 #include <mbgl/actor/scheduler.hpp>
+#include <mbgl/renderer/dynamic_image_atlas.hpp>
 #include <mbgl/renderer/image_manager_observer.hpp>
 #include <mbgl/util/constants.hpp>
 #include <mbgl/util/logging.hpp>
 
+#include <algorithm>
+
 namespace mbgl {
 
 static ImageManagerObserver nullObserver;
 
-ImageManager::ImageManager() = default;
+ImageManager::ImageManager() : imageAtlas(DynamicImageAtlas::create()) {}
 
 ImageManager::~ImageManager() = default;
 
@@ -37,11 +40,15 @@ bool ImageManager::isLoaded() const {
     return loaded;
 }
 
+std::size_t ImageManager::getPendingRequestCount() const {
+    return requestors.size() + missingImageRequestors.size();
+}
+
 void ImageManager::addImage(Immutable<style::Image::Impl> image_) {
     assert(images.find(image_->id) == images.end());
     // Increase cache size if requested image was provided.
     if (requestedImages.find(image_->id) != requestedImages.end()) {
-        requestedImagesCacheSize += image_->image.bytes();
+        requestedImagesCacheSize += image_->getImage().bytes();
     }
     availableImages.emplace(image_->id);
     images.emplace(image_->id, std::move(image_));
@@ -52,18 +59,20 @@ bool ImageManager::updateImage(Immutable<style::Image::Impl> image_) {
     assert(oldImage != images.end());
     if (oldImage == images.end()) return false;
 
-    auto sizeChanged = oldImage->second->image.size != image_->image.size;
+    auto sizeChanged = oldImage->second->size != image_->size;
 
     if (sizeChanged) {
         // Update cache size if requested image size has changed.
         if (requestedImages.find(image_->id) != requestedImages.end()) {
-            int64_t diff = image_->image.bytes() - oldImage->second->image.bytes();
+            int64_t diff = image_->getImage().bytes() - oldImage->second->getImage().bytes();
             assert(static_cast<int64_t>(requestedImagesCacheSize + diff) >= 0ll);
             requestedImagesCacheSize += diff;
         }
         updatedImageVersions.erase(image_->id);
+        imageAtlas->detachImage(image_->id);
     } else {
-        updatedImageVersions[image_->id]++;
+        // Tiles share the atlas entry, so repainting it updates all of them.
+        imageAtlas->updateImage(*image_, ++updatedImageVersions[image_->id]);
     }
 
     oldImage->second = std::move(image_);
@@ -77,13 +86,15 @@ void ImageManager::removeImage(const std::string& id) {
     // Reduce cache size for requested images.
     auto requestedIt = requestedImages.find(it->second->id);
     if (requestedIt != requestedImages.end()) {
-        assert(requestedImagesCacheSize >= it->second->image.bytes());
-        requestedImagesCacheSize -= it->second->image.bytes();
+        assert(requestedImagesCacheSize >= it->second->getImage().bytes());
+        requestedImagesCacheSize -= it->second->getImage().bytes();
         requestedImages.erase(requestedIt);
+        requestedImagesLastUse.erase(id);
     }
     images.erase(it);
     availableImages.erase(id);
     updatedImageVersions.erase(id);
+    imageAtlas->detachImage(id);
 }
 
 const style::Image::Impl* ImageManager::getImage(const std::string& id) const {
@@ -166,9 +177,35 @@ void ImageManager::reduceMemoryUse() {
 }
 
 void ImageManager::reduceMemoryUseIfCacheSizeExceedsLimit() {
-    if (requestedImagesCacheSize > util::DEFAULT_ON_DEMAND_IMAGES_CACHE_SIZE) {
-        reduceMemoryUse();
+    if (requestedImagesCacheSize <= onDemandImagesCacheSize) {
+        return;
+    }
+
+    std::vector<std::pair<uint64_t, const std::string*>> unused;
+    for (const auto& pair : requestedImages) {
+        if (pair.second.empty() && images.find(pair.first) != images.end()) {
+            unused.emplace_back(requestedImagesLastUse[pair.first], &pair.first);
+        }
     }
+    std::sort(unused.begin(), unused.end());
+
+    std::vector<std::string> unusedIDs;
+    std::size_t size = requestedImagesCacheSize;
+    for (const auto& pair : unused) {
+        if (size <= onDemandImagesCacheSize) {
+            break;
+        }
+        size -= images.at(*pair.second)->getImage().bytes();
+        unusedIDs.push_back(*pair.second);
+    }
+
+    if (!unusedIDs.empty()) {
+        observer->onRemoveUnusedStyleImages(unusedIDs);
+    }
+}
+
+void ImageManager::touchRequestedImage(const std::string& id) {
+    requestedImagesLastUse[id] = ++requestedImagesUseCount;
 }
 
 const std::set<std::string>& ImageManager::getAvailableImages() const {
@@ -183,6 +220,8 @@ void ImageManager::clear() {
     availableImages.clear();
     updatedImageVersions.clear();
     requestedImages.clear();
+    requestedImagesLastUse.clear();
+    imageAtlas->detachAll();
     loaded = false;
 }
 
@@ -203,6 +242,7 @@ void ImageManager::checkMissingAndNotify(ImageRequestor& requestor, const ImageR
         for (const auto& dependency : missingDependencies) {
             const std::string& missingImage = dependency.first;
             assert(observer != nullptr);
+            touchRequestedImage(missingImage);
 
             auto existingRequestorsIt = requestedImages.find(missingImage);
             if (existingRequestorsIt != requestedImages.end()) { // Already asked client about this image.
@@ -241,8 +281,10 @@ void ImageManager::checkMissingAndNotify(ImageRequestor& requestor, const ImageR
     } else {
         // Associate requestor with an image that was provided by the client.
         for (const auto& dependency : pair.first) {
-            if (requestedImages.find(dependency.first) != requestedImages.end()) {
-                requestedImages[dependency.first].emplace(&requestor);
+            auto requestedIt = requestedImages.find(dependency.first);
+            if (requestedIt != requestedImages.end()) {
+                requestedIt->second.emplace(&requestor);
+                touchRequestedImage(dependency.first);
             }
         }
         notify(requestor, pair);
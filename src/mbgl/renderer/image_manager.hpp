@@ -1,10 +1,13 @@
 #pragma once
 
 #include <mbgl/style/image_impl.hpp>
+#include <mbgl/util/constants.hpp>
 #include <mbgl/util/immutable.hpp>
 
 #include <map>
+#include <memory>
 #include <string>
+#include <unordered_map>
 
 namespace mbgl {
 
@@ -15,6 +18,7 @@ namespace gfx {
 class UploadPass;
 } // namespace gfx
 
+class DynamicImageAtlas;
 class ImageManagerObserver;
 class ImageRequestor;
 
@@ -32,6 +36,8 @@ public:
 
     void setLoaded(bool);
     bool isLoaded() const;
+    // The requestors waiting for the sprite or for missing images.
+    std::size_t getPendingRequestCount() const;
 
     void dumpDebugLogs() const;
 
@@ -46,8 +52,13 @@ public:
     void removeRequestor(ImageRequestor&);
     void notifyIfMissingImageAdded();
     void reduceMemoryUse();
+    // Asks to remove the least recently used of the images that were provided for missing images,
+    // and that no requestor uses, until the others fit in the cache size.
     void reduceMemoryUseIfCacheSizeExceedsLimit();
+    void setOnDemandImagesCacheSize(std::size_t bytes) { onDemandImagesCacheSize = bytes; }
     const std::set<std::string>& getAvailableImages() const;
+    // The atlas shared by the tiles that use these images.
+    const std::shared_ptr<DynamicImageAtlas>& getImageAtlas() const { return imageAtlas; }
 
     ImageVersionMap updatedImageVersions;
 
@@ -57,6 +68,7 @@ private:
     void checkMissingAndNotify(ImageRequestor&, const ImageRequestPair&);
     void notify(ImageRequestor&, const ImageRequestPair&) const;
     void removePattern(const std::string&);
+    void touchRequestedImage(const std::string&);
 
     bool loaded = false;
 
@@ -64,11 +76,16 @@ private:
     std::map<ImageRequestor*, ImageRequestPair> missingImageRequestors;
     std::map<std::string, std::set<ImageRequestor*>> requestedImages;
     std::size_t requestedImagesCacheSize = 0ul;
+    std::size_t onDemandImagesCacheSize = util::DEFAULT_ON_DEMAND_IMAGES_CACHE_SIZE;
+    // When the requested images were last used, by the count of uses.
+    std::unordered_map<std::string, uint64_t> requestedImagesLastUse;
+    uint64_t requestedImagesUseCount = 0;
     ImageMap images;
     // Mirror of 'ImageMap images;' keys.
     std::set<std::string> availableImages;
 
     ImageManagerObserver* observer = nullptr;
+    std::shared_ptr<DynamicImageAtlas> imageAtlas;
 };
 
 class ImageRequestor {
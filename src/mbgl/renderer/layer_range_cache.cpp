@@ -0,0 +1,90 @@
+#include <mbgl/renderer/layer_range_cache.hpp>
+#include <mbgl/renderer/paint_parameters.hpp>
+#include <mbgl/renderer/render_static_data.hpp>
+#include <mbgl/gfx/command_encoder.hpp>
+#include <mbgl/gfx/context.hpp>
+#include <mbgl/gfx/cull_face_mode.hpp>
+#include <mbgl/gfx/render_pass.hpp>
+#include <mbgl/gfx/renderable.hpp>
+#include <mbgl/gfx/renderer_backend.hpp>
+#include <mbgl/programs/programs.hpp>
+#include <mbgl/util/constants.hpp>
+
+namespace mbgl {
+
+bool LayerRangeCache::isValid(const PaintParameters& parameters, bool layersChanged) const {
+    return texture && !layersChanged && texture->getSize() == parameters.backend.getDefaultRenderable().getSize() &&
+           matrix == parameters.transformParams.projMatrix && debugOptions == parameters.debugOptions;
+}
+
+std::unique_ptr<gfx::RenderPass> LayerRangeCache::createRenderPass(PaintParameters& parameters) {
+    const Size size = parameters.backend.getDefaultRenderable().getSize();
+    if (!texture || texture->getSize() != size) {
+        // Layers clip to tiles with the stencil buffer and may use the depth buffer.
+        texture = parameters.context.createOffscreenTextureWithDepthStencil(size);
+    }
+    matrix = parameters.transformParams.projMatrix;
+    debugOptions = parameters.debugOptions;
+    return parameters.encoder->createRenderPass("cached layers", { *texture, Color{ 0.0f, 0.0f, 0.0f, 0.0f }, 1.0f, 0 });
+}
+
+void LayerRangeCache::composite(PaintParameters& parameters) {
+    assert(texture);
+
+    // The texture covers the viewport, like a tile in the static raster vertex buffer covers its extent.
+    mat4 viewportMat;
+    matrix::ortho(viewportMat, 0, util::EXTENT, 0, util::EXTENT, 0, 1);
+
+    const style::RasterPaintProperties::PossiblyEvaluated properties;
+    const RasterProgram::Binders paintAttributeData{ properties, 0 };
+
+    auto& programInstance = parameters.programs.getRasterLayerPrograms().raster;
+
+    const auto allUniformValues = RasterProgram::computeAllUniformValues(
+        RasterProgram::LayoutUniformValues{
+            uniforms::matrix::Value(viewportMat),
+            uniforms::opacity::Value(1.0f),
+            uniforms::fade_t::Value(0.0f),
+            uniforms::brightness_low::Value(0.0f),
+            uniforms::brightness_high::Value(1.0f),
+            uniforms::saturation_factor::Value(0.0f),
+            uniforms::contrast_factor::Value(1.0f),
+            uniforms::spin_weights::Value(std::array<float, 3>{{1.0f, 0.0f, 0.0f}}),
+            uniforms::buffer_scale::Value(1.0f),
+            uniforms::scale_parent::Value(1.0f),
+            uniforms::tl_parent::Value(std::array<float, 2>{{0.0f, 0.0f}}),
+        },
+        paintAttributeData,
+        properties,
+        parameters.state.getZoom());
+    const auto allAttributeBindings = RasterProgram::computeAllAttributeBindings(
+        *parameters.staticData.rasterVertexBuffer, paintAttributeData, properties);
+
+    if (segments.empty()) {
+        // Copy over the segments so that we can create our own DrawScopes.
+        segments = RenderStaticData::rasterSegments();
+    }
+    programInstance.draw(
+        parameters.context,
+        *parameters.renderPass,
+        gfx::Triangles(),
+        parameters.depthModeForSublayer(0, gfx::DepthMaskType::ReadOnly),
+        gfx::StencilMode::disabled(),
+        parameters.colorModeForRenderPass(),
+        gfx::CullFaceMode::disabled(),
+        *parameters.staticData.quadTriangleIndexBuffer,
+        segments,
+        allUniformValues,
+        allAttributeBindings,
+        RasterProgram::TextureBindings{
+            textures::image0::Value{texture->getTexture().getResource(), gfx::TextureFilterType::Nearest},
+            textures::image1::Value{texture->getTexture().getResource(), gfx::TextureFilterType::Nearest},
+        },
+        "cached layers");
+}
+
+void LayerRangeCache::reset() {
+    texture.reset();
+}
+
+} // namespace mbgl
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <mbgl/gfx/offscreen_texture.hpp>
+#include <mbgl/map/mode.hpp>
+#include <mbgl/programs/raster_program.hpp>
+#include <mbgl/util/mat4.hpp>
+
+#include <memory>
+
+namespace mbgl {
+
+class PaintParameters;
+
+namespace gfx {
+class RenderPass;
+} // namespace gfx
+
+// Holds a range of layers rendered into a texture, so that frames in which neither the camera nor
+// these layers changed composite the texture instead of rendering the layers again.
+class LayerRangeCache {
+public:
+    // Whether the texture shows the layers as they would render with these parameters.
+    bool isValid(const PaintParameters&, bool layersChanged) const;
+
+    // Starts rendering the layers into the texture, which is cleared to transparent.
+    std::unique_ptr<gfx::RenderPass> createRenderPass(PaintParameters&);
+
+    // Draws the texture into the current render pass, at the depth of the current layer.
+    void composite(PaintParameters&);
+
+    void reset();
+
+private:
+    std::unique_ptr<gfx::OffscreenTexture> texture;
+    mat4 matrix;
+    MapDebugOptions debugOptions = MapDebugOptions::NoDebug;
+    SegmentVector<RasterAttributes> segments;
+};
+
+} // namespace mbgl
@@ -7,16 +7,24 @@
 #include <mbgl/renderer/image_manager.hpp>
 #include <mbgl/renderer/render_static_data.hpp>
 #include <mbgl/programs/programs.hpp>
+#include <mbgl/util/constants.hpp>
+#include <mbgl/util/mat4.hpp>
 #include <mbgl/util/tile_cover.hpp>
 #include <mbgl/map/transform_state.hpp>
 #include <mbgl/gfx/cull_face_mode.hpp>
 
+#include <set>
+
 namespace mbgl {
 
 using namespace style;
 
 namespace {
 
+// The number of zoom levels between the tiles a pattern background is drawn with and the tiles
+// of the integer zoom the pattern is aligned to.
+const uint8_t maxPatternZoomDifference = 3;
+
 inline const BackgroundLayer::Impl& impl_cast(const Immutable<style::Layer::Impl>& impl) {
     assert(impl->getTypeInfo() == BackgroundLayer::Impl::staticTypeInfo());
     return static_cast<const style::BackgroundLayer::Impl&>(*impl);
@@ -56,13 +64,18 @@ bool RenderBackgroundLayer::hasTransition() const {
     return unevaluated.hasTransition();
 }
 
+bool RenderBackgroundLayer::isZoomConstant() const {
+    return unevaluated.isZoomConstant();
+}
+
 bool RenderBackgroundLayer::hasCrossfade() const {
     return getCrossfade<BackgroundLayerProperties>(evaluatedProperties).t != 1;
 }
 
 void RenderBackgroundLayer::render(PaintParameters& parameters) {
     // Note that for bottommost layers without a pattern, the background color is drawn with
-    // glClear rather than this method.
+    // glClear rather than this method. Otherwise, the background takes a single draw for a solid
+    // color, and one per ancestor of the covering tiles for a pattern.
 
     const Properties<>::PossiblyEvaluated properties;
     const BackgroundProgram::Binders paintAttributeData(properties, 0);
@@ -114,17 +127,27 @@ void RenderBackgroundLayer::render(PaintParameters& parameters) {
         if (!imagePosA || !imagePosB)
             return;
 
+        // The pattern is aligned to the tiles of the integer zoom, but the same pattern
+        // coordinates come out of any of their ancestors. The tiles of the cover are thus merged
+        // into ancestors a few zoom levels up, which stay small enough for the pattern
+        // coordinates to keep their precision.
+        const uint8_t zoom = parameters.state.getIntegerZoom();
+        const uint8_t ancestorZoom = zoom > maxPatternZoomDifference ? zoom - maxPatternZoomDifference : 0;
+        std::set<UnwrappedTileID> ancestors;
+        for (const auto& tileID : util::tileCover(parameters.state, zoom)) {
+            ancestors.emplace(tileID.wrap, tileID.canonical.scaledTo(ancestorZoom));
+        }
+
         uint32_t i = 0;
-        for (const auto& tileID : util::tileCover(parameters.state, parameters.state.getIntegerZoom())) {
-            const UnwrappedTileID unwrappedTileID = tileID.toUnwrapped();
+        for (const auto& ancestor : ancestors) {
             draw(parameters.programs.getBackgroundLayerPrograms().backgroundPattern,
-                 BackgroundPatternProgram::layoutUniformValues(parameters.matrixForTile(unwrappedTileID),
+                 BackgroundPatternProgram::layoutUniformValues(parameters.matrixForTile(ancestor),
                                                                evaluated.get<BackgroundOpacity>(),
                                                                parameters.patternAtlas.getPixelSize(),
                                                                *imagePosA,
                                                                *imagePosB,
                                                                crossfade,
-                                                               unwrappedTileID,
+                                                               ancestor,
                                                                parameters.state),
                  BackgroundPatternProgram::TextureBindings{
                      textures::image::Value{parameters.patternAtlas.textureBinding()},
@@ -138,17 +161,18 @@ void RenderBackgroundLayer::render(PaintParameters& parameters) {
         if (parameters.pass != backgroundRenderPass) {
             return;
         }
-        uint32_t i = 0;
-        for (const auto& tileID : util::tileCover(parameters.state, parameters.state.getIntegerZoom())) {
-            draw(parameters.programs.getBackgroundLayerPrograms().background,
-                 BackgroundProgram::LayoutUniformValues{
-                     uniforms::matrix::Value(parameters.matrixForTile(tileID.toUnwrapped())),
-                     uniforms::color::Value(evaluated.get<BackgroundColor>()),
-                     uniforms::opacity::Value(evaluated.get<BackgroundOpacity>()),
-                 },
-                 BackgroundProgram::TextureBindings{},
-                 i++);
-        }
+        // A solid color doesn't depend on the position on the map, so a single quad spanning
+        // the whole viewport covers it, the same way as the glClear of the bottommost layer.
+        mat4 viewportMatrix;
+        matrix::ortho(viewportMatrix, 0, util::EXTENT, 0, util::EXTENT, -1, 1);
+        draw(parameters.programs.getBackgroundLayerPrograms().background,
+             BackgroundProgram::LayoutUniformValues{
+                 uniforms::matrix::Value(viewportMatrix),
+                 uniforms::color::Value(evaluated.get<BackgroundColor>()),
+                 uniforms::opacity::Value(evaluated.get<BackgroundOpacity>()),
+             },
+             BackgroundProgram::TextureBindings{},
+             0);
     }
 }
 
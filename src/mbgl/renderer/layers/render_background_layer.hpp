@@ -16,6 +16,7 @@ private:
     void transition(const TransitionParameters&) override;
     void evaluate(const PropertyEvaluationParameters&) override;
     bool hasTransition() const override;
+    bool isZoomConstant() const override;
     bool hasCrossfade() const override;
     optional<Color> getSolidBackground() const override;
     void render(PaintParameters&) override;
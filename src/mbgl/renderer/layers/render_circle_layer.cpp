@@ -71,6 +71,10 @@ bool RenderCircleLayer::hasTransition() const {
     return unevaluated.hasTransition();
 }
 
+bool RenderCircleLayer::isZoomConstant() const {
+    return unevaluated.isZoomConstant();
+}
+
 bool RenderCircleLayer::hasCrossfade() const {
     return false;
 }
@@ -85,7 +89,7 @@ void RenderCircleLayer::render(PaintParameters& parameters) {
         const auto& evaluated = getEvaluated<CircleLayerProperties>(data->layerProperties);
         const bool scaleWithMap = evaluated.template get<CirclePitchScale>() == CirclePitchScaleType::Map;
         const bool pitchWithMap = evaluated.template get<CirclePitchAlignment>() == AlignmentType::Map;
-        const auto& paintPropertyBinders = circleBucket.paintPropertyBinders.at(getID());
+        const auto& paintPropertyBinders = circleBucket.paintPropertyBinders.at(baseImpl->internedID);
 
         auto& programInstance = parameters.programs.getCircleLayerPrograms().circle;
         using LayoutUniformValues = CircleProgram::LayoutUniformValues;
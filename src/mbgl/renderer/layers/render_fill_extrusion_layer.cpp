@@ -14,9 +14,12 @@
 #include <mbgl/style/layers/fill_extrusion_layer_impl.hpp>
 #include <mbgl/tile/geometry_tile.hpp>
 #include <mbgl/tile/tile.hpp>
+#include <mbgl/util/constants.hpp>
 #include <mbgl/util/intersection_tests.hpp>
 #include <mbgl/util/math.hpp>
 
+#include <algorithm>
+
 namespace mbgl {
 
 using namespace style;
@@ -28,6 +31,13 @@ inline const FillExtrusionLayer::Impl& impl_cast(const Immutable<style::Layer::I
     return static_cast<const FillExtrusionLayer::Impl&>(*impl);
 }
 
+// The distance of the center of the tile from the camera, along the view direction.
+double viewDepth(const RenderTile& tile) {
+    const double center = util::EXTENT / 2.0;
+    const mat4& m = tile.matrix;
+    return m[3] * center + m[7] * center + m[15];
+}
+
 } // namespace
 
 RenderFillExtrusionLayer::RenderFillExtrusionLayer(Immutable<style::FillExtrusionLayer::Impl> _impl)
@@ -57,6 +67,10 @@ bool RenderFillExtrusionLayer::hasTransition() const {
     return unevaluated.hasTransition();
 }
 
+bool RenderFillExtrusionLayer::isZoomConstant() const {
+    return unevaluated.isZoomConstant();
+}
+
 bool RenderFillExtrusionLayer::hasCrossfade() const {
     return getCrossfade<FillExtrusionLayerProperties>(evaluatedProperties).t != 1;
 }
@@ -65,6 +79,30 @@ bool RenderFillExtrusionLayer::is3D() const {
     return true;
 }
 
+void RenderFillExtrusionLayer::prepare(const LayerPrepareParameters& params) {
+    RenderLayer::prepare(params);
+    if (!renderTiles || renderTiles->size() < 2) {
+        return;
+    }
+
+    // Tiles are drawn from the closest to the farthest one, so that at a pitch the buildings in
+    // front fill the depth buffer first and the fragments hidden behind them fail the depth test
+    // before being shaded and blended.
+    std::vector<std::pair<double, std::reference_wrapper<const RenderTile>>> tiles;
+    tiles.reserve(renderTiles->size());
+    for (const RenderTile& tile : *renderTiles) {
+        tiles.emplace_back(viewDepth(tile), tile);
+    }
+    std::stable_sort(tiles.begin(), tiles.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    auto sorted = std::make_shared<std::vector<std::reference_wrapper<const RenderTile>>>();
+    sorted->reserve(tiles.size());
+    for (const auto& tile : tiles) {
+        sorted->push_back(tile.second);
+    }
+    renderTiles = std::move(sorted);
+}
+
 void RenderFillExtrusionLayer::render(PaintParameters& parameters) {
     assert(renderTiles);
     if (parameters.pass != RenderPass::Translucent) {
@@ -90,7 +128,7 @@ void RenderFillExtrusionLayer::render(PaintParameters& parameters) {
                     const optional<ImagePosition>& patternPositionB,
                     const auto& textureBindings,
                     const std::string& uniqueName) {
-        const auto& paintPropertyBinders = tileBucket.paintPropertyBinders.at(getID());
+        const auto& paintPropertyBinders = tileBucket.paintPropertyBinders.at(baseImpl->internedID);
         paintPropertyBinders.setPatternParameters(patternPositionA, patternPositionB, crossfade_);
 
         const auto allUniformValues = programInstance.computeAllUniformValues(
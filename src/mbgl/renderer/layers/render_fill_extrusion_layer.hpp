@@ -16,8 +16,10 @@ private:
     void transition(const TransitionParameters&) override;
     void evaluate(const PropertyEvaluationParameters&) override;
     bool hasTransition() const override;
+    bool isZoomConstant() const override;
     bool hasCrossfade() const override;
     bool is3D() const override;
+    void prepare(const LayerPrepareParameters&) override;
     void render(PaintParameters&) override;
 
     bool queryIntersectsFeature(const GeometryCoordinates&,
@@ -18,6 +18,8 @@
 #include <mbgl/util/intersection_tests.hpp>
 #include <mbgl/util/math.hpp>
 
+#include <set>
+
 namespace mbgl {
 
 using namespace style;
@@ -29,6 +31,28 @@ inline const FillLayer::Impl& impl_cast(const Immutable<style::Layer::Impl>& imp
     return static_cast<const FillLayer::Impl&>(*impl);
 }
 
+// Whether a tile of the list covers another one, which happens while tiles of another zoom level
+// stand in for tiles that aren't loaded yet.
+bool renderTilesOverlap(const std::vector<std::reference_wrapper<const RenderTile>>& tiles) {
+    if (tiles.empty()) {
+        return false;
+    }
+    std::set<UnwrappedTileID> ids;
+    uint8_t minZoom = tiles.front().get().id.canonical.z;
+    for (const RenderTile& tile : tiles) {
+        ids.insert(tile.id);
+        minZoom = std::min(minZoom, tile.id.canonical.z);
+    }
+    for (const RenderTile& tile : tiles) {
+        for (uint8_t z = minZoom; z < tile.id.canonical.z; ++z) {
+            if (ids.count(UnwrappedTileID(tile.id.wrap, tile.id.canonical.scaledTo(z)))) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
 } // namespace
 
 RenderFillLayer::RenderFillLayer(Immutable<style::FillLayer::Impl> _impl)
@@ -68,14 +92,35 @@ bool RenderFillLayer::hasTransition() const {
     return unevaluated.hasTransition();
 }
 
+bool RenderFillLayer::isZoomConstant() const {
+    return unevaluated.isZoomConstant();
+}
+
 bool RenderFillLayer::hasCrossfade() const {
     return getCrossfade<FillLayerProperties>(evaluatedProperties).t != 1;
 }
 
+void RenderFillLayer::prepare(const LayerPrepareParameters& params) {
+    RenderLayer::prepare(params);
+    tilesOverlap = renderTilesOverlap(*renderTiles);
+}
+
 void RenderFillLayer::render(PaintParameters& parameters) {
     assert(renderTiles);
-    if (unevaluated.get<FillPattern>().isUndefined()) {
+
+    // Polygons are clipped to their tile with the stencil buffer, so that neither the parts of
+    // them past the tile boundary nor the tiles underneath a tile show through. Neither applies
+    // to a tile whose polygons stay within it, as long as the tiles don't overlap, so the clipping
+    // masks are only drawn once a tile needs them.
+    auto stencilModeFor = [&](const RenderTile& tile, const FillBucket& bucket, const auto& evaluated) {
+        if (!tilesOverlap && !bucket.exceedsTile && evaluated.template get<FillTranslate>() == std::array<float, 2>{{0, 0}}) {
+            return gfx::StencilMode::disabled();
+        }
         parameters.renderTileClippingMasks(renderTiles);
+        return parameters.stencilModeForClipping(tile.id);
+    };
+
+    if (unevaluated.get<FillPattern>().isUndefined()) {
         for (const RenderTile& tile : *renderTiles) {
             const LayerRenderData* renderData = getRenderDataForPass(tile, parameters.pass);
             if (!renderData) {
@@ -90,7 +135,7 @@ void RenderFillLayer::render(PaintParameters& parameters) {
                              const auto& indexBuffer,
                              const auto& segments,
                              auto&& textureBindings) {
-                const auto& paintPropertyBinders = bucket.paintPropertyBinders.at(getID());
+                const auto& paintPropertyBinders = bucket.paintPropertyBinders.at(baseImpl->internedID);
 
                 const auto allUniformValues = programInstance.computeAllUniformValues(
                     FillProgram::LayoutUniformValues {
@@ -117,7 +162,7 @@ void RenderFillLayer::render(PaintParameters& parameters) {
                                      *parameters.renderPass,
                                      drawMode,
                                      depthMode,
-                                     parameters.stencilModeForClipping(tile.id),
+                                     stencilModeFor(tile, bucket, evaluated),
                                      parameters.colorModeForRenderPass(),
                                      gfx::CullFaceMode::disabled(),
                                      indexBuffer,
@@ -158,8 +203,6 @@ void RenderFillLayer::render(PaintParameters& parameters) {
             return;
         }
 
-        parameters.renderTileClippingMasks(renderTiles);
-
         for (const RenderTile& tile : *renderTiles) {
             const LayerRenderData* renderData = getRenderDataForPass(tile, parameters.pass);
             if (!renderData) {
@@ -179,7 +222,7 @@ void RenderFillLayer::render(PaintParameters& parameters) {
                              const auto& indexBuffer,
                              const auto& segments,
                              auto&& textureBindings) {
-                const auto& paintPropertyBinders = bucket.paintPropertyBinders.at(getID());
+                const auto& paintPropertyBinders = bucket.paintPropertyBinders.at(baseImpl->internedID);
                 paintPropertyBinders.setPatternParameters(patternPosA, patternPosB, crossfade);
 
                 const auto allUniformValues = programInstance.computeAllUniformValues(
@@ -210,7 +253,7 @@ void RenderFillLayer::render(PaintParameters& parameters) {
                                      *parameters.renderPass,
                                      drawMode,
                                      depthMode,
-                                     parameters.stencilModeForClipping(tile.id),
+                                     stencilModeFor(tile, bucket, evaluated),
                                      parameters.colorModeForRenderPass(),
                                      gfx::CullFaceMode::disabled(),
                                      indexBuffer,
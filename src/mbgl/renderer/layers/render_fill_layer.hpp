@@ -18,7 +18,9 @@ private:
     void transition(const TransitionParameters&) override;
     void evaluate(const PropertyEvaluationParameters&) override;
     bool hasTransition() const override;
+    bool isZoomConstant() const override;
     bool hasCrossfade() const override;
+    void prepare(const LayerPrepareParameters&) override;
     void render(PaintParameters&) override;
 
     bool queryIntersectsFeature(const GeometryCoordinates&,
@@ -31,6 +33,7 @@ private:
 
     // Paint properties
     style::FillPaintProperties::Unevaluated unevaluated;
+    bool tilesOverlap = false;
 };
 
 } // namespace mbgl
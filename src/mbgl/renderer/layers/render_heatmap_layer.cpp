@@ -11,6 +11,7 @@
 #include <mbgl/gfx/cull_face_mode.hpp>
 #include <mbgl/gfx/render_pass.hpp>
 #include <mbgl/gfx/context.hpp>
+#include <mbgl/platform/settings.hpp>
 #include <mbgl/util/math.hpp>
 #include <mbgl/util/intersection_tests.hpp>
 
@@ -25,12 +26,21 @@ inline const HeatmapLayer::Impl& impl_cast(const Immutable<Layer::Impl>& impl) {
     return static_cast<const HeatmapLayer::Impl&>(*impl);
 }
 
+uint32_t densityDownsampling() {
+    auto value = platform::Settings::getInstance().get(platform::EXPERIMENTAL_HEATMAP_DOWNSAMPLING);
+    if (auto* factor = value.getUint()) {
+        if (*factor > 0) return static_cast<uint32_t>(*factor);
+    }
+    return 4;
+}
+
 } // namespace
 
 RenderHeatmapLayer::RenderHeatmapLayer(Immutable<HeatmapLayer::Impl> _impl)
     : RenderLayer(makeMutable<HeatmapLayerProperties>(std::move(_impl))),
       unevaluated(impl_cast(baseImpl).paint.untransitioned()),
-      colorRamp({256, 1}) {}
+      colorRamp({256, 1}),
+      downsampling(densityDownsampling()) {}
 
 RenderHeatmapLayer::~RenderHeatmapLayer() = default;
 
@@ -55,10 +65,25 @@ bool RenderHeatmapLayer::hasTransition() const {
     return unevaluated.hasTransition();
 }
 
+bool RenderHeatmapLayer::isZoomConstant() const {
+    return unevaluated.isZoomConstant();
+}
+
 bool RenderHeatmapLayer::hasCrossfade() const {
     return false;
 }
 
+void RenderHeatmapLayer::prepare(const LayerPrepareParameters& params) {
+    RenderLayer::prepare(params);
+    // Buckets that are uploaded again, e.g. after a feature state change, have new weights or radii.
+    for (const RenderTile& tile : *renderTiles) {
+        const LayerRenderData* renderData = tile.getLayerRenderData(*baseImpl);
+        if (renderData && renderData->bucket && renderData->bucket->needsUpload()) {
+            densityChanged = true;
+        }
+    }
+}
+
 void RenderHeatmapLayer::upload(gfx::UploadPass& uploadPass) {
     if (!colorRampTexture) {
         colorRampTexture =
@@ -74,10 +99,26 @@ void RenderHeatmapLayer::render(PaintParameters& parameters) {
 
     if (parameters.pass == RenderPass::Pass3D) {
         const auto& viewportSize = parameters.staticData.backendSize;
-        const auto size = Size{viewportSize.width / 4, viewportSize.height / 4};
+        const auto size = Size{std::max(viewportSize.width / downsampling, 1u),
+                               std::max(viewportSize.height / downsampling, 1u)};
 
         assert(colorRampTexture);
 
+        // The density only depends on the buckets, their paint properties and the camera, so the
+        // texture of the previous frame is reused as long as none of them changed.
+        std::vector<DensityTile> tiles;
+        tiles.reserve(renderTiles->size());
+        for (const RenderTile& tile : *renderTiles) {
+            if (const LayerRenderData* renderData = getRenderDataForPass(tile, parameters.pass)) {
+                tiles.push_back({renderData->bucket.get(), renderData->layerProperties.get(), tile.matrix});
+            }
+        }
+        if (renderTexture && renderTexture->getSize() == size && !densityChanged && tiles == densityTiles) {
+            return;
+        }
+        densityTiles = std::move(tiles);
+        densityChanged = false;
+
         if (!renderTexture || renderTexture->getSize() != size) {
             renderTexture.reset();
             if (parameters.context.supportsHalfFloatTextures) {
@@ -108,7 +149,7 @@ void RenderHeatmapLayer::render(PaintParameters& parameters) {
 
             const auto extrudeScale = tile.id.pixelsToTileUnits(1, parameters.state.getZoom());
 
-            const auto& paintPropertyBinders = bucket.paintPropertyBinders.at(getID());
+            const auto& paintPropertyBinders = bucket.paintPropertyBinders.at(baseImpl->internedID);
 
             auto& programInstance = parameters.programs.getHeatmapLayerPrograms().heatmap;
 
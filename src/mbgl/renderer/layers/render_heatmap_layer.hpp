@@ -8,6 +8,8 @@
 #include <mbgl/style/layers/heatmap_layer_properties.hpp>
 #include <mbgl/util/optional.hpp>
 
+#include <vector>
+
 namespace mbgl {
 
 class RenderHeatmapLayer final : public RenderLayer {
@@ -19,7 +21,9 @@ private:
     void transition(const TransitionParameters&) override;
     void evaluate(const PropertyEvaluationParameters&) override;
     bool hasTransition() const override;
+    bool isZoomConstant() const override;
     bool hasCrossfade() const override;
+    void prepare(const LayerPrepareParameters&) override;
     void upload(gfx::UploadPass&) override;
     void render(PaintParameters&) override;
 
@@ -32,9 +36,24 @@ private:
                                 const FeatureState&) const override;
     void updateColorRamp();
 
+    // What the density texture was drawn from, per tile. The texture is only drawn again once any
+    // of it changes.
+    struct DensityTile {
+        const Bucket* bucket;
+        const style::LayerProperties* properties;
+        mat4 matrix;
+
+        bool operator==(const DensityTile& other) const {
+            return bucket == other.bucket && properties == other.properties && matrix == other.matrix;
+        }
+    };
+
     // Paint properties
     style::HeatmapPaintProperties::Unevaluated unevaluated;
     PremultipliedImage colorRamp;
+    const uint32_t downsampling;
+    std::vector<DensityTile> densityTiles;
+    bool densityChanged = true;
     std::unique_ptr<gfx::OffscreenTexture> renderTexture;
     optional<gfx::Texture> colorRampTexture;
     SegmentVector<HeatmapTextureAttributes> segments;
@@ -65,6 +65,10 @@ bool RenderHillshadeLayer::hasTransition() const {
     return unevaluated.hasTransition();
 }
 
+bool RenderHillshadeLayer::isZoomConstant() const {
+    return unevaluated.isZoomConstant();
+}
+
 bool RenderHillshadeLayer::hasCrossfade() const {
     return false;
 }
@@ -140,11 +144,13 @@ void RenderHillshadeLayer::render(PaintParameters& parameters) {
             assert(bucket.dem);
             const uint16_t stride = bucket.getDEMData().stride;
             const uint16_t tilesize = bucket.getDEMData().dim;
-            auto view = parameters.context.createOffscreenTexture({tilesize, tilesize},
-                                                                  gfx::TextureChannelDataType::UnsignedByte);
+            if (!bucket.texture || bucket.texture->getSize() != Size{tilesize, tilesize}) {
+                bucket.texture = parameters.context.createOffscreenTexture({tilesize, tilesize},
+                                                                           gfx::TextureChannelDataType::UnsignedByte);
+            }
 
             auto renderPass = parameters.encoder->createRenderPass(
-                "hillshade prepare", { *view, Color{ 0.0f, 0.0f, 0.0f, 0.0f }, {}, {} });
+                "hillshade prepare", { *bucket.texture, Color{ 0.0f, 0.0f, 0.0f, 0.0f }, {}, {} });
 
             const Properties<>::PossiblyEvaluated properties;
             const HillshadePrepareProgram::Binders paintAttributeData{ properties, 0 };
@@ -185,7 +191,6 @@ void RenderHillshadeLayer::render(PaintParameters& parameters) {
                                      textures::image::Value{bucket.dem->getResource()},
                                  },
                                  "prepare");
-            bucket.texture = std::move(view->getTexture());
             bucket.setPrepared(true);
         } else if (parameters.pass == RenderPass::Translucent) {
             assert(bucket.texture);
@@ -198,7 +203,7 @@ void RenderHillshadeLayer::render(PaintParameters& parameters) {
                      bucket.segments,
                      tile.id,
                      HillshadeProgram::TextureBindings{
-                         textures::image::Value{ bucket.texture->getResource(), gfx::TextureFilterType::Linear },
+                         textures::image::Value{ bucket.texture->getTexture().getResource(), gfx::TextureFilterType::Linear },
                      });
             } else {
                 // Draw the full tile.
@@ -212,7 +217,7 @@ void RenderHillshadeLayer::render(PaintParameters& parameters) {
                      bucket.segments,
                      tile.id,
                      HillshadeProgram::TextureBindings{
-                         textures::image::Value{bucket.texture->getResource(), gfx::TextureFilterType::Linear},
+                         textures::image::Value{bucket.texture->getTexture().getResource(), gfx::TextureFilterType::Linear},
                      });
             }
         }
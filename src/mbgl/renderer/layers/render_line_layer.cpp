@@ -61,6 +61,10 @@ bool RenderLineLayer::hasTransition() const {
     return unevaluated.hasTransition();
 }
 
+bool RenderLineLayer::isZoomConstant() const {
+    return unevaluated.isZoomConstant();
+}
+
 bool RenderLineLayer::hasCrossfade() const {
     return getCrossfade<LineLayerProperties>(evaluatedProperties).t != 1;
 }
@@ -78,8 +82,8 @@ void RenderLineLayer::prepare(const LayerPrepareParameters& params) {
         const LinePatternCap cap = bucket.layout.get<LineCap>() == LineCapType::Round
             ? LinePatternCap::Round : LinePatternCap::Square;
         // Ensures that the dash data gets added to the atlas.
-        params.lineAtlas.getDashPatternTexture(
-            evaluated.get<LineDasharray>().from, evaluated.get<LineDasharray>().to, cap);
+        params.lineAtlas.getDashPosition(evaluated.get<LineDasharray>().from, cap);
+        params.lineAtlas.getDashPosition(evaluated.get<LineDasharray>().to, cap);
     }
 }
 
@@ -110,7 +114,7 @@ void RenderLineLayer::render(PaintParameters& parameters) {
                         auto&& uniformValues,
                         const optional<ImagePosition>& patternPositionA,
                         const optional<ImagePosition>& patternPositionB, auto&& textureBindings) {
-            const auto& paintPropertyBinders = bucket.paintPropertyBinders.at(getID());
+            const auto& paintPropertyBinders = bucket.paintPropertyBinders.at(baseImpl->internedID);
 
             paintPropertyBinders.setPatternParameters(patternPositionA, patternPositionB, crossfade);
 
@@ -145,8 +149,9 @@ void RenderLineLayer::render(PaintParameters& parameters) {
         if (!evaluated.get<LineDasharray>().from.empty()) {
             const LinePatternCap cap =
                 bucket.layout.get<LineCap>() == LineCapType::Round ? LinePatternCap::Round : LinePatternCap::Square;
-            const auto& dashPatternTexture = parameters.lineAtlas.getDashPatternTexture(
-                evaluated.get<LineDasharray>().from, evaluated.get<LineDasharray>().to, cap);
+            LineAtlas& lineAtlas = parameters.lineAtlas;
+            const LinePatternPos posA = lineAtlas.getDashPosition(evaluated.get<LineDasharray>().from, cap);
+            const LinePatternPos posB = lineAtlas.getDashPosition(evaluated.get<LineDasharray>().to, cap);
 
             draw(parameters.programs.getLineLayerPrograms().lineSDF,
                  LineSDFProgram::layoutUniformValues(evaluated,
@@ -154,14 +159,14 @@ void RenderLineLayer::render(PaintParameters& parameters) {
                                                      tile,
                                                      parameters.state,
                                                      parameters.pixelsToGLUnits,
-                                                     dashPatternTexture.getFrom(),
-                                                     dashPatternTexture.getTo(),
+                                                     posA,
+                                                     posB,
                                                      crossfade,
-                                                     dashPatternTexture.getSize().width),
+                                                     lineAtlas.getSize().width),
                  {},
                  {},
                  LineSDFProgram::TextureBindings{
-                     dashPatternTexture.textureBinding(),
+                     lineAtlas.textureBinding(),
                  });
 
         } else if (!unevaluated.get<LinePattern>().isUndefined()) {
@@ -233,6 +233,7 @@ void main() {
             if (!bufferId) return;
             MBGL_CHECK_ERROR(glDeleteBuffers(1, &bufferId));
             bufferId = 0;
+            size = elements = 0;
         }
         void initialize() {
             if (!bufferId) MBGL_CHECK_ERROR(glGenBuffers(1, &bufferId));
@@ -242,9 +243,14 @@ void main() {
             MBGL_CHECK_ERROR(glBindBuffer(target, bufferId));
         }
         void detach(const GLenum target = GL_ARRAY_BUFFER) { MBGL_CHECK_ERROR(glBindBuffer(target, 0)); }
+        // Arrays keep their size, so the storage of the buffer is only allocated once.
         template <typename T, std::size_t N>
         void upload(const std::array<T, N>& data) {
             bind();
+            if (size == N * sizeof(T)) {
+                MBGL_CHECK_ERROR(glBufferSubData(GL_ARRAY_BUFFER, 0, N * sizeof(T), data.data()));
+                return;
+            }
             MBGL_CHECK_ERROR(glBufferData(GL_ARRAY_BUFFER, N * sizeof(T), data.data(), GL_STATIC_DRAW));
             size = static_cast<unsigned int>(N * sizeof(T));
             elements = N;
@@ -275,7 +281,7 @@ public:
         */
         void assign(const Immutable<style::Image::Impl>* img) {
             imageDirty = true;
-            image = (img) ? &(img->get()->image) : nullptr;
+            image = (img) ? &(img->get()->getImage()) : nullptr;
             width = height = 0;
             pixelRatio = 1.0f;
             if (image) {
@@ -378,6 +384,7 @@ public:
         drawShadow();
         drawPuck();
         drawHat();
+        puckGeometryDirty = false;
     }
 
     void release() {
@@ -408,6 +415,8 @@ public:
         bearingChanged |= setTextureFromImageID(params.puckImagePath, texPuck, params);
         bearingChanged |= setTextureFromImageID(params.puckShadowImagePath, texShadow, params);
         bearingChanged |= setTextureFromImageID(params.puckHatImagePath, texPuckHat, params);
+        // The geometry is relative to the puck position, so moving the puck alone only changes the matrices.
+        dirtyFeature |= positionChanged || bearingChanged;
 
         projectionCircle = params.projectionMatrix;
         const Point<double> positionMercator = project(params.puckPosition, *params.state);
@@ -428,7 +437,6 @@ public:
             }
         }
         oldParams = params;
-        dirtyFeature = true;
     }
 
     void updateFeature() {
@@ -485,6 +493,7 @@ protected:
             circle[i] = vec2(project(LatLng(poc.y, poc.x), s) - center);
         }
         radiusChanged = false;
+        circleDirty = true;
     }
 
     // Size in "map pixels" for a screen pixel
@@ -599,6 +608,7 @@ protected:
             hatGeometry[i] =
                 vec2(hatOffset + (verticalShift * (tilt * params.puckLayersDisplacement * horizontalScaleFactor)));
         }
+        puckGeometryDirty = true;
     }
 
     void drawRadius(const mbgl::LocationIndicatorRenderParameters& params) {
@@ -610,7 +620,11 @@ protected:
         mbgl::gl::bindUniform(simpleShader.u_color, params.errorRadiusColor);
         mbgl::gl::bindUniform(simpleShader.u_matrix, projectionCircle);
 
-        circleBuffer.upload(circle);
+        circleBuffer.bind();
+        if (circleDirty) {
+            circleBuffer.upload(circle);
+            circleDirty = false;
+        }
         MBGL_CHECK_ERROR(glEnableVertexAttribArray(simpleShader.a_pos));
         MBGL_CHECK_ERROR(glVertexAttribPointer(simpleShader.a_pos, 2, GL_FLOAT, GL_FALSE, 0, nullptr));
 
@@ -633,7 +647,7 @@ protected:
         mbgl::gl::bindUniform(texturedShader.u_matrix, projectionPuck);
 
         buf.bind();
-        buf.upload(data);
+        if (puckGeometryDirty) buf.upload(data);
         MBGL_CHECK_ERROR(glEnableVertexAttribArray(texturedShader.a_pos));
         MBGL_CHECK_ERROR(glVertexAttribPointer(texturedShader.a_pos, 2, GL_FLOAT, GL_FALSE, 0, nullptr));
 
@@ -677,7 +691,7 @@ protected:
             texture = tx;
         } else {
             const Immutable<style::Image::Impl>* sharedImage = params.imageManager->getSharedImage(imagePath);
-            const mbgl::PremultipliedImage* img = (sharedImage) ? &sharedImage->get()->image : nullptr;
+            const mbgl::PremultipliedImage* img = (sharedImage) ? &sharedImage->get()->getImage() : nullptr;
             std::shared_ptr<Texture>& tex = textures.at(imagePath);
             if (tex->image != img) { // image for the ID might have changed.
                 tex->assign(sharedImage);
@@ -717,6 +731,9 @@ protected:
     mbgl::LocationIndicatorRenderParameters oldParams;
     bool initialized = false;
     bool dirtyFeature = true;
+    // Whether the vertex buffers are out of date.
+    bool circleDirty = true;
+    bool puckGeometryDirty = true;
 
 public:
     mbgl::LocationIndicatorRenderParameters parameters;
@@ -788,6 +805,10 @@ void RenderLocationIndicatorLayer::evaluate(const PropertyEvaluationParameters&
 bool RenderLocationIndicatorLayer::hasTransition() const {
     return unevaluated.hasTransition();
 }
+
+bool RenderLocationIndicatorLayer::isZoomConstant() const {
+    return unevaluated.isZoomConstant();
+}
 bool RenderLocationIndicatorLayer::hasCrossfade() const {
     return false;
 }
@@ -46,6 +46,10 @@ bool RenderRasterLayer::hasTransition() const {
     return unevaluated.hasTransition();
 }
 
+bool RenderRasterLayer::isZoomConstant() const {
+    return unevaluated.isZoomConstant();
+}
+
 bool RenderRasterLayer::hasCrossfade() const {
     return false;
 }
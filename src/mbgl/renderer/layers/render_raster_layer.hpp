@@ -17,6 +17,7 @@ private:
     void transition(const TransitionParameters&) override;
     void evaluate(const PropertyEvaluationParameters&) override;
     bool hasTransition() const override;
+    bool isZoomConstant() const override;
     bool hasCrossfade() const override;
     void prepare(const LayerPrepareParameters&) override;
     void render(PaintParameters&) override;
@@ -336,6 +336,10 @@ bool RenderSymbolLayer::hasTransition() const {
     return unevaluated.hasTransition();
 }
 
+bool RenderSymbolLayer::isZoomConstant() const {
+    return unevaluated.isZoomConstant();
+}
+
 bool RenderSymbolLayer::hasCrossfade() const {
     return false;
 }
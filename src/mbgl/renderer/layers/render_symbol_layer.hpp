@@ -70,6 +70,7 @@ private:
     void transition(const TransitionParameters&) override;
     void evaluate(const PropertyEvaluationParameters&) override;
     bool hasTransition() const override;
+    bool isZoomConstant() const override;
     bool hasCrossfade() const override;
     void render(PaintParameters&) override;
     void prepare(const LayerPrepareParameters&) override;
@@ -91,6 +91,11 @@ void PaintParameters::clearStencil() {
     context.clearStencilBuffer(0b00000000);
 }
 
+void PaintParameters::resetTileClippingMasks() {
+    nextStencilID = 1;
+    tileClippingMaskIDs.clear();
+}
+
 namespace {
 
 // Detects a difference in keys of renderTiles and tileClippingMaskIDs
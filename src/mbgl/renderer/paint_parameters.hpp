@@ -91,6 +91,9 @@ public:
     void renderTileClippingMasks(const RenderTiles&);
     gfx::StencilMode stencilModeForClipping(const UnwrappedTileID&) const;
     gfx::StencilMode stencilModeFor3D();
+    // Forgets the clipping masks of the current render pass. Call when switching to a render pass
+    // that starts with a cleared stencil buffer.
+    void resetTileClippingMasks();
 
 private:
     void clearStencil();
@@ -15,7 +15,10 @@
 #include <mbgl/util/indexed_tuple.hpp>
 #include <mbgl/layout/pattern_layout.hpp>
 
+#include <algorithm>
 #include <bitset>
+#include <unordered_map>
+#include <vector>
 
 namespace mbgl {
 
@@ -26,7 +29,60 @@ struct FeatureVertexRange {
     std::size_t end;
 };
 
-using FeatureVertexRangeMap = std::map<std::string, std::vector<FeatureVertexRange>>;
+using FeatureVertexRangeMap = std::unordered_map<std::string, std::vector<FeatureVertexRange>>;
+
+// Calls `update` with the vertex ranges and the new state of the features whose state changed. The
+// smaller of the two maps is iterated and looked up in the other: a state update can cover many
+// more features than a tile holds, and the other way around.
+template <class Fn>
+void forEachFeatureStateChange(const FeatureStates& states, const FeatureVertexRangeMap& featureMap, Fn&& update) {
+    if (states.size() <= featureMap.size()) {
+        for (const auto& state : states) {
+            const auto positions = featureMap.find(state.first);
+            if (positions == featureMap.end()) continue;
+            for (const auto& pos : positions->second) {
+                update(pos, state.second);
+            }
+        }
+    } else {
+        for (const auto& positions : featureMap) {
+            const auto state = states.find(positions.first);
+            if (state == states.end()) continue;
+            for (const auto& pos : positions.second) {
+                update(pos, state->second);
+            }
+        }
+    }
+}
+
+// Uploads the vertex vector of a binder. Once its buffer exists, only the ranges that changed
+// since the previous upload are sent, so that feature state updates don't upload whole buffers.
+template <class Vertex>
+void uploadVertexVector(gfx::UploadPass& uploadPass,
+                        gfx::VertexVector<Vertex>& vertexVector,
+                        optional<gfx::VertexBuffer<Vertex>>& vertexBuffer,
+                        std::vector<FeatureVertexRange>& dirtyRanges,
+                        const gfx::BufferUsageType usage = gfx::BufferUsageType::StaticDraw) {
+    if (!vertexBuffer || vertexBuffer->elements != vertexVector.elements()) {
+        vertexBuffer = uploadPass.createVertexBuffer(std::move(vertexVector), usage);
+    } else if (!dirtyRanges.empty()) {
+        std::sort(dirtyRanges.begin(), dirtyRanges.end(), [](const auto& a, const auto& b) {
+            return a.start < b.start;
+        });
+        // Adjacent and overlapping ranges are sent in one go.
+        std::size_t start = dirtyRanges.front().start;
+        std::size_t end = dirtyRanges.front().end;
+        for (const auto& range : dirtyRanges) {
+            if (range.start > end) {
+                uploadPass.updateVertexBuffer(*vertexBuffer, vertexVector, start, end);
+                start = range.start;
+            }
+            end = std::max(end, range.end);
+        }
+        uploadPass.updateVertexBuffer(*vertexBuffer, vertexVector, start, end);
+    }
+    dirtyRanges.clear();
+}
 
 /*
    ZoomInterpolatedAttribute<Attr> is a 'compound' attribute, representing two values of the
@@ -113,6 +169,17 @@ public:
                                       const CanonicalTileID& canonical,
                                       const style::expression::Value&) = 0;
 
+    // Populates the vertex vector for a batch of features, as populateVertexVector() does for each
+    // of them in turn with the end of its range as the length.
+    virtual void populateVertexVectors(const std::vector<const GeometryTileFeature*>& features,
+                                       const std::vector<FeatureVertexRange>& ranges,
+                                       const CanonicalTileID& canonical) {
+        assert(features.size() == ranges.size());
+        for (std::size_t i = 0; i < features.size(); ++i) {
+            populateVertexVector(*features[i], ranges[i].end, ranges[i].featureIndex, {}, {}, canonical, {});
+        }
+    }
+
     virtual void updateVertexVectors(const FeatureStates&, const GeometryTileLayer&, const ImagePositions&) {}
 
     virtual void updateVertexVector(std::size_t, std::size_t, const GeometryTileFeature&, const FeatureState&) = 0;
@@ -229,33 +296,30 @@ public:
         auto evaluated = expression.evaluate(
             EvaluationContext(&feature).withFormattedSection(&formattedSection).withCanonicalTileID(&canonical),
             defaultValue);
-        this->statistics.add(evaluated);
-        auto value = attributeValue(evaluated);
-        auto elements = vertexVector.elements();
-        for (std::size_t i = elements; i < length; ++i) {
-            vertexVector.emplace_back(BaseVertex { value });
-        }
-        optional<std::string> idStr = featureIDtoString(feature.getID());
-        if (idStr) {
-            featureMap[*idStr].emplace_back(FeatureVertexRange{index, elements, length});
+        appendVertices(feature, length, index, evaluated);
+    }
+
+    void populateVertexVectors(const std::vector<const GeometryTileFeature*>& features,
+                               const std::vector<FeatureVertexRange>& ranges,
+                               const CanonicalTileID& canonical) override {
+        using style::expression::EvaluationContext;
+        assert(features.size() == ranges.size());
+        std::vector<T> evaluated;
+        expression.evaluate(EvaluationContext().withCanonicalTileID(&canonical), features, evaluated, defaultValue);
+        for (std::size_t i = 0; i < features.size(); ++i) {
+            appendVertices(*features[i], ranges[i].end, ranges[i].featureIndex, evaluated[i]);
         }
     }
 
     void updateVertexVectors(const FeatureStates& states, const GeometryTileLayer& layer,
                              const ImagePositions&) override {
-        for (const auto& it : states) {
-            const auto positions = featureMap.find(it.first);
-            if (positions == featureMap.end()) {
-                continue;
+        forEachFeatureStateChange(states, featureMap, [&](const FeatureVertexRange& pos, const FeatureState& state) {
+            std::unique_ptr<GeometryTileFeature> feature = layer.getFeature(pos.featureIndex);
+            if (feature) {
+                updateVertexVector(pos.start, pos.end, *feature, state);
+                dirtyRanges.push_back(pos);
             }
-
-            for (const auto& pos : positions->second) {
-                std::unique_ptr<GeometryTileFeature> feature = layer.getFeature(pos.featureIndex);
-                if (feature) {
-                    updateVertexVector(pos.start, pos.end, *feature, it.second);
-                }
-            }
-        }
+        });
     }
 
     void updateVertexVector(std::size_t start, std::size_t end, const GeometryTileFeature& feature,
@@ -271,7 +335,7 @@ public:
     }
 
     void upload(gfx::UploadPass& uploadPass) override {
-        vertexBuffer = uploadPass.createVertexBuffer(std::move(vertexVector));
+        uploadVertexVector(uploadPass, vertexVector, vertexBuffer, dirtyRanges);
     }
 
     std::tuple<optional<gfx::AttributeBinding>> attributeBinding(const PossiblyEvaluatedPropertyValue<T>& currentValue) const override {
@@ -298,11 +362,25 @@ public:
     }
 
 private:
+    void appendVertices(const GeometryTileFeature& feature, std::size_t length, std::size_t index, const T& evaluated) {
+        this->statistics.add(evaluated);
+        auto value = attributeValue(evaluated);
+        auto elements = vertexVector.elements();
+        if (length > elements) {
+            vertexVector.extend(length - elements, BaseVertex { value });
+        }
+        optional<std::string> idStr = featureIDtoString(feature.getID());
+        if (idStr) {
+            featureMap[*idStr].emplace_back(FeatureVertexRange{index, elements, length});
+        }
+    }
+
     style::PropertyExpression<T> expression;
     T defaultValue;
     gfx::VertexVector<BaseVertex> vertexVector;
     optional<gfx::VertexBuffer<BaseVertex>> vertexBuffer;
     FeatureVertexRangeMap featureMap;
+    std::vector<FeatureVertexRange> dirtyRanges;
 };
 
 template <class T, class A>
@@ -337,36 +415,34 @@ public:
                                     .withCanonicalTileID(&canonical),
                                 defaultValue),
         };
-        this->statistics.add(range.min);
-        this->statistics.add(range.max);
-        AttributeValue value = zoomInterpolatedAttributeValue(
-            attributeValue(range.min),
-            attributeValue(range.max));
-        auto elements = vertexVector.elements();
-        for (std::size_t i = elements; i < length; ++i) {
-            vertexVector.emplace_back(Vertex { value });
-        }
-        optional<std::string> idStr = featureIDtoString(feature.getID());
-        if (idStr) {
-            featureMap[*idStr].emplace_back(FeatureVertexRange{index, elements, length});
+        appendVertices(feature, length, index, range);
+    }
+
+    void populateVertexVectors(const std::vector<const GeometryTileFeature*>& features,
+                               const std::vector<FeatureVertexRange>& ranges,
+                               const CanonicalTileID& canonical) override {
+        using style::expression::EvaluationContext;
+        assert(features.size() == ranges.size());
+        std::vector<T> min;
+        std::vector<T> max;
+        expression.evaluate(
+            EvaluationContext(zoomRange.min).withCanonicalTileID(&canonical), features, min, defaultValue);
+        expression.evaluate(
+            EvaluationContext(zoomRange.max).withCanonicalTileID(&canonical), features, max, defaultValue);
+        for (std::size_t i = 0; i < features.size(); ++i) {
+            appendVertices(*features[i], ranges[i].end, ranges[i].featureIndex, Range<T>{min[i], max[i]});
         }
     }
 
     void updateVertexVectors(const FeatureStates& states, const GeometryTileLayer& layer,
                              const ImagePositions&) override {
-        for (const auto& it : states) {
-            const auto positions = featureMap.find(it.first);
-            if (positions == featureMap.end()) {
-                continue;
-            }
-
-            for (const auto& pos : positions->second) {
-                std::unique_ptr<GeometryTileFeature> feature = layer.getFeature(pos.featureIndex);
-                if (feature) {
-                    updateVertexVector(pos.start, pos.end, *feature, it.second);
-                }
+        forEachFeatureStateChange(states, featureMap, [&](const FeatureVertexRange& pos, const FeatureState& state) {
+            std::unique_ptr<GeometryTileFeature> feature = layer.getFeature(pos.featureIndex);
+            if (feature) {
+                updateVertexVector(pos.start, pos.end, *feature, state);
+                dirtyRanges.push_back(pos);
             }
-        }
+        });
     }
 
     void updateVertexVector(std::size_t start, std::size_t end, const GeometryTileFeature& feature,
@@ -386,7 +462,7 @@ public:
     }
 
     void upload(gfx::UploadPass& uploadPass) override {
-        vertexBuffer = uploadPass.createVertexBuffer(std::move(vertexVector));
+        uploadVertexVector(uploadPass, vertexVector, vertexBuffer, dirtyRanges);
     }
 
     std::tuple<optional<gfx::AttributeBinding>> attributeBinding(const PossiblyEvaluatedPropertyValue<T>& currentValue) const override {
@@ -416,12 +492,32 @@ public:
     }
 
 private:
+    void appendVertices(const GeometryTileFeature& feature,
+                        std::size_t length,
+                        std::size_t index,
+                        const Range<T>& range) {
+        this->statistics.add(range.min);
+        this->statistics.add(range.max);
+        AttributeValue value = zoomInterpolatedAttributeValue(
+            attributeValue(range.min),
+            attributeValue(range.max));
+        auto elements = vertexVector.elements();
+        if (length > elements) {
+            vertexVector.extend(length - elements, Vertex { value });
+        }
+        optional<std::string> idStr = featureIDtoString(feature.getID());
+        if (idStr) {
+            featureMap[*idStr].emplace_back(FeatureVertexRange{index, elements, length});
+        }
+    }
+
     style::PropertyExpression<T> expression;
     T defaultValue;
     Range<float> zoomRange;
     gfx::VertexVector<Vertex> vertexVector;
     optional<gfx::VertexBuffer<Vertex>> vertexBuffer;
     FeatureVertexRangeMap featureMap;
+    std::vector<FeatureVertexRange> dirtyRanges;
 };
 
 template <class T, class A1, class A2>
@@ -485,7 +581,8 @@ public:
     void updateVertexVector(std::size_t, std::size_t, const GeometryTileFeature&, const FeatureState&) override {}
 
     void upload(gfx::UploadPass& uploadPass) override {
-        if (!patternToVertexVector.empty()) {
+        // Pattern attributes don't depend on feature state, so they are only uploaded once.
+        if (!patternToVertexVector.empty() && !patternToVertexBuffer) {
             assert(!zoomInVertexVector.empty());
             assert(!zoomOutVertexVector.empty());
             patternToVertexBuffer = uploadPass.createVertexBuffer(std::move(patternToVertexVector));
@@ -615,12 +712,45 @@ public:
 
     template <class EvaluatedProperties>
     PaintPropertyBinders(const EvaluatedProperties& properties, float z)
-        : binders(Binder<Ps>::create(properties.template get<Ps>(), z, Ps::defaultValue())...) {
+        : binders(Binder<Ps>::create(properties.template get<Ps>(), z, Ps::defaultValue())...), zoom(z) {
         (void)z; // Workaround for https://gcc.gnu.org/bugzilla/show_bug.cgi?id=56958
     }
 
+    // Creates binders for new paint properties of the same layer, populated for the features that
+    // `previous` was populated with. The features are read again from the source layer, so that data-driven
+    // paint changes don't require a new layout. Pattern properties aren't supported, as they depend on
+    // the image positions of the layout.
+    template <class EvaluatedProperties>
+    PaintPropertyBinders(const EvaluatedProperties& properties,
+                         const PaintPropertyBinders& previous,
+                         const GeometryTileLayer& layer,
+                         const CanonicalTileID& canonical)
+        : PaintPropertyBinders(properties, previous.zoom) {
+        // All features are evaluated as one batch per binder, see PropertyExpression::evaluate().
+        std::vector<std::unique_ptr<GeometryTileFeature>> features;
+        std::vector<const GeometryTileFeature*> batch;
+        std::vector<FeatureVertexRange> ranges;
+        features.reserve(previous.featureRanges.size());
+        batch.reserve(previous.featureRanges.size());
+        ranges.reserve(previous.featureRanges.size());
+        for (const auto& range : previous.featureRanges) {
+            auto feature = layer.getFeature(range.featureIndex);
+            assert(feature);
+            if (feature) {
+                batch.push_back(feature.get());
+                ranges.push_back(range);
+                features.push_back(std::move(feature));
+            }
+        }
+        util::ignore({(binders.template get<Ps>()->populateVertexVectors(batch, ranges, canonical), 0)...});
+        for (const auto& range : ranges) {
+            addFeatureRange(range.featureIndex, range.end);
+        }
+    }
+
     PaintPropertyBinders(PaintPropertyBinders&&) noexcept = default;
     PaintPropertyBinders(const PaintPropertyBinders&) = delete;
+    PaintPropertyBinders& operator=(PaintPropertyBinders&&) noexcept = default;
 
     void populateVertexVectors(const GeometryTileFeature& feature,
                                std::size_t length,
@@ -632,6 +762,7 @@ public:
         util::ignore({(binders.template get<Ps>()->populateVertexVector(
                            feature, length, index, patternPositions, patternDependencies, canonical, formattedSection),
                        0)...});
+        addFeatureRange(index, length);
     }
 
     void updateVertexVectors(const FeatureStates& states, const GeometryTileLayer& layer,
@@ -687,7 +818,22 @@ public:
     }
 
 private:
+    void addFeatureRange(std::size_t index, std::size_t length) {
+        if (length <= populatedLength) return;
+        // Symbols populate the binders once per glyph run; consecutive runs of a feature share a range.
+        if (!featureRanges.empty() && featureRanges.back().featureIndex == index &&
+            featureRanges.back().end == populatedLength) {
+            featureRanges.back().end = length;
+        } else {
+            featureRanges.push_back({index, populatedLength, length});
+        }
+        populatedLength = length;
+    }
+
     Binders binders;
+    float zoom;
+    std::vector<FeatureVertexRange> featureRanges;
+    std::size_t populatedLength = 0;
 };
 
 } // namespace mbgl
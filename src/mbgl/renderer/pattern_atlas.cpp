@@ -2,6 +2,8 @@
 #include <mbgl/gfx/upload_pass.hpp>
 #include <mbgl/gfx/context.hpp>
 
+#include <algorithm>
+
 namespace mbgl {
 
 namespace {
@@ -37,8 +39,8 @@ optional<ImagePosition> PatternAtlas::addPattern(const style::Image::Impl& image
     if (patterns.find(image.id) != patterns.end()) {
         return nullopt;
     }
-    const uint16_t width = image.image.size.width + padding * 2;
-    const uint16_t height = image.image.size.height + padding * 2;
+    const uint16_t width = image.size.width + padding * 2;
+    const uint16_t height = image.size.height + padding * 2;
 
     mapbox::Bin* bin = shelfPack.packOne(-1, width, height);
     if (!bin) {
@@ -47,7 +49,7 @@ optional<ImagePosition> PatternAtlas::addPattern(const style::Image::Impl& image
 
     atlasImage.resize(getPixelSize());
 
-    const PremultipliedImage& src = image.image;
+    const PremultipliedImage& src = image.getImage();
 
     const uint32_t x = bin->x + padding;
     const uint32_t y = bin->y + padding;
@@ -62,7 +64,7 @@ optional<ImagePosition> PatternAtlas::addPattern(const style::Image::Impl& image
     PremultipliedImage::copy(src, atlasImage, { w - 1, 0 }, { x - 1, y }, { 1, h }); // L
     PremultipliedImage::copy(src, atlasImage, { 0,     0 }, { x + w, y }, { 1, h }); // R
 
-    dirty = true;
+    markDirty(bin->x, bin->y, width, height);
 
     return patterns.emplace(image.id, Pattern { bin, { *bin, image } }).first->second.position;
 }
@@ -76,6 +78,7 @@ void PatternAtlas::removePattern(const std::string& id) {
         const uint32_t w = it->second.bin->w;
         const uint32_t h = it->second.bin->h;
         PremultipliedImage::clear(atlasImage, { x, y }, { w, h });
+        markDirty(x, y, w, h);
 
         shelfPack.unref(*it->second.bin);
         patterns.erase(it);
@@ -89,11 +92,29 @@ Size PatternAtlas::getPixelSize() const {
     };
 }
 
+void PatternAtlas::markDirty(uint32_t x, uint32_t y, uint32_t w, uint32_t h) {
+    if (dirty) {
+        dirtyMin = {{ std::min(dirtyMin[0], x), std::min(dirtyMin[1], y) }};
+        dirtyMax = {{ std::max(dirtyMax[0], x + w), std::max(dirtyMax[1], y + h) }};
+    } else {
+        dirtyMin = {{ x, y }};
+        dirtyMax = {{ x + w, y + h }};
+    }
+    dirty = true;
+}
+
 void PatternAtlas::upload(gfx::UploadPass& uploadPass) {
     if (!atlasTexture) {
         atlasTexture = uploadPass.createTexture(atlasImage);
-    } else if (dirty) {
+    } else if (atlasTexture->size != atlasImage.size) {
         uploadPass.updateTexture(*atlasTexture, atlasImage);
+    } else if (dirty) {
+        // Patterns keep their place in the atlas for as long as their image doesn't change, so
+        // only the area of the patterns added or removed since the last upload is sent again.
+        PremultipliedImage area({ dirtyMax[0] - dirtyMin[0], dirtyMax[1] - dirtyMin[1] });
+        PremultipliedImage::copy(atlasImage, area, { dirtyMin[0], dirtyMin[1] }, { 0, 0 }, area.size);
+        uploadPass.updateTextureSub(*atlasTexture, area, static_cast<uint16_t>(dirtyMin[0]),
+                                    static_cast<uint16_t>(dirtyMin[1]));
     }
 
     dirty = false;
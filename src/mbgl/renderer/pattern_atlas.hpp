@@ -6,6 +6,7 @@
 #include <mbgl/style/image_impl.hpp>
 #include <mbgl/util/optional.hpp>
 
+#include <array>
 #include <unordered_map>
 #include <string>
 
@@ -45,11 +46,16 @@ private:
         mapbox::Bin* bin;
         ImagePosition position;
     };
+    void markDirty(uint32_t x, uint32_t y, uint32_t w, uint32_t h);
+
     mapbox::ShelfPack shelfPack;
     std::unordered_map<std::string, Pattern> patterns;
     PremultipliedImage atlasImage;
     mbgl::optional<gfx::Texture> atlasTexture;
     bool dirty = true;
+    // The area of the atlas image that changed since the last upload.
+    std::array<uint32_t, 2> dirtyMin {{ 0, 0 }};
+    std::array<uint32_t, 2> dirtyMax {{ 0, 0 }};
 };
  
 } // namespace mbgl
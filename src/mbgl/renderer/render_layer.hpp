@@ -80,6 +80,10 @@ public:
     // Returns true if the layer has a pattern property and is actively crossfading.
     virtual bool hasCrossfade() const = 0;
 
+    // Returns true if evaluating the paint properties at another zoom level gives the same result,
+    // in which case zoom changes don't require evaluating the layer again.
+    virtual bool isZoomConstant() const { return false; }
+
     // Returns true if layer writes to depth buffer by drawing using PaintParameters::depthModeFor3D().
     virtual bool is3D() const { return false; }
 
@@ -2,6 +2,8 @@
 
 #include <mbgl/annotation/annotation_manager.hpp>
 #include <mbgl/layermanager/layer_manager.hpp>
+#include <mbgl/platform/settings.hpp>
+#include <mbgl/renderer/load_progress.hpp>
 #include <mbgl/renderer/renderer_observer.hpp>
 #include <mbgl/renderer/render_source.hpp>
 #include <mbgl/renderer/render_layer.hpp>
@@ -14,6 +16,7 @@
 #include <mbgl/renderer/transition_parameters.hpp>
 #include <mbgl/renderer/property_evaluation_parameters.hpp>
 #include <mbgl/renderer/tile_parameters.hpp>
+#include <mbgl/renderer/upload_budget.hpp>
 #include <mbgl/renderer/render_tile.hpp>
 #include <mbgl/renderer/style_diff.hpp>
 #include <mbgl/renderer/query.hpp>
@@ -23,10 +26,15 @@
 #include <mbgl/style/transition_options.hpp>
 #include <mbgl/text/glyph_manager.hpp>
 #include <mbgl/tile/tile.hpp>
+#include <mbgl/util/frame_timer.hpp>
+#include <mbgl/util/image_buffer_pool.hpp>
 #include <mbgl/util/math.hpp>
+#include <mbgl/util/phase.hpp>
 #include <mbgl/util/string.hpp>
 #include <mbgl/util/logging.hpp>
 
+#include <algorithm>
+
 namespace mbgl {
 
 using namespace style;
@@ -75,9 +83,8 @@ public:
           updateSymbolOpacities(updateSymbolOpacities_) {}
 
     void prepare() override {
-        for (auto it = layersNeedPlacement.rbegin(); it != layersNeedPlacement.rend(); ++it) {
-            placement->updateLayerBuckets(*it, parameters->transformParams.state, updateSymbolOpacities);
-        }
+        MBGL_FRAME_TIMER(parameters->timings.prepare);
+        placement->updateLayerBuckets(layersNeedPlacement, parameters->transformParams.state, updateSymbolOpacities);
     }
 
     RenderItems getLayerRenderItems() const override {
@@ -113,7 +120,29 @@ RenderOrchestrator::RenderOrchestrator(bool backgroundLayerAsColor_, const optio
       sourceImpls(makeMutable<std::vector<Immutable<style::Source::Impl>>>()),
       layerImpls(makeMutable<std::vector<Immutable<style::Layer::Impl>>>()),
       renderLight(makeMutable<Light::Impl>()),
-      backgroundLayerAsColor(backgroundLayerAsColor_) {
+      backgroundLayerAsColor(backgroundLayerAsColor_),
+      uploadBudget([]() -> optional<std::size_t> {
+          auto value = platform::Settings::getInstance().get(platform::EXPERIMENTAL_UPLOAD_BUDGET);
+          if (auto* bytes = value.getUint()) return static_cast<std::size_t>(*bytes);
+          return nullopt;
+      }()),
+      skipUnchangedFrames([] {
+          auto value = platform::Settings::getInstance().get(platform::EXPERIMENTAL_SKIP_UNCHANGED_FRAMES);
+          const bool* skip = value.getBool();
+          return skip && *skip;
+      }()),
+      concurrentPlacement([] {
+          auto value = platform::Settings::getInstance().get(platform::EXPERIMENTAL_CONCURRENT_PLACEMENT);
+          const bool* concurrent = value.getBool();
+          return concurrent && *concurrent;
+      }()),
+      cachedLayerRange([]() -> optional<std::pair<std::string, std::string>> {
+          const auto& settings = platform::Settings::getInstance();
+          auto first = settings.get(platform::EXPERIMENTAL_CACHED_LAYER_RANGE_FIRST);
+          auto last = settings.get(platform::EXPERIMENTAL_CACHED_LAYER_RANGE_LAST);
+          if (!first.getString() || !last.getString()) return nullopt;
+          return std::make_pair(*first.getString(), *last.getString());
+      }()) {
     glyphManager->setObserver(this);
     imageManager->setObserver(this);
 }
@@ -150,6 +179,17 @@ std::unique_ptr<RenderTree> RenderOrchestrator::createRenderTree(
         }
     }
 
+    if (skipUnchangedFrames && isMapModeContinuous && isFrameUnchanged(*updateParameters)) {
+        return nullptr;
+    }
+    frameChanged = false;
+    completeFrameParameters.reset();
+
+#ifdef MBGL_FRAME_TIMINGS
+    FrameTimings timings;
+    const TimePoint frameStart = Clock::now();
+#endif
+
     const bool zoomChanged =
         zoomHistory.update(updateParameters->transformState.getZoom(), updateParameters->timePoint);
 
@@ -164,6 +204,11 @@ std::unique_ptr<RenderTree> RenderOrchestrator::createRenderTree(
         transitionOptions.duration.value_or(isMapModeContinuous ? util::DEFAULT_TRANSITION_DURATION
                                                                 : Duration::zero())};
 
+    optional<UploadBudget> frameUploadBudget;
+    if (isMapModeContinuous && uploadBudget) {
+        frameUploadBudget.emplace(*uploadBudget);
+    }
+
     const TileParameters tileParameters{updateParameters->pixelRatio,
                                         updateParameters->debugOptions,
                                         updateParameters->transformState,
@@ -172,7 +217,10 @@ std::unique_ptr<RenderTree> RenderOrchestrator::createRenderTree(
                                         updateParameters->annotationManager,
                                         *imageManager,
                                         *glyphManager,
-                                        updateParameters->prefetchZoomDelta};
+                                        updateParameters->prefetchZoomDelta,
+                                        updateParameters->transitionTarget ? &*updateParameters->transitionTarget
+                                                                           : nullptr,
+                                        frameUploadBudget ? &*frameUploadBudget : nullptr};
 
     glyphManager->setURL(updateParameters->glyphURL);
 
@@ -250,6 +298,9 @@ std::unique_ptr<RenderTree> RenderOrchestrator::createRenderTree(
 
     if (layersAddedOrRemoved || !layerDiff.changed.empty()) {
         glyphManager->evict(fontStacks(*layerImpls));
+        if (updateParameters->fileSource) {
+            glyphManager->prefetch(*layerImpls, *updateParameters->fileSource);
+        }
     }
 
     // Update layers for class and zoom changes.
@@ -257,7 +308,10 @@ std::unique_ptr<RenderTree> RenderOrchestrator::createRenderTree(
     for (RenderLayer& layer : orderedLayers) {
         const std::string& id = layer.getID();
         const bool layerAddedOrChanged = layerDiff.added.count(id) || layerDiff.changed.count(id);
-        if (layerAddedOrChanged || zoomChanged || layer.hasTransition() || layer.hasCrossfade()) {
+        // Layers whose paint properties don't depend on the zoom keep their evaluated properties.
+        const bool zoomDependent = zoomChanged && !layer.isZoomConstant();
+        if (layerAddedOrChanged || zoomDependent || layer.hasTransition() || layer.hasCrossfade()) {
+            MBGL_FRAME_TIMER(timings.evaluateLayers);
             auto previousMask = layer.evaluatedProperties->constantsMask();
             layer.evaluate(evaluationParameters);
             if (previousMask != layer.evaluatedProperties->constantsMask()) {
@@ -269,13 +323,26 @@ std::unique_ptr<RenderTree> RenderOrchestrator::createRenderTree(
     const SourceDifference sourceDiff = diffSources(sourceImpls, updateParameters->sources);
     sourceImpls = updateParameters->sources;
 
-    // Remove render layers for removed sources.
+    // Remove render layers for removed sources. Sources that only moved within the list, e.g.
+    // when switching to another style with the same sources, keep their render source and tiles,
+    // which are updated with the new source below.
+    auto moved = [&](const std::string& id) {
+        auto removed = sourceDiff.removed.find(id);
+        auto added = sourceDiff.added.find(id);
+        return removed != sourceDiff.removed.end() && added != sourceDiff.added.end() &&
+               removed->second->type == added->second->type;
+    };
     for (const auto& entry : sourceDiff.removed) {
-        renderSources.erase(entry.first);
+        if (!moved(entry.first)) {
+            renderSources.erase(entry.first);
+        }
     }
 
     // Create render sources for newly added sources.
     for (const auto& entry : sourceDiff.added) {
+        if (moved(entry.first)) {
+            continue;
+        }
         std::unique_ptr<RenderSource> renderSource = RenderSource::create(entry.second);
         renderSource->setObserver(this);
         renderSources.emplace(entry.first, std::move(renderSource));
@@ -301,6 +368,7 @@ std::unique_ptr<RenderTree> RenderOrchestrator::createRenderTree(
 
     // Update all sources and initialize renderItems.
     for (const auto& sourceImpl : *sourceImpls) {
+        MBGL_FRAME_TIMER(timings.updateSources);
         RenderSource* source = renderSources.at(sourceImpl->id).get();
         bool sourceNeedsRendering = false;
         bool sourceNeedsRelayout = false;
@@ -352,6 +420,7 @@ std::unique_ptr<RenderTree> RenderOrchestrator::createRenderTree(
 
     renderTreeParameters->loaded = updateParameters->styleLoaded && isLoaded();
     if (!isMapModeContinuous && !renderTreeParameters->loaded) {
+        updateLoadProgress(false);
         return nullptr;
     }
 
@@ -360,6 +429,10 @@ std::unique_ptr<RenderTree> RenderOrchestrator::createRenderTree(
         if (entry.second->isEnabled()) {
             entry.second->prepare(
                 {renderTreeParameters->transformParams, updateParameters->debugOptions, *imageManager});
+            if (!renderTreeParameters->hasRenderTiles) {
+                const RenderTiles tiles = entry.second->getRenderTiles();
+                renderTreeParameters->hasRenderTiles = tiles && !tiles->empty();
+            }
         }
     }
 
@@ -379,12 +452,15 @@ std::unique_ptr<RenderTree> RenderOrchestrator::createRenderTree(
         }
     }
     // Symbol placement.
+    optional<util::Phase::Scope> placementPhase;
+    placementPhase.emplace("placement");
     assert((updateParameters->mode == MapMode::Tile) || !placedSymbolDataCollected);
     bool symbolBucketsChanged = false;
     bool symbolBucketsAdded = false;
     std::set<std::string> usedSymbolLayers;
     auto longitude = updateParameters->transformState.getLatLng().longitude();
     for (auto it = layersNeedPlacement.crbegin(); it != layersNeedPlacement.crend(); ++it) {
+        MBGL_FRAME_TIMER(timings.placement);
         RenderLayer& layer = *it;
         auto result = crossTileSymbolIndex.addLayer(layer, longitude);
         if (isMapModeContinuous) {
@@ -395,6 +471,7 @@ std::unique_ptr<RenderTree> RenderOrchestrator::createRenderTree(
     }
 
     if (isMapModeContinuous) {
+        MBGL_FRAME_TIMER(timings.placement);
         optional<Duration> placementUpdatePeriodOverride;
         if (symbolBucketsAdded && !tiltedView) {
             // If the view is not tilted, we want *the new* symbols to show up faster, however simple setting
@@ -406,13 +483,27 @@ std::unique_ptr<RenderTree> RenderOrchestrator::createRenderTree(
             placementUpdatePeriodOverride = optional<Duration>(Milliseconds(30));
         }
 
-        renderTreeParameters->placementChanged = !placementController.placementIsRecent(
+        const bool placementDue = !placementController.placementIsRecent(
             updateParameters->timePoint, updateParameters->transformState.getZoom(), placementUpdatePeriodOverride);
-        symbolBucketsChanged |= renderTreeParameters->placementChanged;
-        if (renderTreeParameters->placementChanged) {
+        if (placementTimeBudget) {
+            if (placementDue && !placementController.hasPendingPlacement(layersNeedPlacement)) {
+                placementController.setPendingPlacement(
+                    Placement::create(updateParameters, placementController.getPlacement()), layersNeedPlacement);
+            }
+            renderTreeParameters->placementChanged =
+                placementController.hasPendingPlacement(layersNeedPlacement) &&
+                placementController.continuePlacement(
+                    layersNeedPlacement, updateParameters->timePoint, *placementTimeBudget);
+        } else if (placementDue) {
             Mutable<Placement> placement = Placement::create(updateParameters, placementController.getPlacement());
+            placement->setConcurrent(concurrentPlacement);
             placement->placeLayers(layersNeedPlacement);
             placementController.setPlacement(std::move(placement));
+            renderTreeParameters->placementChanged = true;
+        }
+        symbolBucketsChanged |= renderTreeParameters->placementChanged;
+        if (renderTreeParameters->placementChanged) {
+            renderTreeParameters->placementStatistics = placementController.getPlacement()->getStatistics();
             crossTileSymbolIndex.pruneUnusedLayers(usedSymbolLayers);
             for (const auto& entry : renderSources) {
                 entry.second->updateFadingTiles();
@@ -422,19 +513,26 @@ std::unique_ptr<RenderTree> RenderOrchestrator::createRenderTree(
         }
         renderTreeParameters->symbolFadeChange =
             placementController.getPlacement()->symbolFadeChange(updateParameters->timePoint);
-        renderTreeParameters->needsRepaint = hasTransitions(updateParameters->timePoint);
+        // The tiles left out by the upload budget are rendered in the next frames.
+        renderTreeParameters->needsRepaint = hasTransitions(updateParameters->timePoint) ||
+                                             (frameUploadBudget && frameUploadBudget->isExceeded());
     } else {
+        MBGL_FRAME_TIMER(timings.placement);
         renderTreeParameters->placementChanged = symbolBucketsChanged = !layersNeedPlacement.empty();
         if (renderTreeParameters->placementChanged) {
             Mutable<Placement> placement = Placement::create(updateParameters);
             placement->collectPlacedSymbolData(placedSymbolDataCollected);
             placement->placeLayers(layersNeedPlacement);
+            renderTreeParameters->placementStatistics = placement->getStatistics();
             placementController.setPlacement(std::move(placement));
         }
         crossTileSymbolIndex.reset();
         renderTreeParameters->symbolFadeChange = 1.0f;
         renderTreeParameters->needsRepaint = false;
     }
+    placementPhase = nullopt;
+    updateLoadProgress(isMapModeContinuous && (placementController.hasPendingPlacement(layersNeedPlacement) ||
+                                               placementController.hasTransitions(updateParameters->timePoint)));
 
     if (!renderTreeParameters->needsRepaint && renderTreeParameters->loaded) {
         // Notify observer about unused images when map is fully loaded
@@ -442,6 +540,62 @@ std::unique_ptr<RenderTree> RenderOrchestrator::createRenderTree(
         imageManager->reduceMemoryUseIfCacheSizeExceedsLimit();
     }
 
+    if (skipUnchangedFrames && isMapModeContinuous && renderTreeParameters->loaded &&
+        !renderTreeParameters->needsRepaint) {
+        // Custom layers draw whatever they like, every frame may change.
+        const bool hasCustomLayers = std::any_of(layerRenderItems.begin(), layerRenderItems.end(), [](const auto& item) {
+            return *item.layer.get().baseImpl->getTypeInfo()->type == '\0';
+        });
+        if (!hasCustomLayers) {
+            completeFrameParameters = updateParameters;
+        }
+    }
+
+    if (cachedLayerRange && isMapModeContinuous) {
+        auto layerIndex = [&](const std::string& id) -> optional<std::size_t> {
+            for (std::size_t index = 0; index < orderedLayers.size(); ++index) {
+                if (orderedLayers[index].get().getID() == id) return index;
+            }
+            return nullopt;
+        };
+        const auto first = layerIndex(cachedLayerRange->first);
+        const auto last = layerIndex(cachedLayerRange->second);
+
+        std::vector<const RenderLayer*> layers;
+        bool changed = lightChanged || hasImageDiff || !imageDiff.added.empty();
+        bool hasCustomLayers = false;
+        std::size_t position = 0;
+        for (const auto& item : layerRenderItems) {
+            if (!first || !last || item.index < *first || item.index > *last) {
+                ++position;
+                continue;
+            }
+            // The items of the range are contiguous, as they are ordered like the layers.
+            if (layers.empty()) {
+                renderTreeParameters->cachedLayersBegin = position;
+            }
+            renderTreeParameters->cachedLayersEnd = ++position;
+
+            const RenderLayer& layer = item.layer;
+            layers.push_back(&layer);
+            hasCustomLayers |= *layer.baseImpl->getTypeInfo()->type == '\0';
+            changed = changed || layerDiff.changed.count(layer.getID()) || layer.hasTransition() ||
+                      layer.hasCrossfade() ||
+                      (item.source && (changedSources.count(item.source) || item.source->hasFadingTiles())) ||
+                      (layer.needsPlacement() &&
+                       (symbolBucketsChanged || renderTreeParameters->symbolFadeChange < 1.0f));
+        }
+
+        if (hasCustomLayers) {
+            // Custom layers draw whatever they like, in every frame.
+            renderTreeParameters->cachedLayersBegin = renderTreeParameters->cachedLayersEnd = 0;
+            layers.clear();
+        }
+        renderTreeParameters->cachedLayersChanged = changed || layers != cachedLayers;
+        cachedLayers = std::move(layers);
+    }
+    changedSources.clear();
+
     std::vector<std::unique_ptr<RenderItem>> sourceRenderItems;
     for (const auto& entry : renderSources) {
         if (entry.second->isEnabled()) {
@@ -449,6 +603,11 @@ std::unique_ptr<RenderTree> RenderOrchestrator::createRenderTree(
         }
     }
 
+#ifdef MBGL_FRAME_TIMINGS
+    timings.createRenderTree = Clock::now() - frameStart;
+    renderTreeParameters->timings = std::move(timings);
+#endif
+
     return std::make_unique<RenderTreeImpl>(std::move(renderTreeParameters),
                                             std::move(layerRenderItems),
                                             std::move(sourceRenderItems),
@@ -563,7 +722,12 @@ std::vector<Feature> RenderOrchestrator::queryRenderedFeatures(const ScreenLineS
     for (const auto& pair : filteredLayers) {
         auto it = resultsByLayer.find(pair.second->baseImpl->id);
         if (it != resultsByLayer.end()) {
-            std::move(it->second.begin(), it->second.end(), std::back_inserter(result));
+            auto end = it->second.end();
+            if (options.limit) {
+                end = it->second.begin() + std::min(it->second.size(), *options.limit - result.size());
+            }
+            std::move(it->second.begin(), end, std::back_inserter(result));
+            if (options.limit && result.size() == *options.limit) break;
         }
     }
 
@@ -608,6 +772,17 @@ void RenderOrchestrator::setFeatureState(const std::string& sourceID, const opti
                                          const std::string& featureID, const FeatureState& state) {
     if (RenderSource* renderSource = getRenderSource(sourceID)) {
         renderSource->setFeatureState(sourceLayerID, featureID, state);
+        frameChanged = true;
+        changedSources.insert(renderSource);
+    }
+}
+
+void RenderOrchestrator::setFeatureStates(const std::string& sourceID,
+                                          const std::vector<FeatureStateUpdate>& updates) {
+    if (RenderSource* renderSource = getRenderSource(sourceID)) {
+        renderSource->setFeatureStates(updates);
+        frameChanged = true;
+        changedSources.insert(renderSource);
     }
 }
 
@@ -624,6 +799,8 @@ void RenderOrchestrator::removeFeatureState(const std::string& sourceID, const o
                                             const optional<std::string>& stateKey) {
     if (RenderSource* renderSource = getRenderSource(sourceID)) {
         renderSource->removeFeatureState(sourceLayerID, featureID, stateKey);
+        frameChanged = true;
+        changedSources.insert(renderSource);
     }
 }
 
@@ -633,6 +810,39 @@ void RenderOrchestrator::reduceMemoryUse() {
         entry.second->reduceMemoryUse();
     }
     imageManager->reduceMemoryUse();
+    util::rasterImageBufferPool().clear();
+    frameChanged = true;
+    cachedLayers.clear();
+    observer->onInvalidate();
+}
+
+void RenderOrchestrator::reduceMemoryUse(MemoryPressure pressure, optional<std::size_t> targetBytes) {
+    std::size_t cacheBytes = 0;
+    for (const auto& entry : renderSources) {
+        cacheBytes += entry.second->getCacheBytes();
+    }
+    const std::size_t cacheTarget =
+        targetBytes ? *targetBytes : (pressure == MemoryPressure::Moderate ? cacheBytes / 2 : 0);
+    if (cacheBytes > cacheTarget) {
+        // Every source keeps its share of the target.
+        const double ratio = double(cacheTarget) / cacheBytes;
+        for (const auto& entry : renderSources) {
+            entry.second->trimCache(static_cast<std::size_t>(entry.second->getCacheBytes() * ratio));
+        }
+    }
+
+    if (pressure == MemoryPressure::Critical) {
+        filteredLayersForSource.shrink_to_fit();
+        // The atlases are filled again with what the next frames draw.
+        if (!lineAtlas->isEmpty()) lineAtlas = std::make_unique<LineAtlas>();
+        if (!patternAtlas->isEmpty()) patternAtlas = std::make_unique<PatternAtlas>();
+        glyphManager->evictLoadedGlyphs();
+        imageManager->reduceMemoryUse();
+        util::rasterImageBufferPool().clear();
+        cachedLayers.clear();
+    }
+
+    frameChanged = true;
     observer->onInvalidate();
 }
 
@@ -644,6 +854,18 @@ void RenderOrchestrator::dumpDebugLogs() {
     imageManager->dumpDebugLogs();
 }
 
+void RenderOrchestrator::setPlacementTimeBudget(optional<Duration> budget) {
+    placementTimeBudget = std::move(budget);
+}
+
+void RenderOrchestrator::setUploadBudget(optional<std::size_t> budget) {
+    uploadBudget = std::move(budget);
+}
+
+void RenderOrchestrator::setOnDemandImagesCacheSize(std::size_t bytes) {
+    imageManager->setOnDemandImagesCacheSize(bytes);
+}
+
 void RenderOrchestrator::collectPlacedSymbolData(bool enable) {
     placedSymbolDataCollected = enable;
 }
@@ -691,6 +913,40 @@ bool RenderOrchestrator::hasTransitions(TimePoint timePoint) const {
     return false;
 }
 
+void RenderOrchestrator::updateLoadProgress(bool placementPending) {
+    LoadProgress progress;
+    progress.sources.reserve(sourceImpls->size());
+    for (const auto& sourceImpl : *sourceImpls) {
+        const RenderSource* source = getRenderSource(sourceImpl->id);
+        if (source && source->isEnabled()) {
+            progress.sources.push_back({sourceImpl->id, source->getPendingTileCount()});
+        }
+    }
+    progress.pendingGlyphRanges = glyphManager->getPendingRangeCount();
+    progress.pendingImageRequests = imageManager->getPendingRequestCount();
+    progress.placementPending = placementPending;
+
+    if (progress != loadProgress) {
+        loadProgress = std::move(progress);
+        observer->onDidUpdateLoadProgress(loadProgress);
+    }
+}
+
+bool RenderOrchestrator::isFrameUnchanged(const UpdateParameters& parameters) const {
+    if (frameChanged || !completeFrameParameters) {
+        return false;
+    }
+    const UpdateParameters& last = *completeFrameParameters;
+    // The projection matrix covers the camera, the viewport and its insets.
+    return parameters.styleLoaded == last.styleLoaded && parameters.pixelRatio == last.pixelRatio &&
+           parameters.debugOptions == last.debugOptions &&
+           parameters.transformState.getSize() == last.transformState.getSize() &&
+           parameters.transformState.getProjectionMatrix() == last.transformState.getProjectionMatrix() &&
+           parameters.glyphURL == last.glyphURL && parameters.spriteLoaded == last.spriteLoaded &&
+           parameters.light == last.light && parameters.images == last.images &&
+           parameters.sources == last.sources && parameters.layers == last.layers;
+}
+
 bool RenderOrchestrator::isLoaded() const {
     for (const auto& entry: renderSources) {
         if (!entry.second->isLoaded()) {
@@ -730,7 +986,9 @@ void RenderOrchestrator::onTileError(RenderSource& source, const OverscaledTileI
     observer->onResourceError(error);
 }
 
-void RenderOrchestrator::onTileChanged(RenderSource&, const OverscaledTileID&) {
+void RenderOrchestrator::onTileChanged(RenderSource& source, const OverscaledTileID&) {
+    frameChanged = true;
+    changedSources.insert(&source);
     observer->onInvalidate();
 }
 
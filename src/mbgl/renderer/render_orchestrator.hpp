@@ -11,10 +11,13 @@
 #include <mbgl/text/cross_tile_symbol_index.hpp>
 #include <mbgl/text/glyph_manager_observer.hpp>
 #include <mbgl/renderer/image_manager_observer.hpp>
+#include <mbgl/renderer/load_progress.hpp>
 #include <mbgl/text/placement.hpp>
 
 #include <memory>
 #include <string>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
 namespace mbgl {
@@ -45,7 +48,15 @@ public:
 
     void markContextLost() {
         contextLost = true;
+        frameChanged = true;
+        cachedLayers.clear();
     };
+    // The last frame was rendered incompletely, and the next one needs to render even if nothing
+    // changed.
+    void markFrameIncomplete() {
+        frameChanged = true;
+        cachedLayers.clear();
+    }
     // TODO: Introduce RenderOrchestratorObserver.
     void setObserver(RendererObserver*);
 
@@ -64,6 +75,8 @@ public:
     void setFeatureState(const std::string& sourceID, const optional<std::string>& layerID,
                          const std::string& featureID, const FeatureState& state);
 
+    void setFeatureStates(const std::string& sourceID, const std::vector<FeatureStateUpdate>& updates);
+
     void getFeatureState(FeatureState& state, const std::string& sourceID, const optional<std::string>& layerID,
                          const std::string& featureID) const;
 
@@ -71,14 +84,22 @@ public:
                             const optional<std::string>& featureID, const optional<std::string>& stateKey);
 
     void reduceMemoryUse();
+    void reduceMemoryUse(MemoryPressure, optional<std::size_t> targetBytes);
     void dumpDebugLogs();
+    void setPlacementTimeBudget(optional<Duration>);
+    void setUploadBudget(optional<std::size_t>);
+    void setOnDemandImagesCacheSize(std::size_t);
     void collectPlacedSymbolData(bool);
     const std::vector<PlacedSymbolData>& getPlacedSymbolsData() const;
     void clearData();
 
 private:
     bool isLoaded() const;
+    // Whether a frame for these parameters would look the same as the last complete frame.
+    bool isFrameUnchanged(const UpdateParameters&) const;
     bool hasTransitions(TimePoint) const;
+    // Notifies the observer of what the map still waits for, if it changed since the last frame.
+    void updateLoadProgress(bool placementPending);
 
     RenderSource* getRenderSource(const std::string& id) const;
 
@@ -127,6 +148,29 @@ private:
     const bool backgroundLayerAsColor;
     bool contextLost = false;
     bool placedSymbolDataCollected = false;
+    optional<Duration> placementTimeBudget;
+    optional<std::size_t> uploadBudget;
+
+    // Frames that would look the same as the last complete one are skipped, see
+    // platform::EXPERIMENTAL_SKIP_UNCHANGED_FRAMES.
+    const bool skipUnchangedFrames;
+    // platform::EXPERIMENTAL_CONCURRENT_PLACEMENT.
+    const bool concurrentPlacement;
+    // Tiles, feature states or the GPU context changed since the last frame.
+    bool frameChanged = true;
+    // The parameters of the last frame, if it was complete: loaded, without transitions, and without
+    // custom layers that draw content of their own.
+    std::shared_ptr<UpdateParameters> completeFrameParameters;
+    // The load progress last reported to the observer.
+    LoadProgress loadProgress;
+
+    // IDs of the first and last layer that render into a cached texture, see
+    // platform::EXPERIMENTAL_CACHED_LAYER_RANGE_FIRST.
+    const optional<std::pair<std::string, std::string>> cachedLayerRange;
+    // The layers in the cached texture, empty when it needs to render again regardless.
+    std::vector<const RenderLayer*> cachedLayers;
+    // Sources whose tiles or feature states changed since the last frame.
+    std::unordered_set<const RenderSource*> changedSources;
 
     // Vectors with reserved capacity of layerImpls->size() to avoid reallocation
     // on each frame.
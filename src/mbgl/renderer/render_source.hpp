@@ -52,6 +52,8 @@ public:
 
     bool isEnabled() const;
     virtual bool isLoaded() const = 0;
+    // The tiles that keep the source from being loaded.
+    virtual std::size_t getPendingTileCount() const { return isLoaded() ? 0 : 1; }
 
     virtual void update(Immutable<style::Source::Impl>,
                         const std::vector<Immutable<style::LayerProperties>>&,
@@ -94,6 +96,7 @@ public:
     }
 
     virtual void setFeatureState(const optional<std::string>&, const std::string&, const FeatureState&) {}
+    virtual void setFeatureStates(const std::vector<FeatureStateUpdate>&) {}
 
     virtual void getFeatureState(FeatureState&, const optional<std::string>&, const std::string&) const {}
 
@@ -101,6 +104,10 @@ public:
                                     const optional<std::string>&) {}
 
     virtual void reduceMemoryUse() = 0;
+    // The bytes of the tiles that are kept for reuse without being rendered.
+    virtual std::size_t getCacheBytes() const { return 0; }
+    // Drops the least recently used of those tiles until they take at most `maxBytes`.
+    virtual void trimCache(std::size_t /*maxBytes*/) {}
 
     virtual void dumpDebugLogs() const = 0;
 
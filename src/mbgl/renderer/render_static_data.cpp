@@ -1,6 +1,7 @@
 #include <mbgl/renderer/render_static_data.hpp>
 #include <mbgl/gfx/context.hpp>
 #include <mbgl/gfx/upload_pass.hpp>
+#include <mbgl/platform/settings.hpp>
 #include <mbgl/programs/program_parameters.hpp>
 
 namespace mbgl {
@@ -49,8 +50,20 @@ static gfx::VertexVector<HeatmapTextureLayoutVertex> heatmapTextureVertices() {
     return result;
 }
 
+namespace {
+
+optional<std::string> programCacheDirectory() {
+    auto value = platform::Settings::getInstance().get(platform::EXPERIMENTAL_PROGRAM_CACHE_DIRECTORY);
+    if (const auto* directory = value.getString()) {
+        if (!directory->empty()) return *directory;
+    }
+    return {};
+}
+
+} // namespace
+
 RenderStaticData::RenderStaticData(gfx::Context& context, float pixelRatio)
-    : programs(context, ProgramParameters{pixelRatio, false}),
+    : programs(context, ProgramParameters{pixelRatio, false, programCacheDirectory()}),
       clippingMaskSegments(tileTriangleSegments())
 #ifndef NDEBUG
       ,
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <mbgl/renderer/frame_timings.hpp>
 #include <mbgl/renderer/paint_parameters.hpp>
+#include <mbgl/renderer/placement_statistics.hpp>
 
 #include <cassert>
 #include <memory>
@@ -52,6 +54,17 @@ public:
     bool needsRepaint = false;
     bool loaded = false;
     bool placementChanged = false;
+    // Whether any source has tiles to render.
+    bool hasRenderTiles = false;
+    // The layer render items [cachedLayersBegin, cachedLayersEnd) render into a texture, which is only rendered
+    // again when cachedLayersChanged or the camera moved.
+    std::size_t cachedLayersBegin = 0;
+    std::size_t cachedLayersEnd = 0;
+    bool cachedLayersChanged = true;
+    // CPU times of creating and preparing the render tree, in builds with frame timings.
+    FrameTimings timings;
+    // Statistics of the placement, set when placementChanged.
+    PlacementStatistics placementStatistics;
 };
 
 class RenderTree {
@@ -4,6 +4,8 @@
 #include <mbgl/renderer/renderer_impl.hpp>
 #include <mbgl/renderer/render_tree.hpp>
 #include <mbgl/gfx/backend_scope.hpp>
+#include <mbgl/gfx/context.hpp>
+#include <mbgl/gfx/renderer_backend.hpp>
 #include <mbgl/annotation/annotation_manager.hpp>
 
 namespace mbgl {
@@ -17,6 +19,7 @@ Renderer::~Renderer() {
 }
 
 void Renderer::markContextLost() {
+    impl->preparedTree.reset();
     impl->orchestrator.markContextLost();
 }
 
@@ -26,9 +29,23 @@ void Renderer::setObserver(RendererObserver* observer) {
 }
 
 void Renderer::render(const std::shared_ptr<UpdateParameters>& updateParameters) {
+    if (prepare(updateParameters)) {
+        draw();
+    }
+}
+
+bool Renderer::prepare(const std::shared_ptr<UpdateParameters>& updateParameters) {
     assert(updateParameters);
-    if (auto renderTree = impl->orchestrator.createRenderTree(updateParameters)) {
-        renderTree->prepare();
+    impl->preparedTree = impl->orchestrator.createRenderTree(updateParameters);
+    if (!impl->preparedTree) {
+        return false;
+    }
+    impl->preparedTree->prepare();
+    return true;
+}
+
+void Renderer::draw() {
+    if (auto renderTree = std::move(impl->preparedTree)) {
         impl->render(*renderTree);
     }
 }
@@ -111,6 +128,10 @@ void Renderer::setFeatureState(const std::string& sourceID, const optional<std::
     impl->orchestrator.setFeatureState(sourceID, sourceLayerID, featureID, state);
 }
 
+void Renderer::setFeatureStates(const std::string& sourceID, const std::vector<FeatureStateUpdate>& updates) {
+    impl->orchestrator.setFeatureStates(sourceID, updates);
+}
+
 void Renderer::getFeatureState(FeatureState& state, const std::string& sourceID,
                                const optional<std::string>& sourceLayerID, const std::string& featureID) const {
     impl->orchestrator.getFeatureState(state, sourceID, sourceLayerID, featureID);
@@ -125,6 +146,18 @@ void Renderer::dumpDebugLogs() {
     impl->orchestrator.dumpDebugLogs();
 }
 
+void Renderer::setPlacementTimeBudget(optional<Duration> budget) {
+    impl->orchestrator.setPlacementTimeBudget(std::move(budget));
+}
+
+void Renderer::setUploadBudget(optional<std::size_t> bytes) {
+    impl->orchestrator.setUploadBudget(std::move(bytes));
+}
+
+void Renderer::setOnDemandImagesCacheSize(std::size_t bytes) {
+    impl->orchestrator.setOnDemandImagesCacheSize(bytes);
+}
+
 void Renderer::collectPlacedSymbolData(bool enable) {
     impl->orchestrator.collectPlacedSymbolData(enable);
 }
@@ -135,12 +168,26 @@ const std::vector<PlacedSymbolData>& Renderer::getPlacedSymbolsData() const {
 
 void Renderer::reduceMemoryUse() {
     gfx::BackendScope guard { impl->backend };
-    impl->reduceMemoryUse();
+    impl->preparedTree.reset();
+    impl->reduceMemoryUse(MemoryPressure::Critical);
     impl->orchestrator.reduceMemoryUse();
 }
 
+void Renderer::reduceMemoryUse(MemoryPressure pressure, optional<std::size_t> targetBytes) {
+    gfx::BackendScope guard { impl->backend };
+    impl->preparedTree.reset();
+    impl->reduceMemoryUse(pressure);
+    impl->orchestrator.reduceMemoryUse(pressure, targetBytes);
+}
+
 void Renderer::clearData() {
+    impl->preparedTree.reset();
     impl->orchestrator.clearData();
 }
 
+gfx::MemoryUsage Renderer::getGPUMemoryUsage() const {
+    gfx::BackendScope guard { impl->backend };
+    return impl->backend.getContext().memoryTracker().getUsage();
+}
+
 } // namespace mbgl
@@ -8,13 +8,19 @@
 #include <mbgl/gfx/cull_face_mode.hpp>
 #include <mbgl/gfx/context.hpp>
 #include <mbgl/gfx/renderable.hpp>
+#include <mbgl/renderer/frame_timings.hpp>
 #include <mbgl/renderer/pattern_atlas.hpp>
+#include <mbgl/renderer/placement_statistics.hpp>
 #include <mbgl/renderer/renderer_observer.hpp>
 #include <mbgl/renderer/render_static_data.hpp>
 #include <mbgl/renderer/render_tree.hpp>
+#include <mbgl/util/frame_timer.hpp>
+#include <mbgl/util/phase.hpp>
 #include <mbgl/util/string.hpp>
 #include <mbgl/util/logging.hpp>
 
+#include <algorithm>
+
 namespace mbgl {
 
 using namespace style;
@@ -52,6 +58,7 @@ void Renderer::Impl::render(const RenderTree& renderTree) {
     staticData->has3D = renderTreeParameters.has3D;
 
     auto& context = backend.getContext();
+    const int skippedDrawCalls = context.renderingStats().numSkippedDrawCalls;
 
     // Blocks execution until the renderable is available.
     backend.getDefaultRenderable().wait();
@@ -75,21 +82,61 @@ void Renderer::Impl::render(const RenderTree& renderTree) {
     const auto& sourceRenderItems = renderTree.getSourceRenderItems();
     const auto& layerRenderItems = renderTree.getLayerRenderItems();
 
+#ifdef MBGL_FRAME_TIMINGS
+    FrameTimings timings = renderTreeParameters.timings;
+    timings.layers.resize(layerRenderItems.size());
+    for (std::size_t position = 0; position < layerRenderItems.size(); ++position) {
+        timings.layers[position].id = layerRenderItems[position].get().getName();
+    }
+    context.beginGPUTimer();
+#endif
+
     // - UPLOAD PASS -------------------------------------------------------------------------------
     // Uploads all required buffers and images before we do any actual rendering.
     {
+        MBGL_FRAME_TIMER(timings.upload);
+        const util::Phase::Scope phase("upload");
         const auto uploadPass = parameters.encoder->createUploadPass("upload");
 
         // Update all clipping IDs + upload buckets.
         for (const RenderItem& item : sourceRenderItems) {
+            const auto memoryScope = uploadPass->createMemoryScope(gfx::MemoryOwner::forSource(item.getName()));
             item.upload(*uploadPass);
         }
         for (const RenderItem& item : layerRenderItems) {
+            const auto memoryScope = uploadPass->createMemoryScope(gfx::MemoryOwner::forLayer(item.getName()));
             item.upload(*uploadPass);
         }
-        staticData->upload(*uploadPass);
-        renderTree.getLineAtlas().upload(*uploadPass);
-        renderTree.getPatternAtlas().upload(*uploadPass);
+        {
+            const auto memoryScope = uploadPass->createMemoryScope(gfx::MemoryOwner::forShared("static data"));
+            staticData->upload(*uploadPass);
+        }
+        {
+            const auto memoryScope = uploadPass->createMemoryScope(gfx::MemoryOwner::forShared("line atlas"));
+            renderTree.getLineAtlas().upload(*uploadPass);
+        }
+        {
+            const auto memoryScope = uploadPass->createMemoryScope(gfx::MemoryOwner::forShared("pattern atlas"));
+            renderTree.getPatternAtlas().upload(*uploadPass);
+        }
+    }
+
+#ifdef MBGL_FRAME_TIMINGS
+    const TimePoint renderStart = Clock::now();
+#endif
+
+    // The cached layer range only renders when the camera moved or its layers changed since it was cached.
+    const std::size_t cachedLayersBegin = renderTreeParameters.cachedLayersBegin;
+    const std::size_t cachedLayersEnd = std::min(renderTreeParameters.cachedLayersEnd, layerRenderItems.size());
+    // Positions count the layer render items bottom-to-top, layers count them top-to-bottom.
+    const auto layerPosition = [&](std::size_t layer) { return layerRenderItems.size() - 1 - layer; };
+    const auto isCached = [&](uint32_t layer) {
+        return layerPosition(layer) >= cachedLayersBegin && layerPosition(layer) < cachedLayersEnd;
+    };
+    const bool renderCachedLayers = cachedLayersBegin < cachedLayersEnd &&
+                                    !layerRangeCache.isValid(parameters, renderTreeParameters.cachedLayersChanged);
+    if (cachedLayersBegin >= cachedLayersEnd) {
+        layerRangeCache.reset();
     }
 
     // - 3D PASS -------------------------------------------------------------------------------------
@@ -112,13 +159,44 @@ void Renderer::Impl::render(const RenderTree& renderTree) {
         for (auto it = layerRenderItems.begin(); it != layerRenderItems.end() && i >= 0; ++it, --i) {
             parameters.currentLayer = i;
             const RenderItem& renderItem = it->get();
-            if (renderItem.hasRenderPass(parameters.pass)) {
+            if ((renderCachedLayers || !isCached(i)) && renderItem.hasRenderPass(parameters.pass)) {
+                MBGL_FRAME_TIMER(timings.layers[layerPosition(i)].render);
                 const auto layerDebugGroup(parameters.encoder->createDebugGroup(renderItem.getName().c_str()));
                 renderItem.render(parameters);
             }
         }
     }
 
+    parameters.depthRangeSize = 1 - (layerRenderItems.size() + 2) * parameters.numSublayers * parameters.depthEpsilon;
+
+    // - CACHED LAYERS PASS ------------------------------------------------------------------------
+    // Renders the cached layer range into its texture, opaque objects top-to-bottom and translucent
+    // objects bottom-to-top like the main buffer does. The main buffer composites the texture.
+    if (renderCachedLayers) {
+        parameters.renderPass = layerRangeCache.createRenderPass(parameters);
+
+        const auto renderCachedLayer = [&](std::size_t position) {
+            parameters.currentLayer = static_cast<uint32_t>(layerPosition(position));
+            const RenderItem& renderItem = layerRenderItems[position].get();
+            if (renderItem.hasRenderPass(parameters.pass)) {
+                MBGL_FRAME_TIMER(timings.layers[position].render);
+                const auto layerDebugGroup(parameters.renderPass->createDebugGroup(renderItem.getName().c_str()));
+                renderItem.render(parameters);
+            }
+        };
+        parameters.pass = RenderPass::Opaque;
+        for (std::size_t position = cachedLayersEnd; position-- > cachedLayersBegin;) {
+            renderCachedLayer(position);
+        }
+        parameters.pass = RenderPass::Translucent;
+        for (std::size_t position = cachedLayersBegin; position < cachedLayersEnd; ++position) {
+            renderCachedLayer(position);
+        }
+
+        parameters.renderPass.reset();
+        parameters.resetTileClippingMasks();
+    }
+
     // - CLEAR -------------------------------------------------------------------------------------
     // Renders the backdrop of the OpenGL view. This also paints in areas where we don't have any
     // tiles whatsoever.
@@ -134,8 +212,6 @@ void Renderer::Impl::render(const RenderTree& renderTree) {
 
     // Actually render the layers
 
-    parameters.depthRangeSize = 1 - (layerRenderItems.size() + 2) * parameters.numSublayers * parameters.depthEpsilon;
-
     // - OPAQUE PASS -------------------------------------------------------------------------------
     // Render everything top-to-bottom by using reverse iterators. Render opaque objects first.
     {
@@ -146,7 +222,8 @@ void Renderer::Impl::render(const RenderTree& renderTree) {
         for (auto it = layerRenderItems.rbegin(); it != layerRenderItems.rend(); ++it, ++i) {
             parameters.currentLayer = i;
             const RenderItem& renderItem = it->get();
-            if (renderItem.hasRenderPass(parameters.pass)) {
+            if (!isCached(i) && renderItem.hasRenderPass(parameters.pass)) {
+                MBGL_FRAME_TIMER(timings.layers[layerPosition(i)].render);
                 const auto layerDebugGroup(parameters.renderPass->createDebugGroup(renderItem.getName().c_str()));
                 renderItem.render(parameters);
             }
@@ -163,7 +240,14 @@ void Renderer::Impl::render(const RenderTree& renderTree) {
         for (auto it = layerRenderItems.begin(); it != layerRenderItems.end() && i >= 0; ++it, --i) {
             parameters.currentLayer = i;
             const RenderItem& renderItem = it->get();
-            if (renderItem.hasRenderPass(parameters.pass)) {
+            if (isCached(i)) {
+                if (layerPosition(i) == cachedLayersEnd - 1) {
+                    // Composite the range at the depth of its top layer.
+                    const auto layerDebugGroup(parameters.renderPass->createDebugGroup("cached layers"));
+                    layerRangeCache.composite(parameters);
+                }
+            } else if (renderItem.hasRenderPass(parameters.pass)) {
+                MBGL_FRAME_TIMER(timings.layers[layerPosition(i)].render);
                 const auto layerDebugGroup(parameters.renderPass->createDebugGroup(renderItem.getName().c_str()));
                 renderItem.render(parameters);
             }
@@ -204,13 +288,53 @@ void Renderer::Impl::render(const RenderTree& renderTree) {
     // CommandEncoder destructor submits render commands.
     parameters.encoder.reset();
 
+#ifdef MBGL_FRAME_TIMINGS
+    timings.render = Clock::now() - renderStart;
+    timings.gpu = context.endGPUTimer();
+#endif
+
+    // Draws were skipped while the driver was still linking their programs, the frame is incomplete.
+    const bool programsLinking = context.renderingStats().numSkippedDrawCalls != skippedDrawCalls;
+    const bool loaded = renderTreeParameters.loaded && !programsLinking;
+
+    if (!renderedFirstFrame) {
+        renderedFirstFrame = true;
+        observer->onDidReachStartupMilestone(RendererObserver::StartupMilestone::FirstFrame);
+    }
+    if (renderTreeParameters.hasRenderTiles) {
+        if (!renderedFirstTile) {
+            renderedFirstTile = true;
+            observer->onDidReachStartupMilestone(RendererObserver::StartupMilestone::FirstTileRendered);
+        }
+        if (!programsReady && !programsLinking) {
+            programsReady = true;
+            observer->onDidReachStartupMilestone(RendererObserver::StartupMilestone::ProgramsReady);
+        }
+    }
+
+    if (renderTreeParameters.placementChanged) {
+        observer->onDidPlaceSymbols(renderTreeParameters.placementStatistics);
+    }
+
     observer->onDidFinishRenderingFrame(
-        renderTreeParameters.loaded ? RendererObserver::RenderMode::Full : RendererObserver::RenderMode::Partial,
-        renderTreeParameters.needsRepaint,
+        loaded ? RendererObserver::RenderMode::Full : RendererObserver::RenderMode::Partial,
+        renderTreeParameters.needsRepaint || programsLinking,
         renderTreeParameters.placementChanged
     );
 
-    if (!renderTreeParameters.loaded) {
+#ifdef MBGL_FRAME_TIMINGS
+    observer->onDidMeasureFrame(timings);
+#endif
+
+    if (programsLinking) {
+        orchestrator.markFrameIncomplete();
+        if (!isMapModeContinuous) {
+            // Still images only render again on request.
+            observer->onInvalidate();
+        }
+    }
+
+    if (!loaded) {
         renderState = RenderState::Partial;
     } else if (renderState != RenderState::Fully) {
         renderState = RenderState::Fully;
@@ -218,8 +342,14 @@ void Renderer::Impl::render(const RenderTree& renderTree) {
     }
 }
 
-void Renderer::Impl::reduceMemoryUse() {
+void Renderer::Impl::reduceMemoryUse(MemoryPressure pressure) {
     assert(gfx::BackendScope::exists());
+    if (pressure == MemoryPressure::Moderate) {
+        // Deletes the objects that were abandoned since the last frame.
+        backend.getContext().performCleanup();
+        return;
+    }
+    layerRangeCache.reset();
     backend.getContext().reduceMemoryUsage();
 }
 
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <mbgl/renderer/layer_range_cache.hpp>
 #include <mbgl/renderer/render_orchestrator.hpp>
 
 #include <memory>
@@ -27,17 +28,22 @@ private:
 
     void render(const RenderTree&);
 
-    void reduceMemoryUse();
+    void reduceMemoryUse(MemoryPressure);
 
     // TODO: Move orchestrator to Map::Impl.
     RenderOrchestrator orchestrator;
 
+    // The frame built by Renderer::prepare() and not drawn yet. It refers to the state of the
+    // orchestrator, so it goes first.
+    std::unique_ptr<RenderTree> preparedTree;
+
     gfx::RendererBackend& backend;
 
     RendererObserver* observer;
 
     const float pixelRatio;
     std::unique_ptr<RenderStaticData> staticData;
+    LayerRangeCache layerRangeCache;
 
     enum class RenderState {
         Never,
@@ -46,6 +52,11 @@ private:
     };
 
     RenderState renderState = RenderState::Never;
+
+    // Startup milestones that were reported already.
+    bool renderedFirstFrame = false;
+    bool renderedFirstTile = false;
+    bool programsReady = false;
 };
 
 } // namespace mbgl
@@ -5,88 +5,116 @@
 
 namespace mbgl {
 
-void SourceFeatureState::updateState(const optional<std::string>& sourceLayerID, const std::string& featureID,
-                                     const FeatureState& newState) {
-    std::string sourceLayer = sourceLayerID.value_or(std::string());
+namespace {
+
+void mergeState(FeatureStates& layerStates, const std::string& featureID, const FeatureState& newState) {
+    auto& featureStates = layerStates[featureID];
     for (const auto& state : newState) {
-        auto& layerStates = stateChanges[sourceLayer];
-        auto& featureStates = layerStates[featureID];
         featureStates[state.first] = state.second;
     }
 }
 
-void SourceFeatureState::getState(FeatureState& result, const optional<std::string>& sourceLayerID,
-                                  const std::string& featureID) const {
-    std::string sourceLayer = sourceLayerID.value_or(std::string());
-    FeatureState current;
-    FeatureState changes;
-    auto layerStates = currentStates.find(sourceLayer);
-    if (layerStates != currentStates.end()) {
-        const auto currentStateEntry = layerStates->second.find(featureID);
-        if (currentStateEntry != layerStates->second.end()) {
-            current = currentStateEntry->second;
+} // namespace
+
+void SourceFeatureState::updateState(const optional<std::string>& sourceLayerID, const std::string& featureID,
+                                     const FeatureState& newState) {
+    if (newState.empty()) {
+        return;
+    }
+    mergeState(stateChanges[sourceLayerID.value_or(std::string())], featureID, newState);
+}
+
+void SourceFeatureState::updateStates(const std::vector<FeatureStateUpdate>& updates) {
+    // The changes of a source layer are looked up once for each run of updates to that layer.
+    // Like all other changes, they are applied to the tiles once per frame by coalesceChanges().
+    const optional<std::string>* sourceLayerID = nullptr;
+    FeatureStates* layerStates = nullptr;
+    for (const auto& update : updates) {
+        if (update.state.empty()) {
+            continue;
+        }
+        if (!layerStates || update.sourceLayerID != *sourceLayerID) {
+            sourceLayerID = &update.sourceLayerID;
+            layerStates = &stateChanges[update.sourceLayerID.value_or(std::string())];
         }
+        mergeState(*layerStates, update.featureID, update.state);
     }
+}
 
-    layerStates = stateChanges.find(sourceLayer);
+void SourceFeatureState::getState(FeatureState& result, const optional<std::string>& sourceLayerID,
+                                  const std::string& featureID) const {
+    const std::string sourceLayer = sourceLayerID.value_or(std::string());
+    result.clear();
+
+    // Pending changes take precedence over the current state.
+    auto layerStates = stateChanges.find(sourceLayer);
     if (layerStates != stateChanges.end()) {
         const auto stateChangesEntry = layerStates->second.find(featureID);
         if (stateChangesEntry != layerStates->second.end()) {
-            changes = stateChangesEntry->second;
+            result = stateChangesEntry->second;
+        }
+    }
+
+    layerStates = currentStates.find(sourceLayer);
+    if (layerStates != currentStates.end()) {
+        const auto currentStateEntry = layerStates->second.find(featureID);
+        if (currentStateEntry != layerStates->second.end()) {
+            result.insert(currentStateEntry->second.begin(), currentStateEntry->second.end());
         }
     }
-    result = std::move(changes);
-    result.insert(current.begin(), current.end());
 }
 
 void SourceFeatureState::coalesceChanges(std::vector<RenderTile>& tiles) {
+    // Each source layer and feature is looked up once, and features whose state becomes empty are
+    // dropped, so that hover and selection states that come and go don't pile up.
     LayerFeatureStates changes;
-    for (const auto& layerStatesEntry : stateChanges) {
-        const auto& sourceLayer = layerStatesEntry.first;
-        FeatureStates layerStates;
-        for (const auto& featureStatesEntry : stateChanges[sourceLayer]) {
-            const auto& featureID = featureStatesEntry.first;
-            for (const auto& stateEntry : stateChanges[sourceLayer][featureID]) {
-                const auto& stateKey = stateEntry.first;
-                const auto& stateVal = stateEntry.second;
-
-                auto currentState = currentStates[sourceLayer][featureID].find(stateKey);
-                if (currentState != currentStates[sourceLayer][featureID].end()) {
-                    currentState->second = stateVal;
-                } else {
-                    currentStates[sourceLayer][featureID].insert(std::make_pair(stateKey, stateVal));
-                }
+    for (auto& layerStatesEntry : stateChanges) {
+        auto& currentLayerStates = currentStates[layerStatesEntry.first];
+        auto& layerChanges = changes[layerStatesEntry.first];
+        layerChanges.reserve(layerStatesEntry.second.size());
+        for (auto& featureStatesEntry : layerStatesEntry.second) {
+            auto& current = currentLayerStates[featureStatesEntry.first];
+            for (auto& stateEntry : featureStatesEntry.second) {
+                current[stateEntry.first] = std::move(stateEntry.second);
             }
-            layerStates[featureID] = currentStates[sourceLayer][featureID];
+            layerChanges[featureStatesEntry.first] = current;
         }
-        changes[sourceLayer] = std::move(layerStates);
     }
 
     for (const auto& layerStatesEntry : deletedStates) {
         const auto& sourceLayer = layerStatesEntry.first;
-        FeatureStates layerStates = {{}, {}};
+        auto currentLayerStates = currentStates.find(sourceLayer);
+        auto& layerChanges = changes[sourceLayer];
 
-        if (deletedStates[sourceLayer].empty()) {
-            for (const auto& featureStatesEntry : currentStates[sourceLayer]) {
-                const auto& featureID = featureStatesEntry.first;
-                layerStates[featureID] = {};
-                currentStates[sourceLayer][featureID] = {};
+        if (layerStatesEntry.second.empty()) {
+            if (currentLayerStates != currentStates.end()) {
+                for (const auto& featureStatesEntry : currentLayerStates->second) {
+                    layerChanges[featureStatesEntry.first] = {};
+                }
+                currentStates.erase(currentLayerStates);
             }
-        } else {
-            for (const auto& feature : deletedStates[sourceLayer]) {
-                const auto& featureID = feature.first;
-                bool deleteWholeFeatureState = deletedStates[sourceLayer][featureID].empty();
-                if (deleteWholeFeatureState) {
-                    currentStates[sourceLayer][featureID] = {};
-                } else {
-                    for (const auto& stateEntry : deletedStates[sourceLayer][featureID]) {
-                        currentStates[sourceLayer][featureID].erase(stateEntry.first);
+            continue;
+        }
+
+        for (const auto& feature : layerStatesEntry.second) {
+            const auto& featureID = feature.first;
+            FeatureState remaining;
+            if (currentLayerStates != currentStates.end()) {
+                auto current = currentLayerStates->second.find(featureID);
+                if (current != currentLayerStates->second.end()) {
+                    if (!feature.second.empty()) {
+                        for (const auto& stateEntry : feature.second) {
+                            current->second.erase(stateEntry.first);
+                        }
+                        remaining = current->second;
+                    }
+                    if (remaining.empty()) {
+                        currentLayerStates->second.erase(current);
                     }
                 }
-                layerStates[featureID] = currentStates[sourceLayer][featureID];
             }
+            layerChanges[featureID] = std::move(remaining);
         }
-        changes[sourceLayer] = std::move(layerStates);
     }
 
     stateChanges.clear();
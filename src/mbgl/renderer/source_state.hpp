@@ -14,6 +14,7 @@ public:
 
     void updateState(const optional<std::string>& sourceLayerID, const std::string& featureID,
                      const FeatureState& newState);
+    void updateStates(const std::vector<FeatureStateUpdate>& updates);
     void getState(FeatureState& result, const optional<std::string>& sourceLayerID, const std::string& featureID) const;
     void removeState(const optional<std::string>& sourceLayerID, const optional<std::string>& featureID,
                      const optional<std::string>& stateKey);
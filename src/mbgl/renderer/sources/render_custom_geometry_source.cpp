@@ -1,6 +1,8 @@
 #include <mbgl/renderer/sources/render_custom_geometry_source.hpp>
 #include <mbgl/renderer/render_tile.hpp>
 #include <mbgl/renderer/paint_parameters.hpp>
+#include <mbgl/renderer/tile_parameters.hpp>
+#include <mbgl/map/transform_state.hpp>
 #include <mbgl/tile/custom_geometry_tile.hpp>
 
 namespace mbgl {
@@ -40,6 +42,12 @@ void RenderCustomGeometrySource::update(Immutable<style::Source::Impl> baseImpl_
         return;
     }
 
+    const LatLng center = parameters.transformState.getLatLng(LatLng::Wrapped);
+    if (center != viewportCenter) {
+        viewportCenter = center;
+        tileLoader->invoke(&CustomTileLoader::setViewportCenter, center);
+    }
+
     tilePyramid.update(
         layers,
         needsRendering,
@@ -54,7 +62,8 @@ void RenderCustomGeometrySource::update(Immutable<style::Source::Impl> baseImpl_
                 tileID, impl().id, parameters, impl().getTileOptions(), *tileLoader);
         },
         baseImpl->getPrefetchZoomDelta(),
-        baseImpl->getMaxOverscaleFactorForParentTiles());
+        baseImpl->getMaxOverscaleFactorForParentTiles(),
+        baseImpl->getMaxTileCacheBytes());
 }
 
 } // namespace mbgl
@@ -17,6 +17,9 @@ public:
     
 private:
     const style::CustomGeometrySource::Impl& impl() const;
+
+    // The center last sent to the tile loader, which loads the tiles closest to it first.
+    optional<LatLng> viewportCenter;
 };
 
 } // namespace mbgl
@@ -3,9 +3,12 @@
 #include <mbgl/renderer/paint_parameters.hpp>
 #include <mbgl/tile/geojson_tile.hpp>
 #include <mbgl/renderer/tile_parameters.hpp>
+#include <mbgl/util/projection.hpp>
 
 #include <mapbox/eternal.hpp>
 
+#include <cmath>
+
 namespace mbgl {
 
 using namespace style;
@@ -66,6 +69,21 @@ MAPBOX_ETERNAL_CONSTEXPR const auto extensionGetters = mapbox::eternal::hash_map
     {"expansion-zoom", &getClusterExpansionZoom}
 });
 
+// Whether any of the bounds touches the tile, including its buffer of `buffer` pixels.
+bool tileIntersects(const CanonicalTileID& id, const std::vector<LatLngBounds>& bounds, uint16_t buffer) {
+    const double scale = std::pow(2.0, id.z);
+    const double margin = double(buffer) / util::tileSize;
+    for (const auto& box : bounds) {
+        const Point<double> nw = Projection::project(box.northwest(), scale) / double(util::tileSize);
+        const Point<double> se = Projection::project(box.southeast(), scale) / double(util::tileSize);
+        if (nw.x <= id.x + 1 + margin && se.x >= id.x - margin && nw.y <= id.y + 1 + margin &&
+            se.y >= id.y - margin) {
+            return true;
+        }
+    }
+    return false;
+}
+
 } // namespace
 
 RenderGeoJSONSource::RenderGeoJSONSource(Immutable<style::GeoJSONSource::Impl> impl_)
@@ -88,17 +106,25 @@ void RenderGeoJSONSource::update(Immutable<style::Source::Impl> baseImpl_,
     enabled = needsRendering;
 
     auto data_ = impl().getData().lock();
-    if (data.lock() != data_) {
+    auto previousData = data.lock();
+    if (previousData != data_) {
         data = data_;
         if (parameters.mode != MapMode::Continuous) {
             // Clearing the tile pyramid in order to avoid render tests being flaky.
             tilePyramid.clearAll();
         } else if (data_) {
+            // The cached tiles aren't updated.
             tilePyramid.reduceMemoryUse();
+            const auto& update = data_->getFeatureUpdate();
+            const bool partial = update && previousData && update->base == previousData.get() && !needsRelayout;
             const uint8_t maxZ = impl().getZoomRange().max;
             for (const auto& pair : tilePyramid.getTiles()) {
-                if (pair.first.canonical.z <= maxZ) {
-                    static_cast<GeoJSONTile*>(pair.second.get())->updateData(data_, needsRelayout);
+                auto* tile = static_cast<GeoJSONTile*>(pair.second.get());
+                if (pair.first.canonical.z > maxZ) continue;
+                if (partial && !tileIntersects(pair.first.canonical, update->changedBounds, impl().getOptions()->buffer)) {
+                    tile->replaceData(data_);
+                } else {
+                    tile->updateData(data_, needsRelayout);
                 }
             }
         }
@@ -119,7 +145,8 @@ void RenderGeoJSONSource::update(Immutable<style::Source::Impl> baseImpl_,
             return std::make_unique<GeoJSONTile>(tileID, impl().id, parameters, data_);
         },
         baseImpl->getPrefetchZoomDelta(),
-        baseImpl->getMaxOverscaleFactorForParentTiles());
+        baseImpl->getMaxOverscaleFactorForParentTiles(),
+        baseImpl->getMaxTileCacheBytes());
 }
 
 mapbox::util::variant<Value, FeatureCollection>
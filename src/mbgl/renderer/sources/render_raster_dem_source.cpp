@@ -38,7 +38,8 @@ void RenderRasterDEMSource::updateInternal(const Tileset& tileset,
         tileset.bounds,
         [&](const OverscaledTileID& tileID) { return std::make_unique<RasterDEMTile>(tileID, parameters, tileset); },
         baseImpl->getPrefetchZoomDelta(),
-        baseImpl->getMaxOverscaleFactorForParentTiles());
+        baseImpl->getMaxOverscaleFactorForParentTiles(),
+        baseImpl->getMaxTileCacheBytes());
     algorithm::updateTileMasks(tilePyramid.getRenderedTiles());
 }
 
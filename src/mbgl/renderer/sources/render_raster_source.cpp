@@ -36,7 +36,8 @@ void RenderRasterSource::updateInternal(const Tileset& tileset,
         tileset.bounds,
         [&](const OverscaledTileID& tileID) { return std::make_unique<RasterTile>(tileID, parameters, tileset); },
         baseImpl->getPrefetchZoomDelta(),
-        baseImpl->getMaxOverscaleFactorForParentTiles());
+        baseImpl->getMaxOverscaleFactorForParentTiles(),
+        baseImpl->getMaxTileCacheBytes());
     algorithm::updateTileMasks(tilePyramid.getRenderedTiles());
 }
 
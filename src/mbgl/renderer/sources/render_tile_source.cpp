@@ -1,5 +1,6 @@
 #include <mbgl/renderer/sources/render_tile_source.hpp>
 
+#include <mbgl/gfx/upload_pass.hpp>
 #include <mbgl/renderer/buckets/debug_bucket.hpp>
 #include <mbgl/renderer/render_tile.hpp>
 #include <mbgl/renderer/render_tree.hpp>
@@ -32,6 +33,9 @@ private:
 
 void TileSourceRenderItem::upload(gfx::UploadPass& parameters) const {
     for (auto& tile : *renderTiles) {
+        gfx::MemoryOwner owner = parameters.getMemoryOwner();
+        owner.tile = tile.getOverscaledTileID();
+        const auto memoryScope = parameters.createMemoryScope(std::move(owner));
         tile.upload(parameters);
     }
 }
@@ -54,6 +58,10 @@ bool RenderTileSource::isLoaded() const {
     return tilePyramid.isLoaded();
 }
 
+std::size_t RenderTileSource::getPendingTileCount() const {
+    return tilePyramid.getPendingTileCount();
+}
+
 std::unique_ptr<RenderItem> RenderTileSource::createRenderItem() {
     return std::make_unique<TileSourceRenderItem>(renderTiles, baseImpl->id);
 }
@@ -139,6 +147,10 @@ void RenderTileSource::setFeatureState(const optional<std::string>& sourceLayerI
     featureState.updateState(sourceLayerID, featureID, state);
 }
 
+void RenderTileSource::setFeatureStates(const std::vector<FeatureStateUpdate>& updates) {
+    featureState.updateStates(updates);
+}
+
 void RenderTileSource::getFeatureState(FeatureState& state, const optional<std::string>& sourceLayerID,
                                        const std::string& featureID) const {
     featureState.getState(state, sourceLayerID, featureID);
@@ -154,6 +166,14 @@ void RenderTileSource::reduceMemoryUse() {
     tilePyramid.reduceMemoryUse();
 }
 
+std::size_t RenderTileSource::getCacheBytes() const {
+    return tilePyramid.getCacheBytes();
+}
+
+void RenderTileSource::trimCache(std::size_t maxBytes) {
+    tilePyramid.trimCache(maxBytes);
+}
+
 void RenderTileSource::dumpDebugLogs() const {
     tilePyramid.dumpDebugLogs();
 }
@@ -15,6 +15,7 @@ public:
     ~RenderTileSource() override;
 
     bool isLoaded() const override;
+    std::size_t getPendingTileCount() const override;
 
     std::unique_ptr<RenderItem> createRenderItem() override;
     void prepare(const SourcePrepareParameters&) override;
@@ -36,6 +37,7 @@ public:
     querySourceFeatures(const SourceQueryOptions&) const override;
 
     void setFeatureState(const optional<std::string>&, const std::string&, const FeatureState&) override;
+    void setFeatureStates(const std::vector<FeatureStateUpdate>&) override;
 
     void getFeatureState(FeatureState& state, const optional<std::string>&, const std::string&) const override;
 
@@ -43,6 +45,8 @@ public:
                             const optional<std::string>&) override;
 
     void reduceMemoryUse() override;
+    std::size_t getCacheBytes() const override;
+    void trimCache(std::size_t maxBytes) override;
     void dumpDebugLogs() const override;
 
 protected:
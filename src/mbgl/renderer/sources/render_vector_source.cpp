@@ -34,7 +34,8 @@ void RenderVectorSource::updateInternal(const Tileset& tileset,
             return std::make_unique<VectorTile>(tileID, baseImpl->id, parameters, tileset);
         },
         baseImpl->getPrefetchZoomDelta(),
-        baseImpl->getMaxOverscaleFactorForParentTiles());
+        baseImpl->getMaxOverscaleFactorForParentTiles(),
+        baseImpl->getMaxTileCacheBytes());
 }
 
 } // namespace mbgl
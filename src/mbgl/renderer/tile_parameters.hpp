@@ -13,6 +13,7 @@ class FileSource;
 class AnnotationManager;
 class ImageManager;
 class GlyphManager;
+class UploadBudget;
 
 class TileParameters {
 public:
@@ -25,6 +26,10 @@ public:
     ImageManager& imageManager;
     GlyphManager& glyphManager;
     const uint8_t prefetchZoomDelta;
+    // The camera at the end of the running transition, if its tiles are to be prefetched.
+    const TransformState* transitionTarget;
+    // Limits the data of the tiles rendered for the first time in this frame, if set.
+    UploadBudget* uploadBudget;
 };
 
 } // namespace mbgl
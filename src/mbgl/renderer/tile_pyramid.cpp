@@ -2,6 +2,7 @@
 #include <mbgl/renderer/paint_parameters.hpp>
 #include <mbgl/renderer/render_source.hpp>
 #include <mbgl/renderer/tile_parameters.hpp>
+#include <mbgl/renderer/upload_budget.hpp>
 #include <mbgl/renderer/query.hpp>
 #include <mbgl/map/transform.hpp>
 #include <mbgl/math/clamp.hpp>
@@ -9,6 +10,7 @@
 #include <mbgl/util/tile_range.hpp>
 #include <mbgl/util/enum.hpp>
 #include <mbgl/util/logging.hpp>
+#include <mbgl/util/parallel_for.hpp>
 
 #include <mbgl/algorithm/update_renderables.hpp>
 
@@ -16,6 +18,8 @@
 
 #include <cmath>
 #include <algorithm>
+#include <limits>
+#include <unordered_set>
 
 namespace mbgl {
 
@@ -31,7 +35,11 @@ TilePyramid::~TilePyramid() = default;
 
 bool TilePyramid::isLoaded() const {
     for (const auto& pair : tiles) {
-        if (!pair.second->isComplete()) {
+        // Tiles at the transition target don't hold back the current frame.
+        if (!pair.second->isComplete() && !prefetchedTiles.count(pair.first)) {
+            return false;
+        }
+        if (pair.second->uploadDeferred) {
             return false;
         }
     }
@@ -39,6 +47,12 @@ bool TilePyramid::isLoaded() const {
     return true;
 }
 
+std::size_t TilePyramid::getPendingTileCount() const {
+    return std::count_if(tiles.begin(), tiles.end(), [&](const auto& pair) {
+        return (!pair.second->isComplete() && !prefetchedTiles.count(pair.first)) || pair.second->uploadDeferred;
+    });
+}
+
 Tile* TilePyramid::getTile(const OverscaledTileID& tileID) {
     auto it = tiles.find(tileID);
     return it == tiles.end() ? cache.get(tileID) : it->second.get();
@@ -59,23 +73,27 @@ void TilePyramid::update(const std::vector<Immutable<style::LayerProperties>>& l
                          optional<LatLngBounds> bounds,
                          std::function<std::unique_ptr<Tile>(const OverscaledTileID&)> createTile,
                          const optional<uint8_t>& sourcePrefetchZoomDelta,
-                         const optional<uint8_t>& maxParentTileOverscaleFactor) {
-    // If we need a relayout, abandon any cached tiles; they're now stale.
+                         const optional<uint8_t>& maxParentTileOverscaleFactor,
+                         const optional<uint64_t>& maxTileCacheBytes) {
+    // If we need a relayout, the cached tiles are stale. They keep their data, and are laid
+    // out again when they are taken out of the cache, so that switching between styles that
+    // share sources doesn't reload them.
     if (needsRelayout) {
-        cache.clear();
+        cache.markStale();
     }
 
     // If we're not going to render anything, move our existing tiles into
-    // the cache (if they're not stale) or abandon them, and return.
+    // the cache and return.
     if (!needsRendering) {
-        if (!needsRelayout) {
-            for (auto& entry : tiles) {
-                // These tiles are invisible, we set optional necessity
-                // for them and thus suppress network requests on
-                // tiles expiration (see `OnlineFileRequest`).
-                entry.second->setNecessity(TileNecessity::Optional);
-                cache.add(entry.first, std::move(entry.second));
-            }
+        for (auto& entry : tiles) {
+            // These tiles are invisible, we set optional necessity
+            // for them and thus suppress network requests on
+            // tiles expiration (see `OnlineFileRequest`).
+            entry.second->setNecessity(TileNecessity::Optional);
+            cache.add(entry.first, std::move(entry.second));
+        }
+        if (needsRelayout) {
+            cache.markStale();
         }
 
         tiles.clear();
@@ -93,13 +111,17 @@ void TilePyramid::update(const std::vector<Immutable<style::LayerProperties>>& l
 
     std::vector<OverscaledTileID> idealTiles;
     std::vector<OverscaledTileID> panTiles;
+    std::vector<OverscaledTileID> targetTiles;
 
     if (overscaledZoom >= zoomRange.min) {
         int32_t idealZoom = std::min<int32_t>(zoomRange.max, overscaledZoom);
 
 
-        // Make sure we're not reparsing overzoomed raster tiles.
-        if (type == SourceType::Raster) {
+        // Make sure we're not reparsing overzoomed raster tiles. Overzoomed raster and raster-dem
+        // tiles would only be copies of the tile at the maximum zoom level, each with its own
+        // texture, so that tile is rendered scaled up instead.
+        const bool reuseOverzoomed = type == SourceType::Raster || type == SourceType::RasterDEM;
+        if (reuseOverzoomed) {
             tileZoom = idealZoom;
         }
 
@@ -118,6 +140,19 @@ void TilePyramid::update(const std::vector<Immutable<style::LayerProperties>>& l
             }
         }
 
+        // Request the tiles at the destination of the running transition ahead of arrival. In still
+        // mode, this is the camera of the next still image, if the map was given one.
+        if (parameters.transitionTarget && type != style::SourceType::GeoJSON &&
+            type != style::SourceType::Annotations) {
+            const TransformState& target = *parameters.transitionTarget;
+            const int32_t targetOverscaledZoom = util::coveringZoomLevel(target.getZoom(), type, tileSize);
+            if (targetOverscaledZoom >= zoomRange.min) {
+                const int32_t targetIdealZoom = std::min<int32_t>(zoomRange.max, targetOverscaledZoom);
+                targetTiles = util::tileCover(
+                    target, targetIdealZoom, reuseOverzoomed ? targetIdealZoom : targetOverscaledZoom);
+            }
+        }
+
         idealTiles = util::tileCover(parameters.transformState, idealZoom, tileZoom);
     }
 
@@ -125,7 +160,7 @@ void TilePyramid::update(const std::vector<Immutable<style::LayerProperties>>& l
     // kinds of tiles we need: the ideal tiles determined by the tile cover. They may not yet be in
     // use because they're still loading. In addition to that, we also need to retain all tiles that
     // we're actively using, e.g. as a replacement for tile that aren't loaded yet.
-    std::set<OverscaledTileID> retain;
+    std::unordered_set<OverscaledTileID> retain;
 
     auto retainTileFn = [&](Tile& tile, TileNecessity necessity) -> void {
         if (retain.emplace(tile.id).second) {
@@ -153,7 +188,12 @@ void TilePyramid::update(const std::vector<Immutable<style::LayerProperties>>& l
         if (tileRange && !tileRange->contains(tileID.canonical)) {
             return nullptr;
         }
+        // In a relayout, all the retained tiles get the current layers anyway.
+        const bool stale = !needsRelayout && cache.isStale(tileID);
         std::unique_ptr<Tile> tile = cache.pop(tileID);
+        if (tile && stale) {
+            tile->setLayers(layers);
+        }
         if (!tile) {
             tile = createTile(tileID);
             if (tile) {
@@ -173,8 +213,29 @@ void TilePyramid::update(const std::vector<Immutable<style::LayerProperties>>& l
         addRenderTile(tileID, tile);
         previouslyRenderedTiles.erase(tileID); // Still rendering this tile, no need for special fading logic.
         tile.markRenderedIdeal();
+        tile.wasRendered = true;
     };
 
+    // Tiles that are about to be rendered for the first time take their data from the upload
+    // budget of the frame, ideal tiles first. The tiles that don't fit wait for a later frame,
+    // and their parents or children are rendered in their place.
+    std::vector<Tile*> firstRenders;
+    for (auto& pair : tiles) {
+        Tile& tile = *pair.second;
+        tile.uploadDeferred = false;
+        if (parameters.uploadBudget && tile.isRenderable() && !tile.wasRendered) {
+            firstRenders.push_back(&tile);
+        }
+    }
+    // The tiles map is unordered. Sorting keeps the same tiles getting the budget from run to run.
+    std::sort(firstRenders.begin(), firstRenders.end(), [](const Tile* a, const Tile* b) { return a->id < b->id; });
+    std::stable_partition(firstRenders.begin(), firstRenders.end(), [&](const Tile* tile) {
+        return std::find(idealTiles.begin(), idealTiles.end(), tile->id) != idealTiles.end();
+    });
+    for (Tile* tile : firstRenders) {
+        tile->uploadDeferred = !parameters.uploadBudget->take(tile->getMemoryUsage());
+    }
+
     renderedTiles.clear();
 
     if (!panTiles.empty()) {
@@ -191,6 +252,22 @@ void TilePyramid::update(const std::vector<Immutable<style::LayerProperties>>& l
     algorithm::updateRenderables(
         getTileFn, createTileFn, retainTileFn, renderTileFn, idealTiles, zoomRange, maxParentTileOverscaleFactor);
 
+    // The destination tiles are loaded, but not rendered before the camera gets there.
+    prefetchedTiles.clear();
+    for (const auto& tileID : targetTiles) {
+        if (retain.count(tileID)) {
+            continue;
+        }
+        Tile* tile = getTileFn(tileID);
+        if (!tile) {
+            tile = createTileFn(tileID);
+        }
+        if (tile) {
+            retainTileFn(*tile, TileNecessity::Required);
+            prefetchedTiles.insert(tileID);
+        }
+    }
+
     for (auto previouslyRenderedTile : previouslyRenderedTiles) {
         Tile& tile = previouslyRenderedTile.second;
         tile.markRenderedPreviously();
@@ -209,30 +286,48 @@ void TilePyramid::update(const std::vector<Immutable<style::LayerProperties>>& l
             (parameters.transformState.getMaxZoom() - parameters.transformState.getMinZoom() + 1) * 0.5;
         cache.setSize(conservativeCacheSize);
     }
+    cache.setMaxBytes(maxTileCacheBytes ? optional<size_t>(static_cast<size_t>(*maxTileCacheBytes)) : nullopt);
 
-    // Remove stale tiles. This goes through the (sorted!) tiles map and retain set in lockstep
-    // and removes items from tiles that don't have the corresponding key in the retain set.
-    {
-        auto tilesIt = tiles.begin();
-        auto retainIt = retain.begin();
-        while (tilesIt != tiles.end()) {
-            if (retainIt == retain.end() || tilesIt->first < *retainIt) {
-                if (!needsRelayout) {
-                    tilesIt->second->setNecessity(TileNecessity::Optional);
-                    cache.add(tilesIt->first, std::move(tilesIt->second));
-                }
-                tiles.erase(tilesIt++);
-            } else {
-                if (!(*retainIt < tilesIt->first)) {
-                    ++tilesIt;
-                }
-                ++retainIt;
-            }
+    // Remove stale tiles.
+    for (auto it = tiles.begin(); it != tiles.end();) {
+        if (retain.count(it->first)) {
+            ++it;
+            continue;
         }
+        it->second->setNecessity(TileNecessity::Optional);
+        it->second->uploadDeferred = false;
+        cache.add(it->first, std::move(it->second));
+        it = tiles.erase(it);
+    }
+
+    if (needsRelayout) {
+        // The tiles that just went into the cache didn't get the current layers either.
+        cache.markStale();
     }
 
     for (auto& pair : tiles) {
         pair.second->setShowCollisionBoxes(parameters.debugOptions & MapDebugOptions::Collision);
+        // Tiles that left the cover go behind all the others, instead of keeping their old rank.
+        pair.second->setRequestOrder(std::numeric_limits<uint32_t>::max());
+    }
+
+    // The destination tiles wait for all the tiles needed for the current frame.
+    for (std::size_t i = 0; i < targetTiles.size(); ++i) {
+        auto it = tiles.find(targetTiles[i]);
+        if (it != tiles.end()) {
+            it->second->setRequestOrder(static_cast<uint32_t>(i));
+            it->second->setRequestPriority(Resource::Priority::Low);
+        }
+    }
+
+    // The cover is sorted by the distance from the center of the viewport, so that the closest
+    // tiles get their data first, even when requests for tiles from earlier frames still wait.
+    for (std::size_t i = 0; i < idealTiles.size(); ++i) {
+        auto it = tiles.find(idealTiles[i]);
+        if (it != tiles.end()) {
+            it->second->setRequestOrder(static_cast<uint32_t>(i));
+            it->second->setRequestPriority(Resource::Priority::Regular);
+        }
     }
 
     // Initialize renderable tiles and update the contained layer render data.
@@ -275,7 +370,8 @@ void TilePyramid::handleWrapJump(float lng) {
     prevLng = lng;
 
     if (wrapDelta) {
-        std::map<OverscaledTileID, std::unique_ptr<Tile>> newTiles;
+        std::unordered_map<OverscaledTileID, std::unique_ptr<Tile>> newTiles;
+        newTiles.reserve(tiles.size());
         std::map<UnwrappedTileID, std::reference_wrapper<Tile>> newRenderTiles;
         for (auto& tile : tiles) {
             auto newID = tile.second->id.unwrapTo(tile.second->id.wrap + wrapDelta);
@@ -320,6 +416,7 @@ std::unordered_map<std::string, std::vector<Feature>> TilePyramid::queryRendered
 
     auto maxPitchScaleFactor = transformState.maxPitchScaleFactor();
 
+    std::vector<std::pair<std::reference_wrapper<Tile>, GeometryCoordinates>> queriedTiles;
     for (const auto& entry : sortedTiles) {
         const UnwrappedTileID& id = entry.first;
         Tile& tile = entry.second;
@@ -343,18 +440,68 @@ std::unordered_map<std::string, std::vector<Feature>> TilePyramid::queryRendered
             tileSpaceQueryGeometry.push_back(TileCoordinate::toGeometryCoordinate(id, c));
         }
 
-        tile.queryRenderedFeatures(result, tileSpaceQueryGeometry, transformState, layers, options, projMatrix,
-                                   featureState);
+        queriedTiles.emplace_back(tile, std::move(tileSpaceQueryGeometry));
     }
 
+    const auto queryTile = [&](std::size_t index, std::unordered_map<std::string, std::vector<Feature>>& tileResult) {
+        Tile& tile = queriedTiles[index].first;
+        tile.queryRenderedFeatures(
+            tileResult, queriedTiles[index].second, transformState, layers, options, projMatrix, featureState);
+    };
+
+    if (queriedTiles.size() < 2u) {
+        for (std::size_t i = 0u; i < queriedTiles.size(); ++i) {
+            queryTile(i, result);
+        }
+        return result;
+    }
+
+    // Tiles don't share any data, so they are queried concurrently. Their results are appended in
+    // the order of the tiles, which gives the same results as querying them one after the other.
+    std::vector<std::unordered_map<std::string, std::vector<Feature>>> tileResults(queriedTiles.size());
+    util::parallelFor(queriedTiles.size(), TaskTag::Query, TaskPriority::Default, [&](std::size_t index) {
+        queryTile(index, tileResults[index]);
+    });
+
+    for (auto& tileResult : tileResults) {
+        for (auto& layerResult : tileResult) {
+            auto& features = result[layerResult.first];
+            std::move(layerResult.second.begin(), layerResult.second.end(), std::back_inserter(features));
+            if (options.limit && features.size() > *options.limit) {
+                features.erase(features.begin() + *options.limit, features.end());
+            }
+        }
+    }
     return result;
 }
 
 std::vector<Feature> TilePyramid::querySourceFeatures(const SourceQueryOptions& options) const {
     std::vector<Feature> result;
 
+    // In tile id order, so that deduplication keeps the same copy of a feature every time.
+    std::vector<std::pair<OverscaledTileID, const Tile*>> sortedTiles;
+    sortedTiles.reserve(tiles.size());
     for (const auto& pair : tiles) {
+        if (options.bounds && !options.bounds->intersects(LatLngBounds(pair.first.canonical))) {
+            continue;
+        }
+        sortedTiles.emplace_back(pair.first, pair.second.get());
+    }
+    std::sort(sortedTiles.begin(), sortedTiles.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    std::unordered_set<std::string> seenIDs;
+    for (const auto& pair : sortedTiles) {
+        const std::size_t begin = result.size();
         pair.second->querySourceFeatures(result, options);
+        if (!options.deduplicate) {
+            continue;
+        }
+        // Features without an id are all kept.
+        auto end = std::remove_if(result.begin() + begin, result.end(), [&](const Feature& feature) {
+            optional<std::string> featureID = featureIDtoString(feature.id);
+            return featureID && !seenIDs.insert(feature.sourceLayer + '\0' + *featureID).second;
+        });
+        result.erase(end, result.end());
     }
 
     return result;
@@ -368,6 +515,10 @@ void TilePyramid::reduceMemoryUse() {
     cache.clear();
 }
 
+void TilePyramid::trimCache(size_t maxBytes) {
+    cache.trim(maxBytes);
+}
+
 void TilePyramid::setObserver(TileObserver* observer_) {
     observer = observer_;
 }
@@ -382,6 +533,7 @@ void TilePyramid::clearAll() {
     fadingTiles = false;
     tiles.clear();
     renderedTiles.clear();
+    prefetchedTiles.clear();
     cache.clear();
 }
 
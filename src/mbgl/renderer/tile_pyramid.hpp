@@ -13,6 +13,7 @@
 
 #include <memory>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 #include <map>
 
@@ -32,6 +33,8 @@ public:
     ~TilePyramid();
 
     bool isLoaded() const;
+    // The tiles that keep the pyramid from being loaded.
+    std::size_t getPendingTileCount() const;
 
     void update(const std::vector<Immutable<style::LayerProperties>>& visibleLayers,
                 bool needsRendering,
@@ -43,7 +46,8 @@ public:
                 optional<LatLngBounds> bounds,
                 std::function<std::unique_ptr<Tile>(const OverscaledTileID&)> createTile,
                 const optional<uint8_t>& sourcePrefetchZoomDelta,
-                const optional<uint8_t>& maxParentTileOverscaleFactor);
+                const optional<uint8_t>& maxParentTileOverscaleFactor,
+                const optional<uint64_t>& maxTileCacheBytes = nullopt);
 
     const std::map<UnwrappedTileID, std::reference_wrapper<Tile>>& getRenderedTiles() const { return renderedTiles; }
     Tile* getTile(const OverscaledTileID&);
@@ -60,11 +64,13 @@ public:
 
     void setCacheSize(size_t);
     void reduceMemoryUse();
+    size_t getCacheBytes() const { return cache.getBytes(); }
+    void trimCache(size_t maxBytes);
 
     void setObserver(TileObserver*);
     void dumpDebugLogs() const;
 
-    const std::map<OverscaledTileID, std::unique_ptr<Tile>>& getTiles() const { return tiles; }
+    const std::unordered_map<OverscaledTileID, std::unique_ptr<Tile>>& getTiles() const { return tiles; }
     void clearAll();
 
     void updateFadingTiles();
@@ -73,10 +79,12 @@ public:
 private:
     void addRenderTile(const UnwrappedTileID& tileID, Tile& tile);
 
-    std::map<OverscaledTileID, std::unique_ptr<Tile>> tiles;
+    // Looked up for every tile of the cover and their parents and children on every update.
+    std::unordered_map<OverscaledTileID, std::unique_ptr<Tile>> tiles;
     TileCache cache;
 
     std::map<UnwrappedTileID, std::reference_wrapper<Tile>> renderedTiles; // Sorted by tile id.
+    std::unordered_set<OverscaledTileID> prefetchedTiles; // Only needed for the transition target.
     TileObserver* observer = nullptr;
 
     float prevLng = 0;
@@ -1,4 +1,6 @@
 #include <mbgl/renderer/tile_render_data.hpp>
+#include <mbgl/renderer/dynamic_image_atlas.hpp>
+#include <mbgl/text/dynamic_glyph_atlas.hpp>
 
 namespace mbgl {
 
@@ -12,14 +14,16 @@ TileRenderData::~TileRenderData() = default;
 
 const gfx::Texture& TileRenderData::getGlyphAtlasTexture() const {
     assert(atlasTextures);
-    assert(atlasTextures->glyph);
-    return *atlasTextures->glyph;
+    assert(atlasTextures->glyphAtlas);
+    assert(atlasTextures->glyphAtlas->getTexture());
+    return *atlasTextures->glyphAtlas->getTexture();
 }
 
 const gfx::Texture& TileRenderData::getIconAtlasTexture() const {
     assert(atlasTextures);
-    assert(atlasTextures->icon);
-    return *atlasTextures->icon;
+    assert(atlasTextures->imageAtlas);
+    assert(atlasTextures->imageAtlas->getTexture());
+    return *atlasTextures->imageAtlas->getTexture();
 }
 
 optional<ImagePosition> TileRenderData::getPattern(const std::string&) const {
@@ -13,13 +13,15 @@ class UploadPass;
 } // namespace gfx
 
 class Bucket;
+class DynamicGlyphAtlas;
+class DynamicImageAtlas;
 class LayerRenderData;
 class SourcePrepareParameters;
 
 class TileAtlasTextures {
-public:    
-    optional<gfx::Texture> glyph;
-    optional<gfx::Texture> icon;
+public:
+    std::shared_ptr<DynamicGlyphAtlas> glyphAtlas;
+    std::shared_ptr<DynamicImageAtlas> imageAtlas;
 };
 
 class TileRenderData {
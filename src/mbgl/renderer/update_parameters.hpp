@@ -39,6 +39,8 @@ public:
     std::shared_ptr<FileSource> fileSource;
 
     const uint8_t prefetchZoomDelta;
+    // The camera at the end of the running transition, whose tiles are requested ahead of arrival.
+    const optional<TransformState> transitionTarget;
     
     // For still image requests, render requested
     const bool stillImageRequest;
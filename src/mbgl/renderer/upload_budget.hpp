@@ -0,0 +1,34 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+
+namespace mbgl {
+
+// The bytes that tiles rendered for the first time may upload to the GPU in a frame. The first
+// tile of a frame always fits, so that tiles larger than the budget still get rendered.
+class UploadBudget {
+public:
+    explicit UploadBudget(std::size_t bytes_) : bytes(bytes_) {}
+
+    // Takes the given bytes from the budget, or returns false if they don't fit anymore.
+    bool take(std::size_t size) {
+        if (taken && size > bytes) {
+            exceeded = true;
+            return false;
+        }
+        bytes -= std::min(size, bytes);
+        taken = true;
+        return true;
+    }
+
+    // Whether uploads were left for a later frame.
+    bool isExceeded() const { return exceeded; }
+
+private:
+    std::size_t bytes;
+    bool taken = false;
+    bool exceeded = false;
+};
+
+} // namespace mbgl
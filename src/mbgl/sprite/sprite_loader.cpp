@@ -101,7 +101,7 @@ void SpriteLoader::emitSpriteLoadedIfComplete() {
         observer->onSpriteLoaded(std::move(result.images));
     };
 
-    threadPool->scheduleAndReplyValue(parseClosure, resultClosure);
+    threadPool->scheduleAndReplyValue(TaskTag::Sprite, parseClosure, resultClosure);
 }
 
 void SpriteLoader::setObserver(SpriteLoaderObserver* observer_) {
@@ -15,6 +15,35 @@
 
 namespace mbgl {
 
+namespace {
+
+bool validateMetrics(const Size& sheetSize,
+                     const int32_t srcX,
+                     const int32_t srcY,
+                     const int32_t width,
+                     const int32_t height,
+                     const double ratio) {
+    // Disallow invalid parameter configurations.
+    if (width <= 0 || height <= 0 || width > 1024 || height > 1024 || ratio <= 0 || ratio > 10 || srcX < 0 ||
+        srcY < 0 || srcX >= static_cast<int32_t>(sheetSize.width) || srcY >= static_cast<int32_t>(sheetSize.height) ||
+        srcX + width > static_cast<int32_t>(sheetSize.width) ||
+        srcY + height > static_cast<int32_t>(sheetSize.height)) {
+        Log::Error(Event::Sprite,
+                   "Can't create image with invalid metrics: %dx%d@%d,%d in %ux%u@%sx sprite",
+                   width,
+                   height,
+                   srcX,
+                   srcY,
+                   sheetSize.width,
+                   sheetSize.height,
+                   util::toString(ratio).c_str());
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
 std::unique_ptr<style::Image> createStyleImage(const std::string& id,
                                                const PremultipliedImage& image,
                                                const int32_t srcX,
@@ -26,20 +55,7 @@ std::unique_ptr<style::Image> createStyleImage(const std::string& id,
                                                style::ImageStretches&& stretchX,
                                                style::ImageStretches&& stretchY,
                                                const optional<style::ImageContent>& content) {
-    // Disallow invalid parameter configurations.
-    if (width <= 0 || height <= 0 || width > 1024 || height > 1024 || ratio <= 0 || ratio > 10 || srcX < 0 ||
-        srcY < 0 || srcX >= static_cast<int32_t>(image.size.width) || srcY >= static_cast<int32_t>(image.size.height) ||
-        srcX + width > static_cast<int32_t>(image.size.width) ||
-        srcY + height > static_cast<int32_t>(image.size.height)) {
-        Log::Error(Event::Sprite,
-                   "Can't create image with invalid metrics: %dx%d@%d,%d in %ux%u@%sx sprite",
-                   width,
-                   height,
-                   srcX,
-                   srcY,
-                   image.size.width,
-                   image.size.height,
-                   util::toString(ratio).c_str());
+    if (!validateMetrics(image.size, srcX, srcY, width, height, ratio)) {
         return nullptr;
     }
 
@@ -153,7 +169,8 @@ optional<style::ImageContent> getContent(const JSValue& value, const char* prope
 } // namespace
 
 std::vector<Immutable<style::Image::Impl>> parseSprite(const std::string& encodedImage, const std::string& json) {
-    const PremultipliedImage raster = decodeImage(encodedImage);
+    // The images share the sheet until they are used.
+    const auto sheet = std::make_shared<const PremultipliedImage>(decodeImage(encodedImage));
 
     JSDocument doc;
     doc.Parse<0>(json.c_str());
@@ -183,10 +200,21 @@ std::vector<Immutable<style::Image::Impl>> parseSprite(const std::string& encode
             style::ImageStretches stretchY = getStretches(value, "stretchY", name.c_str());
             optional<style::ImageContent> content = getContent(value, "content", name.c_str());
 
-            auto image = createStyleImage(
-                name, raster, x, y, width, height, pixelRatio, sdf, std::move(stretchX), std::move(stretchY), content);
-            if (image) {
-                images.push_back(std::move(image->baseImpl));
+            if (!validateMetrics(sheet->size, x, y, width, height, pixelRatio)) {
+                continue;
+            }
+            try {
+                images.push_back(makeMutable<style::Image::Impl>(name,
+                                                                 sheet,
+                                                                 Point<uint32_t>(x, y),
+                                                                 Size(width, height),
+                                                                 pixelRatio,
+                                                                 sdf,
+                                                                 std::move(stretchX),
+                                                                 std::move(stretchY),
+                                                                 content));
+            } catch (const util::StyleImageException& ex) {
+                Log::Error(Event::Sprite, "Can't create image with invalid metadata: %s", ex.what());
             }
         }
     }
@@ -1,6 +1,9 @@
 #pragma once
 
 #include <mbgl/storage/file_source.hpp>
+#include <mbgl/storage/response.hpp>
+
+#include <functional>
 
 namespace mbgl {
 
@@ -9,15 +12,23 @@ class ResourceOptions;
 
 class MainResourceLoader final : public FileSource {
 public:
+    // Called on the loader thread with the timing of each response that carries one, before
+    // the response is passed on to the requester.
+    using TimingObserver = std::function<void(const Resource&, const Response::Timing&)>;
+
     explicit MainResourceLoader(const ResourceOptions& options);
     ~MainResourceLoader() override;
 
     bool supportsCacheOnlyRequests() const override;
     std::unique_ptr<AsyncRequest> request(const Resource&, Callback) override;
     bool canRequest(const Resource&) const override;
+    void setProperty(const std::string&, const mapbox::base::Value&) override;
+    mapbox::base::Value getProperty(const std::string&) const override;
     void pause() override;
     void resume() override;
 
+    void setTimingObserver(TimingObserver);
+
 private:
     class Impl;
     const std::unique_ptr<Impl> impl;
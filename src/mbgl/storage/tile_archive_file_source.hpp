@@ -0,0 +1,34 @@
+#pragma once
+
+#include <mbgl/storage/file_source.hpp>
+
+namespace mbgl {
+
+namespace util {
+template <typename T> class Thread;
+} // namespace util
+
+/**
+ * @brief Serves tiles straight from single-file PMTiles (version 3) archives.
+ *
+ * A source URL like `pmtiles:///path/to/archive.pmtiles` resolves to a TileJSON built from the
+ * archive header and metadata, whose tile URLs refer back to the archive. Archives are
+ * memory-mapped and stay open for the lifetime of the file source, so a tile request only
+ * looks up the directories and copies the tile data out of the mapping.
+ */
+class TileArchiveFileSource : public FileSource {
+public:
+    TileArchiveFileSource();
+    ~TileArchiveFileSource() override;
+
+    std::unique_ptr<AsyncRequest> request(const Resource&, Callback) override;
+    bool canRequest(const Resource&) const override;
+    void pause() override;
+    void resume() override;
+
+private:
+    class Impl;
+    std::unique_ptr<util::Thread<Impl>> impl;
+};
+
+} // namespace mbgl
@@ -40,6 +40,8 @@ public:
     auto end() const { return wrappers.end(); }
 
     void clear();
+    // Empties the collection and hands its elements, in order, to the caller.
+    WrapperVector release();
 
 protected:
     std::size_t index(const std::string&) const;
@@ -140,6 +142,17 @@ void CollectionBase<T>::clear() {
     wrappers.clear();
 }
 
+template <class T>
+typename CollectionBase<T>::WrapperVector CollectionBase<T>::release() {
+    mutate(impls, [&] (auto& impls_) {
+        impls_.clear();
+    });
+
+    WrapperVector result;
+    result.swap(wrappers);
+    return result;
+}
+
 template <class T>
 T* CollectionBase<T>::add(std::size_t wrapperIndex, std::size_t implIndex, std::unique_ptr<T> wrapper) {
     assert(wrapperIndex <= size());
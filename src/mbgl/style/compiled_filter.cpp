@@ -0,0 +1,386 @@
+#include <mbgl/style/compiled_filter.hpp>
+#include <mbgl/style/expression/literal.hpp>
+#include <mbgl/style/expression/match.hpp>
+#include <mbgl/tile/geometry_tile_data.hpp>
+
+#include <cassert>
+
+namespace mbgl {
+namespace style {
+
+using namespace expression;
+
+namespace {
+
+std::vector<const Expression*> getChildren(const Expression& expression) {
+    std::vector<const Expression*> children;
+    expression.eachChild([&](const Expression& child) { children.push_back(&child); });
+    return children;
+}
+
+optional<Value> getLiteral(const Expression& expression) {
+    if (expression.getKind() != Kind::Literal) return nullopt;
+    return static_cast<const Literal&>(expression).getValue();
+}
+
+optional<std::string> getLiteralString(const Expression& expression) {
+    auto value = getLiteral(expression);
+    if (!value || !value->is<std::string>()) return nullopt;
+    return value->get<std::string>();
+}
+
+bool isCompound(const Expression& expression, const char* op, std::size_t childCount) {
+    return expression.getKind() == Kind::CompoundExpression && expression.getOperator() == op &&
+           getChildren(expression).size() == childCount;
+}
+
+// Returns the key of a ["get", key] expression that reads a feature property.
+optional<std::string> getPropertyKey(const Expression& expression) {
+    if (!isCompound(expression, "get", 1u)) return nullopt;
+    return getLiteralString(*getChildren(expression).front());
+}
+
+bool isGeometryType(const Expression& expression) {
+    return isCompound(expression, "geometry-type", 0u);
+}
+
+uint8_t typeBit(FeatureType type) {
+    const auto index = static_cast<uint8_t>(type);
+    return index < 8u ? static_cast<uint8_t>(1u << index) : 0u;
+}
+
+// Matches the type names used by `geometry-type` and the legacy `$type` filters.
+uint8_t typeBit(const std::string& name) {
+    if (name == "Point") return typeBit(FeatureType::Point);
+    if (name == "LineString") return typeBit(FeatureType::LineString);
+    if (name == "Polygon") return typeBit(FeatureType::Polygon);
+    if (name == "Unknown") return typeBit(FeatureType::Unknown);
+    return 0u;
+}
+
+const uint8_t allTypes = typeBit(FeatureType::Unknown) | typeBit(FeatureType::Point) |
+                         typeBit(FeatureType::LineString) | typeBit(FeatureType::Polygon);
+
+bool equals(const mbgl::Value& property, const Value& literal) {
+    // Avoid copying string properties, which are by far the most common in filters.
+    if (property.is<std::string>()) {
+        return literal.is<std::string>() && property.get<std::string>() == literal.get<std::string>();
+    }
+    return toExpressionValue(property) == literal;
+}
+
+Value idAsExpressionValue(const FeatureIdentifier& id) {
+    return id.match([](const NullValue&) -> Value { return Null; },
+                    [](const auto& value) { return toExpressionValue(mbgl::Value(value)); });
+}
+
+} // namespace
+
+CompiledFilter::CompiledFilter(std::shared_ptr<const Expression> root_) : root(std::move(root_)) {}
+
+std::unique_ptr<const CompiledFilter> CompiledFilter::compile(std::shared_ptr<const Expression> expression) {
+    if (!expression) return nullptr;
+    std::unique_ptr<CompiledFilter> compiled(new CompiledFilter(std::move(expression)));
+    compiled->compileNode(*compiled->root);
+    if (compiled->program.size() == 1u && compiled->program.front().op == Op::Interpret) {
+        return nullptr;
+    }
+    return std::move(compiled);
+}
+
+CompiledFilter::Instruction& CompiledFilter::emit(Op op) {
+    program.emplace_back();
+    program.back().op = op;
+    return program.back();
+}
+
+void CompiledFilter::compileNode(const Expression& expression) {
+    const auto children = getChildren(expression);
+
+    switch (expression.getKind()) {
+    case Kind::Literal: {
+        auto value = getLiteral(expression);
+        if (value->is<bool>()) {
+            emit(Op::Constant).result = value->get<bool>();
+            return;
+        }
+        break;
+    }
+
+    case Kind::All:
+    case Kind::Any: {
+        const std::size_t index = program.size();
+        emit(expression.getKind() == Kind::All ? Op::All : Op::Any);
+        for (const Expression* child : children) {
+            compileNode(*child);
+        }
+        program[index].size = program.size() - index;
+        return;
+    }
+
+    case Kind::CompoundExpression: {
+        const std::string op = expression.getOperator();
+
+        if (op == "!" && children.size() == 1u) {
+            const std::size_t index = program.size();
+            emit(Op::Not);
+            compileNode(*children.front());
+            program[index].size = program.size() - index;
+            return;
+        }
+
+        if (op == "has" && children.size() == 1u) {
+            if (auto key = getLiteralString(*children.front())) {
+                auto& instruction = emit(Op::Has);
+                instruction.key = std::move(*key);
+                instruction.needsFeature = true;
+                return;
+            }
+        }
+
+        // Legacy filters, see conversion/filter.cpp. Their arguments are always literals.
+        if ((op == "filter-==" || op == "filter-in") && children.size() >= 2u) {
+            if (auto key = getLiteralString(*children.front())) {
+                std::vector<Value> values;
+                for (std::size_t i = 1; i < children.size(); ++i) {
+                    auto value = getLiteral(*children[i]);
+                    if (!value) break;
+                    values.push_back(std::move(*value));
+                }
+                if (values.size() + 1u == children.size()) {
+                    auto& instruction = emit(Op::PropertyIn);
+                    instruction.key = std::move(*key);
+                    instruction.values = std::move(values);
+                    return;
+                }
+            }
+        }
+
+        if (op == "filter-type-==" || op == "filter-type-in") {
+            uint8_t types = 0u;
+            bool literals = true;
+            for (const Expression* child : children) {
+                auto name = getLiteralString(*child);
+                if (!name) {
+                    literals = false;
+                    break;
+                }
+                types |= typeBit(*name);
+            }
+            if (literals) {
+                emit(Op::TypeIn).types = types;
+                return;
+            }
+        }
+
+        if (op == "filter-id-==" || op == "filter-id-in") {
+            std::vector<Value> values;
+            for (const Expression* child : children) {
+                auto value = getLiteral(*child);
+                if (!value) break;
+                values.push_back(std::move(*value));
+            }
+            if (values.size() == children.size()) {
+                emit(Op::IdIn).values = std::move(values);
+                return;
+            }
+        }
+
+        if (op == "filter-has" && children.size() == 1u) {
+            if (auto key = getLiteralString(*children.front())) {
+                emit(Op::Has).key = std::move(*key);
+                return;
+            }
+        }
+
+        if (op == "filter-has-id" && children.empty()) {
+            emit(Op::HasId);
+            return;
+        }
+        break;
+    }
+
+    case Kind::Comparison: {
+        const std::string op = expression.getOperator();
+        // Collator comparisons have a third child and are left to the interpreter.
+        if ((op == "==" || op == "!=") && children.size() == 2u) {
+            const Expression* input = children[0];
+            optional<Value> literal = getLiteral(*children[1]);
+            if (!literal) {
+                input = children[1];
+                literal = getLiteral(*children[0]);
+            }
+            if (!literal) break;
+
+            if (isGeometryType(*input)) {
+                const uint8_t types = literal->is<std::string>() ? typeBit(literal->get<std::string>()) : 0u;
+                auto& instruction = emit(Op::TypeIn);
+                instruction.types = op == "==" ? types : static_cast<uint8_t>(allTypes & ~types);
+                instruction.needsFeature = true;
+                return;
+            }
+
+            if (auto key = getPropertyKey(*input)) {
+                auto& instruction = emit(Op::PropertyIn);
+                instruction.key = std::move(*key);
+                instruction.values.push_back(std::move(*literal));
+                instruction.negated = op == "!=";
+                instruction.missingIsNull = true;
+                instruction.needsFeature = true;
+                return;
+            }
+        }
+        break;
+    }
+
+    case Kind::Match: {
+        // Only matches with string labels and literal boolean outputs are compiled.
+        const Match<std::string>* stringMatch = asStringMatch(expression);
+        if (!stringMatch) break;
+
+        const auto& match = *stringMatch;
+        const Expression& input = *children.front();
+        optional<bool> otherwise;
+        if (auto value = getLiteral(*children.back())) {
+            if (value->is<bool>()) otherwise = value->get<bool>();
+        }
+        if (!otherwise) break;
+
+        std::unordered_map<std::string, bool> labels;
+        for (const auto& branch : match.getBranches()) {
+            auto value = getLiteral(*branch.second);
+            if (!value || !value->is<bool>()) break;
+            labels.emplace(branch.first, value->get<bool>());
+        }
+        if (labels.size() != match.getBranches().size()) break;
+
+        if (isGeometryType(input)) {
+            uint8_t types = *otherwise ? allTypes : 0u;
+            for (const auto& label : labels) {
+                const uint8_t bit = typeBit(label.first);
+                types = static_cast<uint8_t>(label.second ? (types | bit) : (types & ~bit));
+            }
+            auto& instruction = emit(Op::TypeIn);
+            instruction.types = types;
+            instruction.needsFeature = true;
+            return;
+        }
+
+        if (auto key = getPropertyKey(input)) {
+            auto& instruction = emit(Op::Match);
+            instruction.key = std::move(*key);
+            instruction.labels = std::move(labels);
+            instruction.result = *otherwise;
+            instruction.needsFeature = true;
+            return;
+        }
+        break;
+    }
+
+    default:
+        break;
+    }
+
+    emit(Op::Interpret).expression = &expression;
+}
+
+bool CompiledFilter::operator()(const EvaluationContext& context) const {
+    assert(!program.empty());
+    return evaluate(0u, context) == Result::True;
+}
+
+CompiledFilter::Result CompiledFilter::evaluate(std::size_t index, const EvaluationContext& context) const {
+    const Instruction& instruction = program[index];
+    const GeometryTileFeature* feature = context.feature;
+
+    if (instruction.op != Op::Constant && instruction.op != Op::Not && instruction.op != Op::All &&
+        instruction.op != Op::Any && instruction.op != Op::Interpret && !feature) {
+        return instruction.needsFeature ? Result::Error : Result::False;
+    }
+
+    switch (instruction.op) {
+    case Op::Constant:
+        return instruction.result ? Result::True : Result::False;
+
+    case Op::Not: {
+        const Result result = evaluate(index + 1, context);
+        if (result == Result::Error) return result;
+        return result == Result::True ? Result::False : Result::True;
+    }
+
+    case Op::All:
+    case Op::Any: {
+        // All stops at the first false child, Any at the first true one; both stop at an error.
+        const Result stop = instruction.op == Op::All ? Result::False : Result::True;
+        const std::size_t end = index + instruction.size;
+        for (std::size_t child = index + 1; child < end; child += program[child].size) {
+            const Result result = evaluate(child, context);
+            if (result == Result::Error || result == stop) return result;
+        }
+        return instruction.op == Op::All ? Result::True : Result::False;
+    }
+
+    case Op::TypeIn:
+        return (instruction.types & typeBit(feature->getType())) ? Result::True : Result::False;
+
+    case Op::PropertyIn: {
+        const optional<mbgl::Value> property = feature->getValue(instruction.key);
+        bool found = false;
+        if (property) {
+            for (const Value& value : instruction.values) {
+                if (equals(*property, value)) {
+                    found = true;
+                    break;
+                }
+            }
+        } else if (instruction.missingIsNull) {
+            for (const Value& value : instruction.values) {
+                if (value.is<NullValue>()) {
+                    found = true;
+                    break;
+                }
+            }
+        } else {
+            return Result::False;
+        }
+        return found != instruction.negated ? Result::True : Result::False;
+    }
+
+    case Op::Has:
+        return feature->getValue(instruction.key) ? Result::True : Result::False;
+
+    case Op::IdIn: {
+        const Value id = idAsExpressionValue(feature->getID());
+        for (const Value& value : instruction.values) {
+            if (value == id) return Result::True;
+        }
+        return Result::False;
+    }
+
+    case Op::HasId:
+        return feature->getID().is<NullValue>() ? Result::False : Result::True;
+
+    case Op::Match: {
+        const optional<mbgl::Value> property = feature->getValue(instruction.key);
+        if (property && property->is<std::string>()) {
+            auto it = instruction.labels.find(property->get<std::string>());
+            if (it != instruction.labels.end()) {
+                return it->second ? Result::True : Result::False;
+            }
+        }
+        return instruction.result ? Result::True : Result::False;
+    }
+
+    case Op::Interpret: {
+        const EvaluationResult result = instruction.expression->evaluate(context);
+        if (!result) return Result::Error;
+        const optional<bool> typed = fromExpressionValue<bool>(*result);
+        return typed && *typed ? Result::True : Result::False;
+    }
+    }
+
+    return Result::False;
+}
+
+} // namespace style
+} // namespace mbgl
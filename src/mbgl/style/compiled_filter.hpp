@@ -0,0 +1,72 @@
+#pragma once
+
+#include <mbgl/style/expression/expression.hpp>
+#include <mbgl/style/expression/value.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace mbgl {
+namespace style {
+
+// A filter expression lowered into a flat program of specialized predicates.
+//
+// Legacy filters as well as `==`, `!=`, `has` and `match` expressions on `geometry-type` or on a
+// feature property compared against literals, combined with `all`, `any` and `!`, are evaluated
+// straight against the feature. Any other subexpression is kept and evaluated by the expression
+// interpreter, so the result is always the same as evaluating the expression itself.
+class CompiledFilter {
+public:
+    // Returns nullptr if no part of the expression can be compiled.
+    static std::unique_ptr<const CompiledFilter> compile(std::shared_ptr<const expression::Expression>);
+
+    bool operator()(const expression::EvaluationContext&) const;
+
+private:
+    explicit CompiledFilter(std::shared_ptr<const expression::Expression>);
+
+    enum class Result : uint8_t { False, True, Error };
+
+    enum class Op : uint8_t {
+        Constant,   // result
+        Not,
+        All,
+        Any,
+        TypeIn,     // types
+        PropertyIn, // key, values, negated, missingIsNull
+        Has,        // key
+        IdIn,       // values
+        HasId,
+        Match,      // key, labels, result (otherwise)
+        Interpret   // expression
+    };
+
+    struct Instruction {
+        Op op;
+        // Number of instructions in the subtree rooted at this instruction, including itself.
+        std::size_t size = 1;
+        bool result = false;
+        bool negated = false;
+        bool missingIsNull = false;
+        // Whether the original expression fails when there is no feature to evaluate against.
+        bool needsFeature = false;
+        uint8_t types = 0;
+        std::string key;
+        std::vector<expression::Value> values;
+        std::unordered_map<std::string, bool> labels;
+        const expression::Expression* expression = nullptr;
+    };
+
+    void compileNode(const expression::Expression&);
+    Instruction& emit(Op);
+    Result evaluate(std::size_t index, const expression::EvaluationContext&) const;
+
+    std::shared_ptr<const expression::Expression> root;
+    std::vector<Instruction> program;
+};
+
+} // namespace style
+} // namespace mbgl
@@ -18,7 +18,13 @@ static bool isExpression(const Convertible& filter);
 ParseResult convertLegacyFilter(const Convertible& values, Error& error);
 optional<mbgl::Value> serializeLegacyFilter(const Convertible& values);
 
-optional<Filter> Converter<Filter>::operator()(const Convertible& value, Error& error) const {
+optional<Filter> Converter<Filter>::operator()(const Convertible& value, Error& error, bool deferParsing) const {
+    if (deferParsing && isArray(value)) {
+        if (optional<mbgl::Value> json = toValue(value)) {
+            return Filter::deferred(std::move(*json));
+        }
+    }
+
     if (isExpression(value)) {
         ParsingContext parsingContext(type::Boolean);
         ParseResult parseResult = parsingContext.parseExpression(value);
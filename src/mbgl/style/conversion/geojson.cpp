@@ -1,17 +1,466 @@
 #include <mbgl/style/conversion/geojson.hpp>
-#include <mbgl/style/conversion/json.hpp>
 #include <mbgl/style/conversion_impl.hpp>
+#include <mbgl/util/rapidjson.hpp>
+#include <mbgl/util/string.hpp>
+
+#include <rapidjson/reader.h>
+
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+#include <vector>
 
 namespace mbgl {
 namespace style {
 namespace conversion {
 
+namespace {
+
+using mapbox::geojson::feature;
+using mapbox::geojson::feature_collection;
+using mapbox::geojson::geometry;
+using mapbox::geojson::geometry_collection;
+using mapbox::geojson::identifier;
+using mapbox::geojson::point;
+
+// The coordinates of a geometry, which may be parsed before its type is known: the points of the
+// innermost arrays, and the lengths of all arrays by nesting depth, in document order.
+class Coordinates {
+public:
+    void startArray() {
+        if (!open.empty()) {
+            if (open.back().hasNumbers) throw std::runtime_error("coordinates must be nested arrays of numbers");
+            open.back().hasArrays = true;
+            ++open.back().length;
+        }
+        open.push_back({});
+    }
+
+    void number(double value) {
+        if (open.back().hasArrays) throw std::runtime_error("coordinates must be nested arrays of numbers");
+        open.back().hasNumbers = true;
+        if (open.back().length == 0) x = value;
+        if (open.back().length == 1) y = value;
+        ++open.back().length;
+    }
+
+    void endArray() {
+        const OpenArray array = open.back();
+        open.pop_back();
+        const int depth = int(open.size());
+        if (lengths.size() <= open.size()) lengths.resize(open.size() + 1);
+        lengths[depth].push_back(array.length);
+        if (array.hasArrays) {
+            maxContainerDepth = std::max(maxContainerDepth, depth);
+        } else if (array.hasNumbers) {
+            if (array.length < 2) throw std::runtime_error("coordinates array must have at least 2 numbers");
+            if (leafDepth >= 0 && leafDepth != depth) throw std::runtime_error("coordinates must be nested evenly");
+            leafDepth = depth;
+            points.push_back({x, y});
+        }
+    }
+
+    bool isComplete() const { return open.empty(); }
+
+    // Reads the coordinates as a geometry of the given type.
+    geometry read(const std::string& type) {
+        if (type == "Point") {
+            validate(type, 0);
+            return readPoint(0);
+        } else if (type == "MultiPoint") {
+            validate(type, 1);
+            return readArray<mapbox::geojson::multi_point>(0, pointReader());
+        } else if (type == "LineString") {
+            validate(type, 1);
+            return readArray<mapbox::geojson::line_string>(0, pointReader());
+        } else if (type == "MultiLineString") {
+            validate(type, 2);
+            return readArray<mapbox::geojson::multi_line_string>(0, lineReader<mapbox::geojson::line_string>());
+        } else if (type == "Polygon") {
+            validate(type, 2);
+            return readArray<mapbox::geojson::polygon>(0, lineReader<mapbox::geojson::linear_ring>());
+        } else if (type == "MultiPolygon") {
+            validate(type, 3);
+            return readArray<mapbox::geojson::multi_polygon>(0, [this](std::size_t depth) {
+                return readArray<mapbox::geojson::polygon>(depth, lineReader<mapbox::geojson::linear_ring>());
+            });
+        }
+        throw std::runtime_error(type + " not yet implemented");
+    }
+
+private:
+    // Checks that the points are nested `depth` arrays deep.
+    void validate(const std::string& type, int depth) const {
+        if ((leafDepth >= 0 && leafDepth != depth) || maxContainerDepth >= depth) {
+            throw std::runtime_error(type + " coordinates must be nested " + util::toString(depth + 1) + " arrays deep");
+        }
+    }
+
+    std::size_t nextLength(std::size_t depth) {
+        if (cursors.size() <= depth) cursors.resize(depth + 1);
+        assert(depth < lengths.size() && cursors[depth] < lengths[depth].size());
+        return lengths[depth][cursors[depth]++];
+    }
+
+    point readPoint(std::size_t depth) {
+        if (nextLength(depth) < 2) throw std::runtime_error("coordinates array must have at least 2 numbers");
+        return points[nextPoint++];
+    }
+
+    auto pointReader() {
+        return [this](std::size_t depth) { return readPoint(depth); };
+    }
+
+    template <class Line>
+    auto lineReader() {
+        return [this](std::size_t depth) { return readArray<Line>(depth, pointReader()); };
+    }
+
+    template <class Container, class ReadElement>
+    Container readArray(std::size_t depth, ReadElement readElement) {
+        Container result;
+        const std::size_t length = nextLength(depth);
+        result.reserve(length);
+        for (std::size_t i = 0; i < length; ++i) {
+            result.push_back(readElement(depth + 1));
+        }
+        return result;
+    }
+
+    struct OpenArray {
+        std::size_t length = 0;
+        bool hasNumbers = false;
+        bool hasArrays = false;
+    };
+    std::vector<OpenArray> open;
+    double x = 0;
+    double y = 0;
+
+    std::vector<std::vector<std::size_t>> lengths;
+    std::vector<point> points;
+    int leafDepth = -1;
+    int maxContainerDepth = -1;
+
+    std::vector<std::size_t> cursors;
+    std::size_t nextPoint = 0;
+};
+
+// Builds mapbox::geojson objects straight from rapidjson's SAX events, instead of converting a
+// rapidjson DOM of the whole document. Accepts the same GeoJSON as mapbox::geojson::convert(), with
+// the members of each object in any order. Errors are thrown.
+class GeoJSONHandler {
+public:
+    bool Null() { return value(NullValue()); }
+    bool Bool(bool b) { return value(b); }
+    bool Int(int i) { return number(int64_t(i), i); }
+    bool Uint(unsigned u) { return number(uint64_t(u), u); }
+    bool Int64(int64_t i) { return number(i, double(i)); }
+    bool Uint64(uint64_t u) { return number(u, double(u)); }
+    bool Double(double d) { return number(d, d); }
+    bool RawNumber(const char*, rapidjson::SizeType, bool) { return false; }
+    bool String(const char* str, rapidjson::SizeType length, bool) { return value(std::string(str, length)); }
+
+    bool StartObject() {
+        if (frames.empty()) {
+            pushObject(Role::Root);
+            return true;
+        }
+        switch (frames.back()) {
+            case Frame::Object:
+                switch (objects.back().member) {
+                    case Member::Geometry: pushObject(Role::Geometry); break;
+                    case Member::Properties: pushProperty(false); break;
+                    case Member::Other: pushSkip(); break;
+                    default: memberError(objects.back().member);
+                }
+                break;
+            case Frame::Features: pushObject(Role::Feature); break;
+            case Frame::Geometries: pushObject(Role::Geometry); break;
+            case Frame::Coordinates: throw std::runtime_error("coordinates must be nested arrays of numbers");
+            case Frame::Property: pushProperty(false); break;
+            case Frame::Skip: ++skipDepth; break;
+        }
+        return true;
+    }
+
+    bool Key(const char* str, rapidjson::SizeType length, bool) {
+        switch (frames.back()) {
+            case Frame::Object: objects.back().member = memberFor(objects.back().role, str, length); break;
+            case Frame::Property: properties.back().key.assign(str, length); break;
+            default: break;
+        }
+        return true;
+    }
+
+    bool EndObject(rapidjson::SizeType) {
+        switch (frames.back()) {
+            case Frame::Object: popObject(); break;
+            case Frame::Property: popProperty(); break;
+            default: popSkip(); break;
+        }
+        return true;
+    }
+
+    bool StartArray() {
+        if (frames.empty()) throw std::runtime_error("GeoJSON must be an object");
+        switch (frames.back()) {
+            case Frame::Object: {
+                ObjectState& object = objects.back();
+                switch (object.member) {
+                    case Member::Coordinates:
+                        object.coordinates.emplace();
+                        object.coordinates->startArray();
+                        frames.push_back(Frame::Coordinates);
+                        break;
+                    case Member::Geometries:
+                        object.geometries.emplace();
+                        frames.push_back(Frame::Geometries);
+                        break;
+                    case Member::Features:
+                        object.features.emplace();
+                        frames.push_back(Frame::Features);
+                        break;
+                    case Member::Other: pushSkip(); break;
+                    default: memberError(object.member);
+                }
+                break;
+            }
+            case Frame::Features: throw std::runtime_error("Feature must be an object");
+            case Frame::Geometries: throw std::runtime_error("Geometry must be an object");
+            case Frame::Coordinates: objects.back().coordinates->startArray(); break;
+            case Frame::Property: pushProperty(true); break;
+            case Frame::Skip: ++skipDepth; break;
+        }
+        return true;
+    }
+
+    bool EndArray(rapidjson::SizeType) {
+        switch (frames.back()) {
+            case Frame::Coordinates:
+                objects.back().coordinates->endArray();
+                if (objects.back().coordinates->isComplete()) frames.pop_back();
+                break;
+            case Frame::Features:
+            case Frame::Geometries: frames.pop_back(); break;
+            case Frame::Property: popProperty(); break;
+            default: popSkip(); break;
+        }
+        return true;
+    }
+
+    optional<GeoJSON> result;
+
+private:
+    enum class Frame : uint8_t { Object, Features, Geometries, Coordinates, Property, Skip };
+    enum class Role : uint8_t { Root, Feature, Geometry };
+    enum class Member : uint8_t { Other, Type, Coordinates, Geometries, Features, Geometry, Properties, ID };
+
+    struct ObjectState {
+        Role role;
+        Member member = Member::Other;
+        optional<std::string> type;
+        optional<Coordinates> coordinates;
+        optional<geometry_collection> geometries;
+        optional<feature_collection> features;
+        optional<geometry> geometry_;
+        PropertyMap properties;
+        identifier id;
+    };
+
+    struct PropertyState {
+        bool isArray;
+        std::vector<Value> array;
+        PropertyMap object;
+        std::string key;
+    };
+
+    static Member memberFor(Role role, const char* str, rapidjson::SizeType length) {
+        const std::string key(str, length);
+        if (key == "type") return Member::Type;
+        if (role != Role::Feature) {
+            if (key == "coordinates") return Member::Coordinates;
+            if (key == "geometries") return Member::Geometries;
+        }
+        if (role == Role::Root && key == "features") return Member::Features;
+        if (role != Role::Geometry) {
+            if (key == "geometry") return Member::Geometry;
+            if (key == "properties") return Member::Properties;
+            if (key == "id") return Member::ID;
+        }
+        return Member::Other;
+    }
+
+    [[noreturn]] static void memberError(Member member) {
+        switch (member) {
+            case Member::Type: throw std::runtime_error("type property must be a string");
+            case Member::Coordinates: throw std::runtime_error("coordinates property must be an array");
+            case Member::Geometries: throw std::runtime_error("GeometryCollection geometries property must be an array");
+            case Member::Features: throw std::runtime_error("FeatureCollection features property must be an array");
+            case Member::Geometry: throw std::runtime_error("Geometry must be an object");
+            case Member::Properties: throw std::runtime_error("properties must be an object");
+            default: throw std::runtime_error("Feature id must be a string or number");
+        }
+    }
+
+    bool number(Value numberValue, double coordinate) {
+        if (!frames.empty() && frames.back() == Frame::Coordinates) {
+            objects.back().coordinates->number(coordinate);
+            return true;
+        }
+        return value(std::move(numberValue));
+    }
+
+    bool value(Value v) {
+        if (frames.empty()) throw std::runtime_error("GeoJSON must be an object");
+        switch (frames.back()) {
+            case Frame::Object: setMember(objects.back(), std::move(v)); break;
+            case Frame::Features: throw std::runtime_error("Feature must be an object");
+            case Frame::Geometries: throw std::runtime_error("Geometry must be an object");
+            case Frame::Coordinates: throw std::runtime_error("coordinates must be nested arrays of numbers");
+            case Frame::Property: addProperty(std::move(v)); break;
+            case Frame::Skip: break;
+        }
+        return true;
+    }
+
+    static void setMember(ObjectState& object, Value v) {
+        switch (object.member) {
+            case Member::Other: break;
+            case Member::Type:
+                if (!v.is<std::string>()) memberError(object.member);
+                object.type = std::move(v.get<std::string>());
+                break;
+            case Member::Geometry:
+                if (!v.is<NullValue>()) memberError(object.member);
+                object.geometry_ = geometry{mapbox::geometry::empty{}};
+                break;
+            case Member::Properties:
+                if (!v.is<NullValue>()) memberError(object.member);
+                break;
+            case Member::ID:
+                object.id = v.match([](uint64_t id) -> identifier { return id; },
+                                    [](int64_t id) -> identifier { return id; },
+                                    [](double id) -> identifier { return id; },
+                                    [](const std::string& id) -> identifier { return id; },
+                                    [](const NullValue&) -> identifier { return NullValue(); },
+                                    [](const auto&) -> identifier { memberError(Member::ID); });
+                break;
+            default: memberError(object.member);
+        }
+    }
+
+    void pushObject(Role role) {
+        objects.push_back({});
+        objects.back().role = role;
+        frames.push_back(Frame::Object);
+    }
+
+    void popObject() {
+        ObjectState object = std::move(objects.back());
+        objects.pop_back();
+        frames.pop_back();
+
+        if (frames.empty()) {
+            if (!object.type) throw std::runtime_error("GeoJSON must have a type property");
+            if (*object.type == "FeatureCollection") {
+                if (!object.features) throw std::runtime_error("FeatureCollection must have features property");
+                result = GeoJSON{std::move(*object.features)};
+            } else if (*object.type == "Feature") {
+                result = GeoJSON{finishFeature(object)};
+            } else {
+                result = GeoJSON{finishGeometry(object)};
+            }
+        } else if (frames.back() == Frame::Features) {
+            objects.back().features->push_back(finishFeature(object));
+        } else if (frames.back() == Frame::Geometries) {
+            objects.back().geometries->push_back(finishGeometry(object));
+        } else {
+            assert(objects.back().member == Member::Geometry);
+            objects.back().geometry_ = finishGeometry(object);
+        }
+    }
+
+    static feature finishFeature(ObjectState& object) {
+        if (!object.type) throw std::runtime_error("Feature must have a type property");
+        if (*object.type != "Feature") throw std::runtime_error("Feature type must be Feature");
+        if (!object.geometry_) throw std::runtime_error("Feature must have a geometry property");
+        return feature{std::move(*object.geometry_), std::move(object.properties), std::move(object.id)};
+    }
+
+    static geometry finishGeometry(ObjectState& object) {
+        if (!object.type) throw std::runtime_error("Geometry must have a type property");
+        if (*object.type == "GeometryCollection") {
+            if (!object.geometries) throw std::runtime_error("GeometryCollection must have a geometries property");
+            return geometry{std::move(*object.geometries)};
+        }
+        if (!object.coordinates) throw std::runtime_error(*object.type + " geometry must have a coordinates property");
+        return object.coordinates->read(*object.type);
+    }
+
+    void pushProperty(bool isArray) {
+        properties.push_back({isArray, {}, {}, {}});
+        frames.push_back(Frame::Property);
+    }
+
+    void popProperty() {
+        PropertyState property = std::move(properties.back());
+        properties.pop_back();
+        frames.pop_back();
+        if (frames.back() == Frame::Object) {
+            // The properties member of a feature.
+            objects.back().properties = std::move(property.object);
+        } else if (property.isArray) {
+            addProperty(Value(std::move(property.array)));
+        } else {
+            addProperty(Value(std::move(property.object)));
+        }
+    }
+
+    void addProperty(Value v) {
+        PropertyState& property = properties.back();
+        if (property.isArray) {
+            property.array.push_back(std::move(v));
+        } else {
+            property.object.emplace(std::move(property.key), std::move(v));
+        }
+    }
+
+    void pushSkip() {
+        skipDepth = 1;
+        frames.push_back(Frame::Skip);
+    }
+
+    void popSkip() {
+        if (--skipDepth == 0) frames.pop_back();
+    }
+
+    std::vector<Frame> frames;
+    std::vector<ObjectState> objects;
+    std::vector<PropertyState> properties;
+    std::size_t skipDepth = 0;
+};
+
+} // namespace
+
 optional<GeoJSON> Converter<GeoJSON>::operator()(const Convertible& value, Error& error) const {
     return toGeoJSON(value, error);
 }
 
 optional<GeoJSON> parseGeoJSON(const std::string& value, Error& error) {
-    return convertJSON<GeoJSON>(value, error);
+    GeoJSONHandler handler;
+    rapidjson::Reader reader;
+    rapidjson::StringStream stream(value.c_str());
+    try {
+        const rapidjson::ParseResult parsed = reader.Parse(stream, handler);
+        if (!parsed) {
+            error = {formatJSONParseError(parsed)};
+            return nullopt;
+        }
+    } catch (const std::exception& ex) {
+        error = {ex.what()};
+        return nullopt;
+    }
+    return std::move(handler.result);
 }
 
 } // namespace conversion
@@ -32,7 +32,7 @@ optional<Error> setPaintProperties(Layer& layer, const Convertible& value) {
     return eachMember(*paintValue, [&](const std::string& k, const Convertible& v) { return layer.setProperty(k, v); });
 }
 
-optional<std::unique_ptr<Layer>> Converter<std::unique_ptr<Layer>>::operator()(const Convertible& value, Error& error) const {
+optional<std::unique_ptr<Layer>> Converter<std::unique_ptr<Layer>>::operator()(const Convertible& value, Error& error, bool deferFilter) const {
     if (!isObject(value)) {
         error.message = "layer must be an object";
         return nullopt;
@@ -67,7 +67,13 @@ optional<std::unique_ptr<Layer>> Converter<std::unique_ptr<Layer>>::operator()(c
 
     if (!setObjectMember(layer, value, "minzoom", error)) return nullopt;
     if (!setObjectMember(layer, value, "maxzoom", error)) return nullopt;
-    if (!setObjectMember(layer, value, "filter", error)) return nullopt;
+    if (!deferFilter) {
+        if (!setObjectMember(layer, value, "filter", error)) return nullopt;
+    } else if (auto filterValue = objectMember(value, "filter")) {
+        optional<Filter> filter = convert<Filter>(*filterValue, error, true);
+        if (!filter) return nullopt;
+        layer->setFilter(*filter);
+    }
     if (layer->getTypeInfo()->source == LayerTypeInfo::Source::Required) {
         if (!setObjectMember(layer, value, "source-layer", error)) return nullopt;
     }
@@ -137,7 +137,8 @@ void stringify(Writer& writer, const FeatureIdentifier& id) {
 
 template <class Writer>
 void stringify(Writer& writer, const Filter& filter) {
-    if (!filter.expression) writer.Null();
+    if (filter.isDeferred()) stringify(writer, filter.serialize());
+    else if (!filter.expression) writer.Null();
     else stringify(writer, (*filter.expression)->serialize());
 }
     
@@ -1,7 +1,15 @@
+#include <mbgl/actor/scheduler.hpp>
 #include <mbgl/style/custom_tile_loader.hpp>
 #include <mbgl/tile/custom_geometry_tile.hpp>
+#include <mbgl/util/logging.hpp>
+#include <mbgl/util/math.hpp>
+#include <mbgl/util/projection.hpp>
 #include <mbgl/util/tile_range.hpp>
 
+#include <algorithm>
+#include <cmath>
+#include <exception>
+
 namespace mbgl {
 namespace style {
 
@@ -10,6 +18,14 @@ CustomTileLoader::CustomTileLoader(const TileFunction& fetchTileFn, const TileFu
     cancelTileFunction = cancelTileFn;
 }
 
+CustomTileLoader::CustomTileLoader(ActorRef<CustomTileLoader> self_, const CustomGeometrySource::Options& options)
+    : CustomTileLoader(options.fetchTileFunction, options.cancelTileFunction) {
+    loadTileFunction = options.loadTileFunction;
+    self = std::move(self_);
+    threadPool = Scheduler::GetBackground();
+    maxConcurrentLoads = std::max<std::size_t>(options.maxConcurrentLoads, 1);
+}
+
 void CustomTileLoader::fetchTile(const OverscaledTileID& tileID, const ActorRef<CustomGeometryTile>& tileRef) {
     std::lock_guard<std::mutex> guard(dataMutex);
     auto cachedTileData = dataCache.find(tileID.canonical);
@@ -48,7 +64,10 @@ void CustomTileLoader::removeTile(const OverscaledTileID& tileID) {
     for (auto iter = tileCallbacks->second.begin(); iter != tileCallbacks->second.end(); iter++) {
         if (std::get<0>(*iter) == tileID.overscaledZ && std::get<1>(*iter) == tileID.wrap ) {
             tileCallbacks->second.erase(iter);
-            invokeTileCancel(tileID.canonical);
+            // Loads are shared by all wrapped and overscaled copies of the tile.
+            if (loadTileFunction == nullptr || tileCallbacks->second.empty()) {
+                invokeTileCancel(tileID.canonical);
+            }
             break;
         }
     }
@@ -104,14 +123,79 @@ void CustomTileLoader::invalidateRegion(const LatLngBounds& bounds, Range<uint8_
     }
 }
 
+void CustomTileLoader::setViewportCenter(const LatLng& center) {
+    viewportCenter = Projection::project(center, 1.0) / double(util::tileSize);
+}
+
+void CustomTileLoader::startLoads() {
+    while (runningLoads < maxConcurrentLoads && !pendingLoads.empty()) {
+        // Load the waiting tile closest to the viewport center, in tiles at its zoom level.
+        auto next = pendingLoads.begin();
+        if (viewportCenter) {
+            next = std::min_element(
+                pendingLoads.begin(), pendingLoads.end(), [&](const CanonicalTileID& a, const CanonicalTileID& b) {
+                    const auto distance = [&](const CanonicalTileID& tileID) {
+                        const double scale = std::pow(2.0, tileID.z);
+                        return util::dist<double>(*viewportCenter * scale, {tileID.x + 0.5, tileID.y + 0.5});
+                    };
+                    return distance(a) < distance(b);
+                });
+        }
+        const CanonicalTileID tileID = *next;
+        pendingLoads.erase(next);
+
+        const uint64_t load = nextLoad++;
+        activeLoads[tileID] = load;
+        ++runningLoads;
+        threadPool->scheduleTagged(
+            TaskTag::GeoJSON, TaskPriority::Default, [loadTile = loadTileFunction, loader = *self, tileID, load] {
+                // Tiles whose load fails are empty, and the load still releases its slot.
+                GeoJSON data{mapbox::feature::feature_collection<double>{}};
+                try {
+                    data = loadTile(tileID);
+                } catch (const std::exception& ex) {
+                    Log::Error(Event::General,
+                               "Failed to load custom geometry tile %s: %s",
+                               util::toString(tileID).c_str(),
+                               ex.what());
+                } catch (...) {
+                    Log::Error(Event::General, "Failed to load custom geometry tile %s", util::toString(tileID).c_str());
+                }
+                loader.invoke(&CustomTileLoader::didLoadTile, tileID, load, data);
+            });
+    }
+}
+
+void CustomTileLoader::didLoadTile(const CanonicalTileID& tileID, uint64_t load, const GeoJSON& data) {
+    --runningLoads;
+    auto activeLoad = activeLoads.find(tileID);
+    // Data of cancelled or invalidated tiles is dropped.
+    if (activeLoad != activeLoads.end() && activeLoad->second == load) {
+        activeLoads.erase(activeLoad);
+        setTileData(tileID, data);
+    }
+    std::lock_guard<std::mutex> guard(dataMutex);
+    startLoads();
+}
+
 void CustomTileLoader::invokeTileFetch(const CanonicalTileID& tileID) {
-    if (fetchTileFunction != nullptr) {
+    if (loadTileFunction != nullptr && self) {
+        if (!activeLoads.count(tileID) &&
+            std::find(pendingLoads.begin(), pendingLoads.end(), tileID) == pendingLoads.end()) {
+            pendingLoads.push_back(tileID);
+        }
+        startLoads();
+    } else if (fetchTileFunction != nullptr) {
         fetchTileFunction(tileID);
     }
 }
 
 void CustomTileLoader::invokeTileCancel(const CanonicalTileID& tileID) {
-    if (cancelTileFunction != nullptr) {
+    if (loadTileFunction != nullptr && self) {
+        // Loads in progress run to completion, but their data is dropped.
+        pendingLoads.erase(std::remove(pendingLoads.begin(), pendingLoads.end(), tileID), pendingLoads.end());
+        activeLoads.erase(tileID);
+    } else if (cancelTileFunction != nullptr) {
         cancelTileFunction(tileID);
     }
 }
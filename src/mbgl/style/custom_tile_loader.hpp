@@ -4,13 +4,17 @@
 #include <mbgl/tile/tile_id.hpp>
 #include <mbgl/util/geojson.hpp>
 #include <mbgl/actor/actor_ref.hpp>
+#include <mbgl/util/geometry.hpp>
 
 #include <map>
 #include <mutex>
+#include <unordered_map>
+#include <vector>
 
 namespace mbgl {
 
 class CustomGeometryTile;
+class Scheduler;
 
 namespace style {
 
@@ -20,6 +24,7 @@ public:
     using OverscaledIDFunctionTuple = std::tuple<uint8_t, int16_t, ActorRef<CustomGeometryTile>>;
 
     CustomTileLoader(const TileFunction& fetchTileFn, const TileFunction& cancelTileFn);
+    CustomTileLoader(ActorRef<CustomTileLoader> self, const CustomGeometrySource::Options&);
 
     void fetchTile(const OverscaledTileID& tileID, const ActorRef<CustomGeometryTile>& tileRef);
     void cancelTile(const OverscaledTileID& tileID);
@@ -30,12 +35,31 @@ public:
     void invalidateTile(const CanonicalTileID&);
     void invalidateRegion(const LatLngBounds&, Range<uint8_t>);
 
+    // Tiles waiting for loadTileFunction are loaded closest to this first.
+    void setViewportCenter(const LatLng&);
+
 private:
     void invokeTileFetch(const CanonicalTileID& tileID);
     void invokeTileCancel(const CanonicalTileID& tileID);
 
+    void startLoads();
+    void didLoadTile(const CanonicalTileID&, uint64_t load, const GeoJSON&);
+
     TileFunction fetchTileFunction;
     TileFunction cancelTileFunction;
+    TileDataFunction loadTileFunction;
+    optional<ActorRef<CustomTileLoader>> self;
+
+    // Tiles waiting for loadTileFunction, the loads in progress by tile, and the number of busy
+    // threads, which includes loads whose tiles were cancelled.
+    std::shared_ptr<Scheduler> threadPool;
+    std::size_t maxConcurrentLoads = 1;
+    std::vector<CanonicalTileID> pendingLoads;
+    std::unordered_map<CanonicalTileID, uint64_t> activeLoads;
+    std::size_t runningLoads = 0;
+    uint64_t nextLoad = 0;
+    optional<Point<double>> viewportCenter;
+
     std::unordered_map<CanonicalTileID, std::vector<OverscaledIDFunctionTuple>> tileCallbackMap;
     // Keep around a cache of tile data to serve back for wrapped and over-zooomed tiles
     std::map<CanonicalTileID, std::unique_ptr<GeoJSON>> dataCache;
@@ -0,0 +1,528 @@
+#include <mbgl/style/expression/compiled_expression.hpp>
+#include <mbgl/style/expression/interpolate.hpp>
+#include <mbgl/style/expression/literal.hpp>
+#include <mbgl/style/expression/match.hpp>
+#include <mbgl/style/expression/step.hpp>
+#include <mbgl/tile/geometry_tile_data.hpp>
+#include <mbgl/util/interpolate.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+namespace mbgl {
+namespace style {
+namespace expression {
+
+namespace {
+
+std::vector<const Expression*> getChildren(const Expression& expression) {
+    std::vector<const Expression*> children;
+    expression.eachChild([&](const Expression& child) { children.push_back(&child); });
+    return children;
+}
+
+optional<Value> getLiteral(const Expression& expression) {
+    if (expression.getKind() != Kind::Literal) return nullopt;
+    return static_cast<const Literal&>(expression).getValue();
+}
+
+// Returns the key of a ["get", key] expression that reads a feature property.
+optional<std::string> getPropertyKey(const Expression& expression) {
+    if (expression.getKind() != Kind::CompoundExpression || expression.getOperator() != "get") return nullopt;
+    const auto children = getChildren(expression);
+    if (children.size() != 1u) return nullopt;
+    auto key = getLiteral(*children.front());
+    if (!key || !key->is<std::string>()) return nullopt;
+    return key->get<std::string>();
+}
+
+} // namespace
+
+std::unique_ptr<const CompiledExpression> CompiledExpression::compileNumber(const Expression& expression) {
+    if (expression.getType() != type::Number) return nullptr;
+    std::unique_ptr<CompiledExpression> compiled(new CompiledExpression());
+    if (!compiled->compileNumeric(expression)) return nullptr;
+    return std::move(compiled);
+}
+
+std::unique_ptr<const CompiledExpression> CompiledExpression::compileColor(const Expression& expression) {
+    if (expression.getType() != type::Color) return nullptr;
+    std::unique_ptr<CompiledExpression> compiled(new CompiledExpression());
+
+    Instruction instruction(Op::Constant);
+    switch (expression.getKind()) {
+    case Kind::Interpolate:
+    case Kind::Step: {
+        const Expression& input = expression.getKind() == Kind::Interpolate
+                                      ? *static_cast<const Interpolate&>(expression).getInput()
+                                      : *static_cast<const Step&>(expression).getInput();
+        auto inputRegister = compiled->compileNumeric(input);
+        if (!inputRegister) return nullptr;
+        instruction.op = expression.getKind() == Kind::Interpolate ? Op::Interpolate : Op::Step;
+        instruction.lhs = *inputRegister;
+        break;
+    }
+    case Kind::Match:
+        instruction.op = Op::Match;
+        break;
+    default:
+        return nullptr;
+    }
+
+    if (!compiled->compileOutputs(expression, instruction, true)) return nullptr;
+    if (!compiled->emit(std::move(instruction))) return nullptr;
+    compiled->colorResult = true;
+    return std::move(compiled);
+}
+
+optional<uint8_t> CompiledExpression::compileNumeric(const Expression& expression) {
+    if (expression.getType() != type::Number) return nullopt;
+
+    const auto children = getChildren(expression);
+    optional<Instruction> instruction;
+
+    switch (expression.getKind()) {
+    case Kind::Literal: {
+        auto value = getLiteral(expression);
+        if (!value || !value->is<double>()) return nullopt;
+        instruction.emplace(Op::Constant);
+        instruction->value = value->get<double>();
+        break;
+    }
+
+    case Kind::Assertion: {
+        // ["number", ["get", key]], which fails for non-numeric properties.
+        if (children.size() != 1u) return nullopt;
+        auto key = getPropertyKey(*children.front());
+        if (!key) return nullopt;
+        instruction.emplace(Op::Property);
+        instruction->key = std::move(*key);
+        break;
+    }
+
+    case Kind::CompoundExpression: {
+        const std::string op = expression.getOperator();
+        if (op == "zoom" && children.empty()) {
+            instruction.emplace(Op::Zoom);
+            break;
+        }
+
+        std::vector<uint8_t> operands;
+        for (const Expression* child : children) {
+            auto operand = compileNumeric(*child);
+            if (!operand) return nullopt;
+            operands.push_back(*operand);
+        }
+
+        if (op == "+" || op == "*") {
+            // Accumulates in the same order as the interpreter, which starts from 0 for sums.
+            const Op accumulate = op == "+" ? Op::Add : Op::Multiply;
+            optional<uint8_t> result;
+            std::size_t first = 0;
+            if (op == "+" || operands.empty()) {
+                Instruction initial(Op::Constant);
+                initial.value = op == "+" ? 0.0 : 1.0;
+                result = emit(std::move(initial));
+                if (!result) return nullopt;
+            } else {
+                result = operands.front();
+                first = 1;
+            }
+            for (std::size_t i = first; i < operands.size(); ++i) {
+                Instruction step(accumulate);
+                step.lhs = *result;
+                step.rhs = operands[i];
+                result = emit(std::move(step));
+                if (!result) return nullopt;
+            }
+            return result;
+        }
+
+        if (op == "-" && operands.size() == 2u) {
+            instruction.emplace(Op::Subtract);
+        } else if (op == "-" && operands.size() == 1u) {
+            instruction.emplace(Op::Negate);
+        } else if (op == "/" && operands.size() == 2u) {
+            instruction.emplace(Op::Divide);
+        } else {
+            return nullopt;
+        }
+        instruction->lhs = operands[0];
+        instruction->rhs = operands.back();
+        break;
+    }
+
+    case Kind::Interpolate:
+    case Kind::Step: {
+        const Expression& input = expression.getKind() == Kind::Interpolate
+                                      ? *static_cast<const Interpolate&>(expression).getInput()
+                                      : *static_cast<const Step&>(expression).getInput();
+        auto inputRegister = compileNumeric(input);
+        if (!inputRegister) return nullopt;
+        instruction.emplace(expression.getKind() == Kind::Interpolate ? Op::Interpolate : Op::Step);
+        instruction->lhs = *inputRegister;
+        if (!compileOutputs(expression, *instruction, false)) return nullopt;
+        break;
+    }
+
+    case Kind::Match:
+        instruction.emplace(Op::Match);
+        if (!compileOutputs(expression, *instruction, false)) return nullopt;
+        break;
+
+    default:
+        return nullopt;
+    }
+
+    return emit(std::move(*instruction));
+}
+
+bool CompiledExpression::Instruction::operator==(const Instruction& other) const {
+    // Compares the sign of constants as well, so that results stay those of the interpreter bit for bit.
+    return op == other.op && lhs == other.lhs && rhs == other.rhs && color == other.color &&
+           value == other.value && std::signbit(value) == std::signbit(other.value) && key == other.key &&
+           inputs == other.inputs && outputs == other.outputs && outputRegisters == other.outputRegisters &&
+           colors == other.colors && labels == other.labels && interpolator == other.interpolator;
+}
+
+optional<uint8_t> CompiledExpression::emit(Instruction instruction) {
+    // Instructions only depend on their operands, which come before them, so an identical
+    // instruction computes the same value for every feature.
+    const auto existing = std::find(program.begin(), program.end(), instruction);
+    if (existing != program.end()) {
+        return static_cast<uint8_t>(existing - program.begin());
+    }
+    if (program.size() >= maxRegisters) return nullopt;
+    switch (instruction.op) {
+    case Op::Constant:
+    case Op::Zoom:
+        instruction.featureDependent = false;
+        break;
+    case Op::Property:
+    case Op::Match:
+        instruction.featureDependent = true;
+        break;
+    case Op::Negate:
+    case Op::Interpolate:
+    case Op::Step:
+        instruction.featureDependent = program[instruction.lhs].featureDependent;
+        break;
+    case Op::Add:
+    case Op::Subtract:
+    case Op::Multiply:
+    case Op::Divide:
+        instruction.featureDependent =
+            program[instruction.lhs].featureDependent || program[instruction.rhs].featureDependent;
+        break;
+    }
+    for (uint8_t output : instruction.outputRegisters) {
+        if (output != literalOutput && program[output].featureDependent) {
+            instruction.featureDependent = true;
+        }
+    }
+    program.push_back(std::move(instruction));
+    return static_cast<uint8_t>(program.size() - 1);
+}
+
+bool CompiledExpression::compileOutputs(const Expression& curve, Instruction& instruction, bool color) {
+    instruction.color = color;
+    bool supported = true;
+    std::vector<uint8_t> registers;
+    const auto addOutput = [&](const Expression& output) {
+        auto value = getLiteral(output);
+        if (color) {
+            // Color outputs have to be literals, as there are no color registers.
+            if (value && value->is<Color>()) {
+                instruction.colors.push_back(value->get<Color>());
+            } else {
+                supported = false;
+            }
+        } else if (value && value->is<double>()) {
+            instruction.outputs.push_back(value->get<double>());
+            registers.push_back(literalOutput);
+        } else if (auto outputRegister = compileNumeric(output)) {
+            instruction.outputs.push_back(0.0);
+            registers.push_back(*outputRegister);
+        } else {
+            supported = false;
+        }
+    };
+    const auto finish = [&] {
+        if (std::any_of(registers.begin(), registers.end(), [](uint8_t r) { return r != literalOutput; })) {
+            instruction.outputRegisters = std::move(registers);
+        }
+        return supported;
+    };
+
+    if (curve.getKind() == Kind::Interpolate) {
+        const auto& interpolate = static_cast<const Interpolate&>(curve);
+        instruction.interpolator = interpolate.getInterpolator();
+        interpolate.eachStop([&](double input, const Expression& output) {
+            instruction.inputs.push_back(input);
+            addOutput(output);
+        });
+        return finish() && !instruction.inputs.empty();
+    }
+
+    if (curve.getKind() == Kind::Step) {
+        static_cast<const Step&>(curve).eachStop([&](double input, const Expression& output) {
+            instruction.inputs.push_back(input);
+            addOutput(output);
+        });
+        return finish() && !instruction.inputs.empty();
+    }
+
+    if (curve.getKind() == Kind::Match) {
+        const Match<std::string>* match = asStringMatch(curve);
+        if (!match) return false;
+        const auto children = getChildren(curve);
+        auto key = getPropertyKey(*children.front());
+        if (!key) return false;
+        instruction.key = std::move(*key);
+
+        // Branches sharing an output expression share the output slot.
+        std::unordered_map<const Expression*, std::size_t> slots;
+        for (const auto& branch : match->getBranches()) {
+            auto slot = slots.find(branch.second.get());
+            if (slot == slots.end()) {
+                slot = slots.emplace(branch.second.get(), slots.size()).first;
+                addOutput(*branch.second);
+            }
+            instruction.labels.emplace(branch.first, slot->second);
+        }
+        addOutput(*children.back());
+        return finish();
+    }
+
+    return false;
+}
+
+optional<double> CompiledExpression::evaluateNumber(const EvaluationContext& context) const {
+    assert(!colorResult);
+    double registers[maxRegisters];
+    uint32_t valid = 0;
+    run(context, registers, valid, nullptr, Pass::All);
+    if (!isValid(valid, program.size() - 1)) return nullopt;
+    return registers[program.size() - 1];
+}
+
+optional<Color> CompiledExpression::evaluateColor(const EvaluationContext& context) const {
+    assert(colorResult);
+    double registers[maxRegisters];
+    uint32_t valid = 0;
+    Color color;
+    run(context, registers, valid, &color, Pass::All);
+    if (!isValid(valid, program.size() - 1)) return nullopt;
+    return color;
+}
+
+void CompiledExpression::evaluateNumbers(const EvaluationContext& context,
+                                         const std::vector<const GeometryTileFeature*>& features,
+                                         std::vector<optional<double>>& results) const {
+    assert(!colorResult);
+    results.clear();
+    results.reserve(features.size());
+
+    double registers[maxRegisters];
+    uint32_t valid = 0;
+    run(context, registers, valid, nullptr, Pass::Invariant);
+
+    EvaluationContext featureContext(context);
+    for (const GeometryTileFeature* feature : features) {
+        featureContext.feature = feature;
+        run(featureContext, registers, valid, nullptr, Pass::FeatureDependent);
+        if (isValid(valid, program.size() - 1)) {
+            results.emplace_back(registers[program.size() - 1]);
+        } else {
+            results.emplace_back();
+        }
+    }
+}
+
+void CompiledExpression::evaluateColors(const EvaluationContext& context,
+                                        const std::vector<const GeometryTileFeature*>& features,
+                                        std::vector<optional<Color>>& results) const {
+    assert(colorResult);
+    results.clear();
+    results.reserve(features.size());
+
+    double registers[maxRegisters];
+    uint32_t valid = 0;
+    Color invariantColor;
+    run(context, registers, valid, &invariantColor, Pass::Invariant);
+
+    EvaluationContext featureContext(context);
+    for (const GeometryTileFeature* feature : features) {
+        featureContext.feature = feature;
+        Color color = invariantColor;
+        run(featureContext, registers, valid, &color, Pass::FeatureDependent);
+        if (isValid(valid, program.size() - 1)) {
+            results.emplace_back(color);
+        } else {
+            results.emplace_back();
+        }
+    }
+}
+
+bool CompiledExpression::isValid(uint32_t valid, std::size_t index) {
+    return (valid >> index) & 1u;
+}
+
+void CompiledExpression::run(
+    const EvaluationContext& context, double* registers, uint32_t& valid, Color* color, Pass pass) const {
+    for (std::size_t i = 0; i < program.size(); ++i) {
+        const Instruction& instruction = program[i];
+        if ((pass == Pass::Invariant && instruction.featureDependent) ||
+            (pass == Pass::FeatureDependent && !instruction.featureDependent)) {
+            continue;
+        }
+        valid &= ~(1u << i);
+        if (execute(instruction, context, registers, valid, color, registers[i])) {
+            valid |= 1u << i;
+        }
+    }
+}
+
+bool CompiledExpression::output(const Instruction& instruction,
+                                std::size_t index,
+                                const double* registers,
+                                uint32_t valid,
+                                double& result) {
+    if (instruction.outputRegisters.empty() || instruction.outputRegisters[index] == literalOutput) {
+        result = instruction.outputs[index];
+        return true;
+    }
+    const uint8_t outputRegister = instruction.outputRegisters[index];
+    result = registers[outputRegister];
+    return isValid(valid, outputRegister);
+}
+
+bool CompiledExpression::execute(const Instruction& instruction,
+                                 const EvaluationContext& context,
+                                 const double* registers,
+                                 uint32_t valid,
+                                 Color* color,
+                                 double& result) const {
+    switch (instruction.op) {
+    case Op::Constant:
+        result = instruction.value;
+        return true;
+
+    case Op::Zoom:
+        if (!context.zoom) return false;
+        result = *context.zoom;
+        return true;
+
+    case Op::Property: {
+        if (!context.feature) return false;
+        const optional<mbgl::Value> property = context.feature->getValue(instruction.key);
+        if (!property) return false;
+        const optional<double> number =
+            property->match([](double value) -> optional<double> { return value; },
+                            [](uint64_t value) -> optional<double> { return static_cast<double>(value); },
+                            [](int64_t value) -> optional<double> { return static_cast<double>(value); },
+                            [](const auto&) -> optional<double> { return nullopt; });
+        if (!number) return false;
+        result = *number;
+        return true;
+    }
+
+    case Op::Add:
+    case Op::Subtract:
+    case Op::Multiply:
+    case Op::Divide: {
+        if (!isValid(valid, instruction.lhs) || !isValid(valid, instruction.rhs)) return false;
+        const double a = registers[instruction.lhs];
+        const double b = registers[instruction.rhs];
+        if (instruction.op == Op::Add) {
+            result = a + b;
+        } else if (instruction.op == Op::Subtract) {
+            result = a - b;
+        } else if (instruction.op == Op::Multiply) {
+            result = a * b;
+        } else if (b == 0 && a == 0) {
+            result = std::numeric_limits<double>::quiet_NaN();
+        } else if (b == 0 && a > 0) {
+            result = std::numeric_limits<double>::infinity();
+        } else if (b == 0 && a < 0) {
+            result = -std::numeric_limits<double>::infinity();
+        } else {
+            result = a / b;
+        }
+        return true;
+    }
+
+    case Op::Negate:
+        if (!isValid(valid, instruction.lhs)) return false;
+        result = -registers[instruction.lhs];
+        return true;
+
+    case Op::Interpolate:
+    case Op::Step: {
+        if (!isValid(valid, instruction.lhs)) return false;
+        const float x = static_cast<float>(registers[instruction.lhs]);
+        if (std::isnan(x)) return false;
+
+        const auto& inputs = instruction.inputs;
+        const std::size_t upper = std::upper_bound(inputs.begin(), inputs.end(), x) - inputs.begin();
+        std::size_t lower = upper;
+        float t = 0.0f;
+        if (upper == inputs.size()) {
+            lower = inputs.size() - 1;
+        } else if (upper == 0) {
+            lower = 0;
+        } else if (instruction.op == Op::Step) {
+            lower = upper - 1;
+        } else {
+            lower = upper - 1;
+            const Range<double> range{inputs[lower], inputs[upper]};
+            t = instruction.interpolator.match(
+                [&](const auto& interpolator) { return interpolator.interpolationFactor(range, x); });
+            if (t == 1.0f) {
+                lower = upper;
+                t = 0.0f;
+            }
+        }
+
+        if (instruction.color) {
+            *color = t == 0.0f ? instruction.colors[lower]
+                               : util::interpolate(instruction.colors[lower], instruction.colors[upper], t);
+            return true;
+        }
+
+        // Like the interpreter, only the outputs in use have to evaluate successfully.
+        double lowerOutput;
+        if (!output(instruction, lower, registers, valid, lowerOutput)) return false;
+        if (t == 0.0f) {
+            result = lowerOutput;
+            return true;
+        }
+        double upperOutput;
+        if (!output(instruction, upper, registers, valid, upperOutput)) return false;
+        result = util::interpolate(lowerOutput, upperOutput, t);
+        return true;
+    }
+
+    case Op::Match: {
+        if (!context.feature) return false;
+        std::size_t slot = instruction.color ? instruction.colors.size() - 1 : instruction.outputs.size() - 1;
+        const optional<mbgl::Value> property = context.feature->getValue(instruction.key);
+        if (property && property->is<std::string>()) {
+            auto it = instruction.labels.find(property->get<std::string>());
+            if (it != instruction.labels.end()) slot = it->second;
+        }
+        if (instruction.color) {
+            *color = instruction.colors[slot];
+            return true;
+        }
+        return output(instruction, slot, registers, valid, result);
+    }
+    }
+    return false;
+}
+
+} // namespace expression
+} // namespace style
+} // namespace mbgl
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <mbgl/style/expression/expression.hpp>
+#include <mbgl/style/expression/interpolator.hpp>
+#include <mbgl/util/color.hpp>
+#include <mbgl/util/optional.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace mbgl {
+namespace style {
+namespace expression {
+
+/*
+    A numeric or color expression lowered into a register program.
+
+    Supported are literals, `zoom`, numeric feature properties (`["number", ["get", key]]`),
+    the arithmetic operators `+`, `-`, `*` and `/`, as well as `interpolate`, `step` and
+    `match` on a string property. Their outputs may be compiled numeric expressions, such as the
+    nested curves of composite functions, while color outputs have to be literals. Intermediate values
+    are kept as plain doubles instead of boxed `Value`s, and the result is the same as the one
+    of the interpreted expression. Expressions using anything else are not compiled.
+*/
+class CompiledExpression {
+public:
+    static std::unique_ptr<const CompiledExpression> compileNumber(const Expression&);
+    static std::unique_ptr<const CompiledExpression> compileColor(const Expression&);
+
+    // Both return nullopt if evaluating the original expression results in an error.
+    optional<double> evaluateNumber(const EvaluationContext&) const;
+    optional<Color> evaluateColor(const EvaluationContext&) const;
+
+    // Evaluate the program for each of the features, with `context` providing everything else.
+    // Instructions that don't depend on the feature, such as constants, zoom and arithmetic on
+    // them, run only once for the whole batch. `results` receives one entry per feature.
+    void evaluateNumbers(const EvaluationContext& context,
+                         const std::vector<const GeometryTileFeature*>& features,
+                         std::vector<optional<double>>& results) const;
+    void evaluateColors(const EvaluationContext& context,
+                        const std::vector<const GeometryTileFeature*>& features,
+                        std::vector<optional<Color>>& results) const;
+
+private:
+    CompiledExpression() = default;
+
+    enum class Op : uint8_t {
+        Constant,    // value
+        Zoom,
+        Property,    // key
+        Add,         // lhs, rhs
+        Subtract,    // lhs, rhs
+        Multiply,    // lhs, rhs
+        Divide,      // lhs, rhs
+        Negate,      // lhs
+        Interpolate, // lhs (input), inputs, outputs (and outputRegisters) or colors, interpolator
+        Step,        // lhs (input), inputs, outputs (and outputRegisters) or colors
+        Match        // key, labels, outputs (and outputRegisters) or colors; the last output is the fallback
+    };
+
+    struct Instruction {
+        explicit Instruction(Op op_) : op(op_) {}
+
+        // Whether both compute the same result, so that emit() can reuse the register of the
+        // first one.
+        bool operator==(const Instruction&) const;
+
+        Op op;
+        uint8_t lhs = 0;
+        uint8_t rhs = 0;
+        // Interpolate, Step and Match write a color instead of a register.
+        bool color = false;
+        // Whether the result differs between features, directly or through an operand.
+        bool featureDependent = false;
+        double value = 0;
+        std::string key;
+        std::vector<double> inputs;
+        std::vector<double> outputs;
+        // Empty when all outputs are literals; otherwise the register holding each output, or
+        // literalOutput for the ones taken from `outputs`.
+        std::vector<uint8_t> outputRegisters;
+        std::vector<Color> colors;
+        std::unordered_map<std::string, std::size_t> labels;
+        Interpolator interpolator = ExponentialInterpolator(1.0);
+    };
+
+    // Every instruction writes the register with its own index, and repeated subexpressions,
+    // such as the same property read in several outputs, share the first register computing them. Registers holding the result of
+    // a failed evaluation are marked in a bit mask, as the interpreter only fails when such a
+    // value is actually used.
+    static constexpr std::size_t maxRegisters = 32;
+    static constexpr uint8_t literalOutput = 0xff;
+
+    // Selects the instructions executed by run().
+    enum class Pass : uint8_t { All, Invariant, FeatureDependent };
+
+    optional<uint8_t> compileNumeric(const Expression&);
+    bool compileOutputs(const Expression& curve, Instruction&, bool color);
+    optional<uint8_t> emit(Instruction);
+
+    static bool isValid(uint32_t valid, std::size_t index);
+    static bool output(const Instruction&, std::size_t index, const double* registers, uint32_t valid, double& result);
+    void run(const EvaluationContext&, double* registers, uint32_t& valid, Color* color, Pass) const;
+    bool execute(const Instruction&,
+                 const EvaluationContext&,
+                 const double* registers,
+                 uint32_t valid,
+                 Color* color,
+                 double& result) const;
+
+    std::vector<Instruction> program;
+    bool colorResult = false;
+};
+
+} // namespace expression
+} // namespace style
+} // namespace mbgl
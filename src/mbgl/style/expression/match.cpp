@@ -122,6 +122,23 @@ template<> EvaluationResult Match<int64_t>::evaluate(const EvaluationContext& pa
 template class Match<int64_t>;
 template class Match<std::string>;
 
+const Match<std::string>* asStringMatch(const Expression& expression) {
+    if (expression.getKind() != Kind::Match) return nullptr;
+
+    // Both specializations share the same kind; the label type only shows in the serialization,
+    // which is ["match", input, label or [labels...], output, ..., otherwise].
+    const mbgl::Value serialized = expression.serialize();
+    if (!serialized.is<std::vector<mbgl::Value>>()) return nullptr;
+    const auto& array = serialized.get<std::vector<mbgl::Value>>();
+    if (array.size() < 5u) return nullptr;
+    const mbgl::Value& label = array[2];
+    const bool stringLabels = label.is<std::string>() ||
+                              (label.is<std::vector<mbgl::Value>>() &&
+                               !label.get<std::vector<mbgl::Value>>().empty() &&
+                               label.get<std::vector<mbgl::Value>>().front().is<std::string>());
+    return stringLabels ? static_cast<const Match<std::string>*>(&expression) : nullptr;
+}
+
 using InputType = variant<int64_t, std::string>;
 
 using namespace mbgl::style::conversion;
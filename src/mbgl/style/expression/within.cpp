@@ -29,18 +29,14 @@ Point<int64_t> latLonToTileCoodinates(const Point<double>& point, const mbgl::Ca
     return p;
 };
 
-Polygon<int64_t> getTilePolygon(const Polygon<double>& polygon,
-                                const mbgl::CanonicalTileID& canonical,
-                                WithinBBox& bbox) {
+Polygon<int64_t> getTilePolygon(const Polygon<double>& polygon, const mbgl::CanonicalTileID& canonical) {
     Polygon<int64_t> result;
     result.reserve(polygon.size());
     for (const auto& ring : polygon) {
         LinearRing<int64_t> temp;
         temp.reserve(ring.size());
         for (const auto p : ring) {
-            const auto coord = latLonToTileCoodinates(p, canonical);
-            temp.push_back(coord);
-            updateBBox(bbox, coord);
+            temp.push_back(latLonToTileCoodinates(p, canonical));
         }
         result.push_back(std::move(temp));
     }
@@ -48,20 +44,19 @@ Polygon<int64_t> getTilePolygon(const Polygon<double>& polygon,
 }
 
 MultiPolygon<int64_t> getTilePolygons(const Feature::geometry_type& polygonGeoSet,
-                                      const mbgl::CanonicalTileID& canonical,
-                                      WithinBBox& bbox) {
+                                      const mbgl::CanonicalTileID& canonical) {
     return polygonGeoSet.match(
-        [&canonical, &bbox](const mapbox::geometry::multi_polygon<double>& polygons) {
+        [&canonical](const mapbox::geometry::multi_polygon<double>& polygons) {
             MultiPolygon<int64_t> result;
             result.reserve(polygons.size());
             for (const auto& pg : polygons) {
-                result.push_back(getTilePolygon(pg, canonical, bbox));
+                result.push_back(getTilePolygon(pg, canonical));
             }
             return result;
         },
-        [&canonical, &bbox](const mapbox::geometry::polygon<double>& polygon) {
+        [&canonical](const mapbox::geometry::polygon<double>& polygon) {
             MultiPolygon<int64_t> result;
-            result.push_back(getTilePolygon(polygon, canonical, bbox));
+            result.push_back(getTilePolygon(polygon, canonical));
             return result;
         },
         [](const auto&) { return MultiPolygon<int64_t>(); });
@@ -137,9 +132,9 @@ MultiLineString<int64_t> getTileLines(const GeometryCollection& lines,
 
 bool featureWithinPolygons(const GeometryTileFeature& feature,
                            const CanonicalTileID& canonical,
-                           const Feature::geometry_type& polygonGeoSet) {
-    WithinBBox polyBBox = DefaultBBox;
-    const auto polygons = getTilePolygons(polygonGeoSet, canonical, polyBBox);
+                           const PolygonIndex& index) {
+    const auto& polygons = index.polygons;
+    const auto& polyBBox = index.bbox;
     assert(!polygons.empty());
     const GeometryCollection& geometries = feature.getGeometries();
     switch (feature.getType()) {
@@ -149,8 +144,7 @@ bool featureWithinPolygons(const GeometryTileFeature& feature,
             MultiPoint<int64_t> points = getTilePoints(geometries.at(0), canonical, pointBBox, polyBBox);
             if (!boxWithinBox(pointBBox, polyBBox)) return false;
 
-            return std::all_of(
-                points.begin(), points.end(), [&polygons](const auto& p) { return pointWithinPolygons(p, polygons); });
+            return std::all_of(points.begin(), points.end(), [&index](const auto& p) { return index.contains(p); });
         }
         case FeatureType::LineString: {
             WithinBBox lineBBox = DefaultBBox;
@@ -200,6 +194,21 @@ Within::Within(GeoJSON geojson, Feature::geometry_type geometries_)
 
 Within::~Within() = default;
 
+std::shared_ptr<const PolygonIndex> Within::getIndex(const CanonicalTileID& canonical) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = indexes.find(canonical);
+    if (it != indexes.end()) {
+        return it->second;
+    }
+    // Layouts evaluate the expression for a few tiles at a time, so keep the recent ones only.
+    if (indexes.size() >= 16) {
+        indexes.clear();
+    }
+    auto index = std::make_shared<const PolygonIndex>(getTilePolygons(geometries, canonical));
+    indexes.emplace(canonical, index);
+    return index;
+}
+
 using namespace mbgl::style::conversion;
 
 EvaluationResult Within::evaluate(const EvaluationContext& params) const {
@@ -209,7 +218,7 @@ EvaluationResult Within::evaluate(const EvaluationContext& params) const {
     auto geometryType = params.feature->getType();
     // Currently only support Point and LineString types in Polygon/Polygons
     if (geometryType == FeatureType::Point || geometryType == FeatureType::LineString) {
-        return featureWithinPolygons(*params.feature, *params.canonical, geometries);
+        return featureWithinPolygons(*params.feature, *params.canonical, *getIndex(*params.canonical));
     }
     mbgl::Log::Warning(mbgl::Event::General,
                        "within expression currently only support Point/LineString geometry type.");
@@ -1,12 +1,72 @@
 #include <mbgl/style/filter.hpp>
+#include <mbgl/style/compiled_filter.hpp>
+#include <mbgl/style/conversion/filter.hpp>
+#include <mbgl/style/conversion/json.hpp>
+#include <mbgl/style/conversion/stringify.hpp>
 #include <mbgl/tile/geometry_tile_data.hpp>
+#include <mbgl/util/logging.hpp>
+
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+#include <mutex>
 
 namespace mbgl {
 namespace style {
 
+class Filter::Deferred {
+public:
+    explicit Deferred(mbgl::Value json_) : json(std::move(json_)) {}
+
+    // Filters are evaluated on the tile workers, so the first one to get here parses it for everyone.
+    const Filter& get() {
+        std::call_once(parsed, [&] {
+            rapidjson::StringBuffer buffer;
+            rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+            conversion::stringify(writer, json);
+
+            conversion::Error error;
+            if (optional<Filter> converted = conversion::convertJSON<Filter>(buffer.GetString(), error)) {
+                filter = std::move(*converted);
+            } else {
+                Log::Warning(Event::ParseStyle, "invalid filter: %s", error.message.c_str());
+            }
+        });
+        return filter;
+    }
+
+    const mbgl::Value json;
+
+private:
+    std::once_flag parsed;
+    Filter filter;
+};
+
+Filter::Filter(expression::ParseResult _expression, optional<mbgl::Value> _filter)
+    : expression(std::move(*_expression)),
+      legacyFilter(std::move(_filter)) {
+    assert(!expression || *expression != nullptr);
+    if (expression) {
+        compiled = CompiledFilter::compile(*expression);
+    }
+}
+
+Filter Filter::deferred(mbgl::Value json) {
+    Filter filter;
+    filter.deferred_ = std::make_shared<Deferred>(std::move(json));
+    return filter;
+}
+
 bool Filter::operator()(const expression::EvaluationContext &context) const {
-    
+    if (deferred_) {
+        const Filter& parsed = deferred_->get();
+        // Invalid filters don't match anything, unlike missing ones.
+        return parsed ? parsed(context) : false;
+    }
+
     if (!this->expression) return true;
+
+    if (compiled) return (*compiled)(context);
     
     const expression::EvaluationResult result = (*this->expression)->evaluate(context);
     if (result) {
@@ -17,5 +77,16 @@ bool Filter::operator()(const expression::EvaluationContext &context) const {
     }
 }
 
+mbgl::Value Filter::serialize() const {
+    if (deferred_) {
+        return deferred_->json;
+    } else if (legacyFilter) {
+        return *legacyFilter;
+    } else if (expression) {
+        return (**expression).serialize();
+    }
+    return NullValue();
+}
+
 } // namespace style
 } // namespace mbgl
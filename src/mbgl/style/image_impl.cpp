@@ -1,6 +1,8 @@
 #include <mbgl/style/image_impl.hpp>
 #include <mbgl/util/exception.hpp>
 
+#include <cassert>
+
 namespace mbgl {
 namespace style {
 
@@ -40,24 +42,70 @@ Image::Impl::Impl(std::string id_,
                   ImageStretches stretchY_,
                   optional<ImageContent> content_)
     : id(std::move(id_)),
-      image(std::move(image_)),
+      size(image_.size),
       pixelRatio(pixelRatio_),
       sdf(sdf_),
       stretchX(std::move(stretchX_)),
       stretchY(std::move(stretchY_)),
-      content(std::move(content_)) {
+      content(std::move(content_)),
+      image(std::move(image_)) {
     if (!image.valid()) {
         throw util::StyleImageException("dimensions may not be zero");
-    } else if (pixelRatio <= 0) {
+    }
+    validate();
+}
+
+Image::Impl::Impl(std::string id_,
+                  std::shared_ptr<const PremultipliedImage> sheet_,
+                  const Point<uint32_t> position_,
+                  const Size size_,
+                  const float pixelRatio_,
+                  bool sdf_,
+                  ImageStretches stretchX_,
+                  ImageStretches stretchY_,
+                  optional<ImageContent> content_)
+    : id(std::move(id_)),
+      size(size_),
+      pixelRatio(pixelRatio_),
+      sdf(sdf_),
+      stretchX(std::move(stretchX_)),
+      stretchY(std::move(stretchY_)),
+      content(std::move(content_)),
+      sheet(std::move(sheet_)),
+      position(position_) {
+    assert(sheet);
+    if (size.isEmpty()) {
+        throw util::StyleImageException("dimensions may not be zero");
+    } else if (position.x + size.width > sheet->size.width || position.y + size.height > sheet->size.height) {
+        throw util::StyleImageException("area is outside of the sprite");
+    }
+    validate();
+}
+
+void Image::Impl::validate() const {
+    if (pixelRatio <= 0) {
         throw util::StyleImageException("pixelRatio may not be <= 0");
-    } else if (!validateStretch(stretchX, image.size.width)) {
+    } else if (!validateStretch(stretchX, size.width)) {
         throw util::StyleImageException("stretchX is out of bounds or overlapping");
-    } else if (!validateStretch(stretchY, image.size.height)) {
+    } else if (!validateStretch(stretchY, size.height)) {
         throw util::StyleImageException("stretchY is out of bounds or overlapping");
-    } else if (content && !validateContent(*content, image.size)) {
+    } else if (content && !validateContent(*content, size)) {
         throw util::StyleImageException("content area is invalid");
     }
 }
 
+const PremultipliedImage& Image::Impl::getImage() const {
+    std::call_once(copied, [this] {
+        if (!sheet) {
+            return;
+        }
+        image = PremultipliedImage(size);
+        PremultipliedImage::copy(*sheet, image, position, {0, 0}, size);
+        // The sheet goes away with the last of its images that wasn't needed yet.
+        sheet.reset();
+    });
+    return image;
+}
+
 } // namespace style
 } // namespace mbgl
@@ -1,7 +1,10 @@
 #pragma once
 
 #include <mbgl/style/image.hpp>
+#include <mbgl/util/geometry.hpp>
 
+#include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <set>
@@ -19,9 +22,24 @@ public:
          ImageStretches stretchY = {},
          optional<ImageContent> content = nullopt);
 
+    // An image in the given area of a sprite sheet. Its pixels are only copied out of the sheet
+    // the first time they are needed, since most views use a few of the images of a sprite.
+    Impl(std::string id,
+         std::shared_ptr<const PremultipliedImage> sheet,
+         Point<uint32_t> position,
+         Size size,
+         float pixelRatio,
+         bool sdf = false,
+         ImageStretches stretchX = {},
+         ImageStretches stretchY = {},
+         optional<ImageContent> content = nullopt);
+
     const std::string id;
 
-    PremultipliedImage image;
+    const Size size;
+
+    // Safe to call from any thread.
+    const PremultipliedImage& getImage() const;
 
     // Pixel ratio of the sprite image.
     const float pixelRatio;
@@ -35,6 +53,14 @@ public:
 
     // The space where text can be fit into this image.
     const optional<ImageContent> content;
+
+private:
+    void validate() const;
+
+    mutable PremultipliedImage image;
+    mutable std::shared_ptr<const PremultipliedImage> sheet;
+    const Point<uint32_t> position;
+    mutable std::once_flag copied;
 };
 
 } // namespace style
@@ -5,10 +5,18 @@ namespace style {
 
 Layer::Impl::Impl(std::string layerID, std::string sourceID)
     : id(std::move(layerID)),
+      internedID(util::stringIndexer().get(id)),
       source(std::move(sourceID)) {
 }
 
+void Layer::Impl::setID(std::string layerID) {
+    id = std::move(layerID);
+    internedID = util::stringIndexer().get(id);
+}
+
 void Layer::Impl::populateFontStack(std::set<FontStack>&) const {}
 
+void Layer::Impl::populateGlyphRanges(std::map<FontStack, std::set<GlyphRange>>&) const {}
+
 } // namespace style
 } // namespace mbgl
@@ -3,12 +3,16 @@
 #include <mbgl/style/layer.hpp>
 #include <mbgl/style/types.hpp>
 #include <mbgl/style/filter.hpp>
+#include <mbgl/text/glyph_range.hpp>
+#include <mbgl/util/string_indexer.hpp>
 
 #include <rapidjson/writer.h>
 #include <rapidjson/stringbuffer.h>
 
 #include <string>
 #include <limits>
+#include <map>
+#include <set>
 
 namespace mbgl {
 
@@ -33,9 +37,14 @@ public:
     Impl& operator=(const Impl&) = delete;
 
     // Returns true buckets if properties affecting layout have changed: i.e. filter,
-    // visibility, layout properties, or data-driven paint properties.
+    // visibility, layout properties, or data-driven paint properties that buckets can't
+    // update on their own.
     virtual bool hasLayoutDifference(const Layer::Impl&) const = 0;
 
+    // Returns true if data-driven paint properties have changed in a way that existing buckets
+    // apply by evaluating them again, see Bucket::updatePaintProperties().
+    virtual bool hasPaintPropertyBinderDifference(const Layer::Impl&) const { return false; }
+
     // Utility function for automatic layer grouping.
     virtual void stringifyLayout(rapidjson::Writer<rapidjson::StringBuffer>&) const = 0;
 
@@ -45,7 +54,17 @@ public:
     // Populates the given \a fontStack with fonts being used by the layer.
     virtual void populateFontStack(std::set<FontStack>& fontStack) const;
 
+    // Populates the given \a ranges with the glyph ranges that the layer is likely to need for
+    // each of its fonts, as far as they can be predicted without the data of its features.
+    virtual void populateGlyphRanges(std::map<FontStack, std::set<GlyphRange>>& ranges) const;
+
+    // Sets the ID along with its interned identity.
+    void setID(std::string);
+
     std::string id;
+    // The identity of `id` in util::stringIndexer(), which keys the data of the layer in tiles
+    // and buckets.
+    StringIdentity internedID;
     std::string source;
     std::string sourceLayer;
     Filter filter;
@@ -57,6 +76,14 @@ protected:
     Impl(const Impl&) = default;
 };
 
+// Returns true if either of the layers uses the pattern property. Pattern binders depend on the
+// image positions of the layout, so changes to layers using patterns always require a new layout.
+template <class PatternProperty, class LayerImpl>
+bool hasPattern(const LayerImpl& a, const LayerImpl& b) {
+    return !a.paint.template get<PatternProperty>().value.isUndefined() ||
+           !b.paint.template get<PatternProperty>().value.isUndefined();
+}
+
 // To be used in the inherited classes.
 #define DECLARE_LAYER_TYPE_INFO \
 const LayerTypeInfo* getTypeInfo() const noexcept final { return staticTypeInfo(); } \
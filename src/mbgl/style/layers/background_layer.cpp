@@ -52,7 +52,7 @@ Mutable<BackgroundLayer::Impl> BackgroundLayer::mutableImpl() const {
 
 std::unique_ptr<Layer> BackgroundLayer::cloneRef(const std::string& id_) const {
     auto impl_ = mutableImpl();
-    impl_->id = id_;
+    impl_->setID(id_);
     impl_->paint = BackgroundPaintProperties::Transitionable();
     return std::make_unique<BackgroundLayer>(std::move(impl_));
 }
@@ -7,7 +7,13 @@ bool CircleLayer::Impl::hasLayoutDifference(const Layer::Impl& other) const {
     assert(other.getTypeInfo() == getTypeInfo());
     const auto& impl = static_cast<const style::CircleLayer::Impl&>(other);
     return filter != impl.filter || visibility != impl.visibility || layout != impl.layout ||
-           paint.hasDataDrivenPropertyDifference(impl.paint);
+           paint.hasDataDrivenKindDifference(impl.paint);
+}
+
+bool CircleLayer::Impl::hasPaintPropertyBinderDifference(const Layer::Impl& other) const {
+    assert(other.getTypeInfo() == getTypeInfo());
+    const auto& impl = static_cast<const style::CircleLayer::Impl&>(other);
+    return !paint.hasDataDrivenKindDifference(impl.paint) && paint.hasDataDrivenPropertyDifference(impl.paint);
 }
 
 } // namespace style
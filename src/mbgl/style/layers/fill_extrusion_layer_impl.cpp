@@ -8,6 +8,14 @@ bool FillExtrusionLayer::Impl::hasLayoutDifference(const Layer::Impl& other) con
     const auto& impl = static_cast<const style::FillExtrusionLayer::Impl&>(other);
     return filter     != impl.filter ||
            visibility != impl.visibility ||
+           paint.hasDataDrivenKindDifference(impl.paint) ||
+           (hasPattern<FillExtrusionPattern>(*this, impl) && paint.hasDataDrivenPropertyDifference(impl.paint));
+}
+
+bool FillExtrusionLayer::Impl::hasPaintPropertyBinderDifference(const Layer::Impl& other) const {
+    assert(other.getTypeInfo() == getTypeInfo());
+    const auto& impl = static_cast<const style::FillExtrusionLayer::Impl&>(other);
+    return !hasPattern<FillExtrusionPattern>(*this, impl) && !paint.hasDataDrivenKindDifference(impl.paint) &&
            paint.hasDataDrivenPropertyDifference(impl.paint);
 }
 
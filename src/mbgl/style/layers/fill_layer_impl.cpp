@@ -8,6 +8,14 @@ bool FillLayer::Impl::hasLayoutDifference(const Layer::Impl& other) const {
     const auto& impl = static_cast<const style::FillLayer::Impl&>(other);
     return filter != impl.filter || visibility != impl.visibility || layout != impl.layout ||
            paint.get<FillPattern>().value != impl.paint.get<FillPattern>().value ||
+           paint.hasDataDrivenKindDifference(impl.paint) ||
+           (hasPattern<FillPattern>(*this, impl) && paint.hasDataDrivenPropertyDifference(impl.paint));
+}
+
+bool FillLayer::Impl::hasPaintPropertyBinderDifference(const Layer::Impl& other) const {
+    assert(other.getTypeInfo() == getTypeInfo());
+    const auto& impl = static_cast<const style::FillLayer::Impl&>(other);
+    return !hasPattern<FillPattern>(*this, impl) && !paint.hasDataDrivenKindDifference(impl.paint) &&
            paint.hasDataDrivenPropertyDifference(impl.paint);
 }
 
@@ -52,7 +52,7 @@ Mutable<HeatmapLayer::Impl> HeatmapLayer::mutableImpl() const {
 
 std::unique_ptr<Layer> HeatmapLayer::cloneRef(const std::string& id_) const {
     auto impl_ = mutableImpl();
-    impl_->id = id_;
+    impl_->setID(id_);
     impl_->paint = HeatmapPaintProperties::Transitionable();
     return std::make_unique<HeatmapLayer>(std::move(impl_));
 }
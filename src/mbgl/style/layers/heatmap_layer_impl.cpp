@@ -8,7 +8,13 @@ bool HeatmapLayer::Impl::hasLayoutDifference(const Layer::Impl& other) const {
     const auto& impl = static_cast<const style::HeatmapLayer::Impl&>(other);
     return filter     != impl.filter ||
            visibility != impl.visibility ||
-           paint.hasDataDrivenPropertyDifference(impl.paint);
+           paint.hasDataDrivenKindDifference(impl.paint);
+}
+
+bool HeatmapLayer::Impl::hasPaintPropertyBinderDifference(const Layer::Impl& other) const {
+    assert(other.getTypeInfo() == getTypeInfo());
+    const auto& impl = static_cast<const style::HeatmapLayer::Impl&>(other);
+    return !paint.hasDataDrivenKindDifference(impl.paint) && paint.hasDataDrivenPropertyDifference(impl.paint);
 }
 
 } // namespace style
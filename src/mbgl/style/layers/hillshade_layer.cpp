@@ -52,7 +52,7 @@ Mutable<HillshadeLayer::Impl> HillshadeLayer::mutableImpl() const {
 
 std::unique_ptr<Layer> HillshadeLayer::cloneRef(const std::string& id_) const {
     auto impl_ = mutableImpl();
-    impl_->id = id_;
+    impl_->setID(id_);
     impl_->paint = HillshadePaintProperties::Transitionable();
     return std::make_unique<HillshadeLayer>(std::move(impl_));
 }
@@ -9,6 +9,14 @@ bool LineLayer::Impl::hasLayoutDifference(const Layer::Impl& other) const {
     return filter     != impl.filter ||
            visibility != impl.visibility ||
            layout     != impl.layout ||
+           paint.hasDataDrivenKindDifference(impl.paint) ||
+           (hasPattern<LinePattern>(*this, impl) && paint.hasDataDrivenPropertyDifference(impl.paint));
+}
+
+bool LineLayer::Impl::hasPaintPropertyBinderDifference(const Layer::Impl& other) const {
+    assert(other.getTypeInfo() == getTypeInfo());
+    const auto& impl = static_cast<const style::LineLayer::Impl&>(other);
+    return !hasPattern<LinePattern>(*this, impl) && !paint.hasDataDrivenKindDifference(impl.paint) &&
            paint.hasDataDrivenPropertyDifference(impl.paint);
 }
 
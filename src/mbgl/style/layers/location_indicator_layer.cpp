@@ -52,7 +52,7 @@ Mutable<LocationIndicatorLayer::Impl> LocationIndicatorLayer::mutableImpl() cons
 
 std::unique_ptr<Layer> LocationIndicatorLayer::cloneRef(const std::string& id_) const {
     auto impl_ = mutableImpl();
-    impl_->id = id_;
+    impl_->setID(id_);
     impl_->paint = LocationIndicatorPaintProperties::Transitionable();
     return std::make_unique<LocationIndicatorLayer>(std::move(impl_));
 }
@@ -1,9 +1,100 @@
 #include <mbgl/style/layers/symbol_layer_impl.hpp>
+#include <mbgl/style/expression/compound_expression.hpp>
+#include <mbgl/text/glyph.hpp>
 #include <mbgl/util/logging.hpp>
+#include <mbgl/util/utf.hpp>
 
 namespace mbgl {
 namespace style {
 
+namespace {
+
+// The glyph ranges that labels in a language need beyond Basic Latin and Latin-1, for the
+// languages that styles pick with a `name_<language>` or `name:<language>` property. Ideographs
+// and Hangul syllables are too many to fetch ahead of time, and are usually rasterized locally.
+const std::map<std::string, std::vector<GlyphRange>>& languageGlyphRanges() {
+    static const std::vector<GlyphRange> latin{{256, 511}};
+    static const std::vector<GlyphRange> cyrillic{{1024, 1279}};
+    static const std::vector<GlyphRange> arabic{{1536, 1791}, {64256, 64511}, {65024, 65279}};
+    static const std::map<std::string, std::vector<GlyphRange>> ranges{
+        {"ar", arabic},
+        {"be", cyrillic},
+        {"bg", cyrillic},
+        {"cs", latin},
+        {"de", latin},
+        {"el", {{768, 1023}}},
+        {"es", latin},
+        {"fa", arabic},
+        {"fr", latin},
+        {"he", {{1280, 1535}}},
+        {"hi", {{2304, 2559}}},
+        {"hu", latin},
+        {"it", latin},
+        {"ja", {{12288, 12543}}},
+        {"kk", cyrillic},
+        {"ko", {{12288, 12543}, {12544, 12799}}},
+        {"mk", cyrillic},
+        {"pl", latin},
+        {"pt", latin},
+        {"ro", latin},
+        {"ru", cyrillic},
+        {"sr", cyrillic},
+        {"th", {{3584, 3839}}},
+        {"tr", latin},
+        {"uk", cyrillic},
+        {"ur", arabic},
+        {"vi", {{256, 511}, {7680, 7935}}},
+        {"zh", {{12288, 12543}, {65280, 65535}}},
+    };
+    return ranges;
+}
+
+void populateTextRanges(const std::string& text, std::set<GlyphRange>& ranges) {
+    for (char16_t chr : util::convertUTF8ToUTF16(text)) {
+        ranges.insert(getGlyphRange(chr));
+    }
+}
+
+void populatePropertyRanges(const std::string& property, std::set<GlyphRange>& ranges) {
+    for (const char* prefix : {"name_", "name:"}) {
+        if (property.compare(0, 5, prefix) == 0) {
+            const auto language = languageGlyphRanges().find(property.substr(5, property.find_first_of("-_", 5) - 5));
+            if (language != languageGlyphRanges().end()) {
+                ranges.insert(language->second.begin(), language->second.end());
+            }
+            return;
+        }
+    }
+}
+
+// Collects the ranges of the literal strings of a text-field expression, and of the languages of
+// the feature properties it gets.
+void populateExpressionRanges(const expression::Expression& expression, std::set<GlyphRange>& ranges) {
+    if (expression.getKind() == expression::Kind::Literal) {
+        const auto value = static_cast<const expression::Literal&>(expression).getValue();
+        if (value.is<std::string>()) {
+            populateTextRanges(value.get<std::string>(), ranges);
+        }
+        return;
+    }
+
+    const bool get = expression.getKind() == expression::Kind::CompoundExpression &&
+                     static_cast<const expression::CompoundExpression&>(expression).getOperator() == "get";
+    bool key = get;
+    expression.eachChild([&](const expression::Expression& child) {
+        if (key && child.getKind() == expression::Kind::Literal) {
+            const auto value = static_cast<const expression::Literal&>(child).getValue();
+            if (value.is<std::string>()) {
+                populatePropertyRanges(value.get<std::string>(), ranges);
+            }
+        }
+        key = false;
+        populateExpressionRanges(child, ranges);
+    });
+}
+
+} // namespace
+
 bool SymbolLayer::Impl::hasFormatSectionOverrides() const {
     if (!hasFormatSectionOverrides_) {
         hasFormatSectionOverrides_ = SymbolLayerPaintPropertyOverrides::hasOverrides(layout.get<TextField>());
@@ -46,5 +137,31 @@ void SymbolLayer::Impl::populateFontStack(std::set<FontStack>& fontStack) const
     );
 }
 
+void SymbolLayer::Impl::populateGlyphRanges(std::map<FontStack, std::set<GlyphRange>>& ranges) const {
+    std::set<FontStack> fontStacks;
+    populateFontStack(fontStacks);
+    if (fontStacks.empty()) {
+        return;
+    }
+
+    // Nearly every label has spaces, digits or punctuation from Basic Latin and Latin-1.
+    std::set<GlyphRange> needed{{0, 255}};
+    layout.get<TextField>().match(
+        [] (Undefined) {},
+        [&] (const expression::Formatted& constant) {
+            for (const auto& section : constant.sections) {
+                populateTextRanges(section.text, needed);
+            }
+        },
+        [&] (const auto& function) {
+            populateExpressionRanges(function.getExpression(), needed);
+        }
+    );
+
+    for (const auto& fontStack : fontStacks) {
+        ranges[fontStack].insert(needed.begin(), needed.end());
+    }
+}
+
 } // namespace style
 } // namespace mbgl
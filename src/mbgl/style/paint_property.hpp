@@ -22,6 +22,7 @@ public:
     using Type = T;
     static constexpr bool IsDataDriven = false;
     static constexpr bool IsOverridable = false;
+    static constexpr bool IsCrossFaded = false;
 };
 
 template <class T, class A, class U, bool isOverridable = false>
@@ -34,6 +35,7 @@ public:
     using Type = T;
     static constexpr bool IsDataDriven = true;
     static constexpr bool IsOverridable = isOverridable;
+    static constexpr bool IsCrossFaded = false;
 
     using Attribute = A;
     using AttributeList = TypeList<A>;
@@ -51,6 +53,7 @@ public:
     using Type = T;
     static constexpr bool IsDataDriven = true;
     static constexpr bool IsOverridable = false;
+    static constexpr bool IsCrossFaded = true;
 
     using Attribute = A1;
     using AttributeList = TypeList<A1, A2>;
@@ -68,6 +71,7 @@ public:
     using Type = T;
     static constexpr bool IsDataDriven = false;
     static constexpr bool IsOverridable = false;
+    static constexpr bool IsCrossFaded = true;
 };
 
 /*
@@ -89,6 +93,7 @@ public:
     using Type = Color;
     static constexpr bool IsDataDriven = false;
     static constexpr bool IsOverridable = false;
+    static constexpr bool IsCrossFaded = false;
 
     static Color defaultValue() { return {}; }
 };
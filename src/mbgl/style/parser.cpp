@@ -9,6 +9,7 @@
 #include <mbgl/style/conversion_impl.hpp>
 
 #include <mbgl/util/logging.hpp>
+#include <mbgl/util/parallel_for.hpp>
 #include <mbgl/util/string.hpp>
 
 #include <mapbox/geojsonvt.hpp>
@@ -18,10 +19,18 @@
 
 #include <algorithm>
 #include <set>
+#include <unordered_set>
 
 namespace mbgl {
 namespace style {
 
+namespace {
+
+// Styles with fewer layers than this per thread are converted on the calling thread only.
+constexpr std::size_t minLayersPerThread = 64;
+
+} // namespace
+
 Parser::~Parser() = default;
 
 StyleParseResult Parser::parse(const std::string& json) {
@@ -197,7 +206,48 @@ void Parser::parseLayers(const JSValue& value) {
         ids.push_back(layerID);
     }
 
+    // Layers without a ref don't depend on each other, so the ones of large styles are converted
+    // concurrently. Layers with a ref are cloned from their reference afterwards.
+    std::unordered_set<std::string> failed;
+    if (ids.size() >= 2u * minLayersPerThread) {
+        std::vector<std::string> independentIDs;
+        std::vector<const JSValue*> values;
+        for (const auto& id : ids) {
+            const JSValue& layerValue = layersMap.find(id)->second.first;
+            if (!layerValue.HasMember("ref")) {
+                independentIDs.push_back(id);
+                values.push_back(&layerValue);
+            }
+        }
+
+        std::vector<std::unique_ptr<Layer>> convertedLayers(values.size());
+        std::vector<std::string> errors(values.size());
+        util::parallelFor(
+            values.size(),
+            TaskTag::Style,
+            TaskPriority::Default,
+            [&](std::size_t index) {
+                conversion::Error error;
+                if (auto converted = conversion::convert<std::unique_ptr<Layer>>(*values[index], error, deferFilters)) {
+                    convertedLayers[index] = std::move(*converted);
+                } else {
+                    errors[index] = std::move(error.message);
+                }
+            },
+            minLayersPerThread);
+
+        for (std::size_t i = 0; i < independentIDs.size(); ++i) {
+            if (convertedLayers[i]) {
+                layersMap.find(independentIDs[i])->second.second = std::move(convertedLayers[i]);
+            } else {
+                Log::Warning(Event::ParseStyle, errors[i]);
+                failed.insert(independentIDs[i]);
+            }
+        }
+    }
+
     for (const auto& id : ids) {
+        if (failed.count(id)) continue;
         auto it = layersMap.find(id);
 
         parseLayer(it->first,
@@ -257,7 +307,7 @@ void Parser::parseLayer(const std::string& id, const JSValue& value, std::unique
         conversion::setPaintProperties(*layer, conversion::Convertible(&value));
     } else {
         conversion::Error error;
-        optional<std::unique_ptr<Layer>> converted = conversion::convert<std::unique_ptr<Layer>>(value, error);
+        optional<std::unique_ptr<Layer>> converted = conversion::convert<std::unique_ptr<Layer>>(value, error, deferFilters);
         if (!converted) {
             Log::Warning(Event::ParseStyle, error.message);
             return;
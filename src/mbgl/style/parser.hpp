@@ -27,6 +27,10 @@ public:
 
     StyleParseResult parse(const std::string&);
 
+    // Keep the JSON of layer filters and only parse them once they are first evaluated, which happens
+    // when a tile of the layer is laid out. Layers outside the zoom range of the map never pay for it.
+    bool deferFilters = false;
+
     std::string spriteURL;
     std::string glyphURL;
 
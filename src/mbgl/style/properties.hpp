@@ -66,6 +66,10 @@ public:
         return bool(prior);
     }
 
+    bool isZoomConstant() const {
+        return value.isZoomConstant();
+    }
+
     bool isUndefined() const {
         return value.isUndefined();
     }
@@ -278,6 +282,14 @@ public:
             return result;
         }
 
+        // Crossfaded properties depend on the zoom history even when they are constant.
+        bool isZoomConstant() const {
+            bool result = true;
+            util::ignore({ result &= (Ps::IsCrossFaded ? this->template get<Ps>().isUndefined()
+                                                       : this->template get<Ps>().isZoomConstant())... });
+            return result;
+        }
+
         template <class P>
         auto evaluate(const PropertyEvaluationParameters& parameters) const {
             using Evaluator = typename P::EvaluatorType;
@@ -324,6 +336,12 @@ public:
             util::ignore({ (result |= this->template get<Ps>().value.hasDataDrivenPropertyDifference(other.template get<Ps>().value))... });
             return result;
         }
+
+        bool hasDataDrivenKindDifference(const Transitionable& other) const {
+            bool result = false;
+            util::ignore({ (result |= this->template get<Ps>().value.hasDataDrivenKindDifference(other.template get<Ps>().value))... });
+            return result;
+        }
     };
 };
 
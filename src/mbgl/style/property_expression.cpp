@@ -1,14 +1,131 @@
 #include <mbgl/style/property_expression.hpp>
+#include <mbgl/style/expression/compiled_expression.hpp>
+#include <mbgl/style/expression/literal.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
 
 namespace mbgl {
 namespace style {
 
+// The inputs of the stops and the factors of the interpolation between each pair of them are
+// computed once. The stops that were found last are tried first, since consecutive frames
+// mostly stay between the same stops.
+class PropertyExpressionBase::LiteralZoomCurve {
+public:
+    static std::unique_ptr<LiteralZoomCurve> create(const expression::Expression& curve) {
+        using namespace expression;
+
+        auto result = std::make_unique<LiteralZoomCurve>();
+        bool literal = true;
+        auto addStop = [&](double input, const Expression& output) {
+            if (output.getKind() != Kind::Literal) {
+                literal = false;
+                return;
+            }
+            result->inputs.push_back(input);
+            result->outputs.push_back(static_cast<const Literal&>(output).getValue());
+        };
+
+        const Expression* input = nullptr;
+        if (curve.getKind() == Kind::Interpolate) {
+            const auto& interpolate = static_cast<const Interpolate&>(curve);
+            input = interpolate.getInput().get();
+            interpolate.eachStop(addStop);
+            result->interpolate = &interpolate;
+            interpolate.getInterpolator().match(
+                [&](const ExponentialInterpolator& exponential) { result->base = exponential.base; },
+                [&](const CubicBezierInterpolator&) {});
+        } else if (curve.getKind() == Kind::Step) {
+            const auto& step = static_cast<const Step&>(curve);
+            input = step.getInput().get();
+            step.eachStop(addStop);
+        }
+
+        if (!input || input->getOperator() != "zoom" || !literal || result->inputs.empty()) {
+            return nullptr;
+        }
+
+        if (result->base && static_cast<float>(*result->base) != 1.0f) {
+            // Same as the denominator of util::interpolationFactor().
+            for (std::size_t i = 1; i < result->inputs.size(); ++i) {
+                const float zoomDiff = static_cast<float>(result->inputs[i]) - static_cast<float>(result->inputs[i - 1]);
+                result->denominators.push_back(std::pow(static_cast<double>(static_cast<float>(*result->base)), zoomDiff) - 1);
+            }
+        }
+        return result;
+    }
+
+    optional<ZoomCurvePosition> position(float zoom) const noexcept {
+        if (std::isnan(zoom)) {
+            return nullopt;
+        }
+
+        // Index of the first stop above the zoom, like std::map::upper_bound() in Interpolate and Step.
+        std::size_t upper = hint.load(std::memory_order_relaxed);
+        if (!(upper <= inputs.size() && (upper == 0 || inputs[upper - 1] <= zoom) &&
+              (upper == inputs.size() || zoom < inputs[upper]))) {
+            upper = std::upper_bound(inputs.begin(), inputs.end(), static_cast<double>(zoom)) - inputs.begin();
+            hint.store(upper, std::memory_order_relaxed);
+        }
+
+        if (upper == inputs.size()) {
+            return ZoomCurvePosition{upper - 1, upper - 1, 0.0f};
+        } else if (upper == 0) {
+            return ZoomCurvePosition{0, 0, 0.0f};
+        } else if (!interpolate) {
+            return ZoomCurvePosition{upper - 1, upper - 1, 0.0f};
+        }
+        return ZoomCurvePosition{upper - 1, upper, factor(upper - 1, zoom)};
+    }
+
+    std::vector<double> inputs;
+    std::vector<expression::Value> outputs;
+    const expression::Interpolate* interpolate = nullptr;
+
+private:
+    float factor(std::size_t lower, float zoom) const noexcept {
+        if (!base) {
+            return interpolate->interpolationFactor({inputs[lower], inputs[lower + 1]}, zoom);
+        }
+        const float zoomDiff = static_cast<float>(inputs[lower + 1]) - static_cast<float>(inputs[lower]);
+        const float zoomProgress = zoom - static_cast<float>(inputs[lower]);
+        if (zoomDiff == 0) {
+            return 0;
+        } else if (denominators.empty()) {
+            return zoomProgress / zoomDiff;
+        }
+        return (std::pow(static_cast<double>(static_cast<float>(*base)), zoomProgress) - 1) / denominators[lower];
+    }
+
+    optional<double> base;
+    std::vector<double> denominators;
+    mutable std::atomic<std::size_t> hint{0u};
+};
+
 PropertyExpressionBase::PropertyExpressionBase(std::unique_ptr<expression::Expression> expression_)
     : expression(std::move(expression_)),
       zoomCurve(expression::findZoomCurveChecked(expression.get())) {
     isZoomConstant_ = expression::isZoomConstant(*expression);
     isFeatureConstant_ = expression::isFeatureConstant(*expression);
     isRuntimeConstant_ = expression::isRuntimeConstant(*expression);
+    if (isFeatureConstant_ && !isZoomConstant_ && isRuntimeConstant_) {
+        literalZoomCurve = LiteralZoomCurve::create(*expression);
+    }
+}
+
+bool PropertyExpressionBase::isLiteralZoomInterpolation() const noexcept {
+    return literalZoomCurve && literalZoomCurve->interpolate;
+}
+
+const std::vector<expression::Value>& PropertyExpressionBase::literalZoomCurveOutputs() const {
+    static const std::vector<expression::Value> none;
+    return literalZoomCurve ? literalZoomCurve->outputs : none;
+}
+
+optional<PropertyExpressionBase::ZoomCurvePosition> PropertyExpressionBase::literalZoomCurvePosition(float zoom) const noexcept {
+    return literalZoomCurve ? literalZoomCurve->position(zoom) : nullopt;
 }
 
 bool PropertyExpressionBase::isZoomConstant() const noexcept {
@@ -55,5 +172,48 @@ std::shared_ptr<const expression::Expression> PropertyExpressionBase::getSharedE
     return expression;
 }
 
+void PropertyExpressionBase::compileNumber() {
+    compiled = expression::CompiledExpression::compileNumber(*expression);
+}
+
+void PropertyExpressionBase::compileColor() {
+    compiled = expression::CompiledExpression::compileColor(*expression);
+}
+
+optional<float> PropertyExpressionBase::evaluateCompiled(const expression::EvaluationContext& context, float*) const {
+    const optional<double> result = compiled->evaluateNumber(context);
+    return result ? optional<float>(static_cast<float>(*result)) : nullopt;
+}
+
+optional<Color> PropertyExpressionBase::evaluateCompiled(const expression::EvaluationContext& context, Color*) const {
+    return compiled->evaluateColor(context);
+}
+
+void PropertyExpressionBase::evaluateCompiled(const expression::EvaluationContext& context,
+                                              const std::vector<const GeometryTileFeature*>& features,
+                                              std::vector<float>& results,
+                                              float fallback) const {
+    std::vector<optional<double>> values;
+    compiled->evaluateNumbers(context, features, values);
+    results.clear();
+    results.reserve(values.size());
+    for (const auto& value : values) {
+        results.push_back(value ? static_cast<float>(*value) : fallback);
+    }
+}
+
+void PropertyExpressionBase::evaluateCompiled(const expression::EvaluationContext& context,
+                                              const std::vector<const GeometryTileFeature*>& features,
+                                              std::vector<Color>& results,
+                                              Color fallback) const {
+    std::vector<optional<Color>> values;
+    compiled->evaluateColors(context, features, values);
+    results.clear();
+    results.reserve(values.size());
+    for (const auto& value : values) {
+        results.push_back(value ? *value : fallback);
+    }
+}
+
 } // namespace style
 } // namespace mbgl
@@ -55,6 +55,18 @@ optional<uint8_t> Source::getMaxOverscaleFactorForParentTiles() const noexcept {
     return baseImpl->getMaxOverscaleFactorForParentTiles();
 }
 
+void Source::setMaxTileCacheBytes(optional<uint64_t> maxBytes) noexcept {
+    if (getMaxTileCacheBytes() == maxBytes) return;
+    auto newImpl = createMutable();
+    newImpl->setMaxTileCacheBytes(std::move(maxBytes));
+    baseImpl = std::move(newImpl);
+    observer->onSourceChanged(*this);
+}
+
+optional<uint64_t> Source::getMaxTileCacheBytes() const noexcept {
+    return baseImpl->getMaxTileCacheBytes();
+}
+
 void Source::dumpDebugLogs() const {
     Log::Info(Event::General, "Source::id: %s", getID().c_str());
     Log::Info(Event::General, "Source::loaded: %d", loaded);
@@ -37,5 +37,13 @@ optional<uint8_t> Source::Impl::getMaxOverscaleFactorForParentTiles() const noex
     return maxOverscaleFactor;
 }
 
+void Source::Impl::setMaxTileCacheBytes(optional<uint64_t> maxBytes) noexcept {
+    maxTileCacheBytes = std::move(maxBytes);
+}
+
+optional<uint64_t> Source::Impl::getMaxTileCacheBytes() const noexcept {
+    return maxTileCacheBytes;
+}
+
 } // namespace style
 } // namespace mbgl
@@ -24,11 +24,14 @@ public:
     optional<uint8_t> getPrefetchZoomDelta() const noexcept;
     void setMaxOverscaleFactorForParentTiles(optional<uint8_t> overscaleFactor) noexcept;
     optional<uint8_t> getMaxOverscaleFactorForParentTiles() const noexcept;
+    void setMaxTileCacheBytes(optional<uint64_t> maxBytes) noexcept;
+    optional<uint64_t> getMaxTileCacheBytes() const noexcept;
 
     const SourceType type;
     const std::string id;
     optional<uint8_t> prefetchZoomDelta;
     optional<uint8_t> maxOverscaleFactor;
+    optional<uint64_t> maxTileCacheBytes;
 
 protected:
     Impl(SourceType, std::string);
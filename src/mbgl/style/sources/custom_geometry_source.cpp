@@ -17,7 +17,9 @@ namespace style {
 CustomGeometrySource::CustomGeometrySource(std::string id, const CustomGeometrySource::Options& options)
     : Source(makeMutable<CustomGeometrySource::Impl>(std::move(id), options)),
       loader(std::make_unique<Actor<CustomTileLoader>>(
-          Scheduler::GetBackground(), options.fetchTileFunction, options.cancelTileFunction)) {}
+          Scheduler::GetBackground(), options)) {
+    loader->setTag(TaskTag::GeoJSON);
+}
 
 CustomGeometrySource::~CustomGeometrySource() = default;
 
@@ -42,11 +42,12 @@ void GeoJSONSource::setURL(const std::string& url_) {
 namespace {
 
 inline std::shared_ptr<GeoJSONData> createGeoJSONData(const mapbox::geojson::geojson& geoJSON,
-                                                      const GeoJSONSource::Impl& impl) {
+                                                      const GeoJSONSource::Impl& impl,
+                                                      const std::function<void(float)>& onProgress = {}) {
     if (auto data = impl.getData().lock()) {
-        return GeoJSONData::create(geoJSON, impl.getOptions(), data->getScheduler());
+        return GeoJSONData::create(geoJSON, impl.getOptions(), data->getScheduler(), onProgress);
     }
-    return GeoJSONData::create(geoJSON, impl.getOptions());
+    return GeoJSONData::create(geoJSON, impl.getOptions(), nullptr, onProgress);
 }
 
 } // namespace
@@ -61,6 +62,19 @@ void GeoJSONSource::setGeoJSONData(std::shared_ptr<GeoJSONData> geoJSONData) {
     observer->onSourceChanged(*this);
 }
 
+void GeoJSONSource::updateFeatures(const GeoJSONData::Features& features, const std::vector<FeatureIdentifier>& removed) {
+    auto data = impl().getData().lock();
+    if (!data) {
+        setGeoJSON(features);
+        return;
+    }
+    if (auto updated = data->updateFeatures(features, removed)) {
+        setGeoJSONData(std::move(updated));
+    } else {
+        Log::Warning(Event::General, "GeoJSON source \"%s\" doesn't support feature updates", getID().c_str());
+    }
+}
+
 optional<std::string> GeoJSONSource::getURL() const {
     return url;
 }
@@ -69,6 +83,10 @@ const GeoJSONOptions& GeoJSONSource::getOptions() const {
     return *impl().getOptions();
 }
 
+float GeoJSONSource::getLoadProgress() const {
+    return loaded ? 1.0f : loadProgress->load();
+}
+
 void GeoJSONSource::loadDescription(FileSource& fileSource) {
     if (!url) {
         loaded = true;
@@ -89,13 +107,21 @@ void GeoJSONSource::loadDescription(FileSource& fileSource) {
             observer->onSourceError(
                 *this, std::make_exception_ptr(std::runtime_error("unexpectedly empty GeoJSON")));
         } else {
-            auto makeImplInBackground = [currentImpl = baseImpl, data = res.data]() -> Immutable<Source::Impl> {
+            loadProgress->store(0.0f);
+            auto makeImplInBackground = [currentImpl = baseImpl, data = res.data, progress = loadProgress]()
+                -> Immutable<Source::Impl> {
                 assert(data);
                 auto& current = static_cast<const Impl&>(*currentImpl);
                 conversion::Error error;
                 std::shared_ptr<GeoJSONData> geoJSONData;
-                if (optional<GeoJSON> geoJSON = conversion::convertJSON<GeoJSON>(*data, error)) {
-                    geoJSONData = createGeoJSONData(*geoJSON, current);
+                if (optional<GeoJSON> geoJSON = conversion::parseGeoJSON(*data, error)) {
+                    try {
+                        geoJSONData = createGeoJSONData(
+                            *geoJSON, current, [progress](float fraction) { progress->store(fraction); });
+                    } catch (const std::exception& ex) {
+                        // Like unparsable data, data that can't be indexed leaves the source empty.
+                        Log::Error(Event::ParseStyle, "Failed to index GeoJSON data: %s", ex.what());
+                    }
                 } else {
                     // Create an empty GeoJSON VT object to make sure we're not infinitely waiting for tiles to load.
                     Log::Error(Event::ParseStyle, "Failed to parse GeoJSON data: %s", error.message.c_str());
@@ -111,7 +137,7 @@ void GeoJSONSource::loadDescription(FileSource& fileSource) {
                 loaded = true;
                 observer->onSourceLoaded(*this);
             };
-            threadPool->scheduleAndReplyValue(makeImplInBackground, onImplReady);
+            threadPool->scheduleAndReplyValue(TaskTag::GeoJSON, makeImplInBackground, onImplReady);
         }
     });
 }
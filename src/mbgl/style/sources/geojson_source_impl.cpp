@@ -1,23 +1,136 @@
+#include <mbgl/math/clamp.hpp>
 #include <mbgl/style/sources/geojson_source_impl.hpp>
 #include <mbgl/tile/tile_id.hpp>
 #include <mbgl/util/constants.hpp>
 #include <mbgl/util/feature.hpp>
+#include <mbgl/util/geo.hpp>
+#include <mbgl/util/parallel_for.hpp>
 #include <mbgl/util/string.hpp>
 #include <mbgl/util/thread_pool.hpp>
 
 #include <mapbox/geojsonvt.hpp>
+#include <mapbox/geometry/envelope.hpp>
 #include <supercluster.hpp>
 
+#include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace mbgl {
 namespace style {
 
+namespace {
+
+// Feature collections with at least twice as many features are split into chunks, which are
+// indexed in parallel and re-indexed separately when features are updated.
+constexpr std::size_t minFeaturesPerChunk = 4096;
+
+// At most this many bounding boxes are reported for an update, more are merged into one.
+constexpr std::size_t maxChangedBounds = 64;
+
+struct GeoJSONVTChunk {
+    std::shared_ptr<const GeoJSONData::Features> features;
+    std::shared_ptr<mapbox::geojsonvt::GeoJSONVT> index;
+};
+
+// Builds the missing geojson-vt indices of the chunks, in parallel. Works from a background worker too.
+void buildChunkIndices(std::vector<GeoJSONVTChunk>& chunks,
+                       const mapbox::geojsonvt::Options& options,
+                       const std::function<void(float)>& onProgress) {
+    std::vector<std::size_t> pending;
+    for (std::size_t i = 0; i < chunks.size(); ++i) {
+        if (!chunks[i].index) pending.push_back(i);
+    }
+
+    std::mutex mutex;
+    std::size_t done = 0;
+    util::parallelFor(pending.size(), TaskTag::GeoJSON, TaskPriority::Default, [&](std::size_t index) {
+        GeoJSONVTChunk& chunk = chunks[pending[index]];
+        chunk.index = std::make_shared<mapbox::geojsonvt::GeoJSONVT>(*chunk.features, options);
+
+        if (onProgress) {
+            std::lock_guard<std::mutex> lock(mutex);
+            onProgress(float(++done) / pending.size());
+        }
+    });
+}
+
+// Clusters the points only once tiles are requested, and only from clusterMaxZoom down to the
+// lowest zoom requested so far, so that zoom levels that are never shown cost nothing. Each level
+// is clustered from the one above it, so a lower zoom rebuilds the index down to zoom 0.
+class LazySupercluster {
+public:
+    LazySupercluster(GeoJSONData::Features features_, mapbox::supercluster::Options options_)
+        : features(std::move(features_)), options(std::move(options_)), lowestRequestedZoom(options.maxZoom) {}
+
+    // Notes a zoom about to be requested, so that the first build also covers the other tiles
+    // requested with it, e.g. the lower zoom prefetched tiles.
+    void request(std::uint8_t zoom) {
+        std::uint8_t lowest = lowestRequestedZoom;
+        while (zoom < lowest && !lowestRequestedZoom.compare_exchange_weak(lowest, zoom)) {
+        }
+    }
+
+    // Returns the index covering `zoom` and the zooms above it. Must be called with the mutex held.
+    mapbox::supercluster::Supercluster& get(std::uint8_t zoom = 0) {
+        if (!index || zoom < options.minZoom) {
+            options.minZoom = !index ? std::min<std::uint8_t>({zoom, lowestRequestedZoom, options.maxZoom}) : 0;
+            index = std::make_unique<mapbox::supercluster::Supercluster>(features, options);
+            if (options.minZoom == 0) {
+                // The index has all zooms now and keeps its own copy of the points.
+                GeoJSONData::Features().swap(features);
+            }
+        }
+        return *index;
+    }
+
+    std::mutex mutex;
+
+private:
+    GeoJSONData::Features features;
+    mapbox::supercluster::Options options;
+    std::unique_ptr<mapbox::supercluster::Supercluster> index;
+    std::atomic<std::uint8_t> lowestRequestedZoom;
+};
+
+// Supercluster keeps the zoom of a cluster in the low five bits of its id, as zoom + 1.
+std::uint8_t clusterZoom(std::uint32_t clusterID) {
+    const std::uint32_t encoded = clusterID % 32;
+    return encoded > 0 ? encoded - 1 : 0;
+}
+
+void addFeatureBounds(std::vector<LatLngBounds>& bounds, const GeoJSONData::Features::value_type& feature) {
+    const auto box = mapbox::geometry::envelope(feature.geometry);
+    if (!(box.min.x <= box.max.x && box.min.y <= box.max.y) || !std::isfinite(box.min.x) ||
+        !std::isfinite(box.max.x) || !std::isfinite(box.min.y) || !std::isfinite(box.max.y)) {
+        return; // Empty or invalid geometry.
+    }
+    bounds.push_back(LatLngBounds::hull({util::clamp(box.min.y, -90.0, 90.0), box.min.x},
+                                        {util::clamp(box.max.y, -90.0, 90.0), box.max.x}));
+}
+
+} // namespace
+
 class GeoJSONVTData final : public GeoJSONData {
     void getTile(const CanonicalTileID& id, const std::function<void(TileFeatures)>& fn) final {
         assert(fn);
         scheduler->scheduleAndReplyValue(
-            [id, impl = this->impl]() -> TileFeatures { return impl->getTile(id.z, id.x, id.y).features; }, fn);
+            TaskTag::GeoJSON,
+            [id, chunks = this->chunks]() -> TileFeatures {
+                if (chunks.size() == 1) {
+                    return chunks.front().index->getTile(id.z, id.x, id.y).features;
+                }
+                TileFeatures features;
+                for (const auto& chunk : chunks) {
+                    const TileFeatures& chunkFeatures = chunk.index->getTile(id.z, id.x, id.y).features;
+                    features.insert(features.end(), chunkFeatures.begin(), chunkFeatures.end());
+                }
+                return features;
+            },
+            fn);
     }
 
     Features getChildren(const std::uint32_t) final { return {}; }
@@ -30,38 +143,146 @@ class GeoJSONVTData final : public GeoJSONData {
 
     std::shared_ptr<Scheduler> getScheduler() final { return scheduler; }
 
+    std::shared_ptr<GeoJSONData> updateFeatures(const Features& features,
+                                                const std::vector<FeatureIdentifier>& removed) final {
+        std::unordered_set<std::string> removals;
+        for (const auto& id : removed) {
+            if (optional<std::string> key = featureIDtoString(id)) removals.insert(*key);
+        }
+        // Updated features replace the existing ones in place, the others are added at the end.
+        std::unordered_map<std::string, const Features::value_type*> updates;
+        Features added;
+        for (const auto& feature : features) {
+            optional<std::string> key = featureIDtoString(feature.id);
+            if (!key) {
+                added.push_back(feature);
+            } else if (!removals.count(*key)) {
+                updates[*key] = &feature;
+            }
+        }
+        const auto isChanged = [&](const Features::value_type& feature) {
+            optional<std::string> key = featureIDtoString(feature.id);
+            return key && (removals.count(*key) || updates.count(*key));
+        };
+
+        FeatureUpdate update{this, {}};
+
+        // Only chunks with updated or removed features are re-indexed, the others are shared.
+        std::vector<GeoJSONVTChunk> newChunks = chunks;
+        for (auto& chunk : newChunks) {
+            if (std::none_of(chunk.features->begin(), chunk.features->end(), isChanged)) continue;
+
+            auto changed = std::make_shared<Features>();
+            changed->reserve(chunk.features->size());
+            for (const auto& feature : *chunk.features) {
+                optional<std::string> key = featureIDtoString(feature.id);
+                const auto it = key ? updates.find(*key) : updates.end();
+                if (key && removals.count(*key)) {
+                    addFeatureBounds(update.changedBounds, feature);
+                } else if (it != updates.end()) {
+                    addFeatureBounds(update.changedBounds, feature);
+                    // Only the first feature with a duplicate id is replaced, the others are dropped.
+                    if (it->second) {
+                        changed->push_back(*it->second);
+                        addFeatureBounds(update.changedBounds, *it->second);
+                        it->second = nullptr;
+                    }
+                } else {
+                    changed->push_back(feature);
+                }
+            }
+            chunk = {std::move(changed), nullptr};
+        }
+
+        for (const auto& pair : updates) {
+            if (pair.second) added.push_back(*pair.second);
+        }
+        if (!added.empty()) {
+            for (const auto& feature : added) {
+                addFeatureBounds(update.changedBounds, feature);
+            }
+            GeoJSONVTChunk& last = newChunks.back();
+            if (last.features->size() + added.size() < 2 * minFeaturesPerChunk) {
+                auto merged = std::make_shared<Features>(*last.features);
+                merged->insert(merged->end(), added.begin(), added.end());
+                last = {std::move(merged), nullptr};
+            } else {
+                newChunks.push_back({std::make_shared<const Features>(std::move(added)), nullptr});
+            }
+        }
+
+        if (update.changedBounds.size() > maxChangedBounds) {
+            LatLngBounds merged = LatLngBounds::empty();
+            for (const auto& bounds : update.changedBounds) {
+                merged.extend(bounds);
+            }
+            update.changedBounds = {merged};
+        }
+
+        buildChunkIndices(newChunks, options, {});
+        return std::shared_ptr<GeoJSONData>(
+            new GeoJSONVTData(std::move(newChunks), options, scheduler, std::move(update)));
+    }
+
     friend GeoJSONData;
-    GeoJSONVTData(const GeoJSON& geoJSON,
-                  const mapbox::geojsonvt::Options& options,
-                  std::shared_ptr<Scheduler> scheduler_)
-        : impl(std::make_shared<mapbox::geojsonvt::GeoJSONVT>(geoJSON, options)), scheduler(std::move(scheduler_)) {
+    GeoJSONVTData(std::vector<GeoJSONVTChunk> chunks_,
+                  const mapbox::geojsonvt::Options& options_,
+                  std::shared_ptr<Scheduler> scheduler_,
+                  optional<FeatureUpdate> update = nullopt)
+        : chunks(std::move(chunks_)), options(options_), scheduler(std::move(scheduler_)) {
         assert(scheduler);
+        assert(!chunks.empty());
+        featureUpdate = std::move(update);
     }
 
-    std::shared_ptr<mapbox::geojsonvt::GeoJSONVT> impl; // Accessed on worker thread.
+    // The source features and the index of each chunk, the indices are accessed on worker thread.
+    std::vector<GeoJSONVTChunk> chunks;
+    const mapbox::geojsonvt::Options options;
     std::shared_ptr<Scheduler> scheduler;
 };
 
 class SuperclusterData final : public GeoJSONData {
     void getTile(const CanonicalTileID& id, const std::function<void(TileFeatures)>& fn) final {
         assert(fn);
-        fn(impl.getTile(id.z, id.x, id.y));
+        index->request(id.z);
+        scheduler->scheduleAndReplyValue(
+            TaskTag::GeoJSON,
+            [id, index = this->index]() -> TileFeatures {
+                std::lock_guard<std::mutex> lock(index->mutex);
+                return index->get(id.z).getTile(id.z, id.x, id.y);
+            },
+            fn);
     }
 
-    Features getChildren(const std::uint32_t cluster_id) final { return impl.getChildren(cluster_id); }
+    // The queries only need the zooms from the one of the cluster up, which the tile the cluster
+    // id came from has usually built already.
+    Features getChildren(const std::uint32_t cluster_id) final {
+        std::lock_guard<std::mutex> lock(index->mutex);
+        return index->get(clusterZoom(cluster_id)).getChildren(cluster_id);
+    }
 
     Features getLeaves(const std::uint32_t cluster_id, const std::uint32_t limit, const std::uint32_t offset) final {
-        return impl.getLeaves(cluster_id, limit, offset);
+        std::lock_guard<std::mutex> lock(index->mutex);
+        return index->get(clusterZoom(cluster_id)).getLeaves(cluster_id, limit, offset);
     }
 
     std::uint8_t getClusterExpansionZoom(std::uint32_t cluster_id) final {
-        return impl.getClusterExpansionZoom(cluster_id);
+        std::lock_guard<std::mutex> lock(index->mutex);
+        return index->get(clusterZoom(cluster_id)).getClusterExpansionZoom(cluster_id);
     }
 
+    std::shared_ptr<Scheduler> getScheduler() final { return scheduler; }
+
     friend GeoJSONData;
-    SuperclusterData(const Features& features, const mapbox::supercluster::Options& options)
-        : impl(features, options) {}
-    mapbox::supercluster::Supercluster impl;
+    SuperclusterData(const Features& features,
+                     const mapbox::supercluster::Options& options,
+                     std::shared_ptr<Scheduler> scheduler_)
+        : index(std::make_shared<LazySupercluster>(features, options)), scheduler(std::move(scheduler_)) {
+        assert(scheduler);
+    }
+
+    const std::shared_ptr<LazySupercluster> index;
+    std::shared_ptr<Scheduler> scheduler;
 };
 
 template <class T>
@@ -81,7 +302,8 @@ T evaluateFeature(const mapbox::feature::feature<double>& f,
 // static
 std::shared_ptr<GeoJSONData> GeoJSONData::create(const GeoJSON& geoJSON,
                                                  const Immutable<GeoJSONOptions>& options,
-                                                 std::shared_ptr<Scheduler> scheduler) {
+                                                 std::shared_ptr<Scheduler> scheduler,
+                                                 const std::function<void(float)>& onProgress) {
     constexpr double scale = util::EXTENT / util::tileSize;
     if (options->cluster && geoJSON.is<Features>() && !geoJSON.get<Features>().empty()) {
         mapbox::supercluster::Options clusterOptions;
@@ -108,7 +330,12 @@ std::shared_ptr<GeoJSONData> GeoJSONData::create(const GeoJSON& geoJSON,
                 toReturn[p.first] = evaluateFeature<Value>(*feature, p.second.second, accumulated);
             }
         };
-        return std::shared_ptr<GeoJSONData>(new SuperclusterData(geoJSON.get<Features>(), clusterOptions));
+        if (!scheduler) scheduler = Scheduler::GetSequenced();
+        auto data = std::shared_ptr<GeoJSONData>(
+            new SuperclusterData(geoJSON.get<Features>(), clusterOptions, std::move(scheduler)));
+        // The points are clustered lazily, when tiles are requested.
+        if (onProgress) onProgress(1.0f);
+        return data;
     }
 
     mapbox::geojsonvt::Options vtOptions;
@@ -118,7 +345,30 @@ std::shared_ptr<GeoJSONData> GeoJSONData::create(const GeoJSON& geoJSON,
     vtOptions.tolerance = scale * options->tolerance;
     vtOptions.lineMetrics = options->lineMetrics;
     if (!scheduler) scheduler = Scheduler::GetSequenced();
-    return std::shared_ptr<GeoJSONData>(new GeoJSONVTData(geoJSON, vtOptions, std::move(scheduler)));
+
+    // The source features are kept along with the index of their chunk, for re-indexing on updates.
+    std::vector<GeoJSONVTChunk> chunks;
+    if (geoJSON.is<Features>()) {
+        const Features& features = geoJSON.get<Features>();
+        const std::size_t chunkCount =
+            features.size() < 2 * minFeaturesPerChunk
+                ? 1
+                : std::min(features.size() / minFeaturesPerChunk, 4 * ThreadPool::defaultThreadCount());
+        for (std::size_t chunk = 0; chunk < chunkCount; ++chunk) {
+            const std::size_t begin = features.size() * chunk / chunkCount;
+            const std::size_t end = features.size() * (chunk + 1) / chunkCount;
+            chunks.push_back(
+                {std::make_shared<const Features>(features.begin() + begin, features.begin() + end), nullptr});
+        }
+    } else if (geoJSON.is<mapbox::geojson::feature>()) {
+        chunks.push_back(
+            {std::make_shared<const Features>(Features{geoJSON.get<mapbox::geojson::feature>()}), nullptr});
+    } else {
+        mapbox::geojson::feature feature{geoJSON.get<mapbox::geojson::geometry>()};
+        chunks.push_back({std::make_shared<const Features>(Features{std::move(feature)}), nullptr});
+    }
+    buildChunkIndices(chunks, vtOptions, onProgress);
+    return std::shared_ptr<GeoJSONData>(new GeoJSONVTData(std::move(chunks), vtOptions, std::move(scheduler)));
 }
 
 GeoJSONSource::Impl::Impl(std::string id_, Immutable<GeoJSONOptions> options_)
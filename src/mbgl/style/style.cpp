@@ -22,6 +22,14 @@ void Style::loadURL(const std::string& url) {
     impl->loadURL(url);
 }
 
+void Style::applyPatch(const std::string& json) {
+    impl->applyPatch(json);
+}
+
+void Style::setDeferFilterParsing(bool defer) {
+    impl->deferFilterParsing = defer;
+}
+
 std::string Style::getJSON() const {
     return impl->getJSON();
 }
@@ -71,6 +79,14 @@ void Style::addImage(std::unique_ptr<Image> image) {
     impl->addImage(std::move(image));
 }
 
+void Style::addEncodedImage(const std::string& id,
+                            std::shared_ptr<const std::string> data,
+                            float pixelRatio,
+                            bool sdf) {
+    impl->mutated = true;
+    impl->addEncodedImage(id, std::move(data), pixelRatio, sdf);
+}
+
 void Style::removeImage(const std::string& name) {
     impl->mutated = true;
     impl->removeImage(name);
@@ -78,7 +94,11 @@ void Style::removeImage(const std::string& name) {
 
 std::vector<Source*> Style::getSources() {
     impl->mutated = true;
-    return impl->getSources();
+    auto sources = impl->getSources();
+    for (const auto* source : sources) {
+        impl->mutatedSources.insert(source->getID());
+    }
+    return sources;
 }
 
 std::vector<const Source*> Style::getSources() const {
@@ -87,6 +107,7 @@ std::vector<const Source*> Style::getSources() const {
 
 Source* Style::getSource(const std::string& id) {
     impl->mutated = true;
+    impl->mutatedSources.insert(id);
     return impl->getSource(id);
 }
 
@@ -96,11 +117,13 @@ const Source* Style::getSource(const std::string& id) const {
 
 void Style::addSource(std::unique_ptr<Source> source) {
     impl->mutated = true;
+    impl->mutatedSources.insert(source->getID());
     impl->addSource(std::move(source));
 }
 
 std::unique_ptr<Source> Style::removeSource(const std::string& sourceID) {
     impl->mutated = true;
+    impl->mutatedSources.insert(sourceID);
     return impl->removeSource(sourceID);
 }
 
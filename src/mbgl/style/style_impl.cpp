@@ -1,3 +1,4 @@
+#include <mbgl/actor/scheduler.hpp>
 #include <mbgl/gl/custom_layer.hpp>
 #include <mbgl/sprite/sprite_loader.hpp>
 #include <mbgl/storage/file_source.hpp>
@@ -23,7 +24,11 @@
 #include <mbgl/util/exception.hpp>
 #include <mbgl/util/logging.hpp>
 #include <mbgl/util/string.hpp>
+#include <mbgl/util/rapidjson.hpp>
+
 #include <sstream>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace mbgl {
 namespace style {
@@ -83,22 +88,22 @@ void Style::Impl::loadURL(const std::string& url_) {
 
 void Style::Impl::parse(const std::string& json_) {
     Parser parser;
+    parser.deferFilters = deferFilterParsing;
 
     if (auto error = parser.parse(json_)) {
-        std::string message = "Failed to parse style: " + util::toString(error);
-        Log::Error(Event::ParseStyle, message.c_str());
-        observer->onStyleError(std::make_exception_ptr(util::StyleParseException(message)));
-        observer->onResourceError(error);
+        onParseError(error);
         return;
     }
 
     mutated = false;
+    mutatedSources.clear();
     loaded = false;
     json = json_;
 
     sources.clear();
     layers.clear();
     images = makeMutable<ImageImpls>();
+    imageDecodes.clear();
 
     transitionOptions = parser.transition;
 
@@ -130,6 +135,121 @@ void Style::Impl::parse(const std::string& json_) {
     observer->onStyleLoaded();
 }
 
+void Style::Impl::onParseError(std::exception_ptr error) {
+    std::string message = "Failed to parse style: " + util::toString(error);
+    Log::Error(Event::ParseStyle, message.c_str());
+    observer->onStyleError(std::make_exception_ptr(util::StyleParseException(message)));
+    observer->onResourceError(error);
+}
+
+void Style::Impl::applyPatch(const std::string& json_) {
+    if (!loaded) {
+        loadJSON(json_);
+        return;
+    }
+
+    Parser parser;
+    parser.deferFilters = deferFilterParsing;
+
+    if (auto error = parser.parse(json_)) {
+        onParseError(error);
+        return;
+    }
+
+    lastError = nullptr;
+    observer->onStyleLoading();
+    url.clear();
+
+    // Sources can't be serialized, so they are compared by the JSON they were created from, unless
+    // they may have been changed since. Layers are compared by their current serialization.
+    JSDocument previous;
+    previous.Parse<0>(json.c_str());
+    JSDocument next;
+    next.Parse<0>(json_.c_str());
+
+    auto member = [](const JSValue& value, const char* name) -> const JSValue* {
+        if (!value.IsObject()) return nullptr;
+        auto it = value.FindMember(name);
+        return it != value.MemberEnd() ? &it->value : nullptr;
+    };
+    auto sameMember = [&](const JSValue* a, const JSValue* b, const char* name) {
+        const JSValue* aMember = a ? member(*a, name) : nullptr;
+        const JSValue* bMember = b ? member(*b, name) : nullptr;
+        return aMember && bMember ? *aMember == *bMember : aMember == bMember;
+    };
+
+    const JSValue* previousSources = member(previous, "sources");
+    const JSValue* nextSources = member(next, "sources");
+
+    std::unordered_map<std::string, std::unique_ptr<Source>> previousSourcesByID;
+    for (auto& source : sources.release()) {
+        std::string id = source->getID();
+        previousSourcesByID.emplace(std::move(id), std::move(source));
+    }
+    std::unordered_map<std::string, std::unique_ptr<Layer>> previousLayersByID;
+    for (auto& layer : layers.release()) {
+        std::string id = layer->getID();
+        previousLayersByID.emplace(std::move(id), std::move(layer));
+    }
+
+    // Unchanged sources keep their tiles, and unchanged layers keep their impls, so that the
+    // renderer sees no difference for them and neither reloads nor re-evaluates them.
+    std::unordered_set<std::string> replacedSources;
+    for (auto& source : parser.sources) {
+        const std::string& id = source->getID();
+        auto it = previousSourcesByID.find(id);
+        if (it != previousSourcesByID.end() && !mutatedSources.count(id) &&
+            it->second->getType() == source->getType() && sameMember(previousSources, nextSources, id.c_str())) {
+            sources.add(std::move(it->second));
+        } else {
+            if (it != previousSourcesByID.end()) {
+                replacedSources.insert(id);
+            }
+            addSource(std::move(source));
+        }
+    }
+
+    for (auto& layer : parser.layers) {
+        auto it = previousLayersByID.find(layer->getID());
+        if (it != previousLayersByID.end() && !replacedSources.count(layer->getSourceID()) &&
+            it->second->serialize() == layer->serialize()) {
+            layers.add(std::move(it->second));
+        } else {
+            addLayer(std::move(layer));
+        }
+    }
+
+    mutated = false;
+    mutatedSources.clear();
+    json = json_;
+    transitionOptions = parser.transition;
+
+    name = parser.name;
+    defaultCamera.center = parser.latLng;
+    defaultCamera.zoom = parser.zoom;
+    defaultCamera.bearing = parser.bearing;
+    defaultCamera.pitch = parser.pitch;
+
+    if (!sameMember(&previous, &next, "light")) {
+        setLight(std::make_unique<Light>(parser.light));
+    }
+
+    if (!sameMember(&previous, &next, "sprite")) {
+        images = makeMutable<ImageImpls>();
+        imageDecodes.clear();
+        spriteLoaded = false;
+        if (fileSource) {
+            spriteLoader->load(parser.spriteURL, *fileSource);
+        } else {
+            onSpriteError(std::make_exception_ptr(std::runtime_error("Unable to find resource provider for sprite url.")));
+        }
+    }
+    glyphURL = parser.glyphURL;
+
+    observer->onUpdate();
+    observer->onStyleLoaded();
+}
+
 std::string Style::Impl::getJSON() const {
     return json;
 }
@@ -274,6 +394,7 @@ bool Style::Impl::isLoaded() const {
 }
 
 void Style::Impl::addImage(std::unique_ptr<style::Image> image) {
+    imageDecodes.erase(image->getID());
     auto newImages = makeMutable<ImageImpls>(*images);
     auto it =
         std::lower_bound(newImages->begin(), newImages->end(), image->getID(), [](const auto& a, const std::string& b) {
@@ -289,7 +410,56 @@ void Style::Impl::addImage(std::unique_ptr<style::Image> image) {
     observer->onUpdate();
 }
 
+void Style::Impl::addEncodedImage(const std::string& id,
+                                  std::shared_ptr<const std::string> data,
+                                  float pixelRatio,
+                                  bool sdf) {
+    // Invalid arguments throw here, rather than once the image is decoded.
+    if (!data) {
+        throw util::StyleImageException("image data may not be null");
+    }
+    if (!(pixelRatio > 0)) {
+        throw util::StyleImageException("pixelRatio may not be <= 0");
+    }
+
+    const uint64_t decode = ++imageDecodeCount;
+    imageDecodes[id] = decode;
+
+    auto decodeClosure = [id, data = std::move(data)]() -> std::shared_ptr<PremultipliedImage> {
+        try {
+            return std::make_shared<PremultipliedImage>(decodeImage(*data));
+        } catch (...) {
+            Log::Error(Event::Image,
+                       "Failed to decode image '%s': %s",
+                       id.c_str(),
+                       util::toString(std::current_exception()).c_str());
+            return nullptr;
+        }
+    };
+
+    auto resultClosure = [this, weak = weakFactory.makeWeakPtr(), id, decode, pixelRatio, sdf](
+                             std::shared_ptr<PremultipliedImage> image) {
+        if (!weak) return; // The style has been deleted.
+
+        auto it = imageDecodes.find(id);
+        if (it == imageDecodes.end() || it->second != decode) {
+            return; // The image has been added or removed again in the meantime.
+        }
+        imageDecodes.erase(it);
+
+        if (image) {
+            addImage(std::make_unique<style::Image>(id, std::move(*image), pixelRatio, sdf));
+        }
+    };
+
+    if (!threadPool) {
+        threadPool = Scheduler::GetBackground();
+    }
+    threadPool->scheduleAndReplyValue(TaskTag::Style, decodeClosure, resultClosure);
+}
+
 void Style::Impl::removeImage(const std::string& id) {
+    imageDecodes.erase(id);
     auto newImages = makeMutable<ImageImpls>(*images);
     auto found =
         std::find_if(newImages->begin(), newImages->end(), [&id](const auto& image) { return image->id == id; });
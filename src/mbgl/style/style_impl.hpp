@@ -18,15 +18,19 @@
 #include <mbgl/util/optional.hpp>
 #include <mbgl/util/geo.hpp>
 
+#include <mapbox/std/weak.hpp>
+
 #include <memory>
 #include <string>
 #include <vector>
 #include <unordered_map>
+#include <unordered_set>
 
 namespace mbgl {
 
 class FileSource;
 class AsyncRequest;
+class Scheduler;
 class SpriteLoader;
 
 namespace style {
@@ -42,6 +46,7 @@ public:
 
     void loadJSON(const std::string&);
     void loadURL(const std::string&);
+    void applyPatch(const std::string&);
 
     std::string getJSON() const;
     std::string getURL() const;
@@ -79,6 +84,7 @@ public:
 
     optional<Immutable<style::Image::Impl>> getImage(const std::string&) const;
     void addImage(std::unique_ptr<style::Image>);
+    void addEncodedImage(const std::string& id, std::shared_ptr<const std::string> data, float pixelRatio, bool sdf);
     void removeImage(const std::string&);
 
     const std::string& getGlyphURL() const;
@@ -91,11 +97,16 @@ public:
     void dumpDebugLogs() const;
 
     bool mutated = false;
+    // The sources that may have been changed through the API since the style JSON was loaded.
+    // Their JSON doesn't tell, so applyPatch() replaces them even if it is unchanged.
+    std::unordered_set<std::string> mutatedSources;
     bool loaded = false;
     bool spriteLoaded = false;
+    bool deferFilterParsing = false;
 
 private:
     void parse(const std::string&);
+    void onParseError(std::exception_ptr);
 
     std::shared_ptr<FileSource> fileSource;
 
@@ -107,6 +118,10 @@ private:
 
     std::string glyphURL;
     Immutable<ImageImpls> images = makeMutable<ImageImpls>();
+    // The images being decoded, with the number of the decode that the image is added from.
+    std::unordered_map<std::string, uint64_t> imageDecodes;
+    uint64_t imageDecodeCount = 0;
+    std::shared_ptr<Scheduler> threadPool;
     CollectionWithPersistentOrder<Source> sources;
     Collection<Layer> layers;
     TransitionOptions transitionOptions;
@@ -136,6 +151,8 @@ private:
     Observer* observer = &nullObserver;
 
     std::exception_ptr lastError;
+
+    mapbox::base::WeakPtrFactory<Impl> weakFactory{this};
 };
 
 } // namespace style
@@ -3,14 +3,12 @@
 #include <set>
 #include <string>
 #include <vector>
-#include <memory>
 
 #include <mbgl/util/noncopyable.hpp>
 
 namespace mbgl {
 
 class BiDi;
-class BiDiImpl;
 
 std::u16string applyArabicShaping(const std::u16string&);
 
@@ -19,7 +17,10 @@ std::u16string applyArabicShaping(const std::u16string&);
 // The data structure is intended to accomodate the reordering/interleaving
 // of formatting that can happen when BiDi rearranges inputs
 using StyledText = std::pair<std::u16string, std::vector<uint8_t>>;
-    
+
+// Keeps no state of its own: the ICU objects and recent results are kept per thread, so any
+// number of instances may be used on any number of threads, as long as an instance isn't used
+// on two threads at a time.
 class BiDi : private util::noncopyable {
 public:
     BiDi();
@@ -36,8 +37,6 @@ private:
     std::vector<std::u16string> applyLineBreaking(std::set<std::size_t>);
     std::u16string getLine(std::size_t start, std::size_t end);
     std::u16string writeReverse(const std::u16string&, std::size_t, std::size_t);
-
-    std::unique_ptr<BiDiImpl> impl;
 };
 
 } // end namespace mbgl
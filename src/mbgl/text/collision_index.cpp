@@ -32,6 +32,15 @@ inline float findViewportPadding(const TransformState& transformState, MapMode m
     return (transformState.getPitch() != 0.0f) ? viewportPaddingDefault * 2 : viewportPaddingDefault;
 }
 
+CollisionIndex::CollisionGrid::BBox translate(const CollisionIndex::CollisionGrid::BBox& box, Point<float> shift) {
+    return {{box.min.x + shift.x, box.min.y + shift.y}, {box.max.x + shift.x, box.max.y + shift.y}};
+}
+
+CollisionIndex::CollisionGrid::BCircle translate(const CollisionIndex::CollisionGrid::BCircle& circle,
+                                                 Point<float> shift) {
+    return {{circle.center.x + shift.x, circle.center.y + shift.y}, circle.radius};
+}
+
 } // namespace
 
 CollisionIndex::CollisionIndex(const TransformState& transformState_, MapMode mapMode)
@@ -83,6 +92,17 @@ bool CollisionIndex::isInsideGrid(const CollisionBoundaries& boundaries) const {
            boundaries[1] < gridBottomBoundary;
 }
 
+template <class Geometry>
+bool CollisionIndex::hitTest(const Geometry& geometry,
+                             const optional<std::function<bool(const IndexedSubfeature&)>>& predicate) {
+    ++statistics.tests;
+    statistics.gridCells += collisionGrid.cellCount(geometry);
+    // Hands the predicate to the grid by reference, so that it isn't copied for every box.
+    const bool hit = predicate ? collisionGrid.hitTest(geometry, *predicate) : collisionGrid.hitTest(geometry);
+    statistics.collisions += hit;
+    return hit;
+}
+
 CollisionBoundaries CollisionIndex::projectTileBoundaries(const mat4& posMatrix) const {
     Point<float> topLeft = projectPoint(posMatrix, { 0, 0 });
     Point<float> bottomRight = projectPoint(posMatrix, { util::EXTENT, util::EXTENT });
@@ -160,20 +180,43 @@ std::pair<bool, bool> CollisionIndex::placeFeature(
     assert(projectedBoxes.empty());
     if (!feature.alongLine) {
         const CollisionBox& box = feature.boxes.front();
-        auto collisionBoundaries = getProjectedCollisionBoundaries(posMatrix, shift, textPixelRatio, box);
-        projectedBoxes.emplace_back(
-            collisionBoundaries[0], collisionBoundaries[1], collisionBoundaries[2], collisionBoundaries[3]);
-        if ((avoidEdges && !isInsideTile(collisionBoundaries, *avoidEdges)) || !isInsideGrid(collisionBoundaries) ||
-            (!allowOverlap && collisionGrid.hitTest(projectedBoxes.back().box(), collisionGroupPredicate))) {
-            return { false, false };
-        }
-
-        return {true, isOffscreen(collisionBoundaries)};
+        return placeBox(box,
+                        projectAndGetPerspectiveRatio(posMatrix, box.anchor),
+                        shift,
+                        textPixelRatio,
+                        allowOverlap,
+                        avoidEdges,
+                        collisionGroupPredicate,
+                        projectedBoxes);
     } else {
         return placeLineFeature(feature, posMatrix, labelPlaneMatrix, textPixelRatio, symbol, scale, fontSize, allowOverlap, pitchWithMap, collisionDebug, avoidEdges, collisionGroupPredicate, projectedBoxes);
     }
 }
 
+std::pair<bool, bool> CollisionIndex::placeBox(
+    const CollisionBox& box,
+    const ProjectedAnchor& projectedAnchor,
+    Point<float> shift,
+    const float textPixelRatio,
+    const bool allowOverlap,
+    const optional<CollisionBoundaries>& avoidEdges,
+    const optional<std::function<bool(const IndexedSubfeature&)>>& collisionGroupPredicate,
+    std::vector<ProjectedCollisionBox>& projectedBoxes) {
+    assert(projectedBoxes.empty());
+    auto collisionBoundaries = getProjectedCollisionBoundaries(projectedAnchor, shift, textPixelRatio, box);
+    projectedBoxes.emplace_back(
+        collisionBoundaries[0], collisionBoundaries[1], collisionBoundaries[2], collisionBoundaries[3]);
+    if ((avoidEdges && !isInsideTile(collisionBoundaries, *avoidEdges)) || !isInsideGrid(collisionBoundaries)) {
+        ++statistics.offscreen;
+        return {false, false};
+    }
+    if (!allowOverlap && hitTest(projectedBoxes.back().box(), collisionGroupPredicate)) {
+        return {false, false};
+    }
+
+    return {true, isOffscreen(collisionBoundaries)};
+}
+
 std::pair<bool, bool> CollisionIndex::placeLineFeature(
     const CollisionFeature& feature,
     const mat4& posMatrix,
@@ -288,8 +331,9 @@ std::pair<bool, bool> CollisionIndex::placeLineFeature(
         entirelyOffscreen &= isOffscreen(collisionBoundaries);
         inGrid |= isInsideGrid(collisionBoundaries);
 
-        if ((avoidEdges && !isInsideTile(collisionBoundaries, *avoidEdges)) ||
-            (!allowOverlap && collisionGrid.hitTest(projectedBoxes[i].circle(), collisionGroupPredicate))) {
+        const bool crossesTileEdges = avoidEdges && !isInsideTile(collisionBoundaries, *avoidEdges);
+        if (crossesTileEdges || (!allowOverlap && hitTest(projectedBoxes[i].circle(), collisionGroupPredicate))) {
+            statistics.offscreen += crossesTileEdges;
             if (!collisionDebug) {
                 return {false, false};
             } else {
@@ -300,6 +344,9 @@ std::pair<bool, bool> CollisionIndex::placeLineFeature(
         }
     }
 
+    if (!collisionDetected && firstAndLastGlyph && !inGrid) {
+        ++statistics.offscreen;
+    }
     return {!collisionDetected && firstAndLastGlyph && inGrid, entirelyOffscreen};
 }
 
@@ -340,6 +387,25 @@ void CollisionIndex::insertFeature(const CollisionFeature& feature, const std::v
     }
 }
 
+void CollisionIndex::insertFeatures(const CollisionIndex& other) {
+    collisionGrid.insert(other.collisionGrid);
+    ignoredGrid.insert(other.ignoredGrid);
+}
+
+void CollisionIndex::insertFeatures(const CollisionIndex& other,
+                                    const std::unordered_set<uint32_t>& bucketInstanceIds,
+                                    Point<float> shift) {
+    const auto shifted = [&](CollisionGrid& grid) {
+        return [&grid, &bucketInstanceIds, shift](const IndexedSubfeature& feature, const auto& geometry) {
+            if (bucketInstanceIds.count(feature.bucketInstanceId) != 0u) {
+                grid.insert(IndexedSubfeature(feature), translate(geometry, shift));
+            }
+        };
+    };
+    other.collisionGrid.forEach(shifted(collisionGrid));
+    other.ignoredGrid.forEach(shifted(ignoredGrid));
+}
+
 bool polygonIntersectsBox(const LineString<float>& polygon, const GridIndex<IndexedSubfeature>::BBox& bbox) {
     // This is just a wrapper that allows us to use the integer-based util::polygonIntersectsPolygon
     // Conversion limits our query accuracy to single-pixel resolution
@@ -409,7 +475,7 @@ std::pair<float,float> CollisionIndex::projectAnchor(const mat4& posMatrix, cons
     );
 }
 
-std::pair<Point<float>,float> CollisionIndex::projectAndGetPerspectiveRatio(const mat4& posMatrix, const Point<float>& point) const {
+CollisionIndex::ProjectedAnchor CollisionIndex::projectAndGetPerspectiveRatio(const mat4& posMatrix, const Point<float>& point) const {
     vec4 p = {{ point.x, point.y, 0, 1 }};
     matrix::transformMat4(p, p, posMatrix);
     auto size = transformState.getSize();
@@ -438,7 +504,14 @@ CollisionBoundaries CollisionIndex::getProjectedCollisionBoundaries(const mat4&
                                                                     Point<float> shift,
                                                                     float textPixelRatio,
                                                                     const CollisionBox& box) const {
-    const auto projectedPoint = projectAndGetPerspectiveRatio(posMatrix, box.anchor);
+    return getProjectedCollisionBoundaries(
+        projectAndGetPerspectiveRatio(posMatrix, box.anchor), shift, textPixelRatio, box);
+}
+
+CollisionBoundaries CollisionIndex::getProjectedCollisionBoundaries(const ProjectedAnchor& projectedPoint,
+                                                                    Point<float> shift,
+                                                                    float textPixelRatio,
+                                                                    const CollisionBox& box) const {
     const float tileToViewport = textPixelRatio * projectedPoint.second;
     return CollisionBoundaries{{
         (box.x1 + shift.x) * tileToViewport + projectedPoint.first.x,
@@ -7,6 +7,8 @@
 #include <mbgl/map/transform_state.hpp>
 
 #include <array>
+#include <functional>
+#include <unordered_set>
 
 namespace mbgl {
 
@@ -25,6 +27,16 @@ class CollisionIndex {
 public:
     using CollisionGrid = GridIndex<IndexedSubfeature>;
 
+    // Running totals of the placeFeature() calls on the index.
+    struct Statistics {
+        // Collision tests, the grid cells they looked into, and those that hit a placed feature.
+        std::size_t tests = 0;
+        std::size_t gridCells = 0;
+        std::size_t collisions = 0;
+        // Features rejected outside of the grid, or crossing the tile edges they have to avoid.
+        std::size_t offscreen = 0;
+    };
+
     explicit CollisionIndex(const TransformState&, MapMode);
     IntersectStatus intersectsTileEdges(const CollisionBox&,
                                         Point<float> shift,
@@ -47,8 +59,29 @@ public:
         const optional<std::function<bool(const IndexedSubfeature&)>>& collisionGroupPredicate,
         std::vector<ProjectedCollisionBox>& /*out*/);
 
+    // The viewport position of an anchor, with the perspective ratio that scales the boxes around it.
+    using ProjectedAnchor = std::pair<Point<float>, float>;
+    ProjectedAnchor projectAndGetPerspectiveRatio(const mat4& posMatrix, const Point<float>& point) const;
+
+    // Places the box of a point feature around an anchor projected once for all the positions
+    // tried for the feature, such as the variable anchors of a label. Same as placeFeature()
+    // otherwise.
+    std::pair<bool, bool> placeBox(const CollisionBox&,
+                                   const ProjectedAnchor&,
+                                   Point<float> shift,
+                                   float textPixelRatio,
+                                   bool allowOverlap,
+                                   const optional<CollisionBoundaries>& avoidEdges,
+                                   const optional<std::function<bool(const IndexedSubfeature&)>>& collisionGroupPredicate,
+                                   std::vector<ProjectedCollisionBox>& /*out*/);
+
     void insertFeature(const CollisionFeature& feature, const std::vector<ProjectedCollisionBox>&, bool ignorePlacement, uint32_t bucketInstanceId, uint16_t collisionGroupId);
 
+    // Adds the features placed into another index for the same transform state.
+    void insertFeatures(const CollisionIndex&);
+    // Adds the features of the given buckets from an index whose viewport was `shift` pixels away.
+    void insertFeatures(const CollisionIndex&, const std::unordered_set<uint32_t>& bucketInstanceIds, Point<float> shift);
+
     std::unordered_map<uint32_t, std::vector<IndexedSubfeature>> queryRenderedSymbols(const ScreenLineString&) const;
 
     CollisionBoundaries projectTileBoundaries(const mat4& posMatrix) const;
@@ -57,9 +90,13 @@ public:
 
     float getViewportPadding() const { return viewportPadding; }
 
+    const Statistics& getStatistics() const { return statistics; }
+
 private:
     bool isOffscreen(const CollisionBoundaries&) const;
     bool isInsideGrid(const CollisionBoundaries&) const;
+    template <class Geometry>
+    bool hitTest(const Geometry&, const optional<std::function<bool(const IndexedSubfeature&)>>& predicate);
     bool isInsideTile(const CollisionBoundaries& boundaries, const CollisionBoundaries& tileBoundaries) const;
     bool overlapsTile(const CollisionBoundaries& boundaries, const CollisionBoundaries& tileBoundaries) const;
 
@@ -85,12 +122,15 @@ private:
                                   bool pitchWithMap);
 
     std::pair<float,float> projectAnchor(const mat4& posMatrix, const Point<float>& point) const;
-    std::pair<Point<float>,float> projectAndGetPerspectiveRatio(const mat4& posMatrix, const Point<float>& point) const;
     Point<float> projectPoint(const mat4& posMatrix, const Point<float>& point) const;
     CollisionBoundaries getProjectedCollisionBoundaries(const mat4& posMatrix,
                                                         Point<float> shift,
                                                         float textPixelRatio,
                                                         const CollisionBox& box) const;
+    CollisionBoundaries getProjectedCollisionBoundaries(const ProjectedAnchor&,
+                                                        Point<float> shift,
+                                                        float textPixelRatio,
+                                                        const CollisionBox& box) const;
 
     const TransformState transformState;
 
@@ -104,6 +144,8 @@ private:
     const float gridBottomBoundary;
     
     const float pitchFactor;
+
+    Statistics statistics;
 };
 
 } // namespace mbgl
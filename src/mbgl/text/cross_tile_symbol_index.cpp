@@ -4,6 +4,9 @@
 #include <mbgl/renderer/render_tile.hpp>
 #include <mbgl/tile/tile.hpp>
 
+#include <algorithm>
+#include <iterator>
+
 namespace mbgl {
 
 TileLayerIndex::TileLayerIndex(OverscaledTileID coord_,
@@ -11,10 +14,28 @@ TileLayerIndex::TileLayerIndex(OverscaledTileID coord_,
                                uint32_t bucketInstanceId_,
                                std::string bucketLeaderId_)
     : coord(coord_), bucketInstanceId(bucketInstanceId_), bucketLeaderId(std::move(bucketLeaderId_)) {
+    uint32_t order = 0;
     for (SymbolInstance& symbolInstance : symbolInstances) {
         if (symbolInstance.crossTileID == SymbolInstance::invalidCrossTileID()) continue;
-        indexedSymbolInstances[symbolInstance.key].emplace_back(symbolInstance.crossTileID,
-                                                                getScaledCoordinates(symbolInstance, coord));
+        auto& groups = indexedSymbolInstances[symbolInstance.keyHash];
+        auto group = std::find_if(groups.begin(), groups.end(), [&](const IndexedSymbolGroup& candidate) {
+            return candidate.key == symbolInstance.key;
+        });
+        if (group == groups.end()) {
+            groups.emplace_back(symbolInstance.key);
+            group = std::prev(groups.end());
+        }
+        group->instances.emplace_back(symbolInstance.crossTileID, getScaledCoordinates(symbolInstance, coord), order++);
+    }
+
+    for (auto& groups : indexedSymbolInstances) {
+        for (auto& group : groups.second) {
+            std::stable_sort(group.instances.begin(),
+                             group.instances.end(),
+                             [](const IndexedSymbolInstance& a, const IndexedSymbolInstance& b) {
+                                 return a.coord.x < b.coord.x;
+                             });
+        }
     }
 }
 
@@ -29,11 +50,22 @@ Point<int64_t> TileLayerIndex::getScaledCoordinates(SymbolInstance& symbolInstan
     };
 }
 
+const IndexedSymbolGroup* TileLayerIndex::findGroup(const SymbolInstance& symbolInstance) const {
+    auto it = indexedSymbolInstances.find(symbolInstance.keyHash);
+    if (it == indexedSymbolInstances.end()) return nullptr;
+    for (const IndexedSymbolGroup& group : it->second) {
+        if (group.key == symbolInstance.key) return &group;
+    }
+    return nullptr;
+}
+
 void TileLayerIndex::findMatches(SymbolBucket& bucket,
                                  const OverscaledTileID& newCoord,
-                                 std::set<uint32_t>& zoomCrossTileIDs) const {
+                                 std::unordered_set<uint32_t>& zoomCrossTileIDs) const {
     auto& symbolInstances = bucket.symbolInstances;
-    float tolerance = coord.canonical.z < newCoord.canonical.z ? 1 : std::pow(2, coord.canonical.z - newCoord.canonical.z);
+    // The tolerance is always a whole number of grid units.
+    const int64_t tolerance =
+        coord.canonical.z < newCoord.canonical.z ? 1 : (int64_t(1) << (coord.canonical.z - newCoord.canonical.z));
 
     if (bucket.bucketLeaderID != bucketLeaderId) return;
 
@@ -43,28 +75,37 @@ void TileLayerIndex::findMatches(SymbolBucket& bucket,
             continue;
         }
 
-        auto it = indexedSymbolInstances.find(symbolInstance.key);
-        if (it == indexedSymbolInstances.end()) {
+        const IndexedSymbolGroup* group = findGroup(symbolInstance);
+        if (!group) {
             // No symbol with this key in this bucket
             continue;
         }
 
         auto scaledSymbolCoord = getScaledCoordinates(symbolInstance, newCoord);
 
-        for (const IndexedSymbolInstance& thisTileSymbol : it->second) {
-            // Return any symbol with the same keys whose coordinates are within 1
-            // grid unit. (with a 4px grid, this covers a 12px by 12px area)
-            if (std::abs(thisTileSymbol.coord.x - scaledSymbolCoord.x) <= tolerance &&
-                std::abs(thisTileSymbol.coord.y - scaledSymbolCoord.y) <= tolerance &&
-                zoomCrossTileIDs.find(thisTileSymbol.crossTileID) == zoomCrossTileIDs.end()) {
-                // Once we've marked ourselves duplicate against this parent symbol,
-                // don't let any other symbols at the same zoom level duplicate against
-                // the same parent (see issue #10844)
-                zoomCrossTileIDs.insert(thisTileSymbol.crossTileID);
-                symbolInstance.crossTileID = thisTileSymbol.crossTileID;
-                break;
+        // Return any symbol with the same keys whose coordinates are within 1
+        // grid unit. (with a 4px grid, this covers a 12px by 12px area)
+        // Candidates are found by their x coordinate; when several of them match, the one that
+        // came first in its bucket wins.
+        const IndexedSymbolInstance* match = nullptr;
+        auto it = std::lower_bound(group->instances.begin(),
+                                   group->instances.end(),
+                                   scaledSymbolCoord.x - tolerance,
+                                   [](const IndexedSymbolInstance& a, int64_t x) { return a.coord.x < x; });
+        for (; it != group->instances.end() && it->coord.x <= scaledSymbolCoord.x + tolerance; ++it) {
+            if (std::abs(it->coord.y - scaledSymbolCoord.y) <= tolerance && (!match || it->order < match->order) &&
+                zoomCrossTileIDs.find(it->crossTileID) == zoomCrossTileIDs.end()) {
+                match = &*it;
             }
         }
+
+        if (match) {
+            // Once we've marked ourselves duplicate against this parent symbol,
+            // don't let any other symbols at the same zoom level duplicate against
+            // the same parent (see issue #10844)
+            zoomCrossTileIDs.insert(match->crossTileID);
+            symbolInstance.crossTileID = match->crossTileID;
+        }
     }
 }
 
@@ -184,9 +225,12 @@ bool CrossTileSymbolLayerIndex::addBucket(const OverscaledTileID& tileID,
 }
 
 void CrossTileSymbolLayerIndex::removeBucketCrossTileIDs(uint8_t zoom, const TileLayerIndex& removedBucket) {
-    for (const auto& key : removedBucket.indexedSymbolInstances) {
-        for (auto indexedSymbolInstance : key.second) {
-            usedCrossTileIDs[zoom].erase(indexedSymbolInstance.crossTileID);
+    auto& zoomCrossTileIDs = usedCrossTileIDs[zoom];
+    for (const auto& groups : removedBucket.indexedSymbolInstances) {
+        for (const auto& group : groups.second) {
+            for (const auto& indexedSymbolInstance : group.instances) {
+                zoomCrossTileIDs.erase(indexedSymbolInstance.crossTileID);
+            }
         }
     }
 }
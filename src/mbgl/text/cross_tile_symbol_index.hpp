@@ -12,6 +12,7 @@
 #include <vector>
 #include <string>
 #include <memory>
+#include <unordered_map>
 #include <unordered_set>
 
 namespace mbgl {
@@ -22,12 +23,23 @@ class SymbolBucket;
 
 class IndexedSymbolInstance {
 public:
-    IndexedSymbolInstance(uint32_t crossTileID_, Point<int64_t> coord_)
-        : crossTileID(crossTileID_), coord(coord_)
+    IndexedSymbolInstance(uint32_t crossTileID_, Point<int64_t> coord_, uint32_t order_)
+        : crossTileID(crossTileID_), coord(coord_), order(order_)
     {}
 
     uint32_t crossTileID;
     Point<int64_t> coord;
+    // Position of the symbol in its bucket, which decides between several matching symbols.
+    uint32_t order;
+};
+
+// The indexed symbols of a tile that share the same key, sorted by their x coordinate.
+class IndexedSymbolGroup {
+public:
+    explicit IndexedSymbolGroup(std::u16string key_) : key(std::move(key_)) {}
+
+    std::u16string key;
+    std::vector<IndexedSymbolInstance> instances;
 };
 
 class TileLayerIndex {
@@ -38,12 +50,15 @@ public:
                    std::string bucketLeaderId);
 
     Point<int64_t> getScaledCoordinates(SymbolInstance&, const OverscaledTileID&) const;
-    void findMatches(SymbolBucket&, const OverscaledTileID&, std::set<uint32_t>&) const;
+    void findMatches(SymbolBucket&, const OverscaledTileID&, std::unordered_set<uint32_t>&) const;
+    const IndexedSymbolGroup* findGroup(const SymbolInstance&) const;
 
     OverscaledTileID coord;
     uint32_t bucketInstanceId;
     std::string bucketLeaderId;
-    std::map<std::u16string,std::vector<IndexedSymbolInstance>> indexedSymbolInstances;
+    // Groups are looked up by the precomputed hash of their key. Different keys with the same
+    // hash end up in the same bucket of the map.
+    std::unordered_map<std::size_t, std::vector<IndexedSymbolGroup>> indexedSymbolInstances;
 };
 
 class CrossTileSymbolLayerIndex {
@@ -56,7 +71,7 @@ private:
     void removeBucketCrossTileIDs(uint8_t zoom, const TileLayerIndex& removedBucket);
 
     std::map<uint8_t, std::map<OverscaledTileID,TileLayerIndex>> indexes;
-    std::map<uint8_t, std::set<uint32_t>> usedCrossTileIDs;
+    std::map<uint8_t, std::unordered_set<uint32_t>> usedCrossTileIDs;
     float lng = 0;
     uint32_t& maxCrossTileID;
 };
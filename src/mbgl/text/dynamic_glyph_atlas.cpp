@@ -0,0 +1,157 @@
+#include <mbgl/text/dynamic_glyph_atlas.hpp>
+#include <mbgl/gfx/upload_pass.hpp>
+
+#include <algorithm>
+#include <cassert>
+
+namespace mbgl {
+
+namespace {
+
+constexpr uint32_t padding = 1;
+constexpr int32_t initialSize = 128;
+
+mapbox::ShelfPack::ShelfPackOptions packOptions() {
+    mapbox::ShelfPack::ShelfPackOptions options;
+    options.autoResize = true;
+    return options;
+}
+
+// Whether an entry of the atlas can stand for the glyph. Tiles usually get the glyphs of the
+// same font stack from the same glyph manager, so the bitmaps are rarely compared.
+bool isSameGlyph(const Immutable<Glyph>& lhs, const Immutable<Glyph>& rhs) {
+    return lhs == rhs || (lhs->metrics == rhs->metrics && lhs->bitmap.size == rhs->bitmap.size &&
+                          lhs->bitmap == rhs->bitmap);
+}
+
+} // namespace
+
+DynamicGlyphAtlas::Reservation::Reservation(std::weak_ptr<DynamicGlyphAtlas> atlas_, std::vector<GlyphKey> glyphs_)
+    : atlas(std::move(atlas_)), glyphs(std::move(glyphs_)) {}
+
+DynamicGlyphAtlas::Reservation::~Reservation() {
+    if (auto shared = atlas.lock()) {
+        shared->release(glyphs);
+    }
+}
+
+std::shared_ptr<DynamicGlyphAtlas> DynamicGlyphAtlas::create() {
+    return std::shared_ptr<DynamicGlyphAtlas>(new DynamicGlyphAtlas());
+}
+
+DynamicGlyphAtlas::DynamicGlyphAtlas()
+    : pack(initialSize, initialSize, packOptions()), image({uint32_t(initialSize), uint32_t(initialSize)}) {
+    image.fill(0);
+}
+
+DynamicGlyphAtlas::~DynamicGlyphAtlas() = default;
+
+std::shared_ptr<const DynamicGlyphAtlas::Reservation> DynamicGlyphAtlas::addGlyphs(const GlyphMap& glyphMap,
+                                                                                   GlyphPositions& positions) {
+    std::vector<GlyphKey> reserved;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto& glyphMapEntry : glyphMap) {
+        const FontStackHash fontStack = glyphMapEntry.first;
+        GlyphPositionMap& fontPositions = positions[fontStack];
+        auto& fontEntries = entries[fontStack];
+
+        for (const auto& glyphEntry : glyphMapEntry.second) {
+            if (!glyphEntry.second || !(*glyphEntry.second)->bitmap.valid()) {
+                continue;
+            }
+            const Immutable<Glyph>& glyphPtr = *glyphEntry.second;
+            const Glyph& glyph = *glyphPtr;
+
+            auto range = fontEntries.equal_range(glyph.id);
+            auto it = std::find_if(range.first, range.second, [&](const auto& entry) {
+                return isSameGlyph(entry.second.glyph, glyphPtr);
+            });
+            if (it != range.second) {
+                ++it->second.references;
+            } else {
+                const mapbox::Bin* bin = pack.packOne(
+                    -1, glyph.bitmap.size.width + 2 * padding, glyph.bitmap.size.height + 2 * padding);
+                assert(bin);
+
+                if (uint32_t(pack.width()) > image.size.width || uint32_t(pack.height()) > image.size.height) {
+                    image.resize({uint32_t(pack.width()), uint32_t(pack.height())});
+                }
+
+                const Rect<uint16_t> rect{static_cast<uint16_t>(bin->x),
+                                          static_cast<uint16_t>(bin->y),
+                                          static_cast<uint16_t>(bin->w),
+                                          static_cast<uint16_t>(bin->h)};
+                // The bin may hold the pixels of a released glyph.
+                AlphaImage::clear(image, {rect.x, rect.y}, {rect.w, rect.h});
+                AlphaImage::copy(glyph.bitmap,
+                                 image,
+                                 {0, 0},
+                                 {rect.x + padding, rect.y + padding},
+                                 glyph.bitmap.size);
+                dirtyRects.push_back(rect);
+                dirty = true;
+
+                it = fontEntries.emplace(glyph.id, Entry{glyphPtr, bin->id, GlyphPosition{rect, glyph.metrics}, 1u});
+            }
+
+            fontPositions.emplace(glyph.id, it->second.position);
+            reserved.emplace_back(fontStack, glyph.id, it->second.glyph.get());
+        }
+    }
+
+    return std::shared_ptr<const Reservation>(new Reservation(shared_from_this(), std::move(reserved)));
+}
+
+void DynamicGlyphAtlas::release(const std::vector<GlyphKey>& glyphs) {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto& glyph : glyphs) {
+        auto fontEntries = entries.find(std::get<0>(glyph));
+        assert(fontEntries != entries.end());
+        auto range = fontEntries->second.equal_range(std::get<1>(glyph));
+        auto it = std::find_if(range.first, range.second, [&](const auto& entry) {
+            return entry.second.glyph.get() == std::get<2>(glyph);
+        });
+        assert(it != range.second);
+        if (--it->second.references == 0) {
+            if (mapbox::Bin* bin = pack.getBin(it->second.binID)) {
+                pack.unref(*bin);
+            }
+            fontEntries->second.erase(it);
+        }
+    }
+}
+
+void DynamicGlyphAtlas::upload(gfx::UploadPass& uploadPass) {
+    if (!dirty.exchange(false) && texture) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!texture || texture->size != image.size) {
+        texture = uploadPass.createTexture(image);
+    } else {
+        for (const auto& rect : dirtyRects) {
+            AlphaImage patch({rect.w, rect.h});
+            AlphaImage::copy(image, patch, {rect.x, rect.y}, {0, 0}, patch.size);
+            uploadPass.updateTextureSub(*texture, patch, rect.x, rect.y);
+        }
+    }
+    dirtyRects.clear();
+}
+
+Size DynamicGlyphAtlas::getSize() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return image.size;
+}
+
+std::size_t DynamicGlyphAtlas::glyphCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::size_t count = 0;
+    for (const auto& fontEntries : entries) {
+        count += fontEntries.second.size();
+    }
+    return count;
+}
+
+} // namespace mbgl
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <mbgl/gfx/texture.hpp>
+#include <mbgl/text/glyph_atlas.hpp>
+#include <mbgl/util/noncopyable.hpp>
+#include <mbgl/util/optional.hpp>
+
+#include <mapbox/shelf-pack.hpp>
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace mbgl {
+
+namespace gfx {
+class UploadPass;
+} // namespace gfx
+
+/**
+ * @brief A glyph atlas shared by all tiles of a renderer.
+ *
+ * Tile workers add the glyphs of their layout with addGlyphs() and keep the returned
+ * reservation for as long as their buckets refer to the glyph positions. Glyphs used by
+ * several tiles are stored once, and the space of glyphs that are no longer reserved by any
+ * tile is reused. Glyphs never move, so positions stay valid when the atlas grows.
+ *
+ * addGlyphs() may be called from any thread; upload() and getTexture() are only used on the
+ * render thread. upload() only sends the glyphs added since the previous upload, unless the
+ * atlas has grown in between.
+ */
+class DynamicGlyphAtlas : public std::enable_shared_from_this<DynamicGlyphAtlas>, private util::noncopyable {
+private:
+    // A glyph of a font stack, told apart from other versions of it by its bitmap, e.g. when it was
+    // loaded again from the glyph URL of another style while tiles still use the old one.
+    using GlyphKey = std::tuple<FontStackHash, GlyphID, const Glyph*>;
+
+public:
+    class Reservation : private util::noncopyable {
+    public:
+        ~Reservation();
+
+    private:
+        friend class DynamicGlyphAtlas;
+        Reservation(std::weak_ptr<DynamicGlyphAtlas>, std::vector<GlyphKey>);
+
+        const std::weak_ptr<DynamicGlyphAtlas> atlas;
+        const std::vector<GlyphKey> glyphs;
+    };
+
+    static std::shared_ptr<DynamicGlyphAtlas> create();
+    ~DynamicGlyphAtlas();
+
+    // Adds the glyphs that aren't in the atlas yet and writes the positions of all glyphs with
+    // a bitmap to `positions`. The glyphs stay in place until the reservation is released.
+    std::shared_ptr<const Reservation> addGlyphs(const GlyphMap&, GlyphPositions& positions);
+
+    void upload(gfx::UploadPass&);
+
+    // Null before the first upload.
+    const gfx::Texture* getTexture() const { return texture ? &*texture : nullptr; }
+
+    // The size of the atlas image, which the texture catches up with on the next upload.
+    Size getSize() const;
+    // The number of glyphs currently in the atlas.
+    std::size_t glyphCount() const;
+
+private:
+    DynamicGlyphAtlas();
+
+    void release(const std::vector<GlyphKey>&);
+
+    struct Entry {
+        // Keeps the bitmap alive, so that its address identifies the entry.
+        Immutable<Glyph> glyph;
+        int32_t binID;
+        GlyphPosition position;
+        uint32_t references;
+    };
+
+    mutable std::mutex mutex;
+    mapbox::ShelfPack pack;
+    AlphaImage image;
+    // Usually one entry per glyph, but several when the glyph has bitmaps that differ.
+    std::map<FontStackHash, std::multimap<GlyphID, Entry>> entries;
+    // Padded rectangles of the glyphs added since the last upload.
+    std::vector<Rect<uint16_t>> dirtyRects;
+    std::atomic<bool> dirty{false};
+
+    // Render thread only.
+    optional<gfx::Texture> texture;
+};
+
+} // namespace mbgl
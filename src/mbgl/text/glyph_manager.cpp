@@ -1,6 +1,9 @@
+#include <mbgl/actor/scheduler.hpp>
 #include <mbgl/storage/file_source.hpp>
 #include <mbgl/storage/resource.hpp>
 #include <mbgl/storage/response.hpp>
+#include <mbgl/style/layer_impl.hpp>
+#include <mbgl/text/dynamic_glyph_atlas.hpp>
 #include <mbgl/text/glyph_manager.hpp>
 #include <mbgl/text/glyph_manager_observer.hpp>
 #include <mbgl/text/glyph_pbf.hpp>
@@ -8,13 +11,29 @@
 #include <mbgl/util/std.hpp>
 #include <mbgl/util/tiny_sdf.hpp>
 
+#include <unordered_set>
+#include <utility>
+
 namespace mbgl {
 
 static GlyphManagerObserver nullObserver;
 
+namespace {
+
+Glyph generateLocalSDF(LocalGlyphRasterizer& rasterizer, const FontStack& fontStack, GlyphID glyphID) {
+    Glyph local = rasterizer.rasterizeGlyph(fontStack, glyphID);
+    local.bitmap = util::transformRasterToSDF(local.bitmap, 8, .25);
+    return local;
+}
+
+} // namespace
+
 GlyphManager::GlyphManager(std::unique_ptr<LocalGlyphRasterizer> localGlyphRasterizer_)
     : observer(&nullObserver),
-      localGlyphRasterizer(std::move(localGlyphRasterizer_)) {
+      localGlyphRasterizer(std::move(localGlyphRasterizer_)),
+      glyphAtlas(DynamicGlyphAtlas::create()),
+      threadPool(Scheduler::GetBackground()),
+      rasterizerScheduler(Scheduler::GetSequenced()) {
 }
 
 GlyphManager::~GlyphManager() = default;
@@ -32,21 +51,37 @@ void GlyphManager::getGlyphs(GlyphRequestor& requestor, GlyphDependencies glyphD
 
         const GlyphIDs& glyphIDs = dependency.second;
         std::unordered_set<GlyphRange> ranges;
+        std::vector<GlyphID> localGlyphIDs;
         for (const auto& glyphID : glyphIDs) {
             if (localGlyphRasterizer->canRasterizeGlyph(fontStack, glyphID)) {
                 if (entry.glyphs.find(glyphID) == entry.glyphs.end()) {
-                    entry.glyphs.emplace(glyphID, makeMutable<Glyph>(generateLocalSDF(fontStack, glyphID)));
+                    auto it = entry.localRequests.find(glyphID);
+                    if (it == entry.localRequests.end()) {
+                        it = entry.localRequests.emplace(glyphID, Requestors()).first;
+                        localGlyphIDs.push_back(glyphID);
+                    }
+                    it->second[&requestor] = dependencies;
                 }
             } else {
                 ranges.insert(getGlyphRange(glyphID));
             }
         }
 
+        if (!localGlyphIDs.empty()) {
+            rasterizeLocalGlyphs(fontStack, std::move(localGlyphIDs));
+        }
+
         for (const auto& range : ranges) {
             auto it = entry.ranges.find(range);
-            if (it == entry.ranges.end() || !it->second.parsed) {
+            if (it != entry.ranges.end() && it->second.parsed) {
+                usage.splice(usage.end(), usage, it->second.used);
+            } else {
                 GlyphRequest& request = entry.ranges[range];
                 request.requestors[&requestor] = dependencies;
+                if (request.failed) {
+                    request.failed = false;
+                    request.req.reset();
+                }
                 requestRange(request, fontStack, range, fileSource);
             }
         }
@@ -59,10 +94,72 @@ void GlyphManager::getGlyphs(GlyphRequestor& requestor, GlyphDependencies glyphD
     }
 }
 
-Glyph GlyphManager::generateLocalSDF(const FontStack& fontStack, GlyphID glyphID) {
-    Glyph local = localGlyphRasterizer->rasterizeGlyph(fontStack, glyphID);
-    local.bitmap = util::transformRasterToSDF(local.bitmap, 8, .25);
-    return local;
+void GlyphManager::prefetch(const std::vector<Immutable<style::Layer::Impl>>& layers, FileSource& fileSource) {
+    if (glyphURL.empty()) {
+        return;
+    }
+
+    std::map<FontStack, std::set<GlyphRange>> ranges;
+    for (const auto& layer : layers) {
+        layer->populateGlyphRanges(ranges);
+    }
+
+    for (const auto& pair : ranges) {
+        const FontStack& fontStack = pair.first;
+        Entry& entry = entries[fontStack];
+        for (const auto& range : pair.second) {
+            if (entry.ranges.count(range)) {
+                continue;
+            }
+
+            bool local = true;
+            for (uint32_t glyphID = range.first; local && glyphID <= range.second; ++glyphID) {
+                local = localGlyphRasterizer->canRasterizeGlyph(fontStack, glyphID);
+            }
+            if (!local) {
+                requestRange(entry.ranges[range], fontStack, range, fileSource);
+            }
+        }
+    }
+}
+
+void GlyphManager::rasterizeLocalGlyphs(const FontStack& fontStack, std::vector<GlyphID> glyphIDs) {
+    auto rasterizeClosure = [rasterizer = localGlyphRasterizer, fontStack, glyphIDs = std::move(glyphIDs)]() {
+        std::vector<Immutable<Glyph>> glyphs;
+        glyphs.reserve(glyphIDs.size());
+        for (const GlyphID glyphID : glyphIDs) {
+            glyphs.push_back(makeMutable<Glyph>(generateLocalSDF(*rasterizer, fontStack, glyphID)));
+        }
+        return glyphs;
+    };
+
+    auto resultClosure = [this, weak = weakFactory.makeWeakPtr(), fontStack](std::vector<Immutable<Glyph>> glyphs) {
+        if (!weak) return; // This instance has been deleted.
+        onLocalGlyphsRasterized(fontStack, std::move(glyphs));
+    };
+
+    rasterizerScheduler->scheduleAndReplyValue(TaskTag::Glyph, rasterizeClosure, resultClosure);
+}
+
+void GlyphManager::onLocalGlyphsRasterized(const FontStack& fontStack, std::vector<Immutable<Glyph>> glyphs) {
+    auto entryIt = entries.find(fontStack);
+    if (entryIt == entries.end()) {
+        return; // Evicted in the meantime.
+    }
+    Entry& entry = entryIt->second;
+
+    Requestors requestors;
+    for (auto& glyph : glyphs) {
+        const GlyphID id = glyph->id;
+        entry.glyphs.emplace(id, std::move(glyph));
+        auto it = entry.localRequests.find(id);
+        if (it != entry.localRequests.end()) {
+            requestors.insert(it->second.begin(), it->second.end());
+            entry.localRequests.erase(it);
+        }
+    }
+
+    notifyCompleted(requestors);
 }
 
 void GlyphManager::requestRange(GlyphRequest& request, const FontStack& fontStack, const GlyphRange& range, FileSource& fileSource) {
@@ -77,6 +174,16 @@ void GlyphManager::requestRange(GlyphRequest& request, const FontStack& fontStac
 
 void GlyphManager::processResponse(const Response& res, const FontStack& fontStack, const GlyphRange& range) {
     if (res.error) {
+        auto entryIt = entries.find(fontStack);
+        if (entryIt != entries.end()) {
+            auto it = entryIt->second.ranges.find(range);
+            if (it != entryIt->second.ranges.end() && it->second.requestors.empty()) {
+                // Nothing waits for the range yet, as it was prefetched. The first requestor
+                // requests it again and gets the error then.
+                it->second.failed = true;
+                return;
+            }
+        }
         observer->onGlyphsError(fontStack, range, std::make_exception_ptr(std::runtime_error(res.error->message)));
         return;
     }
@@ -85,41 +192,86 @@ void GlyphManager::processResponse(const Response& res, const FontStack& fontSta
         return;
     }
 
-    Entry& entry = entries[fontStack];
-    GlyphRequest& request = entry.ranges[range];
+    if (res.noContent) {
+        onRangeParsed(fontStack, range, {});
+        return;
+    }
 
-    if (!res.noContent) {
-        std::vector<Glyph> glyphs;
+    struct ParseResult {
+        std::vector<Immutable<Glyph>> glyphs;
+        std::exception_ptr error;
+    };
 
+    // A range holds up to 256 SDF bitmaps, so decode it off the thread that owns the manager.
+    auto parseClosure = [data = res.data, range]() -> ParseResult {
         try {
-            glyphs = parseGlyphPBF(range, *res.data);
+            std::vector<Immutable<Glyph>> glyphs;
+            for (auto& glyph : parseGlyphPBF(range, *data)) {
+                glyphs.push_back(makeMutable<Glyph>(std::move(glyph)));
+            }
+            return {std::move(glyphs), nullptr};
         } catch (...) {
-            observer->onGlyphsError(fontStack, range, std::current_exception());
+            return {{}, std::current_exception()};
+        }
+    };
+
+    auto resultClosure = [this, weak = weakFactory.makeWeakPtr(), fontStack, range](ParseResult result) {
+        if (!weak) return; // This instance has been deleted.
+
+        if (result.error) {
+            observer->onGlyphsError(fontStack, range, result.error);
             return;
         }
+        onRangeParsed(fontStack, range, std::move(result.glyphs));
+    };
 
-        for (auto& glyph : glyphs) {
-            auto id = glyph.id;
-            if (!localGlyphRasterizer->canRasterizeGlyph(fontStack, id)) {
-                entry.glyphs.erase(id);
-                entry.glyphs.emplace(id, makeMutable<Glyph>(std::move(glyph)));
-            }
+    threadPool->scheduleAndReplyValue(TaskTag::Glyph, parseClosure, resultClosure);
+}
+
+void GlyphManager::onRangeParsed(const FontStack& fontStack,
+                                 const GlyphRange& range,
+                                 std::vector<Immutable<Glyph>> glyphs) {
+    auto entryIt = entries.find(fontStack);
+    if (entryIt == entries.end()) {
+        return; // Evicted in the meantime.
+    }
+    Entry& entry = entryIt->second;
+    GlyphRequest& request = entry.ranges[range];
+
+    std::size_t rangeSize = 0;
+    for (auto& glyph : glyphs) {
+        auto id = glyph->id;
+        if (!localGlyphRasterizer->canRasterizeGlyph(fontStack, id)) {
+            rangeSize += glyph->bitmap.bytes();
+            entry.glyphs.erase(id);
+            entry.glyphs.emplace(id, std::move(glyph));
         }
     }
 
+    // The file source may deliver the range again once it has been revalidated.
+    forgetRange(request);
     request.parsed = true;
+    request.size = rangeSize;
+    request.used = usage.emplace(usage.end(), fontStack, range);
+    size += rangeSize;
+
+    Requestors requestors;
+    std::swap(requestors, request.requestors);
+    notifyCompleted(requestors);
+
+    evictLeastRecentlyUsed();
 
-    for (auto& pair : request.requestors) {
+    observer->onGlyphsLoaded(fontStack, range);
+}
+
+void GlyphManager::notifyCompleted(const Requestors& requestors) {
+    for (auto& pair : requestors) {
         GlyphRequestor& requestor = *pair.first;
         const std::shared_ptr<GlyphDependencies>& dependencies = pair.second;
         if (dependencies.unique()) {
             notify(requestor, *dependencies);
         }
     }
-
-    request.requestors.clear();
-
-    observer->onGlyphsLoaded(fontStack, range);
 }
 
 void GlyphManager::setObserver(GlyphManagerObserver* observer_) {
@@ -154,13 +306,123 @@ void GlyphManager::removeRequestor(GlyphRequestor& requestor) {
         for (auto& range : entry.second.ranges) {
             range.second.requestors.erase(&requestor);
         }
+        for (auto& localRequest : entry.second.localRequests) {
+            localRequest.second.erase(&requestor);
+        }
     }
 }
 
 void GlyphManager::evict(const std::set<FontStack>& keep) {
     util::erase_if(entries, [&] (const auto& entry) {
-        return keep.count(entry.first) == 0;
+        if (keep.count(entry.first)) {
+            return false;
+        }
+        for (const auto& range : entry.second.ranges) {
+            forgetRange(range.second);
+        }
+        return true;
     });
 }
 
+void GlyphManager::setMaximumSize(std::size_t bytes) {
+    maximumSize = bytes;
+}
+
+void GlyphManager::forgetRange(const GlyphRequest& request) {
+    if (request.parsed) {
+        size -= request.size;
+        usage.erase(request.used);
+    }
+}
+
+GlyphDependencies GlyphManager::pendingGlyphs() const {
+    // Requestors get their glyphs once all of them loaded, so the glyphs of pending requestors stay,
+    // even where their ranges loaded already.
+    std::unordered_set<const GlyphDependencies*> pending;
+    for (const auto& pair : entries) {
+        for (const auto& range : pair.second.ranges) {
+            for (const auto& requestor : range.second.requestors) {
+                pending.insert(requestor.second.get());
+            }
+        }
+        for (const auto& localRequest : pair.second.localRequests) {
+            for (const auto& requestor : localRequest.second) {
+                pending.insert(requestor.second.get());
+            }
+        }
+    }
+    GlyphDependencies keep;
+    for (const GlyphDependencies* dependencies : pending) {
+        for (const auto& dependency : *dependencies) {
+            keep[dependency.first].insert(dependency.second.begin(), dependency.second.end());
+        }
+    }
+    return keep;
+}
+
+void GlyphManager::evictLeastRecentlyUsed() {
+    if (size <= maximumSize) {
+        return;
+    }
+
+    GlyphDependencies keep = pendingGlyphs();
+    // The most recently used range is the one that just loaded, which stays.
+    for (auto it = usage.begin(); size > maximumSize && it != std::prev(usage.end());) {
+        const FontStack& fontStack = it->first;
+        const GlyphRange& range = it->second;
+        const GlyphIDs& kept = keep[fontStack];
+        const auto keptGlyph = kept.lower_bound(range.first);
+        if (keptGlyph != kept.end() && *keptGlyph <= range.second) {
+            ++it;
+            continue;
+        }
+
+        Entry& entry = entries.at(fontStack);
+        entry.glyphs.erase(entry.glyphs.lower_bound(range.first), entry.glyphs.upper_bound(range.second));
+        auto rangeIt = entry.ranges.find(range);
+        size -= rangeIt->second.size;
+        entry.ranges.erase(rangeIt);
+        it = usage.erase(it);
+    }
+}
+
+void GlyphManager::evictLoadedGlyphs() {
+    GlyphDependencies keep = pendingGlyphs();
+
+    for (auto& pair : entries) {
+        const FontStack& fontStack = pair.first;
+        Entry& entry = pair.second;
+        const GlyphIDs& kept = keep[fontStack];
+        util::erase_if(entry.ranges, [&](const auto& range) {
+            const GlyphID first = range.first.first;
+            const GlyphID last = range.first.second;
+            const auto keptGlyph = kept.lower_bound(first);
+            if (!range.second.parsed || (keptGlyph != kept.end() && *keptGlyph <= last)) {
+                return false;
+            }
+            entry.glyphs.erase(entry.glyphs.lower_bound(first), entry.glyphs.upper_bound(last));
+            forgetRange(range.second);
+            return true;
+        });
+        util::erase_if(entry.glyphs, [&](const auto& glyph) {
+            return kept.count(glyph.first) == 0 && localGlyphRasterizer->canRasterizeGlyph(fontStack, glyph.first);
+        });
+    }
+    util::erase_if(entries, [](const auto& entry) {
+        return entry.second.ranges.empty() && entry.second.glyphs.empty() && entry.second.localRequests.empty();
+    });
+}
+
+std::size_t GlyphManager::getPendingRangeCount() const {
+    std::size_t count = 0;
+    for (const auto& pair : entries) {
+        for (const auto& range : pair.second.ranges) {
+            count += !range.second.parsed && !range.second.failed && range.second.req;
+        }
+        // Local glyphs are rasterized in batches per font stack.
+        count += pair.second.localRequests.empty() ? 0 : 1;
+    }
+    return count;
+}
+
 } // namespace mbgl
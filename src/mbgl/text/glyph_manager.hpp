@@ -7,14 +7,21 @@
 #include <mbgl/util/font_stack.hpp>
 #include <mbgl/util/immutable.hpp>
 
+#include <mapbox/std/weak.hpp>
+
+#include <list>
+#include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace mbgl {
 
 class FileSource;
 class AsyncRequest;
+class DynamicGlyphAtlas;
 class Response;
+class Scheduler;
 
 class GlyphRequestor {
 public:
@@ -35,10 +42,15 @@ public:
     // their `GlyphDependencies`. If all glyphs are already locally available, GlyphManager
     // will provide them to the requestor immediately. Otherwise, it makes a request on the
     // FileSource is made for each range needed, and notifies the observer when all are
-    // complete.
+    // complete. Glyph PBFs are decoded and local glyphs are rasterized on background
+    // threads, so the requestor is notified asynchronously in that case.
     void getGlyphs(GlyphRequestor&, GlyphDependencies, FileSource&);
     void removeRequestor(GlyphRequestor&);
 
+    // Requests the glyph ranges that the layers are likely to need ahead of their tiles, so that
+    // the ranges load while the tiles do. See style::Layer::Impl::populateGlyphRanges().
+    void prefetch(const std::vector<Immutable<style::Layer::Impl>>&, FileSource&);
+
     void setURL(const std::string& url) {
         glyphURL = url;
     }
@@ -47,31 +59,75 @@ public:
 
     // Remove glyphs for all but the supplied font stacks.
     void evict(const std::set<FontStack>&);
+    // Removes the glyphs of the ranges that finished loading and the locally rasterized glyphs.
+    // Glyphs that requestors still wait for are kept. The others are loaded again when needed.
+    void evictLoadedGlyphs();
+
+    // The glyph ranges that are being requested or rasterized locally.
+    std::size_t getPendingRangeCount() const;
+
+    // The bytes of glyph bitmaps that the loaded ranges may take. Past it, the least recently
+    // used ranges are evicted, except those that requestors still wait for. They are loaded
+    // again when needed.
+    void setMaximumSize(std::size_t bytes);
+    std::size_t getSize() const { return size; }
+
+    // The atlas that the tiles of this renderer share their glyphs in.
+    const std::shared_ptr<DynamicGlyphAtlas>& getGlyphAtlas() const { return glyphAtlas; }
 
 private:
-    Glyph generateLocalSDF(const FontStack& fontStack, GlyphID glyphID);
     std::string glyphURL;
 
+    using Requestors = std::unordered_map<GlyphRequestor*, std::shared_ptr<GlyphDependencies>>;
+
+    using RangeKey = std::pair<FontStack, GlyphRange>;
+
     struct GlyphRequest {
         bool parsed = false;
+        // Whether the range failed to load before anything requested its glyphs.
+        bool failed = false;
         std::unique_ptr<AsyncRequest> req;
-        std::unordered_map<GlyphRequestor*, std::shared_ptr<GlyphDependencies>> requestors;
+        Requestors requestors;
+        // The bytes of the bitmaps of the glyphs of the range, once parsed.
+        std::size_t size = 0;
+        // The position of the range in `usage`, once parsed.
+        std::list<RangeKey>::iterator used;
     };
 
     struct Entry {
         std::map<GlyphRange, GlyphRequest> ranges;
         std::map<GlyphID, Immutable<Glyph>> glyphs;
+        // Requestors of the glyphs that are being rasterized locally.
+        std::map<GlyphID, Requestors> localRequests;
     };
 
     std::unordered_map<FontStack, Entry, FontStackHasher> entries;
+    // The parsed ranges, least recently used first.
+    std::list<RangeKey> usage;
+    std::size_t size = 0;
+    // About fifty ranges of Latin glyphs, or twenty of ideographs.
+    std::size_t maximumSize = 8 * 1024 * 1024;
 
     void requestRange(GlyphRequest&, const FontStack&, const GlyphRange&, FileSource& fileSource);
     void processResponse(const Response&, const FontStack&, const GlyphRange&);
+    void onRangeParsed(const FontStack&, const GlyphRange&, std::vector<Immutable<Glyph>>);
+    void rasterizeLocalGlyphs(const FontStack&, std::vector<GlyphID>);
+    void onLocalGlyphsRasterized(const FontStack&, std::vector<Immutable<Glyph>>);
+    void notifyCompleted(const Requestors&);
     void notify(GlyphRequestor&, const GlyphDependencies&);
+    GlyphDependencies pendingGlyphs() const;
+    void evictLeastRecentlyUsed();
+    void forgetRange(const GlyphRequest&);
     
     GlyphManagerObserver* observer = nullptr;
     
-    std::unique_ptr<LocalGlyphRasterizer> localGlyphRasterizer;
+    // Shared with the rasterization tasks, which may outlive the manager.
+    std::shared_ptr<LocalGlyphRasterizer> localGlyphRasterizer;
+    std::shared_ptr<DynamicGlyphAtlas> glyphAtlas;
+    std::shared_ptr<Scheduler> threadPool;
+    // Rasterizers aren't thread-safe, so local glyphs are generated on a single thread.
+    std::shared_ptr<Scheduler> rasterizerScheduler;
+    mapbox::base::WeakPtrFactory<GlyphManager> weakFactory{this};
 };
 
 } // namespace mbgl
@@ -8,6 +8,12 @@
 #include <mbgl/text/placement.hpp>
 #include <mbgl/tile/geometry_tile.hpp>
 #include <mbgl/util/math.hpp>
+#include <mbgl/util/parallel_for.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <unordered_set>
 #include <utility>
 
 namespace mbgl {
@@ -70,6 +76,7 @@ class PlacementContext {
 public:
     PlacementContext(const SymbolBucket& bucket_,
                      const RenderTile& renderTile_,
+                     const mat4& posMatrix_,
                      const TransformState& state_,
                      float placementZoom,
                      CollisionGroups::CollisionGroup collisionGroup_,
@@ -77,6 +84,7 @@ public:
         : bucket(bucket_),
           renderTile(renderTile_),
           state(state_),
+          posMatrix(posMatrix_),
           pixelsToTileUnits(renderTile_.id.pixelsToTileUnits(1, placementZoom)),
           scale(std::pow(2, placementZoom - getOverscaledID().overscaledZ)),
           pixelRatio(util::tileSize * getOverscaledID().overscaleFactor() / util::EXTENT),
@@ -97,6 +105,8 @@ public:
         return getLayout().get<style::TextVariableAnchor>();
     }
 
+    // The tile matrix for the camera of the placement.
+    mat4 posMatrix;
     float pixelsToTileUnits;
     float scale;
     float pixelRatio;
@@ -108,12 +118,11 @@ public:
     SymbolPlacementType placementType = getLayout().get<SymbolPlacement>();
 
     mat4 textLabelPlaneMatrix =
-        getLabelPlaneMatrix(renderTile.get().matrix, pitchTextWithMap, rotateTextWithMap, state, pixelsToTileUnits);
+        getLabelPlaneMatrix(posMatrix, pitchTextWithMap, rotateTextWithMap, state, pixelsToTileUnits);
     mat4 iconLabelPlaneMatrix =
         (rotateTextWithMap == rotateIconWithMap && pitchTextWithMap == pitchIconWithMap)
             ? textLabelPlaneMatrix
-            : getLabelPlaneMatrix(
-                  renderTile.get().matrix, pitchIconWithMap, rotateIconWithMap, state, pixelsToTileUnits);
+            : getLabelPlaneMatrix(posMatrix, pitchIconWithMap, rotateIconWithMap, state, pixelsToTileUnits);
 
     CollisionGroups::CollisionGroup collisionGroup;
     ZoomEvaluatedSize partiallyEvaluatedTextSize;
@@ -152,9 +161,35 @@ PlacementController::PlacementController() : placement(makeMutable<Placement>())
 
 void PlacementController::setPlacement(Immutable<Placement> placement_) {
     placement = std::move(placement_);
+    pendingPlacement = nullopt;
     stale = false;
 }
 
+void PlacementController::setPendingPlacement(Mutable<Placement> placement_, const RenderLayerReferences& layers) {
+    pendingPlacement = std::move(placement_);
+    pendingLayerIDs.clear();
+    for (const RenderLayer& layer : layers) {
+        pendingLayerIDs.push_back(layer.getID());
+    }
+}
+
+bool PlacementController::hasPendingPlacement(const RenderLayerReferences& layers) const {
+    return pendingPlacement && layers.size() == pendingLayerIDs.size() &&
+           std::equal(layers.begin(),
+                      layers.end(),
+                      pendingLayerIDs.begin(),
+                      [](const RenderLayer& layer, const std::string& layerID) { return layer.getID() == layerID; });
+}
+
+bool PlacementController::continuePlacement(const RenderLayerReferences& layers, TimePoint now, Duration budget) {
+    assert(hasPendingPlacement(layers));
+    if (!(*pendingPlacement)->continuePlacement(layers, now, budget)) {
+        return false;
+    }
+    setPlacement(std::move(*pendingPlacement));
+    return true;
+}
+
 bool PlacementController::placementIsRecent(TimePoint now, const float zoom, optional<Duration> periodOverride) const {
     if (!placement->transitionsEnabled()) return false;
 
@@ -193,18 +228,233 @@ Placement::Placement() : collisionIndex({}, MapMode::Static), collisionGroups(tr
 Placement::~Placement() = default;
 
 void Placement::placeLayers(const RenderLayerReferences& layers) {
-    for (auto it = layers.crbegin(); it != layers.crend(); ++it) {
-        std::set<uint32_t> seenCrossTileIDs;
-        placeLayer(*it, seenCrossTileIDs);
+    startPlacement(layers);
+    if (carryOverShift || !placeLayersConcurrently(layers)) {
+        for (auto it = layers.crbegin(); it != layers.crend(); ++it) {
+            std::set<uint32_t> seenCrossTileIDs;
+            placeLayer(*it, seenCrossTileIDs);
+        }
     }
     commit();
 }
 
+bool Placement::continuePlacement(const RenderLayerReferences& layers, TimePoint now, Duration budget) {
+    const TimePoint deadline = Clock::now() + budget;
+    if (!placementStarted) {
+        startPlacement(layers);
+        placementStarted = true;
+    }
+
+    bool placedBucket = false;
+    for (; placedLayerCount < layers.size(); ++placedLayerCount) {
+        const RenderLayer& layer = layers[layers.size() - 1u - placedLayerCount];
+        const LayerPlacementData& placementData = layer.getPlacementData();
+        beginLayerStatistics(layer);
+        // The tiles may have changed since the previous frame, in which case some of the symbols
+        // are skipped or placed a second time. The latter are dropped as seen cross tile IDs.
+        auto it = placementData.begin();
+        std::advance(it, static_cast<std::ptrdiff_t>(std::min(placedBucketCount, placementData.size())));
+        for (; it != placementData.end(); ++it, ++placedBucketCount) {
+            // At least one bucket is placed per frame, so that placement always finishes.
+            const TimePoint start = Clock::now();
+            if (placedBucket && start >= deadline) {
+                return false;
+            }
+            it->bucket.get().place(*this, *it, layerSeenCrossTileIDs);
+            layerStatistics().time += Clock::now() - start;
+            placedBucket = true;
+        }
+        placedBucketCount = 0u;
+        layerSeenCrossTileIDs.clear();
+    }
+
+    commitTime = now;
+    commit();
+    return true;
+}
+
+void Placement::startPlacement(const RenderLayerReferences& layers) {
+    carryOverShift = getCarryOverShift();
+    if (carryOverShift) {
+        // Start out with the collision boxes of the buckets that were placed before and are still
+        // around, so that the symbols of new buckets are placed around them.
+        const Placement& prev = *getPrevPlacement();
+        std::unordered_set<uint32_t> carriedBuckets;
+        for (const RenderLayer& layer : layers) {
+            for (const BucketPlacementData& data : layer.getPlacementData()) {
+                if (canCarryOver(data)) {
+                    carriedBuckets.insert(static_cast<const SymbolBucket&>(data.bucket.get()).bucketInstanceId);
+                }
+            }
+        }
+        collisionGroups = prev.collisionGroups;
+        collisionIndex.insertFeatures(prev.collisionIndex, carriedBuckets, *carryOverShift);
+        carryOverDistance = prev.carryOverDistance + std::hypot(carryOverShift->x, carryOverShift->y);
+    }
+}
+
+// Results of the previous placement are carried over for the buckets it already placed when the
+// camera was panned by a few pixels, without zooming, rotating or pitching. The collision boxes
+// of these symbols are then simply shifted on screen. Labels that move in from outside the
+// viewport have already been placed against the boxes in its padding, which is why the camera
+// may only move by a part of the padding before the next full placement. An unchanged camera
+// always gets a full placement, so that the labels settle once a gesture ends.
+optional<Point<float>> Placement::getCarryOverShift() const {
+    const Placement* prev = getPrevPlacement();
+    if (!updateParameters || !prev || !prev->updateParameters || showCollisionBoxes) {
+        return nullopt;
+    }
+
+    const TransformState& state = updateParameters->transformState;
+    const TransformState& prevState = prev->updateParameters->transformState;
+    if (updateParameters->crossSourceCollisions != prev->updateParameters->crossSourceCollisions ||
+        state.getSize() != prevState.getSize() || state.getZoom() != prevState.getZoom() ||
+        state.getBearing() != prevState.getBearing() || state.getPitch() != 0.0 || prevState.getPitch() != 0.0) {
+        return nullopt;
+    }
+
+    const LatLng center = prevState.getLatLng();
+    const ScreenCoordinate before = prevState.latLngToScreenCoordinate(center);
+    const ScreenCoordinate after = state.latLngToScreenCoordinate(center);
+    const Point<float> shift(static_cast<float>(after.x - before.x), static_cast<float>(after.y - before.y));
+    const float distance = std::hypot(shift.x, shift.y);
+    if (distance == 0.0f || prev->carryOverDistance + distance > collisionIndex.getViewportPadding() / 2) {
+        return nullopt;
+    }
+    return shift;
+}
+
+// Placements continued in a later frame have to keep using the camera they started with, instead
+// of the tile matrices of the current frame.
+mat4 Placement::getPosMatrix(const RenderTile& tile) const {
+    mat4 matrix;
+    collisionIndex.getTransformState().matrixFor(matrix, tile.id);
+    matrix::multiply(matrix, collisionIndex.getTransformState().getProjectionMatrix(), matrix);
+    return matrix;
+}
+
+bool Placement::canCarryOver(const BucketPlacementData& data) const {
+    if (!carryOverShift || data.tile.get().holdForFade()) {
+        return false;
+    }
+    const auto& bucket = static_cast<const SymbolBucket&>(data.bucket.get());
+    return getPrevPlacement()->placedBuckets.count(bucket.bucketInstanceId) != 0u;
+}
+
+// Takes the previous result for a symbol of a carried over bucket. Returns false if the symbol has
+// to be placed regularly, e.g. because it has no previous result.
+bool Placement::carryOverSymbol(const SymbolInstance& symbolInstance, std::set<uint32_t>& seenCrossTileIDs) {
+    const uint32_t crossTileID = symbolInstance.crossTileID;
+    if (crossTileID == SymbolInstance::invalidCrossTileID() || seenCrossTileIDs.count(crossTileID) != 0u) {
+        return false;
+    }
+
+    const Placement& prev = *getPrevPlacement();
+    auto prevJointPlacement = prev.placements.find(crossTileID);
+    if (prevJointPlacement == prev.placements.end()) {
+        return false;
+    }
+    placements.emplace(crossTileID, prevJointPlacement->second);
+
+    auto prevOffset = prev.variableOffsets.find(crossTileID);
+    if (prevOffset != prev.variableOffsets.end()) {
+        variableOffsets.emplace(crossTileID, prevOffset->second);
+    }
+    auto prevOrientation = prev.placedOrientations.find(crossTileID);
+    if (prevOrientation != prev.placedOrientations.end()) {
+        placedOrientations.emplace(crossTileID, prevOrientation->second);
+    }
+
+    seenCrossTileIDs.insert(crossTileID);
+    return true;
+}
+
+// Without cross-source collisions, symbols only collide with symbols of the same source, so
+// the sources are independent of each other. Each of them is placed into its own Placement,
+// concurrently, and the results are merged in the order of the sources' first layers, which
+// gives the same placements as placing all the layers one after the other.
+bool Placement::placeLayersConcurrently(const RenderLayerReferences& layers) {
+    if (!concurrent || !updateParameters || updateParameters->crossSourceCollisions) {
+        return false;
+    }
+
+    std::vector<std::pair<std::string, std::vector<std::reference_wrapper<const RenderLayer>>>> sources;
+    for (auto it = layers.crbegin(); it != layers.crend(); ++it) {
+        const RenderLayer& layer = *it;
+        const std::string& sourceID = layer.baseImpl->source;
+        auto source = std::find_if(
+            sources.begin(), sources.end(), [&](const auto& entry) { return entry.first == sourceID; });
+        if (source == sources.end()) {
+            sources.emplace_back(sourceID, std::vector<std::reference_wrapper<const RenderLayer>>{});
+            source = std::prev(sources.end());
+        }
+        source->second.emplace_back(layer);
+    }
+    if (sources.size() < 2u) {
+        return false;
+    }
+
+    // Assign the collision groups up front, so that the merged collision index holds the same
+    // group IDs as the one of a sequential placement.
+    for (const auto& source : sources) {
+        collisionGroups.get(source.first);
+    }
+
+    std::vector<std::unique_ptr<Placement>> sourcePlacements;
+    for (const auto& source : sources) {
+        sourcePlacements.push_back(std::make_unique<Placement>(updateParameters, prevPlacement));
+        sourcePlacements.back()->collisionGroups = collisionGroups;
+    }
+    util::parallelFor(sources.size(), TaskTag::Placement, TaskPriority::Default, [&](std::size_t index) {
+        for (const RenderLayer& layer : sources[index].second) {
+            std::set<uint32_t> seenCrossTileIDs;
+            sourcePlacements[index]->placeLayer(layer, seenCrossTileIDs);
+        }
+    });
+
+    // Symbol placements are keyed by cross tile IDs, which are unique across sources.
+    for (auto& sourcePlacement : sourcePlacements) {
+        placements.insert(sourcePlacement->placements.begin(), sourcePlacement->placements.end());
+        variableOffsets.insert(sourcePlacement->variableOffsets.begin(), sourcePlacement->variableOffsets.end());
+        placedOrientations.insert(sourcePlacement->placedOrientations.begin(),
+                                  sourcePlacement->placedOrientations.end());
+        retainedQueryData.insert(sourcePlacement->retainedQueryData.begin(),
+                                 sourcePlacement->retainedQueryData.end());
+        placedBuckets.insert(sourcePlacement->placedBuckets.begin(), sourcePlacement->placedBuckets.end());
+        collisionCircles.insert(sourcePlacement->collisionCircles.begin(), sourcePlacement->collisionCircles.end());
+        collisionIndex.insertFeatures(sourcePlacement->collisionIndex);
+        statistics.layers.insert(statistics.layers.end(),
+                                 sourcePlacement->statistics.layers.begin(),
+                                 sourcePlacement->statistics.layers.end());
+    }
+    return true;
+}
+
 void Placement::placeLayer(const RenderLayer& layer, std::set<uint32_t>& seenCrossTileIDs) {
+    beginLayerStatistics(layer);
+    const TimePoint start = Clock::now();
     for (const BucketPlacementData& data : layer.getPlacementData()) {
         Bucket& bucket = data.bucket;
         bucket.place(*this, data, seenCrossTileIDs);
     }
+    layerStatistics().time += Clock::now() - start;
+}
+
+void Placement::beginLayerStatistics(const RenderLayer& layer) {
+    const std::string& id = layer.baseImpl->id;
+    auto it = std::find_if(
+        statistics.layers.begin(), statistics.layers.end(), [&](const auto& entry) { return entry.id == id; });
+    if (it == statistics.layers.end()) {
+        statistics.layers.emplace_back();
+        statistics.layers.back().id = id;
+        it = std::prev(statistics.layers.end());
+    }
+    statisticsLayer = static_cast<std::size_t>(std::distance(statistics.layers.begin(), it));
+}
+
+PlacementStatistics::Layer& Placement::layerStatistics() {
+    assert(statisticsLayer);
+    return statistics.layers[*statisticsLayer];
 }
 
 namespace {
@@ -232,14 +482,24 @@ void Placement::placeSymbolBucket(const BucketPlacementData& params, std::set<ui
     assert(updateParameters);
     const auto& symbolBucket = static_cast<const SymbolBucket&>(params.bucket.get());
     const RenderTile& renderTile = params.tile;
+    const mat4 posMatrix = getPosMatrix(renderTile);
     PlacementContext ctx{symbolBucket,
                          params.tile,
+                         posMatrix,
                          collisionIndex.getTransformState(),
                          placementZoom,
                          collisionGroups.get(params.sourceId),
-                         getAvoidEdges(symbolBucket, renderTile.matrix)};
+                         getAvoidEdges(symbolBucket, posMatrix)};
+    const bool carryOver = canCarryOver(params);
     for (const SymbolInstance& symbol : getSortedSymbols(params, ctx.pixelRatio)) {
-        placeSymbol(symbol, ctx, seenCrossTileIDs);
+        if (carryOver && carryOverSymbol(symbol, seenCrossTileIDs)) {
+            ++layerStatistics().carriedOver;
+        } else {
+            placeSymbol(symbol, ctx, seenCrossTileIDs);
+        }
+    }
+    if (!renderTile.holdForFade()) {
+        placedBuckets.insert(symbolBucket.bucketInstanceId);
     }
 
     // As long as this placement lives, we have to hold onto this bucket's
@@ -263,8 +523,12 @@ void Placement::placeSymbol(const SymbolInstance& symbolInstance,
         placements.emplace(symbolInstance.crossTileID, JointPlacement(false, false, false));
         return;
     }
+    PlacementStatistics::Layer& stats = layerStatistics();
+    const CollisionIndex::Statistics collisionStatsBefore = collisionIndex.getStatistics();
+    ++stats.symbols;
+
     const SymbolBucket& bucket = ctx.getBucket();
-    const mat4& posMatrix = ctx.getRenderTile().matrix;
+    const mat4& posMatrix = ctx.posMatrix;
     const auto& collisionGroup = ctx.collisionGroup;
     auto variableTextAnchors = ctx.getVariableTextAnchors();
     textBoxes.clear();
@@ -386,6 +650,11 @@ void Placement::placeSymbol(const SymbolInstance& symbolInstance,
                 const float height = textBox.y2 - textBox.y1;
                 const float textBoxScale = symbolInstance.textBoxScale;
                 std::pair<bool, bool> placedFeature = {false, false};
+                // Variable anchors only shift boxes of point features, whose anchors are projected once
+                // for all the attempts.
+                assert(!textCollisionFeature.alongLine && !iconCollisionFeature.alongLine);
+                const auto projectedTextAnchor = collisionIndex.projectAndGetPerspectiveRatio(posMatrix, textBox.anchor);
+                optional<CollisionIndex::ProjectedAnchor> projectedIconAnchor;
                 const size_t anchorsSize = variableTextAnchors.size();
                 const size_t placementAttempts = ctx.textAllowOverlap ? anchorsSize * 2 : anchorsSize;
                 for (size_t i = 0u; i < placementAttempts; ++i) {
@@ -405,37 +674,29 @@ void Placement::placeSymbol(const SymbolInstance& symbolInstance,
                         continue;
                     }
 
-                    placedFeature = collisionIndex.placeFeature(textCollisionFeature,
-                                                                shift,
-                                                                posMatrix,
-                                                                mat4(),
-                                                                ctx.pixelRatio,
-                                                                placedSymbol,
-                                                                ctx.scale,
-                                                                fontSize,
-                                                                allowOverlap,
-                                                                ctx.pitchTextWithMap,
-                                                                showCollisionBoxes,
-                                                                ctx.avoidEdges,
-                                                                collisionGroup.second,
-                                                                textBoxes);
-
-                    if (doVariableIconPlacement) {
-                        auto placedIconFeature =
-                            collisionIndex.placeFeature(iconCollisionFeature,
-                                                        shift,
-                                                        posMatrix,
-                                                        ctx.iconLabelPlaneMatrix,
-                                                        ctx.pixelRatio,
-                                                        placedSymbol,
-                                                        ctx.scale,
-                                                        fontSize,
-                                                        ctx.iconAllowOverlap,
-                                                        ctx.pitchTextWithMap, // TODO: shall it be pitchIconWithMap?
-                                                        showCollisionBoxes,
-                                                        ctx.avoidEdges,
-                                                        collisionGroup.second,
-                                                        iconBoxes);
+                    placedFeature = collisionIndex.placeBox(textBox,
+                                                            projectedTextAnchor,
+                                                            shift,
+                                                            ctx.pixelRatio,
+                                                            allowOverlap,
+                                                            ctx.avoidEdges,
+                                                            collisionGroup.second,
+                                                            textBoxes);
+
+                    // The icon only matters at the anchors where the text fits.
+                    if (doVariableIconPlacement && placedFeature.first) {
+                        const CollisionBox& iconBox = iconCollisionFeature.boxes.front();
+                        if (!projectedIconAnchor) {
+                            projectedIconAnchor = collisionIndex.projectAndGetPerspectiveRatio(posMatrix, iconBox.anchor);
+                        }
+                        auto placedIconFeature = collisionIndex.placeBox(iconBox,
+                                                                         *projectedIconAnchor,
+                                                                         shift,
+                                                                         ctx.pixelRatio,
+                                                                         ctx.iconAllowOverlap,
+                                                                         ctx.avoidEdges,
+                                                                         collisionGroup.second,
+                                                                         iconBoxes);
                         iconBoxes.clear();
                         if (!placedIconFeature.first) continue;
                     }
@@ -595,6 +856,16 @@ void Placement::placeSymbol(const SymbolInstance& symbolInstance,
         collisionCircles[&symbolInstance.textCollisionFeature] = textBoxes;
     }
 
+    const CollisionIndex::Statistics& collisionStats = collisionIndex.getStatistics();
+    stats.gridCells += collisionStats.gridCells - collisionStatsBefore.gridCells;
+    if (placeText || placeIcon) {
+        ++stats.placed;
+    } else if (collisionStats.collisions != collisionStatsBefore.collisions) {
+        ++stats.collisions;
+    } else if (collisionStats.offscreen != collisionStatsBefore.offscreen) {
+        ++stats.offscreen;
+    }
+
     assert(symbolInstance.crossTileID != 0);
 
     if (placements.find(symbolInstance.crossTileID) != placements.end()) {
@@ -707,13 +978,48 @@ void Placement::commit() {
     fadeStartTime = placementChanged ? commitTime : getPrevPlacement()->fadeStartTime;
 }
 
-void Placement::updateLayerBuckets(const RenderLayer& layer, const TransformState& state, bool updateOpacities) const {
-    std::set<uint32_t> seenCrossTileIDs;
-    for (const auto& item : layer.getPlacementData()) {
-        if (!item.sortKeyRange || item.sortKeyRange->isFirstRange()) {
-            item.bucket.get().updateVertices(*this, updateOpacities, state, item.tile, seenCrossTileIDs);
+namespace {
+
+// Fewer symbols following the camera than this are updated on the render thread only.
+constexpr std::size_t minParallelDynamicSymbols = 2048;
+
+} // namespace
+
+void Placement::updateLayerBuckets(const RenderLayerReferences& layers,
+                                   const TransformState& state,
+                                   bool updateOpacities) const {
+    // Symbol layers with the same layout share their buckets, which are only updated once.
+    std::vector<std::pair<std::reference_wrapper<Bucket>, std::reference_wrapper<const RenderTile>>> buckets;
+    std::unordered_set<const Bucket*> seenBuckets;
+    std::size_t dynamicSymbolCount = 0u;
+    for (auto it = layers.rbegin(); it != layers.rend(); ++it) {
+        std::set<uint32_t> seenCrossTileIDs;
+        for (const auto& item : it->get().getPlacementData()) {
+            if (item.sortKeyRange && !item.sortKeyRange->isFirstRange()) continue;
+            if (updateOpacities) {
+                item.bucket.get().updateOpacities(*this, state, seenCrossTileIDs);
+            }
+            const std::size_t symbolCount = item.bucket.get().getDynamicSymbolCount();
+            if (symbolCount > 0u && seenBuckets.insert(&item.bucket.get()).second) {
+                buckets.emplace_back(item.bucket, item.tile);
+                dynamicSymbolCount += symbolCount;
+            }
+        }
+    }
+
+    // Reprojecting line labels of a pitched map is the bulk of the work. Each bucket only writes
+    // its own vertices and reads the placement, so they are independent of each other. Unless there
+    // are enough symbols to outweigh handing them to other threads, they are updated on this thread.
+    const auto update = [&](std::size_t index) {
+        buckets[index].first.get().updateDynamicVertices(*this, state, buckets[index].second);
+    };
+    if (dynamicSymbolCount < minParallelDynamicSymbols) {
+        for (std::size_t i = 0u; i < buckets.size(); ++i) {
+            update(i);
         }
+        return;
     }
+    util::parallelFor(buckets.size(), TaskTag::Placement, TaskPriority::Default, update);
 }
 
 namespace {
@@ -725,6 +1031,42 @@ Point<float> calculateVariableRenderShift(style::SymbolAnchorType anchor, float
     return { (shiftX / textBoxScale + variablOffset[0]) * renderTextSize,
              (shiftY / textBoxScale + variablOffset[1]) * renderTextSize };
 }
+
+// Changed opacity vertices closer than this are uploaded together, as a single upload is cheaper
+// than several small ones.
+constexpr std::size_t opacityUploadGap = 256;
+
+// Gives the next `count` opacity vertices of the buffer, which belong to one symbol instance, the
+// opacity of that symbol. Only the vertices whose opacity changed are marked for upload. The
+// vertices are visited in the order of the symbol instances, like the layout added them.
+void updateOpacityVertices(SymbolBucket::Buffer& buffer,
+                           std::size_t& offset,
+                           std::size_t count,
+                           std::size_t symbolIndex,
+                           const gfx::Vertex<SymbolOpacityAttributes>& vertex) {
+    const std::size_t start = offset;
+    const std::size_t end = offset + count;
+    offset = end;
+
+    auto& vertices = buffer.opacityVertices;
+    assert(end <= vertices.elements());
+    bool changed = false;
+    for (std::size_t i = start; i < end && i < vertices.elements(); ++i) {
+        auto& current = vertices.at(i);
+        if (current.a1 != vertex.a1) {
+            current = vertex;
+            changed = true;
+        }
+    }
+    if (!changed) return;
+
+    auto& ranges = buffer.opacityDirtyRanges;
+    if (!ranges.empty() && ranges.back().start <= start && start <= ranges.back().end + opacityUploadGap) {
+        ranges.back().end = std::max(ranges.back().end, end);
+    } else {
+        ranges.push_back({symbolIndex, start, end});
+    }
+}
 } // namespace
 
 bool Placement::updateBucketDynamicVertices(SymbolBucket& bucket, const TransformState& state, const RenderTile& tile) const {
@@ -888,13 +1230,22 @@ bool Placement::updateBucketDynamicVertices(SymbolBucket& bucket, const Transfor
 void Placement::updateBucketOpacities(SymbolBucket& bucket,
                                       const TransformState& state,
                                       std::set<uint32_t>& seenCrossTileIDs) const {
-    if (bucket.hasTextData()) bucket.text.opacityVertices.clear();
-    if (bucket.hasIconData()) bucket.icon.opacityVertices.clear();
-    if (bucket.hasSdfIconData()) bucket.sdfIcon.opacityVertices.clear();
-    if (bucket.hasIconCollisionBoxData()) bucket.iconCollisionBox->dynamicVertices.clear();
-    if (bucket.hasIconCollisionCircleData()) bucket.iconCollisionCircle->dynamicVertices.clear();
-    if (bucket.hasTextCollisionBoxData()) bucket.textCollisionBox->dynamicVertices.clear();
-    if (bucket.hasTextCollisionCircleData()) bucket.textCollisionCircle->dynamicVertices.clear();
+    // The opacity vertices are updated in place, so that uploads only cover the symbols whose
+    // opacity changed.
+    std::size_t textOpacityOffset = 0;
+    std::size_t iconOpacityOffset = 0;
+    std::size_t sdfIconOpacityOffset = 0;
+    // The collision debug buffers only exist in buckets laid out with the collision debug option.
+    const bool hasIconCollisionBoxData = bucket.hasIconCollisionBoxData();
+    const bool hasIconCollisionCircleData = bucket.hasIconCollisionCircleData();
+    const bool hasTextCollisionBoxData = bucket.hasTextCollisionBoxData();
+    const bool hasTextCollisionCircleData = bucket.hasTextCollisionCircleData();
+    const bool hasCollisionDebugData =
+        hasIconCollisionBoxData || hasIconCollisionCircleData || hasTextCollisionBoxData || hasTextCollisionCircleData;
+    if (hasIconCollisionBoxData) bucket.iconCollisionBox->dynamicVertices.clear();
+    if (hasIconCollisionCircleData) bucket.iconCollisionCircle->dynamicVertices.clear();
+    if (hasTextCollisionBoxData) bucket.textCollisionBox->dynamicVertices.clear();
+    if (hasTextCollisionCircleData) bucket.textCollisionCircle->dynamicVertices.clear();
 
     const JointOpacityState duplicateOpacityState(false, false, true);
 
@@ -914,7 +1265,8 @@ void Placement::updateBucketOpacities(SymbolBucket& bucket,
             iconAllowOverlap && (textAllowOverlap || !bucket.hasTextData() || bucket.layout->get<style::TextOptional>()),
             true);
 
-    for (SymbolInstance& symbolInstance : bucket.symbolInstances) {
+    for (std::size_t symbolIndex = 0; symbolIndex < bucket.symbolInstances.size(); ++symbolIndex) {
+        SymbolInstance& symbolInstance = bucket.symbolInstances[symbolIndex];
         bool isDuplicate = seenCrossTileIDs.count(symbolInstance.crossTileID) > 0;
 
         auto it = opacities.find(symbolInstance.crossTileID);
@@ -950,7 +1302,7 @@ void Placement::updateBucketOpacities(SymbolBucket& bucket,
                 bucket.text.placedSymbols[*symbolInstance.placedVerticalTextIndex].hidden = opacityState.isHidden();
             }
 
-            bucket.text.opacityVertices.extend(textOpacityVerticesSize, opacityVertex);
+            updateOpacityVertices(bucket.text, textOpacityOffset, textOpacityVerticesSize, symbolIndex, opacityVertex);
 
             style::TextWritingModeType previousOrientation = style::TextWritingModeType::Horizontal;
             if (bucket.allowVerticalPlacement) {
@@ -971,7 +1323,8 @@ void Placement::updateBucketOpacities(SymbolBucket& bucket,
             const auto& opacityVertex =
                 SymbolIconProgram::opacityVertex(opacityState.icon.placed, opacityState.icon.opacity);
             auto& iconBuffer = symbolInstance.hasSdfIcon() ? bucket.sdfIcon : bucket.icon;
-            
+            auto& iconBufferOffset = symbolInstance.hasSdfIcon() ? sdfIconOpacityOffset : iconOpacityOffset;
+
             if (symbolInstance.placedIconIndex) {
                 iconOpacityVerticesSize += symbolInstance.iconQuadsSize * 4;
                 iconBuffer.placedSymbols[*symbolInstance.placedIconIndex].hidden = opacityState.isHidden();
@@ -982,9 +1335,11 @@ void Placement::updateBucketOpacities(SymbolBucket& bucket,
                 iconBuffer.placedSymbols[*symbolInstance.placedVerticalIconIndex].hidden = opacityState.isHidden();
             }
 
-            iconBuffer.opacityVertices.extend(iconOpacityVerticesSize, opacityVertex);
+            updateOpacityVertices(iconBuffer, iconBufferOffset, iconOpacityVerticesSize, symbolIndex, opacityVertex);
         }
 
+        if (!hasCollisionDebugData) continue;
+
         auto updateIconCollisionBox = [&](const auto& feature, const bool placed, const Point<float>& shift) {
             if (feature.alongLine) {
                 return;
@@ -1049,27 +1404,31 @@ void Placement::updateBucketOpacities(SymbolBucket& bucket,
         };
         Point<float> textShift{0.0f, 0.0f};
         Point<float> verticalTextShift{0.0f, 0.0f};
-        if (bucket.hasTextCollisionBoxData()) {
+        if (hasTextCollisionBoxData) {
             textShift = updateTextCollisionBox(symbolInstance.textCollisionFeature, opacityState.text.placed);
             if (bucket.allowVerticalPlacement && symbolInstance.verticalTextCollisionFeature) {
                 verticalTextShift = updateTextCollisionBox(*symbolInstance.verticalTextCollisionFeature, opacityState.text.placed);
             }
         }
-        if (bucket.hasIconCollisionBoxData()) {
+        if (hasIconCollisionBoxData) {
             updateIconCollisionBox(symbolInstance.iconCollisionFeature, opacityState.icon.placed, hasIconTextFit ? textShift : Point<float>{0.0f, 0.0f});
             if (bucket.allowVerticalPlacement && symbolInstance.verticalIconCollisionFeature) {
                 updateIconCollisionBox(*symbolInstance.verticalIconCollisionFeature, opacityState.text.placed, hasIconTextFit ? verticalTextShift : Point<float>{0.0f, 0.0f});
             }
         }
 
-        if (bucket.hasIconCollisionCircleData()) {
+        if (hasIconCollisionCircleData) {
             updateCollisionCircles(symbolInstance.iconCollisionFeature, opacityState.icon.placed, false);
         }
-        if (bucket.hasTextCollisionCircleData()) {
+        if (hasTextCollisionCircleData) {
             updateCollisionCircles(symbolInstance.textCollisionFeature, opacityState.text.placed, true);
         }
     }
 
+    assert(textOpacityOffset == bucket.text.opacityVertices.elements());
+    assert(iconOpacityOffset == bucket.icon.opacityVertices.elements());
+    assert(sdfIconOpacityOffset == bucket.sdfIcon.opacityVertices.elements());
+
     bucket.sortFeatures(state.getBearing());
     auto retainedData = retainedQueryData.find(bucket.bucketInstanceId);
     if (retainedData != retainedQueryData.end()) {
@@ -1242,11 +1601,15 @@ void StaticPlacement::commit() {
 /// Placement for Tile map mode.
 
 struct Intersection {
-    Intersection(const SymbolInstance& symbol_, PlacementContext ctx_, IntersectStatus status_)
-        : symbol(symbol_), ctx(std::move(ctx_)), status(status_) {}
+    Intersection(const SymbolInstance& symbol_,
+                 PlacementContext ctx_,
+                 IntersectStatus status_,
+                 std::size_t statisticsLayer_)
+        : symbol(symbol_), ctx(std::move(ctx_)), status(status_), statisticsLayer(statisticsLayer_) {}
     std::reference_wrapper<const SymbolInstance> symbol;
     PlacementContext ctx;
     IntersectStatus status;
+    std::size_t statisticsLayer;
 };
 
 class TilePlacement : public StaticPlacement {
@@ -1316,6 +1679,7 @@ void TilePlacement::placeLayers(const RenderLayerReferences& layers) {
     });
     // Place intersections.
     for (const auto& intersection : intersections) {
+        statisticsLayer = intersection.statisticsLayer;
         placeSymbol(intersection.symbol, intersection.ctx, seenCrossTileIDs);
     }
     // Place the rest labels.
@@ -1351,6 +1715,7 @@ void TilePlacement::placeSymbolBucket(const BucketPlacementData& params, std::se
     const RenderTile& renderTile = params.tile;
     PlacementContext ctx{bucket,
                          params.tile,
+                         renderTile.matrix,
                          collisionIndex.getTransformState(),
                          placementZoom,
                          collisionGroups.get(params.sourceId),
@@ -1456,7 +1821,7 @@ void TilePlacement::placeSymbolBucket(const BucketPlacementData& params, std::se
     for (const SymbolInstance& symbol : symbolInstances) {
         auto intersectStatus = symbolIntersectsTileEdges(symbol);
         if (intersectStatus.flags == IntersectStatus::None) continue;
-        intersections.emplace_back(symbol, ctx, intersectStatus);
+        intersections.emplace_back(symbol, ctx, intersectStatus, *statisticsLayer);
     }
 }
 
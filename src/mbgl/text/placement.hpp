@@ -1,6 +1,7 @@
 #pragma once
 
 #include <mbgl/layout/symbol_projection.hpp>
+#include <mbgl/renderer/placement_statistics.hpp>
 #include <mbgl/renderer/renderer.hpp>
 #include <mbgl/style/transition_options.hpp>
 #include <mbgl/text/collision_index.hpp>
@@ -101,8 +102,19 @@ public:
     bool placementIsRecent(TimePoint now, float zoom, optional<Duration> periodOverride = nullopt) const;
     bool hasTransitions(TimePoint now) const;
 
+    // With a time budget, a placement is spread across frames. It is kept here while in progress
+    // and only replaces the current placement once all of its layers are placed. Any placement set
+    // in the meantime drops it.
+    void setPendingPlacement(Mutable<Placement>, const RenderLayerReferences&);
+    // Returns false if there is no pending placement, or if it was started for other layers.
+    bool hasPendingPlacement(const RenderLayerReferences&) const;
+    // Returns true once the pending placement is done and became the current placement.
+    bool continuePlacement(const RenderLayerReferences&, TimePoint now, Duration budget);
+
 private:
     Immutable<Placement> placement;
+    optional<Mutable<Placement>> pendingPlacement;
+    std::vector<std::string> pendingLayerIDs;
     bool stale = false;
 };
 
@@ -118,8 +130,18 @@ public:
                                      optional<Immutable<Placement>> prevPlacement = nullopt);
 
     virtual ~Placement();
+    // Without cross-source collisions, makes placeLayers() place the layers of each source on its own
+    // thread. Off by default, see platform::EXPERIMENTAL_CONCURRENT_PLACEMENT.
+    void setConcurrent(bool enable) { concurrent = enable; }
     virtual void placeLayers(const RenderLayerReferences&);
-    void updateLayerBuckets(const RenderLayer&, const TransformState&, bool updateOpacities) const;
+    // Places the layers for about `budget`, but at least one bucket, and returns false if the
+    // placement has to be continued in a later frame with the same layers. Once all layers are
+    // placed, the placement is committed at `now`.
+    bool continuePlacement(const RenderLayerReferences&, TimePoint now, Duration budget);
+    // Updates the buckets of the layers, given from bottom to top. The opacities are updated
+    // in order, then the dynamic vertices of the buckets that have any, concurrently if there
+    // are many of them.
+    void updateLayerBuckets(const RenderLayerReferences&, const TransformState&, bool updateOpacities) const;
     virtual float symbolFadeChange(TimePoint now) const;
     virtual bool hasTransitions(TimePoint now) const;
     virtual bool transitionsEnabled() const;
@@ -127,6 +149,7 @@ public:
     virtual const std::vector<PlacedSymbolData>& getPlacedSymbolsData() const;
 
     const CollisionIndex& getCollisionIndex() const;
+    const PlacementStatistics& getStatistics() const { return statistics; }
     TimePoint getCommitTime() const { return commitTime; }
     Duration getUpdatePeriod(float zoom) const;
 
@@ -146,6 +169,15 @@ protected:
                      const PlacementContext&,
                      std::set<uint32_t>& seenCrossTileIDs);
     void placeLayer(const RenderLayer&, std::set<uint32_t>&);
+    // Makes the symbols placed next count into the statistics of the layer.
+    void beginLayerStatistics(const RenderLayer&);
+    PlacementStatistics::Layer& layerStatistics();
+    bool placeLayersConcurrently(const RenderLayerReferences&);
+    void startPlacement(const RenderLayerReferences&);
+    mat4 getPosMatrix(const RenderTile&) const;
+    optional<Point<float>> getCarryOverShift() const;
+    bool canCarryOver(const BucketPlacementData&) const;
+    bool carryOverSymbol(const SymbolInstance&, std::set<uint32_t>& seenCrossTileIDs);
     virtual void commit();
     virtual void newSymbolPlaced(const SymbolInstance&,
                                  const PlacementContext&,
@@ -194,9 +226,26 @@ protected:
     std::unordered_map<uint32_t, style::TextWritingModeType> placedOrientations;
 
     std::unordered_map<uint32_t, RetainedQueryData> retainedQueryData;
+    // Buckets whose symbols went through collision detection, i.e. whose tile wasn't held for fading.
+    std::unordered_set<uint32_t> placedBuckets;
+    // Set while the results for the buckets placed by the previous placement are carried over,
+    // to the on-screen offset of the previous placement's collision boxes.
+    optional<Point<float>> carryOverShift;
+    // The distance the camera moved since the last placement that didn't carry over any results.
+    float carryOverDistance = 0.0f;
     CollisionGroups collisionGroups;
     mutable optional<Immutable<Placement>> prevPlacement;
     bool showCollisionBoxes = false;
+    bool concurrent = false;
+
+    // Progress of a placement spread across frames.
+    bool placementStarted = false;
+    std::size_t placedLayerCount = 0u;
+    std::size_t placedBucketCount = 0u;
+    std::set<uint32_t> layerSeenCrossTileIDs;
+
+    PlacementStatistics statistics;
+    optional<std::size_t> statisticsLayer;
 
     // Cache being used by placeSymbol()
     std::vector<ProjectedCollisionBox> textBoxes;
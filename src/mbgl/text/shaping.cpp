@@ -4,6 +4,7 @@
 #include <mbgl/layout/symbol_feature.hpp>
 #include <mbgl/math/minmax.hpp>
 #include <mbgl/text/bidi.hpp>
+#include <mbgl/text/shaping_cache.hpp>
 
 #include <algorithm>
 #include <list>
@@ -348,7 +349,8 @@ std::set<std::size_t> determineLineBreaks(const TaggedString& logicalInput,
     return leastBadBreaks(evaluateBreak(logicalInput.length(), currentX, targetWidth, potentialBreaks, 0, true));
 }
 
-void shapeLines(Shaping& shaping,
+// Returns false if any of the glyphs or images were missing and left out.
+bool shapeLines(Shaping& shaping,
                 std::vector<TaggedString>& lines,
                 const float spacing,
                 const float lineHeight,
@@ -362,6 +364,7 @@ void shapeLines(Shaping& shaping,
                 bool allowVerticalPlacement) {
     float x = 0.0f;
     float y = Shaping::yOffset;
+    bool complete = true;
 
     float maxLineLength = 0.0f;
     double maxLineHeight = 0.0f;
@@ -409,6 +412,7 @@ void shapeLines(Shaping& shaping,
             if (!section.imageID) {
                 auto glyphPositionMap = glyphPositions.find(section.fontStackHash);
                 if (glyphPositionMap == glyphPositions.end()) {
+                    complete = false;
                     continue;
                 }
 
@@ -419,11 +423,13 @@ void shapeLines(Shaping& shaping,
                 } else {
                     auto glyphs = glyphMap.find(section.fontStackHash);
                     if (glyphs == glyphMap.end()) {
+                        complete = false;
                         continue;
                     }
 
                     auto glyph = glyphs->second.find(codePoint);
                     if (glyph == glyphs->second.end() || !glyph->second) {
+                        complete = false;
                         continue;
                     }
                     metrics = (*glyph->second)->metrics;
@@ -436,6 +442,7 @@ void shapeLines(Shaping& shaping,
             } else {
                 auto image = imagePositions.find(*section.imageID);
                 if (image == imagePositions.end()) {
+                    complete = false;
                     continue;
                 }
                 shaping.iconsInText |= true;
@@ -526,8 +533,52 @@ void shapeLines(Shaping& shaping,
     shaping.bottom = shaping.top + height;
     shaping.left += -anchorAlign.horizontalAlign * maxLineLength;
     shaping.right = shaping.left + maxLineLength;
+
+    return complete;
+}
+
+namespace {
+
+// Images in text may change with the style, so only plain text shapings are cached.
+bool isCacheable(const TaggedString& formattedString) {
+    for (const auto& section : formattedString.getSections()) {
+        if (section.imageID) return false;
+    }
+    return true;
+}
+
+// Glyphs are placed differently in the atlas of each tile, so a cached shaping has to take the
+// glyph rectangles from this tile's positions. It can't be used if any glyph is missing or has
+// different metrics.
+bool updateGlyphPositions(Shaping& shaping, const GlyphMap& glyphMap, const GlyphPositions& glyphPositions) {
+    for (auto& line : shaping.positionedLines) {
+        for (auto& positionedGlyph : line.positionedGlyphs) {
+            auto glyphPositionMap = glyphPositions.find(positionedGlyph.font);
+            if (glyphPositionMap == glyphPositions.end()) return false;
+
+            auto glyphPosition = glyphPositionMap->second.find(positionedGlyph.glyph);
+            if (glyphPosition != glyphPositionMap->second.end()) {
+                if (!(glyphPosition->second.metrics == positionedGlyph.metrics)) return false;
+                positionedGlyph.rect = glyphPosition->second.rect;
+                continue;
+            }
+
+            // Glyphs without a bitmap, such as spaces, have no position in the atlas.
+            auto glyphs = glyphMap.find(positionedGlyph.font);
+            if (glyphs == glyphMap.end()) return false;
+            auto glyph = glyphs->second.find(positionedGlyph.glyph);
+            if (glyph == glyphs->second.end() || !glyph->second ||
+                !((*glyph->second)->metrics == positionedGlyph.metrics)) {
+                return false;
+            }
+            positionedGlyph.rect = {};
+        }
+    }
+    return true;
 }
 
+} // namespace
+
 Shaping getShaping(const TaggedString& formattedString,
                    const float maxWidth,
                    const float lineHeight,
@@ -544,6 +595,33 @@ Shaping getShaping(const TaggedString& formattedString,
                    float layoutTextSizeAtBucketZoomLevel,
                    bool allowVerticalPlacement) {
     assert(layoutTextSize);
+
+    optional<ShapingCache::Key> cacheKey;
+    if (isCacheable(formattedString)) {
+        std::vector<std::pair<FontStackHash, double>> sections;
+        sections.reserve(formattedString.sectionCount());
+        for (const auto& section : formattedString.getSections()) {
+            sections.emplace_back(section.fontStackHash, section.scale);
+        }
+        cacheKey = ShapingCache::Key{formattedString.getStyledText(),
+                                     std::move(sections),
+                                     maxWidth,
+                                     lineHeight,
+                                     textAnchor,
+                                     textJustify,
+                                     spacing,
+                                     translate,
+                                     writingMode,
+                                     layoutTextSize,
+                                     layoutTextSizeAtBucketZoomLevel,
+                                     allowVerticalPlacement};
+        if (auto cached = ShapingCache::get().find(*cacheKey)) {
+            if (updateGlyphPositions(*cached, glyphMap, glyphPositions)) {
+                return std::move(*cached);
+            }
+        }
+    }
+
     std::vector<TaggedString> reorderedLines;
     if (formattedString.sectionCount() == 1) {
         auto untaggedLines = bidi.processText(
@@ -561,18 +639,23 @@ Shaping getShaping(const TaggedString& formattedString,
         }
     }
     Shaping shaping(translate[0], translate[1], writingMode);
-    shapeLines(shaping,
-               reorderedLines,
-               spacing,
-               lineHeight,
-               textAnchor,
-               textJustify,
-               writingMode,
-               glyphMap,
-               glyphPositions,
-               imagePositions,
-               layoutTextSizeAtBucketZoomLevel,
-               allowVerticalPlacement);
+    const bool complete = shapeLines(shaping,
+                                     reorderedLines,
+                                     spacing,
+                                     lineHeight,
+                                     textAnchor,
+                                     textJustify,
+                                     writingMode,
+                                     glyphMap,
+                                     glyphPositions,
+                                     imagePositions,
+                                     layoutTextSizeAtBucketZoomLevel,
+                                     allowVerticalPlacement);
+
+    // Shapings with missing glyphs depend on this tile's glyphs and are not reused.
+    if (cacheKey && complete) {
+        ShapingCache::get().add(std::move(*cacheKey), shaping);
+    }
 
     return shaping;
 }
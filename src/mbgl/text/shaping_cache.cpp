@@ -0,0 +1,94 @@
+#include <mbgl/text/shaping_cache.hpp>
+#include <mbgl/util/hash.hpp>
+
+#include <cassert>
+
+namespace mbgl {
+
+bool ShapingCache::Key::operator==(const Key& rhs) const {
+    return text == rhs.text && sections == rhs.sections && maxWidth == rhs.maxWidth &&
+           lineHeight == rhs.lineHeight && textAnchor == rhs.textAnchor && textJustify == rhs.textJustify &&
+           spacing == rhs.spacing && translate == rhs.translate && writingMode == rhs.writingMode &&
+           layoutTextSize == rhs.layoutTextSize &&
+           layoutTextSizeAtBucketZoomLevel == rhs.layoutTextSizeAtBucketZoomLevel &&
+           allowVerticalPlacement == rhs.allowVerticalPlacement;
+}
+
+std::size_t ShapingCache::KeyHasher::operator()(const Key& key) const {
+    std::size_t seed = util::hash(key.text.first,
+                                  key.maxWidth,
+                                  key.lineHeight,
+                                  static_cast<uint8_t>(key.textAnchor),
+                                  static_cast<uint8_t>(key.textJustify),
+                                  key.spacing,
+                                  key.translate[0],
+                                  key.translate[1],
+                                  static_cast<uint8_t>(key.writingMode),
+                                  key.layoutTextSize,
+                                  key.layoutTextSizeAtBucketZoomLevel,
+                                  key.allowVerticalPlacement);
+    // The section indices only matter for formatted text.
+    if (key.sections.size() > 1) {
+        for (const uint8_t index : key.text.second) {
+            util::hash_combine(seed, index);
+        }
+    }
+    for (const auto& section : key.sections) {
+        util::hash_combine(seed, section.first);
+        util::hash_combine(seed, section.second);
+    }
+    return seed;
+}
+
+ShapingCache::ShapingCache(std::size_t maxEntries_) : maxEntries(maxEntries_) {
+    assert(maxEntries > 0);
+}
+
+ShapingCache& ShapingCache::get() {
+    // Intentionally leaked: tile workers may still be shaping while static destructors run.
+    static auto* cache = new ShapingCache();
+    return *cache;
+}
+
+optional<Shaping> ShapingCache::find(const Key& key) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = entries.find(key);
+    if (it == entries.end()) {
+        return nullopt;
+    }
+    orderedKeys.splice(orderedKeys.end(), orderedKeys, it->second.position);
+    return it->second.shaping;
+}
+
+void ShapingCache::add(Key key, Shaping shaping) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = entries.find(key);
+    if (it != entries.end()) {
+        // Another worker shaped the same text in the meantime.
+        it->second.shaping = std::move(shaping);
+        orderedKeys.splice(orderedKeys.end(), orderedKeys, it->second.position);
+        return;
+    }
+
+    if (entries.size() >= maxEntries) {
+        auto oldest = entries.find(*orderedKeys.front());
+        orderedKeys.pop_front();
+        entries.erase(oldest);
+    }
+
+    it = entries.emplace(std::move(key), Entry{std::move(shaping), orderedKeys.end()}).first;
+    it->second.position = orderedKeys.insert(orderedKeys.end(), &it->first);
+}
+
+void ShapingCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    entries.clear();
+    orderedKeys.clear();
+}
+
+std::size_t ShapingCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return entries.size();
+}
+
+} // namespace mbgl
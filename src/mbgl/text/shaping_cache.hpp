@@ -0,0 +1,69 @@
+#pragma once
+
+#include <mbgl/style/types.hpp>
+#include <mbgl/text/glyph.hpp>
+#include <mbgl/text/tagged_string.hpp>
+#include <mbgl/util/noncopyable.hpp>
+#include <mbgl/util/optional.hpp>
+
+#include <array>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace mbgl {
+
+// Shapings of label text, shared by the workers of all tiles: the same label, such as a road
+// name, usually appears in several tiles and at several zoom levels. The least recently used
+// entries are evicted once the cache is full. Thread-safe.
+class ShapingCache : private util::noncopyable {
+public:
+    // Everything getShaping() depends on, apart from the glyphs and their positions.
+    struct Key {
+        StyledText text;
+        // Font stack and scale of each section.
+        std::vector<std::pair<FontStackHash, double>> sections;
+        float maxWidth;
+        float lineHeight;
+        style::SymbolAnchorType textAnchor;
+        style::TextJustifyType textJustify;
+        float spacing;
+        std::array<float, 2> translate;
+        WritingModeType writingMode;
+        float layoutTextSize;
+        float layoutTextSizeAtBucketZoomLevel;
+        bool allowVerticalPlacement;
+
+        bool operator==(const Key&) const;
+    };
+
+    explicit ShapingCache(std::size_t maxEntries = 4096);
+
+    // The cache used by getShaping().
+    static ShapingCache& get();
+
+    optional<Shaping> find(const Key&);
+    void add(Key, Shaping);
+    void clear();
+    std::size_t size() const;
+
+private:
+    struct KeyHasher {
+        std::size_t operator()(const Key&) const;
+    };
+
+    struct Entry {
+        Shaping shaping;
+        std::list<const Key*>::iterator position;
+    };
+
+    const std::size_t maxEntries;
+    mutable std::mutex mutex;
+    std::unordered_map<Key, Entry, KeyHasher> entries;
+    // Least recently used first. Points to the keys of `entries`, which stay in place on rehashing.
+    std::list<const Key*> orderedKeys;
+};
+
+} // namespace mbgl
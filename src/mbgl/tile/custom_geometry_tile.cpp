@@ -58,6 +58,7 @@ void CustomGeometryTile::invalidateTileData() {
 // Only required tiles make fetchTile requests. Attempt to cancel a tile
 // that is no longer required.
 void CustomGeometryTile::setNecessity(TileNecessity newNecessity) {
+   GeometryTile::setNecessity(newNecessity);
    if (newNecessity != necessity || stale ) {
         necessity = newNecessity;
         if (necessity == TileNecessity::Required) {
@@ -77,17 +78,7 @@ void CustomGeometryTile::querySourceFeatures(
     auto layer = getData()->getLayer({});
 
     if (layer) {
-        auto featureCount = layer->featureCount();
-        for (std::size_t i = 0; i < featureCount; i++) {
-            auto feature = layer->getFeature(i);
-
-            // Apply filter, if any
-            if (queryOptions.filter && !(*queryOptions.filter)(style::expression::EvaluationContext { static_cast<float>(id.overscaledZ), feature.get() })) {
-                continue;
-            }
-
-            result.push_back(convertFeature(*feature, id.canonical));
-        }
+        querySourceLayerFeatures(result, *layer, queryOptions);
     }
 }
 
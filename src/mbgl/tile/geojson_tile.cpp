@@ -20,14 +20,19 @@ void GeoJSONTile::updateData(std::shared_ptr<style::GeoJSONData> data_, bool nee
     if (needsRelayout) reset();
     data->getTile(
         id.canonical,
-        [this, self = weakFactory.makeWeakPtr(), capturedData = data.get()](style::GeoJSONData::TileFeatures features) {
+        [this, self = weakFactory.makeWeakPtr(), request = ++dataRequest](style::GeoJSONData::TileFeatures features) {
             if (!self) return;
-            if (data.get() != capturedData) return;
+            if (dataRequest != request) return;
             auto tileData = std::make_unique<GeoJSONTileData>(std::move(features));
             setData(std::move(tileData));
         });
 }
 
+void GeoJSONTile::replaceData(std::shared_ptr<style::GeoJSONData> data_) {
+    assert(data_);
+    data = std::move(data_);
+}
+
 void GeoJSONTile::querySourceFeatures(
     std::vector<Feature>& result,
     const SourceQueryOptions& options) {
@@ -35,17 +40,7 @@ void GeoJSONTile::querySourceFeatures(
     // Ignore the sourceLayer, there is only one
     if (auto tileData = getData()) {
         if (auto layer = tileData->getLayer({})) {
-            auto featureCount = layer->featureCount();
-            for (std::size_t i = 0; i < featureCount; i++) {
-                auto feature = layer->getFeature(i);
-
-                // Apply filter, if any
-                if (options.filter && !(*options.filter)(style::expression::EvaluationContext { static_cast<float>(this->id.overscaledZ), feature.get() })) {
-                    continue;
-                }
-
-                result.push_back(convertFeature(*feature, id.canonical));
-            }
+            querySourceLayerFeatures(result, *layer, options);
         }
     }
 }
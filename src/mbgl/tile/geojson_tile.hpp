@@ -18,6 +18,8 @@ public:
                 std::shared_ptr<style::GeoJSONData>);
 
     void updateData(std::shared_ptr<style::GeoJSONData> data, bool needsRelayout = false);
+    // Swaps in data with the same features for this tile, without reloading it.
+    void replaceData(std::shared_ptr<style::GeoJSONData> data);
 
     void querySourceFeatures(
         std::vector<Feature>& result,
@@ -25,6 +27,7 @@ public:
 
 private:
     std::shared_ptr<style::GeoJSONData> data;
+    uint64_t dataRequest = 0;
     mapbox::base::WeakPtrFactory<GeoJSONTile> weakFactory{this};
 };
 
@@ -20,14 +20,16 @@
 #include <mbgl/tile/geometry_tile_worker.hpp>
 #include <mbgl/tile/tile_observer.hpp>
 #include <mbgl/util/logging.hpp>
+#include <mbgl/util/tile_trace.hpp>
 
 #include <mbgl/gfx/upload_pass.hpp>
+#include <unordered_set>
 #include <utility>
 
 namespace mbgl {
 
 LayerRenderData* GeometryTile::LayoutResult::getLayerRenderData(const style::Layer::Impl& layerImpl) {
-    auto it = layerRenderData.find(layerImpl.id);
+    auto it = layerRenderData.find(layerImpl.internedID);
     if (it == layerRenderData.end()) {
         return nullptr;
     }
@@ -42,9 +44,11 @@ LayerRenderData* GeometryTile::LayoutResult::getLayerRenderData(const style::Lay
 class GeometryTileRenderData final : public TileRenderData {
 public:
     GeometryTileRenderData(
+        const OverscaledTileID& id_,
         std::shared_ptr<GeometryTile::LayoutResult> layoutResult_,
         std::shared_ptr<TileAtlasTextures> atlasTextures_)
         : TileRenderData(std::move(atlasTextures_))
+        , id(id_)
         , layoutResult(std::move(layoutResult_)) {
     }
 
@@ -54,10 +58,9 @@ private:
     const LayerRenderData* getLayerRenderData(const style::Layer::Impl&) const override;
     Bucket* getBucket(const style::Layer::Impl&) const override;
     void upload(gfx::UploadPass&) override;
-    void prepare(const SourcePrepareParameters&) override;
 
+    const OverscaledTileID id;
     std::shared_ptr<GeometryTile::LayoutResult> layoutResult;
-    std::vector<ImagePatch> imagePatches;
 };
 
 using namespace style;
@@ -76,44 +79,41 @@ optional<ImagePosition> GeometryTileRenderData::getPattern(const std::string& pa
 void GeometryTileRenderData::upload(gfx::UploadPass& uploadPass) {
     if (!layoutResult) return;
 
-    auto uploadFn = [&] (Bucket& bucket) {
+    bool uploaded = false;
+    auto uploadFn = [&] (const std::string& layerID, Bucket& bucket) {
         if (bucket.needsUpload()) {
+            if (!uploaded) {
+                uploaded = true;
+                util::TileTrace::begin(id, "upload");
+            }
+            gfx::MemoryOwner owner = uploadPass.getMemoryOwner();
+            owner.layer = layerID;
+            const auto memoryScope = uploadPass.createMemoryScope(std::move(owner));
             bucket.upload(uploadPass);
         }
     };
 
     for (auto& entry : layoutResult->layerRenderData) {
-        uploadFn(*entry.second.bucket);
+        uploadFn(entry.second.layerProperties->baseImpl->id, *entry.second.bucket);
     }
 
     assert(atlasTextures);
 
-    if (layoutResult->glyphAtlasImage) {
-        atlasTextures->glyph = uploadPass.createTexture(*layoutResult->glyphAtlasImage);
-        layoutResult->glyphAtlasImage = {};
+    if (atlasTextures->glyphAtlas) {
+        const auto memoryScope = uploadPass.createMemoryScope(gfx::MemoryOwner::forShared("glyph atlas"));
+        atlasTextures->glyphAtlas->upload(uploadPass);
     }
 
-    if (layoutResult->iconAtlas.image.valid()) {
-        atlasTextures->icon = uploadPass.createTexture(layoutResult->iconAtlas.image);
-        layoutResult->iconAtlas.image = {};
+    if (atlasTextures->imageAtlas) {
+        const auto memoryScope = uploadPass.createMemoryScope(gfx::MemoryOwner::forShared("image atlas"));
+        atlasTextures->imageAtlas->upload(uploadPass);
     }
 
-    if (atlasTextures->icon && !imagePatches.empty()) {
-        for (const auto& imagePatch : imagePatches) { // patch updated images.
-            uploadPass.updateTextureSub(*atlasTextures->icon,
-                                        imagePatch.image->image,
-                                        imagePatch.paddedRect.x + ImagePosition::padding,
-                                        imagePatch.paddedRect.y + ImagePosition::padding);
-        }
-        imagePatches.clear();
+    if (uploaded) {
+        util::TileTrace::end(id, "upload");
     }
 }
 
-void GeometryTileRenderData::prepare(const SourcePrepareParameters& parameters) {
-    if (!layoutResult) return;
-    imagePatches = layoutResult->iconAtlas.getImagePatchesAndUpdateVersions(parameters.imageManager);
-}
-
 Bucket* GeometryTileRenderData::getBucket(const Layer::Impl& layer) const {
     const LayerRenderData* data = getLayerRenderData(layer);
     return data ? data->bucket.get() : nullptr; 
@@ -154,12 +154,15 @@ GeometryTile::GeometryTile(const OverscaledTileID& id_,
              obsolete,
              parameters.mode,
              parameters.pixelRatio,
-             parameters.debugOptions & MapDebugOptions::Collision),
+             parameters.debugOptions & MapDebugOptions::Collision,
+             parameters.glyphManager.getGlyphAtlas(),
+             parameters.imageManager.getImageAtlas()),
       fileSource(parameters.fileSource),
       glyphManager(parameters.glyphManager),
       imageManager(parameters.imageManager),
       mode(parameters.mode),
       showCollisionBoxes(parameters.debugOptions & MapDebugOptions::Collision) {
+    worker.setTag(TaskTag::Tile);
 }
 
 GeometryTile::~GeometryTile() {
@@ -167,6 +170,10 @@ GeometryTile::~GeometryTile() {
     markObsolete();
 }
 
+void GeometryTile::setNecessity(TileNecessity necessity) {
+    worker.setPriority(necessity == TileNecessity::Required ? TaskPriority::High : TaskPriority::Low);
+}
+
 void GeometryTile::cancel() {
     markObsolete();
 }
@@ -186,6 +193,7 @@ void GeometryTile::setData(std::unique_ptr<const GeometryTileData> data_) {
     pending = true;
 
     ++correlationID;
+    util::TileTrace::begin(id, "data queued");
     worker.self().invoke(
         &GeometryTileWorker::setData, std::move(data_), imageManager.getAvailableImages(), correlationID);
 }
@@ -200,7 +208,7 @@ void GeometryTile::reset() {
 }
 
 std::unique_ptr<TileRenderData> GeometryTile::createRenderData() {
-    return std::make_unique<GeometryTileRenderData>(layoutResult, atlasTextures);
+    return std::make_unique<GeometryTileRenderData>(id, layoutResult, atlasTextures);
 }
 
 void GeometryTile::setLayers(const std::vector<Immutable<LayerProperties>>& layers) {
@@ -239,24 +247,47 @@ void GeometryTile::setShowCollisionBoxes(const bool showCollisionBoxes_) {
 }
 
 void GeometryTile::onLayout(std::shared_ptr<LayoutResult> result, const uint64_t resultCorrelationID) {
+    util::TileTrace::end(id, "result queued");
     loaded = true;
     renderable = true;
+    partial = false;
     if (resultCorrelationID == correlationID) {
         pending = false;
     }
 
     layoutResult = std::move(result);
     if (!atlasTextures) {
-    	atlasTextures = std::make_shared<TileAtlasTextures>();
+        atlasTextures = std::make_shared<TileAtlasTextures>();
+        atlasTextures->glyphAtlas = glyphManager.getGlyphAtlas();
+        atlasTextures->imageAtlas = imageManager.getImageAtlas();
     }
     
     observer->onTileChanged(*this);
 }
 
+void GeometryTile::onPartialLayout(std::shared_ptr<LayoutResult> result, const uint64_t resultCorrelationID) {
+    // Never replace a complete result or a result of a newer request.
+    if (resultCorrelationID != correlationID || (layoutResult && !pending)) {
+        return;
+    }
+
+    renderable = true;
+    partial = true;
+    layoutResult = std::move(result);
+    if (!atlasTextures) {
+        atlasTextures = std::make_shared<TileAtlasTextures>();
+        atlasTextures->glyphAtlas = glyphManager.getGlyphAtlas();
+        atlasTextures->imageAtlas = imageManager.getImageAtlas();
+    }
+
+    observer->onTileChanged(*this);
+}
+
 void GeometryTile::onError(std::exception_ptr err, const uint64_t resultCorrelationID) {
     loaded = true;
     if (resultCorrelationID == correlationID) {
         pending = false;
+        partial = false;
     }
     observer->onTileError(*this, std::move(err));
 }
@@ -279,6 +310,22 @@ void GeometryTile::getImages(ImageRequestPair pair) {
     imageManager.getImages(*this, std::move(pair));
 }
 
+std::size_t GeometryTile::getMemoryUsage() const {
+    std::size_t bytes = 0u;
+    if (layoutResult) {
+        // Buckets are shared by the layers of the same layout group.
+        std::unordered_set<const Bucket*> buckets;
+        for (const auto& entry : layoutResult->layerRenderData) {
+            const Bucket* bucket = entry.second.bucket.get();
+            if (bucket && buckets.insert(bucket).second) {
+                bytes += bucket->getMemoryUsage();
+            }
+        }
+    }
+    // The glyph and image atlases are shared by all tiles, so they aren't counted here.
+    return bytes;
+}
+
 std::shared_ptr<FeatureIndex> GeometryTile::getFeatureIndex() const {
     return layoutResult ? layoutResult->featureIndex : nullptr;
 }
@@ -291,6 +338,16 @@ bool GeometryTile::layerPropertiesUpdated(const Immutable<style::LayerProperties
 
     if (renderData->layerProperties != layerProperties &&
         renderData->layerProperties->constantsMask() == layerProperties->constantsMask()) {
+        // Data-driven paint changes that don't need a new layout are applied to the existing bucket.
+        const style::Layer::Impl& previousImpl = *renderData->layerProperties->baseImpl;
+        if (renderData->bucket && &previousImpl != layerProperties->baseImpl.get() &&
+            previousImpl.hasPaintPropertyBinderDifference(*layerProperties->baseImpl)) {
+            const GeometryTileData* data = getData();
+            const auto sourceLayer = data ? data->getLayer(layerProperties->baseImpl->sourceLayer) : nullptr;
+            if (sourceLayer) {
+                renderData->bucket->updatePaintProperties(layerProperties, *sourceLayer, id.canonical);
+            }
+        }
         renderData->layerProperties = layerProperties;
     }
 
@@ -359,16 +416,11 @@ void GeometryTile::querySourceFeatures(
         auto layer = getData()->getLayer(sourceLayer);
         
         if (layer) {
-            auto featureCount = layer->featureCount();
-            for (std::size_t i = 0; i < featureCount; i++) {
-                auto feature = layer->getFeature(i);
-
-                // Apply filter, if any
-                if (options.filter && !(*options.filter)(style::expression::EvaluationContext { static_cast<float>(this->id.overscaledZ), feature.get() })) {
-                    continue;
-                }
-
-                result.emplace_back(convertFeature(*feature, id.canonical));
+            const std::size_t begin = result.size();
+            querySourceLayerFeatures(result, *layer, options);
+            // Feature ids are only unique within their source layer.
+            for (std::size_t i = begin; i < result.size(); ++i) {
+                result[i].sourceLayer = sourceLayer;
             }
         }
     }
@@ -403,7 +455,7 @@ void GeometryTile::setFeatureState(const LayerFeatureStates& states) {
 
     auto& layerIdToLayerRenderData = layoutResult->layerRenderData;
     for (auto& layer : layerIdToLayerRenderData) {
-        const auto& layerID = layer.first;
+        const auto& layerID = layer.second.layerProperties->baseImpl->id;
         const auto sourceLayer = layers->getLayer(layerID);
         if (sourceLayer) {
             const auto& sourceLayerID = sourceLayer->getName();
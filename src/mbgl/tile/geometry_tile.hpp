@@ -3,12 +3,15 @@
 #include <mbgl/actor/actor.hpp>
 #include <mbgl/geometry/feature_index.hpp>
 #include <mbgl/gfx/texture.hpp>
+#include <mbgl/renderer/dynamic_image_atlas.hpp>
 #include <mbgl/renderer/image_manager.hpp>
+#include <mbgl/text/dynamic_glyph_atlas.hpp>
 #include <mbgl/text/glyph_manager.hpp>
 #include <mbgl/tile/tile.hpp>
 #include <mbgl/tile/geometry_tile_worker.hpp>
 #include <mbgl/util/feature.hpp>
 #include <mbgl/util/optional.hpp>
+#include <mbgl/util/string_indexer.hpp>
 
 #include <atomic>
 #include <memory>
@@ -21,7 +24,6 @@ class GeometryTileData;
 class RenderLayer;
 class SourceQueryOptions;
 class TileParameters;
-class GlyphAtlas;
 class ImageAtlas;
 class TileAtlasTextures;
 
@@ -42,6 +44,8 @@ public:
     std::unique_ptr<TileRenderData> createRenderData() override;
     void setLayers(const std::vector<Immutable<style::LayerProperties>>&) override;
     void setShowCollisionBoxes(bool showCollisionBoxes) override;
+    // Parses the tiles required for rendering ahead of the optional (e.g. prefetched) ones.
+    void setNecessity(TileNecessity) override;
 
     void onGlyphsAvailable(GlyphMap) override;
     void onImagesAvailable(ImageMap, ImageMap, ImageVersionMap versionMap, uint64_t imageCorrelationID) override;
@@ -67,23 +71,31 @@ public:
 
     class LayoutResult {
     public:
-        std::unordered_map<std::string, LayerRenderData> layerRenderData;
+        std::unordered_map<StringIdentity, LayerRenderData> layerRenderData;
         std::shared_ptr<FeatureIndex> featureIndex;
-        optional<AlphaImage> glyphAtlasImage;
+        // Keeps the glyphs used by the buckets in the shared glyph atlas.
+        std::shared_ptr<const DynamicGlyphAtlas::Reservation> glyphs;
+        // Keeps the icons and patterns used by the buckets in the shared image atlas.
+        std::shared_ptr<const DynamicImageAtlas::Reservation> images;
         ImageAtlas iconAtlas;
 
         LayerRenderData* getLayerRenderData(const style::Layer::Impl&);
 
-        LayoutResult(std::unordered_map<std::string, LayerRenderData> renderData_,
-                     std::unique_ptr<FeatureIndex> featureIndex_,
-                     optional<AlphaImage> glyphAtlasImage_,
+        LayoutResult(std::unordered_map<StringIdentity, LayerRenderData> renderData_,
+                     std::shared_ptr<FeatureIndex> featureIndex_,
+                     std::shared_ptr<const DynamicGlyphAtlas::Reservation> glyphs_,
+                     std::shared_ptr<const DynamicImageAtlas::Reservation> images_,
                      ImageAtlas iconAtlas_)
             : layerRenderData(std::move(renderData_)),
               featureIndex(std::move(featureIndex_)),
-              glyphAtlasImage(std::move(glyphAtlasImage_)),
+              glyphs(std::move(glyphs_)),
+              images(std::move(images_)),
               iconAtlas(std::move(iconAtlas_)) {}
     };
     void onLayout(std::shared_ptr<LayoutResult>, uint64_t correlationID);
+    // Receives a result that lacks the layers waiting for glyphs or images. It makes the
+    // tile renderable, but keeps it pending until the complete result arrives.
+    void onPartialLayout(std::shared_ptr<LayoutResult>, uint64_t correlationID);
 
     void onError(std::exception_ptr, uint64_t correlationID);
 
@@ -96,6 +108,7 @@ public:
     const std::string sourceID;
 
     void setFeatureState(const LayerFeatureStates&) override;
+    std::size_t getMemoryUsage() const override;
 
 protected:
     const GeometryTileData* getData() const;
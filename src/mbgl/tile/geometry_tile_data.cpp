@@ -52,17 +52,20 @@ GeometryCollection fixupPolygons(const GeometryCollection& rings) {
     return toGeometryCollection(std::move(multipolygon));
 }
 
-std::vector<GeometryCollection> classifyRings(const GeometryCollection& rings) {
-    std::vector<GeometryCollection> polygons;
+std::vector<GeometryPolygon> classifyRings(const GeometryCollection& rings) {
+    std::vector<GeometryPolygon> polygons;
 
     std::size_t len = rings.size();
 
     if (len <= 1) {
-        polygons.emplace_back(rings.clone());
+        polygons.emplace_back();
+        if (len == 1) {
+            polygons.back().push_back(rings[0]);
+        }
         return polygons;
     }
 
-    GeometryCollection polygon;
+    GeometryPolygon polygon;
     int8_t ccw = 0;
 
     for (const auto& ring : rings) {
@@ -75,10 +78,10 @@ std::vector<GeometryCollection> classifyRings(const GeometryCollection& rings) {
 
         if (ccw == (area < 0 ? -1 : 1) && !polygon.empty()) {
             polygons.emplace_back(std::move(polygon));
-            polygon = GeometryCollection();
+            polygon = GeometryPolygon();
         }
 
-        polygon.emplace_back(ring);
+        polygon.push_back(ring);
     }
 
     if (!polygon.empty()) {
@@ -88,18 +91,27 @@ std::vector<GeometryCollection> classifyRings(const GeometryCollection& rings) {
     return polygons;
 }
 
-void limitHoles(GeometryCollection& polygon, uint32_t maxHoles) {
-    if (polygon.size() > 1 + maxHoles) {
-        std::nth_element(polygon.begin() + 1,
-                         polygon.begin() + 1 + maxHoles,
-                         polygon.end(),
-                         [] (const auto& a, const auto& b) {
-                             return std::fabs(signedArea(a)) > std::fabs(signedArea(b));
+template <class Rings, class Area>
+static void limitHoles(Rings& rings, uint32_t maxHoles, Area area) {
+    if (rings.size() > 1 + maxHoles) {
+        std::nth_element(rings.begin() + 1,
+                         rings.begin() + 1 + maxHoles,
+                         rings.end(),
+                         [&] (const auto& a, const auto& b) {
+                             return std::fabs(area(a)) > std::fabs(area(b));
                          });
-        polygon.resize(1 + maxHoles);
+        rings.resize(1 + maxHoles);
     }
 }
 
+void limitHoles(GeometryCollection& polygon, uint32_t maxHoles) {
+    limitHoles(polygon, maxHoles, [] (const GeometryCoordinates& ring) { return signedArea(ring); });
+}
+
+void limitHoles(GeometryPolygon& polygon, uint32_t maxHoles) {
+    limitHoles(polygon.rings, maxHoles, [] (const GeometryCoordinates* ring) { return signedArea(*ring); });
+}
+
 Feature::geometry_type convertGeometry(const GeometryTileFeature& geometryTileFeature, const CanonicalTileID& tileID) {
     const double size = util::EXTENT * std::pow(2, tileID.z);
     const double x0 = util::EXTENT * static_cast<double>(tileID.x);
@@ -272,4 +284,11 @@ const GeometryCollection& GeometryTileFeature::getGeometries() const {
     return dummy;
 }
 
+void GeometryTileLayer::forEachFeature(const FeatureVisitor& visitor) const {
+    const std::size_t count = featureCount();
+    for (std::size_t i = 0; i < count; ++i) {
+        visitor(i, *getFeature(i));
+    }
+}
+
 } // namespace mbgl
@@ -5,6 +5,8 @@
 #include <mbgl/util/optional.hpp>
 
 #include <cstdint>
+#include <functional>
+#include <iterator>
 #include <string>
 #include <vector>
 #include <memory>
@@ -63,6 +65,13 @@ public:
     // object may *not* outlive the layer object.
     virtual std::unique_ptr<GeometryTileFeature> getFeature(std::size_t) const = 0;
 
+    // Calls the given function with the position and a view of each feature within the layer.
+    // The feature reference is only valid for the duration of the call, which lets implementations
+    // read features in place instead of allocating one object per feature. Use getFeature() to
+    // obtain a feature that needs to be retained.
+    using FeatureVisitor = std::function<void(std::size_t, const GeometryTileFeature&)>;
+    virtual void forEachFeature(const FeatureVisitor&) const;
+
     virtual std::string getName() const = 0;
 };
 
@@ -76,11 +85,57 @@ public:
     virtual std::unique_ptr<GeometryTileLayer> getLayer(const std::string&) const = 0;
 };
 
+// A polygon made of rings of another geometry, which it refers to instead of copying them. The
+// geometry must outlive the polygon.
+class GeometryPolygon {
+    using Rings = std::vector<const GeometryCoordinates*>;
+
+public:
+    using value_type = GeometryCoordinates;
+
+    class const_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = GeometryCoordinates;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const GeometryCoordinates*;
+        using reference = const GeometryCoordinates&;
+
+        explicit const_iterator(Rings::const_iterator it_) : it(it_) {}
+
+        reference operator*() const { return **it; }
+        pointer operator->() const { return *it; }
+        const_iterator& operator++() { ++it; return *this; }
+        bool operator==(const const_iterator& other) const { return it == other.it; }
+        bool operator!=(const const_iterator& other) const { return it != other.it; }
+
+    private:
+        Rings::const_iterator it;
+    };
+
+    void push_back(const GeometryCoordinates& ring) { rings.push_back(&ring); }
+
+    bool empty() const { return rings.empty(); }
+    std::size_t size() const { return rings.size(); }
+    const GeometryCoordinates& operator[](std::size_t i) const { return *rings[i]; }
+
+    const_iterator begin() const { return const_iterator(rings.begin()); }
+    const_iterator end() const { return const_iterator(rings.end()); }
+
+private:
+    friend void limitHoles(GeometryPolygon&, uint32_t);
+
+    Rings rings;
+};
+
 // classifies an array of rings into polygons with outer rings and holes
-std::vector<GeometryCollection> classifyRings(const GeometryCollection&);
+std::vector<GeometryPolygon> classifyRings(const GeometryCollection&);
+// The polygons refer to the rings, which a temporary wouldn't keep around.
+std::vector<GeometryPolygon> classifyRings(GeometryCollection&&) = delete;
 
 // Truncate polygon to the largest `maxHoles` inner rings by area.
 void limitHoles(GeometryCollection&, uint32_t maxHoles);
+void limitHoles(GeometryPolygon&, uint32_t maxHoles);
 
 Feature::geometry_type convertGeometry(const GeometryTileFeature& geometryTileFeature, const CanonicalTileID& tileID);
 
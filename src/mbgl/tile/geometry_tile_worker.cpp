@@ -6,9 +6,11 @@
 #include <mbgl/layout/symbol_layout.hpp>
 #include <mbgl/layout/pattern_layout.hpp>
 #include <mbgl/renderer/bucket_parameters.hpp>
+#include <mbgl/renderer/dynamic_image_atlas.hpp>
 #include <mbgl/renderer/group_by_layout.hpp>
 #include <mbgl/style/filter.hpp>
 #include <mbgl/style/layers/symbol_layer_impl.hpp>
+#include <mbgl/text/dynamic_glyph_atlas.hpp>
 #include <mbgl/renderer/layers/render_fill_layer.hpp>
 #include <mbgl/renderer/layers/render_fill_extrusion_layer.hpp>
 #include <mbgl/renderer/layers/render_line_layer.hpp>
@@ -18,8 +20,12 @@
 #include <mbgl/util/constants.hpp>
 #include <mbgl/util/string.hpp>
 #include <mbgl/util/exception.hpp>
+#include <mbgl/util/parallel_for.hpp>
+#include <mbgl/util/phase.hpp>
 #include <mbgl/util/stopwatch.hpp>
+#include <mbgl/util/tile_trace.hpp>
 
+#include <algorithm>
 #include <unordered_set>
 #include <utility>
 
@@ -27,6 +33,53 @@ namespace mbgl {
 
 using namespace style;
 
+namespace {
+
+// Builds the bucket for a layout group that needs no intermediate Layout step.
+struct BucketTask {
+    BucketTask(BucketParameters parameters_,
+               const std::vector<Immutable<LayerProperties>>& group_,
+               std::unique_ptr<GeometryTileLayer> geometryLayer_)
+        : parameters(std::move(parameters_)), group(group_), geometryLayer(std::move(geometryLayer_)) {}
+
+    void run(const std::atomic<bool>& obsolete) {
+        const style::Layer::Impl& leaderImpl = *(group.at(0)->baseImpl);
+        const Filter& filter = leaderImpl.filter;
+        const OverscaledTileID& id = parameters.tileID;
+        bucket = LayerManager::get()->createBucket(parameters, group);
+
+        // Filter features in place and only materialize the ones that end up in the bucket.
+        geometryLayer->forEachFeature([&](std::size_t i, const GeometryTileFeature& view) {
+            if (obsolete ||
+                !filter(expression::EvaluationContext(static_cast<float>(id.overscaledZ), &view)
+                            .withCanonicalTileID(&id.canonical)))
+                return;
+
+            std::unique_ptr<GeometryTileFeature> feature = geometryLayer->getFeature(i);
+            bucket->addFeature(*feature, feature->getGeometries(), {}, PatternLayerMap(), i, id.canonical);
+            features.emplace_back(i, std::move(feature));
+        });
+    }
+
+    const BucketParameters parameters;
+    const std::vector<Immutable<LayerProperties>>& group;
+    std::unique_ptr<GeometryTileLayer> geometryLayer;
+
+    std::shared_ptr<Bucket> bucket;
+    // The features added to the bucket, to be inserted into the feature index once all the
+    // tasks are done: FeatureIndex is not thread-safe and its insertion order matters.
+    std::vector<std::pair<std::size_t, std::unique_ptr<GeometryTileFeature>>> features;
+};
+
+void runBucketTasks(std::vector<BucketTask>& tasks, const std::atomic<bool>& obsolete) {
+    // The helpers get the priority of the worker's tile, so that prefetched tiles don't hold up visible ones.
+    util::parallelFor(tasks.size(), TaskTag::Tile, Scheduler::GetCurrentPriority(), [&](std::size_t index) {
+        if (!obsolete) tasks[index].run(obsolete);
+    });
+}
+
+} // namespace
+
 GeometryTileWorker::GeometryTileWorker(ActorRef<GeometryTileWorker> self_,
                                        ActorRef<GeometryTile> parent_,
                                        OverscaledTileID id_,
@@ -34,7 +87,9 @@ GeometryTileWorker::GeometryTileWorker(ActorRef<GeometryTileWorker> self_,
                                        const std::atomic<bool>& obsolete_,
                                        const MapMode mode_,
                                        const float pixelRatio_,
-                                       const bool showCollisionBoxes_)
+                                       const bool showCollisionBoxes_,
+                                       std::shared_ptr<DynamicGlyphAtlas> glyphAtlas_,
+                                       std::shared_ptr<DynamicImageAtlas> imageAtlas_)
     : self(std::move(self_)),
       parent(std::move(parent_)),
       id(id_),
@@ -42,6 +97,8 @@ GeometryTileWorker::GeometryTileWorker(ActorRef<GeometryTileWorker> self_,
       obsolete(obsolete_),
       mode(mode_),
       pixelRatio(pixelRatio_),
+      glyphAtlas(std::move(glyphAtlas_)),
+      imageAtlas(std::move(imageAtlas_)),
       showCollisionBoxes(showCollisionBoxes_) {}
 
 GeometryTileWorker::~GeometryTileWorker() = default;
@@ -103,7 +160,9 @@ GeometryTileWorker::~GeometryTileWorker() = default;
  
    Although parsing (which populates all non-symbol buckets and requests dependencies
    for symbol buckets) is internally separate from symbol layout, we only return
-   results to the foreground when we have completed both steps. Because we _move_
+   complete results to the foreground when we have completed both steps. Before the
+   first complete result, continuous mode additionally sends the non-symbol buckets
+   as a partial result while the symbol dependencies are pending. Because we _move_
    the result buckets to the foreground, it is necessary to re-generate all buckets from
    scratch for `setShowCollisionBoxes`, even though it only affects symbol layers.
  
@@ -119,8 +178,10 @@ GeometryTileWorker::~GeometryTileWorker() = default;
 void GeometryTileWorker::setData(std::unique_ptr<const GeometryTileData> data_,
                                  std::set<std::string> availableImages_,
                                  uint64_t correlationID_) {
+    util::TileTrace::end(id, "data queued");
     try {
         data = std::move(data_);
+        previousFeatureIndex.reset();
         correlationID = correlationID_;
         availableImages = std::move(availableImages_);
 
@@ -339,16 +400,21 @@ void GeometryTileWorker::parse() {
     }
 
     MBGL_TIMING_START(watch)
+    // Ends before the symbol layout, which has a step of its own.
+    optional<util::TileTrace::Scope> parseTrace;
+    parseTrace.emplace(id, "parse");
+    optional<util::Phase::Scope> parsePhase;
+    parsePhase.emplace("parse");
 
     std::unordered_map<std::string, std::unique_ptr<SymbolLayout>> symbolLayoutMap;
 
     renderData.clear();
     layouts.clear();
-
-    featureIndex = std::make_unique<FeatureIndex>(*data ? (*data)->clone() : nullptr);
+    arena.reset();
 
     GlyphDependencies glyphDependencies;
     ImageDependencies imageDependencies;
+    std::vector<BucketTask> bucketTasks;
 
     // Create render layers and group by layout
     std::unordered_map<std::string, std::vector<Immutable<style::LayerProperties>>> groupMap;
@@ -356,6 +422,25 @@ void GeometryTileWorker::parse() {
         groupMap[layoutKey(*layer->baseImpl)].push_back(std::move(layer));
     }
 
+    // The features each group adds to the feature index only depend on its layout and layers.
+    featureIndexGroups.clear();
+    for (const auto& pair : groupMap) {
+        std::vector<std::string> layerIDs;
+        for (const auto& layer : pair.second) {
+            layerIDs.push_back(layer->baseImpl->id);
+        }
+        featureIndexGroups.emplace_back(pair.first, std::move(layerIDs));
+    }
+    std::sort(featureIndexGroups.begin(), featureIndexGroups.end());
+
+    featureIndexReused = previousFeatureIndex && featureIndexGroups == previousFeatureIndexGroups;
+    if (featureIndexReused) {
+        featureIndex = previousFeatureIndex;
+    } else {
+        featureIndex = std::make_shared<FeatureIndex>(*data ? (*data)->clone() : nullptr);
+    }
+    FeatureIndex* featureIndexToFill = featureIndexReused ? nullptr : featureIndex.get();
+
     for (auto& pair : groupMap) {
         const auto& group = pair.second;
         if (obsolete) {
@@ -379,7 +464,9 @@ void GeometryTileWorker::parse() {
             layerIDs.push_back(layer->baseImpl->id);
         }
 
-        featureIndex->setBucketLayerIDs(leaderImpl.id, layerIDs);
+        if (featureIndexToFill) {
+            featureIndexToFill->setBucketLayerIDs(leaderImpl.id, layerIDs);
+        }
 
         // Symbol layers and layers that support pattern properties have an extra step at layout time to figure out what images/glyphs
         // are needed to render the layer. They use the intermediate Layout data structure to accomplish this,
@@ -387,47 +474,68 @@ void GeometryTileWorker::parse() {
         // the images/glyphs are available to add the features to the buckets.
         if (leaderImpl.getTypeInfo()->layout == LayerTypeInfo::Layout::Required) {
             std::unique_ptr<Layout> layout = LayerManager::get()->createLayout(
-                {parameters, glyphDependencies, imageDependencies, availableImages}, std::move(geometryLayer), group);
+                {parameters, glyphDependencies, imageDependencies, availableImages, &arena},
+                std::move(geometryLayer),
+                group);
             if (layout->hasDependencies()) {
                 layouts.push_back(std::move(layout));
             } else {
-                layout->createBucket({}, featureIndex, renderData, firstLoad, showCollisionBoxes, id.canonical);
+                layout->createBucket(
+                    {}, featureIndexToFill, renderData, firstLoad, showCollisionBoxes, id.canonical);
             }
         } else {
-            const Filter& filter = leaderImpl.filter;
-            const std::string& sourceLayerID = leaderImpl.sourceLayer;
-            std::shared_ptr<Bucket> bucket = LayerManager::get()->createBucket(parameters, group);
-
-            for (std::size_t i = 0; !obsolete && i < geometryLayer->featureCount(); i++) {
-                std::unique_ptr<GeometryTileFeature> feature = geometryLayer->getFeature(i);
+            bucketTasks.emplace_back(parameters, group, std::move(geometryLayer));
+        }
+    }
 
-                if (!filter(expression::EvaluationContext(static_cast<float>(this->id.overscaledZ), feature.get())
-                                .withCanonicalTileID(&id.canonical)))
-                    continue;
+    // Buckets of the groups without a Layout step are independent of each other and
+    // are built in parallel.
+    runBucketTasks(bucketTasks, obsolete);
+    if (obsolete) {
+        return;
+    }
 
-                const GeometryCollection& geometries = feature->getGeometries();
-                bucket->addFeature(*feature, geometries, {}, PatternLayerMap(), i, id.canonical);
-                featureIndex->insert(geometries, i, sourceLayerID, leaderImpl.id);
+    for (auto& task : bucketTasks) {
+        const style::Layer::Impl& leaderImpl = *(task.group.at(0)->baseImpl);
+        if (featureIndexToFill) {
+            for (const auto& feature : task.features) {
+                featureIndexToFill->insert(
+                    feature.second->getGeometries(), feature.first, leaderImpl.sourceLayer, leaderImpl.id);
             }
+        }
 
-            if (!bucket->hasData()) {
-                continue;
-            }
+        if (!task.bucket->hasData()) {
+            continue;
+        }
 
-            for (const auto& layer : group) {
-                renderData.emplace(layer->baseImpl->id, LayerRenderData{bucket, layer});
-            }
+        for (const auto& layer : task.group) {
+            renderData.emplace(layer->baseImpl->internedID, LayerRenderData{task.bucket, layer});
         }
     }
 
     requestNewGlyphs(glyphDependencies);
     requestNewImages(imageDependencies);
+    if (!tracingDependencies && hasPendingDependencies()) {
+        tracingDependencies = true;
+        util::TileTrace::begin(id, "glyphs and images");
+    }
+
+    // Until the tile is laid out for the first time, ship the buckets that do not depend on
+    // glyphs or images right away, so that the tile geometry can be rendered while the
+    // symbol dependencies are still loading.
+    if (firstLoad && mode == MapMode::Continuous && !renderData.empty() && hasPendingDependencies()) {
+        parent.invoke(&GeometryTile::onPartialLayout,
+                      std::make_shared<GeometryTile::LayoutResult>(renderData, nullptr, nullptr, nullptr, ImageAtlas()),
+                      correlationID);
+    }
 
     MBGL_TIMING_FINISH(watch,
                        " Action: " << "Parsing," <<
                        " SourceID: " << sourceID.c_str() <<
                        " Canonical: " << static_cast<int>(id.canonical.z) << "/" << id.canonical.x << "/" << id.canonical.y <<
                        " Time");
+    parseTrace = nullopt;
+    parsePhase = nullopt;
     finalizeLayout();
 }
 
@@ -448,32 +556,45 @@ void GeometryTileWorker::finalizeLayout() {
     if (!data || !layers || !hasPendingParseResult() || hasPendingDependencies()) {
         return;
     }
+    if (tracingDependencies) {
+        tracingDependencies = false;
+        util::TileTrace::end(id, "glyphs and images");
+    }
     
     MBGL_TIMING_START(watch)
-    optional<AlphaImage> glyphAtlasImage;
-    ImageAtlas iconAtlas = makeImageAtlas(imageMap, patternMap, versionMap);
+    util::TileTrace::Scope trace(id, "symbol layout");
+    const util::Phase::Scope phase("layout");
+    std::shared_ptr<const DynamicGlyphAtlas::Reservation> glyphs;
+    ImageAtlas iconAtlas;
+    auto images = imageAtlas->addImages(imageMap, patternMap, versionMap, iconAtlas);
     if (!layouts.empty()) {
-        GlyphAtlas glyphAtlas = makeGlyphAtlas(glyphMap);
-        glyphAtlasImage = std::move(glyphAtlas.image);
+        GlyphPositions glyphPositions;
+        glyphs = glyphAtlas->addGlyphs(glyphMap, glyphPositions);
 
         for (auto& layout : layouts) {
             if (obsolete) {
                 return;
             }
 
-            layout->prepareSymbols(glyphMap, glyphAtlas.positions, imageMap, iconAtlas.iconPositions);
+            layout->prepareSymbols(glyphMap, glyphPositions, imageMap, iconAtlas.iconPositions);
 
             if (!layout->hasSymbolInstances()) {
                 continue;
             }
 
             // layout adds the bucket to buckets
-            layout->createBucket(
-                iconAtlas.patternPositions, featureIndex, renderData, firstLoad, showCollisionBoxes, id.canonical);
+            layout->createBucket(iconAtlas.patternPositions,
+                                 featureIndexReused ? nullptr : featureIndex.get(),
+                                 renderData,
+                                 firstLoad,
+                                 showCollisionBoxes,
+                                 id.canonical);
         }
     }
 
     layouts.clear();
+    // Workers of idle tiles don't hold on to the memory of their last parse.
+    arena.release();
 
     firstLoad = false;
     
@@ -483,10 +604,15 @@ void GeometryTileWorker::finalizeLayout() {
                        " Canonical: " << static_cast<int>(id.canonical.z) << "/" << id.canonical.x << "/" << id.canonical.y <<
                        " Time");
 
+    previousFeatureIndex = featureIndex;
+    previousFeatureIndexGroups = featureIndexGroups;
+
+    util::TileTrace::begin(id, "result queued");
     parent.invoke(&GeometryTile::onLayout, std::make_shared<GeometryTile::LayoutResult>(
         std::move(renderData),
         std::move(featureIndex),
-        std::move(glyphAtlasImage),
+        std::move(glyphs),
+        std::move(images),
         std::move(iconAtlas)
     ), correlationID);
 }
@@ -12,12 +12,16 @@
 #include <mbgl/renderer/bucket.hpp>
 #include <mbgl/renderer/render_layer.hpp>
 #include <mbgl/tile/tile.hpp>
+#include <mbgl/util/arena.hpp>
+#include <mbgl/util/string_indexer.hpp>
 
 #include <atomic>
 #include <memory>
 
 namespace mbgl {
 
+class DynamicGlyphAtlas;
+class DynamicImageAtlas;
 class GeometryTile;
 class GeometryTileData;
 class Layout;
@@ -35,7 +39,9 @@ public:
                        const std::atomic<bool>&,
                        MapMode,
                        float pixelRatio,
-                       bool showCollisionBoxes_);
+                       bool showCollisionBoxes_,
+                       std::shared_ptr<DynamicGlyphAtlas>,
+                       std::shared_ptr<DynamicImageAtlas>);
     ~GeometryTileWorker();
 
     void setLayers(std::vector<Immutable<style::LayerProperties>>,
@@ -77,9 +83,19 @@ private:
     const std::atomic<bool>& obsolete;
     const MapMode mode;
     const float pixelRatio;
+    const std::shared_ptr<DynamicGlyphAtlas> glyphAtlas;
+    const std::shared_ptr<DynamicImageAtlas> imageAtlas;
     
-    std::unique_ptr<FeatureIndex> featureIndex;
-    std::unordered_map<std::string, LayerRenderData> renderData;
+    std::shared_ptr<FeatureIndex> featureIndex;
+    // The feature index of the last layout, and the layer groups it was built for. Parsing the
+    // same data with the same groups again, e.g. after a paint or image change, reuses it instead
+    // of inserting every feature again.
+    using FeatureIndexGroups = std::vector<std::pair<std::string, std::vector<std::string>>>;
+    std::shared_ptr<FeatureIndex> previousFeatureIndex;
+    FeatureIndexGroups previousFeatureIndexGroups;
+    FeatureIndexGroups featureIndexGroups;
+    bool featureIndexReused = false;
+    std::unordered_map<StringIdentity, LayerRenderData> renderData;
 
     enum State {
         Idle,
@@ -96,6 +112,9 @@ private:
     optional<std::vector<Immutable<style::LayerProperties>>> layers;
     optional<std::unique_ptr<const GeometryTileData>> data;
 
+    // Per-parse memory for the layouts, released once they are done. The layouts must be
+    // declared after it so that they are destroyed first.
+    util::Arena arena;
     std::vector<std::unique_ptr<Layout>> layouts;
 
     GlyphDependencies pendingGlyphDependencies;
@@ -108,6 +127,8 @@ private:
 
     bool showCollisionBoxes;
     bool firstLoad = true;
+    // Whether the wait for glyphs and images of the current parse result is being traced.
+    bool tracingDependencies = false;
 };
 
 } // namespace mbgl
@@ -22,6 +22,7 @@ RasterDEMTile::RasterDEMTile(const OverscaledTileID& id_,
       mailbox(std::make_shared<Mailbox>(*Scheduler::GetCurrent())),
       worker(Scheduler::GetBackground(),
              ActorRef<RasterDEMTile>(*this, mailbox)) {
+    worker.setTag(TaskTag::Tile);
 
     encoding = tileset.encoding;
     if ( id.canonical.y == 0 ){
@@ -106,9 +107,8 @@ void RasterDEMTile::backfillBorder(const RasterDEMTile& borderTile, const DEMTil
         tileDEM.backfillBorder(borderDEM, dx, dy);
         // update the bitmask to indicate that this tiles have been backfilled by flipping the relevant bit
         this->neighboringTiles = this->neighboringTiles | mask;
-        // mark HillshadeBucket.prepared as false so it runs through the prepare render pass
-        // with the new texture data we just backfilled
-        bucket->setPrepared(false);
+        // upload the border we just backfilled, and run the DEM through the prepare render pass again
+        bucket->setDEMBorderChanged(dx, dy);
     }
 }
 
@@ -118,8 +118,20 @@ void RasterDEMTile::setMask(TileMask&& mask) {
     }
 }
 
+std::size_t RasterDEMTile::getMemoryUsage() const {
+    return bucket ? bucket->getMemoryUsage() : 0u;
+}
+
 void RasterDEMTile::setNecessity(TileNecessity necessity) {
     loader.setNecessity(necessity);
 }
 
+void RasterDEMTile::setRequestOrder(uint32_t order) {
+    loader.setRequestOrder(order);
+}
+
+void RasterDEMTile::setRequestPriority(Resource::Priority priority) {
+    loader.setRequestPriority(priority);
+}
+
 } // namespace mbgl
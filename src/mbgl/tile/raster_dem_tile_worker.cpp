@@ -2,6 +2,7 @@
 #include <mbgl/tile/raster_dem_tile.hpp>
 #include <mbgl/renderer/buckets/hillshade_bucket.hpp>
 #include <mbgl/actor/actor.hpp>
+#include <mbgl/util/image_buffer_pool.hpp>
 #include <mbgl/util/premultiply.hpp>
 
 namespace mbgl {
@@ -18,7 +19,13 @@ void RasterDEMTileWorker::parse(const std::shared_ptr<const std::string>& data,
     }
 
     try {
-        auto bucket = std::make_unique<HillshadeBucket>(decodeImage(*data), encoding);
+        // The DEM data copies the elevations into an image with a border, the decoded image isn't
+        // needed afterwards.
+        auto& pool = util::rasterImageBufferPool();
+        PremultipliedImage image = decodeImage(*data, pool);
+        DEMData demData(image, encoding);
+        pool.release(std::move(image));
+        auto bucket = std::make_unique<HillshadeBucket>(std::move(demData));
         parent.invoke(&RasterDEMTile::onParsed, std::move(bucket), correlationID);
     } catch (...) {
         parent.invoke(&RasterDEMTile::onError, std::current_exception(), correlationID);
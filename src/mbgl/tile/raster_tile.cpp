@@ -22,6 +22,7 @@ RasterTile::RasterTile(const OverscaledTileID& id_,
       mailbox(std::make_shared<Mailbox>(*Scheduler::GetCurrent())),
       worker(Scheduler::GetBackground(),
              ActorRef<RasterTile>(*this, mailbox)) {
+    worker.setTag(TaskTag::Tile);
 }
 
 RasterTile::~RasterTile() = default;
@@ -74,8 +75,20 @@ void RasterTile::setMask(TileMask&& mask) {
     }
 }
 
+std::size_t RasterTile::getMemoryUsage() const {
+    return bucket ? bucket->getMemoryUsage() : 0u;
+}
+
 void RasterTile::setNecessity(TileNecessity necessity) {
     loader.setNecessity(necessity);
 }
 
+void RasterTile::setRequestOrder(uint32_t order) {
+    loader.setRequestOrder(order);
+}
+
+void RasterTile::setRequestPriority(Resource::Priority priority) {
+    loader.setRequestPriority(priority);
+}
+
 } // namespace mbgl
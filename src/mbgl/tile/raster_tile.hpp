@@ -24,6 +24,8 @@ public:
 
     std::unique_ptr<TileRenderData> createRenderData() override;
     void setNecessity(TileNecessity) final;
+    void setRequestOrder(uint32_t) final;
+    void setRequestPriority(Resource::Priority) final;
 
     void setError(std::exception_ptr);
     void setMetadata(optional<Timestamp> modified, optional<Timestamp> expires);
@@ -32,6 +34,7 @@ public:
     bool layerPropertiesUpdated(const Immutable<style::LayerProperties>& layerProperties) override;
 
     void setMask(TileMask&&) override;
+    std::size_t getMemoryUsage() const override;
 
     void onParsed(std::unique_ptr<RasterBucket> result, uint64_t correlationID);
     void onError(std::exception_ptr, uint64_t correlationID);
@@ -2,6 +2,9 @@
 #include <mbgl/tile/raster_tile.hpp>
 #include <mbgl/renderer/buckets/raster_bucket.hpp>
 #include <mbgl/actor/actor.hpp>
+#include <mbgl/platform/settings.hpp>
+#include <mbgl/util/etc1.hpp>
+#include <mbgl/util/image_buffer_pool.hpp>
 #include <mbgl/util/premultiply.hpp>
 
 namespace mbgl {
@@ -16,7 +19,23 @@ void RasterTileWorker::parse(const std::shared_ptr<const std::string>& data, uin
     }
 
     try {
-        auto bucket = std::make_unique<RasterBucket>(decodeImage(*data));
+        auto& pool = util::rasterImageBufferPool();
+        PremultipliedImage image = decodeImage(*data, pool);
+        auto value = platform::Settings::getInstance().get(platform::EXPERIMENTAL_COMPRESSED_RASTER_TILES);
+        const bool* compress = value.getBool();
+        if (compress && *compress) {
+            std::vector<uint8_t> compressed = util::encodeETC1(image);
+            if (!compressed.empty()) {
+                const Size size = image.size;
+                pool.release(std::move(image));
+                parent.invoke(&RasterTile::onParsed,
+                              std::make_unique<RasterBucket>(size, std::move(compressed)),
+                              correlationID);
+                return;
+            }
+        }
+        auto bucket = std::make_unique<RasterBucket>(std::move(image));
+        bucket->imagePool = &pool;
         parent.invoke(&RasterTile::onParsed, std::move(bucket), correlationID);
     } catch (...) {
         parent.invoke(&RasterTile::onError, std::current_exception(), correlationID);
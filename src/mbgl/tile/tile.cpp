@@ -1,8 +1,15 @@
 #include <mbgl/tile/tile.hpp>
 #include <mbgl/tile/tile_observer.hpp>
 #include <mbgl/renderer/query.hpp>
+#include <mbgl/util/constants.hpp>
 #include <mbgl/util/string.hpp>
 #include <mbgl/util/logging.hpp>
+#include <mbgl/util/projection.hpp>
+
+#include <mapbox/geometry/box.hpp>
+
+#include <algorithm>
+#include <cmath>
 
 namespace mbgl {
 
@@ -50,4 +57,50 @@ void Tile::querySourceFeatures(
         std::vector<Feature>&,
         const SourceQueryOptions&) {}
 
+void Tile::querySourceLayerFeatures(std::vector<Feature>& result,
+                                    const GeometryTileLayer& layer,
+                                    const SourceQueryOptions& options) const {
+    // The query bounds in tile coordinates, unless they contain the whole tile.
+    optional<mapbox::geometry::box<double>> box;
+    if (options.bounds && !options.bounds->contains(id.canonical)) {
+        const double scale = std::pow(2.0, id.canonical.z) * util::EXTENT / util::tileSize;
+        const Point<double> origin(id.canonical.x * util::EXTENT, id.canonical.y * util::EXTENT);
+        box = mapbox::geometry::box<double>(Projection::project(options.bounds->northwest(), scale) - origin,
+                                            Projection::project(options.bounds->southeast(), scale) - origin);
+    }
+
+    const auto featureCount = layer.featureCount();
+    for (std::size_t i = 0; i < featureCount; i++) {
+        auto feature = layer.getFeature(i);
+
+        // Apply filter, if any
+        if (options.filter && !(*options.filter)(style::expression::EvaluationContext { static_cast<float>(id.overscaledZ), feature.get() })) {
+            continue;
+        }
+
+        if (box) {
+            bool intersects = false;
+            for (const auto& ring : feature->getGeometries()) {
+                mapbox::geometry::box<double> envelope({INFINITY, INFINITY}, {-INFINITY, -INFINITY});
+                for (const auto& point : ring) {
+                    envelope.min.x = std::min<double>(envelope.min.x, point.x);
+                    envelope.min.y = std::min<double>(envelope.min.y, point.y);
+                    envelope.max.x = std::max<double>(envelope.max.x, point.x);
+                    envelope.max.y = std::max<double>(envelope.max.y, point.y);
+                }
+                if (envelope.min.x <= box->max.x && envelope.max.x >= box->min.x && envelope.min.y <= box->max.y &&
+                    envelope.max.y >= box->min.y) {
+                    intersects = true;
+                    break;
+                }
+            }
+            if (!intersects) {
+                continue;
+            }
+        }
+
+        result.push_back(convertFeature(*feature, id.canonical));
+    }
+}
+
 } // namespace mbgl
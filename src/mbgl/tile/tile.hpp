@@ -53,6 +53,12 @@ public:
 
     virtual void setNecessity(TileNecessity) {}
 
+    // Orders the queued network requests of this tile among those of the other tiles, lower first.
+    virtual void setRequestOrder(uint32_t) {}
+
+    // Sets the priority of the network requests that this tile makes from now on.
+    virtual void setRequestPriority(Resource::Priority) {}
+
     // Mark this tile as no longer needed and cancel any pending work.
     virtual void cancel();
 
@@ -95,6 +101,19 @@ public:
         return renderable;
     }
 
+    // Whether the tile is rendered in the current frame if it is needed. Renderable tiles that
+    // haven't been rendered before wait for a later frame when their data would exceed the upload
+    // budget of this one.
+    bool isReadyToRender() const {
+        return renderable && !uploadDeferred;
+    }
+
+    // Partial tiles render without their symbols, which still wait for glyphs or images. A
+    // parent tile renders along with them until then, so that its labels stay on the map.
+    bool isPartial() const {
+        return renderable && partial;
+    }
+
     // A tile is "Loaded" when we have received a response from a FileSource, and have attempted to
     // parse the tile (if applicable). Tile implementations should set this to true when a load
     // error occurred, or after the tile was parsed successfully.
@@ -127,6 +146,9 @@ public:
 
     virtual void setFeatureState(const LayerFeatureStates&) {}
 
+    // Returns the approximate number of bytes used by the tile's buckets and textures.
+    virtual std::size_t getMemoryUsage() const { return 0u; }
+
     void dumpDebugLogs() const;
 
     const Kind kind;
@@ -136,11 +158,21 @@ public:
     // Indicates whether this tile is used for the currently visible layers on the map.
     // Re-initialized at every source update.
     bool usedByRenderedLayers = false;
+    // Set once the tile is rendered, after which its data doesn't count against upload budgets.
+    bool wasRendered = false;
+    // Set by the tile pyramid for the current frame, see isReadyToRender().
+    bool uploadDeferred = false;
 
 protected:
+    // Adds the features of a source layer of this tile that match the query options.
+    void querySourceLayerFeatures(std::vector<Feature>& result,
+                                  const GeometryTileLayer&,
+                                  const SourceQueryOptions&) const;
+
     bool triedOptional = false;
     bool renderable = false;
     bool pending = false;
+    bool partial = false;
     bool loaded = false;
 
 
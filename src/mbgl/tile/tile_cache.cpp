@@ -5,42 +5,53 @@ namespace mbgl {
 
 void TileCache::setSize(size_t size_) {
     size = size_;
-
-    while (orderedKeys.size() > size) {
-        auto key = orderedKeys.front();
-        orderedKeys.remove(key);
-        tiles.erase(key);
-    }
-
+    evict();
     assert(orderedKeys.size() <= size);
 }
 
+void TileCache::setMaxBytes(optional<size_t> maxBytes_) {
+    maxBytes = std::move(maxBytes_);
+    evict();
+}
+
 void TileCache::add(const OverscaledTileID& key, std::unique_ptr<Tile> tile) {
     if (!tile->isRenderable() || !size) {
         return;
     }
 
-    // insert new or query existing tile
-    if (!tiles.emplace(key, std::move(tile)).second) {
-        // remove existing tile key
-        orderedKeys.remove(key);
+    auto it = tiles.find(key);
+    if (it != tiles.end()) {
+        // keep the existing tile, but mark it as newest
+        orderedKeys.splice(orderedKeys.end(), orderedKeys, it->second.position);
+    } else {
+        const size_t tileBytes = tile->getMemoryUsage();
+        orderedKeys.push_back(key);
+        tiles.emplace(key, Entry{std::move(tile), std::prev(orderedKeys.end()), tileBytes, false});
+        bytes += tileBytes;
     }
 
-    // (re-)insert tile key as newest
-    orderedKeys.push_back(key);
+    // purge oldest keys/tiles if necessary
+    evict();
+
+    assert(orderedKeys.size() <= size);
+}
 
-    // purge oldest key/tile if necessary
-    if (orderedKeys.size() > size) {
+void TileCache::evict() {
+    while (!orderedKeys.empty() && (orderedKeys.size() > size || (maxBytes && bytes > *maxBytes))) {
         pop(orderedKeys.front());
     }
+}
 
-    assert(orderedKeys.size() <= size);
+void TileCache::trim(size_t maxBytes_) {
+    while (!orderedKeys.empty() && bytes > maxBytes_) {
+        pop(orderedKeys.front());
+    }
 }
 
 Tile* TileCache::get(const OverscaledTileID& key) {
     auto it = tiles.find(key);
     if (it != tiles.end()) {
-        return it->second.get();
+        return it->second.tile.get();
     } else {
         return nullptr;
     }
@@ -52,9 +63,11 @@ std::unique_ptr<Tile> TileCache::pop(const OverscaledTileID& key) {
 
     auto it = tiles.find(key);
     if (it != tiles.end()) {
-        tile = std::move(it->second);
+        tile = std::move(it->second.tile);
+        assert(bytes >= it->second.bytes);
+        bytes -= it->second.bytes;
+        orderedKeys.erase(it->second.position);
         tiles.erase(it);
-        orderedKeys.remove(key);
         assert(tile->isRenderable());
     }
 
@@ -65,9 +78,21 @@ bool TileCache::has(const OverscaledTileID& key) {
     return tiles.find(key) != tiles.end();
 }
 
+void TileCache::markStale() {
+    for (auto& entry : tiles) {
+        entry.second.stale = true;
+    }
+}
+
+bool TileCache::isStale(const OverscaledTileID& key) const {
+    auto it = tiles.find(key);
+    return it != tiles.end() && it->second.stale;
+}
+
 void TileCache::clear() {
     orderedKeys.clear();
     tiles.clear();
+    bytes = 0;
 }
 
 } // namespace mbgl
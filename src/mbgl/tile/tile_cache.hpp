@@ -2,11 +2,11 @@
 
 #include <mbgl/tile/tile_id.hpp>
 #include <mbgl/tile/tile.hpp>
-
+#include <mbgl/util/optional.hpp>
 
 #include <list>
 #include <memory>
-#include <map>
+#include <unordered_map>
 
 namespace mbgl {
 
@@ -16,17 +16,40 @@ public:
 
     void setSize(size_t);
     size_t getSize() const { return size; };
+    // Limits the total memory used by the cached tiles, as reported by Tile::getMemoryUsage().
+    void setMaxBytes(optional<size_t>);
+    optional<size_t> getMaxBytes() const { return maxBytes; }
+    size_t getBytes() const { return bytes; }
     void add(const OverscaledTileID& key, std::unique_ptr<Tile> tile);
     std::unique_ptr<Tile> pop(const OverscaledTileID& key);
     Tile* get(const OverscaledTileID& key);
     bool has(const OverscaledTileID& key);
     void clear();
+    // Drops the least recently used tiles until the rest take at most `maxBytes`.
+    void trim(size_t maxBytes);
+
+    // Marks the cached tiles as laid out for outdated layers, so that they get the current ones
+    // when they are taken out of the cache.
+    void markStale();
+    bool isStale(const OverscaledTileID& key) const;
 
 private:
-    std::map<OverscaledTileID, std::unique_ptr<Tile>> tiles;
+    void evict();
+
+    struct Entry {
+        std::unique_ptr<Tile> tile;
+        std::list<OverscaledTileID>::iterator position;
+        size_t bytes;
+        bool stale;
+    };
+
+    std::unordered_map<OverscaledTileID, Entry> tiles;
+    // Oldest key first.
     std::list<OverscaledTileID> orderedKeys;
 
     size_t size;
+    optional<size_t> maxBytes;
+    size_t bytes = 0;
 };
 
 } // namespace mbgl
@@ -22,6 +22,7 @@ size_t hash<mbgl::OverscaledTileID>::operator()(const mbgl::OverscaledTileID& id
     std::size_t seed = 0;
     mbgl::util::hash_combine(seed, std::hash<mbgl::CanonicalTileID>{}(id.canonical));
     mbgl::util::hash_combine(seed, id.overscaledZ);
+    mbgl::util::hash_combine(seed, id.wrap);
     return seed;
 }
 
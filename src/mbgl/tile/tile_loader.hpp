@@ -33,6 +33,12 @@ public:
         }
     }
 
+    void setRequestOrder(uint32_t order) { resource.queueOrder->store(order, std::memory_order_relaxed); }
+
+    void setRequestPriority(Resource::Priority priority) { resource.setPriority(priority); }
+
+    const Resource& getResource() const { return resource; }
+
 private:
     // called when the tile is one of the ideal tiles that we want to show definitely. the tile source
     // should try to make every effort (e.g. fetch from internet, or revalidate existing resources).
@@ -4,9 +4,11 @@
 #include <mbgl/storage/file_source.hpp>
 #include <mbgl/tile/tile_loader.hpp>
 #include <mbgl/util/async_request.hpp>
+#include <mbgl/util/tile_trace.hpp>
 #include <mbgl/util/tileset.hpp>
 
 #include <cassert>
+#include <limits>
 
 namespace mbgl {
 
@@ -31,6 +33,8 @@ TileLoader<T>::TileLoader(T& tile_,
         Resource::LoadingMethod::CacheOnly)),
       fileSource(parameters.fileSource) {
     assert(!request);
+    // Tiles that aren't ranked yet wait for those that are.
+    resource.queueOrder = std::make_shared<std::atomic<uint32_t>>(std::numeric_limits<uint32_t>::max());
     if (!fileSource) {
         tile.setError(getCantLoadTileError());
         return;
@@ -65,7 +69,9 @@ void TileLoader<T>::loadFromCache() {
     }
 
     resource.loadingMethod = Resource::LoadingMethod::CacheOnly;
+    util::TileTrace::begin(tile.id, "cache");
     request = fileSource->request(resource, [this](const Response& res) {
+        util::TileTrace::end(tile.id, "cache");
         request.reset();
 
         tile.setTriedCache();
@@ -103,6 +109,7 @@ void TileLoader<T>::makeOptional() {
         // Abort the current request, but only when we know that we're specifically querying for a
         // network resource only.
         request.reset();
+        util::TileTrace::end(tile.id, "network");
     }
 }
 
@@ -135,7 +142,11 @@ void TileLoader<T>::loadFromNetwork() {
     // Instead of using Resource::LoadingMethod::All, we're first doing a CacheOnly, and then a
     // NetworkOnly request.
     resource.loadingMethod = Resource::LoadingMethod::NetworkOnly;
-    request = fileSource->request(resource, [this](const Response& res) { loadedData(res); });
+    util::TileTrace::begin(tile.id, "network");
+    request = fileSource->request(resource, [this](const Response& res) {
+        util::TileTrace::end(tile.id, "network");
+        loadedData(res);
+    });
 }
 
 } // namespace mbgl
@@ -13,16 +13,34 @@ VectorTile::VectorTile(const OverscaledTileID& id_,
     : GeometryTile(id_, std::move(sourceID_), parameters), loader(*this, id_, parameters, tileset) {}
 
 void VectorTile::setNecessity(TileNecessity necessity) {
+    GeometryTile::setNecessity(necessity);
     loader.setNecessity(necessity);
 }
 
+void VectorTile::setRequestOrder(uint32_t order) {
+    loader.setRequestOrder(order);
+}
+
+void VectorTile::setRequestPriority(Resource::Priority priority) {
+    loader.setRequestPriority(priority);
+}
+
 void VectorTile::setMetadata(optional<Timestamp> modified_, optional<Timestamp> expires_) {
     modified = std::move(modified_);
     expires = std::move(expires_);
 }
 
 void VectorTile::setData(const std::shared_ptr<const std::string>& data_) {
-    GeometryTile::setData(data_ ? std::make_unique<VectorTileData>(data_) : nullptr);
+    // Tiles revisited from the cache are loaded from the network again once their cached response
+    // has expired, and the response often has the same bytes. Layout is deterministic for the
+    // same bytes and layers, so the result of the current layout stands.
+    if (data && data_ && (data == data_ || *data == *data_)) {
+        return;
+    }
+    data = data_;
+
+    // Sources that refer to the same tileset share the raw and parsed data of their tiles.
+    GeometryTile::setData(data_ ? VectorTileData::create(loader.getResource().url, data_) : nullptr);
 }
 
 } // namespace mbgl
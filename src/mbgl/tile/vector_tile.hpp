@@ -16,11 +16,15 @@ public:
                const Tileset&);
 
     void setNecessity(TileNecessity) final;
+    void setRequestOrder(uint32_t) final;
+    void setRequestPriority(Resource::Priority) final;
     void setMetadata(optional<Timestamp> modified, optional<Timestamp> expires);
     void setData(const std::shared_ptr<const std::string>& data);
 
 private:
     TileLoader<VectorTile> loader;
+    // The bytes the tile was last laid out from.
+    std::shared_ptr<const std::string> data;
 };
 
 } // namespace mbgl
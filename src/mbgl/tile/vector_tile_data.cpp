@@ -1,11 +1,111 @@
 #include <mbgl/tile/vector_tile_data.hpp>
 #include <mbgl/util/constants.hpp>
 
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <memory>
+#include <mutex>
+
 namespace mbgl {
 
-VectorTileFeature::VectorTileFeature(const mapbox::vector_tile::layer& layer,
+// The values of the properties of a layer, decoded for all of its features at once. The filters,
+// paint property binders and symbol layouts of the style layers that use the source layer then
+// share them, instead of decoding the values of each feature for each of them. The columns live
+// as long as the layers of a tile parse refer to them.
+//
+// The bucket tasks of a tile read the columns concurrently, so lookups don't lock: keys go into a
+// fixed open-addressing table whose entries are never moved or removed, and columns are published
+// with a single atomic store.
+class VectorTileColumns {
+public:
+    using Column = std::vector<optional<Value>>;
+
+    VectorTileColumns() = default;
+    ~VectorTileColumns() {
+        for (auto& slot : slots) {
+            delete slot.load(std::memory_order_relaxed);
+        }
+    }
+
+    // Returns null until the key has been asked for once per feature of the layer, which is when
+    // a second filter or property reads it. Queries that only read a few features never decode
+    // a whole column. The column is empty if no feature has a value for the key.
+    const Column* get(const mapbox::vector_tile::layer& layer, const std::string& key) {
+        Entry* entry = find(key);
+        if (!entry) {
+            return nullptr;
+        }
+        if (const Column* column = entry->column.load(std::memory_order_acquire)) {
+            return column;
+        }
+        // Only the request that crosses the threshold decodes the column, the others keep reading
+        // their feature until it is published.
+        if (entry->requests.fetch_add(1u, std::memory_order_relaxed) != layer.featureCount()) {
+            return nullptr;
+        }
+        entry->decoded = std::make_unique<const Column>(decode(layer, key));
+        entry->column.store(entry->decoded.get(), std::memory_order_release);
+        return entry->decoded.get();
+    }
+
+private:
+    struct Entry {
+        explicit Entry(std::string key_) : key(std::move(key_)) {}
+        const std::string key;
+        std::atomic<std::size_t> requests{0u};
+        // Written once, by the request that decodes the column, before `column` is set.
+        std::unique_ptr<const Column> decoded;
+        std::atomic<const Column*> column{nullptr};
+    };
+
+    // Style layers read a handful of keys of each source layer, further keys are read per feature.
+    static constexpr std::size_t maxKeys = 64u;
+
+    Entry* find(const std::string& key) {
+        const std::size_t hash = std::hash<std::string>()(key);
+        for (std::size_t probe = 0u; probe < maxKeys; ++probe) {
+            auto& slot = slots[(hash + probe) % maxKeys];
+            Entry* entry = slot.load(std::memory_order_acquire);
+            if (!entry) {
+                auto created = std::make_unique<Entry>(key);
+                if (slot.compare_exchange_strong(entry, created.get(), std::memory_order_acq_rel)) {
+                    return created.release();
+                }
+                // Another thread filled the slot first, `entry` is now its entry.
+            }
+            if (entry->key == key) {
+                return entry;
+            }
+        }
+        return nullptr;
+    }
+
+    static Column decode(const mapbox::vector_tile::layer& layer, const std::string& key) {
+        const std::size_t count = layer.featureCount();
+        Column column;
+        for (std::size_t i = 0; i < count; ++i) {
+            optional<Value> value(mapbox::vector_tile::feature(layer.getFeature(i), layer).getValue(key));
+            if (value->is<NullValue>()) continue;
+            if (column.empty()) column.resize(count);
+            column[i] = std::move(value);
+        }
+        return column;
+    }
+
+    std::array<std::atomic<Entry*>, maxKeys> slots{};
+};
+
+VectorTileFeature::VectorTileFeature(const mapbox::vector_tile::layer& layer_,
                                      const protozero::data_view& view)
-    : feature(view, layer) {
+    : layer(layer_), feature(view, layer) {
+}
+
+VectorTileFeature::VectorTileFeature(const mapbox::vector_tile::layer& layer_,
+                                     const protozero::data_view& view,
+                                     VectorTileColumns& columns_,
+                                     std::size_t index_)
+    : layer(layer_), feature(view, layer), columns(&columns_), index(index_) {
 }
 
 FeatureType VectorTileFeature::getType() const {
@@ -22,6 +122,11 @@ FeatureType VectorTileFeature::getType() const {
 }
 
 optional<Value> VectorTileFeature::getValue(const std::string& key) const {
+    if (columns) {
+        if (const auto* column = columns->get(layer, key)) {
+            return column->empty() ? nullopt : (*column)[index];
+        }
+    }
     const optional<Value> value(feature.getValue(key));
     return value->is<NullValue>() ? nullopt : value;
 }
@@ -53,42 +158,150 @@ VectorTileLayer::VectorTileLayer(std::shared_ptr<const std::string> data_,
     : data(std::move(data_)), layer(view) {
 }
 
+VectorTileLayer::VectorTileLayer(std::shared_ptr<const std::string> data_,
+                                 const protozero::data_view& view,
+                                 std::shared_ptr<VectorTileColumns> columns_)
+    : data(std::move(data_)), layer(view), columns(std::move(columns_)) {
+}
+
 std::size_t VectorTileLayer::featureCount() const {
     return layer.featureCount();
 }
 
 std::unique_ptr<GeometryTileFeature> VectorTileLayer::getFeature(std::size_t i) const {
+    if (columns) {
+        return std::make_unique<VectorTileFeature>(layer, layer.getFeature(i), *columns, i);
+    }
     return std::make_unique<VectorTileFeature>(layer, layer.getFeature(i));
 }
 
+void VectorTileLayer::forEachFeature(const FeatureVisitor& visitor) const {
+    const std::size_t count = layer.featureCount();
+    for (std::size_t i = 0; i < count; ++i) {
+        if (columns) {
+            visitor(i, VectorTileFeature(layer, layer.getFeature(i), *columns, i));
+        } else {
+            visitor(i, VectorTileFeature(layer, layer.getFeature(i)));
+        }
+    }
+}
+
 std::string VectorTileLayer::getName() const {
     return layer.getName();
 }
 
-VectorTileData::VectorTileData(std::shared_ptr<const std::string> data_) : data(std::move(data_)) {
+class VectorTileData::Buffer {
+public:
+    Buffer(std::shared_ptr<const std::string> data_, std::string url_ = {})
+        : data(std::move(data_)), url(std::move(url_)) {}
+    ~Buffer();
+
+    const std::map<std::string, const protozero::data_view>& getLayers() const {
+        // We're parsing this lazily so that we can construct VectorTileData objects on the main
+        // thread without incurring the overhead of parsing immediately. A buffer may be shared
+        // by the workers of several sources, so parsing has to happen exactly once.
+        std::call_once(parsed, [this] { layers = mapbox::vector_tile::buffer(*data).getLayers(); });
+        return layers;
+    }
+
+    // The columns of the layer with the given name, shared by the layers read from the buffer
+    // while any of them is alive.
+    std::shared_ptr<VectorTileColumns> getColumns(const std::string& name) const {
+        std::lock_guard<std::mutex> lock(columnsMutex);
+        auto& entry = columns[name];
+        auto result = entry.lock();
+        if (!result) {
+            result = std::make_shared<VectorTileColumns>();
+            entry = result;
+        }
+        return result;
+    }
+
+    const std::shared_ptr<const std::string> data;
+    const std::string url;
+
+private:
+    mutable std::once_flag parsed;
+    mutable std::map<std::string, const protozero::data_view> layers;
+    mutable std::mutex columnsMutex;
+    mutable std::unordered_map<std::string, std::weak_ptr<VectorTileColumns>> columns;
+};
+
+namespace {
+
+struct BufferRegistry {
+    std::mutex mutex;
+    std::unordered_map<std::string, std::weak_ptr<const void>> buffers;
+};
+
+BufferRegistry& getBufferRegistry() {
+    // Intentionally leaked: buffers may be released after static destructors have run.
+    static auto* registry = new BufferRegistry();
+    return *registry;
 }
 
-std::unique_ptr<GeometryTileData> VectorTileData::clone() const {
-    return std::make_unique<VectorTileData>(data);
+} // namespace
+
+VectorTileData::Buffer::~Buffer() {
+    if (url.empty()) {
+        return;
+    }
+    auto& registry = getBufferRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    auto it = registry.buffers.find(url);
+    // The entry may have been replaced by a newer buffer for the same URL.
+    if (it != registry.buffers.end() && it->second.expired()) {
+        registry.buffers.erase(it);
+    }
 }
 
-std::unique_ptr<GeometryTileLayer> VectorTileData::getLayer(const std::string& name) const {
-    if (!parsed) {
-        // We're parsing this lazily so that we can construct VectorTileData objects on the main
-        // thread without incurring the overhead of parsing immediately.
-        layers = mapbox::vector_tile::buffer(*data).getLayers();
-        parsed = true;
+VectorTileData::VectorTileData(std::shared_ptr<const std::string> data_)
+    : buffer(std::make_shared<const Buffer>(std::move(data_))) {
+}
+
+VectorTileData::VectorTileData(std::shared_ptr<const Buffer> buffer_, bool readsColumns_)
+    : buffer(std::move(buffer_)), readsColumns(readsColumns_) {
+}
+
+std::unique_ptr<VectorTileData> VectorTileData::create(const std::string& url,
+                                                       std::shared_ptr<const std::string> data) {
+    assert(data);
+    // Declared before the lock: releasing the last reference to a stale buffer locks the registry.
+    std::shared_ptr<const Buffer> existing;
+    auto& registry = getBufferRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+
+    auto& entry = registry.buffers[url];
+    existing = std::static_pointer_cast<const Buffer>(entry.lock());
+    if (existing) {
+        if (existing->data == data || *existing->data == *data) {
+            return std::unique_ptr<VectorTileData>(new VectorTileData(std::move(existing), true));
+        }
     }
 
+    auto created = std::make_shared<const Buffer>(std::move(data), url);
+    entry = created;
+    return std::unique_ptr<VectorTileData>(new VectorTileData(std::move(created), true));
+}
+
+std::unique_ptr<GeometryTileData> VectorTileData::clone() const {
+    return std::unique_ptr<GeometryTileData>(new VectorTileData(buffer, false));
+}
+
+std::unique_ptr<GeometryTileLayer> VectorTileData::getLayer(const std::string& name) const {
+    const auto& layers = buffer->getLayers();
     auto it = layers.find(name);
     if (it != layers.end()) {
-        return std::make_unique<VectorTileLayer>(data, it->second);
+        if (readsColumns) {
+            return std::make_unique<VectorTileLayer>(buffer->data, it->second, buffer->getColumns(name));
+        }
+        return std::make_unique<VectorTileLayer>(buffer->data, it->second);
     }
     return nullptr;
 }
 
 std::vector<std::string> VectorTileData::layerNames() const {
-    return mapbox::vector_tile::buffer(*data).layerNames();
+    return mapbox::vector_tile::buffer(*buffer->data).layerNames();
 }
 
 } // namespace mbgl
@@ -9,9 +9,16 @@
 
 namespace mbgl {
 
+class VectorTileColumns;
+
 class VectorTileFeature : public GeometryTileFeature {
 public:
     VectorTileFeature(const mapbox::vector_tile::layer&, const protozero::data_view&);
+    // Reads the values of properties from the columns of its layer, at the given feature index.
+    VectorTileFeature(const mapbox::vector_tile::layer&,
+                      const protozero::data_view&,
+                      VectorTileColumns&,
+                      std::size_t index);
 
     FeatureType getType() const override;
     optional<Value> getValue(const std::string& key) const override;
@@ -20,7 +27,10 @@ public:
     const GeometryCollection& getGeometries() const override;
 
 private:
+    const mapbox::vector_tile::layer& layer;
     mapbox::vector_tile::feature feature;
+    VectorTileColumns* columns = nullptr;
+    std::size_t index = 0;
     mutable optional<GeometryCollection> lines;
     mutable optional<PropertyMap> properties;
 };
@@ -28,29 +38,47 @@ private:
 class VectorTileLayer : public GeometryTileLayer {
 public:
     VectorTileLayer(std::shared_ptr<const std::string> data, const protozero::data_view&);
+    VectorTileLayer(std::shared_ptr<const std::string> data,
+                    const protozero::data_view&,
+                    std::shared_ptr<VectorTileColumns>);
 
     std::size_t featureCount() const override;
     std::unique_ptr<GeometryTileFeature> getFeature(std::size_t i) const override;
+    void forEachFeature(const FeatureVisitor&) const override;
     std::string getName() const override;
 
 private:
     std::shared_ptr<const std::string> data;
     mapbox::vector_tile::layer layer;
+    std::shared_ptr<VectorTileColumns> columns;
 };
 
 class VectorTileData : public GeometryTileData {
 public:
     VectorTileData(std::shared_ptr<const std::string> data);
 
+    // Creates data for the tile loaded from the given URL. When another VectorTileData for the
+    // same URL and with identical contents is still alive, e.g. because two sources refer to the
+    // same tileset, the raw buffer and its parsed layer index are shared instead of duplicated.
+    static std::unique_ptr<VectorTileData> create(const std::string& url, std::shared_ptr<const std::string> data);
+
+    // Clones are kept by the feature index of the parsed tile, whose queries read a few features
+    // at a time. Their layers read the values from the features, and don't keep the property
+    // columns of the parse alive.
     std::unique_ptr<GeometryTileData> clone() const override;
     std::unique_ptr<GeometryTileLayer> getLayer(const std::string& name) const override;
 
     std::vector<std::string> layerNames() const;
 
+    // Whether both objects refer to the same underlying buffer.
+    bool sharesBufferWith(const VectorTileData& other) const { return buffer == other.buffer; }
+
 private:
-    std::shared_ptr<const std::string> data;
-    mutable bool parsed = false;
-    mutable std::map<std::string, const protozero::data_view> layers;
+    class Buffer;
+    VectorTileData(std::shared_ptr<const Buffer>, bool readsColumns);
+
+    std::shared_ptr<const Buffer> buffer;
+    bool readsColumns = true;
 };
 
 } // namespace mbgl
@@ -0,0 +1,77 @@
+#include <mbgl/util/arena.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+
+namespace mbgl {
+namespace util {
+
+namespace {
+
+// Blocks beyond this size are only allocated for requests that don't fit into a smaller one.
+constexpr std::size_t maxBlockSize = 16 * 1024 * 1024;
+
+} // namespace
+
+Arena::Arena(std::size_t initialBlockSize_)
+    : initialBlockSize(std::max<std::size_t>(initialBlockSize_, 64)), nextBlockSize(initialBlockSize) {}
+
+void* Arena::allocate(std::size_t size, std::size_t alignment) {
+    // Blocks come from new[], which is aligned for any fundamental type.
+    assert(alignment != 0 && alignment <= alignof(std::max_align_t));
+
+    if (!blocks.empty()) {
+        Block& block = blocks.back();
+        const std::size_t aligned = (offset + alignment - 1) / alignment * alignment;
+        if (aligned <= block.size && size <= block.size - aligned) {
+            offset = aligned + size;
+            return block.data.get() + aligned;
+        }
+    }
+
+    const std::size_t blockSize = std::max(nextBlockSize, size);
+    blocks.push_back({std::unique_ptr<char[]>(new char[blockSize]), blockSize});
+    nextBlockSize = std::min(nextBlockSize * 2, maxBlockSize);
+    offset = size;
+    return blocks.back().data.get();
+}
+
+void Arena::deallocate(void* pointer, std::size_t size) noexcept {
+    if (blocks.empty() || !pointer) {
+        return;
+    }
+    char* const top = blocks.back().data.get() + offset;
+    if (static_cast<char*>(pointer) + size == top) {
+        offset -= size;
+    }
+}
+
+void Arena::reset() {
+    if (blocks.size() > 1) {
+        auto largest = std::max_element(
+            blocks.begin(), blocks.end(), [](const Block& a, const Block& b) { return a.size < b.size; });
+        Block block = std::move(*largest);
+        blocks.clear();
+        blocks.push_back(std::move(block));
+    }
+    offset = 0;
+}
+
+void Arena::release() {
+    blocks.clear();
+    blocks.shrink_to_fit();
+    offset = 0;
+    nextBlockSize = initialBlockSize;
+}
+
+std::size_t Arena::capacity() const {
+    std::size_t result = 0;
+    for (const auto& block : blocks) {
+        result += block.size;
+    }
+    return result;
+}
+
+} // namespace util
+} // namespace mbgl
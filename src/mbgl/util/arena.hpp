@@ -0,0 +1,100 @@
+#pragma once
+
+#include <mbgl/util/noncopyable.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+namespace mbgl {
+namespace util {
+
+// A monotonic allocator for objects that are all released at the same time. Memory is handed out
+// from a list of growing blocks. reset() keeps the largest block around so that the next round of
+// allocations usually doesn't hit malloc at all, release() returns all of them to the system.
+// Not thread-safe.
+class Arena : private util::noncopyable {
+public:
+    explicit Arena(std::size_t initialBlockSize = 64 * 1024);
+
+    void* allocate(std::size_t size, std::size_t alignment);
+
+    // Only the most recent allocation is actually reclaimed, which lets a growing vector reuse
+    // the space of its previous buffer. Anything else is released by reset().
+    void deallocate(void* pointer, std::size_t size) noexcept;
+
+    // Invalidates everything allocated from the arena.
+    void reset();
+
+    // Invalidates everything allocated from the arena, and returns all of its memory to the system.
+    // The next block has the initial size again.
+    void release();
+
+    // The number of bytes currently held by the arena.
+    std::size_t capacity() const;
+
+private:
+    struct Block {
+        std::unique_ptr<char[]> data;
+        std::size_t size;
+    };
+
+    std::vector<Block> blocks;
+    std::size_t offset = 0;
+    const std::size_t initialBlockSize;
+    std::size_t nextBlockSize;
+};
+
+// A standard allocator backed by an Arena. Without an arena, it uses the global heap, so that
+// containers using it can also be created outside of an arena's scope.
+template <class T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    ArenaAllocator() noexcept = default;
+    explicit ArenaAllocator(Arena* arena_) noexcept : arena(arena_) {}
+    template <class U>
+    ArenaAllocator(const ArenaAllocator<U>& other) noexcept : arena(other.getArena()) {}
+
+    Arena* getArena() const noexcept { return arena; }
+
+    T* allocate(std::size_t n) {
+        if (!arena) {
+            return static_cast<T*>(::operator new(n * sizeof(T)));
+        }
+        return static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* pointer, std::size_t n) noexcept {
+        if (!arena) {
+            ::operator delete(pointer);
+        } else {
+            arena->deallocate(pointer, n * sizeof(T));
+        }
+    }
+
+    template <class U>
+    friend bool operator==(const ArenaAllocator& lhs, const ArenaAllocator<U>& rhs) noexcept {
+        return lhs.arena == rhs.getArena();
+    }
+
+    template <class U>
+    friend bool operator!=(const ArenaAllocator& lhs, const ArenaAllocator<U>& rhs) noexcept {
+        return lhs.arena != rhs.getArena();
+    }
+
+private:
+    Arena* arena = nullptr;
+};
+
+template <class T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+} // namespace util
+} // namespace mbgl
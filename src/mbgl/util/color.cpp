@@ -3,23 +3,91 @@
 
 #include <csscolorparser/csscolorparser.hpp>
 
+#include <array>
+#include <functional>
+
 namespace mbgl {
 
-optional<Color> Color::parse(const std::string& s) {
-    auto css_color = CSSColorParser::parse(s);
+namespace {
 
-    // Premultiply the color.
-    if (css_color) {
-        const float factor = css_color->a / 255;
-        return {{
-            css_color->r * factor,
-            css_color->g * factor,
-            css_color->b * factor,
-            css_color->a
-        }};
-    } else {
+Color premultiply(const CSSColorParser::Color& css_color) {
+    const float factor = css_color.a / 255;
+    return {
+        css_color.r * factor,
+        css_color.g * factor,
+        css_color.b * factor,
+        css_color.a
+    };
+}
+
+int hexDigit(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// Parses #rgb and #rrggbb, the most common notations of styles, without the copies of the
+// general parser. Anything else, including hex colors with other characters, which the general
+// parser accepts in its own lenient way, is left to it.
+optional<CSSColorParser::Color> parseHex(const std::string& s) {
+    if ((s.size() != 4 && s.size() != 7) || s.front() != '#') {
         return {};
     }
+
+    const std::size_t digits = (s.size() - 1) / 3;
+    unsigned char channels[3];
+    for (std::size_t i = 0; i < 3; ++i) {
+        int channel = 0;
+        for (std::size_t j = 0; j < digits; ++j) {
+            const int digit = hexDigit(s[1 + i * digits + j]);
+            if (digit < 0) {
+                return {};
+            }
+            channel = channel * 16 + digit;
+        }
+        channels[i] = static_cast<unsigned char>(digits == 1 ? channel * 17 : channel);
+    }
+    return CSSColorParser::Color(channels[0], channels[1], channels[2], 1);
+}
+
+// The colors of the strings parsed last on this thread. Colors coming from feature properties
+// repeat the same few strings over and over.
+class ParseCache {
+public:
+    static ParseCache& get() {
+        static thread_local ParseCache cache;
+        return cache;
+    }
+
+    optional<Color> parse(const std::string& s) {
+        Entry& entry = entries[std::hash<std::string>()(s) % entries.size()];
+        if (!entry.used || entry.string != s) {
+            auto css_color = CSSColorParser::parse(s);
+            entry.color = css_color ? optional<Color>(premultiply(*css_color)) : nullopt;
+            entry.string = s;
+            entry.used = true;
+        }
+        return entry.color;
+    }
+
+private:
+    struct Entry {
+        bool used = false;
+        std::string string;
+        optional<Color> color;
+    };
+
+    std::array<Entry, 64> entries;
+};
+
+} // namespace
+
+optional<Color> Color::parse(const std::string& s) {
+    if (auto css_color = parseHex(s)) {
+        return premultiply(*css_color);
+    }
+    return ParseCache::get().parse(s);
 }
 
 std::string Color::stringify() const {
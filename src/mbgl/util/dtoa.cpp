@@ -2,20 +2,44 @@
 
 #include <rapidjson/internal/dtoa.h>
 
+#include <cmath>
+#include <cstdint>
+
 namespace mbgl {
 namespace util {
 
 std::string dtoa(double value, bool decimal) {
-    std::string data;
-    data.resize(25);
-    auto end = rapidjson::internal::dtoa(value, const_cast<char*>(data.data()));
-    auto length = end - data.data();
+    char buffer[25];
+
+    // Integers, such as elevations and house numbers, are written as such. Below 10^15 their
+    // shortest representation is the integer itself, as it is in the output of the general case.
+    if (value != 0 && std::abs(value) < 1e15 && std::trunc(value) == value) {
+        char digits[15];
+        std::size_t count = 0;
+        for (auto integer = static_cast<uint64_t>(std::abs(value)); integer; integer /= 10) {
+            digits[count++] = static_cast<char>('0' + integer % 10);
+        }
+        char* end = buffer;
+        if (value < 0) {
+            *end++ = '-';
+        }
+        while (count) {
+            *end++ = digits[--count];
+        }
+        if (decimal) {
+            *end++ = '.';
+            *end++ = '0';
+        }
+        return std::string(buffer, end);
+    }
+
+    auto end = rapidjson::internal::dtoa(value, buffer);
+    auto length = end - buffer;
     if (!decimal && length >= 3 && end[-1] == '0' && end[-2] == '.') {
         // Remove trailing ".0" for integers
         length -= 2;
     }
-    data.resize(length);
-    return data;
+    return std::string(buffer, length);
 }
 
 } // namespace util
@@ -0,0 +1,225 @@
+#include <mbgl/util/etc1.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+namespace mbgl {
+namespace util {
+
+namespace {
+
+constexpr uint32_t blockBytes = 8;
+
+// The intensity modifiers of the eight tables, for the pixel index values 0 and 1. The index
+// values 2 and 3 negate them.
+constexpr int modifierTable[8][2] = {{2, 8}, {5, 17}, {9, 29}, {13, 42}, {18, 60}, {24, 80}, {33, 106}, {47, 183}};
+
+using RGB = std::array<int, 3>;
+
+int modifier(uint32_t table, uint32_t index) {
+    const int value = modifierTable[table][index & 1];
+    return (index & 2) ? -value : value;
+}
+
+int clampByte(int value) {
+    return std::max(0, std::min(255, value));
+}
+
+int expand4(int value) {
+    return (value << 4) | value;
+}
+
+int expand5(int value) {
+    return (value << 3) | (value >> 2);
+}
+
+// Pixels are numbered column by column, as in the block layout.
+bool inSecondSubblock(uint32_t pixel, bool flip) {
+    return flip ? (pixel & 3) >= 2 : pixel >= 8;
+}
+
+struct Subblock {
+    uint32_t table = 0;
+    uint32_t error = std::numeric_limits<uint32_t>::max();
+};
+
+// Picks the table, and the index of each pixel of the subblock, that come closest to the pixels.
+Subblock fit(const std::array<RGB, 16>& pixels,
+             bool flip,
+             bool second,
+             const RGB& base,
+             std::array<uint32_t, 16>& indices) {
+    Subblock best;
+    std::array<uint32_t, 16> candidate{};
+    for (uint32_t table = 0; table < 8; ++table) {
+        uint32_t error = 0;
+        for (uint32_t pixel = 0; pixel < 16; ++pixel) {
+            if (inSecondSubblock(pixel, flip) != second) {
+                continue;
+            }
+            uint32_t pixelError = std::numeric_limits<uint32_t>::max();
+            for (uint32_t index = 0; index < 4; ++index) {
+                const int m = modifier(table, index);
+                uint32_t e = 0;
+                for (std::size_t c = 0; c < 3; ++c) {
+                    const int d = clampByte(base[c] + m) - pixels[pixel][c];
+                    e += uint32_t(d * d);
+                }
+                if (e < pixelError) {
+                    pixelError = e;
+                    candidate[pixel] = index;
+                }
+            }
+            error += pixelError;
+        }
+        if (error < best.error) {
+            best.table = table;
+            best.error = error;
+            for (uint32_t pixel = 0; pixel < 16; ++pixel) {
+                if (inSecondSubblock(pixel, flip) == second) {
+                    indices[pixel] = candidate[pixel];
+                }
+            }
+        }
+    }
+    return best;
+}
+
+void encodeBlock(const std::array<RGB, 16>& pixels, uint8_t* block) {
+    uint32_t bestError = std::numeric_limits<uint32_t>::max();
+    for (bool flip : {false, true}) {
+        // The average color of each subblock, quantized for both modes.
+        std::array<RGB, 2> average4{};
+        std::array<RGB, 2> average5{};
+        for (std::size_t s = 0; s < 2; ++s) {
+            RGB sum{};
+            for (uint32_t pixel = 0; pixel < 16; ++pixel) {
+                if (inSecondSubblock(pixel, flip) == bool(s)) {
+                    for (std::size_t c = 0; c < 3; ++c) sum[c] += pixels[pixel][c];
+                }
+            }
+            for (std::size_t c = 0; c < 3; ++c) {
+                const double mean = sum[c] / 8.0;
+                average4[s][c] = int(std::lround(mean * 15 / 255));
+                average5[s][c] = int(std::lround(mean * 31 / 255));
+            }
+        }
+
+        bool representable = true;
+        for (std::size_t c = 0; c < 3; ++c) {
+            const int delta = average5[1][c] - average5[0][c];
+            representable = representable && delta >= -4 && delta <= 3;
+        }
+
+        for (bool differential : {false, true}) {
+            if (differential && !representable) {
+                continue;
+            }
+            std::array<RGB, 2> base;
+            for (std::size_t s = 0; s < 2; ++s) {
+                for (std::size_t c = 0; c < 3; ++c) {
+                    base[s][c] = differential ? expand5(average5[s][c]) : expand4(average4[s][c]);
+                }
+            }
+
+            std::array<uint32_t, 16> indices{};
+            const Subblock first = fit(pixels, flip, false, base[0], indices);
+            const Subblock second = fit(pixels, flip, true, base[1], indices);
+            if (first.error + second.error >= bestError) {
+                continue;
+            }
+            bestError = first.error + second.error;
+
+            for (std::size_t c = 0; c < 3; ++c) {
+                block[c] = differential
+                               ? uint8_t((average5[0][c] << 3) | ((average5[1][c] - average5[0][c]) & 7))
+                               : uint8_t((average4[0][c] << 4) | average4[1][c]);
+            }
+            block[3] = uint8_t((first.table << 5) | (second.table << 2) | (differential << 1) | flip);
+            uint32_t bits = 0;
+            for (uint32_t pixel = 0; pixel < 16; ++pixel) {
+                bits |= ((indices[pixel] >> 1) << (16 + pixel)) | ((indices[pixel] & 1) << pixel);
+            }
+            for (std::size_t i = 0; i < 4; ++i) {
+                block[4 + i] = uint8_t(bits >> (24 - 8 * i));
+            }
+        }
+    }
+}
+
+} // namespace
+
+std::vector<uint8_t> encodeETC1(const PremultipliedImage& image) {
+    const Size size = image.size;
+    if (!image.valid() || size.width % 4 || size.height % 4) {
+        return {};
+    }
+    for (std::size_t i = 3; i < image.bytes(); i += 4) {
+        if (image.data[i] != 255) {
+            return {};
+        }
+    }
+
+    std::vector<uint8_t> blocks(std::size_t(size.width / 4) * (size.height / 4) * blockBytes);
+    uint8_t* block = blocks.data();
+    std::array<RGB, 16> pixels;
+    for (uint32_t by = 0; by < size.height; by += 4) {
+        for (uint32_t bx = 0; bx < size.width; bx += 4) {
+            for (uint32_t x = 0; x < 4; ++x) {
+                for (uint32_t y = 0; y < 4; ++y) {
+                    const uint8_t* pixel = image.data.get() + ((by + y) * size.width + bx + x) * 4;
+                    pixels[x * 4 + y] = {{pixel[0], pixel[1], pixel[2]}};
+                }
+            }
+            encodeBlock(pixels, block);
+            block += blockBytes;
+        }
+    }
+    return blocks;
+}
+
+PremultipliedImage decodeETC1(Size size, const std::vector<uint8_t>& blocks) {
+    assert(size.width % 4 == 0 && size.height % 4 == 0);
+    assert(blocks.size() == std::size_t(size.width / 4) * (size.height / 4) * blockBytes);
+    PremultipliedImage image(size);
+    const uint8_t* block = blocks.data();
+    for (uint32_t by = 0; by < size.height; by += 4) {
+        for (uint32_t bx = 0; bx < size.width; bx += 4) {
+            const bool differential = block[3] & 2;
+            const bool flip = block[3] & 1;
+            std::array<RGB, 2> base;
+            for (std::size_t c = 0; c < 3; ++c) {
+                if (differential) {
+                    const int first = block[c] >> 3;
+                    const int delta = (block[c] & 7) >= 4 ? (block[c] & 7) - 8 : (block[c] & 7);
+                    base[0][c] = expand5(first);
+                    base[1][c] = expand5(first + delta);
+                } else {
+                    base[0][c] = expand4(block[c] >> 4);
+                    base[1][c] = expand4(block[c] & 15);
+                }
+            }
+            const uint32_t tables[2] = {uint32_t(block[3] >> 5), uint32_t((block[3] >> 2) & 7)};
+            const uint32_t bits = (uint32_t(block[4]) << 24) | (uint32_t(block[5]) << 16) |
+                                  (uint32_t(block[6]) << 8) | uint32_t(block[7]);
+            for (uint32_t pixel = 0; pixel < 16; ++pixel) {
+                const std::size_t s = inSecondSubblock(pixel, flip);
+                const uint32_t index = (((bits >> (16 + pixel)) & 1) << 1) | ((bits >> pixel) & 1);
+                const int m = modifier(tables[s], index);
+                uint8_t* out = image.data.get() + ((by + (pixel & 3)) * size.width + bx + (pixel >> 2)) * 4;
+                for (std::size_t c = 0; c < 3; ++c) {
+                    out[c] = uint8_t(clampByte(base[s][c] + m));
+                }
+                out[3] = 255;
+            }
+            block += blockBytes;
+        }
+    }
+    return image;
+}
+
+} // namespace util
+} // namespace mbgl
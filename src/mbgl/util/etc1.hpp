@@ -0,0 +1,25 @@
+#pragma once
+
+#include <mbgl/util/image.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace mbgl {
+namespace util {
+
+/*
+    Encoder and decoder of ETC1 compressed textures, which store the RGB colors of each 4x4 block
+    of pixels in 8 bytes, an eighth of the uncompressed RGBA size. ETC1 has no alpha channel, so
+    only opaque images can be encoded. GPUs that support ETC2 decode ETC1 data as well.
+*/
+
+// Returns the blocks of the image, row by row, or nothing when the image isn't opaque or its
+// width or height isn't a multiple of 4.
+std::vector<uint8_t> encodeETC1(const PremultipliedImage&);
+
+// Decodes the blocks of an image of that size.
+PremultipliedImage decodeETC1(Size, const std::vector<uint8_t>&);
+
+} // namespace util
+} // namespace mbgl
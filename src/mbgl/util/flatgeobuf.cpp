@@ -0,0 +1,511 @@
+#include <mbgl/math/clamp.hpp>
+#include <mbgl/tile/tile_id.hpp>
+#include <mbgl/util/flatgeobuf.hpp>
+#include <mbgl/util/projection.hpp>
+
+#include <mapbox/geometry/envelope.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace mbgl {
+
+namespace {
+
+// FlatGeobuf files start with "fgb", the major version 3, "fgb" and the patch version.
+constexpr char magicBytes[] = {'f', 'g', 'b', 3, 'f', 'g', 'b'};
+constexpr std::size_t magicSize = 8;
+constexpr std::size_t maxHeaderSize = 10 * 1024 * 1024;
+
+// A packed R-tree node: its bounding box and either the index of its first child node or, for the
+// leaves, the byte offset of its feature in the feature data.
+constexpr std::size_t nodeItemSize = 4 * sizeof(double) + sizeof(uint64_t);
+
+enum class GeometryType : uint8_t {
+    Unknown = 0,
+    Point,
+    LineString,
+    Polygon,
+    MultiPoint,
+    MultiLineString,
+    MultiPolygon,
+    GeometryCollection
+};
+
+enum class ColumnType : uint8_t {
+    Byte = 0,
+    UByte,
+    Bool,
+    Short,
+    UShort,
+    Int,
+    UInt,
+    Long,
+    ULong,
+    Float,
+    Double,
+    String,
+    Json,
+    DateTime,
+    Binary
+};
+
+// Field indices of the flatbuffer tables in FlatGeobuf's schema.
+namespace headerField {
+constexpr uint16_t envelope = 1;
+constexpr uint16_t geometryType = 2;
+constexpr uint16_t columns = 7;
+constexpr uint16_t featuresCount = 8;
+constexpr uint16_t indexNodeSize = 9;
+} // namespace headerField
+namespace columnField {
+constexpr uint16_t name = 0;
+constexpr uint16_t type = 1;
+} // namespace columnField
+namespace featureField {
+constexpr uint16_t geometry = 0;
+constexpr uint16_t properties = 1;
+constexpr uint16_t columns = 2;
+} // namespace featureField
+namespace geometryField {
+constexpr uint16_t ends = 0;
+constexpr uint16_t xy = 1;
+constexpr uint16_t type = 6;
+constexpr uint16_t parts = 7;
+} // namespace geometryField
+
+// FlatGeobuf and flatbuffers are little-endian, like the platforms we run on.
+template <class T>
+T readScalar(const std::string& data, std::size_t offset) {
+    if (offset > data.size() || data.size() - offset < sizeof(T)) {
+        throw std::runtime_error("Truncated FlatGeobuf data");
+    }
+    T value;
+    std::memcpy(&value, data.data() + offset, sizeof(T));
+    return value;
+}
+
+struct Vector {
+    std::size_t begin = 0;
+    uint32_t size = 0;
+};
+
+// A read-only view of a flatbuffer table.
+class Table {
+public:
+    Table(const std::string& data_, std::size_t offset_) : data(data_), offset(offset_) {
+        const int64_t vtable = int64_t(offset) - readScalar<int32_t>(data, offset);
+        if (vtable < 0) throw std::runtime_error("Invalid FlatGeobuf data");
+        vtableOffset = std::size_t(vtable);
+        vtableSize = readScalar<uint16_t>(data, vtableOffset);
+    }
+
+    static Table root(const std::string& data) { return {data, readScalar<uint32_t>(data, 0)}; }
+
+    template <class T>
+    T scalar(uint16_t field, T defaultValue) const {
+        const uint16_t position = fieldPosition(field);
+        return position ? readScalar<T>(data, offset + position) : defaultValue;
+    }
+
+    optional<Table> table(uint16_t field) const {
+        if (optional<std::size_t> target = offsetField(field)) return Table(data, *target);
+        return nullopt;
+    }
+
+    Vector vector(uint16_t field, std::size_t elementSize) const {
+        optional<std::size_t> target = offsetField(field);
+        if (!target) return {};
+        const Vector result{*target + sizeof(uint32_t), readScalar<uint32_t>(data, *target)};
+        if ((data.size() - result.begin) / elementSize < result.size) {
+            throw std::runtime_error("Truncated FlatGeobuf data");
+        }
+        return result;
+    }
+
+    std::vector<Table> tables(uint16_t field) const {
+        const Vector elements = vector(field, sizeof(uint32_t));
+        std::vector<Table> result;
+        result.reserve(elements.size);
+        for (uint32_t i = 0; i < elements.size; ++i) {
+            const std::size_t element = elements.begin + i * sizeof(uint32_t);
+            result.emplace_back(data, element + readScalar<uint32_t>(data, element));
+        }
+        return result;
+    }
+
+    std::string string(uint16_t field) const {
+        const Vector characters = vector(field, 1);
+        return data.substr(characters.begin, characters.size);
+    }
+
+private:
+    uint16_t fieldPosition(uint16_t field) const {
+        const std::size_t entry = 2 * (2 + std::size_t(field));
+        return entry < vtableSize ? readScalar<uint16_t>(data, vtableOffset + entry) : 0;
+    }
+
+    optional<std::size_t> offsetField(uint16_t field) const {
+        const uint16_t position = fieldPosition(field);
+        if (!position) return nullopt;
+        return offset + position + readScalar<uint32_t>(data, offset + position);
+    }
+
+    const std::string& data;
+    const std::size_t offset;
+    std::size_t vtableOffset;
+    uint16_t vtableSize;
+};
+
+struct Column {
+    std::string name;
+    ColumnType type;
+};
+
+std::vector<Column> readColumns(const Table& table, uint16_t field) {
+    std::vector<Column> columns;
+    for (const Table& column : table.tables(field)) {
+        columns.push_back({column.string(columnField::name), ColumnType(column.scalar<uint8_t>(columnField::type, 0))});
+    }
+    return columns;
+}
+
+class GeometryReader {
+public:
+    explicit GeometryReader(const std::string& data_) : data(data_) {}
+
+    mapbox::geojson::geometry read(const Table& geometry, GeometryType type) {
+        if (type == GeometryType::Unknown) {
+            type = GeometryType(geometry.scalar<uint8_t>(geometryField::type, 0));
+        }
+        switch (type) {
+            case GeometryType::MultiPolygon: {
+                mapbox::geojson::multi_polygon polygons;
+                for (const Table& part : geometry.tables(geometryField::parts)) {
+                    polygons.push_back(readLines<mapbox::geojson::polygon>(part));
+                }
+                return polygons;
+            }
+            case GeometryType::GeometryCollection: {
+                mapbox::geojson::geometry_collection geometries;
+                for (const Table& part : geometry.tables(geometryField::parts)) {
+                    geometries.push_back(read(part, GeometryType::Unknown));
+                }
+                return geometries;
+            }
+            case GeometryType::Point: {
+                const Vector xy = geometry.vector(geometryField::xy, sizeof(double));
+                if (xy.size < 2) return mapbox::geometry::empty{};
+                return point(xy, 0);
+            }
+            case GeometryType::MultiPoint:
+                return readPoints<mapbox::geojson::multi_point>(geometry);
+            case GeometryType::LineString:
+                return readPoints<mapbox::geojson::line_string>(geometry);
+            case GeometryType::MultiLineString:
+                return readLines<mapbox::geojson::multi_line_string>(geometry);
+            case GeometryType::Polygon:
+                return readLines<mapbox::geojson::polygon>(geometry);
+            default:
+                throw std::runtime_error("Unsupported FlatGeobuf geometry type");
+        }
+    }
+
+private:
+    mapbox::geojson::point point(const Vector& xy, std::size_t index) const {
+        return {readScalar<double>(data, xy.begin + 2 * index * sizeof(double)),
+                readScalar<double>(data, xy.begin + (2 * index + 1) * sizeof(double))};
+    }
+
+    template <class Points>
+    Points readPoints(const Vector& xy, std::size_t begin, std::size_t end) const {
+        Points points;
+        points.reserve(end - begin);
+        for (std::size_t i = begin; i < end; ++i) {
+            points.push_back(point(xy, i));
+        }
+        return points;
+    }
+
+    template <class Points>
+    Points readPoints(const Table& geometry) const {
+        const Vector xy = geometry.vector(geometryField::xy, sizeof(double));
+        return readPoints<Points>(xy, 0, xy.size / 2);
+    }
+
+    // Lines or rings, which end at the point indices in `ends`, or a single one.
+    template <class Lines>
+    Lines readLines(const Table& geometry) const {
+        const Vector xy = geometry.vector(geometryField::xy, sizeof(double));
+        const Vector ends = geometry.vector(geometryField::ends, sizeof(uint32_t));
+        const std::size_t pointCount = xy.size / 2;
+        Lines lines;
+        if (ends.size == 0) {
+            lines.push_back(readPoints<typename Lines::value_type>(xy, 0, pointCount));
+            return lines;
+        }
+        std::size_t begin = 0;
+        for (uint32_t i = 0; i < ends.size; ++i) {
+            const std::size_t end = std::min<std::size_t>(readScalar<uint32_t>(data, ends.begin + i * 4), pointCount);
+            lines.push_back(readPoints<typename Lines::value_type>(xy, begin, std::max(begin, end)));
+            begin = std::max(begin, end);
+        }
+        return lines;
+    }
+
+    const std::string& data;
+};
+
+PropertyMap readProperties(const std::string& data, const Vector& properties, const std::vector<Column>& columns) {
+    PropertyMap result;
+    std::size_t position = properties.begin;
+    const std::size_t end = properties.begin + properties.size;
+    const auto next = [&](auto value) {
+        position += sizeof(value);
+        return value;
+    };
+    while (position < end) {
+        const uint16_t index = readScalar<uint16_t>(data, position);
+        position += sizeof(uint16_t);
+        if (index >= columns.size()) throw std::runtime_error("Invalid FlatGeobuf property");
+
+        Value value;
+        switch (columns[index].type) {
+            case ColumnType::Byte: value = int64_t(next(readScalar<int8_t>(data, position))); break;
+            case ColumnType::UByte: value = uint64_t(next(readScalar<uint8_t>(data, position))); break;
+            case ColumnType::Bool: value = next(readScalar<uint8_t>(data, position)) != 0; break;
+            case ColumnType::Short: value = int64_t(next(readScalar<int16_t>(data, position))); break;
+            case ColumnType::UShort: value = uint64_t(next(readScalar<uint16_t>(data, position))); break;
+            case ColumnType::Int: value = int64_t(next(readScalar<int32_t>(data, position))); break;
+            case ColumnType::UInt: value = uint64_t(next(readScalar<uint32_t>(data, position))); break;
+            case ColumnType::Long: value = next(readScalar<int64_t>(data, position)); break;
+            case ColumnType::ULong: value = next(readScalar<uint64_t>(data, position)); break;
+            case ColumnType::Float: value = double(next(readScalar<float>(data, position))); break;
+            case ColumnType::Double: value = next(readScalar<double>(data, position)); break;
+            case ColumnType::String:
+            case ColumnType::Json:
+            case ColumnType::DateTime:
+            case ColumnType::Binary: {
+                const uint32_t length = next(readScalar<uint32_t>(data, position));
+                if (length > end - std::min(position, end)) throw std::runtime_error("Truncated FlatGeobuf data");
+                value = data.substr(position, length);
+                position += length;
+                break;
+            }
+            default:
+                throw std::runtime_error("Unsupported FlatGeobuf column type");
+        }
+        result.emplace(columns[index].name, std::move(value));
+    }
+    return result;
+}
+
+} // namespace
+
+class FlatGeobufReader::Impl {
+public:
+    explicit Impl(const std::string& path) : file(path, std::ios::binary) {
+        if (!file.good()) {
+            throw std::runtime_error("Cannot read file " + path);
+        }
+        file.seekg(0, std::ios::end);
+        fileSize = uint64_t(file.tellg());
+
+        const std::string magic = read(0, magicSize);
+        if (!std::equal(std::begin(magicBytes), std::end(magicBytes), magic.begin())) {
+            throw std::runtime_error(path + " is not a FlatGeobuf file");
+        }
+        const uint32_t headerSize = readScalar<uint32_t>(read(magicSize, sizeof(uint32_t)), 0);
+        if (headerSize > maxHeaderSize) {
+            throw std::runtime_error("Invalid FlatGeobuf header");
+        }
+        const std::string headerData = read(magicSize + sizeof(uint32_t), headerSize);
+        const Table header = Table::root(headerData);
+
+        geometryType = GeometryType(header.scalar<uint8_t>(headerField::geometryType, 0));
+        columns = readColumns(header, headerField::columns);
+        featureCount = header.scalar<uint64_t>(headerField::featuresCount, 0);
+        nodeSize = header.scalar<uint16_t>(headerField::indexNodeSize, 16);
+
+        const Vector envelope = header.vector(headerField::envelope, sizeof(double));
+        if (envelope.size >= 4) {
+            const auto coordinate = [&](std::size_t i) {
+                return readScalar<double>(headerData, envelope.begin + i * sizeof(double));
+            };
+            bounds = LatLngBounds::hull({util::clamp(coordinate(1), -90.0, 90.0), coordinate(0)},
+                                        {util::clamp(coordinate(3), -90.0, 90.0), coordinate(2)});
+        }
+
+        indexOffset = magicSize + sizeof(uint32_t) + headerSize;
+        featuresOffset = indexOffset;
+        if (hasIndex()) {
+            generateLevelBounds();
+            featuresOffset += levelBounds.front().second * nodeItemSize;
+        }
+    }
+
+    FeatureCollection query(const LatLngBounds& queryBounds) const {
+        FeatureCollection result;
+        const auto intersects = [&](double minX, double minY, double maxX, double maxY) {
+            return minX <= queryBounds.east() && maxX >= queryBounds.west() && minY <= queryBounds.north() &&
+                   maxY >= queryBounds.south();
+        };
+
+        if (!hasIndex()) {
+            // Without an index, all of the features are read and filtered by their envelope.
+            uint64_t index = 0;
+            for (uint64_t offset = featuresOffset; offset < fileSize; ++index) {
+                const uint32_t size = readScalar<uint32_t>(read(offset, sizeof(uint32_t)), 0);
+                auto feature = readFeature(offset + sizeof(uint32_t), size, index);
+                const auto box = mapbox::geometry::envelope(feature.geometry);
+                if (intersects(box.min.x, box.min.y, box.max.x, box.max.y)) {
+                    result.push_back(std::move(feature));
+                }
+                offset += sizeof(uint32_t) + size;
+            }
+            return result;
+        }
+
+        // Search the packed R-tree from the root, reading one node's children at a time.
+        std::vector<std::pair<uint64_t, uint64_t>> hits; // feature offsets and indices
+        const uint64_t leavesOffset = levelBounds.front().first;
+        std::map<uint64_t, std::size_t> queue{{0, levelBounds.size() - 1}};
+        while (!queue.empty()) {
+            const uint64_t nodeIndex = queue.begin()->first;
+            const std::size_t level = queue.begin()->second;
+            queue.erase(queue.begin());
+
+            const bool isLeaf = nodeIndex >= leavesOffset;
+            if (!isLeaf && level == 0) throw std::runtime_error("Invalid FlatGeobuf index");
+            const uint64_t end = std::min<uint64_t>(nodeIndex + nodeSize, levelBounds[level].second);
+            const std::string nodes = read(indexOffset + nodeIndex * nodeItemSize, (end - nodeIndex) * nodeItemSize);
+            for (uint64_t i = 0; i < end - nodeIndex; ++i) {
+                const std::size_t node = i * nodeItemSize;
+                if (!intersects(readScalar<double>(nodes, node),
+                                readScalar<double>(nodes, node + 8),
+                                readScalar<double>(nodes, node + 16),
+                                readScalar<double>(nodes, node + 24))) {
+                    continue;
+                }
+                const uint64_t offset = readScalar<uint64_t>(nodes, node + 32);
+                if (isLeaf) {
+                    hits.emplace_back(offset, nodeIndex + i - leavesOffset);
+                } else {
+                    queue.emplace(offset, level - 1);
+                }
+            }
+        }
+
+        // Read the features in file order.
+        std::sort(hits.begin(), hits.end());
+        result.reserve(hits.size());
+        for (const auto& hit : hits) {
+            const uint64_t offset = featuresOffset + hit.first;
+            const uint32_t size = readScalar<uint32_t>(read(offset, sizeof(uint32_t)), 0);
+            result.push_back(readFeature(offset + sizeof(uint32_t), size, hit.second));
+        }
+        return result;
+    }
+
+    uint64_t featureCount = 0;
+    optional<LatLngBounds> bounds;
+
+private:
+    bool hasIndex() const { return nodeSize > 0 && featureCount > 0; }
+
+    // The range of node indices of each level of the packed R-tree, from the leaves up to the
+    // root. The nodes are stored from the root down.
+    void generateLevelBounds() {
+        if (nodeSize < 2) throw std::runtime_error("Invalid FlatGeobuf index node size");
+        std::vector<uint64_t> levelNodeCounts{featureCount};
+        uint64_t count = featureCount;
+        uint64_t nodeCount = count;
+        do {
+            count = (count + nodeSize - 1) / nodeSize;
+            nodeCount += count;
+            levelNodeCounts.push_back(count);
+        } while (count != 1);
+
+        for (const uint64_t levelNodeCount : levelNodeCounts) {
+            nodeCount -= levelNodeCount;
+            levelBounds.emplace_back(nodeCount, nodeCount + levelNodeCount);
+        }
+    }
+
+    mapbox::geojson::feature readFeature(uint64_t offset, uint32_t size, uint64_t index) const {
+        const std::string data = read(offset, size);
+        const Table table = Table::root(data);
+
+        mapbox::geojson::feature result;
+        if (optional<Table> geometry = table.table(featureField::geometry)) {
+            result.geometry = GeometryReader(data).read(*geometry, geometryType);
+        }
+        const Vector properties = table.vector(featureField::properties, 1);
+        if (properties.size) {
+            const std::vector<Column> featureColumns = readColumns(table, featureField::columns);
+            result.properties = readProperties(data, properties, featureColumns.empty() ? columns : featureColumns);
+        }
+        result.id = index;
+        return result;
+    }
+
+    std::string read(uint64_t offset, uint64_t length) const {
+        if (offset > fileSize || fileSize - offset < length) {
+            throw std::runtime_error("Truncated FlatGeobuf file");
+        }
+        std::string data(length, '\0');
+        std::lock_guard<std::mutex> lock(mutex);
+        file.clear();
+        file.seekg(std::streamoff(offset));
+        file.read(&data[0], std::streamsize(length));
+        if (uint64_t(file.gcount()) != length) {
+            throw std::runtime_error("Cannot read FlatGeobuf file");
+        }
+        return data;
+    }
+
+    mutable std::mutex mutex;
+    mutable std::ifstream file;
+    uint64_t fileSize = 0;
+
+    GeometryType geometryType = GeometryType::Unknown;
+    std::vector<Column> columns;
+    uint16_t nodeSize = 0;
+    std::vector<std::pair<uint64_t, uint64_t>> levelBounds;
+    uint64_t indexOffset = 0;
+    uint64_t featuresOffset = 0;
+};
+
+FlatGeobufReader::FlatGeobufReader(const std::string& path) : impl(std::make_unique<Impl>(path)) {}
+
+FlatGeobufReader::~FlatGeobufReader() = default;
+
+uint64_t FlatGeobufReader::getFeatureCount() const {
+    return impl->featureCount;
+}
+
+optional<LatLngBounds> FlatGeobufReader::getBounds() const {
+    return impl->bounds;
+}
+
+FeatureCollection FlatGeobufReader::query(const LatLngBounds& bounds) const {
+    return impl->query(bounds);
+}
+
+FeatureCollection FlatGeobufReader::getTile(const CanonicalTileID& id, uint16_t buffer, uint16_t tileSize) const {
+    const double scale = std::pow(2.0, id.z);
+    const double margin = double(buffer) / tileSize;
+    const LatLng northwest = Projection::unproject(
+        {(id.x - margin) * util::tileSize, (id.y - margin) * util::tileSize}, scale);
+    const LatLng southeast = Projection::unproject(
+        {(id.x + 1 + margin) * util::tileSize, (id.y + 1 + margin) * util::tileSize}, scale);
+    return query(LatLngBounds::hull(northwest, southeast));
+}
+
+} // namespace mbgl
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <mbgl/util/chrono.hpp>
+#include <mbgl/util/noncopyable.hpp>
+
+namespace mbgl {
+namespace util {
+
+// Adds the time from its construction to its destruction to a duration.
+class FrameTimer : private util::noncopyable {
+public:
+    explicit FrameTimer(Duration& duration_) : duration(duration_), start(Clock::now()) {}
+    ~FrameTimer() { duration += Clock::now() - start; }
+
+private:
+    Duration& duration;
+    const TimePoint start;
+};
+
+} // namespace util
+} // namespace mbgl
+
+// Adds the time until the end of the enclosing scope to `duration` in builds with frame timings
+// (MBGL_WITH_FRAME_TIMINGS), and compiles to nothing otherwise.
+#ifdef MBGL_FRAME_TIMINGS
+#define MBGL_FRAME_TIMER_NAME_(line) frameTimer##line
+#define MBGL_FRAME_TIMER_NAME(line) MBGL_FRAME_TIMER_NAME_(line)
+#define MBGL_FRAME_TIMER(duration) const ::mbgl::util::FrameTimer MBGL_FRAME_TIMER_NAME(__LINE__)(duration)
+#else
+#define MBGL_FRAME_TIMER(duration)
+#endif
@@ -1,6 +1,9 @@
 #include <mbgl/util/geometry_within.hpp>
 
+#include <mbgl/math/clamp.hpp>
+
 #include <algorithm>
+#include <cmath>
 
 namespace mbgl {
 
@@ -140,4 +143,107 @@ bool lineStringWithinPolygons(const LineString<int64_t>& line, const MultiPolygo
     }
     return false;
 }
+
+PolygonIndex::PolygonIndex(MultiPolygon<int64_t> polygons_) : polygons(std::move(polygons_)) {
+    std::size_t edges = 0;
+    for (const auto& polygon : polygons) {
+        for (const auto& ring : polygon) {
+            for (const auto& p : ring) {
+                updateBBox(bbox, p);
+            }
+            edges += ring.size();
+        }
+    }
+    if (edges == 0) return;
+
+    // About one edge per cell for simple polygons, and at most 128 * 128 cells for detailed ones.
+    gridSize = util::clamp<std::size_t>(static_cast<std::size_t>(std::sqrt(edges)), 1, 128);
+    cellWidth = (bbox[2] - bbox[0]) / static_cast<int64_t>(gridSize) + 1;
+    cellHeight = (bbox[3] - bbox[1]) / static_cast<int64_t>(gridSize) + 1;
+    cells.assign(gridSize * gridSize, Cell::Unknown);
+
+    for (const auto& polygon : polygons) {
+        for (const auto& ring : polygon) {
+            for (std::size_t i = 0; i + 1 < ring.size(); ++i) {
+                markEdge(ring[i], ring[i + 1]);
+            }
+        }
+    }
+    for (std::size_t i = 0; i < cells.size(); ++i) {
+        if (cells[i] == Cell::Unknown) classify(i);
+    }
+}
+
+// Marks the cells of every row that the edge crosses, including the lines between the cells.
+// The edge is widened by two units, which covers the rounding of the ray casting test.
+void PolygonIndex::markEdge(const Point<int64_t>& p1, const Point<int64_t>& p2) {
+    const auto cellX = [&](double x) {
+        return static_cast<int64_t>(std::floor((x - bbox[0]) / static_cast<double>(cellWidth)));
+    };
+    const auto lastCell = static_cast<int64_t>(gridSize) - 1;
+    const int64_t minY = std::min(p1.y, p2.y);
+    const int64_t maxY = std::max(p1.y, p2.y);
+    const int64_t firstRow = (minY - bbox[1]) / cellHeight;
+    const int64_t lastRow = (maxY - bbox[1]) / cellHeight;
+    for (int64_t row = firstRow; row <= lastRow; ++row) {
+        const auto y0 = static_cast<double>(std::max(minY, bbox[1] + row * cellHeight));
+        const auto y1 = static_cast<double>(std::min(maxY, bbox[1] + (row + 1) * cellHeight));
+        double x0 = p1.x;
+        double x1 = p2.x;
+        if (p1.y != p2.y) {
+            const double slope = static_cast<double>(p2.x - p1.x) / static_cast<double>(p2.y - p1.y);
+            x0 = p1.x + (y0 - p1.y) * slope;
+            x1 = p1.x + (y1 - p1.y) * slope;
+        }
+        const int64_t first = std::max<int64_t>(0, cellX(std::min(x0, x1) - 2));
+        const int64_t last = std::min(lastCell, cellX(std::max(x0, x1) + 2));
+        for (int64_t column = first; column <= last; ++column) {
+            cells[static_cast<std::size_t>(row) * gridSize + static_cast<std::size_t>(column)] = Cell::Edge;
+        }
+    }
+}
+
+// Neighbouring cells without edges are on the same side of every edge, so a flood fill classifies
+// all the cells of a region with a single ray casting test.
+void PolygonIndex::classify(std::size_t start) {
+    const auto column = static_cast<int64_t>(start % gridSize);
+    const auto row = static_cast<int64_t>(start / gridSize);
+    const Point<int64_t> sample(bbox[0] + column * cellWidth, bbox[1] + row * cellHeight);
+    const Cell side = pointWithinPolygons(sample, polygons) ? Cell::Inside : Cell::Outside;
+
+    std::vector<std::size_t> stack{start};
+    cells[start] = side;
+    while (!stack.empty()) {
+        const std::size_t i = stack.back();
+        stack.pop_back();
+        const std::size_t x = i % gridSize;
+        const std::size_t y = i / gridSize;
+        const auto visit = [&](std::size_t j) {
+            if (cells[j] == Cell::Unknown) {
+                cells[j] = side;
+                stack.push_back(j);
+            }
+        };
+        if (x > 0) visit(i - 1);
+        if (x + 1 < gridSize) visit(i + 1);
+        if (y > 0) visit(i - gridSize);
+        if (y + 1 < gridSize) visit(i + gridSize);
+    }
+}
+
+bool PolygonIndex::contains(const Point<int64_t>& point) const {
+    if (point.x < bbox[0] || point.x > bbox[2] || point.y < bbox[1] || point.y > bbox[3]) {
+        return false;
+    }
+    const auto column = static_cast<std::size_t>((point.x - bbox[0]) / cellWidth);
+    const auto row = static_cast<std::size_t>((point.y - bbox[1]) / cellHeight);
+    switch (cells[row * gridSize + column]) {
+        case Cell::Inside:
+            return true;
+        case Cell::Outside:
+            return false;
+        default:
+            return pointWithinPolygons(point, polygons);
+    }
+}
 } // namespace mbgl
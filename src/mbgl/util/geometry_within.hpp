@@ -1,7 +1,9 @@
 #pragma once
 
 #include <array>
+#include <cstdint>
 #include <limits>
+#include <vector>
 #include <mbgl/util/geometry.hpp>
 
 namespace mbgl {
@@ -26,4 +28,29 @@ bool lineStringWithinPolygon(const LineString<int64_t>& lineString, const Polygo
 
 bool lineStringWithinPolygons(const LineString<int64_t>& line, const MultiPolygon<int64_t>& polygons);
 
+// Polygons with a grid over their bounding box. The cells that no polygon edge crosses are known to
+// be entirely inside or outside of the polygons, so only the points in the cells along the edges
+// need the ray casting test.
+class PolygonIndex {
+public:
+    explicit PolygonIndex(MultiPolygon<int64_t> polygons);
+
+    // Same result as pointWithinPolygons(point, polygons).
+    bool contains(const Point<int64_t>& point) const;
+
+    const MultiPolygon<int64_t> polygons;
+    WithinBBox bbox = DefaultBBox;
+
+private:
+    enum class Cell : uint8_t { Unknown, Edge, Inside, Outside };
+
+    void markEdge(const Point<int64_t>& p1, const Point<int64_t>& p2);
+    void classify(std::size_t start);
+
+    std::size_t gridSize = 0;
+    int64_t cellWidth = 1;
+    int64_t cellHeight = 1;
+    std::vector<Cell> cells;
+};
+
 } // namespace mbgl
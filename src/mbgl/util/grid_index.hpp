@@ -2,12 +2,13 @@
 
 #include <mapbox/geometry/point.hpp>
 #include <mapbox/geometry/box.hpp>
-#include <mbgl/util/optional.hpp>
+#include <mbgl/math/minmax.hpp>
 
+#include <cmath>
 #include <cstdint>
 #include <cstddef>
+#include <limits>
 #include <vector>
-#include <functional>
 
 namespace mbgl {
 
@@ -51,6 +52,10 @@ constexpr bool operator!=(circle<T> const& lhs, circle<T> const& rhs)
  at least one cell. As long as the geometries are relatively
  uniformly distributed across the plane, this greatly reduces
  the number of comparisons necessary.
+ The cells don't own any storage: the entries of all cells live in
+ two flat arrays and each cell links the entries it holds, together
+ with a copy of their geometry, so that neither inserting nor
+ querying allocates per cell.
 */
 
 template <class T>
@@ -63,29 +68,83 @@ public:
 
     void insert(T&& t, const BBox&);
     void insert(T&& t, const BCircle&);
+
+    // Inserts all elements of another index with the same dimensions.
+    void insert(const GridIndex&);
+
+    // Removes all elements, but keeps the memory around for the next round of insertions.
+    void clear();
     
     std::vector<T> query(const BBox&) const;
     std::vector<std::pair<T,BBox>> queryWithBoxes(const BBox&) const;
+
+    // Calls `visitor(const T&, const BBox&)` once for every element intersecting the query
+    // geometry, until it returns true. Circles are reported with their bounding box.
+    template <class Visitor>
+    void query(const BBox&, Visitor&&) const;
+    template <class Visitor>
+    void query(const BCircle&, Visitor&&) const;
+
+    // Calls `visitor(const T&, const BBox&)` for every box and `visitor(const T&, const BCircle&)`
+    // for every circle, in insertion order.
+    template <class Visitor>
+    void forEach(Visitor&&) const;
     
-    bool hitTest(const BBox&, optional<std::function<bool(const T&)>> predicate = nullopt) const;
-    bool hitTest(const BCircle&, optional<std::function<bool(const T&)>> predicate = nullopt) const;
+    bool hitTest(const BBox&) const;
+    bool hitTest(const BCircle&) const;
+
+    // Only elements for which `predicate(const T&)` returns true count as a hit.
+    template <class Predicate>
+    bool hitTest(const BBox&, const Predicate&) const;
+    template <class Predicate>
+    bool hitTest(const BCircle&, const Predicate&) const;
+
+    // The number of cells a query for the geometry looks into.
+    std::size_t cellCount(const BBox&) const;
+    std::size_t cellCount(const BCircle&) const;
     
     bool empty() const;
 
 private:
+    static constexpr uint32_t none = std::numeric_limits<uint32_t>::max();
+
+    struct BoxEntry {
+        BBox bbox;
+        uint32_t uid;
+        uint32_t next;
+    };
+
+    struct CircleEntry {
+        BCircle circle;
+        uint32_t uid;
+        uint32_t next;
+    };
+
+    // Heads and tails of the entry lists, which are kept in insertion order.
+    struct Cell {
+        uint32_t firstBox = none;
+        uint32_t lastBox = none;
+        uint32_t firstCircle = none;
+        uint32_t lastCircle = none;
+    };
+
     bool noIntersection(const BBox& queryBBox) const;
     bool completeIntersection(const BBox& queryBBox) const;
     BBox convertToBox(const BCircle& circle) const;
 
-    void query(const BBox&, std::function<bool (const T&, const BBox&)>) const;
-    void query(const BCircle&, std::function<bool (const T&, const BBox&)>) const;
+    template <class Visitor>
+    void queryAll(Visitor&) const;
+
+    // An element spanning several cells is only reported from the first of its cells that is
+    // visited by a query starting at (cx1, cy1), which makes the queries free of bookkeeping.
+    bool isFirstCell(const BBox&, std::size_t x, std::size_t y, std::size_t cx1, std::size_t cy1) const;
 
     std::size_t convertToXCellCoord(float x) const;
     std::size_t convertToYCellCoord(float y) const;
 
-    bool boxesCollide(const BBox&, const BBox&) const;
-    bool circlesCollide(const BCircle&, const BCircle&) const;
-    bool circleAndBoxCollide(const BCircle&, const BBox&) const;
+    static bool boxesCollide(const BBox&, const BBox&);
+    static bool circlesCollide(const BCircle&, const BCircle&);
+    static bool circleAndBoxCollide(const BCircle&, const BBox&);
 
     const float width;
     const float height;
@@ -98,9 +157,201 @@ private:
     std::vector<std::pair<T, BBox>> boxElements;
     std::vector<std::pair<T, BCircle>> circleElements;
     
-    std::vector<std::vector<size_t>> boxCells;
-    std::vector<std::vector<size_t>> circleCells;
-
+    std::vector<Cell> cells;
+    std::vector<BoxEntry> boxEntries;
+    std::vector<CircleEntry> circleEntries;
 };
 
+template <class T>
+template <class Visitor>
+void GridIndex<T>::query(const BBox& queryBBox, Visitor&& visitor) const {
+    if (noIntersection(queryBBox)) {
+        return;
+    } else if (completeIntersection(queryBBox)) {
+        queryAll(visitor);
+        return;
+    }
+
+    const auto cx1 = convertToXCellCoord(queryBBox.min.x);
+    const auto cy1 = convertToYCellCoord(queryBBox.min.y);
+    const auto cx2 = convertToXCellCoord(queryBBox.max.x);
+    const auto cy2 = convertToYCellCoord(queryBBox.max.y);
+
+    for (std::size_t x = cx1; x <= cx2; ++x) {
+        for (std::size_t y = cy1; y <= cy2; ++y) {
+            const Cell& cell = cells[xCellCount * y + x];
+            // Look up other boxes
+            for (uint32_t i = cell.firstBox; i != none; i = boxEntries[i].next) {
+                const BoxEntry& entry = boxEntries[i];
+                if (boxesCollide(queryBBox, entry.bbox) && isFirstCell(entry.bbox, x, y, cx1, cy1)) {
+                    if (visitor(boxElements[entry.uid].first, entry.bbox)) {
+                        return;
+                    }
+                }
+            }
+
+            // Look up circles
+            for (uint32_t i = cell.firstCircle; i != none; i = circleEntries[i].next) {
+                const CircleEntry& entry = circleEntries[i];
+                if (circleAndBoxCollide(entry.circle, queryBBox)) {
+                    const BBox bbox = convertToBox(entry.circle);
+                    if (isFirstCell(bbox, x, y, cx1, cy1) && visitor(circleElements[entry.uid].first, bbox)) {
+                        return;
+                    }
+                }
+            }
+        }
+    }
+}
+
+template <class T>
+template <class Visitor>
+void GridIndex<T>::query(const BCircle& queryBCircle, Visitor&& visitor) const {
+    const BBox queryBBox = convertToBox(queryBCircle);
+    if (noIntersection(queryBBox)) {
+        return;
+    } else if (completeIntersection(queryBBox)) {
+        queryAll(visitor);
+        return;
+    }
+
+    const auto cx1 = convertToXCellCoord(queryBBox.min.x);
+    const auto cy1 = convertToYCellCoord(queryBBox.min.y);
+    const auto cx2 = convertToXCellCoord(queryBBox.max.x);
+    const auto cy2 = convertToYCellCoord(queryBBox.max.y);
+
+    for (std::size_t x = cx1; x <= cx2; ++x) {
+        for (std::size_t y = cy1; y <= cy2; ++y) {
+            const Cell& cell = cells[xCellCount * y + x];
+            // Look up boxes
+            for (uint32_t i = cell.firstBox; i != none; i = boxEntries[i].next) {
+                const BoxEntry& entry = boxEntries[i];
+                if (circleAndBoxCollide(queryBCircle, entry.bbox) && isFirstCell(entry.bbox, x, y, cx1, cy1)) {
+                    if (visitor(boxElements[entry.uid].first, entry.bbox)) {
+                        return;
+                    }
+                }
+            }
+
+            // Look up other circles
+            for (uint32_t i = cell.firstCircle; i != none; i = circleEntries[i].next) {
+                const CircleEntry& entry = circleEntries[i];
+                if (circlesCollide(queryBCircle, entry.circle)) {
+                    const BBox bbox = convertToBox(entry.circle);
+                    if (isFirstCell(bbox, x, y, cx1, cy1) && visitor(circleElements[entry.uid].first, bbox)) {
+                        return;
+                    }
+                }
+            }
+        }
+    }
+}
+
+template <class T>
+template <class Visitor>
+void GridIndex<T>::forEach(Visitor&& visitor) const {
+    for (auto& element : boxElements) {
+        visitor(element.first, element.second);
+    }
+    for (auto& element : circleElements) {
+        visitor(element.first, element.second);
+    }
+}
+
+template <class T>
+template <class Predicate>
+bool GridIndex<T>::hitTest(const BBox& queryBBox, const Predicate& predicate) const {
+    bool hit = false;
+    query(queryBBox, [&](const T& t, const BBox&) -> bool {
+        hit = predicate(t);
+        return hit;
+    });
+    return hit;
+}
+
+template <class T>
+template <class Predicate>
+bool GridIndex<T>::hitTest(const BCircle& queryBCircle, const Predicate& predicate) const {
+    bool hit = false;
+    query(queryBCircle, [&](const T& t, const BBox&) -> bool {
+        hit = predicate(t);
+        return hit;
+    });
+    return hit;
+}
+
+template <class T>
+template <class Visitor>
+void GridIndex<T>::queryAll(Visitor& visitor) const {
+    for (auto& element : boxElements) {
+        if (visitor(element.first, element.second)) {
+            return;
+        }
+    }
+    for (auto& element : circleElements) {
+        if (visitor(element.first, convertToBox(element.second))) {
+            return;
+        }
+    }
+}
+
+template <class T>
+inline typename GridIndex<T>::BBox GridIndex<T>::convertToBox(const BCircle& circle) const {
+    return BBox{{circle.center.x - circle.radius, circle.center.y - circle.radius},
+                {circle.center.x + circle.radius, circle.center.y + circle.radius}};
+}
+
+template <class T>
+inline bool GridIndex<T>::isFirstCell(
+    const BBox& bbox, const std::size_t x, const std::size_t y, const std::size_t cx1, const std::size_t cy1) const {
+    return util::max(convertToXCellCoord(bbox.min.x), cx1) == x && util::max(convertToYCellCoord(bbox.min.y), cy1) == y;
+}
+
+template <class T>
+inline std::size_t GridIndex<T>::convertToXCellCoord(const float x) const {
+    return util::max(0.0, util::min(xCellCount - 1.0, std::floor(x * xScale)));
+}
+
+template <class T>
+inline std::size_t GridIndex<T>::convertToYCellCoord(const float y) const {
+    return util::max(0.0, util::min(yCellCount - 1.0, std::floor(y * yScale)));
+}
+
+template <class T>
+inline bool GridIndex<T>::boxesCollide(const BBox& first, const BBox& second) {
+    return first.min.x <= second.max.x && first.min.y <= second.max.y && first.max.x >= second.min.x &&
+           first.max.y >= second.min.y;
+}
+
+template <class T>
+inline bool GridIndex<T>::circlesCollide(const BCircle& first, const BCircle& second) {
+    auto dx = second.center.x - first.center.x;
+    auto dy = second.center.y - first.center.y;
+    auto bothRadii = first.radius + second.radius;
+    return (bothRadii * bothRadii) > (dx * dx + dy * dy);
+}
+
+template <class T>
+inline bool GridIndex<T>::circleAndBoxCollide(const BCircle& circle, const BBox& box) {
+    auto halfRectWidth = (box.max.x - box.min.x) / 2;
+    auto distX = std::abs(circle.center.x - (box.min.x + halfRectWidth));
+    if (distX > (halfRectWidth + circle.radius)) {
+        return false;
+    }
+
+    auto halfRectHeight = (box.max.y - box.min.y) / 2;
+    auto distY = std::abs(circle.center.y - (box.min.y + halfRectHeight));
+    if (distY > (halfRectHeight + circle.radius)) {
+        return false;
+    }
+
+    if (distX <= halfRectWidth || distY <= halfRectHeight) {
+        return true;
+    }
+
+    auto dx = distX - halfRectWidth;
+    auto dy = distY - halfRectHeight;
+    return (dx * dx + dy * dy) <= (circle.radius * circle.radius);
+}
+
 } // namespace mbgl
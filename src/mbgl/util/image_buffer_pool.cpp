@@ -0,0 +1,60 @@
+#include <mbgl/util/image_buffer_pool.hpp>
+
+namespace mbgl {
+namespace util {
+
+ImageBufferPool::ImageBufferPool(std::size_t maximumSize_) : maximumSize(maximumSize_) {}
+
+PremultipliedImage ImageBufferPool::acquire(Size imageSize) {
+    const std::size_t bytes = std::size_t(imageSize.width) * imageSize.height * 4;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = buffers.find(bytes);
+        if (it != buffers.end()) {
+            std::unique_ptr<uint8_t[]> buffer = std::move(it->second.back());
+            it->second.pop_back();
+            if (it->second.empty()) {
+                buffers.erase(it);
+            }
+            size -= bytes;
+            return { imageSize, std::move(buffer) };
+        }
+    }
+    return PremultipliedImage(imageSize);
+}
+
+void ImageBufferPool::release(PremultipliedImage&& image) {
+    if (!image.valid()) {
+        return;
+    }
+
+    const std::size_t bytes = image.bytes();
+    std::lock_guard<std::mutex> lock(mutex);
+    if (size + bytes > maximumSize) {
+        return;
+    }
+    buffers[bytes].push_back(std::move(image.data));
+    image.size = {};
+    size += bytes;
+}
+
+void ImageBufferPool::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    buffers.clear();
+    size = 0;
+}
+
+std::size_t ImageBufferPool::getSize() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return size;
+}
+
+ImageBufferPool& rasterImageBufferPool() {
+    // Enough for a screen of 512px raster tiles on a large display. Intentionally leaked: tile
+    // workers may still be parsing while static destructors run.
+    static auto* pool = new ImageBufferPool(32 * 1024 * 1024);
+    return *pool;
+}
+
+} // namespace util
+} // namespace mbgl
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <mbgl/util/image.hpp>
+#include <mbgl/util/noncopyable.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace mbgl {
+namespace util {
+
+// Keeps the pixel buffers of decoded images that are no longer needed, so that images of the same
+// size reuse them instead of allocating new ones. The buffers are grouped by their size in bytes,
+// since the tiles of a source all decode to the same size. Buffers released past the maximum size
+// are freed. Thread-safe.
+class ImageBufferPool : private util::noncopyable {
+public:
+    explicit ImageBufferPool(std::size_t maximumSize);
+
+    // An image of the given size, in a buffer released before if there is one. The values of its
+    // pixels are unspecified.
+    PremultipliedImage acquire(Size);
+    void release(PremultipliedImage&&);
+
+    // Frees the buffers kept.
+    void clear();
+    // The bytes of the buffers kept.
+    std::size_t getSize() const;
+
+private:
+    mutable std::mutex mutex;
+    const std::size_t maximumSize;
+    std::size_t size = 0;
+    std::unordered_map<std::size_t, std::vector<std::unique_ptr<uint8_t[]>>> buffers;
+};
+
+// The pool shared by the raster tile workers of the whole process, from which the buckets release
+// their images once they are uploaded.
+ImageBufferPool& rasterImageBufferPool();
+
+} // namespace util
+
+// Decodes into a buffer of the pool when the platform decoder supports it.
+PremultipliedImage decodeImage(const std::string&, util::ImageBufferPool&);
+
+} // namespace mbgl
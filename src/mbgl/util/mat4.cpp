@@ -24,10 +24,52 @@
 
 #include <cmath>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
 namespace mbgl {
 
 namespace matrix {
 
+namespace {
+
+// Two doubles, in a vector register where the platform has double precision vector instructions.
+#if defined(__SSE2__)
+
+using Lanes = __m128d;
+inline Lanes load(const double* p) { return _mm_loadu_pd(p); }
+inline void store(double* p, Lanes v) { _mm_storeu_pd(p, v); }
+inline Lanes splat(double v) { return _mm_set1_pd(v); }
+inline Lanes mul(Lanes a, Lanes b) { return _mm_mul_pd(a, b); }
+inline Lanes add(Lanes a, Lanes b) { return _mm_add_pd(a, b); }
+
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+
+using Lanes = float64x2_t;
+inline Lanes load(const double* p) { return vld1q_f64(p); }
+inline void store(double* p, Lanes v) { vst1q_f64(p, v); }
+inline Lanes splat(double v) { return vdupq_n_f64(v); }
+inline Lanes mul(Lanes a, Lanes b) { return vmulq_f64(a, b); }
+inline Lanes add(Lanes a, Lanes b) { return vaddq_f64(a, b); }
+
+#else
+
+struct Lanes {
+    double v0, v1;
+};
+inline Lanes load(const double* p) { return { p[0], p[1] }; }
+inline void store(double* p, Lanes v) { p[0] = v.v0; p[1] = v.v1; }
+inline Lanes splat(double v) { return { v, v }; }
+inline Lanes mul(Lanes a, Lanes b) { return { a.v0 * b.v0, a.v1 * b.v1 }; }
+inline Lanes add(Lanes a, Lanes b) { return { a.v0 + b.v0, a.v1 + b.v1 }; }
+
+#endif
+
+} // namespace
+
 void identity(mat4& out) {
     out[0] = 1.0f;
     out[1] = 0.0f;
@@ -322,62 +364,40 @@ void scale(mat4& out, const mat4& a, double x, double y, double z) {
     out[15] = a[15];
 }
 
+// Matrices are column-major, so each column of the product is a sum of the columns of `a` scaled by
+// the elements of a column of `b`. The kernels work on the halves of columns in pairs of doubles,
+// and add up the products in the same order as the scalar code, so the results are identical.
 void multiply(mat4& out, const mat4& a, const mat4& b) {
-    double a00 = a[0];
-    double a01 = a[1];
-    double a02 = a[2];
-    double a03 = a[3];
-    double a10 = a[4];
-    double a11 = a[5];
-    double a12 = a[6];
-    double a13 = a[7];
-    double a20 = a[8];
-    double a21 = a[9];
-    double a22 = a[10];
-    double a23 = a[11];
-    double a30 = a[12];
-    double a31 = a[13];
-    double a32 = a[14];
-    double a33 = a[15];
+    // Load all of `a` first, `out` may be the same matrix as `a` or `b`.
+    Lanes low[4];
+    Lanes high[4];
+    for (int k = 0; k < 4; k++) {
+        low[k] = load(&a[k * 4]);
+        high[k] = load(&a[k * 4 + 2]);
+    }
 
-    // Cache only the current line of the second matrix
-    double b0 = b[0];
-    double b1 = b[1];
-    double b2 = b[2];
-    double b3 = b[3];
-    out[0] = b0 * a00 + b1 * a10 + b2 * a20 + b3 * a30;
-    out[1] = b0 * a01 + b1 * a11 + b2 * a21 + b3 * a31;
-    out[2] = b0 * a02 + b1 * a12 + b2 * a22 + b3 * a32;
-    out[3] = b0 * a03 + b1 * a13 + b2 * a23 + b3 * a33;
-
-    b0 = b[4]; b1 = b[5]; b2 = b[6]; b3 = b[7];
-    out[4] = b0 * a00 + b1 * a10 + b2 * a20 + b3 * a30;
-    out[5] = b0 * a01 + b1 * a11 + b2 * a21 + b3 * a31;
-    out[6] = b0 * a02 + b1 * a12 + b2 * a22 + b3 * a32;
-    out[7] = b0 * a03 + b1 * a13 + b2 * a23 + b3 * a33;
-
-    b0 = b[8]; b1 = b[9]; b2 = b[10]; b3 = b[11];
-    out[8] = b0 * a00 + b1 * a10 + b2 * a20 + b3 * a30;
-    out[9] = b0 * a01 + b1 * a11 + b2 * a21 + b3 * a31;
-    out[10] = b0 * a02 + b1 * a12 + b2 * a22 + b3 * a32;
-    out[11] = b0 * a03 + b1 * a13 + b2 * a23 + b3 * a33;
-
-    b0 = b[12]; b1 = b[13]; b2 = b[14]; b3 = b[15];
-    out[12] = b0 * a00 + b1 * a10 + b2 * a20 + b3 * a30;
-    out[13] = b0 * a01 + b1 * a11 + b2 * a21 + b3 * a31;
-    out[14] = b0 * a02 + b1 * a12 + b2 * a22 + b3 * a32;
-    out[15] = b0 * a03 + b1 * a13 + b2 * a23 + b3 * a33;
+    for (int j = 0; j < 4; j++) {
+        const Lanes b0 = splat(b[j * 4]);
+        const Lanes b1 = splat(b[j * 4 + 1]);
+        const Lanes b2 = splat(b[j * 4 + 2]);
+        const Lanes b3 = splat(b[j * 4 + 3]);
+        store(&out[j * 4], add(add(add(mul(b0, low[0]), mul(b1, low[1])), mul(b2, low[2])), mul(b3, low[3])));
+        store(&out[j * 4 + 2],
+              add(add(add(mul(b0, high[0]), mul(b1, high[1])), mul(b2, high[2])), mul(b3, high[3])));
+    }
 }
 
 void transformMat4(vec4& out, const vec4& a, const mat4& m) {
-    double x = a[0];
-    double y = a[1];
-    double z = a[2];
-    double w = a[3];
-    out[0] = m[0] * x + m[4] * y + m[8] * z + m[12] * w;
-    out[1] = m[1] * x + m[5] * y + m[9] * z + m[13] * w;
-    out[2] = m[2] * x + m[6] * y + m[10] * z + m[14] * w;
-    out[3] = m[3] * x + m[7] * y + m[11] * z + m[15] * w;
+    const Lanes x = splat(a[0]);
+    const Lanes y = splat(a[1]);
+    const Lanes z = splat(a[2]);
+    const Lanes w = splat(a[3]);
+    const Lanes low =
+        add(add(add(mul(load(&m[0]), x), mul(load(&m[4]), y)), mul(load(&m[8]), z)), mul(load(&m[12]), w));
+    const Lanes high =
+        add(add(add(mul(load(&m[2]), x), mul(load(&m[6]), y)), mul(load(&m[10]), z)), mul(load(&m[14]), w));
+    store(&out[0], low);
+    store(&out[2], high);
 }
 
 } // namespace matrix
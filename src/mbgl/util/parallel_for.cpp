@@ -0,0 +1,91 @@
+#include <mbgl/util/parallel_for.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+
+namespace mbgl {
+namespace util {
+
+namespace {
+
+// Shared with the helpers, which may start after parallelFor() returned.
+class ParallelFor {
+public:
+    ParallelFor(std::size_t count_, const std::function<void(std::size_t)>& fn_) : count(count_), fn(fn_) {}
+
+    void run() {
+        while (true) {
+            const std::size_t index = next++;
+            // Helpers that start after all the indices were claimed must not touch anything
+            // but the counter: `fn` may already be gone.
+            if (index >= count) return;
+            std::exception_ptr exception;
+            try {
+                fn(index);
+            } catch (...) {
+                exception = std::current_exception();
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            if (exception && !error) {
+                error = std::move(exception);
+            }
+            if (++completed == count) {
+                cv.notify_all();
+            }
+        }
+    }
+
+    // Rethrows the first exception that `fn` threw, once all the indices are done.
+    void wait() {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [this] { return completed == count; });
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+private:
+    const std::size_t count;
+    const std::function<void(std::size_t)>& fn;
+    std::atomic<std::size_t> next{0u};
+    std::size_t completed = 0u;
+    std::exception_ptr error;
+    std::mutex mutex;
+    std::condition_variable cv;
+};
+
+} // namespace
+
+void parallelFor(std::size_t count,
+                 TaskTag tag,
+                 TaskPriority priority,
+                 const std::function<void(std::size_t)>& fn,
+                 std::size_t minPerThread) {
+    std::shared_ptr<Scheduler> scheduler;
+    std::size_t threadCount = count / std::max<std::size_t>(minPerThread, 1u);
+    if (threadCount > 1u) {
+        scheduler = Scheduler::GetBackground();
+        threadCount = std::min(threadCount, scheduler->threadCount());
+    }
+
+    if (threadCount < 2u) {
+        for (std::size_t i = 0u; i < count; ++i) {
+            fn(i);
+        }
+        return;
+    }
+
+    auto state = std::make_shared<ParallelFor>(count, fn);
+    for (std::size_t i = 1u; i < threadCount; ++i) {
+        scheduler->scheduleTagged(tag, priority, [state] { state->run(); });
+    }
+    state->run();
+    state->wait();
+}
+
+} // namespace util
+} // namespace mbgl
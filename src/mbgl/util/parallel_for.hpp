@@ -0,0 +1,30 @@
+#pragma once
+
+#include <mbgl/actor/scheduler.hpp>
+
+#include <cstddef>
+#include <functional>
+
+namespace mbgl {
+namespace util {
+
+// Calls `fn` with every index from 0 to `count` - 1 and returns once all the calls are done. The
+// calling thread takes part in the work, the other indices are claimed by helper tasks posted to
+// the background scheduler with the given tag and priority. At most as many threads as the
+// scheduler has work on the indices, and only one per `minPerThread` indices; with fewer than two
+// threads, everything runs on the calling thread.
+//
+// The calling thread only waits for the indices claimed by helpers, so it never waits for a helper
+// that has not started yet, and this may be called from a task of the background scheduler itself.
+// `fn` may be called concurrently, and must not be used after this returns.
+//
+// If `fn` throws, the first exception is rethrown on the calling thread once no call is running
+// anymore. Whether the remaining indices are still called is unspecified.
+void parallelFor(std::size_t count,
+                 TaskTag,
+                 TaskPriority,
+                 const std::function<void(std::size_t)>& fn,
+                 std::size_t minPerThread = 1u);
+
+} // namespace util
+} // namespace mbgl
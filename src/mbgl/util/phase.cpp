@@ -0,0 +1,25 @@
+#include <mbgl/util/phase.hpp>
+
+namespace mbgl {
+namespace util {
+
+namespace {
+
+thread_local const char* currentPhase = nullptr;
+
+} // namespace
+
+const char* Phase::current() {
+    return currentPhase;
+}
+
+Phase::Scope::Scope(const char* phase) : previous(currentPhase) {
+    currentPhase = phase;
+}
+
+Phase::Scope::~Scope() {
+    currentPhase = previous;
+}
+
+} // namespace util
+} // namespace mbgl
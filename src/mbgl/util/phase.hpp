@@ -0,0 +1,28 @@
+#pragma once
+
+#include <mbgl/util/noncopyable.hpp>
+
+namespace mbgl {
+namespace util {
+
+// Names the stage of the pipeline the current thread is working on ("parse", "layout",
+// "placement" or "upload"), so that profilers like the allocation index of the render test
+// runner can attribute their samples to it. Phases nest, and the innermost one applies.
+class Phase {
+public:
+    // Null outside of any phase.
+    static const char* current();
+
+    class Scope : private util::noncopyable {
+    public:
+        // `phase` must be a string literal.
+        explicit Scope(const char* phase);
+        ~Scope();
+
+    private:
+        const char* const previous;
+    };
+};
+
+} // namespace util
+} // namespace mbgl
@@ -2,18 +2,21 @@
 
 #include <cmath>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
 namespace mbgl {
 namespace util {
 
-PremultipliedImage premultiply(UnassociatedImage&& src) {
-    PremultipliedImage dst;
-
-    dst.size = src.size;
-    src.size = { 0, 0 };
-    dst.data = std::move(src.data);
+namespace {
 
-    uint8_t* data = dst.data.get();
-    for (size_t i = 0; i < dst.bytes(); i += 4) {
+// The vector kernels compute (x * a + 127) / 255 as (t + (t >> 8)) >> 8 with t = x * a + 128,
+// which gives the same result for every 8-bit x and a.
+void premultiplyScalar(uint8_t* data, std::size_t count) {
+    for (size_t i = 0; i < count * 4; i += 4) {
         uint8_t& r = data[i + 0];
         uint8_t& g = data[i + 1];
         uint8_t& b = data[i + 2];
@@ -22,6 +25,75 @@ PremultipliedImage premultiply(UnassociatedImage&& src) {
         g = (g * a + 127) / 255;
         b = (b * a + 127) / 255;
     }
+}
+
+#if defined(__SSE2__)
+
+// Premultiplies the 2 pixels in the 16-bit lanes of `pixels`, the alpha lanes are multiplied by
+// 255 so that they are kept.
+inline __m128i premultiplySSE2(__m128i pixels, __m128i alphaMask) {
+    __m128i alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(pixels, 0xFF), 0xFF);
+    alpha = _mm_or_si128(_mm_andnot_si128(alphaMask, alpha), _mm_and_si128(alphaMask, _mm_set1_epi16(255)));
+    const __m128i t = _mm_add_epi16(_mm_mullo_epi16(pixels, alpha), _mm_set1_epi16(128));
+    return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+}
+
+std::size_t premultiplyVector(uint8_t* data, std::size_t count) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i alphaMask = _mm_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0);
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i* block = reinterpret_cast<__m128i*>(data + i * 4);
+        const __m128i pixels = _mm_loadu_si128(block);
+        const __m128i low = premultiplySSE2(_mm_unpacklo_epi8(pixels, zero), alphaMask);
+        const __m128i high = premultiplySSE2(_mm_unpackhi_epi8(pixels, zero), alphaMask);
+        _mm_storeu_si128(block, _mm_packus_epi16(low, high));
+    }
+    return i;
+}
+
+#elif defined(__ARM_NEON)
+
+inline uint8x8_t premultiplyNEON(uint8x8_t channel, uint8x8_t alpha) {
+    const uint16x8_t product = vmull_u8(channel, alpha);
+    return vraddhn_u16(product, vrshrq_n_u16(product, 8));
+}
+
+std::size_t premultiplyVector(uint8_t* data, std::size_t count) {
+    std::size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        uint8x8x4_t pixels = vld4_u8(data + i * 4);
+        pixels.val[0] = premultiplyNEON(pixels.val[0], pixels.val[3]);
+        pixels.val[1] = premultiplyNEON(pixels.val[1], pixels.val[3]);
+        pixels.val[2] = premultiplyNEON(pixels.val[2], pixels.val[3]);
+        vst4_u8(data + i * 4, pixels);
+    }
+    return i;
+}
+
+#else
+
+std::size_t premultiplyVector(uint8_t*, std::size_t) {
+    return 0;
+}
+
+#endif
+
+} // namespace
+
+void premultiplyPixels(uint8_t* data, std::size_t count) {
+    const std::size_t done = premultiplyVector(data, count);
+    premultiplyScalar(data + done * 4, count - done);
+}
+
+PremultipliedImage premultiply(UnassociatedImage&& src) {
+    PremultipliedImage dst;
+
+    dst.size = src.size;
+    src.size = { 0, 0 };
+    dst.data = std::move(src.data);
+
+    premultiplyPixels(dst.data.get(), dst.size.area());
 
     return dst;
 }
@@ -39,7 +111,8 @@ UnassociatedImage unpremultiply(PremultipliedImage&& src) {
         uint8_t& g = data[i + 1];
         uint8_t& b = data[i + 2];
         uint8_t& a = data[i + 3];
-        if (a) {
+        // Opaque pixels, the most common ones, are the same in both forms.
+        if (a && a != 255) {
             r = static_cast<uint8_t>((255 * r + (a / 2)) / a);
             g = static_cast<uint8_t>((255 * g + (a / 2)) / a);
             b = static_cast<uint8_t>((255 * b + (a / 2)) / a);
@@ -8,6 +8,11 @@ std::string formatJSONParseError(const JSDocument& doc) {
            util::toString(doc.GetErrorOffset());
 }
 
+std::string formatJSONParseError(const rapidjson::ParseResult& result) {
+    return std::string{ rapidjson::GetParseError_En(result.Code()) } + " at offset " +
+           util::toString(result.Offset());
+}
+
 } // namespace mbgl
 
 
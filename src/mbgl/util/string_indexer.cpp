@@ -0,0 +1,36 @@
+#include <mbgl/util/string_indexer.hpp>
+
+#include <cassert>
+
+namespace mbgl {
+namespace util {
+
+StringIdentity StringIndexer::get(const std::string& string) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = identities.find(string);
+    if (it == identities.end()) {
+        it = identities.emplace(string, strings.size()).first;
+        strings.push_back(&it->first);
+    }
+    return it->second;
+}
+
+const std::string& StringIndexer::get(StringIdentity identity) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    assert(identity < strings.size());
+    return *strings[identity];
+}
+
+std::size_t StringIndexer::size() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return strings.size();
+}
+
+StringIndexer& stringIndexer() {
+    // Intentionally leaked: tile workers may still be laying out while static destructors run.
+    static auto* indexer = new StringIndexer();
+    return *indexer;
+}
+
+} // namespace util
+} // namespace mbgl
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <mbgl/util/noncopyable.hpp>
+
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace mbgl {
+
+using StringIdentity = std::size_t;
+
+namespace util {
+
+// Gives strings that are used as keys over and over, such as layer IDs, an integer identity, so
+// that the maps keyed on them compare and hash integers instead. A string keeps its identity for
+// the lifetime of the process, and strings are never released. Thread-safe.
+class StringIndexer : private util::noncopyable {
+public:
+    StringIdentity get(const std::string&);
+    // The string of an identity handed out before.
+    const std::string& get(StringIdentity) const;
+    std::size_t size() const;
+
+private:
+    mutable std::mutex mutex;
+    std::unordered_map<std::string, StringIdentity> identities;
+    // Points to the keys of `identities`, which stay in place on rehashing.
+    std::vector<const std::string*> strings;
+};
+
+// The indexer shared by the whole process.
+StringIndexer& stringIndexer();
+
+} // namespace util
+} // namespace mbgl
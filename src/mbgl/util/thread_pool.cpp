@@ -5,8 +5,19 @@
 #include <mbgl/util/platform.hpp>
 #include <mbgl/util/string.hpp>
 
+#include <algorithm>
+#include <cassert>
+
 namespace mbgl {
 
+ThreadedSchedulerBase::ThreadedSchedulerBase(std::size_t workerCount) {
+    assert(workerCount > 0u);
+    workers.reserve(workerCount);
+    for (std::size_t i = 0u; i < workerCount; ++i) {
+        workers.emplace_back(std::make_unique<Worker>());
+    }
+}
+
 ThreadedSchedulerBase::~ThreadedSchedulerBase() = default;
 
 void ThreadedSchedulerBase::terminate() {
@@ -17,43 +28,184 @@ void ThreadedSchedulerBase::terminate() {
     cv.notify_all();
 }
 
-std::thread ThreadedSchedulerBase::makeSchedulerThread(size_t index) {
-    return std::thread([this, index] {
-        auto& settings = platform::Settings::getInstance();
-        auto value = settings.get(platform::EXPERIMENTAL_THREAD_PRIORITY_WORKER);
-        if (auto* priority = value.getDouble()) {
+bool ThreadedSchedulerBase::pop(std::size_t index, Task& task) {
+    for (std::size_t priority = 0u; priority < workers[index]->queues.size(); ++priority) {
+        {
+            Worker& own = *workers[index];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            auto& queue = own.queues[priority];
+            if (!queue.empty()) {
+                task = std::move(queue.front());
+                queue.pop_front();
+                --pending;
+                return true;
+            }
+        }
+
+        // Steal from the back of the other workers' queues, so that the victim keeps
+        // processing its oldest tasks first.
+        for (std::size_t i = 1u; i < workers.size(); ++i) {
+            Worker& victim = *workers[(index + i) % workers.size()];
+            std::unique_lock<std::mutex> lock(victim.mutex, std::try_to_lock);
+            if (!lock.owns_lock()) continue;
+            auto& queue = victim.queues[priority];
+            if (!queue.empty()) {
+                task = std::move(queue.back());
+                queue.pop_back();
+                --pending;
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+void ThreadedSchedulerBase::run(Task& task) {
+    const TimePoint start = Clock::now();
+    Scheduler::SetCurrentPriority(task.priority);
+    if (task.fn) task.fn();
+    Scheduler::SetCurrentPriority(TaskPriority::Default);
+    const TimePoint end = Clock::now();
+
+    TagCounters& tagCounters = counters[static_cast<std::size_t>(task.tag)];
+    tagCounters.count.fetch_add(1u, std::memory_order_relaxed);
+    tagCounters.waitTime.fetch_add((start - task.scheduled).count(), std::memory_order_relaxed);
+    tagCounters.runTime.fetch_add((end - start).count(), std::memory_order_relaxed);
+}
+
+TaskStatistics ThreadedSchedulerBase::getTaskStatistics(TaskTag tag) const {
+    const TagCounters& tagCounters = counters[static_cast<std::size_t>(tag)];
+    TaskStatistics statistics;
+    statistics.count = tagCounters.count.load(std::memory_order_relaxed);
+    statistics.waitTime = Duration(tagCounters.waitTime.load(std::memory_order_relaxed));
+    statistics.runTime = Duration(tagCounters.runTime.load(std::memory_order_relaxed));
+    return statistics;
+}
+
+void ThreadedSchedulerBase::setWorkerBackground(std::weak_ptr<Scheduler> scheduler) {
+    workerBackground = std::move(scheduler);
+}
+
+std::thread ThreadedSchedulerBase::makeSchedulerThread(size_t index, const ThreadPoolOptions& options) {
+    return std::thread([this, index, priority = options.priority, cpus = options.cpus] {
+        if (priority) {
             platform::setCurrentThreadPriority(*priority);
         }
+        if (cpus) {
+            platform::setCurrentThreadAffinity(*cpus);
+        }
 
         platform::setCurrentThreadName(std::string{"Worker "} + util::toString(index + 1));
         platform::attachThread();
+        currentWorker.set(workers[index].get());
 
+        bool backgroundSet = false;
         while (true) {
-            std::unique_lock<std::mutex> lock(mutex);
+            Task task;
+            if (!terminated && pop(index, task)) {
+                // Read once a task was scheduled, which happens after setWorkerBackground().
+                if (!backgroundSet) {
+                    Scheduler::SetBackground(workerBackground);
+                    backgroundSet = true;
+                }
+                run(task);
+                continue;
+            }
 
-            cv.wait(lock, [this] { return !queue.empty() || terminated; });
+            std::unique_lock<std::mutex> lock(mutex);
+            ++sleeping;
+            cv.wait(lock, [this] { return pending > 0u || terminated; });
+            --sleeping;
 
             if (terminated) {
+                currentWorker.set(nullptr);
                 platform::detachThread();
                 return;
             }
-
-            auto function = std::move(queue.front());
-            queue.pop();
-            lock.unlock();
-            if (function) function();
         }
     });
 }
 
 void ThreadedSchedulerBase::schedule(std::function<void()> fn) {
+    scheduleWithPriority(TaskPriority::Default, std::move(fn));
+}
+
+void ThreadedSchedulerBase::scheduleWithPriority(TaskPriority priority, std::function<void()> fn) {
+    scheduleTagged(TaskTag::Untagged, priority, std::move(fn));
+}
+
+void ThreadedSchedulerBase::scheduleTagged(TaskTag tag, TaskPriority priority, std::function<void()> fn) {
     assert(fn);
+    Worker* worker = currentWorker.get();
+    if (!worker) {
+        worker = workers[nextWorker++ % workers.size()].get();
+    }
+
+    // Count the task before it becomes visible, so that a worker stealing it cannot
+    // observe the counter going below zero.
+    ++pending;
     {
+        std::lock_guard<std::mutex> lock(worker->mutex);
+        worker->queues[static_cast<std::size_t>(priority)].push_back({std::move(fn), tag, priority, Clock::now()});
+    }
+
+    if (sleeping > 0u) {
         std::lock_guard<std::mutex> lock(mutex);
-        queue.push(std::move(fn));
+        cv.notify_one();
+    }
+}
+
+ThreadedScheduler::ThreadedScheduler(std::size_t threadCount, ThreadPoolOptions options)
+    : ThreadedSchedulerBase(threadCount) {
+    auto& settings = platform::Settings::getInstance();
+    if (!options.priority) {
+        auto value = settings.get(platform::EXPERIMENTAL_THREAD_PRIORITY_WORKER);
+        if (auto* priority = value.getDouble()) options.priority = *priority;
+    }
+    if (!options.cpus) {
+        auto value = settings.get(platform::EXPERIMENTAL_WORKER_THREAD_AFFINITY);
+        if (auto* array = value.getArray()) {
+            options.cpus.emplace();
+            for (const auto& cpu : *array) {
+                if (auto* index = cpu.getUint()) options.cpus->push_back(static_cast<std::size_t>(*index));
+            }
+        }
+    }
+
+    threads.reserve(threadCount);
+    for (std::size_t i = 0u; i < threadCount; ++i) {
+        threads.emplace_back(makeSchedulerThread(i, options));
+    }
+}
+
+ThreadedScheduler::~ThreadedScheduler() {
+    terminate();
+    for (auto& thread : threads) {
+        assert(std::this_thread::get_id() != thread.get_id());
+        thread.join();
+    }
+}
+
+ThreadPool::ThreadPool() : ThreadPool(defaultThreadCount()) {}
+
+ThreadPool::ThreadPool(std::size_t threadCount) : ThreadedScheduler(threadCount) {}
+
+ThreadPool::ThreadPool(const ThreadPoolOptions& options)
+    : ThreadedScheduler(options.threadCount && *options.threadCount > 0u ? *options.threadCount : defaultThreadCount(),
+                        options) {}
+
+// static
+std::size_t ThreadPool::defaultThreadCount() {
+    auto value = platform::Settings::getInstance().get(platform::EXPERIMENTAL_WORKER_THREAD_COUNT);
+    if (auto* count = value.getUint()) {
+        if (*count > 0u) return static_cast<std::size_t>(*count);
     }
 
-    cv.notify_one();
+    // hardware_concurrency() may return 0 when the value is not computable,
+    // fall back to the previous fixed pool size in that case.
+    const std::size_t hardwareThreads = std::thread::hardware_concurrency();
+    return hardwareThreads > 0u ? hardwareThreads : 4u;
 }
 
 } // namespace mbgl
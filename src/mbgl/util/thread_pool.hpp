@@ -2,70 +2,133 @@
 
 #include <mbgl/actor/mailbox.hpp>
 #include <mbgl/actor/scheduler.hpp>
+#include <mbgl/util/thread_local.hpp>
 
 #include <array>
+#include <atomic>
 #include <condition_variable>
+#include <deque>
+#include <memory>
 #include <mutex>
-#include <queue>
 #include <thread>
+#include <vector>
 
 namespace mbgl {
 
+/**
+ * @brief ThreadedSchedulerBase keeps a separate task deque for each worker thread.
+ *
+ * Tasks scheduled from one of the scheduler's own workers are pushed to that worker's
+ * deque, tasks scheduled from other threads are distributed round-robin. A worker takes
+ * tasks from the front of its own deque and, once it runs dry, steals from the back of
+ * the other workers' deques, so that there is no single lock shared by all workers.
+ *
+ * Each worker keeps one deque per `TaskPriority`; a task is only picked if there are no
+ * tasks with a higher priority in the worker's own deques or in the ones it can steal from.
+ *
+ * While a task runs, `Scheduler::GetCurrentPriority()` returns its priority.
+ *
+ * The count, the queue wait time and the run time of the tasks are summed up per `TaskTag`.
+ */
 class ThreadedSchedulerBase : public Scheduler {
 public:
     void schedule(std::function<void()>) override;
+    void scheduleWithPriority(TaskPriority, std::function<void()>) override;
+    void scheduleTagged(TaskTag, TaskPriority, std::function<void()>) override;
+    TaskStatistics getTaskStatistics(TaskTag) const override;
+
+    // Makes `Scheduler::GetBackground()` return the given scheduler on the worker threads, usually
+    // this one. Must be called before any task is scheduled.
+    void setWorkerBackground(std::weak_ptr<Scheduler>);
 
 protected:
-    ThreadedSchedulerBase() = default;
+    explicit ThreadedSchedulerBase(std::size_t workerCount);
     ~ThreadedSchedulerBase() override;
 
     void terminate();
-    std::thread makeSchedulerThread(size_t index);
+    // The thread takes the priority and the CPUs of the options, if they are set.
+    std::thread makeSchedulerThread(size_t index, const ThreadPoolOptions&);
+
+private:
+    struct Task {
+        std::function<void()> fn;
+        TaskTag tag = TaskTag::Untagged;
+        TaskPriority priority = TaskPriority::Default;
+        TimePoint scheduled;
+    };
+
+    struct Worker {
+        std::mutex mutex;
+        std::array<std::deque<Task>, 3> queues;
+    };
+
+    // Durations are kept in ticks, so that they can be atomic.
+    struct TagCounters {
+        std::atomic<std::uint64_t> count{0u};
+        std::atomic<Duration::rep> waitTime{0};
+        std::atomic<Duration::rep> runTime{0};
+    };
+
+    bool pop(std::size_t index, Task& task);
+    void run(Task&);
+
+    std::array<TagCounters, TaskTagCount> counters;
+    std::weak_ptr<Scheduler> workerBackground;
+    std::vector<std::unique_ptr<Worker>> workers;
+    util::ThreadLocal<Worker> currentWorker;
+    std::atomic<std::size_t> nextWorker{0u};
+    std::atomic<std::size_t> pending{0u};
+    std::atomic<std::size_t> sleeping{0u};
 
-    std::queue<std::function<void()>> queue;
     std::mutex mutex;
     std::condition_variable cv;
-    bool terminated{false};
+    std::atomic<bool> terminated{false};
 };
 
 /**
  * @brief ThreadScheduler implements Scheduler interface using a lightweight event loop
  *
- * @tparam N number of threads
+ * The number of threads is given at construction time and must be more than zero.
  *
- * Note: If N == 1 all scheduled tasks are guaranteed to execute consequently;
- * otherwise, some of the scheduled tasks might be executed in parallel.
+ * Note: If the scheduler has one thread all scheduled tasks are guaranteed to execute
+ * consequently; otherwise, some of the scheduled tasks might be executed in parallel.
  */
-template <std::size_t N>
 class ThreadedScheduler : public ThreadedSchedulerBase {
 public:
-    ThreadedScheduler() {
-        for (std::size_t i = 0u; i < N; ++i) {
-            threads[i] = makeSchedulerThread(i);
-        }
-    }
-
-    ~ThreadedScheduler() override {
-        terminate();
-        for (auto& thread : threads) {
-            assert(std::this_thread::get_id() != thread.get_id());
-            thread.join();
-        }
-    }
+    // The options not given are taken from the platform settings; their thread count is ignored.
+    explicit ThreadedScheduler(std::size_t threadCount, ThreadPoolOptions = {});
+    ~ThreadedScheduler() override;
+
+    std::size_t threadCount() const override { return threads.size(); }
 
     mapbox::base::WeakPtr<Scheduler> makeWeakPtr() override { return weakFactory.makeWeakPtr(); }
 
 private:
-    std::array<std::thread, N> threads;
+    std::vector<std::thread> threads;
     mapbox::base::WeakPtrFactory<Scheduler> weakFactory{this};
-    static_assert(N > 0, "Thread count must be more than zero.");
 };
 
-class SequencedScheduler : public ThreadedScheduler<1> {};
+class SequencedScheduler : public ThreadedScheduler {
+public:
+    SequencedScheduler() : ThreadedScheduler(1u) {}
+};
 
 template <std::size_t extra>
-using ParallelScheduler = ThreadedScheduler<1 + extra>;
+class ParallelScheduler : public ThreadedScheduler {
+public:
+    ParallelScheduler() : ThreadedScheduler(1u + extra) {}
+};
 
-class ThreadPool : public ParallelScheduler<3> {};
+class ThreadPool : public ThreadedScheduler {
+public:
+    // Creates a pool with `defaultThreadCount()` threads.
+    ThreadPool();
+    explicit ThreadPool(std::size_t threadCount);
+    explicit ThreadPool(const ThreadPoolOptions&);
+
+    // Returns the value of the `EXPERIMENTAL_WORKER_THREAD_COUNT` platform setting
+    // if it is set to a positive number, otherwise the hardware concurrency.
+    static std::size_t defaultThreadCount();
+};
 
 } // namespace mbgl
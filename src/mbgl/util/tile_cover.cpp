@@ -8,6 +8,7 @@
 #include <mbgl/util/tile_cover_impl.hpp>
 
 #include <functional>
+#include <limits>
 #include <list>
 
 namespace mbgl {
@@ -147,7 +148,61 @@ int32_t coveringZoomLevel(double zoom, style::SourceType type, uint16_t size) {
     }
 }
 
+namespace {
+
+// The covers of the latest cameras, most recent first. Every source of a map asks for the same
+// covers in a frame, and a camera that doesn't move asks for them again in the next frames.
+class TileCoverCache {
+public:
+    static TileCoverCache& get() {
+        static thread_local TileCoverCache cache;
+        return cache;
+    }
+
+    const std::vector<OverscaledTileID>* find(const TransformState& state, uint8_t z, uint8_t overscaledZ) {
+        for (auto it = entries.begin(); it != entries.end(); ++it) {
+            if (it->z == z && it->overscaledZ == overscaledZ && it->size == state.getSize() &&
+                it->viewportMode == state.getViewportMode() && it->invProjMatrix == state.getInvProjectionMatrix()) {
+                entries.splice(entries.begin(), entries, it);
+                return &entries.front().tiles;
+            }
+        }
+        return nullptr;
+    }
+
+    void add(const TransformState& state, uint8_t z, uint8_t overscaledZ, std::vector<OverscaledTileID> tiles) {
+        entries.push_front(
+            {state.getInvProjectionMatrix(), state.getSize(), state.getViewportMode(), z, overscaledZ, std::move(tiles)});
+        if (entries.size() > maxEntries) {
+            entries.pop_back();
+        }
+    }
+
+private:
+    // The ideal, prefetch and transition target covers of a few frames.
+    static constexpr std::size_t maxEntries = 8;
+
+    struct Entry {
+        mat4 invProjMatrix;
+        Size size;
+        ViewportMode viewportMode;
+        uint8_t z;
+        uint8_t overscaledZ;
+        std::vector<OverscaledTileID> tiles;
+    };
+    std::list<Entry> entries;
+};
+
+} // namespace
+
 std::vector<OverscaledTileID> tileCover(const TransformState& state, uint8_t z, const optional<uint8_t>& overscaledZ) {
+    // The camera determines the cover through its inverse projection matrix, which includes the
+    // center, zoom, bearing, pitch and field of view, and the viewport.
+    auto& cache = TileCoverCache::get();
+    if (const auto* tiles = cache.find(state, z, overscaledZ.value_or(z))) {
+        return *tiles;
+    }
+
     struct Node {
         AABB aabb;
         uint8_t zoom;
@@ -163,7 +218,6 @@ std::vector<OverscaledTileID> tileCover(const TransformState& state, uint8_t z,
 
     const double numTiles = std::pow(2.0, z);
     const double worldSize = Projection::worldSize(state.getScale());
-    const uint8_t minZoom = state.getPitch() <= (60.0 / 180.0) * M_PI ? z : 0;
     const uint8_t maxZoom = z;
     const uint8_t overscaledZoom = overscaledZ.value_or(z);
     const bool flippedY = state.getViewportMode() == ViewportMode::FlippedY;
@@ -178,6 +232,32 @@ std::vector<OverscaledTileID> tileCover(const TransformState& state, uint8_t z,
     // There should always be a certain number of maximum zoom level tiles surrounding the center location
     const double radiusOfMaxLvlLodInTiles = 3;
 
+    // Tiles shrink on screen with their depth along the view direction. A tile deep enough that a lower
+    // zoom level tile shows as much detail per pixel as a maximum zoom level tile at the center of
+    // perspective is taken from that lower zoom level. The camera position follows from the projection,
+    // the perspective center and camera distance in tile units are known.
+    const double cameraToCenterDistance = state.getCameraToCenterDistance() / worldSize * numTiles;
+    const auto perspectiveCenter = TileCoordinate::fromLatLng(z, state.getLatLng(LatLng::Unwrapped)).p;
+    vec4 eye = {{0.0, 0.0, -1.0, 0.0}};
+    matrix::transformMat4(eye, eye, state.getInvProjectionMatrix());
+    // An axonometric projection has no camera position, and no perspective foreshortening either.
+    const bool lod = std::abs(eye[3]) > std::numeric_limits<double>::epsilon() && cameraToCenterDistance > 0;
+    const double eyeX = lod ? eye[0] / eye[3] / worldSize * numTiles : 0;
+    const double eyeY = lod ? eye[1] / eye[3] / worldSize * numTiles : 0;
+    const double cosPitch = std::cos(state.getPitch());
+
+    // With c the perspective center and e the camera, the depth of a ground point p is
+    // (p - e)·(c - e) / |camera to center| + |camera to center|·cos²(pitch). It's linear in p, so the
+    // least depth of a tile is at one of its corners.
+    const auto minDepth = [&](const AABB& aabb) {
+        const double viewX = perspectiveCenter.x - eyeX;
+        const double viewY = perspectiveCenter.y - eyeY;
+        const double x = viewX > 0 ? aabb.min[0] : aabb.max[0];
+        const double y = viewY > 0 ? aabb.min[1] : aabb.max[1];
+        return ((x - eyeX) * viewX + (y - eyeY) * viewY) / cameraToCenterDistance +
+               cameraToCenterDistance * cosPitch * cosPitch;
+    };
+
     const auto newRootTile = [&](int16_t wrap) -> Node {
         return {AABB({wrap * numTiles, 0.0, 0.0}, {(wrap + 1) * numTiles, numTiles, 0.0}),
                 uint8_t(0),
@@ -213,26 +293,26 @@ std::vector<OverscaledTileID> tileCover(const TransformState& state, uint8_t z,
             node.fullyVisible = intersection == IntersectionResult::Contains;
         }
 
-        const vec3 distanceXyz = node.aabb.distanceXYZ(centerCoord);
-        const double* longestDim = std::max_element(distanceXyz.data(), distanceXyz.data() + distanceXyz.size());
-        assert(longestDim);
+        // Have we reached the target depth or is the tile deep enough to not be split any further?
+        bool coarseEnough = false;
+        if (lod && node.zoom < maxZoom) {
+            const vec3 distanceXyz = node.aabb.distanceXYZ(centerCoord);
+            const double* longestDim = std::max_element(distanceXyz.data(), distanceXyz.data() + distanceXyz.size());
+            assert(longestDim);
 
-        // We're using distance based heuristics to determine if a tile should be split into quadrants or not.
-        // radiusOfMaxLvlLodInTiles defines that there's always a certain number of maxLevel tiles next to the map
-        // center. Using the fact that a parent node in quadtree is twice the size of its children (per dimension) we
-        // can define distance thresholds for each relative level: f(k) = offset + 2 + 4 + 8 + 16 + ... + 2^k. This is
-        // the same as "offset+2^(k+1)-2"
-        const double distToSplit = radiusOfMaxLvlLodInTiles + (1 << (maxZoom - node.zoom)) - 2;
+            const double nodeSizeInTiles = 1 << (maxZoom - node.zoom);
+            coarseEnough = *longestDim > radiusOfMaxLvlLodInTiles &&
+                           minDepth(node.aabb) >= nodeSizeInTiles * cameraToCenterDistance;
+        }
 
-        // Have we reached the target depth or is the tile too far away to be any split further?
-        if (node.zoom == maxZoom || (*longestDim > distToSplit && node.zoom >= minZoom)) {
+        if (node.zoom == maxZoom || coarseEnough) {
             // Perform precise intersection test between the frustum and aabb. This will cull < 1% false positives
             // missed by the original test
             if (node.fullyVisible || frustum.intersectsPrecise(node.aabb, true) != IntersectionResult::Separate) {
                 const OverscaledTileID id = {
                     node.zoom == maxZoom ? overscaledZoom : node.zoom, node.wrap, node.zoom, node.x, node.y};
-                const double dx = node.wrap * numTiles + node.x + 0.5 - centerCoord[0];
-                const double dy = node.y + 0.5 - centerCoord[1];
+                const double dx = (node.aabb.min[0] + node.aabb.max[0]) * 0.5 - centerCoord[0];
+                const double dy = (node.aabb.min[1] + node.aabb.max[1]) * 0.5 - centerCoord[1];
 
                 result.push_back({id, dx * dx + dy * dy});
             }
@@ -266,6 +346,7 @@ std::vector<OverscaledTileID> tileCover(const TransformState& state, uint8_t z,
         ids.push_back(tile.id);
     }
 
+    cache.add(state, z, overscaledZoom, ids);
     return ids;
 }
 
@@ -299,12 +380,18 @@ std::vector<UnwrappedTileID> tileCover(const Geometry<double>& geometry, uint8_t
     return result;
 }
 
+namespace {
+
+struct CoverRange {
+    int64_t minX, maxX, minY, maxY;
+};
+
 // Taken from https://github.com/mapbox/sphericalmercator#xyzbbox-zoom-tms_style-srs
-// Computes the projected tiles for the lower left and upper right points of the bounds
-// and uses that to compute the tile cover count
-uint64_t tileCount(const LatLngBounds& bounds, uint8_t zoom){
+// Computes the projected tiles for the lower left and upper right points of the bounds.
+// Ranges that wrap around are unwrapped, so that maxX may exceed the last tile.
+CoverRange coverRange(const LatLngBounds& bounds, uint8_t zoom) {
     if (zoom == 0) {
-        return 1;
+        return {0, 0, 0, 0};
     }
     auto sw = Projection::project(bounds.southwest(), zoom);
     auto ne = Projection::project(bounds.northeast(), zoom);
@@ -313,10 +400,17 @@ uint64_t tileCount(const LatLngBounds& bounds, uint8_t zoom){
     auto x2 = ceil(ne.x) - 1;
     auto y1 = util::clamp(floor(sw.y), 0.0, maxTile - 1);
     auto y2 = util::clamp(floor(ne.y), 0.0, maxTile - 1);
+    if (x1 > x2) {
+        x2 += maxTile;
+    }
+    return {static_cast<int64_t>(x1), static_cast<int64_t>(x2), static_cast<int64_t>(y2), static_cast<int64_t>(y1)};
+}
+
+} // namespace
 
-    auto dx = x1 > x2 ? (maxTile - x1) + x2 : x2 - x1;
-    auto dy = y1 - y2;
-    return (dx + 1) * (dy + 1);
+uint64_t tileCount(const LatLngBounds& bounds, uint8_t zoom){
+    const CoverRange range = coverRange(bounds, zoom);
+    return static_cast<uint64_t>(range.maxX - range.minX + 1) * static_cast<uint64_t>(range.maxY - range.minY + 1);
 }
 
 uint64_t tileCount(const Geometry<double>& geometry, uint8_t z) {
@@ -355,6 +449,62 @@ TileCover::TileCover(const Geometry<double>& geom, uint8_t z, bool project/* = t
 
 TileCover::~TileCover() = default;
 
+ZOrderTileCover::ZOrderTileCover(const LatLngBounds& bounds, uint8_t z_) : z(z_) {
+    const CoverRange range = coverRange(bounds, z);
+    minX = range.minX;
+    maxX = range.maxX;
+    minY = range.minY;
+    maxY = range.maxY;
+
+    // The root is aligned to the world grid, so that the quads are the tiles of lower zoom levels.
+    const int64_t worldSize = 1ll << z;
+    const int64_t originX = (minX < 0 ? minX - worldSize + 1 : minX) / worldSize * worldSize;
+    uint8_t level = z;
+    while ((1ll << level) <= maxX - originX) {
+        level++;
+    }
+    quads.push_back({originX, 0, level});
+    descend();
+}
+
+// Leaves the next tile on top of the stack, skipping the quads outside of the range.
+void ZOrderTileCover::descend() {
+    while (!quads.empty()) {
+        const Quad quad = quads.back();
+        const int64_t size = 1ll << quad.level;
+        if (quad.x > maxX || quad.x + size <= minX || quad.y > maxY || quad.y + size <= minY) {
+            quads.pop_back();
+            continue;
+        }
+        if (quad.level == 0) {
+            return;
+        }
+
+        // Pushes the children in reverse, so that they come off the stack in Z-order.
+        quads.pop_back();
+        const int64_t half = size / 2;
+        const auto level = static_cast<uint8_t>(quad.level - 1);
+        quads.push_back({quad.x + half, quad.y + half, level});
+        quads.push_back({quad.x, quad.y + half, level});
+        quads.push_back({quad.x + half, quad.y, level});
+        quads.push_back({quad.x, quad.y, level});
+    }
+}
+
+optional<UnwrappedTileID> ZOrderTileCover::next() {
+    if (quads.empty()) {
+        return nullopt;
+    }
+    const Quad tile = quads.back();
+    quads.pop_back();
+    descend();
+    return UnwrappedTileID(z, tile.x, tile.y);
+}
+
+bool ZOrderTileCover::hasNext() {
+    return !quads.empty();
+}
+
 optional<UnwrappedTileID> TileCover::next() {
     return impl->next();
 }
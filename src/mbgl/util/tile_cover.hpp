@@ -31,6 +31,31 @@ private:
     std::unique_ptr<Impl> impl;
 };
 
+// Streams the tiles of bounds in Z-order (Morton order), so that consecutive tiles stay close to
+// each other at every scale instead of running along rows. Yields exactly the tiles that
+// tileCount() counts, and the memory it needs only grows with the zoom level.
+class ZOrderTileCover {
+public:
+    ZOrderTileCover(const LatLngBounds&, uint8_t z);
+
+    optional<UnwrappedTileID> next();
+    bool hasNext();
+
+private:
+    // The square of 2^level tiles starting at x, y.
+    struct Quad {
+        int64_t x;
+        int64_t y;
+        uint8_t level;
+    };
+
+    void descend();
+
+    uint8_t z;
+    int64_t minX, maxX, minY, maxY;
+    std::vector<Quad> quads;
+};
+
 int32_t coveringZoomLevel(double z, style::SourceType type, uint16_t tileSize);
 
 std::vector<OverscaledTileID> tileCover(const TransformState&,
@@ -0,0 +1,92 @@
+#include <mbgl/util/tile_trace.hpp>
+#include <mbgl/util/chrono.hpp>
+#include <mbgl/util/string.hpp>
+
+#include <mutex>
+#include <vector>
+
+namespace mbgl {
+namespace util {
+
+namespace {
+
+struct Event {
+    TimePoint time;
+    OverscaledTileID id;
+    const char* step;
+    char phase;
+    uint32_t thread;
+};
+
+// Keeps memory bounded when a trace is never exported.
+constexpr std::size_t maxEvents = 1 << 20;
+
+std::mutex mutex;
+std::vector<Event> events;
+
+uint32_t currentThread() {
+    static std::atomic<uint32_t> nextThread{1};
+    thread_local const uint32_t thread = nextThread++;
+    return thread;
+}
+
+void record(const OverscaledTileID& id, const char* step, char phase) {
+    const TimePoint time = Clock::now();
+    const uint32_t thread = currentThread();
+    std::lock_guard<std::mutex> lock(mutex);
+    if (events.size() < maxEvents) {
+        events.push_back({time, id, step, phase, thread});
+    }
+}
+
+} // namespace
+
+std::atomic<bool> TileTrace::enabled{false};
+
+void TileTrace::setEnabled(bool enabled_) {
+    enabled = enabled_;
+}
+
+void TileTrace::begin(const OverscaledTileID& id, const char* step) {
+    if (isEnabled()) {
+        record(id, step, 'b');
+    }
+}
+
+void TileTrace::end(const OverscaledTileID& id, const char* step) {
+    if (isEnabled()) {
+        record(id, step, 'e');
+    }
+}
+
+std::string TileTrace::exportChromeTrace() {
+    std::vector<Event> recorded;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        recorded.swap(events);
+    }
+
+    std::string json = "{\"traceEvents\":[";
+    json.reserve(json.size() + recorded.size() * 160);
+    for (std::size_t i = 0; i < recorded.size(); ++i) {
+        const Event& event = recorded[i];
+        const auto tile = util::toString(event.id.overscaledZ) + "/" + util::toString(event.id.wrap) + "/" +
+                          util::toString(event.id.canonical.z) + "/" + util::toString(event.id.canonical.x) + "/" +
+                          util::toString(event.id.canonical.y);
+        const auto micros = std::chrono::duration_cast<std::chrono::microseconds>(event.time.time_since_epoch());
+        if (i > 0) {
+            json += ",";
+        }
+        json += "{\"name\":\"";
+        json += event.step;
+        json += "\",\"cat\":\"tile\",\"ph\":\"";
+        json += event.phase;
+        json += "\",\"id\":\"" + tile + "\",\"ts\":" + util::toString(static_cast<int64_t>(micros.count())) +
+                ",\"pid\":1,\"tid\":" + util::toString(event.thread) + ",\"args\":{\"tile\":\"" + tile + "\"}}";
+    }
+    json += "],\"displayTimeUnit\":\"ms\"}";
+    return json;
+}
+
+} // namespace util
+} // namespace mbgl
@@ -3,29 +3,27 @@
 #include <mbgl/util/math.hpp>
 
 #include <algorithm>
+#include <cmath>
 
 namespace mbgl {
 namespace util {
 
 namespace tinysdf {
 
-static const double INF = 1e20;
+static const float INF = 1e20f;
 
-// 1D squared distance transform
-void edt1d(std::vector<double>& f,
-           std::vector<double>& d,
-           std::vector<int16_t>& v,
-           std::vector<double>& z,
-           uint32_t n) {
+// 1D squared distance transform of the `n` contiguous values of `f`, written to `d`.
+void edt1d(const float* f, float* d, int16_t* v, float* z, uint32_t n) {
     v[0] = 0;
     z[0] = -INF;
     z[1] = +INF;
 
     for (uint32_t q = 1, k = 0; q < n; q++) {
-        double s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2 * q - 2 * v[k]);
+        const float fq = f[q] + float(q * q);
+        float s = (fq - (f[v[k]] + float(v[k] * v[k]))) / float(2 * (int32_t(q) - v[k]));
         while (s <= z[k]) {
             k--;
-            s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2 * q - 2 * v[k]);
+            s = (fq - (f[v[k]] + float(v[k] * v[k]))) / float(2 * (int32_t(q) - v[k]));
         }
         k++;
         v[k] = q;
@@ -34,36 +32,51 @@ void edt1d(std::vector<double>& f,
     }
 
     for (uint32_t q = 0, k = 0; q < n; q++) {
-        while (z[k + 1] < q) k++;
-        d[q] = (static_cast<double>(q) - v[k]) * (static_cast<double>(q) - v[k]) + f[v[k]];
+        while (z[k + 1] < float(q)) k++;
+        const float dq = float(int32_t(q) - v[k]);
+        d[q] = dq * dq + f[v[k]];
     }
 }
 
+// Transposes the `width` x `height` row-major `src` into `dst`.
+void transpose(const float* src, float* dst, uint32_t width, uint32_t height) {
+    // Blocks keep both sides in the cache for glyphs of any size.
+    const uint32_t block = 16;
+    for (uint32_t y0 = 0; y0 < height; y0 += block) {
+        const uint32_t y1 = std::min(y0 + block, height);
+        for (uint32_t x0 = 0; x0 < width; x0 += block) {
+            const uint32_t x1 = std::min(x0 + block, width);
+            for (uint32_t y = y0; y < y1; y++) {
+                for (uint32_t x = x0; x < x1; x++) {
+                    dst[x * height + y] = src[y * width + x];
+                }
+            }
+        }
+    }
+}
 
 // 2D Euclidean distance transform by Felzenszwalb & Huttenlocher https://cs.brown.edu/~pff/dt/
-void edt(std::vector<double>& data,
+// The column pass runs on a transposed copy, so both passes read and write contiguous lines.
+void edt(std::vector<float>& data,
          uint32_t width,
          uint32_t height,
-         std::vector<double>& f,
-         std::vector<double>& d,
+         std::vector<float>& transposed,
+         std::vector<float>& d,
          std::vector<int16_t>& v,
-         std::vector<double>& z) {
+         std::vector<float>& z) {
+    transpose(data.data(), transposed.data(), width, height);
     for (uint32_t x = 0; x < width; x++) {
-        for (uint32_t y = 0; y < height; y++) {
-            f[y] = data[y * width + x];
-        }
-        edt1d(f, d, v, z, height);
-        for (uint32_t y = 0; y < height; y++) {
-            data[y * width + x] = d[y];
-        }
+        float* column = transposed.data() + x * height;
+        edt1d(column, d.data(), v.data(), z.data(), height);
+        std::copy(d.begin(), d.begin() + height, column);
     }
+    transpose(transposed.data(), data.data(), height, width);
+
     for (uint32_t y = 0; y < height; y++) {
+        float* row = data.data() + y * width;
+        edt1d(row, d.data(), v.data(), z.data(), width);
         for (uint32_t x = 0; x < width; x++) {
-            f[x] = data[y * width + x];
-        }
-        edt1d(f, d, v, z, width);
-        for (uint32_t x = 0; x < width; x++) {
-            data[y * width + x] = std::sqrt(d[x]);
+            row[x] = std::sqrt(d[x]);
         }
     }
 }
@@ -73,29 +86,34 @@ void edt(std::vector<double>& data,
 AlphaImage transformRasterToSDF(const AlphaImage& rasterInput, double radius, double cutoff) {
     uint32_t size = rasterInput.size.width * rasterInput.size.height;
     uint32_t maxDimension = std::max(rasterInput.size.width, rasterInput.size.height);
-    
+
     AlphaImage sdf(rasterInput.size);
-    
+
     // temporary arrays for the distance transform
-    std::vector<double> gridOuter(size);
-    std::vector<double> gridInner(size);
-    std::vector<double> f(maxDimension);
-    std::vector<double> d(maxDimension);
-    std::vector<double> z(maxDimension + 1);
+    std::vector<float> gridOuter(size);
+    std::vector<float> gridInner(size);
+    std::vector<float> transposed(size);
+    std::vector<float> d(maxDimension);
+    std::vector<float> z(maxDimension + 1);
     std::vector<int16_t> v(maxDimension);
-    
+
+    // Selects rather than branches, so that the compiler can vectorize the conversion.
     for (uint32_t i = 0; i < size; i++) {
-        double a = double(rasterInput.data[i]) / 255; // alpha value
-        gridOuter[i] = a == 1.0 ? 0.0 : a == 0.0 ? tinysdf::INF : std::pow(std::max(0.0, 0.5 - a), 2.0);
-        gridInner[i] = a == 1.0 ? tinysdf::INF : a == 0.0 ? 0.0 : std::pow(std::max(0.0, a - 0.5), 2.0);
+        const float a = float(rasterInput.data[i]) / 255; // alpha value
+        const float outer = std::max(0.0f, 0.5f - a);
+        const float inner = std::max(0.0f, a - 0.5f);
+        gridOuter[i] = rasterInput.data[i] == 255 ? 0.0f : rasterInput.data[i] == 0 ? tinysdf::INF : outer * outer;
+        gridInner[i] = rasterInput.data[i] == 255 ? tinysdf::INF : rasterInput.data[i] == 0 ? 0.0f : inner * inner;
     }
 
-    tinysdf::edt(gridOuter, rasterInput.size.width, rasterInput.size.height, f, d, v, z);
-    tinysdf::edt(gridInner, rasterInput.size.width, rasterInput.size.height, f, d, v, z);
+    tinysdf::edt(gridOuter, rasterInput.size.width, rasterInput.size.height, transposed, d, v, z);
+    tinysdf::edt(gridInner, rasterInput.size.width, rasterInput.size.height, transposed, d, v, z);
 
+    const float scale = float(255.0 / radius);
+    const float offset = float(255.0 - 255.0 * cutoff);
     for (uint32_t i = 0; i < size; i++) {
-        double distance = gridOuter[i] - gridInner[i];
-        sdf.data[i] = std::max(0l, std::min(255l, ::lround(255.0 - 255.0 * (distance / radius + cutoff))));
+        const float distance = gridOuter[i] - gridInner[i];
+        sdf.data[i] = uint8_t(std::max(0.0f, std::min(255.0f, std::round(offset - scale * distance))));
     }
 
     return sdf;
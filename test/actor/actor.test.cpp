@@ -4,11 +4,13 @@
 #include <mbgl/test/util.hpp>
 #include <mbgl/util/run_loop.hpp>
 
+#include <array>
 #include <chrono>
 #include <functional>
 #include <future>
 #include <memory>
 #include <thread>
+#include <vector>
 
 using namespace mbgl;
 using namespace std::chrono_literals;
@@ -265,6 +267,48 @@ TEST(Actor, NonConcurrentMailbox) {
     endedFuture.wait();
 }
 
+TEST(Actor, OrderedMailboxMultipleSenders) {
+    // Messages from each sender are processed in the order they were sent,
+    // and no message is lost when several threads send concurrently.
+
+    static const int numSenders = 4;
+    static const int numMessages = 1000;
+
+    struct TestActor {
+        std::array<int, numSenders> last{};
+        int received = 0;
+        std::promise<void> promise;
+
+        TestActor(ActorRef<TestActor>, std::promise<void> promise_) : promise(std::move(promise_)) {}
+
+        void receive(int sender, int i) {
+            EXPECT_EQ(i, last[sender] + 1);
+            last[sender] = i;
+            if (++received == numSenders * numMessages) {
+                promise.set_value();
+            }
+        }
+    };
+
+    std::promise<void> endedPromise;
+    std::future<void> endedFuture = endedPromise.get_future();
+    Actor<TestActor> test(Scheduler::GetBackground(), std::move(endedPromise));
+
+    std::vector<std::thread> senders;
+    for (int sender = 0; sender < numSenders; ++sender) {
+        senders.emplace_back([sender](ActorRef<TestActor> ref) {
+            for (auto i = 1; i <= numMessages; ++i) {
+                ref.invoke(&TestActor::receive, sender, i);
+            }
+        }, test.self());
+    }
+
+    for (auto& sender : senders) {
+        sender.join();
+    }
+    endedFuture.wait();
+}
+
 TEST(Actor, Ask) {
     // Asking for a result
 
@@ -384,4 +428,16 @@ TEST(Actor, TwoPhaseConstruction) {
     EXPECT_TRUE(*destroyed);
 }
 
+TEST(Actor, MessageStorageIsRecycled) {
+    struct Test {
+        void receive(std::shared_ptr<int>) {}
+    } object;
 
+    auto first = actor::makeMessage(object, &Test::receive, std::make_shared<int>(1));
+    Message* storage = first.get();
+    first.reset();
+
+    // The next small message on this thread takes over the storage of the destroyed one.
+    auto second = actor::makeMessage(object, &Test::receive, std::make_shared<int>(2));
+    EXPECT_EQ(storage, second.get());
+}
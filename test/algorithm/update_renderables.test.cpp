@@ -1382,3 +1382,56 @@ TEST(UpdateRenderables, MaxParentOverscaleFactor) {
                          GetTileDataAction{{5, 0, {5, 3, 1}}, NotFound}}),
               log);
 }
+
+TEST(UpdateRenderables, PartialTileRendersParent) {
+    ActionLog log;
+    MockSource source;
+    auto getTileData = getTileDataFn(log, source.dataTiles);
+    auto createTileData = createTileDataFn(log, source.dataTiles);
+    auto retainTileData = retainTileDataFn(log);
+    auto renderTile = renderTileFn(log);
+
+    source.idealTiles.emplace(OverscaledTileID{1, 0, 0});
+    source.idealTiles.emplace(OverscaledTileID{1, 0, 1});
+
+    auto tile_0_0_0_0 = source.createTileData(OverscaledTileID{0, 0, 0});
+    tile_0_0_0_0->renderable = true;
+    auto tile_1_1_0_0 = source.createTileData(OverscaledTileID{1, 0, 0});
+    tile_1_1_0_0->renderable = true;
+    tile_1_1_0_0->partial = true;
+    auto tile_1_1_0_1 = source.createTileData(OverscaledTileID{1, 0, 1});
+    tile_1_1_0_1->renderable = true;
+    tile_1_1_0_1->partial = true;
+
+    // The parent tile renders once for both partial tiles.
+    algorithm::updateRenderables(
+        getTileData, createTileData, retainTileData, renderTile, source.idealTiles, source.zoomRange);
+    EXPECT_EQ(ActionLog({
+                  GetTileDataAction{{1, 0, {1, 0, 0}}, Found}, // ideal tile
+                  RetainTileDataAction{{1, 0, {1, 0, 0}}, TileNecessity::Required},
+                  RenderTileAction{{1, 0, 0}, *tile_1_1_0_0},
+                  GetTileDataAction{{0, 0, {0, 0, 0}}, Found}, // parent tile for the labels
+                  RetainTileDataAction{{0, 0, {0, 0, 0}}, TileNecessity::Optional},
+                  RenderTileAction{{0, 0, 0}, *tile_0_0_0_0},
+                  GetTileDataAction{{1, 0, {1, 0, 1}}, Found}, // ideal tile
+                  RetainTileDataAction{{1, 0, {1, 0, 1}}, TileNecessity::Required},
+                  RenderTileAction{{1, 0, 1}, *tile_1_1_0_1},
+              }),
+              log);
+
+    // Once every tile has its symbols, the parent tile isn't needed anymore.
+    log.clear();
+    tile_1_1_0_0->partial = false;
+    tile_1_1_0_1->partial = false;
+    algorithm::updateRenderables(
+        getTileData, createTileData, retainTileData, renderTile, source.idealTiles, source.zoomRange);
+    EXPECT_EQ(ActionLog({
+                  GetTileDataAction{{1, 0, {1, 0, 0}}, Found}, // ideal tile
+                  RetainTileDataAction{{1, 0, {1, 0, 0}}, TileNecessity::Required},
+                  RenderTileAction{{1, 0, 0}, *tile_1_1_0_0},
+                  GetTileDataAction{{1, 0, {1, 0, 1}}, Found}, // ideal tile
+                  RetainTileDataAction{{1, 0, {1, 0, 1}}, TileNecessity::Required},
+                  RenderTileAction{{1, 0, 1}, *tile_1_1_0_1},
+              }),
+              log);
+}
@@ -169,6 +169,21 @@ TEST(Annotations, AddMultiple) {
     test.checkRendering("add_multiple");
 }
 
+TEST(Annotations, AddMultipleAtOnce) {
+    AnnotationTest test;
+
+    test.map.getStyle().loadJSON(util::read_file("test/fixtures/api/empty.json"));
+    test.map.addAnnotationImage(namedMarker("default_marker"));
+    AnnotationIDs ids = test.map.addAnnotations({
+        SymbolAnnotation { Point<double> { -10, 0 }, "default_marker" },
+        SymbolAnnotation { Point<double> { 10, 0 }, "default_marker" }
+    });
+
+    ASSERT_EQ(2u, ids.size());
+    EXPECT_LT(ids[0], ids[1]);
+    test.checkRendering("add_multiple");
+}
+
 TEST(Annotations, NonImmediateAdd) {
     AnnotationTest test;
 
@@ -309,6 +324,27 @@ TEST(Annotations, RemoveShape) {
     test.checkRendering("remove_shape");
 }
 
+TEST(Annotations, RemoveMultipleAtOnce) {
+    AnnotationTest test;
+
+    LineString<double> line = {{ { 0, 0 }, { 45, 45 } }};
+    LineAnnotation annotation { line };
+    annotation.color = Color::red();
+    annotation.width = { 5 };
+
+    test.map.getStyle().loadJSON(util::read_file("test/fixtures/api/empty.json"));
+    test.map.addAnnotationImage(namedMarker("default_marker"));
+    AnnotationIDs ids = test.map.addAnnotations({
+        SymbolAnnotation { Point<double> { 0, 0 }, "default_marker" },
+        annotation
+    });
+
+    test.frontend.render(test.map);
+
+    test.map.removeAnnotations(ids);
+    test.checkRendering("remove_shape");
+}
+
 TEST(Annotations, ImmediateRemoveShape) {
     AnnotationTest test;
 
@@ -131,6 +131,32 @@ TEST(Query, QueryRenderedFeaturesFilter) {
     EXPECT_EQ(features3.size(), 1u);
 }
 
+TEST(Query, QueryRenderedFeaturesLimitAndProjection) {
+    QueryTest test;
+    auto zz = test.map.pixelForLatLng({ 0, 0 });
+
+    RenderedQueryOptions limited;
+    limited.limit = 2;
+    EXPECT_EQ(test.frontend.getRenderer()->queryRenderedFeatures(zz, limited).size(), 2u);
+
+    RenderedQueryOptions projected({{ "layer4" }}, {});
+    projected.properties = std::vector<std::string>{ "key1", "unknown" };
+    projected.geometry = false;
+    auto features = test.frontend.getRenderer()->queryRenderedFeatures(zz, projected);
+    ASSERT_EQ(features.size(), 1u);
+    EXPECT_EQ(features[0].id, FeatureIdentifier("feature1"s));
+    ASSERT_EQ(features[0].properties.size(), 1u);
+    EXPECT_EQ(features[0].properties["key1"], Value("value1"s));
+    EXPECT_TRUE(features[0].geometry.is<mapbox::geometry::empty>());
+
+    // Ids only.
+    projected.properties = std::vector<std::string>{};
+    features = test.frontend.getRenderer()->queryRenderedFeatures(zz, projected);
+    ASSERT_EQ(features.size(), 1u);
+    EXPECT_EQ(features[0].id, FeatureIdentifier("feature1"s));
+    EXPECT_TRUE(features[0].properties.empty());
+}
+
 TEST(Query, QuerySourceFeatures) {
     QueryTest test;
 
@@ -138,6 +164,18 @@ TEST(Query, QuerySourceFeatures) {
     EXPECT_EQ(features1.size(), 1u);
 }
 
+TEST(Query, QuerySourceFeaturesBounds) {
+    QueryTest test;
+
+    SourceQueryOptions options;
+    options.bounds = LatLngBounds::hull({ -1, -1 }, { 1, 1 });
+    options.deduplicate = true;
+    EXPECT_EQ(test.frontend.getRenderer()->querySourceFeatures("source4", options).size(), 1u);
+
+    options.bounds = LatLngBounds::hull({ 10, 10 }, { 20, 20 });
+    EXPECT_EQ(test.frontend.getRenderer()->querySourceFeatures("source4", options).size(), 0u);
+}
+
 TEST(Query, QuerySourceFeatureStates) {
     QueryTest test;
 
@@ -154,6 +192,26 @@ TEST(Query, QuerySourceFeatureStates) {
     ASSERT_EQ(newState, states);
 }
 
+TEST(Query, QuerySourceFeatureStatesBatched) {
+    QueryTest test;
+
+    FeatureState hover;
+    hover["hover"] = true;
+    FeatureState radius;
+    radius["radius"].set<uint64_t>(20);
+    test.frontend.getRenderer()->setFeatureStates(
+        "source1", {{{}, "feature1", hover}, {{}, "feature2", radius}, {{}, "feature1", radius}});
+
+    FeatureState states;
+    test.frontend.getRenderer()->getFeatureState(states, "source1", {}, "feature1");
+    ASSERT_EQ(states.size(), 2u);
+    ASSERT_EQ(states["hover"], true);
+    ASSERT_EQ(states["radius"].get<uint64_t>(), 20u);
+
+    test.frontend.getRenderer()->getFeatureState(states, "source1", {}, "feature2");
+    ASSERT_EQ(radius, states);
+}
+
 TEST(Query, QuerySourceFeaturesOptionValidation) {
     QueryTest test;
 
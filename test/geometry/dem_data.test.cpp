@@ -21,7 +21,8 @@ TEST(DEMData, ConstructorMapbox) {
 
     EXPECT_EQ(demdata.dim, 16);
     EXPECT_EQ(demdata.stride, 18);
-    EXPECT_EQ(demdata.getImage()->bytes(), size_t(18*18*4));
+    EXPECT_EQ(demdata.getImage().bytes(), size_t(18*18*4));
+    EXPECT_EQ(demdata.bytes(), size_t(18*18*2));
 };
 
 TEST(DEMData, ConstructorTerrarium) {
@@ -30,7 +31,34 @@ TEST(DEMData, ConstructorTerrarium) {
 
     EXPECT_EQ(demdata.dim, 16);
     EXPECT_EQ(demdata.stride, 18);
-    EXPECT_EQ(demdata.getImage()->bytes(), size_t(18*18*4));
+    EXPECT_EQ(demdata.getImage().bytes(), size_t(18*18*4));
+    EXPECT_EQ(demdata.bytes(), size_t(18*18*2));
+};
+
+TEST(DEMData, CompactHeights) {
+    PremultipliedImage image({4, 4});
+    for (uint32_t i = 0; i < 16; i++) {
+        // Heights between 100 m and 2200 m, with a resolution of 0.1 m.
+        const uint32_t value = 101000 + i * 1337;
+        image.data[i * 4] = value >> 16;
+        image.data[i * 4 + 1] = (value >> 8) & 0xFF;
+        image.data[i * 4 + 2] = value & 0xFF;
+        image.data[i * 4 + 3] = 255;
+    }
+    DEMData demdata(image, Tileset::DEMEncoding::Mapbox);
+
+    const auto& unpack = demdata.getUnpackVector();
+    const PremultipliedImage texture = demdata.getImage();
+    for (int32_t y = 0; y < 4; y++) {
+        for (int32_t x = 0; x < 4; x++) {
+            const uint32_t value = 101000 + (y * 4 + x) * 1337;
+            EXPECT_EQ(static_cast<int32_t>(value * 0.1 - 10000.0), demdata.get(x, y));
+
+            const uint8_t* pixel = texture.data.get() + ((y + 1) * 6 + x + 1) * 4;
+            EXPECT_NEAR(value * 0.1 - 10000.0,
+                        pixel[0] * unpack[0] + pixel[1] * unpack[1] + pixel[2] * unpack[2] - unpack[3], 0.01);
+        }
+    }
 };
 
 TEST(DEMData, InitialBackfill) {
@@ -1,6 +1,9 @@
 #include <mbgl/test/util.hpp>
 
 #include <mbgl/geometry/line_atlas.hpp>
+#include <mbgl/gfx/backend_scope.hpp>
+#include <mbgl/gl/context.hpp>
+#include <mbgl/gl/headless_backend.hpp>
 
 #include <random>
 
@@ -25,7 +28,75 @@ TEST(LineAtlas, Random) {
             const LinePatternCap patternCap =
                 capStyleDistribution(generator) > 0 ? LinePatternCap::Round : LinePatternCap::Square;
 
-            atlas.getDashPatternTexture(dasharray, dasharray, patternCap);
+            atlas.getDashPosition(dasharray, patternCap);
         }
     }
 }
+
+TEST(LineAtlas, SharedRows) {
+    LineAtlas atlas;
+    const LinePatternPos a = atlas.getDashPosition({1, 2}, LinePatternCap::Square);
+    const LinePatternPos b = atlas.getDashPosition({3, 4}, LinePatternCap::Square);
+    EXPECT_NE(a.y, b.y);
+    EXPECT_FLOAT_EQ(3.0f, a.width);
+    EXPECT_FLOAT_EQ(7.0f, b.width);
+    EXPECT_EQ(Size(256, 16), atlas.getSize());
+
+    // Both caps of the same dasharray are different patterns, and patterns are only added once.
+    const LinePatternPos c = atlas.getDashPosition({1, 2}, LinePatternCap::Round);
+    EXPECT_EQ(Size(256, 32), atlas.getSize());
+    EXPECT_FLOAT_EQ(0.5f / 32, atlas.getDashPosition({1, 2}, LinePatternCap::Square).y);
+    EXPECT_FLOAT_EQ(1.5f / 32, atlas.getDashPosition({3, 4}, LinePatternCap::Square).y);
+    EXPECT_FLOAT_EQ(9.5f / 32, c.y);
+    EXPECT_FLOAT_EQ(c.y, atlas.getDashPosition({1, 2}, LinePatternCap::Round).y);
+    EXPECT_EQ(Size(256, 32), atlas.getSize());
+}
+
+TEST(LineAtlas, Grow) {
+    LineAtlas atlas;
+    atlas.getDashPosition({1, 1}, LinePatternCap::Round);
+    const Size size = atlas.getSize();
+    for (float length = 2; length < 9; ++length) {
+        atlas.getDashPosition({length, 1}, LinePatternCap::Round);
+    }
+
+    // The height stays a power of two, and positions are relative to it.
+    EXPECT_EQ(256u, atlas.getSize().width);
+    EXPECT_EQ(size.height * 8, atlas.getSize().height);
+    const LinePatternPos position = atlas.getDashPosition({1, 1}, LinePatternCap::Round);
+    EXPECT_FLOAT_EQ(7.5f / atlas.getSize().height, position.y);
+    EXPECT_FLOAT_EQ(15.0f / atlas.getSize().height, position.height);
+}
+
+TEST(LineAtlas, EvictUnused) {
+    gl::HeadlessBackend backend({32, 32});
+    gfx::BackendScope scope{backend};
+    gfx::Context& context = backend.getContext();
+
+    LineAtlas atlas;
+    const auto upload = [&] {
+        auto commandEncoder = context.createCommandEncoder();
+        auto uploadPass = commandEncoder->createUploadPass("upload");
+        atlas.upload(*uploadPass);
+    };
+
+    // Fill the atlas to its largest size in one frame.
+    for (uint32_t i = 1; i <= 2048 / 15; ++i) {
+        atlas.getDashPosition({float(i), 1}, LinePatternCap::Round);
+    }
+    EXPECT_EQ(2048u, atlas.getSize().height);
+    EXPECT_FLOAT_EQ(757.5f / 2048, atlas.getDashPosition({51, 1}, LinePatternCap::Round).y);
+    upload();
+
+    // The patterns of the next frame replace those that weren't used in it, and the ones that
+    // were move up.
+    atlas.getDashPosition({51, 1}, LinePatternCap::Round);
+    for (uint32_t i = 1; i <= 10; ++i) {
+        atlas.getDashPosition({1000.0f + i, 1}, LinePatternCap::Round);
+    }
+    EXPECT_EQ(2048u, atlas.getSize().height);
+    EXPECT_FLOAT_EQ(7.5f / 2048, atlas.getDashPosition({51, 1}, LinePatternCap::Round).y);
+    EXPECT_FLOAT_EQ(52.0f, atlas.getDashPosition({51, 1}, LinePatternCap::Round).width);
+    upload();
+    atlas.textureBinding();
+}
@@ -0,0 +1,52 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/gfx/memory_tracker.hpp>
+
+using namespace mbgl;
+using namespace mbgl::gfx;
+
+TEST(MemoryTracker, Attribution) {
+    MemoryTracker tracker;
+    const OverscaledTileID tileID{1, 0, 0};
+
+    auto unowned = tracker.add(MemoryType::Texture, 100);
+    MemoryTracker::Handle glyphs = [&] {
+        const MemoryTracker::Scope scope(tracker, MemoryOwner::forShared("glyph atlas"));
+        return tracker.add(MemoryType::Texture, 10);
+    }();
+
+    MemoryTracker::Handle vertices, indices;
+    {
+        const MemoryTracker::Scope sourceScope(tracker, MemoryOwner::forSource("streets"));
+        MemoryOwner owner = tracker.getOwner();
+        owner.tile = tileID;
+        const MemoryTracker::Scope tileScope(tracker, std::move(owner));
+        owner = tracker.getOwner();
+        owner.layer = "roads";
+        const MemoryTracker::Scope layerScope(tracker, std::move(owner));
+        vertices = tracker.add(MemoryType::VertexBuffer, 20);
+        indices = tracker.add(MemoryType::IndexBuffer, 5);
+    }
+    EXPECT_TRUE(tracker.getOwner().source.empty());
+
+    MemoryUsage usage = tracker.getUsage();
+    EXPECT_EQ(135u, usage.total.total());
+    EXPECT_EQ(100u, usage.other.textures);
+    EXPECT_EQ(10u, usage.shared["glyph atlas"].textures);
+    EXPECT_EQ(20u, usage.sources["streets"].vertexBuffers);
+    EXPECT_EQ(5u, usage.tiles["streets"][tileID].indexBuffers);
+    EXPECT_EQ(25u, usage.layers["roads"].total());
+
+    tracker.remove(vertices, MemoryType::VertexBuffer, 20);
+    usage = tracker.getUsage();
+    EXPECT_EQ(0u, usage.layers["roads"].vertexBuffers);
+    EXPECT_EQ(5u, usage.layers["roads"].indexBuffers);
+
+    tracker.remove(indices, MemoryType::IndexBuffer, 5);
+    tracker.remove(glyphs, MemoryType::Texture, 10);
+    tracker.remove(unowned, MemoryType::Texture, 100);
+    usage = tracker.getUsage();
+    EXPECT_EQ(0u, usage.total.total());
+    EXPECT_TRUE(usage.sources.empty());
+    EXPECT_TRUE(usage.shared.empty());
+}
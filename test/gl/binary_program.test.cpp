@@ -0,0 +1,20 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/gl/binary_program.hpp>
+
+using namespace mbgl;
+
+TEST(BinaryProgram, RoundTrip) {
+    std::string code("\x01\x00\x02\xFF", 4);
+    const gl::BinaryProgram program(0x8741, std::move(code), "identifier");
+
+    const gl::BinaryProgram parsed(program.serialize());
+    EXPECT_EQ(0x8741u, parsed.format());
+    EXPECT_EQ(std::string("\x01\x00\x02\xFF", 4), parsed.code());
+    EXPECT_EQ("identifier", parsed.identifier());
+}
+
+TEST(BinaryProgram, Invalid) {
+    EXPECT_THROW(gl::BinaryProgram(std::string()), std::runtime_error);
+    EXPECT_THROW(gl::BinaryProgram(std::string("\x08", 1)), std::exception);
+}
@@ -4,15 +4,21 @@
 #include <mbgl/gfx/backend_scope.hpp>
 #include <mbgl/renderer/buckets/circle_bucket.hpp>
 #include <mbgl/renderer/buckets/fill_bucket.hpp>
+#include <mbgl/renderer/buckets/hillshade_bucket.hpp>
 #include <mbgl/renderer/buckets/line_bucket.hpp>
 #include <mbgl/renderer/buckets/raster_bucket.hpp>
 #include <mbgl/renderer/buckets/symbol_bucket.hpp>
 #include <mbgl/renderer/bucket_parameters.hpp>
+#include <mbgl/renderer/property_evaluation_parameters.hpp>
+#include <mbgl/style/expression/dsl.hpp>
+#include <mbgl/style/layers/circle_layer_impl.hpp>
+#include <mbgl/style/layers/fill_layer_impl.hpp>
 #include <mbgl/style/layers/symbol_layer_properties.hpp>
 #include <mbgl/gl/context.hpp>
 #include <mbgl/gl/headless_backend.hpp>
 
 #include <mbgl/map/mode.hpp>
+#include <mbgl/util/constants.hpp>
 
 namespace mbgl {
 
@@ -40,6 +46,22 @@ namespace {
 
 PropertyMap properties;
 
+class StubGeometryTileLayer : public GeometryTileLayer {
+public:
+    std::size_t featureCount() const override { return features.size(); }
+    std::unique_ptr<GeometryTileFeature> getFeature(std::size_t i) const override {
+        return std::make_unique<StubGeometryTileFeature>(features.at(i));
+    }
+    std::string getName() const override { return "layer"; }
+
+    std::vector<StubGeometryTileFeature> features;
+};
+
+Immutable<style::LayerProperties> evaluate(const Immutable<style::FillLayer::Impl>& impl) {
+    return makeMutable<style::FillLayerProperties>(
+        impl, CrossfadeParameters(), impl->paint.untransitioned().evaluate(PropertyEvaluationParameters(5.0f)));
+}
+
 } // namespace
 
 TEST(Buckets, CircleBucket) {
@@ -99,6 +121,158 @@ TEST(Buckets, FillBucket) {
     ASSERT_FALSE(bucket.needsUpload());
 }
 
+TEST(Buckets, FillBucketOverscaled) {
+    // A square with a hole, in the tile of an overscaled zoom level and of the one above it.
+    GeometryCollection polygon{{{0, 0}, {8, 0}, {8, 8}, {0, 8}, {0, 0}},
+                               {{2, 2}, {2, 6}, {6, 6}, {6, 2}, {2, 2}}};
+    auto addPolygon = [&](FillBucket& bucket) {
+        bucket.addFeature(StubGeometryTileFeature{{}, FeatureType::Polygon, polygon, properties},
+                          polygon,
+                          {},
+                          PatternLayerMap(),
+                          0,
+                          CanonicalTileID(0, 0, 0));
+    };
+
+    FillBucket bucket{FillBucket::PossiblyEvaluatedLayoutProperties(), {}, 5.0f, 1};
+    addPolygon(bucket);
+
+    FillBucket overscaled{FillBucket::PossiblyEvaluatedLayoutProperties(), {}, 6.0f, 2};
+    addPolygon(overscaled);
+    FillBucket overscaledAgain{FillBucket::PossiblyEvaluatedLayoutProperties(), {}, 7.0f, 4};
+    addPolygon(overscaledAgain);
+
+    ASSERT_GT(bucket.triangles.elements(), 0u);
+    EXPECT_EQ(bucket.triangles.vector(), overscaled.triangles.vector());
+    EXPECT_EQ(bucket.triangles.vector(), overscaledAgain.triangles.vector());
+}
+
+TEST(Buckets, FillBucketExceedsTile) {
+    auto addPolygon = [](FillBucket& bucket, const GeometryCollection& polygon) {
+        bucket.addFeature(StubGeometryTileFeature{{}, FeatureType::Polygon, polygon, properties},
+                          polygon,
+                          {},
+                          PatternLayerMap(),
+                          0,
+                          CanonicalTileID(0, 0, 0));
+    };
+
+    FillBucket bucket{FillBucket::PossiblyEvaluatedLayoutProperties(), {}, 5.0f, 1};
+    addPolygon(bucket, {{{1, 1}, {util::EXTENT - 1, 1}, {1, util::EXTENT - 1}}});
+    EXPECT_FALSE(bucket.exceedsTile);
+
+    // Polygons on the tile boundary are clipped as well.
+    addPolygon(bucket, {{{1, 1}, {util::EXTENT, 1}, {1, 2}}});
+    EXPECT_TRUE(bucket.exceedsTile);
+
+    FillBucket buffered{FillBucket::PossiblyEvaluatedLayoutProperties(), {}, 5.0f, 1};
+    addPolygon(buffered, {{{-64, 1}, {8, 1}, {8, 8}}});
+    EXPECT_TRUE(buffered.exceedsTile);
+}
+
+TEST(Buckets, FillBucketUpdatePaintProperties) {
+    using namespace style;
+    using namespace style::expression::dsl;
+
+    FillLayer layer("fill", "source");
+    layer.setFillOpacity(PropertyExpression<float>(createExpression(R"(["number", ["get", "opacity"]])")));
+    const auto before = staticImmutableCast<FillLayer::Impl>(layer.baseImpl);
+
+    StubGeometryTileLayer sourceLayer;
+    GeometryCollection polygon{{{0, 0}, {0, 1}, {1, 1}}};
+    sourceLayer.features.emplace_back(FeatureIdentifier{}, FeatureType::Polygon, polygon, PropertyMap{{"opacity", 0.25}});
+    sourceLayer.features.emplace_back(FeatureIdentifier{}, FeatureType::Polygon, polygon, PropertyMap{{"opacity", 0.5}});
+
+    FillBucket bucket{FillBucket::PossiblyEvaluatedLayoutProperties(), {{"fill", evaluate(before)}}, 5.0f, 1};
+    for (std::size_t i = 0; i < sourceLayer.features.size(); ++i) {
+        bucket.addFeature(
+            sourceLayer.features[i], polygon, {}, PatternLayerMap(), i, CanonicalTileID(0, 0, 0));
+    }
+    EXPECT_DOUBLE_EQ(0.5, *bucket.paintPropertyBinders.at(before->internedID).statistics<FillOpacity>().max());
+
+    layer.setFillOpacity(PropertyExpression<float>(createExpression(R"(["*", 1.5, ["number", ["get", "opacity"]]])")));
+    const auto after = staticImmutableCast<FillLayer::Impl>(layer.baseImpl);
+    EXPECT_FALSE(before->hasLayoutDifference(*after));
+    EXPECT_TRUE(before->hasPaintPropertyBinderDifference(*after));
+
+    bucket.updatePaintProperties(evaluate(after), sourceLayer, CanonicalTileID(0, 0, 0));
+    EXPECT_DOUBLE_EQ(0.75, *bucket.paintPropertyBinders.at(after->internedID).statistics<FillOpacity>().max());
+    EXPECT_TRUE(bucket.needsUpload());
+
+    // Layers using patterns still need a new layout.
+    layer.setFillPattern(PropertyExpression<expression::Image>(createExpression(R"(["image", ["get", "pattern"]])")));
+    const auto patterned = staticImmutableCast<FillLayer::Impl>(layer.baseImpl);
+    EXPECT_TRUE(after->hasLayoutDifference(*patterned));
+    EXPECT_FALSE(after->hasPaintPropertyBinderDifference(*patterned));
+}
+
+TEST(Buckets, DataDrivenKindChangeNeedsLayout) {
+    using namespace style;
+    using namespace style::expression::dsl;
+
+    // Existing buckets have constant binders for constant properties and can't switch kinds.
+    FillLayer fill("fill", "source");
+    fill.setFillColor(Color::red());
+    const auto constantFill = staticImmutableCast<FillLayer::Impl>(fill.baseImpl);
+    fill.setFillColor(PropertyExpression<Color>(createExpression(R"(["to-color", ["get", "color"]])")));
+    const auto expressionFill = staticImmutableCast<FillLayer::Impl>(fill.baseImpl);
+
+    EXPECT_TRUE(constantFill->hasLayoutDifference(*expressionFill));
+    EXPECT_FALSE(constantFill->hasPaintPropertyBinderDifference(*expressionFill));
+    EXPECT_TRUE(expressionFill->hasLayoutDifference(*constantFill));
+    EXPECT_FALSE(expressionFill->hasPaintPropertyBinderDifference(*constantFill));
+
+    CircleLayer circle("circle", "source");
+    circle.setCircleRadius(2.0f);
+    const auto constantCircle = staticImmutableCast<CircleLayer::Impl>(circle.baseImpl);
+    circle.setCircleRadius(PropertyExpression<float>(createExpression(R"(["number", ["get", "radius"]])")));
+    const auto expressionCircle = staticImmutableCast<CircleLayer::Impl>(circle.baseImpl);
+
+    EXPECT_TRUE(constantCircle->hasLayoutDifference(*expressionCircle));
+    EXPECT_FALSE(constantCircle->hasPaintPropertyBinderDifference(*expressionCircle));
+    EXPECT_TRUE(expressionCircle->hasLayoutDifference(*constantCircle));
+    EXPECT_FALSE(expressionCircle->hasPaintPropertyBinderDifference(*constantCircle));
+}
+
+TEST(Buckets, FillBucketUpdateFeatureState) {
+    using namespace style;
+    using namespace style::expression::dsl;
+
+    gl::HeadlessBackend backend({512, 256});
+    gfx::BackendScope scope{backend};
+    gl::Context context{backend};
+
+    FillLayer layer("fill", "source");
+    layer.setFillOpacity(
+        PropertyExpression<float>(createExpression(R"(["number", ["feature-state", "opacity"], 1])")));
+
+    StubGeometryTileLayer sourceLayer;
+    GeometryCollection polygon{{{0, 0}, {0, 1}, {1, 1}}};
+    for (uint64_t id = 0; id < 3; ++id) {
+        sourceLayer.features.emplace_back(FeatureIdentifier{id}, FeatureType::Polygon, polygon, properties);
+    }
+
+    FillBucket bucket{FillBucket::PossiblyEvaluatedLayoutProperties(),
+                      {{"fill", evaluate(staticImmutableCast<FillLayer::Impl>(layer.baseImpl))}},
+                      5.0f,
+                      1};
+    for (std::size_t i = 0; i < sourceLayer.features.size(); ++i) {
+        bucket.addFeature(sourceLayer.features[i], polygon, {}, PatternLayerMap(), i, CanonicalTileID(0, 0, 0));
+    }
+
+    auto commandEncoder = context.createCommandEncoder();
+    auto uploadPass = commandEncoder->createUploadPass("upload");
+    bucket.upload(*uploadPass);
+    const auto buffers = context.renderingStats().numBuffers;
+
+    // Feature state updates write the changed vertices into the existing buffers.
+    bucket.update({{"1", FeatureState{{"opacity", 0.5}}}}, sourceLayer, "fill", {});
+    ASSERT_TRUE(bucket.needsUpload());
+    bucket.upload(*uploadPass);
+    EXPECT_FALSE(bucket.needsUpload());
+    EXPECT_EQ(buffers, context.renderingStats().numBuffers);
+}
+
 TEST(Buckets, LineBucket) {
     gl::HeadlessBackend backend({ 512, 256 });
     gfx::BackendScope scope { backend };
@@ -183,6 +357,7 @@ TEST(Buckets, SymbolBucket) {
     ASSERT_FALSE(bucket.needsUpload());
 
     bucket.text.segments.emplace_back(0, 0);
+    bucket.text.vertices.emplace_back(SymbolLayoutVertex{});
     ASSERT_TRUE(bucket.hasTextData());
     ASSERT_TRUE(bucket.hasData());
     ASSERT_TRUE(bucket.needsUpload());
@@ -191,6 +366,12 @@ TEST(Buckets, SymbolBucket) {
     auto uploadPass = commandEncoder->createUploadPass("upload");
     bucket.upload(*uploadPass);
     ASSERT_FALSE(bucket.needsUpload());
+
+    // The layout vertices only live on in their buffer once uploaded.
+    EXPECT_EQ(1u, bucket.text.vertexBuffer->elements);
+    EXPECT_TRUE(bucket.text.vertices.empty());
+    EXPECT_EQ(0u, bucket.text.vertices.capacity());
+    EXPECT_TRUE(bucket.hasTextData());
 }
 
 TEST(Buckets, RasterBucket) {
@@ -214,6 +395,48 @@ TEST(Buckets, RasterBucket) {
     ASSERT_TRUE(bucket.needsUpload());
 }
 
+TEST(Buckets, HillshadeBucket) {
+    gl::HeadlessBackend backend({ 512, 256 });
+    gfx::BackendScope scope { backend };
+
+    gl::Context context{ backend };
+    HillshadeBucket bucket{ PremultipliedImage({ 16, 16 }), Tileset::DEMEncoding::Mapbox };
+    ASSERT_TRUE(bucket.hasData());
+    ASSERT_TRUE(bucket.needsUpload());
+
+    auto commandEncoder = context.createCommandEncoder();
+    auto uploadPass = commandEncoder->createUploadPass("upload");
+    bucket.upload(*uploadPass);
+    ASSERT_FALSE(bucket.needsUpload());
+    ASSERT_TRUE(bucket.dem);
+    const gfx::TextureResource* demResource = &bucket.dem->getResource();
+    bucket.setPrepared(true);
+
+    // New masks only upload the vertices again.
+    bucket.setMask({ CanonicalTileID(1, 0, 0) });
+    ASSERT_TRUE(bucket.needsUpload());
+    bucket.upload(*uploadPass);
+    EXPECT_TRUE(bucket.isPrepared());
+    EXPECT_EQ(demResource, &bucket.dem->getResource());
+
+    // Backfilled borders upload into the same DEM texture, and prepare the slopes again.
+    bucket.setDEMDataChanged();
+    ASSERT_TRUE(bucket.needsUpload());
+    EXPECT_FALSE(bucket.isPrepared());
+    bucket.upload(*uploadPass);
+    ASSERT_FALSE(bucket.needsUpload());
+    EXPECT_EQ(demResource, &bucket.dem->getResource());
+    bucket.setPrepared(true);
+
+    // So do single borders.
+    bucket.setDEMBorderChanged(-1, 0);
+    ASSERT_TRUE(bucket.needsUpload());
+    EXPECT_FALSE(bucket.isPrepared());
+    bucket.upload(*uploadPass);
+    ASSERT_FALSE(bucket.needsUpload());
+    EXPECT_EQ(demResource, &bucket.dem->getResource());
+}
+
 TEST(Buckets, RasterBucketMaskEmpty) {
     RasterBucket bucket{ nullptr };
     bucket.setMask({});
@@ -352,3 +575,25 @@ TEST(Buckets, RasterBucketMaskNoChildren) {
      expectedSegments.emplace_back(0, 0, 24, 36);
      EXPECT_EQ(expectedSegments, bucket.segments);
  }
+
+TEST(Buckets, VertexAndIndexVectorAppend) {
+    gfx::VertexVector<LineLayoutVertex> vertices;
+    vertices.grow(2);
+    const std::size_t capacity = vertices.capacity();
+    EXPECT_LE(2u, capacity);
+    const std::vector<LineLayoutVertex> source{LineProgram::layoutVertex({0, 0}, {0, 1}, false, false, 0),
+                                               LineProgram::layoutVertex({0, 0}, {0, -1}, false, true, 0)};
+    vertices.append(source.begin(), source.end());
+    EXPECT_EQ(2u, vertices.elements());
+    EXPECT_EQ(capacity, vertices.capacity());
+    EXPECT_EQ(source, vertices.vector());
+
+    // Growing keeps the capacity geometric, so that calling it for every feature stays linear.
+    vertices.grow(1);
+    EXPECT_LE(capacity * 2, vertices.capacity());
+
+    gfx::IndexVector<gfx::Triangles> triangles;
+    const std::vector<uint32_t> indices{0, 1, 2, 2, 1, 3};
+    triangles.append(indices.begin(), indices.end(), 10);
+    EXPECT_EQ((std::vector<uint16_t>{10, 11, 12, 12, 11, 13}), triangles.vector());
+}
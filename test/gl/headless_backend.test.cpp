@@ -0,0 +1,18 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/gfx/backend_scope.hpp>
+#include <mbgl/gl/headless_backend.hpp>
+
+#include <stdexcept>
+
+using namespace mbgl;
+
+// Backends that can't choose the GPU throw as soon as one is asked for, and the EGL backend
+// doesn't find one that doesn't exist. Either way the backend can still be destroyed.
+TEST(HeadlessBackend, MissingDevice) {
+    gl::HeadlessBackend backend { { 256, 256 },
+                                  gfx::HeadlessBackend::SwapBehaviour::NoFlush,
+                                  gfx::ContextMode::Unique,
+                                  1000u };
+    EXPECT_THROW(gfx::BackendScope { backend }, std::runtime_error);
+}
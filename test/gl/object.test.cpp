@@ -3,6 +3,11 @@
 #include <mbgl/gfx/backend_scope.hpp>
 #include <mbgl/gl/headless_backend.hpp>
 #include <mbgl/gl/context.hpp>
+#include <mbgl/gl/index_buffer_resource.hpp>
+#include <mbgl/gl/texture_resource.hpp>
+#include <mbgl/gfx/command_encoder.hpp>
+#include <mbgl/gfx/upload_pass.hpp>
+#include <mbgl/programs/fill_program.hpp>
 
 #include <memory>
 
@@ -63,3 +68,127 @@ TEST(GLObject, Store) {
     context.reset();
     EXPECT_TRUE(context.empty());
 }
+
+TEST(GLObject, BufferPool) {
+    gl::HeadlessBackend backend { { 256, 256 } };
+    gfx::BackendScope scope { backend };
+
+    gl::Context context{ backend };
+    auto makeIndices = [] {
+        gfx::IndexVector<gfx::Triangles> indices;
+        indices.emplace_back(0, 1, 2);
+        return indices;
+    };
+
+    {
+        auto commandEncoder = context.createCommandEncoder();
+        auto uploadPass = commandEncoder->createUploadPass("upload");
+        auto first = uploadPass->createIndexBuffer(makeIndices());
+        auto second = uploadPass->createIndexBuffer(makeIndices());
+        auto dynamic = uploadPass->createIndexBuffer(makeIndices(), gfx::BufferUsageType::DynamicDraw);
+
+        // Static buffers share a block, at aligned offsets.
+        const auto& firstResource = first.getResource<gl::IndexBufferResource>();
+        const auto& secondResource = second.getResource<gl::IndexBufferResource>();
+        EXPECT_EQ(firstResource.buffer, secondResource.buffer);
+        EXPECT_EQ(0u, firstResource.byteOffset);
+        EXPECT_EQ(gl::BufferPool::alignment, secondResource.byteOffset);
+        EXPECT_NE(firstResource.buffer, dynamic.getResource<gl::IndexBufferResource>().buffer);
+        EXPECT_EQ(1u, context.indexBufferPool.blockCount());
+        EXPECT_EQ(2, context.renderingStats().numBuffers);
+        EXPECT_EQ(18, context.renderingStats().memIndexBuffers);
+    }
+
+    // The block goes away with its last buffer.
+    EXPECT_EQ(0u, context.indexBufferPool.blockCount());
+    context.performCleanup();
+    EXPECT_EQ(0, context.renderingStats().numBuffers);
+    EXPECT_EQ(0, context.renderingStats().memIndexBuffers);
+}
+
+TEST(GLObject, VertexArrayCache) {
+    gl::HeadlessBackend backend { { 256, 256 } };
+    gfx::BackendScope scope { backend };
+
+    gl::Context context{ backend };
+
+    {
+        auto commandEncoder = context.createCommandEncoder();
+        auto uploadPass = commandEncoder->createUploadPass("upload");
+        gfx::IndexVector<gfx::Triangles> indices;
+        indices.emplace_back(0, 1, 2);
+        auto indexBuffer = uploadPass->createIndexBuffer(std::move(indices));
+        gfx::VertexVector<FillLayoutVertex> vertices;
+        vertices.emplace_back(FillProgram::layoutVertex({ 0, 0 }));
+        vertices.emplace_back(FillProgram::layoutVertex({ 1, 0 }));
+        vertices.emplace_back(FillProgram::layoutVertex({ 0, 1 }));
+        auto vertexBuffer = uploadPass->createVertexBuffer(std::move(vertices));
+
+        const gl::AttributeBindingArray bindings{ gfx::attributeBinding<0>(vertexBuffer), nullopt };
+        auto* vertexArray = context.getVertexArray(indexBuffer, bindings);
+        if (!vertexArray) {
+            // No vertex array support.
+            return;
+        }
+
+        // Draws with the same bindings share the vertex array.
+        EXPECT_EQ(vertexArray, context.getVertexArray(indexBuffer, bindings));
+        EXPECT_EQ(1, context.renderingStats().numVertexArrays);
+
+        const gl::AttributeBindingArray offset{ gfx::offsetAttributeBinding(bindings[0], 1), nullopt };
+        EXPECT_NE(vertexArray, context.getVertexArray(indexBuffer, offset));
+        EXPECT_EQ(2, context.renderingStats().numVertexArrays);
+
+        // Draw scopes remember the vertex array, and look it up again when the bindings change.
+        auto drawScope = context.createDrawScope();
+        EXPECT_EQ(vertexArray, &context.getVertexArray(drawScope, indexBuffer, bindings));
+        EXPECT_EQ(vertexArray, &context.getVertexArray(drawScope, indexBuffer, bindings));
+        EXPECT_EQ(context.getVertexArray(indexBuffer, offset), &context.getVertexArray(drawScope, indexBuffer, offset));
+        EXPECT_EQ(2, context.renderingStats().numVertexArrays);
+    }
+
+    // The vertex arrays go away with the buffers they refer to.
+    context.performCleanup();
+    EXPECT_EQ(0, context.renderingStats().numVertexArrays);
+    EXPECT_EQ(0, context.renderingStats().numBuffers);
+}
+
+TEST(GLObject, TexturePool) {
+    gl::HeadlessBackend backend { { 256, 256 } };
+    gfx::BackendScope scope { backend };
+
+    gl::Context context{ backend };
+    auto textureID = [](const gfx::Texture& texture) {
+        return texture.getResource<gl::TextureResource>().texture.get();
+    };
+
+    gl::TextureID pooled = 0;
+    {
+        auto texture = context.createTexture({ 64, 64 });
+        pooled = textureID(texture);
+    }
+    EXPECT_EQ(0, context.renderingStats().numActiveTextures);
+    EXPECT_FALSE(context.empty());
+    EXPECT_EQ(64u * 64u * 4u, context.memoryTracker().getUsage().shared["texture pool"].textures);
+
+    // Textures of the same size and format take over the storage.
+    {
+        auto other = context.createTexture({ 32, 32 });
+        EXPECT_NE(pooled, textureID(other));
+        auto texture = context.createTexture({ 64, 64 });
+        EXPECT_EQ(pooled, textureID(texture));
+        EXPECT_EQ(2, context.renderingStats().numActiveTextures);
+        EXPECT_EQ(0u, context.memoryTracker().getUsage().shared.count("texture pool"));
+    }
+
+    // Reducing memory usage deletes the pooled storage.
+    context.reduceMemoryUsage();
+    EXPECT_EQ(0u, context.memoryTracker().getUsage().total.textures);
+
+    {
+        auto texture = context.createTexture({ 64, 64 });
+    }
+    context.reset();
+    EXPECT_TRUE(context.empty());
+    EXPECT_EQ(0, context.renderingStats().numCreatedTextures);
+}
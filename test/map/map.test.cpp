@@ -10,6 +10,7 @@
 #include <mbgl/gl/context.hpp>
 #include <mbgl/map/map_options.hpp>
 #include <mbgl/math/log2.hpp>
+#include <mbgl/platform/settings.hpp>
 #include <mbgl/renderer/renderer.hpp>
 #include <mbgl/renderer/update_parameters.hpp>
 #include <mbgl/storage/file_source_manager.hpp>
@@ -34,6 +35,7 @@
 #include <mbgl/util/run_loop.hpp>
 
 #include <atomic>
+#include <cstring>
 
 using namespace mbgl;
 using namespace mbgl::style;
@@ -645,6 +647,159 @@ TEST(Map, MapLoadedSignal) {
     test.runLoop.run();
 }
 
+TEST(Map, LoadProgress) {
+    {
+        MapTest<> test;
+        bool failed = false;
+        test.map.whenIdle([&](std::exception_ptr error) { failed = bool(error); });
+        EXPECT_TRUE(failed);
+    }
+
+    MapTest<> test { 1, MapMode::Continuous };
+
+    std::vector<LoadProgress> reports;
+    test.observer.didUpdateLoadProgressCallback = [&](const LoadProgress& progress) { reports.push_back(progress); };
+
+    test.map.getStyle().loadJSON(R"STYLE({
+      "version": 8,
+      "sources": {
+        "points": { "type": "geojson", "data": { "type": "Point", "coordinates": [0, 0] } }
+      },
+      "layers": [{ "id": "points", "type": "circle", "source": "points" }]
+    })STYLE");
+    test.map.whenIdle([&](std::exception_ptr error) {
+        EXPECT_FALSE(error);
+        test.runLoop.stop();
+    });
+    test.runLoop.run();
+
+    ASSERT_FALSE(reports.empty());
+    EXPECT_TRUE(reports.back().isComplete());
+    ASSERT_EQ(1u, reports.back().sources.size());
+    EXPECT_EQ("points", reports.back().sources[0].id);
+    // Only changes are reported.
+    for (std::size_t i = 1; i < reports.size(); ++i) {
+        EXPECT_NE(reports[i - 1], reports[i]);
+    }
+}
+
+TEST(Map, SkipUnchangedFrames) {
+    auto& settings = platform::Settings::getInstance();
+    settings.set(platform::EXPERIMENTAL_SKIP_UNCHANGED_FRAMES, true);
+    MapTest<> test { 1, MapMode::Continuous };
+    settings.set(platform::EXPERIMENTAL_SKIP_UNCHANGED_FRAMES, mapbox::base::Value{});
+
+    unsigned frames = 0;
+    test.observer.didFinishRenderingFrameCallback = [&](MapObserver::RenderFrameStatus) { frames++; };
+    test.observer.didBecomeIdleCallback = [&] { test.runLoop.stop(); };
+
+    test.map.getStyle().loadJSON(util::read_file("test/fixtures/api/empty.json"));
+    test.runLoop.run();
+    EXPECT_LT(0u, frames);
+
+    // Nothing changed since the last frame.
+    frames = 0;
+    util::Timer timer;
+    timer.start(Milliseconds(100), Duration::zero(), [&] { test.runLoop.stop(); });
+    test.map.triggerRepaint();
+    test.runLoop.run();
+    EXPECT_EQ(0u, frames);
+
+    test.map.jumpTo(CameraOptions().withZoom(1.0));
+    test.runLoop.run();
+    EXPECT_LT(0u, frames);
+}
+
+TEST(Map, CachedLayerRange) {
+    const auto renderFrames = [](bool cached) {
+        auto& settings = platform::Settings::getInstance();
+        if (cached) {
+            settings.set(platform::EXPERIMENTAL_CACHED_LAYER_RANGE_FIRST, "base"s);
+            settings.set(platform::EXPERIMENTAL_CACHED_LAYER_RANGE_LAST, "base"s);
+        }
+        MapTest<> test { 1, MapMode::Continuous };
+        settings.set(platform::EXPERIMENTAL_CACHED_LAYER_RANGE_FIRST, mapbox::base::Value{});
+        settings.set(platform::EXPERIMENTAL_CACHED_LAYER_RANGE_LAST, mapbox::base::Value{});
+
+        test.observer.didBecomeIdleCallback = [&] { test.runLoop.stop(); };
+        test.map.getStyle().loadJSON(R"STYLE({
+          "version": 8,
+          "sources": {
+            "base": {
+              "type": "geojson",
+              "data": { "type": "Polygon", "coordinates": [[[-60, -40], [60, -40], [60, 40], [-60, 40], [-60, -40]]] }
+            },
+            "overlay": { "type": "geojson", "data": { "type": "Point", "coordinates": [0, 0] } }
+          },
+          "layers": [
+            { "id": "base", "type": "fill", "source": "base", "paint": { "fill-color": "blue" } },
+            { "id": "overlay", "type": "circle", "source": "overlay", "paint": { "circle-radius": 20 } }
+          ]
+        })STYLE");
+        test.runLoop.run();
+
+        std::vector<PremultipliedImage> images;
+        images.push_back(test.frontend.readStillImage());
+
+        // Only the overlay changes, the cached range composites from its texture.
+        test.map.getStyle().getSource("overlay")->as<GeoJSONSource>()->setGeoJSON(
+            Geometry<double>{Point<double>{30, 30}});
+        test.runLoop.run();
+        images.push_back(test.frontend.readStillImage());
+
+        test.map.jumpTo(CameraOptions().withZoom(1.0));
+        test.runLoop.run();
+        images.push_back(test.frontend.readStillImage());
+        return images;
+    };
+
+    const auto expected = renderFrames(false);
+    const auto actual = renderFrames(true);
+    ASSERT_EQ(expected.size(), actual.size());
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+        ASSERT_EQ(expected[i].size, actual[i].size);
+        // Antialiased edges are blended into the texture first, which may round differently.
+        for (std::size_t byte = 0; byte < expected[i].bytes(); ++byte) {
+            ASSERT_NEAR(expected[i].data[byte], actual[i].data[byte], 1) << "frame " << i << ", byte " << byte;
+        }
+    }
+}
+
+TEST(Map, UploadBudget) {
+    const auto renderFrames = [](bool budget) {
+        auto& settings = platform::Settings::getInstance();
+        if (budget) {
+            // Only the first tile of every frame fits.
+            settings.set(platform::EXPERIMENTAL_UPLOAD_BUDGET, uint64_t(1));
+        }
+        MapTest<> test { 1, MapMode::Continuous };
+        settings.set(platform::EXPERIMENTAL_UPLOAD_BUDGET, mapbox::base::Value{});
+
+        test.observer.didBecomeIdleCallback = [&] { test.runLoop.stop(); };
+        test.map.jumpTo(CameraOptions().withZoom(2.0));
+        test.map.getStyle().loadJSON(R"STYLE({
+          "version": 8,
+          "sources": {
+            "polygon": {
+              "type": "geojson",
+              "data": { "type": "Polygon", "coordinates": [[[-170, -80], [170, -80], [170, 80], [-170, 80], [-170, -80]]] }
+            }
+          },
+          "layers": [
+            { "id": "polygon", "type": "fill", "source": "polygon", "paint": { "fill-color": "blue" } }
+          ]
+        })STYLE");
+        test.runLoop.run();
+        return test.frontend.readStillImage();
+    };
+
+    // The tiles left out of a frame are rendered in the following ones, until the map is idle.
+    const auto expected = renderFrames(false);
+    const auto actual = renderFrames(true);
+    ASSERT_EQ(expected.size, actual.size);
+    EXPECT_EQ(0, std::memcmp(expected.data.get(), actual.data.get(), expected.bytes()));
+}
+
 TEST(Map, StyleLoadedSignal) {
     MapTest<> test;
 
@@ -1377,7 +1532,8 @@ TEST(Map, KeepRenderData) {
     test.map.jumpTo(CameraOptions().withZoom(10));
     test.map.getStyle().loadURL("mapbox://streets");
     const int iterations = 3;
-    const int resourcesCount = 4 /*tiles*/ + 3 /*fonts*/;
+    // The glyphs of all four font stacks of the style are prefetched, three of which the tiles use.
+    const int resourcesCount = 4 /*tiles*/ + 4 /*fonts*/;
     // Keep render data.
     for (int i = 1; i <= iterations; ++i) {
         test.frontend.render(test.map);
@@ -1472,3 +1628,148 @@ TEST(Map, PlacedSymbolData) {
 
     EXPECT_TRUE(test.frontend.getRenderer()->getPlacedSymbolsData().empty());
 }
+
+TEST(Map, ConcurrentPlacement) {
+    const auto render = [](bool concurrent) {
+        auto& settings = platform::Settings::getInstance();
+        settings.set(platform::EXPERIMENTAL_CONCURRENT_PLACEMENT, concurrent);
+        MapTest<> test{std::move(MapOptions().withMapMode(MapMode::Static).withCrossSourceCollisions(false))};
+        settings.set(platform::EXPERIMENTAL_CONCURRENT_PLACEMENT, mapbox::base::Value{});
+
+        test.fileSource->tileResponse = makeResponse("vector.tile");
+        test.fileSource->glyphsResponse = makeResponse("glyphs.pbf");
+        test.fileSource->sourceResponse = makeResponse("source_vector.json");
+
+        // Both sources load the same tiles, so their symbols overlap but only collide within a source.
+        test.map.jumpTo(CameraOptions().withZoom(12).withCenter(LatLng{38.917982, -77.037603}));
+        test.map.getStyle().loadJSON(R"STYLE({
+          "version": 8,
+          "glyphs": "mapbox://fonts/{fontstack}/{range}.pbf",
+          "sources": {
+            "a": { "type": "vector", "url": "mapbox://a" },
+            "b": { "type": "vector", "url": "mapbox://b" }
+          },
+          "layers": [
+            { "id": "a-roads", "type": "symbol", "source": "a", "source-layer": "road_label",
+              "layout": { "symbol-placement": "line", "text-field": "{name}", "text-font": ["Open Sans Regular"] } },
+            { "id": "b-pois", "type": "symbol", "source": "b", "source-layer": "poi_label",
+              "layout": { "text-field": "{name}", "text-font": ["Open Sans Regular"] } },
+            { "id": "a-pois", "type": "symbol", "source": "a", "source-layer": "poi_label",
+              "layout": { "text-field": "{name}", "text-font": ["Open Sans Regular"], "text-offset": [0, 1] } }
+          ]
+        })STYLE");
+        return test.frontend.render(test.map).image;
+    };
+
+    const PremultipliedImage sequential = render(false);
+    const PremultipliedImage concurrent = render(true);
+    ASSERT_EQ(sequential.size, concurrent.size);
+    EXPECT_EQ(0, std::memcmp(sequential.data.get(), concurrent.data.get(), sequential.bytes()));
+}
+
+TEST(Map, SharedHeadlessBackend) {
+    util::RunLoop runLoop;
+    std::shared_ptr<gfx::HeadlessBackend> backend = gfx::HeadlessBackend::Create();
+    auto fileSource = std::make_shared<StubFileSource>();
+    StubMapObserver observer;
+
+    HeadlessFrontend redFrontend{backend, {32, 16}, 1};
+    HeadlessFrontend blueFrontend{backend, {16, 32}, 1};
+    MapAdapter redMap(
+        redFrontend, observer, fileSource, MapOptions().withMapMode(MapMode::Static).withSize(redFrontend.getSize()));
+    MapAdapter blueMap(
+        blueFrontend, observer, fileSource, MapOptions().withMapMode(MapMode::Static).withSize(blueFrontend.getSize()));
+
+    const auto style = [](const std::string& color) {
+        return R"STYLE({"version": 8, "layers": [{"id": "background", "type": "background", "paint": {"background-color": ")STYLE" +
+               color + R"STYLE("}}]})STYLE";
+    };
+    redMap.getStyle().loadJSON(style("red"));
+    blueMap.getStyle().loadJSON(style("blue"));
+
+    // The maps take turns with the one context, each at its own size.
+    for (int i = 0; i < 2; ++i) {
+        const PremultipliedImage red = redFrontend.render(redMap).image;
+        EXPECT_EQ(Size(32, 16), red.size);
+        EXPECT_EQ(255, red.data[0]);
+        EXPECT_EQ(0, red.data[2]);
+
+        const PremultipliedImage blue = blueFrontend.render(blueMap).image;
+        EXPECT_EQ(Size(16, 32), blue.size);
+        EXPECT_EQ(0, blue.data[0]);
+        EXPECT_EQ(255, blue.data[2]);
+    }
+}
+
+TEST(Map, Metatile) {
+    MapTest<> test{std::move(MapOptions().withMapMode(MapMode::Tile))};
+    test.map.getStyle().loadJSON(R"STYLE({
+      "version": 8,
+      "sources": {
+        "west": {
+          "type": "geojson",
+          "data": { "type": "Polygon", "coordinates": [[[-180, -80], [0, -80], [0, 80], [-180, 80], [-180, -80]]] }
+        }
+      },
+      "layers": [{
+        "id": "background",
+        "type": "background",
+        "paint": { "background-color": "blue" }
+      }, {
+        "id": "west",
+        "type": "fill",
+        "source": "west",
+        "paint": { "fill-color": "red", "fill-antialias": false }
+      }]
+    })STYLE");
+
+    // The whole world at z1, in 256 pixel tiles.
+    const std::vector<PremultipliedImage> tiles = test.frontend.renderMetatile(test.map, {1, 0, 0}, 2, 256);
+    ASSERT_EQ(4u, tiles.size());
+    for (std::size_t i = 0; i < tiles.size(); ++i) {
+        const PremultipliedImage& tile = tiles[i];
+        EXPECT_EQ(Size(256, 256), tile.size);
+        const std::size_t center = (128 * 256 + 128) * 4;
+        const bool west = i % 2 == 0;
+        EXPECT_EQ(west ? 255 : 0, tile.data[center]);
+        EXPECT_EQ(west ? 0 : 255, tile.data[center + 2]);
+    }
+}
+
+TEST(Map, QueuedStillImages) {
+    MapTest<> test;
+    test.map.getStyle().loadJSON(R"STYLE({
+      "version": 8,
+      "sources": {
+        "north": {
+          "type": "geojson",
+          "data": { "type": "Polygon", "coordinates": [[[-180, 0], [180, 0], [180, 80], [-180, 80], [-180, 0]]] }
+        }
+      },
+      "layers": [{
+        "id": "background",
+        "type": "background",
+        "paint": { "background-color": "blue" }
+      }, {
+        "id": "north",
+        "type": "fill",
+        "source": "north",
+        "paint": { "fill-color": "red" }
+      }]
+    })STYLE");
+
+    const PremultipliedImage expected = test.frontend.render(test.map).image;
+
+    test.frontend.renderQueued(test.map);
+    test.map.jumpTo(CameraOptions().withCenter(LatLng{-40, 0}));
+    test.frontend.renderQueued(test.map);
+
+    // Queued images come back in order, with the same orientation as synchronous reads.
+    const PremultipliedImage first = test.frontend.takeQueuedImage();
+    ASSERT_EQ(expected.size, first.size);
+    EXPECT_EQ(0, std::memcmp(expected.data.get(), first.data.get(), expected.bytes()));
+
+    const PremultipliedImage second = test.frontend.takeQueuedImage();
+    ASSERT_EQ(expected.size, second.size);
+    EXPECT_NE(0, std::memcmp(expected.data.get(), second.data.get(), expected.bytes()));
+}
@@ -74,6 +74,53 @@ TEST(MapSnapshotter, setSize) {
     runLoop.run();
 }
 
+TEST(MapSnapshotter, snapshotBatch) {
+    util::RunLoop runLoop;
+    MapSnapshotter snapshotter(Size{32, 16}, 1.0f, ResourceOptions());
+    snapshotter.setStyleJSON(R"JSON({
+        "version": 8,
+        "layers": [{
+            "id": "background",
+            "type": "background",
+            "paint": {"background-color": "green"}
+        }]
+    })JSON");
+
+    std::vector<CameraOptions> cameras = {CameraOptions().withZoom(1.0),
+                                          CameraOptions().withZoom(2.0),
+                                          CameraOptions().withCenter(LatLng{10, 10}).withZoom(3.0)};
+    std::size_t expected = 0;
+    snapshotter.snapshotBatch(cameras,
+                              [&](std::size_t index,
+                                  std::exception_ptr ptr,
+                                  mbgl::PremultipliedImage image,
+                                  mbgl::MapSnapshotter::Attributions,
+                                  mbgl::MapSnapshotter::PointForFn pointForFn,
+                                  mbgl::MapSnapshotter::LatLngForFn) {
+                                  EXPECT_EQ(expected++, index);
+                                  EXPECT_EQ(nullptr, ptr);
+                                  EXPECT_EQ(32, image.size.width);
+                                  EXPECT_EQ(16, image.size.height);
+                                  EXPECT_EQ(cameras[index].zoom, snapshotter.getCameraOptions().zoom);
+                                  if (index == 2) {
+                                      const ScreenCoordinate center = pointForFn(LatLng{10, 10});
+                                      EXPECT_NEAR(16.0, center.x, 1e-6);
+                                      EXPECT_NEAR(8.0, center.y, 1e-6);
+                                      runLoop.stop();
+                                  }
+                              });
+
+    // Only one batch or image at a time.
+    snapshotter.snapshot([](std::exception_ptr ptr,
+                            mbgl::PremultipliedImage,
+                            mbgl::MapSnapshotter::Attributions,
+                            mbgl::MapSnapshotter::PointForFn,
+                            mbgl::MapSnapshotter::LatLngForFn) { EXPECT_NE(nullptr, ptr); });
+
+    runLoop.run();
+    EXPECT_EQ(3u, expected);
+}
+
 TEST(MapSnapshotter, TEST_REQUIRES_SERVER(setStyleURL)) {
     util::RunLoop runLoop;
     MapSnapshotter snapshotter(Size{64, 32}, 1.0f, ResourceOptions());
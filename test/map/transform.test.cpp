@@ -142,6 +142,33 @@ TEST(Transform, PerspectiveProjection) {
     ASSERT_LT(p[3], 0.0);
 }
 
+TEST(Transform, LatLngsToScreenCoordinates) {
+    Transform transform;
+    transform.resize({ 1000, 800 });
+    transform.jumpTo(CameraOptions().withCenter(LatLng { 38.0, -77.0 }).withZoom(10.0).withBearing(30).withPitch(50));
+
+    const std::vector<LatLng> latLngs = {
+        { 38.0, -77.0 }, { 38.74661326302018, -77.59198961199148 }, { 37.5, -76.5 }, { 7.692872969426375, -76.75823239205641 }
+    };
+    const std::vector<ScreenCoordinate> points = transform.getState().latLngsToScreenCoordinates(latLngs);
+    ASSERT_EQ(latLngs.size(), points.size());
+    for (std::size_t i = 0; i < latLngs.size(); ++i) {
+        const ScreenCoordinate point = transform.getState().latLngToScreenCoordinate(latLngs[i]);
+        EXPECT_DOUBLE_EQ(point.x, points[i].x);
+        EXPECT_DOUBLE_EQ(point.y, points[i].y);
+    }
+
+    // The cached projection follows changes of the state.
+    mat4 projMatrix;
+    transform.getState().getProjMatrix(projMatrix);
+    EXPECT_EQ(transform.getState().getProjectionMatrix(), projMatrix);
+    transform.jumpTo(CameraOptions().withBearing(60));
+    mat4 rotatedProjMatrix;
+    transform.getState().getProjMatrix(rotatedProjMatrix);
+    EXPECT_NE(projMatrix, rotatedProjMatrix);
+    EXPECT_EQ(transform.getState().getProjectionMatrix(), rotatedProjMatrix);
+}
+
 TEST(Transform, UnwrappedLatLng) {
     Transform transform;
     transform.resize({ 1000, 1000 });
@@ -508,6 +535,36 @@ TEST(Transform, Camera) {
     ASSERT_DOUBLE_EQ(transform.getLatLng().longitude(), 0);
 }
 
+TEST(Transform, TransitionTarget) {
+    Transform transform;
+    transform.resize({1000, 1000});
+    transform.jumpTo(CameraOptions().withCenter(LatLng{0, 0}).withZoom(2.0));
+    EXPECT_FALSE(transform.getTransitionTarget());
+
+    const LatLng destination{45, 135};
+    transform.flyTo(CameraOptions().withCenter(destination).withZoom(12.0), AnimationOptions(Seconds(1)));
+    ASSERT_TRUE(transform.getTransitionTarget());
+    // The destination is known before the camera moves.
+    EXPECT_DOUBLE_EQ(2.0, transform.getZoom());
+    EXPECT_NEAR(12.0, transform.getTransitionTarget()->getZoom(), 1e-5);
+    EXPECT_NEAR(destination.latitude(), transform.getTransitionTarget()->getLatLng().latitude(), 1e-5);
+    EXPECT_NEAR(destination.longitude(), transform.getTransitionTarget()->getLatLng().longitude(), 1e-5);
+
+    transform.updateTransitions(transform.getTransitionStart() + Milliseconds(500));
+    EXPECT_TRUE(transform.getTransitionTarget());
+    transform.updateTransitions(transform.getTransitionStart() + transform.getTransitionDuration());
+    EXPECT_FALSE(transform.getTransitionTarget());
+    EXPECT_NEAR(12.0, transform.getZoom(), 1e-5);
+
+    // Cancelled and immediate transitions have no target.
+    transform.easeTo(CameraOptions().withZoom(4.0), AnimationOptions(Seconds(1)));
+    EXPECT_TRUE(transform.getTransitionTarget());
+    transform.cancelTransitions();
+    EXPECT_FALSE(transform.getTransitionTarget());
+    transform.easeTo(CameraOptions().withZoom(4.0));
+    EXPECT_FALSE(transform.getTransitionTarget());
+}
+
 TEST(Transform, ProjectionMode) {
     Transform transform;
 
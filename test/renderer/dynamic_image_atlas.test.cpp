@@ -0,0 +1,92 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/renderer/dynamic_image_atlas.hpp>
+#include <mbgl/renderer/image_manager.hpp>
+#include <mbgl/style/image_impl.hpp>
+
+#include <string>
+
+using namespace mbgl;
+
+namespace {
+
+Immutable<style::Image::Impl> makeImage(const std::string& id, uint32_t size) {
+    return makeMutable<style::Image::Impl>(id, PremultipliedImage({size, size}), 1);
+}
+
+} // namespace
+
+TEST(DynamicImageAtlas, SharesImages) {
+    auto atlas = DynamicImageAtlas::create();
+    ImageMap first{{"one", makeImage("one", 16)}};
+    ImageMap second{{"one", makeImage("one", 16)}, {"two", makeImage("two", 16)}};
+
+    ImageAtlas firstPositions;
+    auto firstReservation = atlas->addImages(first, {}, {}, firstPositions);
+    EXPECT_EQ(1u, atlas->imageCount());
+
+    ImageAtlas secondPositions;
+    auto secondReservation = atlas->addImages(second, first, {}, secondPositions);
+    // Icons and patterns are stored separately, patterns have a wrapped border.
+    EXPECT_EQ(3u, atlas->imageCount());
+    EXPECT_EQ(firstPositions.iconPositions.at("one").paddedRect, secondPositions.iconPositions.at("one").paddedRect);
+    EXPECT_FALSE(secondPositions.iconPositions.at("one").paddedRect ==
+                 secondPositions.patternPositions.at("one").paddedRect);
+    EXPECT_EQ(Rect<uint16_t>(0, 0, 18, 18), firstPositions.iconPositions.at("one").paddedRect);
+
+    // Images stay in the atlas as long as any tile uses them.
+    firstReservation.reset();
+    EXPECT_EQ(3u, atlas->imageCount());
+    secondReservation.reset();
+    EXPECT_EQ(0u, atlas->imageCount());
+}
+
+TEST(DynamicImageAtlas, Grows) {
+    auto atlas = DynamicImageAtlas::create();
+    const Size initialSize = atlas->getSize();
+
+    ImageMap icons;
+    for (uint32_t i = 0; i < 64; ++i) {
+        const std::string id = "icon-" + std::to_string(i);
+        icons.emplace(id, makeImage(id, 30));
+    }
+
+    ImageAtlas positions;
+    auto reservation = atlas->addImages(icons, {}, {}, positions);
+    EXPECT_EQ(64u, atlas->imageCount());
+    const Size size = atlas->getSize();
+    EXPECT_TRUE(size.width > initialSize.width || size.height > initialSize.height);
+    for (const auto& position : positions.iconPositions) {
+        EXPECT_LE(position.second.paddedRect.x + position.second.paddedRect.w, size.width);
+        EXPECT_LE(position.second.paddedRect.y + position.second.paddedRect.h, size.height);
+    }
+}
+
+TEST(DynamicImageAtlas, UpdatesImagesOfImageManager) {
+    ImageManager imageManager;
+    const auto& atlas = imageManager.getImageAtlas();
+    imageManager.addImage(makeImage("one", 16));
+
+    ImageAtlas before;
+    auto beforeReservation = atlas->addImages({{"one", *imageManager.getSharedImage("one")}}, {}, {}, before);
+
+    // Updates of the same size are painted over the shared entry.
+    EXPECT_FALSE(imageManager.updateImage(makeImage("one", 16)));
+    ImageAtlas updated;
+    auto updatedReservation = atlas->addImages(
+        {{"one", *imageManager.getSharedImage("one")}}, {}, imageManager.updatedImageVersions, updated);
+    EXPECT_EQ(1u, atlas->imageCount());
+    EXPECT_EQ(before.iconPositions.at("one").paddedRect, updated.iconPositions.at("one").paddedRect);
+    EXPECT_EQ(1u, updated.iconPositions.at("one").version);
+
+    // An image of a different size gets a new entry; tiles laid out before keep the old one.
+    EXPECT_TRUE(imageManager.updateImage(makeImage("one", 24)));
+    ImageAtlas resized;
+    auto resizedReservation = atlas->addImages({{"one", *imageManager.getSharedImage("one")}}, {}, {}, resized);
+    EXPECT_EQ(2u, atlas->imageCount());
+    EXPECT_EQ(26, resized.iconPositions.at("one").paddedRect.w);
+
+    beforeReservation.reset();
+    updatedReservation.reset();
+    EXPECT_EQ(1u, atlas->imageCount());
+}
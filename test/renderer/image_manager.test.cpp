@@ -30,7 +30,7 @@ TEST(ImageManager, Basic) {
         imageManager.addImage(image);
         auto* stored = imageManager.getImage(image->id);
         ASSERT_TRUE(stored);
-        EXPECT_EQ(image->image.size, stored->image.size);
+        EXPECT_EQ(image->size, stored->size);
     }
 }
 
@@ -341,10 +341,45 @@ TEST(ImageManager, RemoveUnusedStyleImages) {
     ASSERT_FALSE(imageManager.getImage("1024px") == nullptr);
 
     // Release last requestor and check if resource was released when cache size is over the limit.
+    // The image that was used last fits in the cache once the other one is removed.
     requestor.reset();
     imageManager.reduceMemoryUseIfCacheSizeExceedsLimit();
     runLoop.runOnce();
-    ASSERT_TRUE(imageManager.getImage("missing") == nullptr);
+    ASSERT_FALSE(imageManager.getImage("missing") == nullptr);
     ASSERT_TRUE(imageManager.getImage("1024px") == nullptr);
     ASSERT_FALSE(imageManager.getImage("sprite") == nullptr);
 }
+
+TEST(ImageManager, RemoveLeastRecentlyUsedStyleImages) {
+    util::RunLoop runLoop;
+    ImageManager imageManager;
+    StubImageManagerObserver observer;
+    imageManager.setObserver(&observer);
+    imageManager.setLoaded(true);
+    // Two images of 16x16 pixels.
+    imageManager.setOnDemandImagesCacheSize(2 * 16 * 16 * 4);
+
+    observer.imageMissing = [&imageManager] (const std::string& id) {
+        imageManager.addImage(makeMutable<style::Image::Impl>(id, PremultipliedImage({ 16, 16 }), 1));
+    };
+
+    std::vector<std::string> removed;
+    observer.removeUnusedStyleImages = [&](const std::vector<std::string>& ids) {
+        for (const auto& id : ids) {
+            removed.push_back(id);
+            imageManager.removeImage(id);
+        }
+    };
+
+    for (const std::string id : {"a", "b", "c", "a"}) {
+        StubImageRequestor requestor(imageManager);
+        imageManager.getImages(requestor, std::make_pair(ImageDependencies{{id, ImageType::Icon}}, 0ull));
+        runLoop.runOnce();
+    }
+    EXPECT_EQ(observer.count, 3);
+
+    imageManager.reduceMemoryUseIfCacheSizeExceedsLimit();
+    EXPECT_EQ(std::vector<std::string>{"b"}, removed);
+    ASSERT_FALSE(imageManager.getImage("a") == nullptr);
+    ASSERT_FALSE(imageManager.getImage("c") == nullptr);
+}
@@ -0,0 +1,27 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/renderer/upload_budget.hpp>
+
+using namespace mbgl;
+
+TEST(UploadBudget, Take) {
+    UploadBudget budget(100);
+    EXPECT_TRUE(budget.take(60));
+    EXPECT_TRUE(budget.take(40));
+    EXPECT_FALSE(budget.isExceeded());
+
+    EXPECT_FALSE(budget.take(1));
+    EXPECT_TRUE(budget.isExceeded());
+
+    // Empty uploads still fit.
+    EXPECT_TRUE(budget.take(0));
+}
+
+TEST(UploadBudget, FirstTakeAlwaysFits) {
+    UploadBudget budget(100);
+    EXPECT_TRUE(budget.take(1000));
+    EXPECT_FALSE(budget.isExceeded());
+
+    EXPECT_FALSE(budget.take(10));
+    EXPECT_TRUE(budget.isExceeded());
+}
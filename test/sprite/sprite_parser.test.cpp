@@ -324,10 +324,10 @@ TEST(Sprite, SpriteParsing) {
     {
         auto& sprite =
             *std::find_if(images.begin(), images.end(), [](const auto& image) { return image->id == "generic-metro"; });
-        EXPECT_EQ(18u, sprite->image.size.width);
-        EXPECT_EQ(18u, sprite->image.size.height);
+        EXPECT_EQ(18u, sprite->size.width);
+        EXPECT_EQ(18u, sprite->size.height);
         EXPECT_EQ(1, sprite->pixelRatio);
-        EXPECT_EQ(readImage("test/fixtures/annotations/result-spriteparsing.png"), sprite->image);
+        EXPECT_EQ(readImage("test/fixtures/annotations/result-spriteparsing.png"), sprite->getImage());
     }
 }
 
@@ -34,11 +34,20 @@ struct MockTileData {
         return renderable;
     }
 
+    bool isReadyToRender() const {
+        return renderable;
+    }
+
     bool isLoaded() const {
         return loaded;
     }
 
+    bool isPartial() const {
+        return renderable && partial;
+    }
+
     bool renderable = false;
+    bool partial = false;
     bool triedOptional = false;
     bool loaded = false;
     const mbgl::OverscaledTileID tileID;
@@ -44,12 +44,19 @@ public:
         }
     }
 
+    void onDidUpdateLoadProgress(const LoadProgress& progress) final {
+        if (didUpdateLoadProgressCallback) {
+            didUpdateLoadProgressCallback(progress);
+        }
+    }
+
     std::function<void()> willStartLoadingMapCallback;
     std::function<void()> didFinishLoadingMapCallback;
     std::function<void()> didFailLoadingMapCallback;
     std::function<void()> didFinishLoadingStyleCallback;
     std::function<void(RenderFrameStatus)> didFinishRenderingFrameCallback;
     std::function<void()> didBecomeIdleCallback;
+    std::function<void(const LoadProgress&)> didUpdateLoadProgressCallback;
 };
 
 
@@ -10,6 +10,10 @@ using namespace mbgl::style;
  */
 class StubStyleObserver : public style::Observer {
 public:
+    void onUpdate() override {
+        if (update) update();
+    }
+
     void onSourceLoaded(Source& source) override {
         if (sourceLoaded) sourceLoaded(source);
     }
@@ -30,6 +34,7 @@ public:
         if (resourceError) resourceError(error);
     };
 
+    std::function<void ()> update;
     std::function<void (Source&)> sourceLoaded;
     std::function<void (Source&)> sourceChanged;
     std::function<void (Source&, std::exception_ptr)> sourceError;
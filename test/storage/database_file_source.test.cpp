@@ -2,6 +2,7 @@
 #include <mbgl/storage/resource.hpp>
 #include <mbgl/storage/resource_options.hpp>
 #include <mbgl/test/util.hpp>
+#include <mbgl/util/io.hpp>
 #include <mbgl/util/run_loop.hpp>
 #include <mbgl/util/timer.hpp>
 
@@ -23,4 +24,38 @@ TEST(DatabaseFileSource, PauseResume) {
     resumeTimer.start(Milliseconds(5), Duration::zero(), [dbfs] { dbfs->resume(); });
 
     loop.run();
-}
\ No newline at end of file
+}
+TEST(DatabaseFileSource, TEST_REQUIRES_WRITE(ReaderPool)) {
+    util::RunLoop loop;
+
+    const std::string path = "test/fixtures/offline_database/reader_pool.db";
+    util::deleteFile(path);
+    util::deleteFile(path + "-wal");
+    util::deleteFile(path + "-shm");
+
+    std::shared_ptr<FileSource> dbfs =
+        FileSourceManager::get()->getFileSource(FileSourceType::Database, ResourceOptions().withCachePath(path));
+    dbfs->setProperty(READER_POOL_SIZE_KEY, uint64_t(2));
+    EXPECT_EQ(2u, *dbfs->getProperty(READER_POOL_SIZE_KEY).getUint());
+
+    const Resource res{Resource::Unknown, "http://127.0.0.1:3000/test", {}, Resource::LoadingMethod::CacheOnly};
+    Response response;
+    response.data = std::make_shared<std::string>("Hello World!");
+
+    std::unique_ptr<AsyncRequest> req;
+    dbfs->forward(res, response, [&] {
+        req = dbfs->request(res, [&](const Response& cached) {
+            EXPECT_EQ(nullptr, cached.error);
+            ASSERT_TRUE(cached.data.get());
+            EXPECT_EQ("Hello World!", *cached.data);
+
+            const auto latency = dbfs->getProperty(QUEUE_LATENCY_KEY);
+            ASSERT_NE(nullptr, latency.getObject());
+            EXPECT_EQ(3u, latency.getObject()->size());
+            EXPECT_EQ(1u, *latency.getObject()->at("reader-0").getObject()->at("requests").getUint());
+            loop.stop();
+        });
+    });
+
+    loop.run();
+}
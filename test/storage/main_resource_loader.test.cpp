@@ -796,3 +796,108 @@ TEST(MainResourceLoader, TEST_REQUIRES_SERVER(NoDoubleDispatch)) {
 
     loop.run();
 }
+
+TEST(MainResourceLoader, MemoryCache) {
+    util::RunLoop loop;
+    MainResourceLoader fs(ResourceOptions{});
+    EXPECT_EQ(8u * 1024 * 1024, *fs.getProperty(MEMORY_CACHE_SIZE_KEY).getUint());
+
+    const Resource resource{
+        Resource::Unknown, "http://127.0.0.1:3000/memory-cache", {}, Resource::LoadingMethod::CacheOnly};
+
+    using namespace std::chrono_literals;
+
+    Response response;
+    response.data = std::make_shared<std::string>("Cached value");
+    response.expires = util::now() + 1h;
+
+    Response updated;
+    updated.data = std::make_shared<std::string>("Updated value");
+    updated.expires = util::now() + 1h;
+
+    std::unique_ptr<AsyncRequest> req;
+    std::shared_ptr<FileSource> dbfs =
+        FileSourceManager::get()->getFileSource(FileSourceType::Database, ResourceOptions{});
+    dbfs->forward(resource, response, [&] {
+        req = fs.request(resource, [&](Response res) {
+            req.reset();
+            ASSERT_TRUE(res.data.get());
+            EXPECT_EQ("Cached value", *res.data);
+
+            dbfs->forward(resource, updated, [&] {
+                req = fs.request(resource, [&](Response res2) {
+                    req.reset();
+                    // Served from memory, without reading the database.
+                    ASSERT_TRUE(res2.data.get());
+                    EXPECT_EQ("Cached value", *res2.data);
+                    EXPECT_EQ(res.data, res2.data);
+
+                    const auto stats = fs.getProperty(MEMORY_CACHE_STATS_KEY);
+                    ASSERT_NE(nullptr, stats.getObject());
+                    EXPECT_EQ(1u, *stats.getObject()->at("hits").getUint());
+                    EXPECT_EQ(1u, *stats.getObject()->at("misses").getUint());
+                    EXPECT_EQ(1u, *stats.getObject()->at("count").getUint());
+
+                    // Disabling the cache drops the response.
+                    fs.setProperty(MEMORY_CACHE_SIZE_KEY, uint64_t(0));
+                    req = fs.request(resource, [&](Response res3) {
+                        req.reset();
+                        ASSERT_TRUE(res3.data.get());
+                        EXPECT_EQ("Updated value", *res3.data);
+                        loop.stop();
+                    });
+                });
+            });
+        });
+    });
+
+    loop.run();
+}
+
+TEST(MainResourceLoader, TEST_REQUIRES_SERVER(RequestTiming)) {
+    util::RunLoop loop;
+    MainResourceLoader fs(ResourceOptions{});
+
+    const Resource resource{Resource::Unknown, "http://127.0.0.1:3000/test"};
+
+    bool databaseTimed = false;
+    bool networkTimed = false;
+    fs.setTimingObserver([&](const Resource& res, const Response::Timing& timing) {
+        EXPECT_EQ(resource.url, res.url);
+        if (timing.database) {
+            databaseTimed = true;
+        }
+        if (timing.network) {
+            EXPECT_TRUE(bool(timing.queued));
+            EXPECT_TRUE(bool(timing.dns));
+            // The test server speaks plain HTTP.
+            EXPECT_FALSE(bool(timing.tls));
+            EXPECT_LE(*timing.firstByte, *timing.network);
+            networkTimed = true;
+        }
+    });
+
+    std::unique_ptr<AsyncRequest> req = fs.request(resource, [&](Response res) {
+        ASSERT_TRUE(res.data.get());
+        EXPECT_EQ("Hello World!", *res.data);
+        if (!networkTimed) {
+            return;
+        }
+        req.reset();
+        EXPECT_TRUE(databaseTimed);
+
+        const auto stats = fs.getProperty(REQUEST_TIMING_KEY);
+        ASSERT_NE(nullptr, stats.getObject());
+        const auto& network = *stats.getObject()->at("network").getObject();
+        EXPECT_EQ(1u, *network.at("requests").getUint());
+        uint64_t counted = 0;
+        for (const auto& bucket : *network.at("buckets").getArray()) {
+            counted += *bucket.getObject()->at("count").getUint();
+        }
+        EXPECT_EQ(1u, counted);
+        EXPECT_EQ(0u, *stats.getObject()->at("tls").getObject()->at("requests").getUint());
+        loop.stop();
+    });
+
+    loop.run();
+}
@@ -227,7 +227,7 @@ TEST(OfflineDatabase, TEST_REQUIRES_WRITE(SchemaVersion)) {
         OfflineDatabase db(filename);
     }
 
-    EXPECT_EQ(6, databaseUserVersion(filename));
+    EXPECT_EQ(10, databaseUserVersion(filename));
 
     OfflineDatabase db(filename);
     // Now try inserting and reading back to make sure we have a valid database.
@@ -387,6 +387,53 @@ TEST(OfflineDatabase, PutTile) {
     EXPECT_EQ(0u, log.uncheckedCount());
 }
 
+TEST(OfflineDatabase, TEST_REQUIRES_WRITE(PutTileSharesData)) {
+    FixtureLog log;
+    deleteDatabaseFiles();
+
+    auto tile = [](int32_t x) {
+        Resource resource{Resource::Tile, "http://example.com/"};
+        resource.tileData = Resource::TileData{"http://example.com/", 1, x, 0, 0};
+        return resource;
+    };
+    auto tileDataCount = [] {
+        mapbox::sqlite::Database db = mapbox::sqlite::Database::open(filename, mapbox::sqlite::ReadOnly);
+        mapbox::sqlite::Statement stmt{db, "SELECT COUNT(*) FROM tile_data"};
+        mapbox::sqlite::Query query{stmt};
+        query.run();
+        return query.get<int>(0);
+    };
+
+    {
+        OfflineDatabase db(filename);
+        Response ocean;
+        ocean.data = std::make_shared<std::string>("ocean");
+        Response land;
+        land.data = std::make_shared<std::string>("land");
+
+        db.put(tile(0), ocean);
+        db.put(tile(1), ocean);
+        db.put(tile(2), land);
+        EXPECT_EQ(2, tileDataCount());
+        EXPECT_EQ("ocean", *db.get(tile(0))->data);
+        EXPECT_EQ("ocean", *db.get(tile(1))->data);
+        EXPECT_EQ("land", *db.get(tile(2))->data);
+        EXPECT_EQ(5, *db.hasRegionResource(tile(1)));
+
+        // The data goes once no tile refers to it anymore.
+        db.put(tile(0), land);
+        EXPECT_EQ(2, tileDataCount());
+        db.put(tile(1), land);
+        EXPECT_EQ(1, tileDataCount());
+        EXPECT_EQ("land", *db.get(tile(0))->data);
+
+        EXPECT_FALSE(db.clearAmbientCache());
+        EXPECT_EQ(0, tileDataCount());
+    }
+
+    EXPECT_EQ(0u, log.uncheckedCount());
+}
+
 TEST(OfflineDatabase, PutResourceNoContent) {
     FixtureLog log;
     OfflineDatabase db(":memory:");
@@ -1035,6 +1082,168 @@ TEST(OfflineDatabase, TEST_REQUIRES_WRITE(ConcurrentUse)) {
     EXPECT_EQ(0u, log.uncheckedCount());
 }
 
+TEST(OfflineDatabase, BatchedPuts) {
+    FixtureLog log;
+    OfflineDatabase db(":memory:");
+    db.setWriteBatchSize(3);
+
+    const Resource first = Resource::style("mapbox://example.com/first");
+    const Resource second = Resource::style("mapbox://example.com/second");
+    const Resource third = Resource::style("mapbox://example.com/third");
+
+    EXPECT_TRUE(db.put(first, fixture::response).first);
+    EXPECT_TRUE(db.put(second, fixture::response).first);
+    EXPECT_TRUE(db.hasPendingWrites());
+    // Buffered writes are visible to reads.
+    EXPECT_TRUE(bool(db.get(first)));
+
+    // The batch is committed once it is full.
+    EXPECT_TRUE(db.put(third, fixture::response).first);
+    EXPECT_FALSE(db.hasPendingWrites());
+
+    EXPECT_TRUE(db.put(first, fixture::response).first);
+    EXPECT_TRUE(db.hasPendingWrites());
+    EXPECT_EQ(nullptr, db.flushPendingWrites());
+    EXPECT_FALSE(db.hasPendingWrites());
+
+    // Other modifications commit the batch first.
+    EXPECT_TRUE(db.put(second, fixture::response).first);
+    EXPECT_EQ(nullptr, db.invalidateAmbientCache());
+    EXPECT_FALSE(db.hasPendingWrites());
+
+    EXPECT_EQ(0u, log.uncheckedCount());
+}
+
+TEST(OfflineDatabase, TEST_REQUIRES_WRITE(WriteAheadLogging)) {
+    FixtureLog log;
+    deleteDatabaseFiles();
+
+    {
+        OfflineDatabase db(filename);
+        db.setWriteAheadLogging(true);
+        EXPECT_TRUE(db.put(fixture::resource, fixture::response).first);
+        EXPECT_EQ("wal", databaseJournalMode(filename));
+
+        db.setWriteAheadLogging(false);
+        EXPECT_EQ("delete", databaseJournalMode(filename));
+        EXPECT_TRUE(bool(db.get(fixture::resource)));
+    }
+
+    EXPECT_EQ(0u, log.uncheckedCount());
+}
+
+TEST(OfflineDatabase, TEST_REQUIRES_WRITE(CompressionDictionary)) {
+    FixtureLog log;
+    deleteDatabaseFiles();
+
+    // Tiles of a tileset share their layer names, keys and values.
+    auto tileData = [](int i) {
+        std::string data;
+        for (int j = 0; j < 20; ++j) {
+            data += "layer=road;class=street;name=" + std::to_string(i * 97 + j) + ";surface=paved;oneway=no;";
+        }
+        return data;
+    };
+    auto tile = [](int x) {
+        return Resource::tile("mapbox://tiles/test/{z}/{x}/{y}.vector.pbf", 1, x, 0, 10, Tileset::Scheme::XYZ);
+    };
+
+    {
+        OfflineDatabase db(filename);
+        for (int i = 0; i < 40; ++i) {
+            Response response;
+            response.data = std::make_shared<std::string>(tileData(i));
+            db.put(tile(i), response);
+        }
+    }
+
+    {
+        mapbox::sqlite::Database sqlite = mapbox::sqlite::Database::open(filename, mapbox::sqlite::ReadOnly);
+        mapbox::sqlite::Statement dictionaries{sqlite, "SELECT COUNT(*) FROM dictionaries"};
+        mapbox::sqlite::Query dictionariesQuery{dictionaries};
+        ASSERT_TRUE(dictionariesQuery.run());
+        EXPECT_EQ(1, dictionariesQuery.get<int>(0));
+
+        // The dictionary is trained once 32 tiles were sampled.
+        mapbox::sqlite::Statement tiles{sqlite, "SELECT x, compressed FROM tiles ORDER BY x"};
+        mapbox::sqlite::Query tilesQuery{tiles};
+        while (tilesQuery.run()) {
+            EXPECT_EQ(tilesQuery.get<int>(0) < 31 ? 1 : 2, tilesQuery.get<int>(1));
+        }
+    }
+
+    OfflineDatabase db(filename);
+    for (int i = 0; i < 40; ++i) {
+        auto result = db.get(tile(i));
+        ASSERT_TRUE(result && result->data);
+        EXPECT_EQ(tileData(i), *result->data);
+    }
+
+    EXPECT_EQ(0u, log.uncheckedCount());
+}
+
+TEST(OfflineDatabase, GetCompressed) {
+    FixtureLog log;
+    OfflineDatabase db(":memory:");
+
+    Response response;
+    response.data = std::make_shared<std::string>(1024, 'a');
+    db.put(fixture::tile, response);
+    response.data = std::make_shared<std::string>("first");
+    db.put(fixture::resource, response);
+
+    // Inflating is left to the caller.
+    auto tile = db.getCompressed(fixture::tile);
+    ASSERT_TRUE(tile && tile->response.data);
+    EXPECT_TRUE(tile->compressed);
+    EXPECT_LT(tile->response.data->size(), 1024u);
+    tile->decompress();
+    EXPECT_FALSE(tile->compressed);
+    EXPECT_EQ(std::string(1024, 'a'), *tile->response.data);
+
+    // Data that doesn't compress is stored as it is.
+    auto resource = db.getCompressed(fixture::resource);
+    ASSERT_TRUE(resource && resource->response.data);
+    EXPECT_FALSE(resource->compressed);
+    EXPECT_EQ("first", *resource->response.data);
+
+    EXPECT_EQ(0u, log.uncheckedCount());
+}
+
+TEST(OfflineDatabase, TEST_REQUIRES_WRITE(AccessTimeResolution)) {
+    FixtureLog log;
+    deleteDatabaseFiles();
+
+    OfflineDatabase db(filename);
+    db.setAccessTimeResolution(Seconds(60));
+    db.put(fixture::resource, fixture::response);
+    EXPECT_FALSE(db.hasPendingWrites());
+
+    mapbox::sqlite::Database sqlite = mapbox::sqlite::Database::open(filename, mapbox::sqlite::ReadWriteCreate);
+    sqlite.exec("UPDATE resources SET accessed = 0");
+    auto accessed = [&] {
+        mapbox::sqlite::Statement stmt{sqlite, "SELECT accessed FROM resources"};
+        mapbox::sqlite::Query query{stmt};
+        query.run();
+        return query.get<int64_t>(0);
+    };
+
+    // Reads buffer their access time.
+    EXPECT_TRUE(bool(db.get(fixture::resource)));
+    EXPECT_TRUE(bool(db.get(fixture::resource)));
+    EXPECT_TRUE(db.hasPendingWrites());
+    EXPECT_EQ(0, accessed());
+
+    EXPECT_EQ(nullptr, db.flushPendingWrites());
+    EXPECT_FALSE(db.hasPendingWrites());
+    const int64_t flushed = accessed();
+    EXPECT_GT(flushed, 0);
+    EXPECT_EQ(0, flushed % 60);
+    EXPECT_LE(flushed, util::now().time_since_epoch().count());
+
+    EXPECT_EQ(0u, log.uncheckedCount());
+}
+
 TEST(OfflineDatabase, PutReturnsSize) {
     FixtureLog log;
     OfflineDatabase db(":memory:");
@@ -1135,6 +1344,50 @@ TEST(OfflineDatabase, PutRegionResourceDoesNotEvict) {
     EXPECT_EQ(0u, log.uncheckedCount());
 }
 
+TEST(OfflineDatabase, TEST_REQUIRES_WRITE(StoresAmbientCacheSize)) {
+    FixtureLog log;
+    deleteDatabaseFiles();
+
+    auto storedSize = [] {
+        mapbox::sqlite::Database sqlite = mapbox::sqlite::Database::open(filename, mapbox::sqlite::ReadOnly);
+        mapbox::sqlite::Statement stmt{sqlite, "SELECT size FROM ambient_cache"};
+        mapbox::sqlite::Query query{stmt};
+        return query.run() ? query.get<int64_t>(0) : int64_t(-1);
+    };
+
+    Response response;
+    response.data = randomString(1024);
+
+    {
+        OfflineDatabase db(filename);
+        db.setMaximumAmbientCacheSize(1024 * 100);
+        for (uint32_t i = 1; i <= 50; ++i) {
+            db.put(Resource::style("http://example.com/"s + util::toString(i)), response);
+        }
+    }
+
+    const int64_t size = storedSize();
+    EXPECT_GT(size, 1024 * 50);
+    EXPECT_LE(size, 1024 * 100);
+
+    // The stored size carries over, so the reopened database keeps evicting at the limit.
+    {
+        OfflineDatabase db(filename);
+        db.setMaximumAmbientCacheSize(1024 * 100);
+        for (uint32_t i = 51; i <= 101; ++i) {
+            db.put(Resource::style("http://example.com/"s + util::toString(i)), response);
+        }
+        EXPECT_FALSE(bool(db.get(Resource::style("http://example.com/1"))));
+        EXPECT_TRUE(bool(db.get(Resource::style("http://example.com/101"))));
+
+        EXPECT_EQ(nullptr, db.clearAmbientCache());
+    }
+
+    EXPECT_EQ(0, storedSize());
+
+    EXPECT_EQ(0u, log.uncheckedCount());
+}
+
 TEST(OfflineDatabase, PutFailsWhenEvictionInsuffices) {
     FixtureLog log;
     OfflineDatabase db(":memory:");
@@ -1395,7 +1648,7 @@ TEST(OfflineDatabase, MigrateFromV2Schema) {
         }
     }
 
-    EXPECT_EQ(6, databaseUserVersion(filename));
+    EXPECT_EQ(10, databaseUserVersion(filename));
     EXPECT_LT(databasePageCount(filename),
               databasePageCount("test/fixtures/offline_database/v2.db"));
 
@@ -1418,7 +1671,7 @@ TEST(OfflineDatabase, MigrateFromV3Schema) {
         }
     }
 
-    EXPECT_EQ(6, databaseUserVersion(filename));
+    EXPECT_EQ(10, databaseUserVersion(filename));
 
     EXPECT_EQ(0u, log.uncheckedCount());
 }
@@ -1439,7 +1692,7 @@ TEST(OfflineDatabase, MigrateFromV4Schema) {
         }
     }
 
-    EXPECT_EQ(6, databaseUserVersion(filename));
+    EXPECT_EQ(10, databaseUserVersion(filename));
 
     // Journal mode should be DELETE after migration to v5.
     EXPECT_EQ("delete", databaseJournalMode(filename));
@@ -1467,7 +1720,7 @@ TEST(OfflineDatabase, MigrateFromV5Schema) {
         }
     }
 
-    EXPECT_EQ(6, databaseUserVersion(filename));
+    EXPECT_EQ(10, databaseUserVersion(filename));
 
     EXPECT_EQ((std::vector<std::string>{"id",
                                         "url_template",
@@ -1481,7 +1734,8 @@ TEST(OfflineDatabase, MigrateFromV5Schema) {
                                         "data",
                                         "compressed",
                                         "accessed",
-                                        "must_revalidate"}),
+                                        "must_revalidate",
+                                        "data_id"}),
               databaseTableColumns(filename, "tiles"));
     EXPECT_EQ(
         (std::vector<std::string>{
@@ -1524,11 +1778,11 @@ TEST(OfflineDatabase, DowngradeSchema) {
         db.setMaximumAmbientCacheSize(0);
     }
 
-    EXPECT_EQ(6, databaseUserVersion(filename));
+    EXPECT_EQ(10, databaseUserVersion(filename));
 
     EXPECT_EQ((std::vector<std::string>{ "id", "url_template", "pixel_ratio", "z", "x", "y",
                                          "expires", "modified", "etag", "data", "compressed",
-                                         "accessed", "must_revalidate" }),
+                                         "accessed", "must_revalidate", "data_id" }),
               databaseTableColumns(filename, "tiles"));
     EXPECT_EQ((std::vector<std::string>{ "id", "url", "kind", "expires", "modified", "etag", "data",
                                          "compressed", "accessed", "must_revalidate" }),
@@ -1814,6 +2068,45 @@ TEST(OfflineDatabase, MergeDatabaseWithMultipleRegionsWithOverlap) {
     }
 }
 
+TEST(OfflineDatabase, MergeDatabaseInChunks) {
+    FixtureLog log;
+    util::deleteFile(filename_sideload);
+    util::copyFile(filename_sideload, "test/fixtures/offline_database/sideload_sat_multiple.db");
+
+    OfflineDatabase db(":memory:");
+    EXPECT_FALSE(db.beginMerge(filename_sideload));
+    // The regions are added first.
+    EXPECT_EQ(2u, db.listRegions()->size());
+    EXPECT_EQ(std::make_pair(uint64_t(0), uint64_t(3 + 1)), db.getMergeProgress());
+
+    EXPECT_TRUE(db.beginMerge(filename_sideload));
+    EXPECT_EQ(1u, log.count({ EventSeverity::Error, Event::Database, -1, "Can't merge database (test/fixtures/offline_database/offline_sideload.db): another merge is in progress" }));
+
+    // Tiles go first, then resources.
+    auto more = db.mergeNextChunk();
+    ASSERT_TRUE(more);
+    EXPECT_TRUE(*more);
+    EXPECT_EQ(std::make_pair(uint64_t(3), uint64_t(3 + 1)), db.getMergeProgress());
+
+    more = db.mergeNextChunk();
+    ASSERT_TRUE(more);
+    EXPECT_FALSE(*more);
+    EXPECT_EQ(std::make_pair(uint64_t(3 + 1), uint64_t(3 + 1)), db.getMergeProgress());
+
+    auto result = db.finishMerge();
+    ASSERT_TRUE(result);
+    EXPECT_EQ(2u, result->size());
+    EXPECT_EQ(std::make_pair(uint64_t(0), uint64_t(0)), db.getMergeProgress());
+
+    auto status = db.getRegionCompletedStatus(result->front().getID());
+    EXPECT_EQ(4u, status->completedResourceCount);
+    EXPECT_EQ(3u, status->completedTileCount);
+
+    EXPECT_FALSE(db.mergeNextChunk());
+    EXPECT_EQ(1u, log.count({ EventSeverity::Error, Event::Database, -1, "Can't merge database: the merge was interrupted" }));
+    EXPECT_EQ(0u, log.uncheckedCount());
+}
+
 TEST(OfflineDatabase, MergeDatabaseWithSingleRegionTooManyNewTiles) {
     FixtureLog log;
     util::deleteFile(filename_sideload);
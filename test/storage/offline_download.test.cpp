@@ -1027,6 +1027,54 @@ TEST(OfflineDownload, InterruptAndResume) {
     test.loop.run();
 }
 
+TEST(OfflineDownload, ResumeFromCheckpoint) {
+    OfflineTest test;
+    auto region = test.createRegion();
+    ASSERT_TRUE(region);
+    OfflineDownload download(region->getID(),
+                             OfflineTilePyramidRegionDefinition(
+                                 "http://127.0.0.1:3000/style.json", LatLngBounds::world(), 0.0, 0.0, 1.0, true),
+                             test.db,
+                             test.fileSource);
+
+    // An earlier download already stored the only tile of the tileset.
+    OfflineRegionCheckpoint checkpoint;
+    checkpoint.urlTemplate = "http://127.0.0.1:3000/{z}-{x}-{y}.vector.pbf";
+    checkpoint.tileCount = 1;
+    checkpoint.tiles = 1;
+    checkpoint.completedTiles = 1;
+    checkpoint.completedSize = 100;
+    test.db.putRegionCheckpoint(region->getID(), checkpoint);
+
+    test.fileSource.styleResponse = [&](const Resource&) { return test.response("style.json"); };
+    test.fileSource.spriteImageResponse = [&](const Resource&) { return test.response("sprite.png"); };
+    test.fileSource.imageResponse = [&](const Resource&) { return test.response("radar.gif"); };
+    test.fileSource.spriteJSONResponse = [&](const Resource&) { return test.response("sprite.json"); };
+    test.fileSource.glyphsResponse = [&](const Resource&) { return test.response("glyph.pbf"); };
+    test.fileSource.sourceResponse = [&](const Resource&) { return test.response("streets.json"); };
+    test.fileSource.tileResponse = [&](const Resource&) {
+        ADD_FAILURE() << "Tile requested that the checkpoint covers";
+        return test.response("0-0-0.vector.pbf");
+    };
+
+    auto observer = std::make_unique<MockObserver>();
+    observer->statusChangedFn = [&](OfflineRegionStatus status) {
+        if (status.complete()) {
+            EXPECT_EQ(1u, status.requiredTileCount);
+            EXPECT_EQ(1u, status.completedTileCount);
+            EXPECT_EQ(100u, status.completedTileSize);
+            test.loop.stop();
+        }
+    };
+
+    download.setObserver(std::move(observer));
+    download.setState(OfflineRegionDownloadState::Active);
+    test.loop.run();
+
+    // Completed downloads walk through all tiles again the next time.
+    EXPECT_FALSE(test.db.getRegionCheckpoint(region->getID(), checkpoint.urlTemplate));
+}
+
 TEST(OfflineDownload, NoFreezingOnCachedTilesAndNewStyle) {
     OfflineTest test;
     auto region = test.createRegion();
@@ -10,6 +10,8 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+
 using namespace mbgl;
 
 TEST(OnlineFileSource, Cancel) {
@@ -557,3 +559,126 @@ TEST(OnlineFileSource, TEST_REQUIRES_SERVER(RequestSameUrlMultipleTimes)) {
 
     loop.run();
 }
+
+TEST(OnlineFileSource, TEST_REQUIRES_SERVER(CoalesceIdenticalRequests)) {
+    util::RunLoop loop;
+    std::unique_ptr<FileSource> fs = std::make_unique<OnlineFileSource>();
+    fs->setProperty(MAX_CONCURRENT_REQUESTS_KEY, 1u);
+    fs->pause();
+
+    // Every response of /cache has a new number, so a shared one shows in the data.
+    std::vector<std::string> data;
+    std::vector<std::unique_ptr<AsyncRequest>> requests;
+    for (int i = 0; i < 3; ++i) {
+        requests.emplace_back(fs->request({Resource::Unknown, "http://127.0.0.1:3000/cache"}, [&](Response res) {
+            EXPECT_EQ(nullptr, res.error);
+            ASSERT_TRUE(res.data.get());
+            data.push_back(*res.data);
+            if (data.size() == 3) {
+                loop.stop();
+            }
+        }));
+    }
+
+    fs->resume();
+    loop.run();
+
+    ASSERT_EQ(3u, data.size());
+    EXPECT_EQ(data[0], data[1]);
+    EXPECT_EQ(data[0], data[2]);
+}
+
+TEST(OnlineFileSource, TEST_REQUIRES_SERVER(QueueOrder)) {
+    util::RunLoop loop;
+    std::unique_ptr<FileSource> fs = std::make_unique<OnlineFileSource>();
+    fs->setProperty(MAX_CONCURRENT_REQUESTS_KEY, 1u);
+    fs->pause();
+
+    std::vector<std::string> responses;
+    std::vector<std::unique_ptr<AsyncRequest>> requests;
+    auto request = [&](const std::string& path, std::shared_ptr<std::atomic<uint32_t>> order) {
+        Resource resource{Resource::Unknown, "http://127.0.0.1:3000/load/" + path};
+        resource.queueOrder = std::move(order);
+        requests.emplace_back(fs->request(resource, [&, path](Response) {
+            responses.push_back(path);
+            if (responses.size() == 3) {
+                loop.stop();
+            }
+        }));
+    };
+
+    // The first request takes the only slot, then the others go by their order at that time.
+    auto first = std::make_shared<std::atomic<uint32_t>>(0);
+    auto second = std::make_shared<std::atomic<uint32_t>>(1);
+    auto third = std::make_shared<std::atomic<uint32_t>>(2);
+    request("1", first);
+    request("2", second);
+    request("3", third);
+    second->store(3);
+
+    fs->resume();
+    loop.run();
+
+    EXPECT_EQ((std::vector<std::string>{"1", "3", "2"}), responses);
+}
+
+TEST(OnlineFileSource, TEST_REQUIRES_SERVER(MaximumConcurrentRequestsPerHost)) {
+    util::RunLoop loop;
+    std::unique_ptr<FileSource> fs = std::make_unique<OnlineFileSource>();
+
+    EXPECT_EQ(0u, *fs->getProperty(MAX_CONCURRENT_REQUESTS_PER_HOST_KEY).getUint());
+    fs->setProperty(MAX_CONCURRENT_REQUESTS_PER_HOST_KEY, 1u);
+    EXPECT_EQ(1u, *fs->getProperty(MAX_CONCURRENT_REQUESTS_PER_HOST_KEY).getUint());
+    fs->pause();
+
+    // With room for more requests overall, the requests to the host still go one at a time.
+    std::vector<std::string> responses;
+    std::vector<std::unique_ptr<AsyncRequest>> requests;
+    for (const std::string path : {"1", "2", "3"}) {
+        Resource resource{Resource::Unknown, "http://127.0.0.1:3000/load/" + path};
+        resource.queueOrder = std::make_shared<std::atomic<uint32_t>>(path == "1" ? 0 : path == "2" ? 2 : 1);
+        requests.emplace_back(fs->request(resource, [&, path](Response) {
+            responses.push_back(path);
+            if (responses.size() == 3) {
+                loop.stop();
+            }
+        }));
+    }
+
+    fs->resume();
+    loop.run();
+
+    EXPECT_EQ((std::vector<std::string>{"1", "3", "2"}), responses);
+}
+
+TEST(OnlineFileSource, TEST_REQUIRES_SERVER(RevalidationsLeaveRoom)) {
+    util::RunLoop loop;
+    std::unique_ptr<FileSource> fs = std::make_unique<OnlineFileSource>();
+    fs->setProperty(MAX_CONCURRENT_REQUESTS_KEY, 2u);
+    fs->pause();
+
+    // The revalidations of expired cached data take one of the two slots at a time, so the request
+    // without data goes along with the first one instead of waiting for all of them.
+    std::vector<std::string> responses;
+    std::vector<std::unique_ptr<AsyncRequest>> requests;
+    for (const std::string path : {"1", "2", "3", "4"}) {
+        Resource resource{Resource::Unknown, "http://127.0.0.1:3000/load/" + path};
+        resource.setPriority(Resource::Priority::Low);
+        if (path != "4") {
+            resource.priorEtag = std::string("snowfall");
+        }
+        requests.emplace_back(fs->request(resource, [&, path](Response) {
+            responses.push_back(path);
+            if (responses.size() == 4) {
+                loop.stop();
+            }
+        }));
+    }
+
+    fs->resume();
+    loop.run();
+
+    ASSERT_EQ(4u, responses.size());
+    EXPECT_NE(responses.begin() + 2, std::find(responses.begin(), responses.begin() + 2, "4"));
+    EXPECT_EQ((std::vector<std::string>{"2", "3"}), std::vector<std::string>(responses.begin() + 2, responses.end()));
+}
@@ -0,0 +1,178 @@
+#include <mbgl/storage/resource.hpp>
+#include <mbgl/storage/tile_archive_file_source.hpp>
+#include <mbgl/test/util.hpp>
+#include <mbgl/util/io.hpp>
+#include <mbgl/util/run_loop.hpp>
+
+#include <unistd.h>
+#include <climits>
+#include <gtest/gtest.h>
+
+using namespace mbgl;
+
+namespace {
+
+struct ArchiveEntry {
+    uint64_t tileID;
+    uint32_t runLength;
+    std::string data;
+};
+
+void writeVarint(std::string& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(char((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(char(value));
+}
+
+void writeLittleEndian(std::string& out, std::size_t position, uint64_t value, std::size_t bytes) {
+    for (std::size_t i = 0; i < bytes; ++i) {
+        out[position + i] = char((value >> (8 * i)) & 0xFF);
+    }
+}
+
+// Builds an uncompressed PMTiles archive whose entries all fit into the root directory.
+std::string makeArchive(const std::vector<ArchiveEntry>& entries, const std::string& metadata) {
+    std::string directory;
+    std::string tileData;
+    writeVarint(directory, entries.size());
+    uint64_t lastID = 0;
+    for (const auto& entry : entries) {
+        writeVarint(directory, entry.tileID - lastID);
+        lastID = entry.tileID;
+    }
+    for (const auto& entry : entries) {
+        writeVarint(directory, entry.runLength);
+    }
+    for (const auto& entry : entries) {
+        writeVarint(directory, entry.data.size());
+    }
+    for (std::size_t i = 0; i < entries.size(); ++i) {
+        // Data that follows the previous entry is stored as 0.
+        writeVarint(directory, i == 0 ? 1 : 0);
+        tileData += entries[i].data;
+    }
+
+    std::string header(127, '\0');
+    header.replace(0, 7, "PMTiles");
+    header[7] = 3;
+    const uint64_t metadataOffset = header.size() + directory.size();
+    const uint64_t tileDataOffset = metadataOffset + metadata.size();
+    writeLittleEndian(header, 8, header.size(), 8);
+    writeLittleEndian(header, 16, directory.size(), 8);
+    writeLittleEndian(header, 24, metadataOffset, 8);
+    writeLittleEndian(header, 32, metadata.size(), 8);
+    writeLittleEndian(header, 40, tileDataOffset, 8);
+    writeLittleEndian(header, 56, tileDataOffset, 8);
+    writeLittleEndian(header, 64, tileData.size(), 8);
+    header[96] = 1; // clustered
+    header[97] = 1; // no internal compression
+    header[98] = 1; // no tile compression
+    header[99] = 1; // vector tiles
+    header[100] = 0;
+    header[101] = 1;
+    writeLittleEndian(header, 102, uint32_t(int32_t(-1800000000)), 4);
+    writeLittleEndian(header, 106, uint32_t(int32_t(-850000000)), 4);
+    writeLittleEndian(header, 110, 1800000000, 4);
+    writeLittleEndian(header, 114, 850000000, 4);
+    return header + directory + metadata + tileData;
+}
+
+std::string archiveURL(const std::string& path) {
+    char buff[PATH_MAX + 1];
+    char* cwd = getcwd(buff, PATH_MAX + 1);
+    return "pmtiles://" + std::string(cwd) + "/" + path;
+}
+
+} // namespace
+
+TEST(TileArchiveFileSource, AcceptsURL) {
+    TileArchiveFileSource fs;
+    EXPECT_TRUE(fs.canRequest(Resource::source("pmtiles:///archive.pmtiles")));
+    EXPECT_FALSE(fs.canRequest(Resource::source("file:///archive.pmtiles")));
+    EXPECT_FALSE(fs.canRequest(Resource::source("archive.pmtiles")));
+}
+
+TEST(TileArchiveFileSource, TEST_REQUIRES_WRITE(Tiles)) {
+    util::RunLoop loop;
+
+    const std::string path = "test/fixtures/storage/archive.pmtiles";
+    // Hilbert tile IDs: 0 is 0/0/0, 1 to 4 are 1/0/0, 1/0/1, 1/1/1 and 1/1/0.
+    util::write_file(path, makeArchive({{0, 1, "zero"}, {1, 1, "one"}, {3, 2, "shared"}},
+                                       R"JSON({"attribution":"Test","vector_layers":[]})JSON"));
+    const std::string url = archiveURL(path);
+
+    TileArchiveFileSource fs;
+    std::vector<std::unique_ptr<AsyncRequest>> requests;
+    auto requestTile = [&](int32_t x, int32_t y, int8_t z, std::function<void(const Response&)> check) {
+        requests.push_back(
+            fs.request(Resource::tile(url + "/{z}/{x}/{y}", 1.0, x, y, z, Tileset::Scheme::XYZ), std::move(check)));
+    };
+
+    int pending = 6;
+    auto done = [&] {
+        if (--pending == 0) {
+            loop.stop();
+        }
+    };
+    auto expectData = [&](const std::string& data) {
+        return [&done, data](const Response& res) {
+            EXPECT_EQ(nullptr, res.error);
+            ASSERT_TRUE(res.data.get());
+            EXPECT_EQ(data, *res.data);
+            done();
+        };
+    };
+    auto expectNoContent = [&](const Response& res) {
+        EXPECT_EQ(nullptr, res.error);
+        EXPECT_TRUE(res.noContent);
+        done();
+    };
+
+    requestTile(0, 0, 0, expectData("zero"));
+    requestTile(0, 0, 1, expectData("one"));
+    requestTile(1, 1, 1, expectData("shared"));
+    requestTile(1, 0, 1, expectData("shared"));
+    requestTile(0, 1, 1, expectNoContent);
+    requestTile(0, 0, 2, expectNoContent);
+
+    loop.run();
+}
+
+TEST(TileArchiveFileSource, TEST_REQUIRES_WRITE(TileJSON)) {
+    util::RunLoop loop;
+
+    const std::string path = "test/fixtures/storage/archive.pmtiles";
+    util::write_file(path, makeArchive({{0, 1, "zero"}}, R"JSON({"attribution":"Test","minzoom":5})JSON"));
+    const std::string url = archiveURL(path);
+
+    TileArchiveFileSource fs;
+    std::unique_ptr<AsyncRequest> req = fs.request(Resource::source(url), [&](const Response& res) {
+        req.reset();
+        EXPECT_EQ(nullptr, res.error);
+        ASSERT_TRUE(res.data.get());
+        EXPECT_NE(std::string::npos, res.data->find(R"JSON("tiles":[")JSON" + url + R"JSON(/{z}/{x}/{y}"])JSON"));
+        // The header takes precedence over the metadata.
+        EXPECT_NE(std::string::npos, res.data->find(R"JSON("minzoom":0,"maxzoom":1)JSON"));
+        EXPECT_NE(std::string::npos, res.data->find(R"JSON("attribution":"Test")JSON"));
+        loop.stop();
+    });
+
+    loop.run();
+}
+
+TEST(TileArchiveFileSource, NotFound) {
+    util::RunLoop loop;
+
+    TileArchiveFileSource fs;
+    std::unique_ptr<AsyncRequest> req =
+        fs.request(Resource::source(archiveURL("test/fixtures/storage/missing.pmtiles")), [&](const Response& res) {
+            req.reset();
+            ASSERT_NE(nullptr, res.error);
+            EXPECT_EQ(Response::Error::Reason::NotFound, res.error->reason);
+            loop.stop();
+        });
+
+    loop.run();
+}
@@ -0,0 +1,83 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/style/conversion/geojson.hpp>
+#include <mbgl/style/conversion/json.hpp>
+
+using namespace mbgl;
+using namespace mbgl::style::conversion;
+
+namespace {
+
+// parseGeoJSON() streams the document, it must match the conversion of the rapidjson DOM.
+void expectSameAsDOM(const std::string& json) {
+    Error streamError;
+    optional<GeoJSON> streamed = parseGeoJSON(json, streamError);
+    ASSERT_TRUE(streamed) << streamError.message;
+
+    Error domError;
+    optional<GeoJSON> converted = convertJSON<GeoJSON>(json, domError);
+    ASSERT_TRUE(converted) << domError.message;
+    EXPECT_EQ(*converted, *streamed) << json;
+}
+
+std::string parseError(const std::string& json) {
+    Error error;
+    EXPECT_FALSE(parseGeoJSON(json, error)) << json;
+    return error.message;
+}
+
+} // namespace
+
+TEST(GeoJSON, Geometries) {
+    expectSameAsDOM(R"JSON({"type": "Point", "coordinates": [1.5, -2, 3]})JSON");
+    expectSameAsDOM(R"JSON({"type": "MultiPoint", "coordinates": [[1, 2], [3, 4]]})JSON");
+    expectSameAsDOM(R"JSON({"type": "LineString", "coordinates": [[1, 2], [3, 4]]})JSON");
+    expectSameAsDOM(R"JSON({"type": "MultiLineString", "coordinates": [[[1, 2], [3, 4]], [], [[5, 6]]]})JSON");
+    expectSameAsDOM(R"JSON({"type": "Polygon", "coordinates": [[[0, 0], [1, 0], [1, 1], [0, 0]]]})JSON");
+    expectSameAsDOM(R"JSON({"type": "MultiPolygon", "coordinates": [[[[0, 0], [1, 0], [1, 1], [0, 0]]], [[]]]})JSON");
+    expectSameAsDOM(R"JSON({"type": "GeometryCollection", "geometries": [
+        {"type": "Point", "coordinates": [1, 2]},
+        {"type": "GeometryCollection", "geometries": []}
+    ]})JSON");
+    // Members in any order.
+    expectSameAsDOM(R"JSON({"coordinates": [[1, 2], [3, 4]], "bbox": [1, 2, 3, 4], "type": "LineString"})JSON");
+}
+
+TEST(GeoJSON, Features) {
+    expectSameAsDOM(R"JSON({
+        "type": "FeatureCollection",
+        "crs": {"type": "name", "properties": {"name": "EPSG:4326"}},
+        "features": [{
+            "type": "Feature",
+            "id": 1,
+            "geometry": {"type": "Point", "coordinates": [1, 2]},
+            "properties": {"name": "one", "rank": -2, "size": 1.5, "open": true, "none": null,
+                           "tags": ["a", 1, [2]], "nested": {"key": {"value": 3}}}
+        }, {
+            "properties": null,
+            "geometry": null,
+            "id": "two",
+            "type": "Feature"
+        }, {
+            "type": "Feature",
+            "id": 18446744073709551615,
+            "geometry": {"coordinates": [[1, 2], [3, 4]], "type": "LineString"}
+        }]
+    })JSON");
+    expectSameAsDOM(R"JSON({"type": "Feature", "geometry": {"type": "Point", "coordinates": [1, 2]}})JSON");
+}
+
+TEST(GeoJSON, Errors) {
+    EXPECT_EQ("GeoJSON must be an object", parseError("[1, 2]"));
+    EXPECT_EQ("GeoJSON must have a type property", parseError(R"JSON({"coordinates": [1, 2]})JSON"));
+    EXPECT_EQ("Point geometry must have a coordinates property", parseError(R"JSON({"type": "Point"})JSON"));
+    EXPECT_EQ("coordinates array must have at least 2 numbers",
+              parseError(R"JSON({"type": "Point", "coordinates": [1]})JSON"));
+    EXPECT_EQ("LineString coordinates must be nested 2 arrays deep",
+              parseError(R"JSON({"type": "LineString", "coordinates": [1, 2]})JSON"));
+    EXPECT_EQ("Feature must have a geometry property",
+              parseError(R"JSON({"type": "FeatureCollection", "features": [{"type": "Feature"}]})JSON"));
+    EXPECT_EQ("Feature id must be a string or number",
+              parseError(R"JSON({"type": "Feature", "geometry": null, "id": true})JSON"));
+    EXPECT_FALSE(parseError(R"JSON({"type": "Point", "coordinates": [1, 2])JSON").empty());
+}
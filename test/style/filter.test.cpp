@@ -8,6 +8,7 @@
 #include <rapidjson/stringbuffer.h>
 #include <mbgl/style/conversion/stringify.hpp>
 
+#include <mbgl/style/compiled_filter.hpp>
 #include <mbgl/style/filter.hpp>
 #include <mbgl/style/conversion/json.hpp>
 #include <mbgl/style/conversion/filter.hpp>
@@ -262,3 +263,102 @@ TEST(Filter, LegacyExpressionInvalidType) {
     optional<Filter> result = conversion::convert<Filter>(conversion::Convertible(&value), error);
     EXPECT_FALSE(result);
 }
+
+TEST(Filter, CompiledMatchesInterpreter) {
+    const char* filters[] = {
+        R"(["==", "$type", "Polygon"])",
+        R"(["in", "$type", "Point", "LineString"])",
+        R"(["==", "class", "snow"])",
+        R"(["!=", "class", "snow"])",
+        R"(["in", "class", "snow", "ice", 1])",
+        R"(["!in", "class", "snow"])",
+        R"(["has", "class"])",
+        R"(["!has", "class"])",
+        R"(["==", "$id", 1])",
+        R"(["in", "$id", 1, 2])",
+        R"(["has", "$id"])",
+        R"(["all", ["==", "class", "snow"], ["==", "$type", "Point"]])",
+        R"(["any", ["==", "class", "ice"], ["in", "$type", "Polygon"]])",
+        R"(["none", ["==", "class", "snow"], ["<", "rank", 3]])",
+        R"(["==", ["get", "class"], "snow"])",
+        R"(["!=", ["get", "class"], "snow"])",
+        R"(["==", ["get", "missing"], null])",
+        R"(["==", ["get", "rank"], 2])",
+        R"(["==", ["geometry-type"], "Point"])",
+        R"(["!=", ["geometry-type"], "Polygon"])",
+        R"(["has", "rank"])",
+        R"(["match", ["get", "class"], ["snow", "ice"], true, false])",
+        R"(["match", ["get", "class"], "snow", false, true])",
+        R"(["match", ["geometry-type"], ["Point", "LineString"], true, false])",
+        R"(["match", ["get", "rank"], [1, 2], true, false])",
+        R"(["all", ["==", ["get", "class"], "snow"], [">", ["get", "rank"], 1]])",
+        R"(["any", ["<", ["get", "rank"], "a"], ["==", ["get", "class"], "snow"]])",
+        R"(["!", ["<", ["get", "rank"], "a"]])",
+    };
+
+    const PropertyMap properties[] = {
+        {},
+        {{"class", std::string("snow")}, {"rank", int64_t(2)}},
+        {{"class", std::string("ice")}, {"rank", uint64_t(1)}},
+        {{"class", int64_t(1)}, {"rank", 2.5}},
+    };
+    const FeatureIdentifier ids[] = {NullValue(), uint64_t(1), std::string("1")};
+    const FeatureType types[] = {FeatureType::Point, FeatureType::LineString, FeatureType::Polygon};
+
+    for (const char* json : filters) {
+        conversion::Error error;
+        optional<Filter> parsed = conversion::convertJSON<Filter>(json, error);
+        ASSERT_TRUE(bool(parsed)) << json;
+        ASSERT_TRUE(parsed->expression);
+
+        auto compiled = CompiledFilter::compile(*parsed->expression);
+        for (const auto& featureProperties : properties) {
+            for (const auto& id : ids) {
+                for (FeatureType type : types) {
+                    StubGeometryTileFeature feature{id, type, {}, featureProperties};
+                    expression::EvaluationContext context = {0.0f, &feature};
+
+                    const expression::EvaluationResult result = (*parsed->expression)->evaluate(context);
+                    const bool expected = result && expression::fromExpressionValue<bool>(*result).value_or(false);
+                    EXPECT_EQ(expected, (*parsed)(context)) << json;
+                    if (compiled) EXPECT_EQ(expected, (*compiled)(context)) << json;
+                }
+            }
+        }
+    }
+}
+
+TEST(Filter, CompiledFallback) {
+    conversion::Error error;
+    optional<Filter> parsed = conversion::convertJSON<Filter>(R"(["<", ["get", "rank"], 3])", error);
+    ASSERT_TRUE(bool(parsed));
+    EXPECT_FALSE(CompiledFilter::compile(*parsed->expression));
+
+    parsed = conversion::convertJSON<Filter>(R"(["all", ["==", "$type", "Point"], ["<", ["get", "rank"], 3]])", error);
+    ASSERT_TRUE(bool(parsed));
+    EXPECT_TRUE(CompiledFilter::compile(*parsed->expression));
+}
+
+TEST(Filter, Deferred) {
+    conversion::Error error;
+    optional<Filter> deferred = conversion::convertJSON<Filter>(R"(["==", ["get", "class"], "snow"])", error, true);
+    ASSERT_TRUE(bool(deferred));
+    EXPECT_TRUE(deferred->isDeferred());
+    EXPECT_FALSE(deferred->expression);
+
+    StubGeometryTileFeature snow{{}, FeatureType::Point, {}, {{"class", std::string("snow")}}};
+    StubGeometryTileFeature ice{{}, FeatureType::Point, {}, {{"class", std::string("ice")}}};
+    EXPECT_TRUE((*deferred)(expression::EvaluationContext{0.0f, &snow}));
+    EXPECT_FALSE((*deferred)(expression::EvaluationContext{0.0f, &ice}));
+
+    // The JSON is kept as is, so layers serialize the filter they were given.
+    optional<Filter> legacy = conversion::convertJSON<Filter>(R"(["==", "class", "snow"])", error, true);
+    ASSERT_TRUE(bool(legacy));
+    EXPECT_EQ(*conversion::convertJSON<Filter>(R"(["==", "class", "snow"])", error), *legacy);
+    EXPECT_TRUE((*legacy)(expression::EvaluationContext{0.0f, &snow}));
+
+    // Errors only show up once the filter is used.
+    optional<Filter> invalid = conversion::convertJSON<Filter>(R"(["==", ["get", "class"]])", error, true);
+    ASSERT_TRUE(bool(invalid));
+    EXPECT_FALSE((*invalid)(expression::EvaluationContext{0.0f, &snow}));
+}
@@ -1,6 +1,7 @@
 #include <mbgl/test/util.hpp>
 
 #include <mbgl/style/properties.hpp>
+#include <mbgl/style/layers/fill_layer_properties.hpp>
 #include <mbgl/style/expression/dsl.hpp>
 #include <mbgl/renderer/property_evaluator.hpp>
 #include <mbgl/renderer/data_driven_property_evaluator.hpp>
@@ -136,3 +137,22 @@ TEST(TransitioningDataDrivenPropertyValue, Evaluate) {
     ASSERT_FALSE(evaluateDataExpression(t1, 0ms).isConstant()) <<
         "A paint property transition to a data-driven evaluates immediately to the final value (see https://github.com/mapbox/mapbox-gl-native/issues/8237).";
 }
+
+TEST(UnevaluatedProperties, IsZoomConstant) {
+    using namespace mbgl::style::expression::dsl;
+
+    FillPaintProperties::Transitionable paint;
+    EXPECT_TRUE(paint.untransitioned().isZoomConstant());
+
+    paint.get<FillOpacity>().value = PropertyValue<float>(0.5f);
+    paint.get<FillColor>().value = PropertyExpression<Color>(toColor(get("color")));
+    EXPECT_TRUE(paint.untransitioned().isZoomConstant());
+
+    paint.get<FillOpacity>().value = PropertyExpression<float>(interpolate(linear(), zoom(), 0.0, literal(0.0), 1.0, literal(1.0)));
+    EXPECT_FALSE(paint.untransitioned().isZoomConstant());
+
+    // Patterns crossfade between zoom levels, even when they are constant.
+    paint.get<FillOpacity>().value = PropertyValue<float>(0.5f);
+    paint.get<FillPattern>().value = PropertyValue<expression::Image>(expression::Image("pattern"));
+    EXPECT_FALSE(paint.untransitioned().isZoomConstant());
+}
@@ -1,12 +1,17 @@
 #include <mbgl/test/util.hpp>
 #include <mbgl/test/stub_geometry_tile_feature.hpp>
 
+#include <mbgl/style/conversion/json.hpp>
+#include <mbgl/style/conversion/property_value.hpp>
+#include <mbgl/style/conversion_impl.hpp>
+#include <mbgl/style/expression/compiled_expression.hpp>
 #include <mbgl/style/property_expression.hpp>
 #include <mbgl/renderer/property_evaluator.hpp>
 #include <mbgl/renderer/property_evaluation_parameters.hpp>
 #include <mbgl/style/expression/dsl.hpp>
 #include <mbgl/style/expression/format_section_override.hpp>
 
+#include <cmath>
 #include <sstream>
 
 using namespace mbgl;
@@ -461,3 +466,230 @@ TEST(PropertyExpression, WithinExpressionAntiMeridian) {
         EXPECT_FALSE(evaluatedResult);
     }
 }
+
+TEST(PropertyExpression, CompiledMatchesInterpreter) {
+    const std::vector<StubGeometryTileFeature> features{
+        StubGeometryTileFeature{PropertyMap{}},
+        StubGeometryTileFeature{PropertyMap{{"x", uint64_t(3)}, {"c", "a"s}}},
+        StubGeometryTileFeature{PropertyMap{{"x", int64_t(-7)}, {"c", "b"s}}},
+        StubGeometryTileFeature{PropertyMap{{"x", 42.5}, {"c", "z"s}}},
+        StubGeometryTileFeature{PropertyMap{{"x", 0.0}, {"c", 1.0}}},
+        StubGeometryTileFeature{PropertyMap{{"x", "3"s}}},
+    };
+    const float zooms[] = {0.0f, 7.5f, 14.0f};
+
+    const char* numbers[] = {
+        R"(["get", "x"])",
+        R"(["*", 2, ["get", "x"]])",
+        R"(["+", ["get", "x"], 0.5, -1])",
+        R"(["-", ["get", "x"]])",
+        R"(["/", ["get", "x"], ["-", ["get", "x"], ["get", "x"]]])",
+        R"(["interpolate", ["linear"], ["get", "x"], 0, 0, 10, 100, 50, 1000])",
+        R"(["interpolate", ["exponential", 2], ["*", ["get", "x"], 3], 0, 1, 100, 5])",
+        R"(["interpolate", ["cubic-bezier", 0.4, 0, 0.6, 1], ["get", "x"], 1, 1, 40, 5])",
+        R"(["step", ["get", "x"], 1, 0, 2, 10, 3])",
+        R"(["match", ["get", "c"], "a", 1, ["b", "c"], 2, 3])",
+        R"({"type": "exponential", "base": 2, "stops": [[0, 0], [100, 10]], "property": "x"})",
+    };
+    for (const char* json : numbers) {
+        conversion::Error error;
+        auto value = conversion::convertJSON<PropertyValue<float>>(json, error, true, false);
+        ASSERT_TRUE(value) << json << ": " << error.message;
+        const auto& expression = value->asExpression();
+        EXPECT_TRUE(CompiledExpression::compileNumber(expression.getExpression())) << json;
+        for (const auto& feature : features) {
+            for (float zoom : zooms) {
+                const EvaluationContext context(zoom, &feature);
+                const EvaluationResult result = expression.getExpression().evaluate(context);
+                const optional<float> expected = result ? fromExpressionValue<float>(*result) : nullopt;
+                const float expectedValue = expected ? *expected : -1.0f;
+                const float actual = expression.evaluate(context, -1.0f);
+                EXPECT_TRUE(expectedValue == actual || (std::isnan(expectedValue) && std::isnan(actual))) << json;
+            }
+        }
+    }
+
+    const char* colors[] = {
+        R"(["interpolate", ["linear"], ["get", "x"], 0, "red", 10, "blue", 50, "white"])",
+        R"(["step", ["-", ["get", "x"], 10], "black", 0, "red"])",
+        R"(["match", ["get", "c"], ["a", "b"], "green", "yellow"])",
+    };
+    for (const char* json : colors) {
+        conversion::Error error;
+        auto value = conversion::convertJSON<PropertyValue<Color>>(json, error, true, false);
+        ASSERT_TRUE(value) << json << ": " << error.message;
+        const auto& expression = value->asExpression();
+        EXPECT_TRUE(CompiledExpression::compileColor(expression.getExpression())) << json;
+        for (const auto& feature : features) {
+            for (float zoom : zooms) {
+                const EvaluationContext context(zoom, &feature);
+                const EvaluationResult result = expression.getExpression().evaluate(context);
+                const optional<Color> expected = result ? fromExpressionValue<Color>(*result) : nullopt;
+                EXPECT_EQ(expected ? *expected : Color::black(), expression.evaluate(context, Color::black())) << json;
+            }
+        }
+    }
+}
+
+TEST(PropertyExpression, CompiledOutputsMatchInterpreter) {
+    const std::vector<StubGeometryTileFeature> features{
+        StubGeometryTileFeature{PropertyMap{}},
+        StubGeometryTileFeature{PropertyMap{{"x", uint64_t(3)}}},
+        StubGeometryTileFeature{PropertyMap{{"x", int64_t(-7)}}},
+        StubGeometryTileFeature{PropertyMap{{"x", "3"s}}},
+    };
+    const float zooms[] = {0.0f, 4.0f, 7.5f, 14.0f};
+
+    // Composite expressions, where the outputs of the zoom curve are compiled expressions themselves.
+    const char* numbers[] = {
+        R"(["interpolate", ["linear"], ["zoom"], 0, ["get", "x"], 10, ["*", 2, ["get", "x"]]])",
+        R"(["step", ["zoom"], ["get", "missing"], 5, ["-", ["get", "x"], 1]])",
+        R"({"type": "exponential", "property": "x", "stops": [[{"zoom": 0, "value": 0}, 0],
+            [{"zoom": 0, "value": 10}, 10], [{"zoom": 10, "value": 0}, 5], [{"zoom": 10, "value": 10}, 50]]})",
+    };
+    for (const char* json : numbers) {
+        conversion::Error error;
+        auto value = conversion::convertJSON<PropertyValue<float>>(json, error, true, false);
+        ASSERT_TRUE(value) << json << ": " << error.message;
+        const auto& expression = value->asExpression();
+        EXPECT_TRUE(CompiledExpression::compileNumber(expression.getExpression())) << json;
+        for (const auto& feature : features) {
+            for (float zoom : zooms) {
+                const EvaluationContext context(zoom, &feature);
+                const EvaluationResult result = expression.getExpression().evaluate(context);
+                const optional<float> expected = result ? fromExpressionValue<float>(*result) : nullopt;
+                EXPECT_EQ(expected ? *expected : -1.0f, expression.evaluate(context, -1.0f)) << json;
+            }
+        }
+    }
+
+    // Color outputs are always literals.
+    conversion::Error error;
+    auto color = conversion::convertJSON<PropertyValue<Color>>(
+        R"(["step", ["zoom"], "black", 10, "red"])", error, true, false);
+    ASSERT_TRUE(color) << error.message;
+    EXPECT_TRUE(CompiledExpression::compileColor(color->asExpression().getExpression()));
+    for (const auto& feature : features) {
+        for (float zoom : zooms) {
+            const EvaluationContext context(zoom, &feature);
+            const EvaluationResult result = color->asExpression().getExpression().evaluate(context);
+            const optional<Color> expected = result ? fromExpressionValue<Color>(*result) : nullopt;
+            EXPECT_EQ(expected ? *expected : Color::black(), color->asExpression().evaluate(context, Color::black()));
+        }
+    }
+}
+
+TEST(PropertyExpression, CompiledSharedSubexpressions) {
+    // Every stop reads the same property, which takes a single register.
+    std::ostringstream json;
+    json << R"(["interpolate", ["linear"], ["zoom"])";
+    for (int stop = 1; stop <= 12; ++stop) {
+        json << ", " << stop << R"(, ["*", ["get", "x"], )" << stop << "]";
+    }
+    json << "]";
+
+    conversion::Error error;
+    auto value = conversion::convertJSON<PropertyValue<float>>(json.str(), error, true, false);
+    ASSERT_TRUE(value) << error.message;
+    const auto& expression = value->asExpression();
+    EXPECT_TRUE(CompiledExpression::compileNumber(expression.getExpression()));
+
+    const StubGeometryTileFeature feature{PropertyMap{{"x", 2.0}}};
+    for (float zoom : {0.0f, 3.5f, 12.0f}) {
+        const EvaluationContext context(zoom, &feature);
+        const EvaluationResult result = expression.getExpression().evaluate(context);
+        ASSERT_TRUE(result);
+        EXPECT_EQ(*fromExpressionValue<float>(*result), expression.evaluate(context, -1.0f));
+    }
+}
+
+TEST(PropertyExpression, CompiledFallback) {
+    conversion::Error error;
+    auto value = conversion::convertJSON<PropertyValue<float>>(
+        R"(["coalesce", ["get", "x"], ["length", ["get", "s"]]])", error, true, false);
+    ASSERT_TRUE(value) << error.message;
+    EXPECT_FALSE(CompiledExpression::compileNumber(value->asExpression().getExpression()));
+    EXPECT_EQ(3.0f, value->asExpression().evaluate(StubGeometryTileFeature(PropertyMap{{"s", "abc"s}}), -1.0f));
+}
+
+TEST(PropertyExpression, EvaluateBatch) {
+    const std::vector<StubGeometryTileFeature> stubs{
+        StubGeometryTileFeature{PropertyMap{}},
+        StubGeometryTileFeature{PropertyMap{{"x", uint64_t(3)}, {"c", "a"s}}},
+        StubGeometryTileFeature{PropertyMap{{"x", 42.5}, {"c", "b"s}}},
+        StubGeometryTileFeature{PropertyMap{{"x", "3"s}, {"s", "abc"s}}},
+    };
+    std::vector<const GeometryTileFeature*> features;
+    for (const auto& stub : stubs) features.push_back(&stub);
+
+    const char* numbers[] = {
+        R"(["interpolate", ["linear"], ["zoom"], 0, 0, 10, ["*", ["get", "x"], 2]])",
+        R"(["step", ["zoom"], 1, 3, ["get", "x"], 8, ["/", ["get", "x"], 2]])",
+        R"(["coalesce", ["get", "x"], ["length", ["get", "s"]]])",
+    };
+    for (const char* json : numbers) {
+        conversion::Error error;
+        auto value = conversion::convertJSON<PropertyValue<float>>(json, error, true, false);
+        ASSERT_TRUE(value) << json << ": " << error.message;
+        const auto& expression = value->asExpression();
+        std::vector<float> results;
+        expression.evaluate(EvaluationContext(5.0f), features, results, -1.0f);
+        ASSERT_EQ(features.size(), results.size()) << json;
+        for (std::size_t i = 0; i < features.size(); ++i) {
+            EXPECT_EQ(expression.evaluate(EvaluationContext(5.0f, features[i]), -1.0f), results[i]) << json;
+        }
+    }
+
+    conversion::Error error;
+    auto color = conversion::convertJSON<PropertyValue<Color>>(
+        R"(["match", ["get", "c"], "a", "red", "blue"])", error, true, false);
+    ASSERT_TRUE(color) << error.message;
+    std::vector<Color> colors;
+    color->asExpression().evaluate(EvaluationContext(), features, colors, Color::black());
+    EXPECT_EQ((std::vector<Color>{Color::blue(), Color::red(), Color::blue(), Color::blue()}), colors);
+
+    // Without a zoom level, expressions depending on it fail for every feature.
+    std::vector<float> results;
+    auto zoomDependent = conversion::convertJSON<PropertyValue<float>>(
+        R"(["interpolate", ["linear"], ["zoom"], 0, ["get", "x"], 10, 0])", error, true, false);
+    ASSERT_TRUE(zoomDependent) << error.message;
+    zoomDependent->asExpression().evaluate(EvaluationContext(), features, results, -1.0f);
+    EXPECT_EQ(std::vector<float>(features.size(), -1.0f), results);
+}
+
+TEST(PropertyExpression, LiteralZoomCurveMatchesInterpreter) {
+    std::vector<float> zooms;
+    for (float zoom = -1.0f; zoom <= 25.0f; zoom += 0.37f) zooms.push_back(zoom);
+    // Jumping around exercises the lookup of the stops, not only the ones that were found last.
+    zooms.insert(zooms.end(), {14.0f, 2.0f, 20.0f, 5.0f, 5.0f, 0.0f});
+
+    const char* numbers[] = {
+        R"(["interpolate", ["linear"], ["zoom"], 5, 1, 10, 3, 15, 8])",
+        R"(["interpolate", ["exponential", 1.5], ["zoom"], 0, 0.5, 14, 4, 22, 100])",
+        R"(["interpolate", ["cubic-bezier", 0.4, 0, 0.6, 1], ["zoom"], 1, 1, 20, 5])",
+        R"(["step", ["zoom"], 1, 5, 2, 10, 3])",
+        R"({"type": "exponential", "base": 2, "stops": [[0, 0], [4, 1], [12, 10], [24, 24]]})",
+    };
+    for (const char* json : numbers) {
+        conversion::Error error;
+        auto value = conversion::convertJSON<PropertyValue<float>>(json, error, false, false);
+        ASSERT_TRUE(value) << json << ": " << error.message;
+        ASSERT_TRUE(value->isExpression()) << json;
+        const PropertyExpression<float>& expression = value->asExpression();
+        for (float zoom : zooms) {
+            EXPECT_EQ(expression.evaluate(EvaluationContext(zoom)), expression.evaluate(zoom)) << json << " @ " << zoom;
+        }
+    }
+
+    conversion::Error error;
+    auto color = conversion::convertJSON<PropertyValue<Color>>(
+        R"(["interpolate", ["linear"], ["zoom"], 5, "red", 10, "rgba(0, 0, 255, 0.5)"])", error, false, false);
+    ASSERT_TRUE(color) << error.message;
+    auto text = conversion::convertJSON<PropertyValue<std::string>>(
+        R"(["step", ["zoom"], "a", 5, "b", 10, "c"])", error, false, false);
+    ASSERT_TRUE(text) << error.message;
+    for (float zoom : zooms) {
+        EXPECT_EQ(color->asExpression().evaluate(EvaluationContext(zoom)), color->asExpression().evaluate(zoom));
+        EXPECT_EQ(text->asExpression().evaluate(EvaluationContext(zoom)), text->asExpression().evaluate(zoom));
+    }
+}
@@ -15,6 +15,7 @@
 #include <mbgl/style/source_impl.hpp>
 #include <mbgl/style/sources/custom_geometry_source.hpp>
 #include <mbgl/style/sources/geojson_source.hpp>
+#include <mbgl/style/sources/geojson_source_impl.hpp>
 #include <mbgl/style/sources/image_source.hpp>
 #include <mbgl/style/sources/raster_dem_source.hpp>
 #include <mbgl/style/sources/raster_source.hpp>
@@ -46,7 +47,10 @@
 #include <mbgl/renderer/tile_render_data.hpp>
 #include <mbgl/text/glyph_manager.hpp>
 
+#include <algorithm>
+#include <atomic>
 #include <cstdint>
+#include <mutex>
 #include <gmock/gmock.h>
 
 using namespace mbgl;
@@ -74,7 +78,9 @@ public:
                 annotationManager.makeWeakPtr(),
                 imageManager,
                 glyphManager,
-                0};
+                0,
+                nullptr,
+                nullptr};
     };
 
     SourceTest() {
@@ -214,6 +220,46 @@ TEST(Source, RasterDEMTileEmpty) {
     test.run();
 }
 
+TEST(Source, RasterDEMTileOverzoomed) {
+    SourceTest test;
+    test.transform.jumpTo(CameraOptions().withCenter(LatLng()).withZoom(5.0));
+    test.transformState = test.transform.getState();
+
+    test.fileSource->tileResponse = [&] (const Resource& resource) {
+        EXPECT_EQ(2, int(resource.tileData->z));
+        Response response;
+        response.noContent = true;
+        return response;
+    };
+
+    HillshadeLayer layer("id", "source");
+    Immutable<LayerProperties> layerProperties = makeMutable<HillshadeLayerProperties>(staticImmutableCast<HillshadeLayer::Impl>(layer.baseImpl));
+    std::vector<Immutable<LayerProperties>> layers { layerProperties };
+
+    Tileset tileset;
+    tileset.tiles = { "tiles" };
+    tileset.zoomRange = { 0, 2 };
+
+    RasterDEMSource source("source", tileset, 512);
+    source.loadDescription(*test.fileSource);
+
+    // Beyond the maximum zoom level, the tiles of that level are rendered instead of overzoomed copies.
+    test.renderSourceObserver.tileChanged = [&] (RenderSource&, const OverscaledTileID& tileID) {
+        EXPECT_EQ(tileID.canonical.z, tileID.overscaledZ);
+        test.end();
+    };
+
+    test.renderSourceObserver.tileError = [&] (RenderSource&, const OverscaledTileID&, std::exception_ptr) {
+        FAIL() << "Should never be called";
+    };
+
+    auto renderSource = RenderSource::create(source.baseImpl);
+    renderSource->setObserver(&test.renderSourceObserver);
+    renderSource->update(source.baseImpl, layers, true, true, test.tileParameters());
+
+    test.run();
+}
+
 TEST(Source, VectorTileEmpty) {
     SourceTest test;
 
@@ -884,6 +930,202 @@ TEST(Source, GeoJSONSourceTilesAfterDataReset) {
     EXPECT_TRUE(renderSource.isLoaded()); // Tiles are reset in static mode.
 }
 
+TEST(Source, GeoJSONDataChunks) {
+    util::RunLoop loop;
+
+    // Enough features for the collection to be indexed in chunks.
+    GeoJSONData::Features features;
+    for (int i = 0; i < 20000; ++i) {
+        mapbox::feature::feature<double> feature{mapbox::geometry::point<double>{-170.0 + i * 0.017, 0.0}};
+        feature.id = uint64_t(i);
+        features.push_back(std::move(feature));
+    }
+
+    std::mutex mutex;
+    std::vector<float> progress;
+    auto data = GeoJSONData::create(GeoJSON{features}, GeoJSONOptions::defaultOptions(), nullptr, [&](float fraction) {
+        std::lock_guard<std::mutex> lock(mutex);
+        progress.push_back(fraction);
+    });
+    ASSERT_FALSE(progress.empty());
+    EXPECT_TRUE(std::is_sorted(progress.begin(), progress.end()));
+    EXPECT_FLOAT_EQ(1.0f, progress.back());
+
+    // Tiles have the features of all chunks, in order.
+    data->getTile(CanonicalTileID(0, 0, 0), [&](GeoJSONData::TileFeatures tileFeatures) {
+        ASSERT_EQ(features.size(), tileFeatures.size());
+        for (std::size_t i = 0; i < tileFeatures.size(); ++i) {
+            EXPECT_EQ(features[i].id, tileFeatures[i].id);
+        }
+        loop.stop();
+    });
+    loop.run();
+}
+
+TEST(Source, GeoJSONDataChunkError) {
+    GeoJSONData::Features features;
+    for (int i = 0; i < 20000; ++i) {
+        features.emplace_back(mapbox::geometry::point<double>{-170.0 + i * 0.017, 0.0});
+    }
+
+    // An error while one of the chunks is indexed reaches the caller, after the other chunks are done.
+    std::atomic<int> calls{0};
+    EXPECT_THROW(GeoJSONData::create(GeoJSON{features},
+                                     GeoJSONOptions::defaultOptions(),
+                                     nullptr,
+                                     [&](float) {
+                                         if (++calls == 2) throw std::runtime_error("chunk failed");
+                                     }),
+                 std::runtime_error);
+}
+
+TEST(Source, GeoJSONSourcesMalformedGeometry) {
+    SourceTest test;
+
+    test.fileSource->sourceResponse = [&](const Resource& resource) {
+        Response response;
+        if (resource.url == "malformed") {
+            response.data =
+                std::make_unique<std::string>(R"({"type": "Polygon", "coordinates": [[[0, 0], [1, 1]], 2]})");
+        } else {
+            response.data = std::make_unique<std::string>(
+                R"({"type": "Feature", "geometry": {"type": "Point", "coordinates": [1.1, 1.1]}, "properties": {}})");
+        }
+        return response;
+    };
+
+    std::vector<std::unique_ptr<GeoJSONSource>> sources;
+    for (const auto& url : {"valid-1", "malformed", "valid-2"}) {
+        sources.push_back(std::make_unique<GeoJSONSource>(url));
+        sources.back()->setURL(url);
+    }
+
+    // Every source loads, and only the malformed one is left without data.
+    std::size_t loaded = 0;
+    test.styleObserver.sourceLoaded = [&](Source& source) {
+        const auto& impl = static_cast<const GeoJSONSource::Impl&>(*source.baseImpl);
+        EXPECT_EQ(source.getID() != "malformed", bool(impl.getData().lock()));
+        if (++loaded == sources.size()) test.end();
+    };
+
+    for (auto& source : sources) {
+        source->setObserver(&test.styleObserver);
+        source->loadDescription(*test.fileSource);
+    }
+
+    test.run();
+}
+
+TEST(Source, GeoJSONDataUpdateFeatures) {
+    util::RunLoop loop;
+
+    GeoJSONData::Features features;
+    for (int i = 0; i < 3; ++i) {
+        mapbox::feature::feature<double> feature{mapbox::geometry::point<double>{i * 10.0, 0.0}};
+        feature.id = uint64_t(i);
+        features.push_back(std::move(feature));
+    }
+    auto data = GeoJSONData::create(GeoJSON{features});
+    EXPECT_FALSE(data->getFeatureUpdate());
+
+    // Move feature 1, remove feature 2 and add feature 3.
+    GeoJSONData::Features changed;
+    changed.emplace_back(mapbox::geometry::point<double>{-20.0, 10.0}, PropertyMap{}, uint64_t(1));
+    changed.emplace_back(mapbox::geometry::point<double>{30.0, 0.0}, PropertyMap{}, uint64_t(3));
+    auto updated = data->updateFeatures(changed, {uint64_t(2)});
+    ASSERT_TRUE(updated);
+    ASSERT_TRUE(updated->getFeatureUpdate());
+    EXPECT_EQ(data.get(), updated->getFeatureUpdate()->base);
+    LatLngBounds changedBounds = LatLngBounds::empty();
+    for (const auto& bounds : updated->getFeatureUpdate()->changedBounds) {
+        changedBounds.extend(bounds);
+    }
+    EXPECT_EQ(LatLngBounds::hull({0.0, -20.0}, {10.0, 30.0}), changedBounds);
+
+    updated->getTile(CanonicalTileID(0, 0, 0), [&](GeoJSONData::TileFeatures tileFeatures) {
+        ASSERT_EQ(3u, tileFeatures.size());
+        EXPECT_EQ(FeatureIdentifier(uint64_t(0)), tileFeatures[0].id);
+        EXPECT_EQ(FeatureIdentifier(uint64_t(1)), tileFeatures[1].id);
+        EXPECT_EQ(FeatureIdentifier(uint64_t(3)), tileFeatures[2].id);
+        loop.stop();
+    });
+    loop.run();
+
+    // The original data is left as it is.
+    data->getTile(CanonicalTileID(0, 0, 0), [&](GeoJSONData::TileFeatures tileFeatures) {
+        EXPECT_EQ(3u, tileFeatures.size());
+        loop.stop();
+    });
+    loop.run();
+
+    // Clustered data doesn't support updates.
+    GeoJSONOptions options;
+    options.cluster = true;
+    auto clustered = GeoJSONData::create(GeoJSON{features}, makeMutable<GeoJSONOptions>(std::move(options)));
+    EXPECT_FALSE(clustered->updateFeatures(changed, {}));
+}
+
+TEST(Source, GeoJSONDataClusterLazily) {
+    util::RunLoop loop;
+
+    GeoJSONData::Features features;
+    for (int i = 0; i < 100; ++i) {
+        features.emplace_back(mapbox::geometry::point<double>{0.001 * i, 0.001 * i});
+    }
+    GeoJSONOptions options;
+    options.cluster = true;
+    options.clusterMaxZoom = 14;
+    auto data = GeoJSONData::create(GeoJSON{features}, makeMutable<GeoJSONOptions>(std::move(options)));
+
+    // A high zoom is clustered first, and a lower zoom requested afterwards is still clustered.
+    for (const auto& tileID : {CanonicalTileID(14, 8192, 8191), CanonicalTileID(0, 0, 0)}) {
+        data->getTile(tileID, [&](GeoJSONData::TileFeatures tileFeatures) {
+            ASSERT_FALSE(tileFeatures.empty());
+            EXPECT_LT(tileFeatures.size(), features.size());
+            if (tileID.z == 0) {
+                ASSERT_EQ(1u, tileFeatures.size());
+                EXPECT_EQ(100u, tileFeatures[0].properties.at("point_count").get<uint64_t>());
+            }
+            loop.stop();
+        });
+        loop.run();
+    }
+}
+
+TEST(Source, GeoJSONDataClusterQueries) {
+    util::RunLoop loop;
+
+    GeoJSONData::Features features;
+    for (int i = 0; i < 100; ++i) {
+        features.emplace_back(mapbox::geometry::point<double>{0.001 * i, 0.001 * i});
+    }
+    GeoJSONOptions options;
+    options.cluster = true;
+    options.clusterMaxZoom = 14;
+    auto data = GeoJSONData::create(GeoJSON{features}, makeMutable<GeoJSONOptions>(std::move(options)));
+
+    // The clusters of a high zoom tile can be queried before any lower zoom is clustered.
+    uint32_t clusterID = 0;
+    uint64_t pointCount = 0;
+    data->getTile(CanonicalTileID(12, 2048, 2047), [&](GeoJSONData::TileFeatures tileFeatures) {
+        for (const auto& feature : tileFeatures) {
+            if (feature.properties.count("cluster_id")) {
+                clusterID = uint32_t(feature.properties.at("cluster_id").get<uint64_t>());
+                pointCount = feature.properties.at("point_count").get<uint64_t>();
+                break;
+            }
+        }
+        loop.stop();
+    });
+    loop.run();
+    ASSERT_NE(0u, clusterID);
+    EXPECT_EQ(12u, clusterID % 32 - 1);
+
+    EXPECT_FALSE(data->getChildren(clusterID).empty());
+    EXPECT_EQ(pointCount, data->getLeaves(clusterID, 1000, 0).size());
+    EXPECT_LT(12u, data->getClusterExpansionZoom(clusterID));
+}
+
 TEST(Source, SetMaxParentOverscaleFactor) {
     SourceTest test;
     test.transform.jumpTo(CameraOptions().withCenter(LatLng()).withZoom(8.0));
@@ -1,16 +1,20 @@
 #include <mbgl/test/util.hpp>
 #include <mbgl/test/stub_file_source.hpp>
 #include <mbgl/test/fixture_log_observer.hpp>
+#include <mbgl/test/stub_style_observer.hpp>
 
 #include <mbgl/style/style_impl.hpp>
 #include <mbgl/style/source_impl.hpp>
+#include <mbgl/style/sources/geojson_source.hpp>
 #include <mbgl/style/sources/vector_source.hpp>
 #include <mbgl/style/layer.hpp>
 #include <mbgl/style/layers/line_layer.hpp>
+#include <mbgl/util/exception.hpp>
 #include <mbgl/util/io.hpp>
 #include <mbgl/util/run_loop.hpp>
 
 #include <memory>
+#include <unordered_map>
 
 using namespace mbgl;
 using namespace mbgl::style;
@@ -126,6 +130,93 @@ TEST(Style, SourceImplsOrder) {
     EXPECT_EQ("c", sourceImpls[2]->id);
 }
 
+TEST(Style, ApplyPatch) {
+    util::RunLoop loop;
+    auto fileSource = std::make_shared<StubFileSource>();
+    Style::Impl style{fileSource, 1.0};
+
+    style.loadJSON(R"STYLE({
+        "version": 8,
+        "sources": {
+            "a": { "type": "geojson", "data": { "type": "FeatureCollection", "features": [] } },
+            "b": { "type": "geojson", "data": { "type": "FeatureCollection", "features": [] } }
+        },
+        "layers": [
+            { "id": "background", "type": "background" },
+            { "id": "fill", "type": "fill", "source": "a", "paint": { "fill-color": "red" } },
+            { "id": "line", "type": "line", "source": "b" },
+            { "id": "circle", "type": "circle", "source": "b" }
+        ]
+    })STYLE");
+
+    const auto previousSources = style.getSourceImpls();
+    const auto previousLayers = style.getLayerImpls();
+    ASSERT_EQ(4u, previousLayers->size());
+
+    style.applyPatch(R"STYLE({
+        "version": 8,
+        "sources": {
+            "a": { "type": "geojson", "data": { "type": "FeatureCollection", "features": [] } },
+            "b": { "type": "geojson", "data": { "type": "FeatureCollection", "features": [] }, "maxzoom": 12 }
+        },
+        "layers": [
+            { "id": "background", "type": "background" },
+            { "id": "fill", "type": "fill", "source": "a", "paint": { "fill-color": "blue" } },
+            { "id": "line", "type": "line", "source": "b" }
+        ]
+    })STYLE");
+
+    const auto sources = style.getSourceImpls();
+    ASSERT_EQ(2u, sources->size());
+    EXPECT_EQ((*previousSources)[0].get(), (*sources)[0].get());
+    EXPECT_NE((*previousSources)[1].get(), (*sources)[1].get());
+
+    // The background is untouched, the fill changed and the line uses a changed source.
+    const auto layers = style.getLayerImpls();
+    ASSERT_EQ(3u, layers->size());
+    EXPECT_EQ((*previousLayers)[0].get(), (*layers)[0].get());
+    EXPECT_NE((*previousLayers)[1].get(), (*layers)[1].get());
+    EXPECT_NE((*previousLayers)[2].get(), (*layers)[2].get());
+    EXPECT_EQ(nullptr, style.getLayer("circle"));
+    EXPECT_EQ("fill", (*layers)[1]->id);
+}
+
+TEST(Style, ApplyPatchMutatedSources) {
+    util::RunLoop loop;
+    auto fileSource = std::make_shared<StubFileSource>();
+    Style style{fileSource, 1.0};
+
+    const std::string json = R"STYLE({
+        "version": 8,
+        "sources": {
+            "a": { "type": "geojson", "data": { "type": "FeatureCollection", "features": [] } },
+            "b": { "type": "geojson", "data": { "type": "FeatureCollection", "features": [] } },
+            "c": { "type": "geojson", "data": { "type": "FeatureCollection", "features": [] } }
+        },
+        "layers": []
+    })STYLE";
+    style.loadJSON(json);
+
+    // Source "a" is changed through the API, and "b" is replaced by a different source.
+    auto* a = static_cast<GeoJSONSource*>(style.getSource("a"));
+    ASSERT_TRUE(a);
+    a->setGeoJSON(mapbox::geojson::parse(R"({"type": "Point", "coordinates": [1.1, 1.1]})"));
+    style.removeSource("b");
+    style.addSource(std::make_unique<GeoJSONSource>("b"));
+    std::unordered_map<std::string, const Source::Impl*> previousSources;
+    for (const auto& source : *style.impl->getSourceImpls()) {
+        previousSources.emplace(source->id, source.get());
+    }
+
+    // The style JSON is the same, but only the untouched source is kept.
+    style.applyPatch(json);
+    const auto sources = style.impl->getSourceImpls();
+    ASSERT_EQ(3u, sources->size());
+    for (const auto& source : *sources) {
+        EXPECT_EQ(source->id == "c", previousSources.at(source->id) == source.get()) << source->id;
+    }
+}
+
 TEST(Style, AddRemoveImage) {
     util::RunLoop loop;
     auto fileSource = std::make_shared<StubFileSource>();
@@ -158,4 +249,60 @@ TEST(Style, AddRemoveRemoveImage) {
     EXPECT_TRUE(!!style.getImage("three"));
     EXPECT_FALSE(!!style.getImage("two"));
     EXPECT_FALSE(!!style.getImage("four"));
-}
\ No newline at end of file
+}
+
+TEST(Style, AddEncodedImage) {
+    util::RunLoop loop;
+    auto fileSource = std::make_shared<StubFileSource>();
+    Style::Impl style{fileSource, 1.0};
+    StubStyleObserver observer;
+    style.setObserver(&observer);
+
+    auto data = std::make_shared<const std::string>(util::read_file("test/fixtures/image/tile.png"));
+    // An image added while the data decodes takes precedence.
+    style.addEncodedImage("replaced", data, 2.0f, false);
+    style.addImage(std::make_unique<style::Image>("replaced", PremultipliedImage({16, 16}), 1));
+    style.addEncodedImage("tile", data, 2.0f, false);
+    EXPECT_FALSE(!!style.getImage("tile"));
+
+    observer.update = [&] { loop.stop(); };
+    loop.run();
+
+    auto tile = style.getImage("tile");
+    ASSERT_TRUE(!!tile);
+    EXPECT_EQ(Size(256, 256), (*tile)->image.size);
+    EXPECT_EQ(2.0f, (*tile)->pixelRatio);
+    EXPECT_EQ(Size(16, 16), (*style.getImage("replaced"))->image.size);
+}
+
+TEST(Style, AddEncodedImageInvalid) {
+    util::RunLoop loop;
+    auto fileSource = std::make_shared<StubFileSource>();
+    Style::Impl style{fileSource, 1.0};
+
+    auto data = std::make_shared<const std::string>(util::read_file("test/fixtures/image/tile.png"));
+    EXPECT_THROW(style.addEncodedImage("tile", data, 0.0f, false), util::StyleImageException);
+    EXPECT_THROW(style.addEncodedImage("tile", data, -1.0f, false), util::StyleImageException);
+    EXPECT_THROW(style.addEncodedImage("tile", nullptr, 1.0f, false), util::StyleImageException);
+}
+
+TEST(Style, AddEncodedImageNewStyle) {
+    util::RunLoop loop;
+    auto fileSource = std::make_shared<StubFileSource>();
+    Style::Impl style{fileSource, 1.0};
+    StubStyleObserver observer;
+    style.setObserver(&observer);
+
+    // Images still being decoded when a new style is loaded aren't added to it.
+    auto data = std::make_shared<const std::string>(util::read_file("test/fixtures/image/tile.png"));
+    style.addEncodedImage("before", data, 1.0f, false);
+    style.loadJSON(R"STYLE({ "version": 8, "sources": {}, "layers": [] })STYLE");
+    style.addEncodedImage("after", data, 1.0f, false);
+
+    observer.update = [&] {
+        if (style.getImage("after")) loop.stop();
+    };
+    loop.run();
+
+    EXPECT_FALSE(!!style.getImage("before"));
+}
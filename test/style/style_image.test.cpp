@@ -1,6 +1,7 @@
 #include <mbgl/test/util.hpp>
 
 #include <mbgl/style/image.hpp>
+#include <mbgl/style/image_impl.hpp>
 #include <mbgl/util/image.hpp>
 #include <mbgl/util/exception.hpp>
 
@@ -119,3 +120,31 @@ TEST(StyleImage, StretchContent) {
     EXPECT_EQ((style::ImageStretches{{0, 4}, {12, 16}}), image.getStretchY());
     EXPECT_EQ((style::ImageContent{2, 2, 14, 14}), image.getContent());
 }
+
+TEST(StyleImage, SpriteSheetArea) {
+    auto sheet = std::make_shared<PremultipliedImage>(Size{4, 4});
+    for (uint8_t i = 0; i < sheet->bytes(); ++i) {
+        sheet->data[i] = i;
+    }
+    std::weak_ptr<const PremultipliedImage> weakSheet = sheet;
+
+    style::Image::Impl first("first", sheet, {1, 2}, {2, 2}, 1);
+    style::Image::Impl second("second", std::move(sheet), {0, 0}, {1, 1}, 1);
+    EXPECT_EQ(Size(2, 2), first.size);
+
+    // The pixels are copied out of the sheet once needed, and the sheet goes with the last image.
+    const PremultipliedImage& image = first.getImage();
+    ASSERT_EQ(Size(2, 2), image.size);
+    EXPECT_EQ((2 * 4 + 1) * 4, image.data[0]);
+    EXPECT_EQ((3 * 4 + 2) * 4, image.data[12]);
+    EXPECT_FALSE(weakSheet.expired());
+    second.getImage();
+    EXPECT_TRUE(weakSheet.expired());
+
+    try {
+        style::Image::Impl("outside", std::make_shared<PremultipliedImage>(Size{4, 4}), {3, 3}, {2, 2}, 1);
+        FAIL() << "Expected exception";
+    } catch (util::StyleImageException& ex) {
+        EXPECT_STREQ("area is outside of the sprite", ex.what());
+    }
+}
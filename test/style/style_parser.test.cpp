@@ -204,3 +204,30 @@ TEST(StyleParser, FontStacksGetExpression) {
     auto result = parser.fontStacks();
     ASSERT_EQ(0u, result.size());
 }
+
+TEST(StyleParser, ManyLayers) {
+    // Enough layers to be converted concurrently, which keeps their order.
+    std::string layers;
+    for (int i = 0; i < 500; ++i) {
+        if (i) layers += ",";
+        if (i % 50 == 1) {
+            layers += R"({ "id": "ref)" + util::toString(i) + R"(", "ref": "layer)" + util::toString(i - 1) + R"(" })";
+        } else {
+            layers += R"({ "id": "layer)" + util::toString(i) +
+                      R"(", "type": "line", "source": "vector", "source-layer": "road", "paint": { "line-width": )" +
+                      util::toString(i) + " } }";
+        }
+    }
+    // An invalid layer is skipped.
+    layers += R"(, { "id": "invalid", "type": "line", "source": "vector", "paint": { "line-width": "wide" } })";
+
+    FixtureLog log;
+    style::Parser parser;
+    parser.parse(R"({ "version": 8, "layers": [)" + layers + "] }");
+
+    ASSERT_EQ(500u, parser.layers.size());
+    for (int i = 0; i < 500; ++i) {
+        EXPECT_EQ((i % 50 == 1 ? "ref" : "layer") + util::toString(i), parser.layers[i]->getID());
+    }
+    EXPECT_EQ(1u, log.count({EventSeverity::Warning, Event::ParseStyle, -1, "value must be a number"}));
+}
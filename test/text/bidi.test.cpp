@@ -88,3 +88,20 @@ TEST(BiDi, StyledText) {
     EXPECT_EQ(bidi.processStyledText(input, { 5, 18, 30 }), expected);
 }
 
+
+TEST(BiDi, RepeatedText) {
+    // Results are reused for the same text and line breaks, whichever instance asks for them.
+    const std::u16string text = applyArabicShaping(u"مكتبة الإسكندرية‎‎ Maktabat al-Iskandarīyah");
+    const auto lines = BiDi().processText(text, { 18, 30 });
+    EXPECT_EQ(BiDi().processText(text, { 18, 30 }), lines);
+    EXPECT_EQ(BiDi().processText(text, {}),
+              std::vector<std::u16string>{ u" Maktabat al-Iskandarīyahﺔﻳﺭﺪﻨﻜﺳﻹﺍ ﺔﺒﺘﻜﻣ" });
+
+    // Styled text with the same code points is told apart by its style indices.
+    const StyledText styledText(text, std::vector<uint8_t>(text.size(), 1));
+    const auto styledLines = BiDi().processStyledText(styledText, { 18, 30 });
+    EXPECT_EQ(BiDi().processStyledText(styledText, { 18, 30 }), styledLines);
+    for (const auto& line : BiDi().processStyledText({ text, std::vector<uint8_t>(text.size(), 2) }, { 18, 30 })) {
+        EXPECT_EQ(line.second, std::vector<uint8_t>(line.first.size(), 2));
+    }
+}
@@ -0,0 +1,92 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/text/dynamic_glyph_atlas.hpp>
+#include <mbgl/util/font_stack.hpp>
+
+using namespace mbgl;
+
+namespace {
+
+Immutable<Glyph> makeGlyph(GlyphID id, uint32_t size, uint8_t value = 255) {
+    Glyph glyph;
+    glyph.id = id;
+    glyph.metrics.width = size - 6;
+    glyph.metrics.height = size - 6;
+    glyph.metrics.advance = size - 6;
+    glyph.bitmap = AlphaImage({size, size});
+    glyph.bitmap.fill(value);
+    return makeMutable<Glyph>(std::move(glyph));
+}
+
+} // namespace
+
+TEST(DynamicGlyphAtlas, SharesGlyphs) {
+    auto atlas = DynamicGlyphAtlas::create();
+    const FontStackHash fontStack = FontStackHasher()({"Test Regular"});
+
+    Glyph space;
+    space.id = u' ';
+    GlyphMap first{{fontStack, {{u'a', makeGlyph(u'a', 20)}, {u' ', makeMutable<Glyph>(std::move(space))}}}};
+    GlyphMap second{{fontStack, {{u'a', makeGlyph(u'a', 20)}, {u'b', makeGlyph(u'b', 20)}}}};
+
+    GlyphPositions firstPositions;
+    auto firstReservation = atlas->addGlyphs(first, firstPositions);
+    // Glyphs without a bitmap don't take up space in the atlas.
+    ASSERT_EQ(1u, firstPositions[fontStack].size());
+    EXPECT_EQ(1u, atlas->glyphCount());
+
+    GlyphPositions secondPositions;
+    auto secondReservation = atlas->addGlyphs(second, secondPositions);
+    ASSERT_EQ(2u, secondPositions[fontStack].size());
+    EXPECT_EQ(2u, atlas->glyphCount());
+    EXPECT_EQ(firstPositions[fontStack].at(u'a').rect, secondPositions[fontStack].at(u'a').rect);
+    EXPECT_FALSE(secondPositions[fontStack].at(u'a').rect == secondPositions[fontStack].at(u'b').rect);
+    EXPECT_EQ(Rect<uint16_t>(0, 0, 22, 22), firstPositions[fontStack].at(u'a').rect);
+
+    // Glyphs stay in the atlas as long as any tile uses them.
+    firstReservation.reset();
+    EXPECT_EQ(2u, atlas->glyphCount());
+    secondReservation.reset();
+    EXPECT_EQ(0u, atlas->glyphCount());
+}
+
+TEST(DynamicGlyphAtlas, ReloadedGlyphs) {
+    auto atlas = DynamicGlyphAtlas::create();
+    const FontStackHash fontStack = FontStackHasher()({"Test Regular"});
+
+    GlyphPositions oldPositions;
+    auto oldReservation = atlas->addGlyphs({{fontStack, {{u'a', makeGlyph(u'a', 20)}}}}, oldPositions);
+
+    // A glyph with another bitmap, e.g. from another glyph URL, doesn't take over the old one,
+    // which tiles may still draw.
+    GlyphPositions newPositions;
+    auto newReservation = atlas->addGlyphs({{fontStack, {{u'a', makeGlyph(u'a', 20, 128)}}}}, newPositions);
+    EXPECT_EQ(2u, atlas->glyphCount());
+    EXPECT_FALSE(oldPositions[fontStack].at(u'a').rect == newPositions[fontStack].at(u'a').rect);
+
+    oldReservation.reset();
+    EXPECT_EQ(1u, atlas->glyphCount());
+    newReservation.reset();
+    EXPECT_EQ(0u, atlas->glyphCount());
+}
+
+TEST(DynamicGlyphAtlas, Grows) {
+    auto atlas = DynamicGlyphAtlas::create();
+    const FontStackHash fontStack = FontStackHasher()({"Test Regular"});
+    const Size initialSize = atlas->getSize();
+
+    GlyphMap glyphs;
+    for (GlyphID id = 0; id < 256; ++id) {
+        glyphs[fontStack].emplace(id, makeGlyph(id, 30));
+    }
+
+    GlyphPositions positions;
+    auto reservation = atlas->addGlyphs(glyphs, positions);
+    EXPECT_EQ(256u, atlas->glyphCount());
+    const Size size = atlas->getSize();
+    EXPECT_TRUE(size.width > initialSize.width || size.height > initialSize.height);
+    for (const auto& position : positions[fontStack]) {
+        EXPECT_LE(position.second.rect.x + position.second.rect.w, size.width);
+        EXPECT_LE(position.second.rect.y + position.second.rect.h, size.height);
+    }
+}
@@ -1,6 +1,11 @@
 #include <mbgl/test/util.hpp>
 #include <mbgl/test/stub_file_source.hpp>
 
+#include <mbgl/style/conversion/json.hpp>
+#include <mbgl/style/conversion/property_value.hpp>
+#include <mbgl/style/conversion_impl.hpp>
+#include <mbgl/style/layers/symbol_layer.hpp>
+#include <mbgl/style/layers/symbol_layer_impl.hpp>
 #include <mbgl/text/glyph_manager.hpp>
 #include <mbgl/util/run_loop.hpp>
 #include <mbgl/util/string.hpp>
@@ -390,3 +395,180 @@ TEST(GlyphManager, ImmediateFileSource) {
             {{{"Test Stack"}}, {u'a', u'å', u' '}}
         });
 }
+
+TEST(GlyphManager, EvictLoadedGlyphs) {
+    GlyphManagerTest test;
+    int requests = 0;
+    int notifications = 0;
+
+    test.fileSource.glyphsResponse = [&] (const Resource&) {
+        requests++;
+        Response response;
+        response.data = std::make_shared<std::string>(util::read_file("test/fixtures/resources/glyphs.pbf"));
+        return response;
+    };
+
+    test.requestor.glyphsAvailable = [&] (GlyphMap glyphs) {
+        const auto& testPositions = glyphs.at(FontStackHasher()({{"Test Stack"}}));
+        ASSERT_TRUE(bool(testPositions.at(u'a')));
+
+        if (++notifications == 1) {
+            // The range is loaded again after its glyphs were evicted.
+            test.glyphManager.evictLoadedGlyphs();
+            test.glyphManager.getGlyphs(
+                test.requestor, GlyphDependencies{{{{"Test Stack"}}, {u'a'}}}, test.fileSource);
+        } else {
+            EXPECT_EQ(2, requests);
+            test.end();
+        }
+    };
+
+    test.run(
+        "test/fixtures/resources/glyphs.pbf",
+        GlyphDependencies {
+            {{{"Test Stack"}}, {u'a'}}
+        });
+}
+
+TEST(GlyphManager, EvictLeastRecentlyUsedRanges) {
+    GlyphManagerTest test;
+    StubGlyphRequestor otherRequestor;
+    int requests = 0;
+    int loaded = 0;
+    std::size_t rangeSize = 0;
+
+    test.fileSource.glyphsResponse = [&] (const Resource&) {
+        requests++;
+        Response response;
+        response.data = std::make_shared<std::string>(util::read_file("test/fixtures/resources/glyphs.pbf"));
+        return response;
+    };
+
+    // The glyphs of ranges that loaded before the last one are still there for the requestor.
+    auto glyphsAvailable = [&] (GlyphMap glyphs) {
+        ASSERT_TRUE(bool(glyphs.at(FontStackHasher()({{"Stack A"}})).at(u'a')));
+        ASSERT_TRUE(bool(glyphs.at(FontStackHasher()({{"Stack B"}})).at(u'a')));
+    };
+    test.requestor.glyphsAvailable = glyphsAvailable;
+    otherRequestor.glyphsAvailable = glyphsAvailable;
+
+    test.observer.glyphsLoaded = [&] (const FontStack&, const GlyphRange&) {
+        switch (++loaded) {
+        case 1:
+            rangeSize = test.glyphManager.getSize();
+            EXPECT_LT(0u, rangeSize);
+            break;
+        case 2:
+            // Only the range that loaded last fits.
+            EXPECT_EQ(rangeSize, test.glyphManager.getSize());
+            test.glyphManager.getGlyphs(otherRequestor,
+                                        GlyphDependencies{{{{"Stack A"}}, {u'a'}}, {{{"Stack B"}}, {u'a'}}},
+                                        test.fileSource);
+            break;
+        default:
+            EXPECT_EQ(3, requests);
+            EXPECT_EQ(rangeSize, test.glyphManager.getSize());
+            test.end();
+        }
+    };
+
+    test.glyphManager.setMaximumSize(1);
+    test.run(
+        "test/fixtures/resources/glyphs.pbf",
+        GlyphDependencies {
+            {{{"Stack A"}}, {u'a'}},
+            {{{"Stack B"}}, {u'a'}}
+        });
+}
+
+TEST(GlyphManager, SharesPendingLocalGlyphs) {
+    GlyphManagerTest test;
+    StubGlyphRequestor otherRequestor;
+    int notifications = 0;
+
+    test.fileSource.glyphsResponse = [&] (const Resource&) {
+        ADD_FAILURE() << "Local glyphs should not be requested";
+        return optional<Response>();
+    };
+
+    auto glyphsAvailable = [&] (GlyphMap glyphs) {
+        const auto& testPositions = glyphs.at(FontStackHasher()({{"Test Stack"}}));
+        ASSERT_EQ(testPositions.size(), 1u);
+        ASSERT_TRUE(bool(testPositions.at(u'中')));
+        EXPECT_EQ((*testPositions.at(u'中'))->bitmap.size, Size(30, 30));
+        if (++notifications == 2) {
+            test.end();
+        }
+    };
+    test.requestor.glyphsAvailable = glyphsAvailable;
+    otherRequestor.glyphsAvailable = glyphsAvailable;
+
+    // The glyph is rasterized on a background thread, so neither requestor is notified
+    // right away, and the second request waits for the rasterization the first one started.
+    test.glyphManager.getGlyphs(otherRequestor, GlyphDependencies {{{{"Test Stack"}}, {u'中'}}}, test.fileSource);
+    EXPECT_EQ(0, notifications);
+
+    test.run(
+        "test/fixtures/resources/glyphs.pbf",
+        GlyphDependencies {
+            {{{"Test Stack"}}, {u'中'}}
+        });
+    EXPECT_EQ(2, notifications);
+}
+
+TEST(GlyphManager, Prefetch) {
+    GlyphManagerTest test;
+    std::set<std::string> requests;
+
+    test.fileSource.glyphsResponse = [&] (const Resource& resource) {
+        requests.insert(resource.url);
+        Response response;
+        if (resource.url == "glyphs/Test%20Stack/1024-1279.pbf") {
+            response.error = std::make_unique<Response::Error>(Response::Error::Reason::NotFound, "Not found");
+        } else {
+            response.data = std::make_shared<std::string>(util::read_file("test/fixtures/resources/glyphs.pbf"));
+        }
+        return response;
+    };
+
+    test.observer.glyphsError = [&] (const FontStack&, const GlyphRange&, std::exception_ptr) {
+        ADD_FAILURE() << "Prefetched ranges should not report errors";
+    };
+
+    style::SymbolLayer layer("symbol", "source");
+    layer.setTextFont(std::vector<std::string>{"Test Stack"});
+    style::conversion::Error error;
+    // Russian names need Cyrillic, the arrow General Punctuation, and '中' is rasterized locally.
+    auto textField = style::conversion::convertJSON<style::PropertyValue<style::expression::Formatted>>(
+        R"("{name_ru} → 中")", error, true, true);
+    ASSERT_TRUE(bool(textField)) << error.message;
+    layer.setTextField(*textField);
+    const std::vector<Immutable<style::Layer::Impl>> layers{layer.baseImpl};
+
+    test.glyphManager.setURL("glyphs/{fontstack}/{range}.pbf");
+    test.glyphManager.prefetch(layers, test.fileSource);
+    test.glyphManager.prefetch(layers, test.fileSource);
+
+    test.requestor.glyphsAvailable = [&] (GlyphMap glyphs) {
+        const auto& testPositions = glyphs.at(FontStackHasher()({{"Test Stack"}}));
+        ASSERT_TRUE(bool(testPositions.at(u'a')));
+
+        // The glyphs of the range that loaded ahead are there without another request.
+        EXPECT_EQ(std::set<std::string>({"glyphs/Test%20Stack/0-255.pbf",
+                                            "glyphs/Test%20Stack/1024-1279.pbf",
+                                            "glyphs/Test%20Stack/8192-8447.pbf"}),
+                  requests);
+        test.end();
+    };
+
+    test.observer.glyphsLoaded = [&] (const FontStack&, const GlyphRange& range) {
+        if (range == GlyphRange(0, 255)) {
+            test.glyphManager.getGlyphs(
+                test.requestor, GlyphDependencies{{{{"Test Stack"}}, {u'a'}}}, test.fileSource);
+        }
+    };
+
+    Log::setObserver(std::make_unique<Log::NullObserver>());
+    test.glyphManager.setObserver(&test.observer);
+    test.loop.run();
+}
@@ -4,6 +4,7 @@
 #include <mbgl/text/bidi.hpp>
 #include <mbgl/text/tagged_string.hpp>
 #include <mbgl/text/shaping.hpp>
+#include <mbgl/text/shaping_cache.hpp>
 #include <mbgl/util/constants.hpp>
 
 using namespace mbgl;
@@ -105,3 +106,101 @@ TEST(Shaping, ZWSP) {
         ASSERT_EQ(shaping.writingMode, WritingModeType::Horizontal);
     }
 }
+
+TEST(Shaping, Cache) {
+    GlyphPosition glyphPosition;
+    glyphPosition.rect = {0, 0, 24, 24};
+    glyphPosition.metrics.width = 18;
+    glyphPosition.metrics.height = 18;
+    glyphPosition.metrics.left = 2;
+    glyphPosition.metrics.top = -8;
+    glyphPosition.metrics.advance = 21;
+
+    Glyph glyph;
+    glyph.id = u'中';
+    glyph.metrics = glyphPosition.metrics;
+
+    BiDi bidi;
+    const std::vector<std::string> fontStack{{"cached-font-stack"}};
+    const SectionOptions sectionOptions(1.0f, fontStack);
+    GlyphMap glyphs = {
+        {FontStackHasher()(fontStack), {{u'中', Immutable<Glyph>(makeMutable<Glyph>(std::move(glyph)))}}}};
+    GlyphPositions glyphPositions = {{FontStackHasher()(fontStack), {{u'中', glyphPosition}}}};
+    ImagePositions imagePositions;
+
+    const auto testGetShaping = [&](const TaggedString& string, const GlyphPositions& positions) {
+        return getShaping(string,
+                          10 * ONE_EM, // maxWidth
+                          ONE_EM,      // lineHeight
+                          style::SymbolAnchorType::Center,
+                          style::TextJustifyType::Center,
+                          0,              // spacing
+                          {{0.0f, 0.0f}}, // translate
+                          WritingModeType::Horizontal,
+                          bidi,
+                          glyphs,
+                          positions,
+                          imagePositions,
+                          16.0f,
+                          16.0f,
+                          /*allowVerticalPlacement*/ false);
+    };
+
+    ShapingCache::get().clear();
+    const TaggedString string(u"中中", sectionOptions);
+    const Shaping shaping = testGetShaping(string, glyphPositions);
+    EXPECT_EQ(1u, ShapingCache::get().size());
+
+    // Another tile places the glyph elsewhere in its atlas.
+    GlyphPositions otherPositions = glyphPositions;
+    otherPositions.begin()->second.begin()->second.rect = {24, 0, 24, 24};
+    const Shaping cached = testGetShaping(string, otherPositions);
+    EXPECT_EQ(1u, ShapingCache::get().size());
+    ASSERT_EQ(1u, cached.positionedLines.size());
+    ASSERT_EQ(2u, cached.positionedLines[0].positionedGlyphs.size());
+    EXPECT_EQ(shaping.left, cached.left);
+    EXPECT_EQ(shaping.right, cached.right);
+    for (std::size_t i = 0; i < 2; ++i) {
+        const auto& glyphA = shaping.positionedLines[0].positionedGlyphs[i];
+        const auto& glyphB = cached.positionedLines[0].positionedGlyphs[i];
+        EXPECT_EQ(glyphA.x, glyphB.x);
+        EXPECT_EQ(glyphA.y, glyphB.y);
+        EXPECT_EQ(Rect<uint16_t>(0, 0, 24, 24), glyphA.rect);
+        EXPECT_EQ(Rect<uint16_t>(24, 0, 24, 24), glyphB.rect);
+    }
+
+    // Shapings with missing glyphs are not cached.
+    testGetShaping(TaggedString(u"中?", sectionOptions), glyphPositions);
+    EXPECT_EQ(1u, ShapingCache::get().size());
+    ShapingCache::get().clear();
+}
+
+TEST(ShapingCache, EvictsLeastRecentlyUsed) {
+    const auto makeKey = [](std::u16string text) {
+        return ShapingCache::Key{{text, std::vector<uint8_t>(text.size(), 0)},
+                                 {{0, 1.0}},
+                                 0.0f,
+                                 ONE_EM,
+                                 style::SymbolAnchorType::Center,
+                                 style::TextJustifyType::Center,
+                                 0.0f,
+                                 {{0.0f, 0.0f}},
+                                 WritingModeType::Horizontal,
+                                 16.0f,
+                                 16.0f,
+                                 false};
+    };
+
+    ShapingCache cache(2);
+    cache.add(makeKey(u"a"), Shaping(1.0f, 0.0f, WritingModeType::Horizontal));
+    cache.add(makeKey(u"b"), Shaping(2.0f, 0.0f, WritingModeType::Horizontal));
+    ASSERT_TRUE(cache.find(makeKey(u"a")));
+    cache.add(makeKey(u"c"), Shaping(3.0f, 0.0f, WritingModeType::Horizontal));
+
+    EXPECT_EQ(2u, cache.size());
+    EXPECT_FALSE(cache.find(makeKey(u"b")));
+    ASSERT_TRUE(cache.find(makeKey(u"a")));
+    EXPECT_EQ(1.0f, cache.find(makeKey(u"a"))->left);
+    ASSERT_TRUE(cache.find(makeKey(u"c")));
+    EXPECT_EQ(3.0f, cache.find(makeKey(u"c"))->left);
+}
@@ -5,6 +5,7 @@
 #include <mbgl/tile/custom_geometry_tile.hpp>
 #include <mbgl/style/custom_tile_loader.hpp>
 
+#include <mbgl/actor/actor.hpp>
 #include <mbgl/util/run_loop.hpp>
 #include <mbgl/map/transform.hpp>
 #include <mbgl/renderer/tile_parameters.hpp>
@@ -16,6 +17,7 @@
 #include <mbgl/text/glyph_manager.hpp>
 
 #include <memory>
+#include <mutex>
 
 using namespace mbgl;
 using namespace mbgl::style;
@@ -38,7 +40,9 @@ public:
                                   annotationManager.makeWeakPtr(),
                                   imageManager,
                                   glyphManager,
-                                  0};
+                                  0,
+                                  nullptr,
+                                  nullptr};
 };
 
 TEST(CustomGeometryTile, InvokeFetchTile) {
@@ -135,3 +139,68 @@ TEST(CustomGeometryTile, InvokeTileChanged) {
         test.loop.runOnce();
     }
 }
+
+TEST(CustomGeometryTile, LoadTilesClosestToViewportFirst) {
+    CustomTileTest test;
+
+    std::mutex mutex;
+    std::vector<CanonicalTileID> loaded;
+    CustomGeometrySource::Options options;
+    options.loadTileFunction = [&](const CanonicalTileID& tileId) {
+        std::lock_guard<std::mutex> lock(mutex);
+        loaded.push_back(tileId);
+        if (loaded.size() == 3) {
+            test.loop.stop();
+        }
+        return GeoJSON{mapbox::feature::feature_collection<double>{}};
+    };
+
+    Actor<CustomTileLoader> loader(*Scheduler::GetCurrent(), options);
+    loader.self().invoke(&CustomTileLoader::setViewportCenter, LatLng(-30, 45));
+
+    std::vector<std::unique_ptr<CustomGeometryTile>> tiles;
+    for (const auto& tileId : {OverscaledTileID(2, 0, 0), OverscaledTileID(2, 3, 3), OverscaledTileID(2, 2, 2)}) {
+        tiles.push_back(std::make_unique<CustomGeometryTile>(
+            tileId, "source", test.tileParameters, makeMutable<CustomGeometrySource::TileOptions>(), loader.self()));
+        tiles.back()->setNecessity(TileNecessity::Required);
+    }
+
+    test.loop.run();
+
+    // The first tile starts loading right away, the others wait for it in order of distance.
+    ASSERT_EQ(3u, loaded.size());
+    EXPECT_EQ(CanonicalTileID(2, 0, 0), loaded[0]);
+    EXPECT_EQ(CanonicalTileID(2, 2, 2), loaded[1]);
+    EXPECT_EQ(CanonicalTileID(2, 3, 3), loaded[2]);
+}
+
+TEST(CustomGeometryTile, LoadTileFunctionThrows) {
+    CustomTileTest test;
+
+    std::mutex mutex;
+    std::vector<CanonicalTileID> loaded;
+    CustomGeometrySource::Options options;
+    options.loadTileFunction = [&](const CanonicalTileID& tileId) -> GeoJSON {
+        std::lock_guard<std::mutex> lock(mutex);
+        loaded.push_back(tileId);
+        if (loaded.size() == 1) {
+            throw std::runtime_error("truncated file");
+        }
+        test.loop.stop();
+        return GeoJSON{mapbox::feature::feature_collection<double>{}};
+    };
+
+    Actor<CustomTileLoader> loader(*Scheduler::GetCurrent(), options);
+
+    std::vector<std::unique_ptr<CustomGeometryTile>> tiles;
+    for (const auto& tileId : {OverscaledTileID(1, 0, 0), OverscaledTileID(1, 1, 1)}) {
+        tiles.push_back(std::make_unique<CustomGeometryTile>(
+            tileId, "source", test.tileParameters, makeMutable<CustomGeometrySource::TileOptions>(), loader.self()));
+        tiles.back()->setNecessity(TileNecessity::Required);
+    }
+
+    test.loop.run();
+
+    // The failed load released the only load slot, so the second tile was loaded after it.
+    EXPECT_EQ(2u, loaded.size());
+}
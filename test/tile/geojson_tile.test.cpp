@@ -39,7 +39,9 @@ public:
                                   annotationManager.makeWeakPtr(),
                                   imageManager,
                                   glyphManager,
-                                  0};
+                                  0,
+                                  nullptr,
+                                  nullptr};
 };
 
 namespace {
@@ -16,9 +16,10 @@ static double _signedArea(const GeometryCoordinates& ring) {
 }
 
 TEST(GeometryTileData, classifyRings1) {
-    std::vector<GeometryCollection> polygons = classifyRings({
+    const GeometryCollection rings = {
       { {0, 0}, {0, 40}, {40, 40}, {40, 0}, {0, 0} }
-    });
+    };
+    std::vector<GeometryPolygon> polygons = classifyRings(rings);
 
     // output: 1 polygon
     ASSERT_EQ(polygons.size(), 1u);
@@ -27,15 +28,19 @@ TEST(GeometryTileData, classifyRings1) {
 }
 
 TEST(GeometryTileData, classifyRings2) {
-    std::vector<GeometryCollection> polygons = classifyRings({
+    const GeometryCollection rings = {
       { {0, 0}, {0, 40}, {40, 40}, {40, 0}, {0, 0} },
       { {10, 10}, {20, 10}, {20, 20}, {10, 10} }
-    });
+    };
+    std::vector<GeometryPolygon> polygons = classifyRings(rings);
 
     // output: 1 polygon
     ASSERT_EQ(polygons.size(), 1u);
     // output: polygon 1 has 1 exterior, 1 interior
     ASSERT_EQ(polygons[0].size(), 2u);
+    // the polygon refers to the rings instead of copying them
+    ASSERT_EQ(&polygons[0][0], &rings[0]);
+    ASSERT_EQ(&polygons[0][1], &rings[1]);
 }
 
 TEST(GeometryTileData, limitHoles1) {
@@ -104,4 +109,12 @@ TEST(GeometryTileData, limitHoles3) {
     ASSERT_EQ(original.at(1), polygon.at(1));
     ASSERT_EQ(original.at(3), polygon.at(2));
 
+    // the rings of a classified polygon are limited the same way
+    std::vector<GeometryPolygon> polygons = classifyRings(original);
+    ASSERT_EQ(polygons.size(), 1u);
+    limitHoles(polygons[0], 2);
+    ASSERT_EQ(polygons[0].size(), 3u);
+    ASSERT_EQ(&polygons[0][0], &original.at(0));
+    ASSERT_EQ(&polygons[0][1], &original.at(1));
+    ASSERT_EQ(&polygons[0][2], &original.at(3));
 }
@@ -33,7 +33,9 @@ public:
                                   annotationManager.makeWeakPtr(),
                                   imageManager,
                                   glyphManager,
-                                  0};
+                                  0,
+                                  nullptr,
+                                  nullptr};
 };
 
 TEST(RasterTile, setError) {
@@ -42,7 +42,9 @@ public:
                                   annotationManager.makeWeakPtr(),
                                   imageManager,
                                   glyphManager,
-                                  0};
+                                  0,
+                                  nullptr,
+                                  nullptr};
 };
 
 class VectorTileMock : public VectorTile {
@@ -56,6 +58,17 @@ public:
     }
 };
 
+class SizedVectorTileMock : public VectorTileMock {
+public:
+    SizedVectorTileMock(const OverscaledTileID& id_, const TileParameters& parameters, const Tileset& tileset, size_t bytes_)
+        : VectorTileMock(id_, "source", parameters, tileset), bytes(bytes_) {}
+
+    size_t getMemoryUsage() const override { return bytes; }
+
+private:
+    size_t bytes;
+};
+
 TEST(TileCache, Smoke) {
     VectorTileTest test;
     TileCache cache(1);
@@ -85,3 +98,89 @@ TEST(TileCache, Issue15926) {
     EXPECT_FALSE(cache.has(id0));
     EXPECT_TRUE(cache.has(id1));
 }
+
+TEST(TileCache, LeastRecentlyUsed) {
+    VectorTileTest test;
+    TileCache cache(2);
+    OverscaledTileID id0(0, 0, 0);
+    OverscaledTileID id1(1, 0, 0);
+    OverscaledTileID id2(1, 1, 0);
+
+    cache.add(id0, std::make_unique<VectorTileMock>(id0, "source", test.tileParameters, test.tileset));
+    cache.add(id1, std::make_unique<VectorTileMock>(id1, "source", test.tileParameters, test.tileset));
+    // Re-adding an existing key marks it as the newest entry.
+    cache.add(id0, std::make_unique<VectorTileMock>(id0, "source", test.tileParameters, test.tileset));
+    cache.add(id2, std::make_unique<VectorTileMock>(id2, "source", test.tileParameters, test.tileset));
+    EXPECT_TRUE(cache.has(id0));
+    EXPECT_FALSE(cache.has(id1));
+    EXPECT_TRUE(cache.has(id2));
+}
+
+TEST(TileCache, MaxBytes) {
+    VectorTileTest test;
+    TileCache cache(10);
+    OverscaledTileID id0(0, 0, 0);
+    OverscaledTileID id1(1, 0, 0);
+    OverscaledTileID id2(1, 1, 0);
+
+    cache.setMaxBytes(250u);
+    cache.add(id0, std::make_unique<SizedVectorTileMock>(id0, test.tileParameters, test.tileset, 100u));
+    cache.add(id1, std::make_unique<SizedVectorTileMock>(id1, test.tileParameters, test.tileset, 100u));
+    EXPECT_EQ(200u, cache.getBytes());
+
+    cache.add(id2, std::make_unique<SizedVectorTileMock>(id2, test.tileParameters, test.tileset, 100u));
+    EXPECT_FALSE(cache.has(id0));
+    EXPECT_TRUE(cache.has(id1));
+    EXPECT_TRUE(cache.has(id2));
+    EXPECT_EQ(200u, cache.getBytes());
+
+    auto tile = cache.pop(id1);
+    EXPECT_TRUE(tile);
+    EXPECT_EQ(100u, cache.getBytes());
+
+    cache.setMaxBytes(50u);
+    EXPECT_FALSE(cache.has(id2));
+    EXPECT_EQ(0u, cache.getBytes());
+}
+
+TEST(TileCache, Trim) {
+    VectorTileTest test;
+    TileCache cache(10);
+    OverscaledTileID id0(0, 0, 0);
+    OverscaledTileID id1(1, 0, 0);
+    OverscaledTileID id2(1, 1, 0);
+
+    cache.add(id0, std::make_unique<SizedVectorTileMock>(id0, test.tileParameters, test.tileset, 100u));
+    cache.add(id1, std::make_unique<SizedVectorTileMock>(id1, test.tileParameters, test.tileset, 100u));
+    cache.add(id2, std::make_unique<SizedVectorTileMock>(id2, test.tileParameters, test.tileset, 100u));
+
+    // Trimming drops the oldest tiles and doesn't limit the tiles added later.
+    cache.trim(150u);
+    EXPECT_FALSE(cache.has(id0));
+    EXPECT_FALSE(cache.has(id1));
+    EXPECT_TRUE(cache.has(id2));
+    EXPECT_EQ(100u, cache.getBytes());
+
+    cache.add(id0, std::make_unique<SizedVectorTileMock>(id0, test.tileParameters, test.tileset, 100u));
+    EXPECT_EQ(200u, cache.getBytes());
+}
+
+TEST(TileCache, Stale) {
+    VectorTileTest test;
+    TileCache cache(10);
+    OverscaledTileID id0(0, 0, 0);
+    OverscaledTileID id1(1, 0, 0);
+
+    cache.add(id0, std::make_unique<VectorTileMock>(id0, "source", test.tileParameters, test.tileset));
+    EXPECT_FALSE(cache.isStale(id0));
+
+    // Stale tiles stay in the cache; only the tiles cached so far are stale.
+    cache.markStale();
+    cache.add(id1, std::make_unique<VectorTileMock>(id1, "source", test.tileParameters, test.tileset));
+    EXPECT_TRUE(cache.has(id0));
+    EXPECT_TRUE(cache.isStale(id0));
+    EXPECT_FALSE(cache.isStale(id1));
+
+    EXPECT_TRUE(cache.pop(id0));
+    EXPECT_FALSE(cache.isStale(id0));
+}
@@ -7,6 +7,8 @@
 #include <mbgl/util/run_loop.hpp>
 #include <mbgl/map/transform.hpp>
 #include <mbgl/style/style.hpp>
+#include <mbgl/style/layers/fill_layer.hpp>
+#include <mbgl/style/layers/fill_layer_impl.hpp>
 #include <mbgl/style/layers/symbol_layer.hpp>
 #include <mbgl/renderer/tile_parameters.hpp>
 #include <mbgl/renderer/buckets/symbol_bucket.hpp>
@@ -15,6 +17,7 @@
 #include <mbgl/annotation/annotation_manager.hpp>
 #include <mbgl/renderer/image_manager.hpp>
 #include <mbgl/text/glyph_manager.hpp>
+#include <mbgl/test/stub_tile_observer.hpp>
 
 #include <memory>
 
@@ -39,7 +42,9 @@ public:
                                   annotationManager.makeWeakPtr(),
                                   imageManager,
                                   glyphManager,
-                                  0};
+                                  0,
+                                  nullptr,
+                                  nullptr};
 };
 
 TEST(VectorTile, setError) {
@@ -70,6 +75,76 @@ TEST(VectorTile, Issue8542) {
     tile.querySourceFeatures(result, { { {"layer"} }, {} });
 }
 
+TEST(VectorTile, SameData) {
+    VectorTileTest test;
+    VectorTile tile(OverscaledTileID(0, 0, 0), "source", test.tileParameters, test.tileset);
+    tile.setLayers({});
+
+    auto data = std::make_shared<const std::string>(util::read_file("test/fixtures/map/issue12432/0-0-0.mvt"));
+    tile.setData(data);
+    EXPECT_FALSE(tile.isComplete());
+    while (!tile.isComplete()) {
+        test.loop.runOnce();
+    }
+
+    // The same bytes don't need another layout.
+    tile.setData(std::make_shared<const std::string>(*data));
+    EXPECT_TRUE(tile.isComplete());
+
+    tile.setData(nullptr);
+    EXPECT_FALSE(tile.isComplete());
+}
+
+namespace {
+
+// Data whose layers fail while their features are read.
+class ThrowingTileData : public GeometryTileData {
+public:
+    class Layer : public GeometryTileLayer {
+    public:
+        std::size_t featureCount() const override { return 1; }
+        std::unique_ptr<GeometryTileFeature> getFeature(std::size_t) const override {
+            throw std::runtime_error("corrupt feature");
+        }
+        std::string getName() const override { return "layer"; }
+    };
+
+    std::unique_ptr<GeometryTileData> clone() const override { return std::make_unique<ThrowingTileData>(); }
+    std::unique_ptr<GeometryTileLayer> getLayer(const std::string&) const override {
+        return std::make_unique<Layer>();
+    }
+};
+
+} // namespace
+
+// The bucket tasks of a tile run in parallel, and their errors go to the tile like any other.
+TEST(VectorTile, BucketTaskError) {
+    VectorTileTest test;
+    VectorTile tile(OverscaledTileID(0, 0, 0), "source", test.tileParameters, test.tileset);
+
+    std::vector<Immutable<style::LayerProperties>> layers;
+    for (const auto* id : {"a", "b", "c", "d"}) {
+        style::FillLayer layer(id, "source");
+        layer.setSourceLayer(id);
+        layers.push_back(makeMutable<style::FillLayerProperties>(
+            staticImmutableCast<style::FillLayer::Impl>(layer.baseImpl)));
+    }
+
+    std::exception_ptr error;
+    StubTileObserver observer;
+    observer.tileError = [&](Tile&, std::exception_ptr error_) {
+        error = error_;
+        test.loop.stop();
+    };
+    tile.setObserver(&observer);
+    tile.setLayers(layers);
+    static_cast<GeometryTile&>(tile).setData(std::make_unique<ThrowingTileData>());
+    test.loop.run();
+
+    ASSERT_TRUE(error);
+    EXPECT_THROW(std::rethrow_exception(error), std::runtime_error);
+}
+
 TEST(VectorTileData, ParseResults) {
     VectorTileData data(std::make_shared<std::string>(util::read_file("test/fixtures/map/issue12432/0-0-0.mvt")));
 
@@ -104,3 +179,67 @@ TEST(VectorTileData, ParseResults) {
 
     ASSERT_EQ(feature->getValue("invalid"), nullopt);
 }
+
+TEST(VectorTileData, ForEachFeature) {
+    VectorTileData data(std::make_shared<std::string>(util::read_file("test/fixtures/map/issue12432/0-0-0.mvt")));
+    std::unique_ptr<GeometryTileLayer> layer = data.getLayer("admin");
+    ASSERT_TRUE(layer);
+
+    std::size_t visited = 0;
+    layer->forEachFeature([&](std::size_t i, const GeometryTileFeature& feature) {
+        EXPECT_EQ(i, visited++);
+        if (i == 0u) {
+            EXPECT_EQ(feature.getType(), mbgl::FeatureType::LineString);
+            EXPECT_EQ(feature.getID().get<uint64_t>(), 1u);
+        }
+    });
+    EXPECT_EQ(visited, layer->featureCount());
+}
+
+TEST(VectorTileData, PropertyColumns) {
+    VectorTileData data(std::make_shared<std::string>(util::read_file("test/fixtures/map/issue12432/0-0-0.mvt")));
+    std::unique_ptr<GeometryTileLayer> first = data.getLayer("admin");
+    std::unique_ptr<GeometryTileLayer> second = data.getLayer("admin");
+    // Clones read the values from the features.
+    std::unique_ptr<GeometryTileLayer> cloned = data.clone()->getLayer("admin");
+    ASSERT_TRUE(first && second && cloned);
+
+    // The second pass over the features reads the values from the decoded columns.
+    for (const auto* layer : {first.get(), second.get(), cloned.get()}) {
+        for (std::size_t i = 0; i < layer->featureCount(); ++i) {
+            auto feature = layer->getFeature(i);
+            const auto& properties = feature->getProperties();
+            for (const auto& key : {"disputed", "maritime", "invalid"}) {
+                auto it = properties.find(key);
+                if (it == properties.end()) {
+                    EXPECT_EQ(nullopt, feature->getValue(key));
+                } else {
+                    EXPECT_EQ(it->second, *feature->getValue(key));
+                }
+            }
+        }
+    }
+}
+
+TEST(VectorTileData, SharedBuffer) {
+    const std::string url = "https://example.com/0/0/0.mvt";
+    auto data = std::make_shared<std::string>(util::read_file("test/fixtures/map/issue12432/0-0-0.mvt"));
+    auto copy = std::make_shared<std::string>(*data);
+
+    auto first = VectorTileData::create(url, data);
+    auto second = VectorTileData::create(url, copy);
+    EXPECT_TRUE(first->sharesBufferWith(*second));
+    ASSERT_TRUE(second->getLayer("admin"));
+    EXPECT_EQ(second->getLayer("admin")->featureCount(), 17154u);
+
+    // Different contents for the same URL are never shared.
+    auto third = VectorTileData::create(url, std::make_shared<std::string>());
+    EXPECT_FALSE(first->sharesBufferWith(*third));
+
+    // Once all users are gone, new data does not refer to the old buffer.
+    first.reset();
+    second.reset();
+    third.reset();
+    auto fourth = VectorTileData::create(url, data);
+    EXPECT_EQ(fourth->getLayer("admin")->featureCount(), 17154u);
+}
@@ -0,0 +1,89 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/util/arena.hpp>
+
+#include <cstdint>
+#include <list>
+#include <vector>
+
+using namespace mbgl;
+using namespace mbgl::util;
+
+TEST(Arena, Allocate) {
+    Arena arena(256);
+    void* a = arena.allocate(3, 1);
+    void* b = arena.allocate(8, alignof(double));
+    EXPECT_NE(a, b);
+    EXPECT_EQ(0u, reinterpret_cast<std::uintptr_t>(b) % alignof(double));
+    EXPECT_EQ(256u, arena.capacity());
+
+    // Requests that don't fit get a new block.
+    void* large = arena.allocate(1000, 8);
+    EXPECT_NE(nullptr, large);
+    EXPECT_EQ(256u + 1000u, arena.capacity());
+}
+
+TEST(Arena, Reset) {
+    Arena arena(256);
+    arena.allocate(200, 8);
+    arena.allocate(200, 8);
+    arena.allocate(2000, 8);
+    EXPECT_EQ(256u + 512u + 2000u, arena.capacity());
+
+    // Only the largest block is kept, and allocations start over at its beginning.
+    arena.reset();
+    EXPECT_EQ(2000u, arena.capacity());
+    void* start = arena.allocate(200, 8);
+    arena.reset();
+    EXPECT_EQ(start, arena.allocate(200, 8));
+    EXPECT_EQ(2000u, arena.capacity());
+}
+
+TEST(Arena, Release) {
+    Arena arena(256);
+    arena.allocate(200, 8);
+    arena.allocate(2000, 8);
+    arena.release();
+    EXPECT_EQ(0u, arena.capacity());
+
+    // Blocks grow from the initial size again.
+    arena.allocate(8, 8);
+    EXPECT_EQ(256u, arena.capacity());
+}
+
+TEST(Arena, DeallocateMostRecent) {
+    Arena arena(256);
+    void* a = arena.allocate(64, 8);
+    arena.deallocate(a, 64);
+    EXPECT_EQ(a, arena.allocate(64, 8));
+
+    // Older allocations are only released by reset().
+    void* b = arena.allocate(32, 8);
+    arena.deallocate(a, 64);
+    EXPECT_NE(a, arena.allocate(32, 8));
+    EXPECT_NE(a, b);
+}
+
+TEST(Arena, Containers) {
+    Arena arena;
+    {
+        ArenaVector<int> vector{ArenaAllocator<int>(&arena)};
+        for (int i = 0; i < 1000; ++i) {
+            vector.push_back(i);
+        }
+        EXPECT_EQ(999, vector.back());
+        EXPECT_EQ(&arena, vector.get_allocator().getArena());
+
+        std::list<int, ArenaAllocator<int>> list{ArenaAllocator<int>(&arena)};
+        list.push_back(1);
+        list.push_front(0);
+        EXPECT_EQ((std::vector<int>{0, 1}), std::vector<int>(list.begin(), list.end()));
+    }
+    arena.reset();
+
+    // Without an arena, the allocator uses the heap.
+    ArenaVector<int> heap;
+    heap.assign(10, 1);
+    EXPECT_EQ(nullptr, heap.get_allocator().getArena());
+    EXPECT_EQ(10u, heap.size());
+}
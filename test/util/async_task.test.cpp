@@ -2,11 +2,14 @@
 
 #include <mbgl/actor/actor_ref.hpp>
 #include <mbgl/actor/scheduler.hpp>
+#include <mbgl/platform/settings.hpp>
 #include <mbgl/test/util.hpp>
 #include <mbgl/util/run_loop.hpp>
+#include <mbgl/util/thread_pool.hpp>
 
 #include <atomic>
 #include <future>
+#include <thread>
 #include <vector>
 
 using namespace mbgl;
@@ -213,3 +216,118 @@ TEST(AsyncTask, MultipleSequencedSchedulers) {
     }
     EXPECT_EQ(shedulers.front(), std::shared_ptr<Scheduler>(Scheduler::GetSequenced()));
 }
+
+TEST(AsyncTask, BackgroundSchedulerNestedTasks) {
+    RunLoop loop;
+    std::shared_ptr<Scheduler> scheduler = Scheduler::GetBackground();
+
+    const unsigned numTasks = 100;
+    const unsigned numChildren = 10;
+    std::atomic<unsigned> remaining{numTasks * numChildren};
+
+    // Tasks scheduled from a worker land in that worker's own queue and
+    // must still run even if other workers steal them.
+    for (unsigned i = 0; i < numTasks; ++i) {
+        scheduler->schedule([&] {
+            for (unsigned j = 0; j < numChildren; ++j) {
+                scheduler->schedule([&] {
+                    if (--remaining == 0) {
+                        loop.invoke([&] { loop.stop(); });
+                    }
+                });
+            }
+        });
+    }
+
+    loop.run();
+    EXPECT_EQ(0u, remaining);
+}
+
+TEST(AsyncTask, ThreadPoolSize) {
+    auto& settings = platform::Settings::getInstance();
+
+    settings.set(platform::EXPERIMENTAL_WORKER_THREAD_COUNT, uint64_t(7));
+    EXPECT_EQ(7u, ThreadPool::defaultThreadCount());
+
+    settings.set(platform::EXPERIMENTAL_WORKER_THREAD_COUNT, mapbox::base::Value{});
+    EXPECT_LE(1u, ThreadPool::defaultThreadCount());
+
+    RunLoop loop;
+    ThreadPool pool(2);
+    EXPECT_EQ(2u, pool.threadCount());
+
+    std::atomic<unsigned> remaining{10};
+    for (unsigned i = 0; i < 10; ++i) {
+        pool.schedule([&] {
+            if (--remaining == 0) loop.invoke([&] { loop.stop(); });
+        });
+    }
+    loop.run();
+}
+
+TEST(AsyncTask, ThreadPoolPriority) {
+    RunLoop loop;
+    SequencedScheduler scheduler;
+
+    std::promise<void> started;
+    std::promise<void> unblock;
+    std::vector<TaskPriority> order;
+
+    scheduler.schedule([&] {
+        started.set_value();
+        unblock.get_future().wait();
+    });
+    started.get_future().wait();
+
+    // The tasks record the priority they run with.
+    scheduler.scheduleWithPriority(TaskPriority::Low, [&] {
+        order.push_back(Scheduler::GetCurrentPriority());
+        loop.invoke([&] { loop.stop(); });
+    });
+    scheduler.schedule([&] { order.push_back(Scheduler::GetCurrentPriority()); });
+    scheduler.scheduleWithPriority(TaskPriority::High, [&] { order.push_back(Scheduler::GetCurrentPriority()); });
+
+    unblock.set_value();
+    loop.run();
+
+    const std::vector<TaskPriority> expected{TaskPriority::High, TaskPriority::Default, TaskPriority::Low};
+    EXPECT_EQ(expected, order);
+    EXPECT_EQ(TaskPriority::Default, Scheduler::GetCurrentPriority());
+}
+
+TEST(AsyncTask, MakeThreadPool) {
+    ThreadPoolOptions options;
+    options.threadCount = 2u;
+    options.cpus = std::vector<std::size_t>{0u};
+    std::shared_ptr<Scheduler> pool = Scheduler::MakeThreadPool(options);
+
+    // Work scheduled from the pool stays on the pool.
+    std::promise<std::shared_ptr<Scheduler>> background;
+    pool->schedule([&] { background.set_value(Scheduler::GetBackground()); });
+    EXPECT_EQ(pool, background.get_future().get());
+
+    Scheduler::SetBackground(pool);
+    EXPECT_EQ(pool, std::shared_ptr<Scheduler>(Scheduler::GetBackground()));
+    Scheduler::SetBackground({});
+    EXPECT_NE(pool, std::shared_ptr<Scheduler>(Scheduler::GetBackground()));
+}
+
+TEST(AsyncTask, ThreadPoolTaskStatistics) {
+    SequencedScheduler scheduler;
+
+    std::promise<void> done;
+    scheduler.scheduleTagged(TaskTag::Tile, TaskPriority::Default, [] { std::this_thread::sleep_for(Milliseconds(10)); });
+    // Runs after the tagged task was accounted for.
+    scheduler.schedule([&] { done.set_value(); });
+    done.get_future().wait();
+
+    const TaskStatistics tile = scheduler.getTaskStatistics(TaskTag::Tile);
+    EXPECT_EQ(1u, tile.count);
+    EXPECT_LE(Milliseconds(10), tile.runTime);
+    EXPECT_EQ(0u, scheduler.getTaskStatistics(TaskTag::GeoJSON).count);
+
+    // Schedulers that don't keep statistics report zeros.
+    RunLoop loop;
+    loop.scheduleTagged(TaskTag::Tile, TaskPriority::Default, [] {});
+    EXPECT_EQ(0u, loop.getTaskStatistics(TaskTag::Tile).count);
+}
@@ -0,0 +1,39 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/util/color.hpp>
+#include <mbgl/util/interpolate.hpp>
+
+using namespace mbgl;
+
+TEST(Color, Parse) {
+    EXPECT_EQ(Color::red(), *Color::parse("#f00"));
+    EXPECT_EQ(Color::red(), *Color::parse("#FF0000"));
+    // Hex colors are parsed on their own, with the same results as the general parser.
+    EXPECT_EQ(*Color::parse("rgb(170, 187, 204)"), *Color::parse("#abc"));
+    EXPECT_EQ(*Color::parse("rgb(18, 52, 86)"), *Color::parse("#123456"));
+
+    // Other notations go through the general parser, which caches its results.
+    EXPECT_EQ(Color::blue(), *Color::parse("blue"));
+    EXPECT_EQ(Color::blue(), *Color::parse("blue"));
+    EXPECT_FLOAT_EQ(0.5f, Color::parse("rgba(255, 0, 0, 0.5)")->r);
+    EXPECT_EQ(*Color::parse("rgba(255, 0, 0, 0.5)"), *Color::parse("rgba(255, 0, 0, 0.5)"));
+    EXPECT_EQ(Color::green(), *Color::parse("# 0f0"));
+
+    EXPECT_FALSE(Color::parse(""));
+    EXPECT_FALSE(Color::parse("#"));
+    EXPECT_FALSE(Color::parse("#12345"));
+    EXPECT_FALSE(Color::parse("not a color"));
+    EXPECT_FALSE(Color::parse("not a color"));
+}
+
+TEST(Color, Interpolate) {
+    const Color a(0.1f, 0.2f, 0.3f, 0.4f);
+    const Color b(0.9f, 0.7f, 0.5f, 1.0f);
+    for (double t : {0.0, 0.25, 1.0 / 3.0, 0.5, 1.0}) {
+        const Color result = util::interpolate(a, b, t);
+        EXPECT_EQ(util::interpolate(a.r, b.r, t), result.r);
+        EXPECT_EQ(util::interpolate(a.g, b.g, t), result.g);
+        EXPECT_EQ(util::interpolate(a.b, b.b, t), result.b);
+        EXPECT_EQ(util::interpolate(a.a, b.a, t), result.a);
+    }
+}
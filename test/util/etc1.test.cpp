@@ -0,0 +1,65 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/util/etc1.hpp>
+
+#include <cstdlib>
+
+using namespace mbgl;
+
+namespace {
+
+PremultipliedImage makeImage(Size size, uint8_t alpha) {
+    PremultipliedImage image(size);
+    for (uint32_t y = 0; y < size.height; ++y) {
+        for (uint32_t x = 0; x < size.width; ++x) {
+            uint8_t* pixel = image.data.get() + 4 * (y * size.width + x);
+            pixel[0] = uint8_t(x * 255 / size.width);
+            pixel[1] = uint8_t(y * 255 / size.height);
+            pixel[2] = 128;
+            pixel[3] = alpha;
+        }
+    }
+    return image;
+}
+
+} // namespace
+
+TEST(ETC1, Roundtrip) {
+    const PremultipliedImage image = makeImage({16, 8}, 255);
+    const std::vector<uint8_t> blocks = util::encodeETC1(image);
+    ASSERT_EQ(8u * 4u * 2u, blocks.size());
+
+    const PremultipliedImage decoded = util::decodeETC1(image.size, blocks);
+    ASSERT_EQ(image.size, decoded.size);
+    int totalError = 0;
+    for (std::size_t i = 0; i < image.bytes(); ++i) {
+        if (i % 4 == 3) {
+            EXPECT_EQ(255, decoded.data[i]);
+        } else {
+            const int error = std::abs(int(image.data[i]) - int(decoded.data[i]));
+            EXPECT_LE(error, 48) << i;
+            totalError += error;
+        }
+    }
+    // Lossy, but close on average.
+    EXPECT_LT(totalError, int(image.size.area() * 3 * 8));
+}
+
+TEST(ETC1, FlatColor) {
+    PremultipliedImage image({4, 4});
+    for (std::size_t i = 0; i < image.bytes(); i += 4) {
+        image.data[i] = 200;
+        image.data[i + 1] = 100;
+        image.data[i + 2] = 0;
+        image.data[i + 3] = 255;
+    }
+    const PremultipliedImage decoded = util::decodeETC1(image.size, util::encodeETC1(image));
+    EXPECT_EQ(image, decoded);
+}
+
+TEST(ETC1, Rejects) {
+    // ETC1 has no alpha channel.
+    EXPECT_TRUE(util::encodeETC1(makeImage({8, 8}, 128)).empty());
+    // Only whole blocks are encoded.
+    EXPECT_TRUE(util::encodeETC1(makeImage({6, 8}, 255)).empty());
+}
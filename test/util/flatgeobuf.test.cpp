@@ -0,0 +1,60 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/tile/tile_id.hpp>
+#include <mbgl/util/flatgeobuf.hpp>
+
+#include <stdexcept>
+
+using namespace mbgl;
+
+// grid.fgb has 100 points on a 10° grid from -45° to 45°, named "p0" to "p99" and ranked by their
+// index, followed by a polygon with a hole and a multi line string. Its R-tree has 4 items per node.
+// grid_no_index.fgb has the first three points and the last two features, without an index.
+
+TEST(FlatGeobuf, Header) {
+    FlatGeobufReader reader("test/fixtures/flatgeobuf/grid.fgb");
+    EXPECT_EQ(102u, reader.getFeatureCount());
+    EXPECT_EQ(LatLngBounds::hull({-80, -170}, {45, 110}), *reader.getBounds());
+
+    EXPECT_THROW(FlatGeobufReader("test/fixtures/flatgeobuf/missing.fgb"), std::runtime_error);
+    EXPECT_THROW(FlatGeobufReader("test/fixtures/api/water.json"), std::runtime_error);
+}
+
+TEST(FlatGeobuf, Query) {
+    FlatGeobufReader reader("test/fixtures/flatgeobuf/grid.fgb");
+
+    const FeatureCollection points = reader.query(LatLngBounds::hull({-6, -6}, {6, 16}));
+    ASSERT_EQ(6u, points.size());
+    EXPECT_EQ(FeatureIdentifier(uint64_t(44)), points[0].id);
+    EXPECT_EQ(mapbox::geojson::geometry(mapbox::geojson::point(-5, -5)), points[0].geometry);
+    EXPECT_EQ(Value(std::string("p44")), points[0].properties.at("name"));
+    EXPECT_EQ(Value(int64_t(44)), points[0].properties.at("rank"));
+    EXPECT_EQ(FeatureIdentifier(uint64_t(65)), points[5].id);
+
+    const FeatureCollection polygons = reader.query(LatLngBounds::hull({11, 101}, {11.5, 101.5}));
+    ASSERT_EQ(1u, polygons.size());
+    ASSERT_TRUE(polygons[0].geometry.is<mapbox::geojson::polygon>());
+    const auto& polygon = polygons[0].geometry.get<mapbox::geojson::polygon>();
+    ASSERT_EQ(2u, polygon.size());
+    EXPECT_EQ(5u, polygon[0].size());
+    EXPECT_EQ(4u, polygon[1].size());
+    EXPECT_EQ(Value(int64_t(-1)), polygons[0].properties.at("rank"));
+
+    EXPECT_TRUE(reader.query(LatLngBounds::hull({50, 50}, {60, 60})).empty());
+
+    // Tiles include their buffer.
+    EXPECT_EQ(102u, reader.getTile(CanonicalTileID(0, 0, 0)).size());
+    EXPECT_EQ(1u, reader.getTile(CanonicalTileID(3, 6, 3), 0).size());
+}
+
+TEST(FlatGeobuf, QueryWithoutIndex) {
+    FlatGeobufReader reader("test/fixtures/flatgeobuf/grid_no_index.fgb");
+
+    const FeatureCollection features = reader.query(LatLngBounds::hull({-90, -180}, {90, 180}));
+    ASSERT_EQ(5u, features.size());
+    EXPECT_EQ(FeatureIdentifier(uint64_t(4)), features[4].id);
+    ASSERT_TRUE(features[4].geometry.is<mapbox::geojson::multi_line_string>());
+    EXPECT_EQ(2u, features[4].geometry.get<mapbox::geojson::multi_line_string>().size());
+
+    EXPECT_EQ(1u, reader.query(LatLngBounds::hull({-50, -50}, {-40, -40})).size());
+}
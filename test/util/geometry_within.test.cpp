@@ -0,0 +1,52 @@
+#include <mbgl/util/geometry_within.hpp>
+
+#include <cmath>
+#include <gtest/gtest.h>
+
+using namespace mbgl;
+
+namespace {
+
+// A star with many edges and a square hole, so that the grid has inside, outside and edge cells.
+MultiPolygon<int64_t> starWithHole() {
+    LinearRing<int64_t> outer;
+    const std::size_t points = 200;
+    for (std::size_t i = 0; i < points; ++i) {
+        const double angle = 2 * M_PI * i / points;
+        const double radius = i % 2 ? 4000 : 3000;
+        outer.emplace_back(static_cast<int64_t>(5000 + radius * std::cos(angle)),
+                           static_cast<int64_t>(5000 + radius * std::sin(angle)));
+    }
+    outer.push_back(outer.front());
+
+    LinearRing<int64_t> hole{{4000, 4000}, {6000, 4000}, {6000, 6000}, {4000, 6000}, {4000, 4000}};
+
+    Polygon<int64_t> polygon;
+    polygon.push_back(std::move(outer));
+    polygon.push_back(std::move(hole));
+    return {std::move(polygon)};
+}
+
+} // namespace
+
+TEST(GeometryWithin, PolygonIndex) {
+    const auto polygons = starWithHole();
+    const PolygonIndex index(polygons);
+
+    std::size_t inside = 0;
+    for (int64_t x = 0; x <= 10000; x += 37) {
+        for (int64_t y = 0; y <= 10000; y += 41) {
+            const Point<int64_t> point(x, y);
+            const bool within = pointWithinPolygons(point, polygons);
+            EXPECT_EQ(within, index.contains(point)) << x << ", " << y;
+            inside += within;
+        }
+    }
+    EXPECT_GT(inside, 0u);
+
+    // Points on the edges are not within.
+    EXPECT_FALSE(index.contains({4000, 5000}));
+    EXPECT_FALSE(index.contains({5000, 6000}));
+    EXPECT_TRUE(index.contains({5000, 7000}));
+    EXPECT_FALSE(index.contains({5000, 5000}));
+}
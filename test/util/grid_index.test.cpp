@@ -28,6 +28,73 @@ TEST(GridIndex, DuplicateKeys) {
     EXPECT_EQ(grid.query({{0, 0}, {30, 30}}), (std::vector<int16_t>{KEY, KEY, KEY}));
 }
 
+TEST(GridIndex, InsertIndex) {
+    GridIndex<int16_t> grid(100, 100, 10);
+    grid.insert(0, {{4, 10}, {6, 30}});
+
+    GridIndex<int16_t> other(100, 100, 10);
+    other.insert(1, {{4, 10}, {30, 12}});
+    other.insert(2, {{60, 60}, 15});
+
+    grid.insert(other);
+    EXPECT_EQ(grid.query({{4, 10}, {5, 11}}), (std::vector<int16_t>{0, 1}));
+    EXPECT_TRUE(grid.hitTest({{55, 55}, 2}));
+    EXPECT_EQ(other.query({{-1000, -1000}, {1000, 1000}}), (std::vector<int16_t>{1, 2}));
+}
+
+TEST(GridIndex, Clear) {
+    GridIndex<int16_t> grid(100, 100, 10);
+    grid.insert(0, {{4, 10}, {6, 30}});
+    grid.insert(1, {{60, 60}, 15});
+
+    grid.clear();
+    EXPECT_TRUE(grid.empty());
+    EXPECT_EQ(grid.query({{-1000, -1000}, {1000, 1000}}), (std::vector<int16_t>{}));
+    EXPECT_FALSE(grid.hitTest({{55, 55}, 2}));
+
+    grid.insert(2, {{4, 10}, {30, 12}});
+    EXPECT_EQ(grid.query({{4, 10}, {5, 11}}), (std::vector<int16_t>{2}));
+}
+
+TEST(GridIndex, VisitsElementsOnce) {
+    GridIndex<int16_t> grid(100, 100, 10);
+    grid.insert(0, {{5, 5}, {95, 95}});
+    grid.insert(1, {{50, 50}, 30});
+
+    std::vector<int16_t> visited;
+    grid.query(GridIndex<int16_t>::BBox{{10, 10}, {90, 90}}, [&](const int16_t& t, const GridIndex<int16_t>::BBox&) {
+        visited.push_back(t);
+        return false;
+    });
+    EXPECT_EQ(visited, (std::vector<int16_t>{0, 1}));
+
+    visited.clear();
+    grid.query(GridIndex<int16_t>::BCircle{{50, 50}, 20}, [&](const int16_t& t, const GridIndex<int16_t>::BBox&) {
+        visited.push_back(t);
+        return true;
+    });
+    EXPECT_EQ(visited, (std::vector<int16_t>{0}));
+}
+
+TEST(GridIndex, ForEach) {
+    GridIndex<int16_t> grid(100, 100, 10);
+    grid.insert(0, {{60, 60}, 15});
+    grid.insert(1, {{4, 10}, {30, 12}});
+    grid.insert(2, {{5, 5}, {95, 95}});
+
+    std::vector<int16_t> boxes;
+    std::vector<int16_t> circles;
+    struct Visitor {
+        std::vector<int16_t>& boxes;
+        std::vector<int16_t>& circles;
+        void operator()(int16_t t, const GridIndex<int16_t>::BBox&) { boxes.push_back(t); }
+        void operator()(int16_t t, const GridIndex<int16_t>::BCircle&) { circles.push_back(t); }
+    };
+    grid.forEach(Visitor{boxes, circles});
+    EXPECT_EQ(boxes, (std::vector<int16_t>{1, 2}));
+    EXPECT_EQ(circles, (std::vector<int16_t>{0}));
+}
+
 TEST(GridIndex, CircleCircle) {
     GridIndex<int16_t> grid(100, 100, 10);
     grid.insert(0, {{50, 50}, 10});
@@ -51,6 +118,18 @@ TEST(GridIndex, CircleBox) {
     EXPECT_EQ(grid.query({{0, 80}, {20, 100}}), (std::vector<int16_t>{2}));
 }
 
+TEST(GridIndex, CellCount) {
+    GridIndex<int16_t> grid(100, 100, 10);
+
+    EXPECT_EQ(1u, grid.cellCount({{1, 1}, {9, 9}}));
+    EXPECT_EQ(6u, grid.cellCount({{5, 5}, {25, 15}}));
+    EXPECT_EQ(4u, grid.cellCount({{50, 50}, 5}));
+    // Clamped to the grid.
+    EXPECT_EQ(2u, grid.cellCount({{-50, -50}, {5, 15}}));
+    EXPECT_EQ(0u, grid.cellCount({{-20, -20}, {-10, -10}}));
+    EXPECT_EQ(0u, grid.cellCount({{-10, -10}, {200, 200}}));
+}
+
 TEST(GridIndex, IndexesFeaturesOverflow) {
     GridIndex<int16_t> grid(5000, 5000, 25);
     grid.insert(0, {{4500, 4500}, {4900, 4900}});
@@ -34,6 +34,28 @@ TEST(Image, PNGRoundTripAlpha) {
     EXPECT_EQ(128, image.data[3]);
 }
 
+TEST(Image, PNGRoundTripOptions) {
+    // Tall enough to be split into several strips.
+    PremultipliedImage rgba({ 33, 300 });
+    for (size_t i = 0; i < rgba.bytes(); i += 4) {
+        rgba.data[i + 0] = uint8_t(i / 4 % 33 * 7);
+        rgba.data[i + 1] = uint8_t(i / 4 / 33);
+        rgba.data[i + 2] = uint8_t(i % 5 * 50);
+        rgba.data[i + 3] = 255;
+    }
+
+    using Filter = PNGEncodeOptions::Filter;
+    for (const Filter filter : { Filter::None, Filter::Sub, Filter::Up, Filter::Paeth, Filter::Adaptive }) {
+        for (const int level : { -1, 0, 1, 9 }) {
+            PNGEncodeOptions options;
+            options.filter = filter;
+            options.compressionLevel = level;
+            options.threads = 4;
+            EXPECT_EQ(rgba, decodeImage(encodePNG(rgba, options))) << int(filter) << " " << level;
+        }
+    }
+}
+
 TEST(Image, PNGReadNoProfile) {
     PremultipliedImage image = decodeImage(util::read_file("test/fixtures/image/no_profile.png"));
     EXPECT_EQ(128, image.data[0]);
@@ -155,3 +177,31 @@ TEST(Image, Premultiply) {
     EXPECT_EQ(0u, rgba.size.width);
     EXPECT_EQ(0u, rgba.size.height);
 }
+
+TEST(Image, PremultiplyAllValues) {
+    // Every combination of color and alpha, plus a pixel that doesn't fill a vector.
+    UnassociatedImage rgba({ 256 * 256 + 1, 1 });
+    for (uint32_t i = 0; i < rgba.size.width; ++i) {
+        rgba.data[i * 4 + 0] = uint8_t(i >> 8);
+        rgba.data[i * 4 + 1] = uint8_t(255 - (i >> 8));
+        rgba.data[i * 4 + 2] = uint8_t(i * 7);
+        rgba.data[i * 4 + 3] = uint8_t(i);
+    }
+    const UnassociatedImage original = rgba.clone();
+
+    PremultipliedImage image = util::premultiply(std::move(rgba));
+    for (size_t i = 0; i < image.bytes(); i += 4) {
+        const uint8_t a = original.data[i + 3];
+        for (size_t c = 0; c < 3; ++c) {
+            ASSERT_EQ((original.data[i + c] * a + 127) / 255, image.data[i + c]) << i;
+        }
+        ASSERT_EQ(a, image.data[i + 3]);
+    }
+
+    UnassociatedImage unpremultiplied = util::unpremultiply(std::move(image));
+    for (size_t i = 0; i < unpremultiplied.bytes(); i += 4) {
+        if (original.data[i + 3] == 255) {
+            ASSERT_EQ(original.data[i], unpremultiplied.data[i]);
+        }
+    }
+}
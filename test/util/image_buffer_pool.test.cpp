@@ -0,0 +1,46 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/util/image_buffer_pool.hpp>
+#include <mbgl/util/io.hpp>
+
+using namespace mbgl;
+
+TEST(ImageBufferPool, Reuse) {
+    util::ImageBufferPool pool(64 * 64 * 4);
+
+    PremultipliedImage image = pool.acquire({ 32, 32 });
+    ASSERT_TRUE(image.valid());
+    const uint8_t* buffer = image.data.get();
+    pool.release(std::move(image));
+    EXPECT_FALSE(image.valid());
+    EXPECT_EQ(32u * 32 * 4, pool.getSize());
+
+    // Only images of the same size get the buffer back.
+    PremultipliedImage other = pool.acquire({ 16, 64 });
+    EXPECT_EQ(buffer, other.data.get());
+    EXPECT_EQ(0u, pool.getSize());
+
+    // Buffers past the maximum size are freed.
+    pool.release(std::move(other));
+    pool.release(pool.acquire({ 64, 64 }));
+    EXPECT_EQ(32u * 32 * 4, pool.getSize());
+
+    pool.clear();
+    EXPECT_EQ(0u, pool.getSize());
+}
+
+TEST(ImageBufferPool, Decode) {
+    const std::string data = util::read_file("test/fixtures/image/tile.png");
+    util::ImageBufferPool pool(1024 * 1024);
+
+    const PremultipliedImage expected = decodeImage(data);
+    PremultipliedImage image = decodeImage(data, pool);
+    EXPECT_EQ(expected.size, image.size);
+    EXPECT_EQ(expected, image);
+
+    // Decoding into a reused buffer overwrites every pixel.
+    std::fill(image.data.get(), image.data.get() + image.bytes(), 0x7f);
+    pool.release(std::move(image));
+    image = decodeImage(data, pool);
+    EXPECT_EQ(expected, image);
+}
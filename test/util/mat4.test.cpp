@@ -0,0 +1,63 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/util/mat4.hpp>
+
+using namespace mbgl;
+
+namespace {
+
+mat4 makeMatrix(double seed) {
+    mat4 m;
+    for (int i = 0; i < 16; i++) {
+        m[i] = seed * (i + 1) - 3.0 * i * i;
+    }
+    return m;
+}
+
+// Compilers may fuse the multiplications and additions differently in the kernels and here.
+template <typename T>
+void expectNear(const T& expected, const T& actual) {
+    for (std::size_t i = 0; i < expected.size(); i++) {
+        EXPECT_DOUBLE_EQ(expected[i], actual[i]) << "at " << i;
+    }
+}
+
+} // namespace
+
+TEST(Mat4, Multiply) {
+    const mat4 a = makeMatrix(0.75);
+    const mat4 b = makeMatrix(-1.25);
+
+    mat4 expected;
+    for (int j = 0; j < 4; j++) {
+        for (int i = 0; i < 4; i++) {
+            expected[j * 4 + i] =
+                b[j * 4] * a[i] + b[j * 4 + 1] * a[4 + i] + b[j * 4 + 2] * a[8 + i] + b[j * 4 + 3] * a[12 + i];
+        }
+    }
+
+    mat4 out;
+    matrix::multiply(out, a, b);
+    expectNear(expected, out);
+
+    // The result can be written to either operand.
+    mat4 left = a;
+    matrix::multiply(left, left, b);
+    expectNear(expected, left);
+    mat4 right = b;
+    matrix::multiply(right, a, right);
+    expectNear(expected, right);
+}
+
+TEST(Mat4, TransformMat4) {
+    const mat4 m = makeMatrix(0.5);
+    vec4 v = {{ 3.0, -2.0, 0.5, 1.0 }};
+
+    vec4 expected;
+    for (int i = 0; i < 4; i++) {
+        expected[i] = m[i] * v[0] + m[4 + i] * v[1] + m[8 + i] * v[2] + m[12 + i] * v[3];
+    }
+
+    matrix::transformMat4(v, v, m);
+    expectNear(expected, v);
+}
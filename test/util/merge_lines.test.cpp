@@ -38,7 +38,7 @@ public:
 
 TEST(MergeLines, SameText) {
     // merges lines with the same text
-    std::vector<mbgl::SymbolFeature> input1;
+    mbgl::SymbolFeatures input1;
     input1.push_back(SymbolFeatureStub({}, FeatureType::LineString, {{{0, 0}, {1, 0}, {2, 0}}}, properties, aaa, {}, 0));
     input1.push_back(SymbolFeatureStub({}, FeatureType::LineString, {{{4, 0}, {5, 0}, {6, 0}}}, properties, bbb, {}, 0));
     input1.push_back(SymbolFeatureStub({}, FeatureType::LineString, {{{8, 0}, {9, 0}}}, properties, aaa, {}, 0));
@@ -64,7 +64,7 @@ TEST(MergeLines, SameText) {
 
 TEST(MergeLines, BothEnds) {
     // mergeLines handles merge from both ends
-    std::vector<mbgl::SymbolFeature> input2;
+    mbgl::SymbolFeatures input2;
     input2.push_back(SymbolFeatureStub { {}, FeatureType::LineString, {{{0, 0}, {1, 0}, {2, 0}}}, properties, aaa, {}, 0 });
     input2.push_back(SymbolFeatureStub { {}, FeatureType::LineString, {{{4, 0}, {5, 0}, {6, 0}}}, properties, aaa, {}, 0 });
     input2.push_back(SymbolFeatureStub { {}, FeatureType::LineString, {{{2, 0}, {3, 0}, {4, 0}}}, properties, aaa, {}, 0 });
@@ -84,7 +84,7 @@ TEST(MergeLines, BothEnds) {
 
 TEST(MergeLines, CircularLines) {
     // mergeLines handles circular lines
-    std::vector<mbgl::SymbolFeature> input3;
+    mbgl::SymbolFeatures input3;
     input3.push_back(SymbolFeatureStub { {}, FeatureType::LineString, {{{0, 0}, {1, 0}, {2, 0}}}, properties, aaa, {}, 0 });
     input3.push_back(SymbolFeatureStub { {}, FeatureType::LineString, {{{2, 0}, {3, 0}, {4, 0}}}, properties, aaa, {}, 0 });
     input3.push_back(SymbolFeatureStub { {}, FeatureType::LineString, {{{4, 0}, {0, 0}}}, properties, aaa, {}, 0 });
@@ -103,7 +103,7 @@ TEST(MergeLines, CircularLines) {
 }
 
 TEST(MergeLines, EmptyOuterGeometry) {
-    std::vector<mbgl::SymbolFeature> input;
+    mbgl::SymbolFeatures input;
     input.push_back(SymbolFeatureStub { {}, FeatureType::LineString, {}, properties, aaa, {}, 0 });
 
     const StubGeometryTileFeature expected{ {}, FeatureType::LineString, {}, properties };
@@ -114,7 +114,7 @@ TEST(MergeLines, EmptyOuterGeometry) {
 }
 
 TEST(MergeLines, EmptyInnerGeometry) {
-    std::vector<mbgl::SymbolFeature> input;
+    mbgl::SymbolFeatures input;
     input.push_back(SymbolFeatureStub { {}, FeatureType::LineString, {}, properties, aaa, {}, 0 });
 
     const StubGeometryTileFeature expected{ {}, FeatureType::LineString, {}, properties };
@@ -0,0 +1,100 @@
+#include <mbgl/util/parallel_for.hpp>
+
+#include <mbgl/actor/scheduler.hpp>
+#include <mbgl/test/util.hpp>
+
+#include <atomic>
+#include <future>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace mbgl;
+
+TEST(ParallelFor, CallsEveryIndexOnce) {
+    ThreadPoolOptions options;
+    options.threadCount = 4u;
+    std::shared_ptr<Scheduler> pool = Scheduler::MakeThreadPool(options);
+    Scheduler::SetBackground(pool);
+
+    std::vector<std::atomic<unsigned>> calls(1000);
+    std::mutex mutex;
+    std::set<std::thread::id> threads;
+    util::parallelFor(calls.size(), TaskTag::Untagged, TaskPriority::Default, [&](std::size_t index) {
+        ++calls[index];
+        std::lock_guard<std::mutex> lock(mutex);
+        threads.insert(std::this_thread::get_id());
+    });
+    for (const auto& count : calls) {
+        EXPECT_EQ(1u, count);
+    }
+    // The calling thread and at most one helper less than the pool has threads.
+    EXPECT_LE(threads.size(), 4u);
+
+    // Too few indices per thread run on the calling thread only.
+    threads.clear();
+    util::parallelFor(
+        100u,
+        TaskTag::Untagged,
+        TaskPriority::Default,
+        [&](std::size_t) {
+            std::lock_guard<std::mutex> lock(mutex);
+            threads.insert(std::this_thread::get_id());
+        },
+        64u);
+    EXPECT_EQ(std::set<std::thread::id>{std::this_thread::get_id()}, threads);
+
+    Scheduler::SetBackground({});
+}
+
+TEST(ParallelFor, Exceptions) {
+    ThreadPoolOptions options;
+    options.threadCount = 4u;
+    std::shared_ptr<Scheduler> pool = Scheduler::MakeThreadPool(options);
+    Scheduler::SetBackground(pool);
+
+    // Helpers may still be running when the calling thread throws, which must wait for them.
+    for (const std::size_t throwing : {std::size_t(0u), std::size_t(999u)}) {
+        std::vector<std::atomic<unsigned>> calls(1000);
+        EXPECT_THROW(util::parallelFor(calls.size(),
+                                       TaskTag::Untagged,
+                                       TaskPriority::Default,
+                                       [&](std::size_t index) {
+                                           ++calls[index];
+                                           if (index == throwing) {
+                                               throw std::runtime_error("index");
+                                           }
+                                       }),
+                     std::runtime_error);
+        EXPECT_EQ(1u, calls[throwing]);
+    }
+
+    Scheduler::SetBackground({});
+}
+
+TEST(ParallelFor, FromBackgroundTask) {
+    ThreadPoolOptions options;
+    options.threadCount = 2u;
+    std::shared_ptr<Scheduler> pool = Scheduler::MakeThreadPool(options);
+
+    // Keeps the other thread busy, so that the helper only starts once the loop is done.
+    std::promise<void> blocked;
+    std::promise<void> unblock;
+    auto unblocked = unblock.get_future().share();
+    pool->schedule([&blocked, unblocked] {
+        blocked.set_value();
+        unblocked.wait();
+    });
+    blocked.get_future().wait();
+
+    std::promise<std::size_t> sum;
+    pool->schedule([&] {
+        std::size_t total = 0u;
+        util::parallelFor(10u, TaskTag::Untagged, TaskPriority::Default, [&](std::size_t index) { total += index; });
+        sum.set_value(total);
+    });
+    EXPECT_EQ(45u, sum.get_future().get());
+    unblock.set_value();
+}
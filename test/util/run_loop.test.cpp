@@ -69,6 +69,32 @@ TEST(RunLoop, Priorities) {
     EXPECT_EQ((std::vector<int>{ 2, 4, 1, 3 }), order);
 }
 
+TEST(RunLoop, InvokeFromOtherThreads) {
+    RunLoop loop(RunLoop::Type::New);
+
+    // Tasks queued while the loop processes others don't wake it again, and must still run.
+    int count = 0;
+    auto threadBody = [&]() {
+        for (unsigned i = 0; i < 100000; ++i) {
+            loop.invoke([&] {
+                if (++count == 200000) {
+                    loop.stop();
+                }
+            });
+        }
+    };
+
+    std::thread thread1(threadBody);
+    std::thread thread2(threadBody);
+
+    loop.run();
+
+    EXPECT_EQ(count, 200000);
+
+    thread1.join();
+    thread2.join();
+}
+
 TEST(RunLoop, PlatformIntegration) {
     std::atomic<int> count1(0);
 
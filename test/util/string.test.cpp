@@ -2,6 +2,7 @@
 
 #include <mbgl/util/string.hpp>
 
+#include <cmath>
 #include <cstdint>
 
 using namespace mbgl;
@@ -17,6 +18,19 @@ TEST(ToString, FloatingPoint) {
     EXPECT_EQ("12340000000.0", util::toString(12340000000.0, true));
     EXPECT_EQ("12340000000", util::toString(12340000000.0));
     EXPECT_EQ("12340000000.0", util::toString(12340000000.0, true));
+    EXPECT_EQ("999999999999999", util::toString(999999999999999.0));
+    EXPECT_EQ("-8848", util::toString(-8848.0));
+    EXPECT_EQ("-8848.0", util::toString(-8848.0, true));
+    EXPECT_EQ("8848.5", util::toString(8848.5));
+    EXPECT_EQ("", util::toString(NAN));
+    EXPECT_EQ("", util::toString(INFINITY));
+}
+
+TEST(ToString, Integer) {
+    EXPECT_EQ("-2147483648", util::toString(INT32_MIN));
+    EXPECT_EQ("4294967295", util::toString(UINT32_MAX));
+    EXPECT_EQ("-9223372036854775808", util::toString(INT64_MIN));
+    EXPECT_EQ("18446744073709551615", util::toString(UINT64_MAX));
 }
 
 TEST(ToHex, SIZE_T) {
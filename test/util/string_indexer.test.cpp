@@ -0,0 +1,40 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/util/string_indexer.hpp>
+
+#include <thread>
+#include <vector>
+
+using namespace mbgl;
+
+TEST(StringIndexer, Identity) {
+    util::StringIndexer indexer;
+    const StringIdentity water = indexer.get("water");
+    const StringIdentity roads = indexer.get("roads");
+    EXPECT_NE(water, roads);
+    EXPECT_EQ(water, indexer.get("water"));
+    EXPECT_EQ("water", indexer.get(water));
+    EXPECT_EQ("roads", indexer.get(roads));
+    EXPECT_EQ(2u, indexer.size());
+}
+
+TEST(StringIndexer, Threads) {
+    util::StringIndexer indexer;
+    std::vector<std::thread> threads;
+    std::vector<StringIdentity> identities(4);
+    for (std::size_t i = 0; i < identities.size(); ++i) {
+        threads.emplace_back([&, i] {
+            for (int j = 0; j < 100; ++j) {
+                indexer.get("layer-" + std::to_string(j));
+            }
+            identities[i] = indexer.get("layer-50");
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(100u, indexer.size());
+    for (const StringIdentity identity : identities) {
+        EXPECT_EQ("layer-50", indexer.get(identity));
+    }
+}
@@ -4,6 +4,7 @@
 
 #include <algorithm>
 #include <cstdlib>     /* srand, rand */
+#include <set>
 #include <ctime>       /* time */
 #include <gtest/gtest.h>
 
@@ -41,6 +42,25 @@ TEST(TileCover, Pitch) {
               util::tileCover(transform.getState(), 2));
 }
 
+TEST(TileCover, SameCamera) {
+    Transform transform;
+    transform.resize({ 512, 512 });
+    transform.jumpTo(CameraOptions().withCenter(LatLng { 0.1, -0.1, }).withZoom(2.0).withBearing(5.0).withPitch(40.0));
+
+    const auto tiles = util::tileCover(transform.getState(), 2);
+    EXPECT_EQ(tiles, util::tileCover(transform.getState(), 2));
+    EXPECT_EQ((std::vector<OverscaledTileID>{
+                  {3, 0, {2, 1, 1}}, {3, 0, {2, 2, 1}}, {3, 0, {2, 1, 2}}, {3, 0, {2, 2, 2}}}),
+              util::tileCover(transform.getState(), 2, 3));
+    EXPECT_NE(tiles, util::tileCover(transform.getState(), 3));
+
+    // Cameras that are the same as an earlier one get the same cover, and other cameras their own.
+    transform.jumpTo(CameraOptions().withCenter(LatLng { 45.0, 90.0, }));
+    EXPECT_NE(tiles, util::tileCover(transform.getState(), 2));
+    transform.jumpTo(CameraOptions().withCenter(LatLng { 0.1, -0.1, }));
+    EXPECT_EQ(tiles, util::tileCover(transform.getState(), 2));
+}
+
 TEST(TileCover, PitchIssue15442) {
     Transform transform;
     transform.resize({ 412, 691 });
@@ -78,8 +98,7 @@ TEST(TileCover, PitchWithLargerResultSet) {
                                     .withZoom(5).withBearing(-142.2630000003529176).withPitch(60.0));
 
     auto cover = util::tileCover(transform.getState(), 5);
-    // Returned vector has above 100 elements, we check first 16 as there is a
-    // plan to return lower LOD for distant tiles.
+    // Distant tiles come from lower zoom levels, we check the first 16 that are closest to the center.
     EXPECT_EQ((std::vector<OverscaledTileID>{{5, 15, 16},
                                              {5, 15, 17},
                                              {5, 14, 16},
@@ -99,6 +118,35 @@ TEST(TileCover, PitchWithLargerResultSet) {
               (std::vector<OverscaledTileID>{cover.begin(), cover.begin() + 16}));
 }
 
+TEST(TileCover, PitchLowerZoomForDistantTiles) {
+    Transform transform;
+    transform.resize({1024, 768});
+    transform.jumpTo(CameraOptions().withCenter(LatLng{0.1, -0.1}).withPadding(EdgeInsets{400, 0, 0, 0})
+                                    .withZoom(5).withPitch(60.0));
+
+    const auto cover = util::tileCover(transform.getState(), 5);
+    ASSERT_FALSE(cover.empty());
+    EXPECT_EQ(5, cover.front().canonical.z);
+    EXPECT_TRUE(std::any_of(cover.begin(), cover.end(), [](const OverscaledTileID& id) {
+        return id.canonical.z < 5;
+    }));
+
+    // Lower zoom level tiles replace their children, no area is covered twice.
+    for (const auto& a : cover) {
+        for (const auto& b : cover) {
+            if (a != b) {
+                EXPECT_FALSE(a.isChildOf(b));
+            }
+        }
+    }
+
+    // Without pitch, all tiles show at the same scale.
+    transform.jumpTo(CameraOptions().withPadding(EdgeInsets{}).withPitch(0.0));
+    for (const auto& id : util::tileCover(transform.getState(), 5)) {
+        EXPECT_EQ(5, id.canonical.z);
+    }
+}
+
 TEST(TileCover, WorldZ1) {
     EXPECT_EQ((std::vector<UnwrappedTileID>{
                   {1, 0, 0},
@@ -259,6 +307,44 @@ TEST(TileCoverStream, WorldZ1) {
 static const LatLngBounds sanFrancisco =
     LatLngBounds::hull({ 37.6609, -122.5744 }, { 37.8271, -122.3204 });
 
+TEST(ZOrderTileCover, WorldZ2) {
+    util::ZOrderTileCover tc(LatLngBounds::world(), 2);
+    std::vector<UnwrappedTileID> t;
+    while (tc.hasNext()) {
+        t.push_back(*tc.next());
+    }
+    EXPECT_EQ((std::vector<UnwrappedTileID>{
+                  {2, 0, 0}, {2, 1, 0}, {2, 0, 1}, {2, 1, 1},
+                  {2, 2, 0}, {2, 3, 0}, {2, 2, 1}, {2, 3, 1},
+                  {2, 0, 2}, {2, 1, 2}, {2, 0, 3}, {2, 1, 3},
+                  {2, 2, 2}, {2, 3, 2}, {2, 2, 3}, {2, 3, 3},
+              }),
+              t);
+}
+
+TEST(ZOrderTileCover, MatchesTileCount) {
+    const auto crossingBounds = LatLngBounds::hull({-20.9615, -214.309}, {19.477, -155.830});
+    for (const auto& bounds : {sanFrancisco, crossingBounds, LatLngBounds::world()}) {
+        for (uint8_t z = 0; z <= 12; ++z) {
+            std::set<UnwrappedTileID> tiles;
+            util::ZOrderTileCover tc(bounds, z);
+            while (tc.hasNext()) {
+                EXPECT_TRUE(tiles.insert(*tc.next()).second);
+            }
+            EXPECT_FALSE(tc.next());
+            EXPECT_EQ(util::tileCount(bounds, z), tiles.size());
+        }
+    }
+
+    // Bounds crossing the antimeridian yield unwrapped tiles.
+    util::ZOrderTileCover tc(crossingBounds, 3);
+    std::vector<UnwrappedTileID> t;
+    while (tc.hasNext()) {
+        t.push_back(*tc.next());
+    }
+    EXPECT_EQ((std::vector<UnwrappedTileID>{{3, -1, 3}, {3, -1, 4}, {3, 0, 3}, {3, 0, 4}}), t);
+}
+
 TEST(TileCover, SanFranciscoZ0) {
     EXPECT_EQ((std::vector<UnwrappedTileID>{
         { 0, 0, 0 },
@@ -0,0 +1,31 @@
+#include <mbgl/util/tile_trace.hpp>
+
+#include <gtest/gtest.h>
+
+using namespace mbgl;
+
+TEST(TileTrace, Disabled) {
+    const OverscaledTileID id{3, 0, 3, 1, 2};
+    util::TileTrace::setEnabled(false);
+    util::TileTrace::begin(id, "parse");
+    util::TileTrace::end(id, "parse");
+
+    EXPECT_EQ(R"({"traceEvents":[],"displayTimeUnit":"ms"})", util::TileTrace::exportChromeTrace());
+}
+
+TEST(TileTrace, Export) {
+    const OverscaledTileID id{4, 1, 3, 1, 2};
+    util::TileTrace::setEnabled(true);
+    {
+        util::TileTrace::Scope scope(id, "parse");
+    }
+    util::TileTrace::setEnabled(false);
+
+    const std::string trace = util::TileTrace::exportChromeTrace();
+    EXPECT_NE(std::string::npos, trace.find(R"({"name":"parse","cat":"tile","ph":"b","id":"4/1/3/1/2",)"));
+    EXPECT_NE(std::string::npos, trace.find(R"({"name":"parse","cat":"tile","ph":"e","id":"4/1/3/1/2",)"));
+    EXPECT_NE(std::string::npos, trace.find(R"("args":{"tile":"4/1/3/1/2"})"));
+
+    // Exporting discards the events.
+    EXPECT_EQ(R"({"traceEvents":[],"displayTimeUnit":"ms"})", util::TileTrace::exportChromeTrace());
+}